@@ -100,6 +100,54 @@ void Avg_Finalize
 	}
 }
 
+// returns the average tracked by avg_ctx
+static inline long double _avg
+(
+	const AvgCtx *avg_ctx
+) {
+	// once overflowed, 'total' is the average
+	if(avg_ctx->overflow) return avg_ctx->total;
+	return avg_ctx->total / (long double)avg_ctx->count;
+}
+
+// merge partial average 'src' into 'dst'
+void Avg_Combine
+(
+	AggregateCtx *dst,
+	AggregateCtx *src
+) {
+	AvgCtx *src_ctx = src->private_data;
+	if(src_ctx == NULL || src_ctx->count == 0) return;
+
+	AvgCtx *dst_ctx = dst->private_data;
+	if(dst_ctx == NULL) {
+		dst_ctx = dst->private_data = rm_calloc(1, sizeof(AvgCtx));
+	}
+
+	if(dst_ctx->count == 0) {
+		*dst_ctx = *src_ctx;
+		return;
+	}
+
+	if(!dst_ctx->overflow && !src_ctx->overflow &&
+	   !ABOUT_TO_OVERFLOW(dst_ctx->total, src_ctx->total)) {
+		dst_ctx->count += src_ctx->count;
+		dst_ctx->total += src_ctx->total;
+		return;
+	}
+
+	// weigh both averages by their counts
+	// switching to the incremental representation
+	size_t count = dst_ctx->count + src_ctx->count;
+	long double total =
+		_avg(dst_ctx) * ((long double)dst_ctx->count / (long double)count) +
+		_avg(src_ctx) * ((long double)src_ctx->count / (long double)count);
+
+	dst_ctx->count    = count;
+	dst_ctx->total    = total;
+	dst_ctx->overflow = true;
+}
+
 AggregateCtx *Avg_PrivateData(void)
 {
 	AggregateCtx *ctx = rm_malloc(sizeof(AggregateCtx));
@@ -119,7 +167,7 @@ void Register_AVG(void) {
 	array_append(types, T_NULL | T_INT64 | T_DOUBLE);
 	ret_type = T_NULL | T_DOUBLE;
 	func_desc = AR_AggFuncDescNew("avg", AGG_AVG, 1, 1, types, ret_type,
-			rm_free, Avg_Finalize, Avg_PrivateData);
+			rm_free, Avg_Finalize, Avg_PrivateData, Avg_Combine);
 
 	AR_RegFunc(func_desc);
 }
@@ -27,6 +27,13 @@ AggregateResult AGG_COLLECT(SIValue *argv, int argc, void *private_data) {
 	return AGGREGATE_OK;
 }
 
+void Collect_Combine(AggregateCtx *dst, AggregateCtx *src) {
+	uint32_t n = SIArray_Length(src->result);
+	for(uint32_t i = 0; i < n; i++) {
+		SIArray_Append(&dst->result, SIArray_Get(src->result, i));
+	}
+}
+
 AggregateCtx *Collect_PrivateData(void)
 {
 	AggregateCtx *ctx = rm_malloc(sizeof(AggregateCtx));
@@ -46,7 +53,7 @@ void Register_COLLECT(void) {
 	array_append(types, SI_ALL);
 	ret_type = T_NULL | T_ARRAY;
 	func_desc = AR_AggFuncDescNew("collect", AGG_COLLECT, 1, 1, types, ret_type,
-			NULL, NULL, Collect_PrivateData);
+			NULL, NULL, Collect_PrivateData, Collect_Combine);
 	AR_RegFunc(func_desc);
 }
 
@@ -25,6 +25,10 @@ AggregateResult AGG_COUNT(SIValue *argv, int argc, void *private_data) {
 	return AGGREGATE_OK;
 }
 
+void Count_Combine(AggregateCtx *dst, AggregateCtx *src) {
+	dst->result.longval += src->result.longval;
+}
+
 AggregateCtx *Count_PrivateData(void)
 {
 	AggregateCtx *ctx = rm_malloc(sizeof(AggregateCtx));
@@ -44,7 +48,7 @@ void Register_COUNT(void) {
 	array_append(types, SI_ALL);
 	ret_type = T_INT64;
 	func_desc = AR_AggFuncDescNew("count", AGG_COUNT, 1, 1, types, ret_type,
-			NULL, NULL, Count_PrivateData);
+			NULL, NULL, Count_PrivateData, Count_Combine);
 	AR_RegFunc(func_desc);
 }
 
@@ -20,7 +20,8 @@ AR_FuncDesc *AR_AggFuncDescNew
 	SIType ret_type,                    // return type
 	AR_Func_Free free,                  // free aggregation callback
 	AR_Func_Finalize finalize,          // finalize aggregation callback
-	AR_Func_PrivateData private_data    // generate private data
+	AR_Func_PrivateData private_data,   // generate private data
+	AR_Func_Combine combine             // [optional] merge partial aggregations
 ) {
 	AR_FuncDesc *desc = rm_calloc(1, sizeof(AR_FuncDesc));
 
@@ -36,6 +37,7 @@ AR_FuncDesc *AR_AggFuncDescNew
 	desc->callbacks.free          =  free;
 	desc->callbacks.finalize      =  finalize;
 	desc->callbacks.private_data  =  private_data;
+	desc->callbacks.combine       =  combine;
 
 	return desc;
 }
@@ -72,6 +74,27 @@ void Aggregate_Finalize
 	}
 }
 
+bool Aggregate_Combinable
+(
+	const AR_FuncDesc *func_desc
+) {
+	ASSERT(func_desc != NULL);
+	return func_desc->callbacks.combine != NULL;
+}
+
+void Aggregate_Combine
+(
+	AR_FuncDesc *func_desc,
+	AggregateCtx *dst,
+	AggregateCtx *src
+) {
+	ASSERT(dst != NULL);
+	ASSERT(src != NULL);
+	ASSERT(Aggregate_Combinable(func_desc));
+
+	func_desc->callbacks.combine(dst, src);
+}
+
 // get aggregated result
 SIValue Aggregate_GetResult
 (
@@ -24,7 +24,8 @@ AR_FuncDesc *AR_AggFuncDescNew
 	SIType ret_type,                    // return type
 	AR_Func_Free free,                  // free aggregation callback
 	AR_Func_Finalize finalize,          // finalize aggregation callback
-	AR_Func_PrivateData private_data    // generate private data
+	AR_Func_PrivateData private_data,   // generate private data
+	AR_Func_Combine combine             // [optional] merge partial aggregations
 );
 
 // register all aggregation funcitons
@@ -49,6 +50,20 @@ void Aggregate_Finalize
 	AggregateCtx *ctx
 );
 
+// returns true if partial aggregations of func_desc can be combined
+bool Aggregate_Combinable
+(
+	const AR_FuncDesc *func_desc
+);
+
+// merge partial aggregation context 'src' into 'dst'
+void Aggregate_Combine
+(
+	AR_FuncDesc *func_desc,
+	AggregateCtx *dst,
+	AggregateCtx *src
+);
+
 // free aggregation context
 void Aggregate_Free
 (
@@ -29,6 +29,11 @@ AggregateResult AGG_MAX(SIValue *argv, int argc, void *private_data) {
 	return AGGREGATE_OK;
 }
 
+// the partial maximum is aggregated as a regular value
+void Max_Combine(AggregateCtx *dst, AggregateCtx *src) {
+	AGG_MAX(&src->result, 1, dst);
+}
+
 AggregateCtx *Max_PrivateData(void)
 {
 	AggregateCtx *ctx = rm_malloc(sizeof(AggregateCtx));
@@ -48,7 +53,7 @@ void Register_MAX(void) {
 	array_append(types, SI_ALL);
 	ret_type = SI_ALL;
 	func_desc = AR_AggFuncDescNew("max", AGG_MAX, 1, 1, types, ret_type, NULL,
-			NULL, Max_PrivateData);
+			NULL, Max_PrivateData, Max_Combine);
 	AR_RegFunc(func_desc);
 }
 
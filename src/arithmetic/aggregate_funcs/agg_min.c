@@ -29,6 +29,11 @@ AggregateResult AGG_MIN(SIValue *argv, int argc, void *private_data) {
 	return AGGREGATE_OK;
 }
 
+// the partial minimum is aggregated as a regular value
+void Min_Combine(AggregateCtx *dst, AggregateCtx *src) {
+	AGG_MIN(&src->result, 1, dst);
+}
+
 AggregateCtx *Min_PrivateData(void)
 {
 	AggregateCtx *ctx = rm_malloc(sizeof(AggregateCtx));
@@ -48,7 +53,7 @@ void Register_MIN(void) {
 	array_append(types, SI_ALL);
 	ret_type = SI_ALL;
 	func_desc = AR_AggFuncDescNew("min", AGG_MIN, 1, 1, types, ret_type, NULL,
-			NULL, Min_PrivateData);
+			NULL, Min_PrivateData, Min_Combine);
 	AR_RegFunc(func_desc);
 }
 
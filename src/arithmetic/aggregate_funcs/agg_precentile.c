@@ -55,6 +55,25 @@ AggregateResult AGG_PERC(SIValue *argv, int argc, void *private_data) {
 	return AGGREGATE_OK;
 }
 
+// merge partial percentile 'src' into 'dst'
+void Percentile_Combine(AggregateCtx *dst, AggregateCtx *src) {
+	_agg_PercCtx *src_ctx = src->private_data;
+	_agg_PercCtx *dst_ctx = dst->private_data;
+
+	// src never aggregated a value
+	if(src_ctx->values == NULL) return;
+
+	if(dst_ctx->values == NULL) {
+		dst_ctx->percentile = src_ctx->percentile;
+		dst_ctx->values = array_new(double, array_len(src_ctx->values));
+	}
+
+	uint count = array_len(src_ctx->values);
+	for(uint i = 0; i < count; i++) {
+		array_append(dst_ctx->values, src_ctx->values[i]);
+	}
+}
+
 void PercDiscFinalize(void *ctx_ptr) {
 	AggregateCtx *ctx = ctx_ptr;
 	_agg_PercCtx *perc_ctx = ctx->private_data;
@@ -147,7 +166,8 @@ void Register_PRECENTILE(void) {
 	array_append(types, T_NULL | T_INT64 | T_DOUBLE);
 	ret_type = T_NULL | T_DOUBLE;
 	func_desc = AR_AggFuncDescNew("percentileDisc", AGG_PERC, 2, 2, types, ret_type,
-			Percentile_Free, PercDiscFinalize, Precentile_PrivateData);
+			Percentile_Free, PercDiscFinalize, Precentile_PrivateData,
+			Percentile_Combine);
 	AR_RegFunc(func_desc);
 
 	types = array_new(SIType, 3);
@@ -155,7 +175,8 @@ void Register_PRECENTILE(void) {
 	array_append(types, T_NULL | T_INT64 | T_DOUBLE);
 	ret_type = T_NULL | T_DOUBLE;
 	func_desc = AR_AggFuncDescNew("percentileCont", AGG_PERC, 2, 2, types, ret_type,
-			Percentile_Free, PercContFinalize, Precentile_PrivateData);
+			Percentile_Free, PercContFinalize, Precentile_PrivateData,
+			Percentile_Combine);
 	AR_RegFunc(func_desc);
 }
 
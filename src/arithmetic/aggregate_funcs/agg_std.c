@@ -40,6 +40,26 @@ AggregateResult AGG_STDEV(SIValue *argv, int argc, void *private_data) {
 	return AGGREGATE_OK;
 }
 
+// merge partial standard deviation 'src' into 'dst'
+void StDev_Combine(AggregateCtx *dst, AggregateCtx *src) {
+	_agg_StDevCtx *src_ctx = src->private_data;
+	_agg_StDevCtx *dst_ctx = dst->private_data;
+
+	// src never aggregated a value
+	if(src_ctx->values == NULL) return;
+
+	if(dst_ctx->values == NULL) {
+		dst_ctx->total = 0;
+		dst_ctx->values = array_new(double, array_len(src_ctx->values));
+	}
+
+	uint count = array_len(src_ctx->values);
+	for(uint i = 0; i < count; i++) {
+		array_append(dst_ctx->values, src_ctx->values[i]);
+	}
+	dst_ctx->total += src_ctx->total;
+}
+
 void StDevGenericFinalize(AggregateCtx *ctx, int is_sampled) {
 	_agg_StDevCtx *stdev_ctx = ctx->private_data;
 
@@ -106,14 +126,14 @@ void Register_STD(void) {
 	array_append(types, T_NULL | T_INT64 | T_DOUBLE);
 	ret_type = T_NULL | T_DOUBLE;
 	func_desc = AR_AggFuncDescNew("stDev", AGG_STDEV, 1, 1, types, ret_type,
-			StDev_Free, StDevFinalize, STD_PrivateData);
+			StDev_Free, StDevFinalize, STD_PrivateData, StDev_Combine);
 	AR_RegFunc(func_desc);
 
 	types = array_new(SIType, 2);
 	array_append(types, T_NULL | T_INT64 | T_DOUBLE);
 	ret_type = T_NULL | T_DOUBLE;
 	func_desc = AR_AggFuncDescNew("stDevP", AGG_STDEV, 1, 1, types, ret_type,
-			StDev_Free, StDevPFinalize, STD_PrivateData);
+			StDev_Free, StDevPFinalize, STD_PrivateData, StDev_Combine);
 	AR_RegFunc(func_desc);
 }
 
@@ -25,6 +25,10 @@ AggregateResult AGG_SUM(SIValue *argv, int argc, void *private_data) {
 	return AGGREGATE_OK;
 }
 
+void SUM_Combine(AggregateCtx *dst, AggregateCtx *src) {
+	dst->result.doubleval += src->result.doubleval;
+}
+
 AggregateCtx *SUM_PrivateData(void)
 {
 	AggregateCtx *ctx = rm_malloc(sizeof(AggregateCtx));
@@ -44,7 +48,7 @@ void Register_SUM(void) {
 	array_append(types, T_NULL | T_INT64 | T_DOUBLE);
 	ret_type = T_NULL | T_DOUBLE;
 	func_desc = AR_AggFuncDescNew("sum", AGG_SUM, 1, 1, types, ret_type, NULL,
-			NULL, SUM_PrivateData);
+			NULL, SUM_PrivateData, SUM_Combine);
 	AR_RegFunc(func_desc);
 }
 
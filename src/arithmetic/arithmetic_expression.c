@@ -727,6 +727,43 @@ SIValue AR_EXP_FinalizeAggregations
 	return AR_EXP_Evaluate(root, r);
 }
 
+bool AR_EXP_CanCombineAggregations(const AR_ExpNode *root) {
+	if(AGGREGATION_NODE(root)) {
+		// distinct aggregations track seen values, which aren't combined
+		return (Aggregate_Combinable(root->op.f) &&
+				!AR_EXP_ContainsFunc(root, "distinct"));
+	}
+
+	if(AR_EXP_IsOperation(root)) {
+		for(int i = 0; i < root->op.child_count; i++) {
+			AR_ExpNode *child = root->op.children[i];
+			if(!AR_EXP_CanCombineAggregations(child)) return false;
+		}
+	}
+
+	return true;
+}
+
+void AR_EXP_CombineAggregations(AR_ExpNode *dst, AR_ExpNode *src) {
+	if(AGGREGATION_NODE(dst)) {
+		ASSERT(AGGREGATION_NODE(src));
+		ASSERT(dst->op.f == src->op.f);
+		Aggregate_Combine(dst->op.f, dst->op.private_data,
+				src->op.private_data);
+		// aggregation nodes cannot contain nested aggregation nodes
+		return;
+	}
+
+	if(AR_EXP_IsOperation(dst)) {
+		ASSERT(AR_EXP_IsOperation(src));
+		ASSERT(dst->op.child_count == src->op.child_count);
+		for(int i = 0; i < dst->op.child_count; i++) {
+			AR_EXP_CombineAggregations(dst->op.children[i],
+					src->op.children[i]);
+		}
+	}
+}
+
 void AR_EXP_CollectEntities(AR_ExpNode *root, rax *aliases) {
 	if(AR_EXP_IsOperation(root)) {
 		for(int i = 0; i < root->op.child_count; i ++) {
@@ -118,6 +118,14 @@ void AR_EXP_Aggregate(AR_ExpNode *root, const Record r);
 // and evaluates the expression
 SIValue AR_EXP_FinalizeAggregations(AR_ExpNode *root, const Record r);
 
+// returns true if partial aggregations of expression can be combined
+// i.e. all aggregation functions support combining and none is DISTINCT
+bool AR_EXP_CanCombineAggregations(const AR_ExpNode *root);
+
+// merge the partial aggregations of 'src' into 'dst'
+// both expressions must be clones of the same expression
+void AR_EXP_CombineAggregations(AR_ExpNode *dst, AR_ExpNode *src);
+
 //------------------------------------------------------------------------------
 // Utility functions
 //------------------------------------------------------------------------------
@@ -0,0 +1,119 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "attribute_binding.h"
+#include "../../util/rmalloc.h"
+
+AttributeBinding *AttributeBinding_Column
+(
+	LabelID label
+) {
+	AttributeBinding *b = rm_malloc(sizeof(AttributeBinding));
+
+	b->type   = ATTRIBUTE_BINDING_COLUMN;
+	b->column = ColumnBinding_New(label);
+
+	return b;
+}
+
+AttributeBinding *AttributeBinding_Index
+(
+	Index idx
+) {
+	ASSERT(idx                        != NULL);
+	ASSERT(Index_Type(idx)            == IDX_EXACT_MATCH);
+	ASSERT(Index_GraphEntityType(idx) == GETYPE_NODE);
+
+	AttributeBinding *b = rm_malloc(sizeof(AttributeBinding));
+
+	b->type = ATTRIBUTE_BINDING_INDEX;
+	b->idx  = idx;
+
+	return b;
+}
+
+// reads node's attribute from index
+static bool _AttributeBinding_ReadIndex
+(
+	AttributeBinding *b,
+	GraphContext *gc,
+	Node *n,
+	Attribute_ID attr,
+	SIValue *v
+) {
+	// pending modifications might not be reflected by the index
+	EntityID id = ENTITY_GET_ID(n);
+	if(!gc->g->_writelocked && Index_GetStoredValue(b->idx, &id, attr, v)) {
+		return true;
+	}
+
+	// node emitted by a covering index scan, load its attribute-set
+	if(n->attributes == NULL) Graph_GetNode(gc->g, id, n);
+
+	return false;
+}
+
+bool AttributeBinding_Read
+(
+	AttributeBinding *b,
+	GraphContext *gc,
+	Node *n,
+	Attribute_ID attr,
+	SIValue *v
+) {
+	ASSERT(b  != NULL);
+	ASSERT(n  != NULL);
+	ASSERT(v  != NULL);
+	ASSERT(gc != NULL);
+
+	switch(b->type) {
+		case ATTRIBUTE_BINDING_COLUMN:
+			// intermediate nodes aren't covered by columns
+			if(n->attributes == NULL) return false;
+			return ColumnBinding_Read(b->column, gc->column_store, gc->g, attr,
+					ENTITY_GET_ID(n), v);
+		case ATTRIBUTE_BINDING_INDEX:
+			return _AttributeBinding_ReadIndex(b, gc, n, attr, v);
+		default:
+			ASSERT(false && "unknown attribute binding");
+			return false;
+	}
+}
+
+void *AttributeBinding_Clone
+(
+	void *orig
+) {
+	// unbound property access
+	if(orig == NULL) return NULL;
+
+	AttributeBinding *b     = (AttributeBinding *)orig;
+	AttributeBinding *clone = rm_malloc(sizeof(AttributeBinding));
+
+	clone->type = b->type;
+	if(b->type == ATTRIBUTE_BINDING_COLUMN) {
+		clone->column = ColumnBinding_Clone(b->column);
+	} else {
+		clone->idx = b->idx;
+	}
+
+	return clone;
+}
+
+void AttributeBinding_Free
+(
+	void *b
+) {
+	ASSERT(b != NULL);
+
+	AttributeBinding *binding = (AttributeBinding *)b;
+	if(binding->type == ATTRIBUTE_BINDING_COLUMN) {
+		ColumnBinding_Free(binding->column);
+	}
+
+	rm_free(binding);
+}
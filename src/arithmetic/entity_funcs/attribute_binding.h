@@ -0,0 +1,70 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "../../value.h"
+#include "../../index/index.h"
+#include "../../graph/graphcontext.h"
+#include "../../graph/column_store.h"
+
+// binding of a property access to a source of node attributes
+// other than the nodes' attribute-sets
+// set by the optimizer as the private data of the property function
+//
+// a bound access falls back to the node's attribute-set
+// whenever its source can't provide the accessed value
+
+typedef enum {
+	ATTRIBUTE_BINDING_COLUMN,  // read from a label's column, see column_store.h
+	ATTRIBUTE_BINDING_INDEX,   // read from an exact-match index
+} AttributeBindingType;
+
+typedef struct {
+	AttributeBindingType type;  // binding type
+	union {
+		ColumnBinding *column;  // column binding
+		Index idx;              // index holding accessed attribute
+	};
+} AttributeBinding;
+
+// create a new binding to label's columns
+AttributeBinding *AttributeBinding_Column
+(
+	LabelID label  // label of accessed nodes
+);
+
+// create a new binding to an exact-match node index
+// accessed nodes might be emitted by a covering index scan
+// without their attribute-set, see op_node_by_index_scan.h
+AttributeBinding *AttributeBinding_Index
+(
+	Index idx  // index holding accessed attribute
+);
+
+// read node's attribute through binding
+// returns false if the value must be read from the node's attribute-set
+// a node emitted without its attribute-set has it loaded from the graph
+bool AttributeBinding_Read
+(
+	AttributeBinding *b,  // binding
+	GraphContext *gc,     // graph context
+	Node *n,              // node to read
+	Attribute_ID attr,    // attribute to read
+	SIValue *v            // [output] node's value
+);
+
+// clone binding
+void *AttributeBinding_Clone
+(
+	void *orig  // binding to clone
+);
+
+// free binding
+void AttributeBinding_Free
+(
+	void *b  // binding to free
+);
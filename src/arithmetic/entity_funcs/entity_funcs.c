@@ -6,6 +6,7 @@
 
 #include "entity_funcs.h"
 #include "../func_desc.h"
+#include "attribute_binding.h"
 #include "../../util/arr.h"
 #include "../../query_ctx.h"
 #include "../../datatypes/map.h"
@@ -273,6 +274,18 @@ SIValue AR_PROPERTY(SIValue *argv, int argc, void *private_data) {
 			prop_idx = GraphContext_GetAttributeID(gc, prop_name);
 		}
 
+		// property access bound to a column or an index
+		// try reading node's value from it
+		if(private_data != NULL && SI_TYPE(obj) == T_NODE &&
+		   prop_idx != ATTRIBUTE_ID_NONE) {
+			SIValue v;
+			GraphContext *gc = QueryCtx_GetGraphCtx();
+			if(AttributeBinding_Read(private_data, gc, (Node *)graph_entity,
+						prop_idx, &v)) {
+				return v;
+			}
+		}
+
 		// Retrieve the property.
 		SIValue *value = GraphEntity_GetProperty(graph_entity, prop_idx);
 		return SI_ConstValue(value);
@@ -366,6 +379,8 @@ void Register_EntityFuncs() {
 	array_append(types, T_INT64);
 	ret_type = SI_ALL;
 	func_desc = AR_FuncDescNew("property", AR_PROPERTY, 3, 3, types, ret_type, true, true);
+	AR_SetPrivateDataRoutines(func_desc, AttributeBinding_Free,
+			AttributeBinding_Clone);
 	AR_RegFunc(func_desc);
 
 	types = array_new(SIType, 1);
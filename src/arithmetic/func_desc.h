@@ -34,12 +34,17 @@ typedef void *(*AR_Func_Clone)(void *orig);
 // AR_Func_PrivateData - function pointer to a routine which produce function's private data
 typedef AggregateCtx *(*AR_Func_PrivateData)(void);
 
+// AR_Func_Combine - function pointer to a routine merging a partial aggregation
+// context 'src' into 'dst', 'src' is left to be freed by the caller
+typedef void (*AR_Func_Combine)(AggregateCtx *dst, AggregateCtx *src);
+
 // aggregation function callbacks
 typedef struct {
 	AR_Func_Free free;                  // [optional] function pointer to cleanup routine
 	AR_Func_Clone clone;                // [optional] function pointer to clone routine
 	AR_Func_Finalize finalize;          // [optional] function pointer to finalizing aggregate value routine
 	AR_Func_PrivateData private_data;   // function pointer to private data generator
+	AR_Func_Combine combine;            // [optional] function pointer to partial aggregations merge routine
 } AR_FuncCBs;
 
 typedef struct {
@@ -404,6 +404,7 @@ AST *AST_Build
 	ast->parse_result        = parse_result;
 	ast->referenced_entities = NULL;
 	ast->params_parse_result = NULL;
+	ast->query               = NULL;
 	ast->anot_ctx_collection = AST_AnnotationCtxCollection_New();
 
 	*(ast->ref_count) = 1;
@@ -442,6 +443,7 @@ AST *AST_NewSegment
 	ast->parse_result        = NULL;
 	ast->params_parse_result = NULL;
 	ast->referenced_entities = NULL;
+	ast->query               = master_ast->query;
 	ast->anot_ctx_collection = master_ast->anot_ctx_collection;
 
 	uint n = end_offset - start_offset;
@@ -708,7 +710,7 @@ const char *AST_ToString
 	return str;
 }
 
-cypher_parse_result_t *parse_query
+cypher_parse_result_t *parse_query_syntax
 (
 	const char *query  // query to parse
 ) {
@@ -716,6 +718,20 @@ cypher_parse_result_t *parse_query
 	cypher_parse_result_t *result = cypher_fparse(f, NULL, NULL, CYPHER_PARSE_SINGLE);
 	fclose(f);
 
+	return result;
+}
+
+cypher_parse_result_t *parse_query
+(
+	const char *query  // query to parse
+) {
+	return validate_query(parse_query_syntax(query));
+}
+
+cypher_parse_result_t *validate_query
+(
+	cypher_parse_result_t *result  // parsed query
+) {
 	if(!result) {
 		return NULL;
 	}
@@ -847,6 +863,7 @@ void AST_Free
 			// free the annotation contexts that have been constructed
 			AST_AnnotationCtxCollection_Free(ast->anot_ctx_collection);
 			parse_result_free(ast->parse_result);
+			if(ast->query != NULL) rm_free(ast->query);
 		}
 
 		if(ast->referenced_entities) raxFree(ast->referenced_entities);
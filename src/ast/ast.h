@@ -28,6 +28,7 @@ typedef struct {
 	uint *ref_count;                                    // A pointer to reference counter (for deletion).
 	cypher_parse_result_t *parse_result;                // Query parsing output.
 	cypher_parse_result_t *params_parse_result;         // Parameters parsing output.
+	char *query;                                        // [optional] Query text node ranges refer to.
 } AST;
 
 // checks to see if libcypher-parser reported any errors
@@ -224,12 +225,25 @@ const char **AST_BuildCallColumnNames
 	const cypher_astnode_t *return_clause
 );
 
+// parse a query without validating or rewriting it
+cypher_parse_result_t *parse_query_syntax
+(
+	const char *query  // query to parse
+);
+
 // parse a query to construct an immutable AST
 cypher_parse_result_t *parse_query
 (
 	const char *query  // query to parse
 );
 
+// validate and rewrite a parsed query
+// returns NULL if the query is invalid, in which case result is freed
+cypher_parse_result_t *validate_query
+(
+	cypher_parse_result_t *result  // parsed query
+);
+
 // parse a query parameter values only
 // the remaining query string is set in the result body
 cypher_parse_result_t *parse_params
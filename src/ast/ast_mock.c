@@ -15,6 +15,7 @@ AST *AST_MockMatchClause(AST *master_ast, cypher_astnode_t *node, bool node_is_p
 	AST *ast = rm_malloc(sizeof(AST));
 	ast->referenced_entities = master_ast->referenced_entities;
 	ast->anot_ctx_collection = master_ast->anot_ctx_collection;
+	ast->query = master_ast->query;
 	ast->free_root = true;
 	cypher_astnode_t *pattern;
 	struct cypher_input_range range = {0};
@@ -0,0 +1,292 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "ast.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../errors/errors.h"
+#include "ast_parameterize_literals.h"
+#include "../arithmetic/arithmetic_expression.h"
+#include "../arithmetic/arithmetic_expression_construct.h"
+
+#include <stdio.h>
+
+// max length of a hidden parameter name
+#define LITERAL_PARAM_NAME_LEN (sizeof(LITERAL_PARAM_PREFIX) + 11)
+
+typedef struct {
+	const cypher_astnode_t **literals;  // literals to lift
+	bool valid;                         // query can be normalized
+} _LiftCtx;
+
+static inline bool _IsNumeric
+(
+	cypher_astnode_type_t t
+) {
+	return (t == CYPHER_AST_INTEGER || t == CYPHER_AST_FLOAT);
+}
+
+// returns true if node is a literal which can be lifted
+static bool _IsLiteral
+(
+	const cypher_astnode_t *node
+) {
+	cypher_astnode_type_t t = cypher_astnode_type(node);
+	if(_IsNumeric(t) || t == CYPHER_AST_STRING) return true;
+
+	// negative numbers are lifted as a whole
+	// -9223372036854775808 is only valid once negated
+	if(t == CYPHER_AST_UNARY_OPERATOR &&
+	   cypher_ast_unary_operator_get_operator(node) == CYPHER_OP_UNARY_MINUS) {
+		const cypher_astnode_t *arg = cypher_ast_unary_operator_get_argument(node);
+		return _IsNumeric(cypher_astnode_type(arg));
+	}
+
+	return false;
+}
+
+// returns true if projection's column is named after its expression
+// e.g. RETURN n.v + 1
+static bool _ImplicitlyAliased
+(
+	const cypher_astnode_t *projection
+) {
+	const cypher_astnode_t *alias = cypher_ast_projection_get_alias(projection);
+	if(alias == NULL) return true;
+
+	// an explicit alias follows its expression, e.g. RETURN n.v + 1 AS x
+	const cypher_astnode_t *exp = cypher_ast_projection_get_expression(projection);
+	struct cypher_input_range alias_range = cypher_astnode_range(alias);
+	struct cypher_input_range exp_range   = cypher_astnode_range(exp);
+	return alias_range.start.offset < exp_range.end.offset;
+}
+
+static void _CollectLiterals
+(
+	const cypher_astnode_t *node,    // current node
+	const cypher_astnode_t *parent,  // node's parent
+	bool lift,                       // lift literals under node
+	_LiftCtx *ctx                    // lift context
+) {
+	cypher_astnode_type_t t = cypher_astnode_type(node);
+
+	if(_IsLiteral(node)) {
+		if(!lift) return;
+
+		// SKIP and LIMIT only accept integers and parameters
+		cypher_astnode_type_t parent_t = cypher_astnode_type(parent);
+		if((parent_t == CYPHER_AST_RETURN || parent_t == CYPHER_AST_WITH) &&
+		   t != CYPHER_AST_INTEGER) {
+			return;
+		}
+
+		array_append(ctx->literals, node);
+		return;
+	}
+
+	if(t == CYPHER_AST_PARAMETER) {
+		// a user parameter would collide with the hidden parameters
+		const char *name = cypher_ast_parameter_get_name(node);
+		if(strncmp(name, LITERAL_PARAM_PREFIX,
+					strlen(LITERAL_PARAM_PREFIX)) == 0) {
+			ctx->valid = false;
+		}
+		return;
+	}
+
+	// variable length bounds shape the traversal
+	// e.g. MATCH (a)-[*1..3]->(b)
+	if(t == CYPHER_AST_RANGE) return;
+
+	// projections are named after their text when unaliased
+	// and ORDER BY items are matched against projections by name
+	if(t == CYPHER_AST_PROJECTION && _ImplicitlyAliased(node)) lift = false;
+	if(t == CYPHER_AST_ORDER_BY) lift = false;
+
+	uint n = cypher_astnode_nchildren(node);
+	for(uint i = 0; i < n && ctx->valid; i++) {
+		_CollectLiterals(cypher_astnode_get_child(node, i), node, lift, ctx);
+	}
+}
+
+static int _LiteralCmp
+(
+	const void *a,
+	const void *b
+) {
+	size_t a_offset =
+		cypher_astnode_range(*(const cypher_astnode_t **)a).start.offset;
+	size_t b_offset =
+		cypher_astnode_range(*(const cypher_astnode_t **)b).start.offset;
+	return (a_offset > b_offset) - (a_offset < b_offset);
+}
+
+bool LiteralParams_Collide
+(
+	rax *params
+) {
+	if(params == NULL) return false;
+
+	size_t prefix_len = strlen(LITERAL_PARAM_PREFIX);
+	raxIterator it;
+	raxStart(&it, params);
+	raxSeek(&it, ">=", (unsigned char *)LITERAL_PARAM_PREFIX, prefix_len);
+	bool collide = raxNext(&it) && it.key_len >= prefix_len &&
+		memcmp(it.key, LITERAL_PARAM_PREFIX, prefix_len) == 0;
+	raxStop(&it);
+
+	return collide;
+}
+
+// evaluate the lifted literals
+static SIValue *_EvalLiterals
+(
+	const cypher_astnode_t **literals  // sorted literals
+) {
+	uint n = array_len(literals);
+	SIValue *values = array_new(SIValue, n);
+	for(uint i = 0; i < n; i++) {
+		AR_ExpNode *exp = AR_EXP_FromASTNode(literals[i]);
+		array_append(values, SI_CloneValue(AR_EXP_Evaluate(exp, NULL)));
+		AR_EXP_Free(exp);
+	}
+
+	return values;
+}
+
+// replace each literal in query with a reference to its hidden parameter
+static char *_Normalize
+(
+	const char *query,                  // original query
+	const cypher_astnode_t **literals   // sorted literals
+) {
+	uint n = array_len(literals);
+	size_t query_len = strlen(query);
+	char *normalized = rm_malloc(query_len + n * LITERAL_PARAM_NAME_LEN + 1);
+
+	size_t pos = 0;  // position within query
+	size_t len = 0;  // length of normalized query
+	for(uint i = 0; i < n; i++) {
+		struct cypher_input_range range = cypher_astnode_range(literals[i]);
+		memcpy(normalized + len, query + pos, range.start.offset - pos);
+		len += range.start.offset - pos;
+		len += sprintf(normalized + len, "$" LITERAL_PARAM_PREFIX "%u", i);
+		pos = range.end.offset;
+	}
+
+	memcpy(normalized + len, query + pos, query_len - pos);
+	len += query_len - pos;
+	normalized[len] = '\0';
+
+	return normalized;
+}
+
+LiteralParams *AST_ParameterizeLiterals
+(
+	const char *query,
+	const cypher_parse_result_t *result
+) {
+	ASSERT(query != NULL);
+
+	if(result == NULL) return NULL;
+
+	// invalid queries are reported once validated for execution
+	if(!cypher_parse_result_eof(result) ||
+	   cypher_parse_result_nerrors(result) > 0) {
+		return NULL;
+	}
+
+	// locate statement, skipping comments
+	const cypher_astnode_t *statement = NULL;
+	uint nroots = cypher_parse_result_nroots(result);
+	for(uint i = 0; i < nroots && statement == NULL; i++) {
+		const cypher_astnode_t *root = cypher_parse_result_get_root(result, i);
+		if(cypher_astnode_type(root) == CYPHER_AST_STATEMENT) statement = root;
+	}
+
+	if(statement == NULL) return NULL;
+
+	// only queries are cached, schema commands are left as is
+	const cypher_astnode_t *body = cypher_ast_statement_get_body(statement);
+	if(cypher_astnode_type(body) != CYPHER_AST_QUERY) return NULL;
+
+	LiteralParams *literals = NULL;
+	_LiftCtx ctx = {.literals = array_new(const cypher_astnode_t *, 0),
+		.valid = true};
+	_CollectLiterals(body, statement, true, &ctx);
+
+	uint n = array_len(ctx.literals);
+	if(!ctx.valid || n == 0) goto cleanup;
+
+	qsort(ctx.literals, n, sizeof(const cypher_astnode_t *), _LiteralCmp);
+
+	SIValue *values = _EvalLiterals(ctx.literals);
+	if(ErrorCtx_EncounteredError()) {
+		array_free_cb(values, SIValue_Free);
+		goto cleanup;
+	}
+
+	literals = rm_malloc(sizeof(LiteralParams));
+	literals->query  = _Normalize(query, ctx.literals);
+	literals->values = values;
+
+cleanup:
+	array_free(ctx.literals);
+	return literals;
+}
+
+void LiteralParams_Apply
+(
+	const LiteralParams *literals
+) {
+	ASSERT(literals != NULL);
+
+	rax *params = QueryCtx_GetParams();
+	if(params == NULL) {
+		params = raxNew();
+		QueryCtx_SetParams(params);
+	}
+
+	char name[LITERAL_PARAM_NAME_LEN];
+	uint n = array_len(literals->values);
+	for(uint i = 0; i < n; i++) {
+		SIValue *v = rm_malloc(sizeof(SIValue));
+		*v = SI_CloneValue(literals->values[i]);
+
+		int len = snprintf(name, sizeof(name), LITERAL_PARAM_PREFIX "%u", i);
+		raxInsert(params, (unsigned char *)name, len, (void *)v, NULL);
+	}
+}
+
+LiteralParams *LiteralParams_Clone
+(
+	const LiteralParams *literals
+) {
+	ASSERT(literals != NULL);
+
+	uint n = array_len(literals->values);
+	LiteralParams *clone = rm_malloc(sizeof(LiteralParams));
+
+	clone->query  = rm_strdup(literals->query);
+	clone->values = array_new(SIValue, n);
+	for(uint i = 0; i < n; i++) {
+		array_append(clone->values, SI_CloneValue(literals->values[i]));
+	}
+
+	return clone;
+}
+
+void LiteralParams_Free
+(
+	LiteralParams *literals
+) {
+	ASSERT(literals != NULL);
+
+	array_free_cb(literals->values, SIValue_Free);
+	rm_free(literals->query);
+	rm_free(literals);
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "ast.h"
+#include "../value.h"
+
+// prefix of hidden parameters introduced by literal parameterization
+#define LITERAL_PARAM_PREFIX "__lit_"
+
+// the normalized form of a query and the literals lifted out of it
+typedef struct {
+	char *query;      // normalized query string
+	SIValue *values;  // lifted literals, the i-th is bound to $__lit_i
+} LiteralParams;
+
+// returns true if a user parameter collides with the hidden parameters
+bool LiteralParams_Collide
+(
+	rax *params  // query parameters
+);
+
+// lift the numeric and string literals of a query into hidden parameters
+// such that queries differing only by their literals normalize to the same
+// query string, e.g.
+// MATCH (n {id: 42}) RETURN n.name
+// is normalized to:
+// MATCH (n {id: $__lit_0}) RETURN n.name
+//
+// literals which determine the structure of the query are kept as is:
+// variable length bounds, non-integer SKIP/LIMIT, literals within
+// unaliased projections as these name their column and ORDER BY items
+//
+// result is the unvalidated parse of query, see parse_query_syntax
+// it is left intact such that it can be validated when nothing is lifted
+// returns NULL if there are no literals to lift
+LiteralParams *AST_ParameterizeLiterals
+(
+	const char *query,                    // query string, excluding parameters
+	const cypher_parse_result_t *result   // parsed query
+);
+
+// add the lifted literals to the query's parameters
+void LiteralParams_Apply
+(
+	const LiteralParams *literals  // lifted literals
+);
+
+LiteralParams *LiteralParams_Clone
+(
+	const LiteralParams *literals  // lifted literals to clone
+);
+
+void LiteralParams_Free
+(
+	LiteralParams *literals  // lifted literals to free
+);
@@ -10,6 +10,15 @@
 #include "../schema/schema.h"
 #include "../util/arr.h"
 #include "../util/rmalloc.h"
+#include "../util/thpool/pools.h"
+#include "../util/blocked_client.h"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 // the first byte of each property in the binary stream
 // is used to indicate the type of the subsequent SIValue
@@ -22,108 +31,192 @@ typedef enum {
 	BI_ARRAY = 5,
 } TYPE;
 
+// a parsed binary blob
+// blobs are parsed without accessing the graph, string values and property
+// keys point into the blob's buffer which must outlive the parsed blob
+typedef struct {
+	SchemaType t;          // type of entities described by blob
+	char **labels;         // labels or relationship-type
+	const char **props;    // property keys
+	uint64_t entity_count; // number of entities in blob
+	NodeID *endpoints;     // edges source and destination IDs
+	SIValue *values;       // entity_count X prop_count property values
+	const char *data;      // blob buffer
+	size_t len;            // blob buffer length
+} BulkBlob;
+
 /* binary header format:
  * - entity name : null-terminated C string
  * - property count : 4-byte unsigned integer
  * [0..property_count] : null-terminated C string
  */
 
-// read the label strings from a header, update schemas, and retrieve the label IDs
-static int* _BulkInsert_ReadHeaderLabels
+// nested arrays are parsed recursively, limit nesting depth
+#define BULK_MAX_ARRAY_DEPTH 64
+
+// read 'n' bytes from the data stream
+// returns false if fewer than 'n' bytes remain
+static bool _BulkInsert_Read
 (
-	GraphContext* gc,
-	SchemaType t,
-	const char* data,
-	size_t* data_idx
+	const char *data,  // blob buffer
+	size_t data_len,   // blob buffer length
+	size_t *data_idx,  // current read position
+	void *out,         // [output] read bytes
+	size_t n           // number of bytes to read
+) {
+	if(*data_idx > data_len || data_len - *data_idx < n) return false;
+
+	memcpy(out, data + *data_idx, n);
+	*data_idx += n;
+
+	return true;
+}
+
+// read a null-terminated string from the data stream
+// returns NULL if the string is not terminated within the buffer
+static const char *_BulkInsert_ReadString
+(
+	const char *data,  // blob buffer
+	size_t data_len,   // blob buffer length
+	size_t *data_idx   // current read position
+) {
+	if(*data_idx >= data_len) return NULL;
+
+	const char *s   = data + *data_idx;
+	const char *end = memchr(s, '\0', data_len - *data_idx);
+	if(end == NULL) return NULL;
+
+	*data_idx += end - s + 1;
+
+	return s;
+}
+
+// read the label strings from a header
+static char **_BulkInsert_ReadHeaderLabels
+(
+	const char *data,
+	size_t data_len,
+	size_t *data_idx
 ) {
-	ASSERT(gc        !=  NULL);
 	ASSERT(data      !=  NULL);
 	ASSERT(data_idx  !=  NULL);
 
-    // first sequence is entity label(s)
-    const char* labels = data + *data_idx;
-    int labels_len = strlen(labels);
-    *data_idx += labels_len + 1;
+	// first sequence is entity label(s), delimited by colons
+	const char *labels = _BulkInsert_ReadString(data, data_len, data_idx);
+	if(labels == NULL) return NULL;
 
-    // array of all label IDs
-    int* label_ids = array_new(int, 1);
-    // stack variable to contain a single label
-    char label[labels_len + 1];
+	char **names = array_new(char *, 1);
 
-	while (true) {
+	while(true) {
 		// look for a colon delimiting another label
-		char* found = strchr(labels, ':');
-		if (found) {
-			ASSERT(t == SCHEMA_NODE); // only nodes can have multiple labels
-			// this entity file describes multiple labels, copy the current one
-			size_t len = found - labels;
-			memcpy(label, labels, len);
-			label[len] = '\0';
-			// update the labels pointer for the next seek
-			labels += len + 1;
-		} else {
-			// reached the last (or only) label; copy it
-			size_t len = strlen(labels);
-			// Also copy the terminating NULL character.
-			memcpy(label, labels, len + 1);
+		const char *found = strchr(labels, ':');
+		if(found == NULL) {
+			// reached the last (or only) label
+			array_append(names, rm_strdup(labels));
+			break;
 		}
 
+		array_append(names, rm_strndup(labels, found - labels));
+		labels = found + 1;
+	}
+
+	return names;
+}
+
+// retrieve the schema ID of each header label
+// schemas which do not exist are created
+static int *_BulkInsert_ResolveLabels
+(
+	GraphContext *gc,
+	SchemaType t,
+	char **labels
+) {
+	ASSERT(gc     != NULL);
+	ASSERT(labels != NULL);
+
+	uint label_count = array_len(labels);
+
+	// only nodes can have multiple labels
+	ASSERT(t == SCHEMA_NODE || label_count == 1);
+
+	int *label_ids = array_new(int, label_count);
+	for(uint i = 0; i < label_count; i++) {
 		// try to retrieve the label's schema
-		Schema* s = GraphContext_GetSchema(gc, label, t);
+		Schema *s = GraphContext_GetSchema(gc, labels[i], t);
 		// create the schema if it does not already exist
-		if (s == NULL) {
-			s = GraphContext_AddSchema(gc, label, t);
-		}
+		if(s == NULL) s = GraphContext_AddSchema(gc, labels[i], t);
 
-		// store the label ID
 		array_append(label_ids, Schema_GetID(s));
-
-		// break if we've exhausted all labels
-		if (!found) break;
 	}
 
-    return label_ids;
+	return label_ids;
 }
 
 // read the property keys from a header
-static Attribute_ID* _BulkInsert_ReadHeaderProperties
+static const char **_BulkInsert_ReadHeaderProperties
 (
-	GraphContext* gc,
-	SchemaType t,
-	const char* data,
-	size_t* data_idx,
-	uint* prop_count
+	const char *data,
+	size_t data_len,
+	size_t *data_idx
 ) {
-	ASSERT(gc          !=  NULL);
-	ASSERT(data        !=  NULL);
-	ASSERT(data_idx    !=  NULL);
-	ASSERT(prop_count  !=  NULL);
+	ASSERT(data      !=  NULL);
+	ASSERT(data_idx  !=  NULL);
+
+	// next 4 bytes are property count
+	uint32_t prop_count;
+	if(!_BulkInsert_Read(data, data_len, data_idx, &prop_count,
+				sizeof(uint32_t))) {
+		return NULL;
+	}
+
+	// each property key occupies at least one byte
+	if(prop_count > data_len - *data_idx) return NULL;
 
-    // next 4 bytes are property count
-    *prop_count = *(uint*)&data[*data_idx];
-    *data_idx += sizeof(unsigned int);
+	const char **props = array_new(const char *, prop_count);
+
+	// the rest of the line is [char *prop_key] * prop_count
+	for(uint j = 0; j < prop_count; j++) {
+		const char *prop_key = _BulkInsert_ReadString(data, data_len, data_idx);
+		if(prop_key == NULL) {
+			array_free(props);
+			return NULL;
+		}
+		array_append(props, prop_key);
+	}
 
-    if (*prop_count == 0) return NULL;
+	return props;
+}
 
-    Attribute_ID* prop_indices = rm_malloc(*prop_count * sizeof(Attribute_ID));
+// retrieve the attribute ID of each header property
+// attributes which do not exist are created
+static Attribute_ID *_BulkInsert_ResolveProperties
+(
+	GraphContext *gc,
+	const char **props
+) {
+	ASSERT(gc    != NULL);
+	ASSERT(props != NULL);
 
-    // the rest of the line is [char *prop_key] * prop_count
-	for (uint j = 0; j < *prop_count; j++) {
-		char* prop_key = (char*)data + *data_idx;
-		*data_idx += strlen(prop_key) + 1;
+	uint prop_count = array_len(props);
+	if(prop_count == 0) return NULL;
 
-		// add properties to schemas
-		prop_indices[j] = GraphContext_FindOrAddAttribute(gc, prop_key, NULL);
+	Attribute_ID *prop_indices = rm_malloc(prop_count * sizeof(Attribute_ID));
+	for(uint i = 0; i < prop_count; i++) {
+		prop_indices[i] = GraphContext_FindOrAddAttribute(gc, props[i], NULL);
 	}
 
-    return prop_indices;
+	return prop_indices;
 }
 
 // read an SIValue from the data stream and update the index appropriately
-static SIValue _BulkInsert_ReadProperty
+// returns false if the stream is malformed
+static bool _BulkInsert_ReadProperty
 (
-	const char* data,
-	size_t* data_idx
+	const char *data,  // blob buffer
+	size_t data_len,   // blob buffer length
+	size_t *data_idx,  // current read position
+	uint depth,        // array nesting depth
+	SIValue *v         // [output] read value
 ) {
     // binary property format:
 	// - property type : 1-byte integer corresponding to TYPE enum
@@ -135,202 +228,317 @@ static SIValue _BulkInsert_ReadProperty
 	// - 8-byte array length followed by N values if type is array
 
     // possible property values
-    bool b;
+    uint8_t b;
     double d;
     int64_t i;
     int64_t len;
     const char* s;
 
-    SIValue v = SI_NullVal();
-    TYPE t = data[*data_idx];
-    *data_idx += 1;
+	uint8_t t;
+	*v = SI_NullVal();
+	if(!_BulkInsert_Read(data, data_len, data_idx, &t, 1)) return false;
 
 	switch (t) {
 		case BI_NULL:
-			v = SI_NullVal();
+			*v = SI_NullVal();
 			break;
 
 		case BI_BOOL:
-			b = data[*data_idx];
-			*data_idx += 1;
-			v = SI_BoolVal(b);
+			if(!_BulkInsert_Read(data, data_len, data_idx, &b, 1)) return false;
+			*v = SI_BoolVal(b);
 			break;
 
 		case BI_DOUBLE:
-			d = *(double*)&data[*data_idx];
-			*data_idx += sizeof(double);
-			v = SI_DoubleVal(d);
+			if(!_BulkInsert_Read(data, data_len, data_idx, &d, sizeof(double))) {
+				return false;
+			}
+			*v = SI_DoubleVal(d);
 			break;
 
 		case BI_LONG:
-			i = *(int64_t*)&data[*data_idx];
-			*data_idx += sizeof(int64_t);
-			v = SI_LongVal(i);
+			if(!_BulkInsert_Read(data, data_len, data_idx, &i, sizeof(int64_t))) {
+				return false;
+			}
+			*v = SI_LongVal(i);
 			break;
 
 		case BI_STRING:
-			s = data + *data_idx;
-			*data_idx += strlen(s) + 1;
+			s = _BulkInsert_ReadString(data, data_len, data_idx);
+			if(s == NULL) return false;
 			// The string itself will be cloned when added to the GraphEntity properties.
-			v = SI_ConstStringVal((char*)s);
+			*v = SI_ConstStringVal((char*)s);
 			break;
 
 		case BI_ARRAY:
+			if(depth >= BULK_MAX_ARRAY_DEPTH) return false;
 			// The first 8 bytes of a received array will be the array length.
-			len = *(int64_t*)&data[*data_idx];
-			*data_idx += sizeof(int64_t);
-			v = SIArray_New(len);
-			for (uint i = 0; i < len; i++) {
+			if(!_BulkInsert_Read(data, data_len, data_idx, &len, sizeof(int64_t))) {
+				return false;
+			}
+			// each element occupies at least one byte
+			if(len < 0 || (uint64_t)len > data_len - *data_idx) return false;
+
+			*v = SIArray_New(len);
+			for (int64_t j = 0; j < len; j++) {
 				// Convert every element and add to array.
-				SIArray_Append(&v, _BulkInsert_ReadProperty(data, data_idx));
+				SIValue elem;
+				if(!_BulkInsert_ReadProperty(data, data_len, data_idx, depth + 1,
+							&elem)) {
+					SIValue_Free(*v);
+					*v = SI_NullVal();
+					return false;
+				}
+				SIArray_Append(v, elem);
+				SIValue_Free(elem);
 			}
 			break;
 
 		default:
-			ASSERT(false);
-			break;
+			// unknown type
+			return false;
 	}
 
-    return v;
+	return true;
 }
 
-static int _BulkInsert_ProcessNodeFile
+static void _BulkInsert_FreeBlob
 (
-	GraphContext* gc,
-	const char* data,
-	size_t data_len
+	BulkBlob *blob
+) {
+	ASSERT(blob != NULL);
+
+	if(blob->labels != NULL) array_free_cb(blob->labels, rm_free);
+	if(blob->props  != NULL) array_free(blob->props);
+
+	if(blob->values != NULL) {
+		uint value_count = array_len(blob->values);
+		for(uint i = 0; i < value_count; i++) SIValue_Free(blob->values[i]);
+		array_free(blob->values);
+	}
+
+	if(blob->endpoints != NULL) array_free(blob->endpoints);
+}
+
+// parse a node or edge blob
+// the graph is not accessed, blobs can be parsed concurrently
+// returns NULL on success, otherwise an error message, in which case
+// the blob is left freed
+static const char *_BulkInsert_ParseBlob
+(
+	BulkBlob *blob,    // [output] parsed blob
+	SchemaType t,      // type of entities described by blob
+	const char *data,  // blob buffer
+	size_t data_len    // blob buffer length
 ) {
-    uint prop_count;
-    size_t data_idx = 0;
+	ASSERT(blob != NULL);
+	ASSERT(data != NULL);
+
+	size_t data_idx = 0;
+
+	blob->t            = t;
+	blob->data         = data;
+	blob->len          = data_len;
+	blob->labels       = NULL;
+	blob->props        = NULL;
+	blob->values       = NULL;
+	blob->entity_count = 0;
+	blob->endpoints    = NULL;
+
+	// read the header labels and properties
+	blob->labels = _BulkInsert_ReadHeaderLabels(data, data_len, &data_idx);
+	if(blob->labels == NULL) goto header_error;
+
+	blob->props = _BulkInsert_ReadHeaderProperties(data, data_len, &data_idx);
+	if(blob->props == NULL) goto header_error;
+
+	// edges can only have one type
+	if(t == SCHEMA_EDGE && array_len(blob->labels) != 1) {
+		_BulkInsert_FreeBlob(blob);
+		return "Bulk insert format error, "
+			"edges can only have a single relationship type.";
+	}
+
+	uint prop_count = array_len(blob->props);
+	blob->values = array_new(SIValue, 0);
+	if(t == SCHEMA_EDGE) blob->endpoints = array_new(NodeID, 0);
+
+	while(data_idx < data_len) {
+		if(t == SCHEMA_EDGE) {
+			NodeID src;
+			NodeID dest;
+			// next 8 bytes are source ID
+			// next 8 bytes are destination ID
+			if(!_BulkInsert_Read(data, data_len, &data_idx, &src, sizeof(NodeID)) ||
+			   !_BulkInsert_Read(data, data_len, &data_idx, &dest, sizeof(NodeID))) {
+				goto entity_error;
+			}
+			array_append(blob->endpoints, src);
+			array_append(blob->endpoints, dest);
+		}
+
+		// entity attributes
+		for(uint i = 0; i < prop_count; i++) {
+			SIValue v;
+			if(!_BulkInsert_ReadProperty(data, data_len, &data_idx, 0, &v)) {
+				goto entity_error;
+			}
+			array_append(blob->values, v);
+		}
+
+		blob->entity_count++;
+	}
+
+	return NULL;
+
+header_error:
+	_BulkInsert_FreeBlob(blob);
+	return "Bulk insert format error, failed to parse blob header.";
 
-    // read the CSV file header labels and update all schemas
-    int* label_ids = _BulkInsert_ReadHeaderLabels(gc, SCHEMA_NODE, data, &data_idx);
-    uint label_count = array_len(label_ids);
-    // read the CSV header properties and collect their indices
-    Attribute_ID* prop_indices = _BulkInsert_ReadHeaderProperties(gc, SCHEMA_NODE, data,
-	&data_idx, &prop_count);
+entity_error:
+	_BulkInsert_FreeBlob(blob);
+	return "Bulk insert format error, failed to parse entity.";
+}
+
+static int _BulkInsert_CommitNodes
+(
+	GraphContext *gc,
+	const BulkBlob *blob
+) {
+	// update all schemas and collect property indices
+	int *label_ids = _BulkInsert_ResolveLabels(gc, SCHEMA_NODE, blob->labels);
+	uint label_count = array_len(label_ids);
+	uint prop_count = array_len(blob->props);
+	Attribute_ID *prop_indices = _BulkInsert_ResolveProperties(gc, blob->props);
 
-    // sync each matrix once
-    ASSERT(Graph_GetMatrixPolicy(gc->g) == SYNC_POLICY_RESIZE);
+	// sync each matrix once
+	ASSERT(Graph_GetMatrixPolicy(gc->g) == SYNC_POLICY_RESIZE);
 
-	for (uint i = 0; i < label_count; i++) {
+	for(uint i = 0; i < label_count; i++) {
 		Graph_GetLabelMatrix(gc->g, label_ids[i]);
 	}
 
-    // sync node-label matrix
-    Graph_GetNodeLabelMatrix(gc->g);
-    Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_NOP);
+	// sync node-label matrix
+	Graph_GetNodeLabelMatrix(gc->g);
+	Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_NOP);
 
-    //--------------------------------------------------------------------------
-    // load nodes
-    //--------------------------------------------------------------------------
+	//--------------------------------------------------------------------------
+	// load nodes
+	//--------------------------------------------------------------------------
 
-	while (data_idx < data_len) {
+	const SIValue *values = blob->values;
+	for(uint64_t j = 0; j < blob->entity_count; j++) {
 		Node n = GE_NEW_NODE();
-		GraphEntity* ge;
 		Graph_CreateNode(gc->g, &n, label_ids, label_count);
-		ge = (GraphEntity*)&n;
 		// process entity attributes
-		for (uint i = 0; i < prop_count; i++) {
-			SIValue value = _BulkInsert_ReadProperty(data, &data_idx);
+		for(uint i = 0; i < prop_count; i++) {
+			SIValue value = *values++;
 			// skip invalid attribute values
-			if (!(SI_TYPE(value) & SI_VALID_PROPERTY_VALUE))
-				continue;
-			GraphEntity_AddProperty(ge, prop_indices[i], value);
+			if(!(SI_TYPE(value) & SI_VALID_PROPERTY_VALUE)) continue;
+			GraphEntity_AddProperty((GraphEntity *)&n, prop_indices[i], value);
 		}
 	}
 
-    Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_RESIZE);
-    if (prop_indices) rm_free(prop_indices);
-    array_free(label_ids);
+	Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_RESIZE);
+	if(prop_indices) rm_free(prop_indices);
+	array_free(label_ids);
 
-    return BULK_OK;
+	return BULK_OK;
 }
 
-static int _BulkInsert_ProcessEdgeFile
+static int _BulkInsert_CommitEdges
 (
-	GraphContext* gc,
-	const char* data,
-	size_t data_len
+	GraphContext *gc,
+	const BulkBlob *blob
 ) {
-    int relation_id;
-    uint prop_count;
-    size_t data_idx = 0;
-
-    // read the CSV file header
-    // and commit all labels and properties it introduces
-    int* type_ids = _BulkInsert_ReadHeaderLabels(gc, SCHEMA_EDGE, data, &data_idx);
-    uint type_count = array_len(type_ids);
-
-    // edges can only have one type
-    ASSERT(type_count == 1);
-
-    int type_id = type_ids[0];
-    Attribute_ID* prop_indices = _BulkInsert_ReadHeaderProperties(gc, SCHEMA_EDGE,
-	data, &data_idx, &prop_count);
-
-    // sync matrix once
-    ASSERT(Graph_GetMatrixPolicy(gc->g) == SYNC_POLICY_RESIZE);
-    Graph_GetRelationMatrix(gc->g, type_id, false);
-    Graph_GetAdjacencyMatrix(gc->g, false);
-    Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_NOP);
-
-    //--------------------------------------------------------------------------
-    // load edges
-    //--------------------------------------------------------------------------
-
-	while (data_idx < data_len) {
-		Edge e;
-		GraphEntity* ge;
-
-		// next 8 bytes are source ID
-		NodeID src = *(NodeID*)&data[data_idx];
-		data_idx += sizeof(NodeID);
-		// next 8 bytes are destination ID
-		NodeID dest = *(NodeID*)&data[data_idx];
-		data_idx += sizeof(NodeID);
-
-		Graph_CreateEdge(gc->g, src, dest, type_id, &e);
-		ge = (GraphEntity*)&e;
+	// commit all labels and properties introduced by the blob
+	int *type_ids = _BulkInsert_ResolveLabels(gc, SCHEMA_EDGE, blob->labels);
+	int type_id = type_ids[0];
+	uint prop_count = array_len(blob->props);
+	Attribute_ID *prop_indices = _BulkInsert_ResolveProperties(gc, blob->props);
+
+	// sync matrix once
+	ASSERT(Graph_GetMatrixPolicy(gc->g) == SYNC_POLICY_RESIZE);
+	Graph_GetRelationMatrix(gc->g, type_id, false);
+	Graph_GetAdjacencyMatrix(gc->g, false);
+	Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_NOP);
+
+	//--------------------------------------------------------------------------
+	// load edges
+	//--------------------------------------------------------------------------
+
+	// edges are collected and created at once, allowing an empty relation
+	// to be built in a single pass rather than one connection at a time
+	uint64_t      edge_count = blob->entity_count;
+	Edge         *edges      = rm_malloc(sizeof(Edge) * edge_count);
+	Edge        **to_create  = rm_malloc(sizeof(Edge *) * edge_count);
+	AttributeSet *sets       = rm_calloc(edge_count, sizeof(AttributeSet));
+
+	const SIValue *values = blob->values;
+	for(uint64_t j = 0; j < edge_count; j++) {
+		Edge *e = edges + j;
+
+		e->relationship = NULL;
+		e->relationID   = type_id;
+		e->src_id       = blob->endpoints[j * 2];
+		e->dest_id      = blob->endpoints[j * 2 + 1];
+		to_create[j]    = e;
 
 		// process entity attributes
-		for (uint i = 0; i < prop_count; i++) {
-			SIValue value = _BulkInsert_ReadProperty(data, &data_idx);
+		for(uint i = 0; i < prop_count; i++) {
+			SIValue value = *values++;
 			// skip invalid attribute values
-			if (!(SI_TYPE(value) & SI_VALID_PROPERTY_VALUE)) {
-				continue;
-			}
-
-			GraphEntity_AddProperty(ge, prop_indices[i], value);
+			if(!(SI_TYPE(value) & SI_VALID_PROPERTY_VALUE)) continue;
+			AttributeSet_Add(sets + j, prop_indices[i], value);
 		}
 	}
 
-    array_free(type_ids);
-    if (prop_indices) rm_free(prop_indices);
-    Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_RESIZE);
+	Graph_CreateEdges(gc->g, to_create, edge_count);
+
+	// attach attributes to the newly created edges
+	for(uint64_t j = 0; j < edge_count; j++) *edges[j].attributes = sets[j];
 
-    return BULK_OK;
+	rm_free(to_create);
+	rm_free(edges);
+	rm_free(sets);
+
+	array_free(type_ids);
+	if(prop_indices) rm_free(prop_indices);
+	Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_RESIZE);
+
+	return BULK_OK;
 }
 
-static int _BulkInsert_ProcessTokens
+// commit parsed blobs to the graph
+// node blobs are expected to precede edge blobs
+static void _BulkInsert_Commit
 (
-	GraphContext* gc,
-	int token_count,
-	RedisModuleString** argv,
-	SchemaType type
+	GraphContext *gc,       // graph context
+	const BulkBlob *blobs,  // parsed blobs
+	uint blob_count,        // number of blobs
+	uint64_t node_count,    // number of nodes to be created
+	uint64_t edge_count     // number of edges to be created
 ) {
-	for (int i = 0; i < token_count; i++) {
-		size_t len;
-		// retrieve a pointer to the next binary stream and record its length
-		const char* data = RedisModule_StringPtrLen(argv[i], &len);
-		int rc = (type == SCHEMA_NODE)
-			? _BulkInsert_ProcessNodeFile(gc, data, len)
-			: _BulkInsert_ProcessEdgeFile(gc, data, len);
+	Graph *g = gc->g;
+
+	// lock graph under write lock
+	// allocate space for new nodes and edges
+	// set graph sync policy to resize only
+	Graph_AcquireWriteLock(g);
+	Graph_SetMatrixPolicy(g, SYNC_POLICY_RESIZE);
+	Graph_AllocateNodes(g, node_count);
+	Graph_AllocateEdges(g, edge_count);
+
+	for(uint i = 0; i < blob_count; i++) {
+		int rc = (blobs[i].t == SCHEMA_NODE)
+			? _BulkInsert_CommitNodes(gc, blobs + i)
+			: _BulkInsert_CommitEdges(gc, blobs + i);
 		UNUSED(rc);
 		ASSERT(rc == BULK_OK);
 	}
 
-    return BULK_OK;
+	// reset graph sync policy
+	Graph_SetMatrixPolicy(g, SYNC_POLICY_FLUSH_RESIZE);
+	Graph_ReleaseLock(g);
 }
 
 int BulkInsert
@@ -369,51 +577,592 @@ int BulkInsert
 		return BULK_FAIL;
 	}
 
-	Graph* g = gc->g;
-	int res = BULK_OK;
+	argc -= 2;
 
-	// lock graph under write lock
-	// allocate space for new nodes and edges
-	// set graph sync policy to resize only
-	Graph_AcquireWriteLock(g);
-	Graph_SetMatrixPolicy(g, SYNC_POLICY_RESIZE);
-	Graph_AllocateNodes(g, node_count);
-	Graph_AllocateEdges(g, edge_count);
+	if(node_token_count < 0 || relation_token_count < 0 ||
+	   argc != node_token_count + relation_token_count) {
+		RedisModule_ReplyWithError(ctx, "Bulk insert format error, \
+				number of tokens does not match descriptor counts.");
+		return BULK_FAIL;
+	}
 
-	argc -= 2;
+	// parse all tokens prior to acquiring the graph's write lock
+	uint blob_count = node_token_count + relation_token_count;
+	BulkBlob *blobs = rm_malloc(sizeof(BulkBlob) * blob_count);
 
-	if (node_token_count > 0) {
-		ASSERT(argc >= node_token_count);
-		// process all node files
-		if (_BulkInsert_ProcessTokens(gc, node_token_count, argv,
-					SCHEMA_NODE)
-				!= BULK_OK) {
-			res = BULK_FAIL;
-			goto cleanup;
+	for(uint i = 0; i < blob_count; i++) {
+		size_t len;
+		SchemaType t = (i < node_token_count) ? SCHEMA_NODE : SCHEMA_EDGE;
+		// retrieve a pointer to the next binary stream and record its length
+		const char *data = RedisModule_StringPtrLen(argv[i], &len);
+		const char *err = _BulkInsert_ParseBlob(blobs + i, t, data, len);
+		if(err != NULL) {
+			// free previously parsed blobs, failed blob is already freed
+			for(uint j = 0; j < i; j++) _BulkInsert_FreeBlob(blobs + j);
+			rm_free(blobs);
+			RedisModule_ReplyWithError(ctx, err);
+			return BULK_FAIL;
 		}
-		argv += node_token_count;
-		argc -= node_token_count;
-	}
-
-	if (relation_token_count > 0) {
-		ASSERT(argc >= relation_token_count);
-		// Process all relationship files
-		if (_BulkInsert_ProcessTokens(gc, relation_token_count, argv,
-					SCHEMA_EDGE)
-				!= BULK_OK) {
-			res = BULK_FAIL;
-			goto cleanup;
+	}
+
+	_BulkInsert_Commit(gc, blobs, blob_count, node_count, edge_count);
+
+	for(uint i = 0; i < blob_count; i++) _BulkInsert_FreeBlob(blobs + i);
+	rm_free(blobs);
+
+	return BULK_OK;
+}
+
+//------------------------------------------------------------------------------
+// local file bulk load
+//------------------------------------------------------------------------------
+
+// bulk file format:
+// sequence of sections, each section wraps a single binary blob
+//  - blob type : 1-byte, 0 for nodes, 1 for edges
+//  - blob length : 8-byte unsigned integer
+//  - blob : binary blob as passed to GRAPH.BULK
+
+#define BULK_SECTION_HEADER_LEN (sizeof(uint8_t) + sizeof(uint64_t))
+
+// max number of blob bytes parsed and committed by a single batch
+// each batch is replicated as a single GRAPH.BULK command
+// a single blob larger than this is committed on its own
+#define BULK_LOAD_BATCH_SIZE (64 * 1024 * 1024)
+
+// graphContext type as it is registered at Redis
+extern RedisModuleType *GraphContextRedisModuleType;
+
+typedef struct BulkLoadCtx BulkLoadCtx;
+
+// a memory mapped bulk file
+typedef struct {
+	char *path;  // file path
+	char *data;  // mapped file content
+	size_t len;  // file length
+} BulkFile;
+
+// a single file section, parsed by a reader thread
+typedef struct {
+	SchemaType t;      // type of entities described by section
+	const char *data;  // section blob
+	size_t len;        // section blob length
+	BulkBlob blob;     // parsed blob
+	const char *err;   // parse error
+	BulkLoadCtx *ctx;  // owning bulk load
+} BulkSection;
+
+struct BulkLoadCtx {
+	RedisModuleBlockedClient *bc;  // blocked client
+	char *graph_name;              // name of graph to create
+	char *path;                    // file or directory to load
+	GraphContext *gc;              // created graph, NULL prior to first commit
+	BulkFile *files;               // mapped files
+	BulkSection *sections;         // sections, nodes followed by edges
+	uint next;                     // first section yet to be committed
+	uint64_t node_count;           // number of nodes created
+	uint64_t edge_count;           // number of edges created
+	bool replied;                  // an error has been emitted
+	uint pending;                  // number of sections being parsed
+	pthread_mutex_t lock;          // protects pending
+	pthread_cond_t parsed;         // signaled once all sections are parsed
+};
+
+static int _BulkLoad_PathCmp
+(
+	const void *a,
+	const void *b
+) {
+	return strcmp(((const BulkFile *)a)->path, ((const BulkFile *)b)->path);
+}
+
+// collect files to load
+// a directory's regular files are loaded in lexicographical order
+// symbolic links within a directory are skipped, such that a directory under
+// the bulk load root can not refer to files outside of it
+static BulkFile *_BulkLoad_CollectFiles
+(
+	const char *path,
+	const char **err
+) {
+	struct stat st;
+	if(stat(path, &st) != 0) {
+		*err = "Bulk load failed, unable to access path.";
+		return NULL;
+	}
+
+	BulkFile *files = array_new(BulkFile, 1);
+
+	if(!S_ISDIR(st.st_mode)) {
+		BulkFile f = {.path = rm_strdup(path)};
+		array_append(files, f);
+		return files;
+	}
+
+	DIR *dir = opendir(path);
+	if(dir == NULL) {
+		array_free(files);
+		*err = "Bulk load failed, unable to open directory.";
+		return NULL;
+	}
+
+	struct dirent *entry;
+	while((entry = readdir(dir)) != NULL) {
+		// skip hidden files, '.' and '..'
+		if(entry->d_name[0] == '.') continue;
+
+		size_t len = strlen(path) + strlen(entry->d_name) + 2;
+		char *file_path = rm_malloc(len);
+		snprintf(file_path, len, "%s/%s", path, entry->d_name);
+
+		if(lstat(file_path, &st) != 0 || !S_ISREG(st.st_mode)) {
+			rm_free(file_path);
+			continue;
 		}
-		argv += relation_token_count;
-		argc -= relation_token_count;
+
+		BulkFile f = {.path = file_path};
+		array_append(files, f);
 	}
 
-	ASSERT(argc == 0);
+	closedir(dir);
 
-cleanup:
-	// reset graph sync policy
-	Graph_SetMatrixPolicy(g, SYNC_POLICY_FLUSH_RESIZE);
-	Graph_ReleaseLock(g);
-	return res;
+	qsort(files, array_len(files), sizeof(BulkFile), _BulkLoad_PathCmp);
+
+	return files;
+}
+
+// memory maps a single bulk file
+// returns NULL on success, otherwise an error message
+static const char *_BulkLoad_MapFile
+(
+	BulkFile *f
+) {
+	// do not follow a link which replaced the file after it was collected
+	int fd = open(f->path, O_RDONLY | O_NOFOLLOW);
+	if(fd == -1) return "Bulk load failed, unable to open file.";
+
+	struct stat st;
+	if(fstat(fd, &st) != 0) {
+		close(fd);
+		return "Bulk load failed, unable to access file.";
+	}
+
+	f->len = st.st_size;
+	if(f->len > 0) {
+		f->data = mmap(NULL, f->len, PROT_READ, MAP_PRIVATE, fd, 0);
+	}
+	close(fd);
+
+	if(f->data == MAP_FAILED) {
+		f->data = NULL;
+		return "Bulk load failed, unable to map file.";
+	}
+
+	// file is read once, front to back
+	if(f->data != NULL) madvise(f->data, f->len, MADV_SEQUENTIAL);
+
+	return NULL;
 }
 
+// collects a mapped file's sections of type 't'
+// returns NULL on success, otherwise an error message
+static const char *_BulkLoad_ScanFile
+(
+	const BulkFile *f,       // mapped file
+	SchemaType t,            // type of sections to collect
+	BulkLoadCtx *ctx,        // bulk load
+	BulkSection **sections   // [output] collected sections
+) {
+	size_t offset = 0;
+	while(offset < f->len) {
+		if(f->len - offset < BULK_SECTION_HEADER_LEN) {
+			return "Bulk load failed, truncated section header.";
+		}
+
+		uint8_t  type = *(uint8_t *)(f->data + offset);
+		uint64_t len  = *(uint64_t *)(f->data + offset + sizeof(uint8_t));
+		offset += BULK_SECTION_HEADER_LEN;
+
+		if(type > 1) return "Bulk load failed, unknown section type.";
+
+		if(len == 0 || len > f->len - offset) {
+			return "Bulk load failed, invalid section length.";
+		}
+
+		SchemaType section_type = (type == 0) ? SCHEMA_NODE : SCHEMA_EDGE;
+		if(section_type == t) {
+			BulkSection s = {.t = t, .data = f->data + offset, .len = len,
+				.ctx = ctx};
+			array_append(*sections, s);
+		}
+
+		offset += len;
+	}
+
+	return NULL;
+}
+
+// collects, maps and scans the files to load
+// node sections of all files precede edge sections, node IDs are assigned
+// by order of appearance
+// returns NULL on success, otherwise an error message
+static const char *_BulkLoad_Prepare
+(
+	BulkLoadCtx *ctx  // bulk load
+) {
+	const char *err = NULL;
+
+	ctx->files = _BulkLoad_CollectFiles(ctx->path, &err);
+	if(ctx->files == NULL) return err;
+
+	uint file_count = array_len(ctx->files);
+	if(file_count == 0) return "Bulk load failed, no files to load.";
+
+	for(uint i = 0; i < file_count && err == NULL; i++) {
+		err = _BulkLoad_MapFile(ctx->files + i);
+	}
+
+	ctx->sections = array_new(BulkSection, file_count);
+	for(uint t = 0; t < 2 && err == NULL; t++) {
+		SchemaType type = (t == 0) ? SCHEMA_NODE : SCHEMA_EDGE;
+		for(uint i = 0; i < file_count && err == NULL; i++) {
+			err = _BulkLoad_ScanFile(ctx->files + i, type, ctx, &ctx->sections);
+		}
+	}
+
+	return err;
+}
+
+// parses a single section, executed by a reader thread
+static void _BulkLoad_ParseSection
+(
+	void *arg
+) {
+	BulkSection *s = (BulkSection *)arg;
+	BulkLoadCtx *ctx = s->ctx;
+
+	s->err = _BulkInsert_ParseBlob(&s->blob, s->t, s->data, s->len);
+
+	pthread_mutex_lock(&ctx->lock);
+	if(--ctx->pending == 0) pthread_cond_signal(&ctx->parsed);
+	pthread_mutex_unlock(&ctx->lock);
+}
+
+// replicate a committed batch as a regular bulk insert command
+// replicas are not expected to have access to the loaded files
+// the first batch creates the graph, [BEGIN] node_count edge_count
+// node_blobs edge_blobs blobs...
+static void _BulkLoad_Replicate
+(
+	RedisModuleCtx *ctx,    // redis module context
+	const GraphContext *gc, // graph context
+	const BulkBlob *blobs,  // committed blobs, all of the same type
+	uint blob_count,        // number of blobs
+	uint64_t node_count,    // number of nodes created by batch
+	uint64_t edge_count,    // number of edges created by batch
+	bool begin              // first batch
+) {
+	uint node_blob_count = (blob_count > 0 && blobs[0].t == SCHEMA_NODE)
+		? blob_count : 0;
+
+	size_t argc = blob_count + 4 + begin;
+	RedisModuleString **argv = rm_malloc(sizeof(RedisModuleString *) * argc);
+
+	size_t a = 0;
+	if(begin) argv[a++] = RedisModule_CreateString(ctx, "BEGIN", 5);
+	argv[a++] = RedisModule_CreateStringFromLongLong(ctx, node_count);
+	argv[a++] = RedisModule_CreateStringFromLongLong(ctx, edge_count);
+	argv[a++] = RedisModule_CreateStringFromLongLong(ctx, node_blob_count);
+	argv[a++] = RedisModule_CreateStringFromLongLong(ctx,
+			blob_count - node_blob_count);
+	for(uint i = 0; i < blob_count; i++) {
+		argv[a++] = RedisModule_CreateString(ctx, blobs[i].data, blobs[i].len);
+	}
+	ASSERT(a == argc);
+
+	RedisModule_Replicate(ctx, "GRAPH.BULK", "cv!", GraphContext_GetName(gc),
+			argv, argc);
+
+	for(size_t i = 0; i < argc; i++) RedisModule_FreeString(ctx, argv[i]);
+	rm_free(argv);
+}
+
+// returns true if graph's key still holds the loaded graph
+// expected to be called under the GIL
+static bool _BulkLoad_VerifyKey
+(
+	RedisModuleCtx *rm_ctx,  // redis module context
+	const BulkLoadCtx *ctx   // bulk load
+) {
+	RedisModuleString *key_name = RedisModule_CreateString(rm_ctx,
+			ctx->graph_name, strlen(ctx->graph_name));
+	RedisModuleKey *key = RedisModule_OpenKey(rm_ctx, key_name,
+			REDISMODULE_READ);
+
+	bool valid = RedisModule_ModuleTypeGetType(key) ==
+		GraphContextRedisModuleType &&
+		RedisModule_ModuleTypeGetValue(key) == ctx->gc;
+
+	RedisModule_CloseKey(key);
+	RedisModule_FreeString(rm_ctx, key_name);
+
+	return valid;
+}
+
+// creates the loaded graph, expected to be called under the GIL
+// returns NULL on success, otherwise an error message
+static const char *_BulkLoad_CreateGraph
+(
+	RedisModuleCtx *rm_ctx,  // redis module context
+	BulkLoadCtx *ctx         // bulk load
+) {
+	const char *err = NULL;
+	RedisModuleString *key_name = RedisModule_CreateString(rm_ctx,
+			ctx->graph_name, strlen(ctx->graph_name));
+
+	// the key might have been created while files were parsed
+	RedisModuleKey *key = RedisModule_OpenKey(rm_ctx, key_name,
+			REDISMODULE_READ);
+	bool exists = RedisModule_KeyType(key) != REDISMODULE_KEYTYPE_EMPTY;
+	RedisModule_CloseKey(key);
+
+	if(exists) {
+		err = "Bulk load failed, graph key was created during load.";
+	} else {
+		ctx->gc = GraphContext_Retrieve(rm_ctx, key_name, false, true);
+		// failed to retrieve GraphContext; an error has been emitted
+		if(ctx->gc == NULL) {
+			ctx->replied = true;
+			err = "";
+		}
+	}
+
+	RedisModule_FreeString(rm_ctx, key_name);
+
+	return err;
+}
+
+// parses and commits the next batch of sections
+// sections are parsed concurrently by the readers pool without holding
+// the GIL, which along with the graph's write lock is only held while
+// the parsed batch is committed
+// returns true once all sections are committed
+static bool _BulkLoad_Batch
+(
+	RedisModuleCtx *rm_ctx,  // thread safe redis module context
+	BulkLoadCtx *ctx,        // bulk load
+	const char **err         // [output] error
+) {
+	BulkSection *sections      = ctx->sections;
+	uint         section_count = array_len(sections);
+	uint         first         = ctx->next;
+	uint         last          = first;
+	size_t       batch_len     = 0;
+
+	// collect batch, a batch holds sections of a single type
+	// at least one section is committed per batch
+	while(last < section_count &&
+		  sections[last].t == sections[first].t &&
+		  (last == first || batch_len + sections[last].len <=
+		   BULK_LOAD_BATCH_SIZE)) {
+		batch_len += sections[last].len;
+		last++;
+	}
+
+	//--------------------------------------------------------------------------
+	// parse batch
+	//--------------------------------------------------------------------------
+
+	uint batch_count = last - first;
+	ctx->pending = batch_count;
+	for(uint i = first; i < last; i++) {
+		int res = ThreadPools_AddWorkReader(_BulkLoad_ParseSection,
+				sections + i, 1);
+		ASSERT(res == 0);
+		UNUSED(res);
+	}
+
+	pthread_mutex_lock(&ctx->lock);
+	while(ctx->pending > 0) pthread_cond_wait(&ctx->parsed, &ctx->lock);
+	pthread_mutex_unlock(&ctx->lock);
+
+	// failed sections are left freed by the parser
+	BulkBlob *blobs      = rm_malloc(sizeof(BulkBlob) * MAX(batch_count, 1));
+	uint      blob_count = 0;
+	uint64_t  node_count = 0;
+	uint64_t  edge_count = 0;
+
+	for(uint i = first; i < last; i++) {
+		if(sections[i].err != NULL) {
+			if(*err == NULL) *err = sections[i].err;
+			continue;
+		}
+
+		BulkBlob *blob = &sections[i].blob;
+		blobs[blob_count++] = *blob;
+		if(blob->t == SCHEMA_NODE) {
+			node_count += blob->entity_count;
+		} else {
+			edge_count += blob->entity_count;
+		}
+	}
+
+	// make sure edges connect loaded nodes
+	// all node sections are committed prior to the first edge section
+	for(uint i = 0; i < blob_count && *err == NULL; i++) {
+		uint endpoint_count = (blobs[i].endpoints != NULL)
+			? array_len(blobs[i].endpoints) : 0;
+		for(uint j = 0; j < endpoint_count; j++) {
+			if(blobs[i].endpoints[j] >= ctx->node_count) {
+				*err = "Bulk load failed, edge refers to a missing node.";
+				break;
+			}
+		}
+	}
+
+	//--------------------------------------------------------------------------
+	// commit batch
+	//--------------------------------------------------------------------------
+
+	if(*err == NULL) {
+		RedisModule_ThreadSafeContextLock(rm_ctx);
+
+		bool begin = (ctx->gc == NULL);
+		if(begin) {
+			*err = _BulkLoad_CreateGraph(rm_ctx, ctx);
+		} else if(!_BulkLoad_VerifyKey(rm_ctx, ctx)) {
+			*err = "Graph was deleted or replaced during bulk load.";
+		}
+
+		if(*err == NULL) {
+			_BulkInsert_Commit(ctx->gc, blobs, blob_count, node_count,
+					edge_count);
+			_BulkLoad_Replicate(rm_ctx, ctx->gc, blobs, blob_count,
+					node_count, edge_count, begin);
+			GraphContext_MarkWriter(rm_ctx, ctx->gc);
+
+			ctx->node_count += node_count;
+			ctx->edge_count += edge_count;
+		}
+
+		RedisModule_ThreadSafeContextUnlock(rm_ctx);
+	}
+
+	for(uint i = 0; i < blob_count; i++) _BulkInsert_FreeBlob(blobs + i);
+	rm_free(blobs);
+
+	ctx->next = last;
+
+	return ctx->next == section_count;
+}
+
+// replies to the client and releases the bulk load
+// on failure, a graph created by previous batches is deleted
+static void _BulkLoad_Conclude
+(
+	RedisModuleCtx *rm_ctx,  // thread safe redis module context
+	BulkLoadCtx *ctx,        // bulk load
+	const char *err          // error, NULL if load succeeded
+) {
+	if(ctx->gc != NULL) {
+		if(err != NULL) {
+			RedisModule_ThreadSafeContextLock(rm_ctx);
+			if(_BulkLoad_VerifyKey(rm_ctx, ctx)) {
+				RedisModuleString *key_name = RedisModule_CreateString(rm_ctx,
+						ctx->graph_name, strlen(ctx->graph_name));
+				RedisModuleKey *key = RedisModule_OpenKey(rm_ctx, key_name,
+						REDISMODULE_WRITE);
+				RedisModule_DeleteKey(key);
+				RedisModule_CloseKey(key);
+				RedisModule_FreeString(rm_ctx, key_name);
+
+				// replicas received the batches committed so far
+				RedisModule_Replicate(rm_ctx, "GRAPH.DELETE", "c!",
+						ctx->graph_name);
+			}
+			RedisModule_ThreadSafeContextUnlock(rm_ctx);
+		}
+		GraphContext_DecreaseRefCount(ctx->gc);
+	}
+
+	if(err == NULL) {
+		char reply[1024];
+		int len = snprintf(reply, 1024, "%" PRIu64 " nodes created, %" PRIu64
+				" edges created", ctx->node_count, ctx->edge_count);
+		RedisModule_ReplyWithStringBuffer(rm_ctx, reply, len);
+	} else if(!ctx->replied) {
+		RedisModule_ReplyWithError(rm_ctx, err);
+	}
+
+	if(ctx->files != NULL) {
+		uint file_count = array_len(ctx->files);
+		for(uint i = 0; i < file_count; i++) {
+			BulkFile *f = ctx->files + i;
+			if(f->data != NULL) munmap(f->data, f->len);
+			rm_free(f->path);
+		}
+		array_free(ctx->files);
+	}
+
+	if(ctx->sections != NULL) array_free(ctx->sections);
+
+	pthread_cond_destroy(&ctx->parsed);
+	pthread_mutex_destroy(&ctx->lock);
+	rm_free(ctx->graph_name);
+	rm_free(ctx->path);
+	rm_free(ctx);
+}
+
+// bulk load task executing on the writer thread
+// each task commits a single batch and re-enqueues itself
+// allowing pending write queries to execute in between batches
+static void _BulkLoad_Task
+(
+	void *arg
+) {
+	BulkLoadCtx *ctx = (BulkLoadCtx *)arg;
+	RedisModuleBlockedClient *bc = ctx->bc;
+	RedisModuleCtx *rm_ctx = RedisModule_GetThreadSafeContext(bc);
+
+	bool done = false;
+	const char *err = NULL;
+
+	if(ctx->sections == NULL) err = _BulkLoad_Prepare(ctx);
+	if(err == NULL) done = _BulkLoad_Batch(rm_ctx, ctx, &err);
+
+	if(err == NULL && !done) {
+		int res = ThreadPools_AddWorkWriter(_BulkLoad_Task, ctx, 1);
+		ASSERT(res == 0);
+		UNUSED(res);
+	} else {
+		_BulkLoad_Conclude(rm_ctx, ctx, err);
+		RedisGraph_UnblockClient(bc);
+	}
+
+	RedisModule_FreeThreadSafeContext(rm_ctx);
+}
+
+void BulkLoad
+(
+	RedisModuleCtx *ctx,
+	RedisModuleString *graph_name,
+	const char *path
+) {
+	ASSERT(ctx        != NULL);
+	ASSERT(path       != NULL);
+	ASSERT(graph_name != NULL);
+
+	BulkLoadCtx *load_ctx = rm_calloc(1, sizeof(BulkLoadCtx));
+
+	load_ctx->path       = rm_strdup(path);
+	load_ctx->graph_name = rm_strdup(RedisModule_StringPtrLen(graph_name, NULL));
+
+	pthread_mutex_init(&load_ctx->lock, NULL);
+	pthread_cond_init(&load_ctx->parsed, NULL);
+
+	// load on the writer thread, interleaved with write queries
+	load_ctx->bc = RedisGraph_BlockClient(ctx);
+	int res = ThreadPools_AddWorkWriter(_BulkLoad_Task, load_ctx, 1);
+	ASSERT(res == 0);
+	UNUSED(res);
+}
@@ -30,5 +30,20 @@ int BulkInsert(
 	uint edge_count             // Number of edges to be created.
 );
 
+/* Creates a new graph from local bulk files.
+ * 'path' is either a single file or a directory whose regular files are
+ * loaded in lexicographical order, symbolic links within a directory are
+ * skipped.
+ * The client is blocked while files are loaded on the writer thread in
+ * batches, each batch is parsed concurrently by the readers pool without
+ * holding the GIL, which along with the graph's write lock is only taken
+ * while a parsed batch is committed.
+ * Replies once the load is done, on failure the graph is deleted. */
+void BulkLoad(
+	RedisModuleCtx *ctx,            // Redis module context.
+	RedisModuleString *graph_name,  // Name of the graph to create.
+	const char *path                // File or directory to load.
+);
+
 #endif
 
@@ -7,6 +7,32 @@
 #include "cmd_bulk_insert.h"
 #include "query_ctx.h"
 #include "bulk_insert/bulk_insert.h"
+#include "configuration/config.h"
+
+#include <limits.h>
+#include <stdlib.h>
+
+// make sure graph key 'graphname' doesn't exists
+// emits an error if key already exists
+static int _Graph_Bulk_VerifyNewGraph(RedisModuleCtx *ctx,
+		RedisModuleString *rs_graph_name, const char *graphname) {
+	// lock GIL, verify that graph does not already exist
+	RedisModuleKey *key = NULL;
+	key = RedisModule_OpenKey(ctx, rs_graph_name, REDISMODULE_READ);
+	RedisModule_CloseKey(key);
+
+	if(key) {
+		char *err;
+		int rc __attribute__((unused));
+		rc = asprintf(&err, "Graph with name '%s' cannot be created, "\
+                      "as key '%s' already exists.", graphname, graphname);
+		RedisModule_ReplyWithError(ctx, err);
+		free(err);
+		return BULK_FAIL;
+	}
+
+	return BULK_OK;
+}
 
 // process "BEGIN" token, expected to be present only on first bulk-insert
 // batch, make sure graph key doesn't exists, fails if "BEGIN" token is present
@@ -30,22 +56,73 @@ static int _Graph_Bulk_Begin(RedisModuleCtx *ctx, RedisModuleString ***argv,
 	(*argv) ++;
 	(*argc) --;
 
-	// lock GIL, verify that graph does not already exist
-	RedisModuleKey *key = NULL;
-	key = RedisModule_OpenKey(ctx, rs_graph_name, REDISMODULE_READ);
-	RedisModule_CloseKey(key);
+	return _Graph_Bulk_VerifyNewGraph(ctx, rs_graph_name, graphname);
+}
 
-	if(key) {
-		char *err;
-		int rc __attribute__((unused));
-		rc = asprintf(&err, "Graph with name '%s' cannot be created, "\
-                      "as key '%s' already exists.", graphname, graphname);
-		RedisModule_ReplyWithError(ctx, err);
-		free(err);
-		return BULK_FAIL;
+// resolve a LOAD path against the configured bulk load root
+// relative paths are relative to the root
+// fails if the resolved path, symbolic links followed, is outside the root
+static bool _Graph_Bulk_ResolvePath
+(
+	const char *root,         // bulk load root, resolved
+	const char *path,         // requested path
+	char resolved[PATH_MAX]   // [output] resolved path
+) {
+	char joined[PATH_MAX];
+	if(path[0] != '/') {
+		int len = snprintf(joined, PATH_MAX, "%s/%s", root, path);
+		if(len < 0 || len >= PATH_MAX) return false;
+		path = joined;
 	}
 
-	return BULK_OK;
+	if(realpath(path, resolved) == NULL) return false;
+
+	// root "/" contains every path
+	size_t root_len = strlen(root);
+	if(root_len == 1) return true;
+
+	return strncmp(resolved, root, root_len) == 0 &&
+		(resolved[root_len] == '/' || resolved[root_len] == '\0');
+}
+
+// GRAPH.BULK <graph> LOAD <path>
+// creates a new graph from a local bulk file or directory
+// path must reside under the BULK_LOAD_ROOT directory
+static int _Graph_Bulk_Load(RedisModuleCtx *ctx,
+		RedisModuleString *rs_graph_name, const char *graphname,
+		RedisModuleString *rs_path) {
+	const char *root = NULL;
+	Config_Option_get(Config_BULK_LOAD_ROOT, &root);
+	if(root[0] == '\0') {
+		RedisModule_ReplyWithError(ctx, "Bulk load is disabled, "
+				"set BULK_LOAD_ROOT to enable it.");
+		return REDISMODULE_OK;
+	}
+
+	// loading blocks the client
+	int flags = RedisModule_GetContextFlags(ctx);
+	if(flags & (REDISMODULE_CTX_FLAGS_MULTI | REDISMODULE_CTX_FLAGS_LUA |
+				REDISMODULE_CTX_FLAGS_DENY_BLOCKING)) {
+		RedisModule_ReplyWithError(ctx, "Bulk load can not be issued "
+				"within MULTI, Lua scripts or other non-blocking contexts.");
+		return REDISMODULE_OK;
+	}
+
+	char path[PATH_MAX];
+	if(!_Graph_Bulk_ResolvePath(root, RedisModule_StringPtrLen(rs_path, NULL),
+				path)) {
+		RedisModule_ReplyWithError(ctx, "Bulk load failed, "
+				"path is not accessible under BULK_LOAD_ROOT.");
+		return REDISMODULE_OK;
+	}
+
+	if(_Graph_Bulk_VerifyNewGraph(ctx, rs_graph_name, graphname) != BULK_OK) {
+		return REDISMODULE_OK;
+	}
+
+	BulkLoad(ctx, rs_graph_name, path);
+
+	return REDISMODULE_OK;
 }
 
 int Graph_BulkInsert(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
@@ -64,6 +141,12 @@ int Graph_BulkInsert(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 	const char *graphname = RedisModule_StringPtrLen(rs_graph_name, NULL);
 	argc -= 2; // skip "GRAPH.BULK [GRAPHNAME]"
 
+	// load from local file
+	if(argc == 2 &&
+	   strcasecmp(RedisModule_StringPtrLen(*argv, NULL), "LOAD") == 0) {
+		return _Graph_Bulk_Load(ctx, rs_graph_name, graphname, argv[1]);
+	}
+
 	bool begin = false;
 	if(_Graph_Bulk_Begin(ctx, &argv, &argc, rs_graph_name, graphname, &begin)
 			!= BULK_OK) goto cleanup;
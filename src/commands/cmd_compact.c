@@ -0,0 +1,584 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+#include "../util/thpool/pools.h"
+#include "../util/simple_timer.h"
+#include "../util/blocked_client.h"
+
+// GRAPH.COMPACT <key>
+//
+// renumbers the graph's nodes and edges into dense ID ranges
+// entities holding the highest IDs are moved into vacant IDs, once no vacancy
+// remains below the entity count the graph's trailing storage is released
+//
+// compaction runs in slices, each slice holds the graph's write lock while
+// relocating a batch of entities, queries issued in the meantime are served
+// in between slices, batch size adapts such that a slice takes roughly
+// COMPACT_SLICE_MS
+//
+// each slice is replicated as an explicit step, which replicas and the AOF
+// apply as is:
+//
+// GRAPH.COMPACT <key> NODES <from> <id> [<id> ...]
+// GRAPH.COMPACT <key> EDGES <from> <id> <relation> <src> <dest> [...]
+// GRAPH.COMPACT <key> TRIM
+
+#define COMPACT_SLICE_MS     10     // targeted slice duration
+#define COMPACT_MIN_BATCH    64     // min number of entities relocated per slice
+#define COMPACT_MAX_BATCH    65536  // max number of entities relocated per slice
+#define COMPACT_SWEEP_FACTOR 16     // matrix entries visited per collected edge
+
+// graphContext type as it is registered at Redis
+extern RedisModuleType *GraphContextRedisModuleType;
+
+typedef struct {
+	GraphContext *gc;              // graph being compacted
+	RedisModuleBlockedClient *bc;  // blocked client, NULL if not blocked
+	uint64_t batch;                // number of entities relocated per slice
+	uint64_t node_from;            // lowest vacant node ID
+	uint64_t edge_from;            // lowest vacant edge ID
+	RelationID r;                  // edge sweep relation
+	NodeID row;                    // edge sweep row
+	uint64_t nodes_relocated;      // number of relocated nodes
+	uint64_t edges_relocated;      // number of relocated edges
+	size_t memory;                 // memory usage, reclaimed memory once done
+} CompactCtx;
+
+// relocation is unsafe while an index is populated or a constraint is
+// enforced, both scan the graph by ID without holding its lock throughout
+static bool _Compact_Blocked
+(
+	const GraphContext *gc
+) {
+	SchemaType types[2] = {SCHEMA_NODE, SCHEMA_EDGE};
+
+	for(int t = 0; t < 2; t++) {
+		unsigned short n = GraphContext_SchemaCount(gc, types[t]);
+		for(unsigned short i = 0; i < n; i++) {
+			Schema *s = GraphContext_GetSchemaByID(gc, i, types[t]);
+
+			Index idx[4];
+			unsigned short idx_count = Schema_GetIndicies(s, idx);
+			for(unsigned short j = 0; j < idx_count; j++) {
+				if(!Index_Enabled(idx[j])) return true;
+			}
+
+			const Constraint *cs = Schema_GetConstraints(s);
+			uint c_count = array_len((Constraint *)cs);
+			for(uint j = 0; j < c_count; j++) {
+				if(Constraint_GetStatus(cs[j]) == CT_PENDING) return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+// re-key edge within its relation-type indices
+static void _Compact_ReindexEdge
+(
+	GraphContext *gc,  // graph context
+	const Edge *old,   // edge prior to relocation
+	Edge *e            // relocated edge
+) {
+	Schema *s = GraphContext_GetSchemaByID(gc, Edge_GetRelationID(old),
+			SCHEMA_EDGE);
+	if(!Schema_HasIndices(s)) return;
+
+	Schema_RemoveEdgeFromIndices(s, old);
+	Schema_AddEdgeToIndices(s, e);
+}
+
+// relocates nodes 'src' into vacant IDs at or above 'from'
+// returns number of relocated nodes
+static uint64_t _Compact_Nodes
+(
+	GraphContext *gc,   // graph context
+	uint64_t from,      // lowest vacant node ID
+	const NodeID *src,  // nodes to relocate
+	NodeID *dst,        // [output] nodes new IDs
+	uint64_t n          // number of nodes to relocate
+) {
+	Graph *g = gc->g;
+	uint64_t relocated = Graph_RelocateNodes(g, from, src, dst, n);
+
+	Edge *edges = array_new(Edge, 0);
+
+	for(uint64_t i = 0; i < relocated; i++) {
+		Node node = GE_NEW_NODE();
+		Graph_GetNode(g, dst[i], &node);
+		Node old = {.id = src[i], .attributes = node.attributes};
+
+		// remove node from its labels indices under its old ID
+		uint label_count;
+		NODE_GET_LABELS(g, &old, label_count);
+		for(uint j = 0; j < label_count; j++) {
+			Schema *s = GraphContext_GetSchemaByID(gc, labels[j], SCHEMA_NODE);
+			if(Schema_HasIndices(s)) Schema_RemoveNodeFromIndices(s, &old);
+		}
+
+		Graph_RewireNode(g, src[i], dst[i], &edges);
+
+		for(uint j = 0; j < label_count; j++) {
+			Schema *s = GraphContext_GetSchemaByID(gc, labels[j], SCHEMA_NODE);
+			if(Schema_HasIndices(s)) Schema_AddNodeToIndices(s, &node);
+		}
+
+		// edge index documents are keyed by their endpoints
+		uint edge_count = array_len(edges);
+		for(uint j = 0; j < edge_count; j++) {
+			Edge *old_edge = edges + j;
+			Edge e = *old_edge;
+			if(e.src_id  == src[i]) e.src_id  = dst[i];
+			if(e.dest_id == src[i]) e.dest_id = dst[i];
+			_Compact_ReindexEdge(gc, old_edge, &e);
+		}
+		array_clear(edges);
+	}
+
+	array_free(edges);
+
+	// columns are indexed by node ID, drop them
+	if(relocated > 0) ColumnStore_Clear(gc->column_store);
+
+	return relocated;
+}
+
+// relocates edges into vacant IDs at or above 'from'
+// returns number of relocated edges
+static uint64_t _Compact_Edges
+(
+	GraphContext *gc,  // graph context
+	uint64_t from,     // lowest vacant edge ID
+	Edge *edges,       // edges to relocate
+	EdgeID *dst,       // [output] edges new IDs
+	uint64_t n         // number of edges to relocate
+) {
+	Graph *g = gc->g;
+	EdgeID *src = rm_malloc(sizeof(EdgeID) * n);
+	for(uint64_t i = 0; i < n; i++) src[i] = ENTITY_GET_ID(edges + i);
+
+	uint64_t relocated = Graph_RelocateEdges(g, from, src, dst, n);
+
+	for(uint64_t i = 0; i < relocated; i++) {
+		Edge *old = edges + i;
+		Graph_RewireEdge(g, old, dst[i]);
+
+		Edge e = *old;
+		Graph_GetEdge(g, dst[i], &e);
+		_Compact_ReindexEdge(gc, old, &e);
+	}
+
+	rm_free(src);
+
+	return relocated;
+}
+
+// replicate a relocation step
+static void _Compact_Replicate
+(
+	RedisModuleCtx *ctx,       // redis module context
+	const GraphContext *gc,    // graph context
+	const char *step,          // step type
+	uint64_t from,             // lowest vacant ID
+	const uint64_t *args,      // step arguments
+	uint64_t n                 // number of arguments
+) {
+	RedisModuleString **argv = rm_malloc(sizeof(RedisModuleString *) * (n + 1));
+
+	argv[0] = RedisModule_CreateStringFromLongLong(ctx, from);
+	for(uint64_t i = 0; i < n; i++) {
+		argv[i + 1] = RedisModule_CreateStringFromLongLong(ctx, args[i]);
+	}
+
+	RedisModule_Replicate(ctx, "GRAPH.COMPACT", "ccv!",
+			GraphContext_GetName(gc), step, argv, (size_t)(n + 1));
+
+	for(uint64_t i = 0; i <= n; i++) RedisModule_FreeString(ctx, argv[i]);
+	rm_free(argv);
+}
+
+// performs a single compaction step, graph is expected to be write locked
+// returns true once compaction is done
+static bool _Compact_Step
+(
+	RedisModuleCtx *rm_ctx,  // redis module context
+	CompactCtx *ctx          // compaction context
+) {
+	bool          done  = false;
+	GraphContext *gc    = ctx->gc;
+	Graph        *g     = gc->g;
+	uint64_t      n     = ctx->batch;
+
+	simple_timer_t timer;
+	simple_tic(timer);
+
+	if(Graph_NodesFragmented(g)) {
+		//----------------------------------------------------------------------
+		// relocate nodes
+		//----------------------------------------------------------------------
+
+		NodeID *src = rm_malloc(sizeof(NodeID) * n);
+		NodeID *dst = rm_malloc(sizeof(NodeID) * n);
+
+		uint64_t collected = Graph_TrailingNodes(g, n, src);
+		uint64_t relocated = _Compact_Nodes(gc, ctx->node_from, src, dst,
+				collected);
+
+		if(relocated > 0) {
+			_Compact_Replicate(rm_ctx, gc, "NODES", ctx->node_from, src,
+					relocated);
+		}
+
+		// vacancies below 'from' were introduced in the meantime, start over
+		ctx->node_from = (relocated == 0 || relocated < collected)
+			? 0
+			: dst[relocated - 1] + 1;
+		ctx->nodes_relocated += relocated;
+
+		rm_free(src);
+		rm_free(dst);
+	} else if(Graph_EdgesFragmented(g)) {
+		//----------------------------------------------------------------------
+		// relocate edges
+		//----------------------------------------------------------------------
+
+		Edge   *edges = rm_malloc(sizeof(Edge) * n);
+		EdgeID *dst   = rm_malloc(sizeof(EdgeID) * n);
+
+		uint64_t collected = Graph_TrailingEdges(g, &ctx->r, &ctx->row,
+				n * COMPACT_SWEEP_FACTOR, n, edges);
+		uint64_t relocated = _Compact_Edges(gc, ctx->edge_from, edges, dst,
+				collected);
+
+		if(relocated > 0) {
+			uint64_t *args = rm_malloc(sizeof(uint64_t) * relocated * 4);
+			for(uint64_t i = 0; i < relocated; i++) {
+				Edge *e = edges + i;
+				args[i * 4 + 0] = ENTITY_GET_ID(e);
+				args[i * 4 + 1] = Edge_GetRelationID(e);
+				args[i * 4 + 2] = Edge_GetSrcNodeID(e);
+				args[i * 4 + 3] = Edge_GetDestNodeID(e);
+			}
+			_Compact_Replicate(rm_ctx, gc, "EDGES", ctx->edge_from, args,
+					relocated * 4);
+			rm_free(args);
+
+			ctx->edge_from = dst[relocated - 1] + 1;
+		}
+
+		if(relocated < collected) ctx->edge_from = 0;
+		ctx->edges_relocated += relocated;
+
+		rm_free(dst);
+		rm_free(edges);
+	} else {
+		//----------------------------------------------------------------------
+		// release trailing storage
+		//----------------------------------------------------------------------
+
+		bool trimmed = Graph_Trim(g);
+		ASSERT(trimmed);
+		UNUSED(trimmed);
+		RedisModule_Replicate(rm_ctx, "GRAPH.COMPACT", "cc!",
+				GraphContext_GetName(gc), "TRIM");
+		done = true;
+	}
+
+	GraphContext_MarkWriter(rm_ctx, gc);
+
+	// adapt batch size to the targeted slice duration
+	double elapsed = TIMER_GET_ELAPSED_MILLISECONDS(timer);
+	if(elapsed < COMPACT_SLICE_MS / 2 && ctx->batch < COMPACT_MAX_BATCH) {
+		ctx->batch *= 2;
+	} else if(elapsed > COMPACT_SLICE_MS * 2 && ctx->batch > COMPACT_MIN_BATCH) {
+		ctx->batch /= 2;
+	}
+
+	return done;
+}
+
+// concludes compaction, computing the amount of memory reclaimed
+// expected to be called under the GIL and the graph's write lock
+static void _Compact_Conclude
+(
+	CompactCtx *ctx  // compaction context
+) {
+	GraphContext *gc = ctx->gc;
+
+	size_t memory = Graph_MemoryUsage(gc->g);
+	ctx->memory = (ctx->memory > memory) ? ctx->memory - memory : 0;
+
+	gc->compacting = false;
+}
+
+// reply with compaction statistics and release compaction context
+static void _Compact_Reply
+(
+	RedisModuleCtx *rm_ctx,  // redis module context
+	CompactCtx *ctx,         // compaction context
+	const char *err          // error, NULL if compaction succeeded
+) {
+	if(err != NULL) {
+		RedisModule_ReplyWithError(rm_ctx, err);
+	} else {
+		int  len;
+		char buff[64];
+
+		RedisModule_ReplyWithArray(rm_ctx, 3);
+
+		len = snprintf(buff, sizeof(buff), "Nodes relocated: %" PRIu64,
+				ctx->nodes_relocated);
+		RedisModule_ReplyWithStringBuffer(rm_ctx, buff, len);
+
+		len = snprintf(buff, sizeof(buff), "Relationships relocated: %" PRIu64,
+				ctx->edges_relocated);
+		RedisModule_ReplyWithStringBuffer(rm_ctx, buff, len);
+
+		len = snprintf(buff, sizeof(buff), "Memory reclaimed: %zu bytes",
+				ctx->memory);
+		RedisModule_ReplyWithStringBuffer(rm_ctx, buff, len);
+	}
+
+	GraphContext_DecreaseRefCount(ctx->gc);
+	rm_free(ctx);
+}
+
+// returns true if graph's key still holds 'gc'
+static bool _Compact_VerifyKey
+(
+	RedisModuleCtx *rm_ctx,  // redis module context
+	const GraphContext *gc   // graph context
+) {
+	const char *name = GraphContext_GetName(gc);
+	RedisModuleString *key_name = RedisModule_CreateString(rm_ctx, name,
+			strlen(name));
+	RedisModuleKey *key = RedisModule_OpenKey(rm_ctx, key_name,
+			REDISMODULE_READ);
+
+	bool valid = RedisModule_ModuleTypeGetType(key) ==
+		GraphContextRedisModuleType &&
+		RedisModule_ModuleTypeGetValue(key) == gc;
+
+	RedisModule_CloseKey(key);
+	RedisModule_FreeString(rm_ctx, key_name);
+
+	return valid;
+}
+
+// performs a single compaction step under the GIL and the graph's write lock
+// returns true once compaction is done
+static bool _Compact_Slice
+(
+	RedisModuleCtx *rm_ctx,  // thread safe redis module context
+	CompactCtx *ctx,         // compaction context
+	const char **err         // [output] error
+) {
+	bool done = false;
+	GraphContext *gc = ctx->gc;
+
+	GraphContext_LockForCommit(rm_ctx, gc);
+
+	if(!_Compact_VerifyKey(rm_ctx, gc)) {
+		*err = "Graph was deleted or replaced during compaction";
+	} else if(_Compact_Blocked(gc)) {
+		*err = "Graph is being indexed, compaction aborted";
+	} else {
+		done = _Compact_Step(rm_ctx, ctx);
+	}
+
+	if(done || *err != NULL) _Compact_Conclude(ctx);
+
+	GraphContext_UnlockCommit(rm_ctx, gc);
+
+	return done || *err != NULL;
+}
+
+// compaction task executing on the writer thread
+// each task performs a single slice and re-enqueues itself
+// allowing pending write queries to execute in between slices
+static void _Compact_Task
+(
+	void *arg
+) {
+	CompactCtx *ctx = (CompactCtx *)arg;
+	RedisModuleBlockedClient *bc = ctx->bc;
+	RedisModuleCtx *rm_ctx = RedisModule_GetThreadSafeContext(bc);
+
+	const char *err = NULL;
+	if(!_Compact_Slice(rm_ctx, ctx, &err)) {
+		int res = ThreadPools_AddWorkWriter(_Compact_Task, ctx, 1);
+		ASSERT(res == 0);
+		UNUSED(res);
+	} else {
+		_Compact_Reply(rm_ctx, ctx, err);
+		RedisGraph_UnblockClient(bc);
+	}
+
+	RedisModule_FreeThreadSafeContext(rm_ctx);
+}
+
+// parse unsigned integer argument
+static bool _Compact_ParseID
+(
+	RedisModuleString *arg,  // argument to parse
+	uint64_t *id             // [output] parsed value
+) {
+	long long v;
+	if(RedisModule_StringToLongLong(arg, &v) != REDISMODULE_OK || v < 0) {
+		return false;
+	}
+
+	*id = v;
+	return true;
+}
+
+// applies a replicated compaction step
+// GRAPH.COMPACT <key> NODES <from> <id> [<id> ...]
+// GRAPH.COMPACT <key> EDGES <from> <id> <relation> <src> <dest> [...]
+// GRAPH.COMPACT <key> TRIM
+static int _Compact_Apply
+(
+	RedisModuleCtx *ctx,
+	RedisModuleString **argv,
+	int argc
+) {
+	ASSERT(argc >= 3);
+
+	uint64_t      from;
+	const char   *err  = NULL;
+	const char   *step = RedisModule_StringPtrLen(argv[2], NULL);
+	GraphContext *gc   = GraphContext_Retrieve(ctx, argv[1], false, false);
+	if(gc == NULL) return REDISMODULE_OK;
+
+	Graph *g = gc->g;
+	Graph_AcquireWriteLock(g);
+
+	if(strcasecmp(step, "TRIM") == 0 && argc == 3) {
+		// replica diverged from the master, don't release occupied IDs
+		if(!Graph_Trim(g)) err = "Graph is fragmented, trim skipped";
+	} else if(strcasecmp(step, "NODES") == 0 && argc > 4 &&
+			_Compact_ParseID(argv[3], &from)) {
+		uint64_t n   = argc - 4;
+		NodeID  *src = rm_malloc(sizeof(NodeID) * n);
+		NodeID  *dst = rm_malloc(sizeof(NodeID) * n);
+
+		for(uint64_t i = 0; i < n && err == NULL; i++) {
+			if(!_Compact_ParseID(argv[4 + i], src + i)) err = "Invalid node ID";
+		}
+
+		if(err == NULL && _Compact_Nodes(gc, from, src, dst, n) != n) {
+			err = "Failed to relocate nodes";
+		}
+
+		rm_free(src);
+		rm_free(dst);
+	} else if(strcasecmp(step, "EDGES") == 0 && argc > 4 &&
+			(argc - 4) % 4 == 0 && _Compact_ParseID(argv[3], &from)) {
+		uint64_t n     = (argc - 4) / 4;
+		Edge    *edges = rm_malloc(sizeof(Edge) * n);
+		EdgeID  *dst   = rm_malloc(sizeof(EdgeID) * n);
+
+		for(uint64_t i = 0; i < n && err == NULL; i++) {
+			uint64_t v[4];
+			for(int j = 0; j < 4; j++) {
+				if(!_Compact_ParseID(argv[4 + i * 4 + j], v + j)) {
+					err = "Invalid relationship";
+				}
+			}
+			if(err != NULL) break;
+
+			Edge *e       = edges + i;
+			e->id         = v[0];
+			e->relationID = v[1];
+			e->src_id     = v[2];
+			e->dest_id    = v[3];
+			e->attributes = NULL;
+		}
+
+		if(err == NULL && _Compact_Edges(gc, from, edges, dst, n) != n) {
+			err = "Failed to relocate relationships";
+		}
+
+		rm_free(dst);
+		rm_free(edges);
+	} else {
+		err = "Invalid compaction step";
+	}
+
+	Graph_ReleaseLock(g);
+
+	if(err != NULL) {
+		RedisModule_ReplyWithError(ctx, err);
+	} else {
+		RedisModule_ReplyWithSimpleString(ctx, "OK");
+	}
+
+	GraphContext_DecreaseRefCount(gc);
+
+	return REDISMODULE_OK;
+}
+
+// command handler for GRAPH.COMPACT command
+// GRAPH.COMPACT <key>
+int Graph_Compact
+(
+	RedisModuleCtx *ctx,
+	RedisModuleString **argv,
+	int argc
+) {
+	if(argc < 2) {
+		return RedisModule_WrongArity(ctx);
+	}
+
+	int flags = RedisModule_GetContextFlags(ctx);
+
+	// explicit steps are only accepted from the master or the AOF
+	if(argc > 2) {
+		if(flags & (REDISMODULE_CTX_FLAGS_REPLICATED |
+					REDISMODULE_CTX_FLAGS_LOADING)) {
+			return _Compact_Apply(ctx, argv, argc);
+		}
+		return RedisModule_WrongArity(ctx);
+	}
+
+	// compaction blocks the client, it must not run on the main thread
+	if(flags & (REDISMODULE_CTX_FLAGS_MULTI | REDISMODULE_CTX_FLAGS_LUA |
+				REDISMODULE_CTX_FLAGS_DENY_BLOCKING)) {
+		RedisModule_ReplyWithError(ctx, "Compaction can not be issued "
+				"within MULTI, Lua scripts or other non-blocking contexts.");
+		return REDISMODULE_OK;
+	}
+
+	GraphContext *gc = GraphContext_Retrieve(ctx, argv[1], false, false);
+	if(gc == NULL) return REDISMODULE_OK;
+
+	if(gc->compacting) {
+		RedisModule_ReplyWithError(ctx, "Graph is already being compacted");
+		GraphContext_DecreaseRefCount(gc);
+		return REDISMODULE_OK;
+	}
+
+	CompactCtx *compact_ctx = rm_calloc(1, sizeof(CompactCtx));
+
+	compact_ctx->gc     = gc;
+	compact_ctx->batch  = COMPACT_MIN_BATCH;
+	compact_ctx->memory = Graph_MemoryUsage(gc->g);
+
+	gc->compacting = true;
+
+	// compact on the writer thread, interleaved with write queries
+	compact_ctx->bc = RedisGraph_BlockClient(ctx);
+	int res = ThreadPools_AddWorkWriter(_Compact_Task, compact_ctx, 1);
+	ASSERT(res == 0);
+	UNUSED(res);
+
+	return REDISMODULE_OK;
+}
@@ -8,6 +8,28 @@
 #include "RG.h"
 #include "configuration/config.h"
 
+// reply with a configuration's name and value
+// string valued configurations are replied as strings
+static void _Config_reply_field
+(
+	RedisModuleCtx *ctx,
+	Config_Option_Field field,
+	const char *config_name
+) {
+	RedisModule_ReplyWithArray(ctx, 2);
+	RedisModule_ReplyWithCString(ctx, config_name);
+
+	if(field == Config_BULK_LOAD_ROOT) {
+		const char *value = NULL;
+		Config_Option_get(field, &value);
+		RedisModule_ReplyWithCString(ctx, value);
+	} else {
+		long long value = 0;
+		Config_Option_get(field, &value);
+		RedisModule_ReplyWithLongLong(ctx, value);
+	}
+}
+
 void _Config_get_all
 (
 	RedisModuleCtx *ctx
@@ -16,17 +38,13 @@ void _Config_get_all
 	RedisModule_ReplyWithArray(ctx, config_count);
 
 	for(Config_Option_Field field = 0; field < Config_END_MARKER; field++) {
-		long long value = 0;
 		const char *config_name = Config_Field_name(field);
-		bool res = Config_Option_get(field, &value);
 
-		if(!res || config_name == NULL) {
+		if(config_name == NULL) {
 			RedisModule_ReplyWithError(ctx, "Configuration field was not found");
 			return;
 		} else {
-			RedisModule_ReplyWithArray(ctx, 2);
-			RedisModule_ReplyWithCString(ctx, config_name);
-			RedisModule_ReplyWithLongLong(ctx, value);
+			_Config_reply_field(ctx, field, config_name);
 		}
 	}
 }
@@ -53,15 +71,7 @@ void _Config_get
 		return;
 	}
 
-	long long value = 0;
-
-	if(Config_Option_get(config_field, &value)) {
-		RedisModule_ReplyWithArray(ctx, 2);
-		RedisModule_ReplyWithCString(ctx, config_name);
-		RedisModule_ReplyWithLongLong(ctx, value);
-	} else {
-		RedisModule_ReplyWithError(ctx, "Configuration field was not found");
-	}
+	_Config_reply_field(ctx, config_field, config_name);
 }
 
 void _Config_set
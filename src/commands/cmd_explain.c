@@ -34,7 +34,8 @@ void Graph_Explain(void *args) {
 	// 2. Whether these items were cached or not
 	bool           cached = false;
 	ExecutionPlan  *plan  = NULL;
-	exec_ctx  =  ExecutionCtx_FromQuery(command_ctx->query);
+	// literals are kept in place, the printed plan reflects the query as given
+	exec_ctx  =  ExecutionCtx_FromQuery(command_ctx->query, false);
 	if (exec_ctx == NULL) {
 		query_ctx->status = QueryExecutionStatus_FAILURE;
 		goto cleanup;
@@ -9,6 +9,8 @@
 #include "../globals.h"
 #include "redismodule.h"
 #include "cmd_context.h"
+#include "../graph/compactor.h"
+#include "../util/cache/cache.h"
 #include "../util/thpool/pools.h"
 
 #include <ctype.h>
@@ -21,8 +23,33 @@
 #define RECEIVED_TIMESTAMP_KEY_NAME "Received at"
 #define EXECUTION_DURATION_KEY_NAME "Execution duration"
 
+#define COMPACTOR_RUNS_KEY_NAME     "Runs"
+#define COMPACTIONS_KEY_NAME        "Compacted matrices"
+#define ABORTED_KEY_NAME            "Aborted compactions"
+#define FOLDED_CHANGES_KEY_NAME     "Folded changes"
+#define COMPACTION_TIME_KEY_NAME    "Compaction time"
+#define COMPACTOR_INTERVAL_KEY_NAME "Interval"
+
+#define CACHE_HITS_KEY_NAME         "Cache hits"
+#define CACHE_MISSES_KEY_NAME       "Cache misses"
+
+#define COLUMNS_KEY_NAME            "Columns"
+#define COLUMNS_MEMORY_KEY_NAME     "Column memory"
+
+#define INDEXES_KEY_NAME            "Exact-match indexes"
+#define STORED_MEMORY_KEY_NAME      "Stored value memory"
+
+#define RAW_BYTES_KEY_NAME          "Entity bytes"
+#define ENCODED_BYTES_KEY_NAME      "Encoded entity bytes"
+#define COMPRESSION_RATIO_KEY_NAME  "Compression ratio"
+
 #define SUBCOMMAND_NAME_RUNNING_QUERIES "RunningQueries"
 #define SUBCOMMAND_NAME_WAITING_QUERIES "WaitingQueries"
+#define SUBCOMMAND_NAME_COMPACTION      "Compaction"
+#define SUBCOMMAND_NAME_CACHE           "Cache"
+#define SUBCOMMAND_NAME_COLUMNAR_STORE  "ColumnarStore"
+#define SUBCOMMAND_NAME_INDEXES         "Indexes"
+#define SUBCOMMAND_NAME_PERSISTENCE     "Persistence"
 
 //------------------------------------------------------------------------------
 // Info section API
@@ -240,6 +267,220 @@ static void _info_waiting_queries
 	free(cmds);
 }
 
+// handles the "GRAPH.INFO Compaction" section
+// "GRAPH.INFO Compaction"
+static void _info_compaction
+(
+	RedisModuleCtx *ctx  // redis context
+) {
+	// an example for a command and reply:
+	// command:
+	// GRAPH.INFO Compaction
+	// reply:
+	// "# Compaction"
+	//     "Runs"
+	//     "Compacted matrices"
+	//     "Aborted compactions"
+	//     "Folded changes"
+	//     "Compaction time"
+	//     "Interval"
+
+	ASSERT(ctx != NULL);
+
+	CompactorStats stats;
+	Compactor_GetStats(&stats);
+
+	Info_AddSection(ctx, "# Compaction", 6 * 2);
+
+	Info_SectionAddEntryLongLong(ctx, COMPACTOR_RUNS_KEY_NAME, stats.runs);
+	Info_SectionAddEntryLongLong(ctx, COMPACTIONS_KEY_NAME, stats.compactions);
+	Info_SectionAddEntryLongLong(ctx, ABORTED_KEY_NAME, stats.aborted);
+	Info_SectionAddEntryLongLong(ctx, FOLDED_CHANGES_KEY_NAME,
+			stats.folded_changes);
+
+	// compaction time in milliseconds
+	Info_SectionAddEntryDouble(ctx, COMPACTION_TIME_KEY_NAME,
+			stats.time_us / 1000.0);
+
+	// current wake up interval in milliseconds
+	Info_SectionAddEntryLongLong(ctx, COMPACTOR_INTERVAL_KEY_NAME,
+			stats.interval);
+}
+
+// handles the "GRAPH.INFO Cache" section
+// "GRAPH.INFO Cache"
+static void _info_cache
+(
+	RedisModuleCtx *ctx  // redis context
+) {
+	// an example for a command and reply:
+	// command:
+	// GRAPH.INFO Cache
+	// reply:
+	// "# Cache"
+	//     "Cache hits"
+	//     "Cache misses"
+
+	ASSERT(ctx != NULL);
+
+	// sum up the execution plan caches of all graphs in keyspace
+	uint64_t hits   = 0;
+	uint64_t misses = 0;
+
+	GraphContext *gc = NULL;
+	KeySpaceGraphIterator it;
+	Globals_ScanGraphs(&it);
+
+	while((gc = GraphIterator_Next(&it)) != NULL) {
+		uint64_t gc_hits;
+		uint64_t gc_misses;
+		Cache_GetStats(GraphContext_GetCache(gc), &gc_hits, &gc_misses);
+		hits   += gc_hits;
+		misses += gc_misses;
+		GraphContext_DecreaseRefCount(gc);
+	}
+
+	Info_AddSection(ctx, "# Cache", 2 * 2);
+
+	Info_SectionAddEntryLongLong(ctx, CACHE_HITS_KEY_NAME, hits);
+	Info_SectionAddEntryLongLong(ctx, CACHE_MISSES_KEY_NAME, misses);
+}
+
+// handles the "GRAPH.INFO ColumnarStore" section
+// "GRAPH.INFO ColumnarStore"
+static void _info_columnar_store
+(
+	RedisModuleCtx *ctx  // redis context
+) {
+	// an example for a command and reply:
+	// command:
+	// GRAPH.INFO ColumnarStore
+	// reply:
+	// "# Columnar store"
+	//     "Columns"
+	//     "Column memory"
+
+	ASSERT(ctx != NULL);
+
+	// sum up the columnar stores of all graphs in keyspace
+	uint64_t columns = 0;
+	size_t   memory  = 0;
+
+	GraphContext *gc = NULL;
+	KeySpaceGraphIterator it;
+	Globals_ScanGraphs(&it);
+
+	while((gc = GraphIterator_Next(&it)) != NULL) {
+		uint64_t gc_columns;
+		size_t   gc_memory;
+		ColumnStore_GetStats(gc->column_store, &gc_columns, &gc_memory);
+		columns += gc_columns;
+		memory  += gc_memory;
+		GraphContext_DecreaseRefCount(gc);
+	}
+
+	Info_AddSection(ctx, "# Columnar store", 2 * 2);
+
+	Info_SectionAddEntryLongLong(ctx, COLUMNS_KEY_NAME, columns);
+
+	// column memory in bytes
+	Info_SectionAddEntryLongLong(ctx, COLUMNS_MEMORY_KEY_NAME, memory);
+}
+
+// handles the "GRAPH.INFO Indexes" section
+// "GRAPH.INFO Indexes"
+static void _info_indexes
+(
+	RedisModuleCtx *ctx  // redis context
+) {
+	// an example for a command and reply:
+	// command:
+	// GRAPH.INFO Indexes
+	// reply:
+	// "# Indexes"
+	//     "Exact-match indexes"
+	//     "Stored value memory"
+
+	ASSERT(ctx != NULL);
+
+	// sum up the active exact-match indexes of all graphs in keyspace
+	// indexes are activated and dropped under the GIL
+	uint64_t indexes = 0;
+	size_t   memory  = 0;
+
+	GraphContext *gc = NULL;
+	KeySpaceGraphIterator it;
+	Globals_ScanGraphs(&it);
+
+	while((gc = GraphIterator_Next(&it)) != NULL) {
+		SchemaType types[2] = {SCHEMA_NODE, SCHEMA_EDGE};
+		for(int t = 0; t < 2; t++) {
+			unsigned short n = GraphContext_SchemaCount(gc, types[t]);
+			for(unsigned short i = 0; i < n; i++) {
+				Schema *s = GraphContext_GetSchemaByID(gc, i, types[t]);
+				Index idx = ACTIVE_EXACTMATCH_IDX(s);
+				if(idx == NULL || Index_OrderedIndex(idx) == NULL) continue;
+
+				indexes++;
+				memory += OrderedIndex_StoredMemory(Index_OrderedIndex(idx));
+			}
+		}
+		GraphContext_DecreaseRefCount(gc);
+	}
+
+	Info_AddSection(ctx, "# Indexes", 2 * 2);
+
+	Info_SectionAddEntryLongLong(ctx, INDEXES_KEY_NAME, indexes);
+
+	// bytes held by index entries to answer index-only scans
+	Info_SectionAddEntryLongLong(ctx, STORED_MEMORY_KEY_NAME, memory);
+}
+
+// handles the "GRAPH.INFO Persistence" section
+// "GRAPH.INFO Persistence"
+static void _info_persistence
+(
+	RedisModuleCtx *ctx  // redis context
+) {
+	// an example for a command and reply:
+	// command:
+	// GRAPH.INFO Persistence
+	// reply:
+	// "# Persistence"
+	//     "Entity bytes"
+	//     "Encoded entity bytes"
+	//     "Compression ratio"
+
+	ASSERT(ctx != NULL);
+
+	// sum up the last completed encoding of all graphs in keyspace
+	// either a save on the main thread or a load
+	// encodings performed by a forked child aren't visible to this process
+	uint64_t raw     = 0;
+	uint64_t encoded = 0;
+
+	GraphContext *gc = NULL;
+	KeySpaceGraphIterator it;
+	Globals_ScanGraphs(&it);
+
+	while((gc = GraphIterator_Next(&it)) != NULL) {
+		uint64_t gc_raw;
+		uint64_t gc_encoded;
+		GraphEncodeContext_GetLastEncodedBytes(gc->encoding_context, &gc_raw,
+				&gc_encoded);
+		raw     += gc_raw;
+		encoded += gc_encoded;
+		GraphContext_DecreaseRefCount(gc);
+	}
+
+	Info_AddSection(ctx, "# Persistence", 3 * 2);
+
+	Info_SectionAddEntryLongLong(ctx, RAW_BYTES_KEY_NAME, raw);
+	Info_SectionAddEntryLongLong(ctx, ENCODED_BYTES_KEY_NAME, encoded);
+	Info_SectionAddEntryDouble(ctx, COMPRESSION_RATIO_KEY_NAME,
+			(encoded == 0) ? 1 : (double)raw / encoded);
+}
+
 // attempts to find the specified sections of "GRAPH.INFO" and dispatch it
 static void _handle_sections
 (
@@ -251,6 +492,11 @@ static void _handle_sections
 	ASSERT(argv   != NULL);
 
 	int section_count = 0;
+	bool cache = false;
+	bool compaction = false;
+	bool indexes = false;
+	bool persistence = false;
+	bool columnar_store = false;
 	bool running_queries = false;
 	bool waiting_queries = false;
 
@@ -269,6 +515,26 @@ static void _handle_sections
 					  !strcasecmp(subcmd, SUBCOMMAND_NAME_WAITING_QUERIES)) {
 				waiting_queries = true;
 				section_count++;
+			} else if(!compaction &&
+					  !strcasecmp(subcmd, SUBCOMMAND_NAME_COMPACTION)) {
+				compaction = true;
+				section_count++;
+			} else if(!cache &&
+					  !strcasecmp(subcmd, SUBCOMMAND_NAME_CACHE)) {
+				cache = true;
+				section_count++;
+			} else if(!columnar_store &&
+					  !strcasecmp(subcmd, SUBCOMMAND_NAME_COLUMNAR_STORE)) {
+				columnar_store = true;
+				section_count++;
+			} else if(!indexes &&
+					  !strcasecmp(subcmd, SUBCOMMAND_NAME_INDEXES)) {
+				indexes = true;
+				section_count++;
+			} else if(!persistence &&
+					  !strcasecmp(subcmd, SUBCOMMAND_NAME_PERSISTENCE)) {
+				persistence = true;
+				section_count++;
 			}
 		}
 	}
@@ -285,11 +551,27 @@ static void _handle_sections
 	if(waiting_queries) {
 		_info_waiting_queries(ctx);
 	}
+	if(compaction) {
+		_info_compaction(ctx);
+	}
+	if(cache) {
+		_info_cache(ctx);
+	}
+	if(columnar_store) {
+		_info_columnar_store(ctx);
+	}
+	if(indexes) {
+		_info_indexes(ctx);
+	}
+	if(persistence) {
+		_info_persistence(ctx);
+	}
 }
 
 // graph.info command handler
 // GRAPH.INFO [Section [Section ...]]
-// GRAPH.INFO RunningQueries WaitingQueries
+// GRAPH.INFO RunningQueries WaitingQueries Compaction Cache ColumnarStore
+//            Indexes Persistence
 int Graph_Info
 (
 	RedisModuleCtx *ctx,       // redis module context
@@ -124,6 +124,27 @@ static bool abort_and_check_timeout
 	return has_timed_out;
 }
 
+// returns true if a write query can't fail once it has modified the graph
+// in which case the query requires no undo-log
+// a query fails after modifying the graph if evaluation follows its write
+// operation, it times out or it exceeds its memory capacity
+// constraint violations are accounted for once the graph is locked
+static bool _no_failure_points
+(
+	const ExecutionCtx *exec_ctx,  // execution context
+	bool readonly,                 // read-only query
+	CronTaskHandle timeout         // timeout task
+) {
+	if(readonly || timeout != 0) return false;
+	if(exec_ctx->exec_type != EXECUTION_TYPE_QUERY) return false;
+
+	int64_t mem_capacity;
+	Config_Option_get(Config_QUERY_MEM_CAPACITY, &mem_capacity);
+	if(mem_capacity != QUERY_MEM_CAPACITY_UNLIMITED) return false;
+
+	return ExecutionPlan_WritesLast(exec_ctx->plan);
+}
+
 static bool _index_operation_delete
 (
 	GraphContext *gc,
@@ -324,6 +345,10 @@ static void _ExecuteQuery(void *args) {
 
 	// acquire the appropriate lock
 	if(readonly) {
+		// readers do not run against a snapshot of the graph,
+		// a reader waits for an in-progress commit to apply its modifications,
+		// the writer lets readers in before the query is replicated
+		// see QueryCtx_ReleaseGraphLock
 		Graph_AcquireReadLock(gc->g);
 	} else {
 		// if this is a writer query `we need to re-open the graph key with write flag
@@ -379,6 +404,11 @@ static void _ExecuteQuery(void *args) {
 			query_ctx->status = QueryExecutionStatus_FAILURE;
 		}
 	} else {
+		// all modifications are applied, let readers in
+		// replication doesn't access the graph, there's no need for readers
+		// to wait while effects are serialized and the query is replicated
+		QueryCtx_ReleaseGraphLock();
+
 		// replicate if graph was modified
 		if(ResultSetStat_IndicateModification(&result_set->stats)) {
 			// determine rather or not to replicate via effects
@@ -478,7 +508,9 @@ void _query
 
 	// parse query parameters and build an execution plan
 	// or retrieve it from the cache
-	exec_ctx = ExecutionCtx_FromQuery(command_ctx->query);
+	bool lift_literals = false;
+	Config_Option_get(Config_PARAMETERIZE_LITERALS, &lift_literals);
+	exec_ctx = ExecutionCtx_FromQuery(command_ctx->query, lift_literals);
 	if(exec_ctx == NULL) goto cleanup;
 
 	// update cached flag
@@ -519,6 +551,9 @@ void _query
 	if (profile) {
 		flags |= QueryExecutionTypeFlag_PROFILE;
 	}
+	if (_no_failure_points(exec_ctx, readonly, timeout_task)) {
+		flags |= QueryExecutionTypeFlag_NO_UNDO_LOG;
+	}
 	GraphQueryCtx *gq_ctx = GraphQueryCtx_New(gc, ctx, exec_ctx, command_ctx,
 											  flags, timeout_task);
 
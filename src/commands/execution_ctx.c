@@ -8,6 +8,7 @@
 #include "RG.h"
 #include "../query_ctx.h"
 #include "../errors/errors.h"
+#include "../ast/ast_parameterize_literals.h"
 #include "../execution_plan/execution_plan_clone.h"
 
 static ExecutionType _GetExecutionTypeFromAST
@@ -38,9 +39,9 @@ static ExecutionType _GetExecutionTypeFromAST
 
 static AST *_ExecutionCtx_ParseAST
 (
-	const char *q_str
+	cypher_parse_result_t *query_parse_result  // unvalidated parsed query
 ) {
-	cypher_parse_result_t *query_parse_result = parse_query(q_str);
+	query_parse_result = validate_query(query_parse_result);
 	// if no output from the parser, the query is not valid
 	if(ErrorCtx_EncounteredError() || query_parse_result == NULL) {
 		parse_result_free(query_parse_result);
@@ -96,7 +97,8 @@ ExecutionCtx *ExecutionCtx_Clone
 // returns ExecutionCtx populated with the current execution relevant objects
 ExecutionCtx *ExecutionCtx_FromQuery
 (
-	const char *q  // string representing the query
+	const char *q,       // string representing the query
+	bool lift_literals   // lift the query's literals into hidden parameters
 ) {
 	ASSERT(q != NULL);
 
@@ -134,17 +136,59 @@ ExecutionCtx *ExecutionCtx_FromQuery
 	ctx->query_data.query_no_params = q_str;
 
 	// get cache
-	Cache *cache = GraphContext_GetCache(QueryCtx_GetGraphCtx());
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Cache *cache = GraphContext_GetCache(gc);
 
 	// see if we already have a cached execution-ctx for given query
 	ret = Cache_GetValue(cache, q_str);
 
+	//--------------------------------------------------------------------------
+	// lift literals
+	//--------------------------------------------------------------------------
+
+	// queries differing only by their literals share a cached execution-ctx
+	// stored under their normalized form
+	// the normalized form of a query is cached as well, sparing its parse
+	LiteralParams *literals = NULL;
+	cypher_parse_result_t *query_parse_result = NULL;
+
+	if(ret == NULL && lift_literals &&
+	   !LiteralParams_Collide(QueryCtx_GetParams())) {
+		Cache *literals_cache = GraphContext_GetLiteralsCache(gc);
+		literals = Cache_GetValue(literals_cache, q_str);
+
+		if(literals == NULL) {
+			// a query without literals is built from this very parse
+			query_parse_result = parse_query_syntax(q_str);
+			literals = AST_ParameterizeLiterals(q_str, query_parse_result);
+			if(ErrorCtx_EncounteredError()) {
+				parse_result_free(query_parse_result);
+				parse_result_free(params_parse_result);
+				return NULL;
+			}
+
+			if(literals != NULL) {
+				literals = Cache_SetGetValue(literals_cache, q_str, literals);
+			}
+		}
+
+		if(literals != NULL) {
+			LiteralParams_Apply(literals);
+			ret = Cache_GetValue(cache, literals->query);
+		}
+	}
+
 	//--------------------------------------------------------------------------
 	// cache hit
 	//--------------------------------------------------------------------------
 
 	if(ret != NULL) {
+		parse_result_free(query_parse_result);
 		parse_result_free(params_parse_result);  // free parsed params
+		if(literals != NULL) LiteralParams_Free(literals);
+
+		// AST nodes are resolved against the query string they were parsed from
+		ctx->query_data.query_no_params = ret->ast->query;
 		ret->cached = true;                      // mark cached execution
 		return ret;
 	}
@@ -153,12 +197,26 @@ ExecutionCtx *ExecutionCtx_FromQuery
 	// cache miss
 	//--------------------------------------------------------------------------
 
+	const char *key = q_str;
+	if(literals != NULL) {
+		// build from the normalized query
+		key = literals->query;
+		parse_result_free(query_parse_result);
+		query_parse_result = NULL;
+	}
+
+	if(query_parse_result == NULL) query_parse_result = parse_query_syntax(key);
+
+	// AST nodes are resolved against the query string they were parsed from
+	ctx->query_data.query_no_params = key;
+
 	// try to parse the query
-	AST *ast = _ExecutionCtx_ParseAST(q_str);
+	AST *ast = _ExecutionCtx_ParseAST(query_parse_result);
 
 	// parser failed
 	if(ast == NULL) {
 		parse_result_free(params_parse_result);  // free parsed params
+		if(literals != NULL) LiteralParams_Free(literals);
 
 		// if no error has been set, emit one now
 		if(!ErrorCtx_EncounteredError()) {
@@ -167,6 +225,11 @@ ExecutionCtx *ExecutionCtx_FromQuery
 		return NULL;
 	}
 
+	// the query text outlives this call together with the AST
+	ast->query = rm_strdup(key);
+	ctx->query_data.query_no_params = ast->query;
+	if(literals != NULL) LiteralParams_Free(literals);
+
 	// associate parameters with AST
 	AST_SetParamsParseResult(ast, params_parse_result);
 
@@ -192,7 +255,7 @@ ExecutionCtx *ExecutionCtx_FromQuery
 		}
 
 		ExecutionCtx *exec_ctx = _ExecutionCtx_New(ast, plan, exec_type);
-		ret = Cache_SetGetValue(cache, q_str, exec_ctx);
+		ret = Cache_SetGetValue(cache, ast->query, exec_ctx);
 	} else {
 		ret = _ExecutionCtx_New(ast, NULL, exec_type);
 	}
@@ -31,7 +31,8 @@ typedef struct {
 // returns ExecutionCtx populated with the current execution relevant objects
 ExecutionCtx *ExecutionCtx_FromQuery
 (
-	const char *q  // string representing the query
+	const char *q,       // string representing the query
+	bool lift_literals   // lift the query's literals into hidden parameters
 );
 
 // clone the execution ctx and return a shallow copy for the ast
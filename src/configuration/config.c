@@ -10,6 +10,8 @@
 #include <string.h>
 #include <limits.h>
 #include <errno.h>
+#include <stdlib.h>
+#include <sys/stat.h>
 #include "util/redis_version.h"
 #include "../deps/GraphBLAS/Include/GraphBLAS.h"
 
@@ -64,6 +66,21 @@
 // effects replication threshold
 #define EFFECTS_THRESHOLD "EFFECTS_THRESHOLD"
 
+// columnar attribute store
+#define COLUMNAR_STORE "COLUMNAR_STORE"
+
+// RDB entities compression
+#define RDB_COMPRESSION "RDB_COMPRESSION"
+
+// literal parameterization of cached queries
+#define PARAMETERIZE_LITERALS "PARAMETERIZE_LITERALS"
+
+// directory GRAPH.BULK LOAD is allowed to read from
+#define BULK_LOAD_ROOT "BULK_LOAD_ROOT"
+
+// max mem(bytes) held by each graph's columnar store
+#define COLUMNAR_STORE_MEM_CAPACITY "COLUMNAR_STORE_MEM_CAPACITY"
+
 
 //------------------------------------------------------------------------------
 // Configuration defaults
@@ -74,6 +91,10 @@
 #define VKEY_MAX_ENTITY_COUNT_DEFAULT      100000
 #define CMD_INFO_DEFAULT                   true
 #define CMD_INFO_QUERIES_MAX_COUNT_DEFAULT 1000
+#define COLUMNAR_STORE_DEFAULT             false
+#define RDB_COMPRESSION_DEFAULT            false
+#define PARAMETERIZE_LITERALS_DEFAULT      false
+#define COLUMNAR_STORE_MEM_CAPACITY_DEFAULT (256 * 1024 * 1024)
 
 // configuration object
 typedef struct {
@@ -94,6 +115,11 @@ typedef struct {
 	bool cmd_info_on;                  // If true, the GRAPH.INFO is enabled.
 	uint64_t effects_threshold;        // replicate via effects when runtime exceeds threshold
 	uint32_t max_info_queries_count;   // Maximum number of query info elements.
+	bool columnar_store;               // read node attributes from columns
+	bool rdb_compression;              // compress entities in RDB
+	bool parameterize_literals;        // lift query literals into parameters
+	char bulk_load_root[PATH_MAX];     // GRAPH.BULK LOAD root, empty disables LOAD
+	uint64_t columnar_store_mem_capacity; // max mem(bytes) held by a graph's columns
 } RG_Config;
 
 RG_Config config; // global module configuration
@@ -436,6 +462,94 @@ static uint64_t Config_effects_threshold_get (void) {
 	return config.effects_threshold;
 }
 
+//------------------------------------------------------------------------------
+// columnar store
+//------------------------------------------------------------------------------
+
+static void Config_columnar_store_set
+(
+	bool enabled
+) {
+	config.columnar_store = enabled;
+}
+
+static bool Config_columnar_store_get(void) {
+	return config.columnar_store;
+}
+
+static void Config_columnar_store_mem_capacity_set
+(
+	uint64_t capacity
+) {
+	config.columnar_store_mem_capacity = capacity;
+}
+
+static uint64_t Config_columnar_store_mem_capacity_get(void) {
+	return config.columnar_store_mem_capacity;
+}
+
+//------------------------------------------------------------------------------
+// RDB compression
+//------------------------------------------------------------------------------
+
+static void Config_rdb_compression_set
+(
+	bool enabled
+) {
+	config.rdb_compression = enabled;
+}
+
+static bool Config_rdb_compression_get(void) {
+	return config.rdb_compression;
+}
+
+//------------------------------------------------------------------------------
+// literal parameterization
+//------------------------------------------------------------------------------
+
+static void Config_parameterize_literals_set
+(
+	bool enabled
+) {
+	config.parameterize_literals = enabled;
+}
+
+static bool Config_parameterize_literals_get(void) {
+	return config.parameterize_literals;
+}
+
+//------------------------------------------------------------------------------
+// bulk load root
+//------------------------------------------------------------------------------
+
+// set bulk load root directory
+// an empty path disables GRAPH.BULK LOAD
+// the path is stored resolved, fails if it is not an existing directory
+static bool Config_bulk_load_root_set
+(
+	const char *path
+) {
+	if(path[0] == '\0') {
+		config.bulk_load_root[0] = '\0';
+		return true;
+	}
+
+	char resolved[PATH_MAX];
+	struct stat st;
+	if(realpath(path, resolved) == NULL ||
+	   stat(resolved, &st) != 0         ||
+	   !S_ISDIR(st.st_mode)) {
+		return false;
+	}
+
+	strcpy(config.bulk_load_root, resolved);
+	return true;
+}
+
+static const char *Config_bulk_load_root_get(void) {
+	return config.bulk_load_root;
+}
+
 bool Config_Contains_field
 (
 	const char *field_str,
@@ -477,6 +591,16 @@ bool Config_Contains_field
 		f = Config_CMD_INFO_MAX_QUERY_COUNT;
 	} else if (!(strcasecmp(field_str, EFFECTS_THRESHOLD))) {
 		f = Config_EFFECTS_THRESHOLD;
+	} else if (!(strcasecmp(field_str, COLUMNAR_STORE))) {
+		f = Config_COLUMNAR_STORE;
+	} else if (!(strcasecmp(field_str, RDB_COMPRESSION))) {
+		f = Config_RDB_COMPRESSION;
+	} else if (!(strcasecmp(field_str, PARAMETERIZE_LITERALS))) {
+		f = Config_PARAMETERIZE_LITERALS;
+	} else if (!(strcasecmp(field_str, BULK_LOAD_ROOT))) {
+		f = Config_BULK_LOAD_ROOT;
+	} else if (!(strcasecmp(field_str, COLUMNAR_STORE_MEM_CAPACITY))) {
+		f = Config_COLUMNAR_STORE_MEM_CAPACITY;
 	} else {
 		return false;
 	}
@@ -555,6 +679,26 @@ const char *Config_Field_name
 			name = EFFECTS_THRESHOLD;
 			break;
 
+		case Config_COLUMNAR_STORE:
+			name = COLUMNAR_STORE;
+			break;
+
+		case Config_RDB_COMPRESSION:
+			name = RDB_COMPRESSION;
+			break;
+
+		case Config_PARAMETERIZE_LITERALS:
+			name = PARAMETERIZE_LITERALS;
+			break;
+
+		case Config_BULK_LOAD_ROOT:
+			name = BULK_LOAD_ROOT;
+			break;
+
+		case Config_COLUMNAR_STORE_MEM_CAPACITY:
+			name = COLUMNAR_STORE_MEM_CAPACITY;
+			break;
+
 		//----------------------------------------------------------------------
 		// invalid option
 		//----------------------------------------------------------------------
@@ -622,6 +766,21 @@ static void _Config_SetToDefaults(void) {
 
 	// replicate effects if avg change time μs > effects_threshold μs
 	config.effects_threshold = 300 ;
+
+	// attributes are read from nodes' attribute-sets by default
+	config.columnar_store = COLUMNAR_STORE_DEFAULT;
+
+	// entities are encoded uncompressed by default
+	config.rdb_compression = RDB_COMPRESSION_DEFAULT;
+
+	// queries are cached by their text, literals included, by default
+	config.parameterize_literals = PARAMETERIZE_LITERALS_DEFAULT;
+
+	// GRAPH.BULK LOAD is disabled by default
+	config.bulk_load_root[0] = '\0';
+
+	// bound the memory held by each graph's columns
+	config.columnar_store_mem_capacity = COLUMNAR_STORE_MEM_CAPACITY_DEFAULT;
 }
 
 int Config_Init
@@ -930,6 +1089,77 @@ bool Config_Option_get
 		}
 		break;
 
+		//----------------------------------------------------------------------
+		// columnar store
+		//----------------------------------------------------------------------
+
+		case Config_COLUMNAR_STORE: {
+			va_start(ap, field);
+			bool *columnar_store = va_arg(ap, bool *);
+			va_end(ap);
+
+			ASSERT(columnar_store != NULL);
+			(*columnar_store) = Config_columnar_store_get();
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// RDB compression
+		//----------------------------------------------------------------------
+
+		case Config_RDB_COMPRESSION: {
+			va_start(ap, field);
+			bool *rdb_compression = va_arg(ap, bool *);
+			va_end(ap);
+
+			ASSERT(rdb_compression != NULL);
+			(*rdb_compression) = Config_rdb_compression_get();
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// literal parameterization
+		//----------------------------------------------------------------------
+
+		case Config_PARAMETERIZE_LITERALS: {
+			va_start(ap, field);
+			bool *parameterize_literals = va_arg(ap, bool *);
+			va_end(ap);
+
+			ASSERT(parameterize_literals != NULL);
+			(*parameterize_literals) = Config_parameterize_literals_get();
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// bulk load root
+		//----------------------------------------------------------------------
+
+		case Config_BULK_LOAD_ROOT: {
+			va_start(ap, field);
+			const char **bulk_load_root = va_arg(ap, const char **);
+			va_end(ap);
+
+			ASSERT(bulk_load_root != NULL);
+			(*bulk_load_root) = Config_bulk_load_root_get();
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// columnar store mem capacity
+		//----------------------------------------------------------------------
+
+		case Config_COLUMNAR_STORE_MEM_CAPACITY: {
+			va_start(ap, field);
+			uint64_t *columnar_store_mem_capacity = va_arg(ap, uint64_t *);
+			va_end(ap);
+
+			ASSERT(columnar_store_mem_capacity != NULL);
+			(*columnar_store_mem_capacity) =
+				Config_columnar_store_mem_capacity_get();
+		}
+		break;
+
 		//----------------------------------------------------------------------
 		// invalid option
 		//----------------------------------------------------------------------
@@ -1169,6 +1399,75 @@ bool Config_Option_set
 		}
 		break;
 
+		//----------------------------------------------------------------------
+		// columnar store
+		//----------------------------------------------------------------------
+
+		case Config_COLUMNAR_STORE: {
+			bool columnar_store = false;
+			if(!_Config_ParseYesNo(val, &columnar_store)) {
+				return false;
+			}
+
+			Config_columnar_store_set(columnar_store);
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// RDB compression
+		//----------------------------------------------------------------------
+
+		case Config_RDB_COMPRESSION: {
+			bool rdb_compression = false;
+			if(!_Config_ParseYesNo(val, &rdb_compression)) {
+				return false;
+			}
+
+			Config_rdb_compression_set(rdb_compression);
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// literal parameterization
+		//----------------------------------------------------------------------
+
+		case Config_PARAMETERIZE_LITERALS: {
+			bool parameterize_literals = false;
+			if(!_Config_ParseYesNo(val, &parameterize_literals)) {
+				return false;
+			}
+
+			Config_parameterize_literals_set(parameterize_literals);
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// bulk load root
+		//----------------------------------------------------------------------
+
+		case Config_BULK_LOAD_ROOT: {
+			if(!Config_bulk_load_root_set(val)) {
+				if(err) *err = "BULK_LOAD_ROOT must be an existing directory";
+				return false;
+			}
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// columnar store mem capacity
+		//----------------------------------------------------------------------
+
+		case Config_COLUMNAR_STORE_MEM_CAPACITY: {
+			long long columnar_store_mem_capacity;
+			if(!_Config_ParseNonNegativeInteger(val,
+						&columnar_store_mem_capacity)) {
+				return false;
+			}
+
+			Config_columnar_store_mem_capacity_set(columnar_store_mem_capacity);
+		}
+		break;
+
 		//----------------------------------------------------------------------
 		// invalid option
 		//----------------------------------------------------------------------
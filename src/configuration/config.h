@@ -33,7 +33,12 @@ typedef enum {
 	Config_CMD_INFO                  = 13,  // toggle on/off the GRAPH.INFO
 	Config_CMD_INFO_MAX_QUERY_COUNT  = 14,  // the max number of info queries count
 	Config_EFFECTS_THRESHOLD         = 15,  // replicate queries via effects
-	Config_END_MARKER                = 16
+	Config_COLUMNAR_STORE            = 16,  // read node attributes from columns
+	Config_RDB_COMPRESSION           = 17,  // compress entities in RDB
+	Config_PARAMETERIZE_LITERALS     = 18,  // lift query literals into parameters
+	Config_BULK_LOAD_ROOT            = 19,  // directory GRAPH.BULK LOAD reads from
+	Config_COLUMNAR_STORE_MEM_CAPACITY = 20,  // max mem(bytes) held by a graph's columns
+	Config_END_MARKER                = 21
 } Config_Option_Field;
 
 // callback function, invoked once configuration changes as a result of
@@ -53,7 +58,11 @@ static const Config_Option_Field RUNTIME_CONFIGS[] = {
 	Config_DELTA_MAX_PENDING_CHANGES,
 	Config_CMD_INFO,
 	Config_CMD_INFO_MAX_QUERY_COUNT,
-	Config_EFFECTS_THRESHOLD
+	Config_EFFECTS_THRESHOLD,
+	Config_COLUMNAR_STORE,
+	Config_RDB_COMPRESSION,
+	Config_PARAMETERIZE_LITERALS,
+	Config_COLUMNAR_STORE_MEM_CAPACITY
 };
 static const size_t RUNTIME_CONFIG_COUNT = sizeof(RUNTIME_CONFIGS) / sizeof(RUNTIME_CONFIGS[0]);
 
@@ -5,6 +5,7 @@
  */
 
 #include "RG.h"
+#include "globals.h"
 #include "cron/cron.h"
 #include "util/rmalloc.h"
 #include "reconf_handler.h"
@@ -51,6 +52,45 @@ void reconf_handler(Config_Option_Field type) {
 			}
 			break;
 
+		//----------------------------------------------------------------------
+		// columnar store
+		//----------------------------------------------------------------------
+
+		case Config_COLUMNAR_STORE:
+			{
+				bool enabled;
+				bool res = Config_Option_get(type, &enabled);
+				ASSERT(res);
+				if(enabled) break;
+
+				// release columns held by graphs
+				GraphContext *gc = NULL;
+				KeySpaceGraphIterator it;
+				Globals_ScanGraphs(&it);
+				while((gc = GraphIterator_Next(&it)) != NULL) {
+					ColumnStore_Clear(gc->column_store);
+					GraphContext_DecreaseRefCount(gc);
+				}
+			}
+			break;
+
+		case Config_COLUMNAR_STORE_MEM_CAPACITY:
+			{
+				uint64_t capacity;
+				bool res = Config_Option_get(type, &capacity);
+				ASSERT(res);
+
+				// evict columns exceeding the new capacity
+				GraphContext *gc = NULL;
+				KeySpaceGraphIterator it;
+				Globals_ScanGraphs(&it);
+				while((gc = GraphIterator_Next(&it)) != NULL) {
+					ColumnStore_Evict(gc->column_store, capacity);
+					GraphContext_DecreaseRefCount(gc);
+				}
+			}
+			break;
+
         //----------------------------------------------------------------------
         // all other options
         //----------------------------------------------------------------------
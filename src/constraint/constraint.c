@@ -566,8 +566,9 @@ void Constraint_EnforceEdges
 					break;
 				}
 			} else {
-				EdgeID *edgeIds = (EdgeID *)(CLEAR_MSB(edge_id));
-				uint edgeCount = array_len(edgeIds);
+				uint32_t edgeCount;
+				const EdgeID *edgeIds = RG_Matrix_multiEdge(m, edge_id,
+						&edgeCount);
 
 				for(uint i = 0; i < edgeCount; i++) {
 					edge_id = edgeIds[i];
@@ -7,9 +7,9 @@
 #include "RG.h"
 #include "constraint.h"
 #include "../query_ctx.h"
+#include "../util/arr.h"
 #include "../index/index.h"
-#include "redisearch_api.h"
-#include "../src/datatypes/point.h"
+#include "../index/index_query.h"
 #include "../graph/entities/attribute_set.h"
 
 #include <stdatomic.h>
@@ -76,33 +76,29 @@ bool EnforceUniqueEntity
 
 	UniqueConstraint _c = (UniqueConstraint)c;
 
-	Index   idx     = _c->idx;
-	bool    holds   = false;  // return value none-optimistic
-	RSIndex *rs_idx = Index_RSIndex(idx);
+	Index      idx    = _c->idx;
+	bool       holds  = false;  // return value none-optimistic
+	IndexQuery *query = NULL;
 
 	//--------------------------------------------------------------------------
-	// construct a RediSearch query locating entity
+	// construct an index query locating entity
 	//--------------------------------------------------------------------------
 
-	// TODO: prefer to have the RediSearch query "template" constructed
+	// TODO: prefer to have the index query "template" constructed
 	// once and reused for each entity
 
 	SIType t;
 	SIValue *v;
-	uint8_t i     = 0;
-	RSQNode *node = NULL;  // RediSearch query node
-	RSQNode *root = NULL;  // root of RediSearch query tree
-	RSQNode *nodes[_c->n_attr];
-	RSResultsIterator *iter = NULL;
+	uint16_t           fields_pos[_c->n_attr];  // attributes' index fields
+	SIValue            values[_c->n_attr];      // attributes' values
+	bool               exact      = true;  // index matches are exact matches
+	uint               n_fields   = Index_FieldsCount(idx);
+	const IndexField   *fields    = Index_GetFields(idx);
 	const AttributeSet attributes = GraphEntity_GetAttributes(e);
+	IndexCheck         *checks    = array_new(IndexCheck, _c->n_attr);
 
-	//--------------------------------------------------------------------------
-	// create a RediSearch query
-	//--------------------------------------------------------------------------
-
-	for(i = 0; i < _c->n_attr; i++) {
+	for(uint8_t i = 0; i < _c->n_attr; i++) {
 		Attribute_ID attr_id = _c->attrs[i];
-		const char *field = _c->attr_names[i];
 
 		// get current attribute from entity
 		v = AttributeSet_Get(attributes, attr_id);
@@ -112,88 +108,69 @@ bool EnforceUniqueEntity
 			goto cleanup;
 		}
 
-		// create RediSearch query node according to entity attr type
 		t = SI_TYPE(*v);
 
+		// points are encoded by their exact coordinates
+		// and are matched like any other indexable value
 		if(!(t & SI_INDEXABLE)) {
-			// TODO: see RediSearch MULTI-VALUE index.
-			holds = true;
-			goto cleanup;
-		} else if(t == T_STRING) {
-			node = RediSearch_CreateTagNode(rs_idx, field);
-			RSQNode *child = RediSearch_CreateTagTokenNode(rs_idx, v->stringval);
-			RediSearch_QueryNodeAddChild(node, child);
-		} else if(t & (SI_NUMERIC | T_BOOL)) {
-			double d = SI_GET_NUMERIC((*v));
-			node = RediSearch_CreateNumericNode(rs_idx, field, d, d, true, true);
-		} else {
-			// ASSERT(t == T_POINT);
-			// double lat = (double)Point_lat(*v);
-			// double lon = (double)Point_lon(*v);
-			// node = RediSearch_CreateGeoNode(rs_idx, field, lat, lon, 0, RS_GEO_DISTANCE_M);
-			// TODO: RediSearch exact match for point.
 			holds = true;
 			goto cleanup;
 		}
 
-		ASSERT(node != NULL);
-		nodes[i] = node;
-	}
+		// locate attribute within the supporting index
+		uint16_t field = 0;
+		while(field < n_fields && fields[field].id != attr_id) field++;
+		ASSERT(field < n_fields);
 
-	//--------------------------------------------------------------------------
-	// cancat filters
-	//--------------------------------------------------------------------------
+		// integers of great magnitude share their index encoding
+		// with their neighbours, matches must be compared exactly
+		IndexCheck check = {.field = field};
+		exact &= IndexRange_FromPredicate(&check.range, OP_EQUAL, *v);
+		array_append(checks, check);
 
-	root = node;
-	if(_c->n_attr > 1) {
-		// intersection query node
-		root = RediSearch_CreateIntersectNode(rs_idx, false);
-		for(uint8_t i = 0; i < _c->n_attr; i++) {
-			RediSearch_QueryNodeAddChild(root, nodes[i]);
-		}
+		fields_pos[i] = field;
+		values[i]     = *v;
 	}
 
 	//--------------------------------------------------------------------------
-	// query RediSearch index
+	// query index
 	//--------------------------------------------------------------------------
 
-	// constraint holds if there are no duplicates, a single index match
-	iter = RediSearch_GetResultsIterator(root, rs_idx);
-	if(Constraint_GetEntityType(c) == GETYPE_NODE) {
-		// first call, expecting to find 'e' in the index
-		const EntityID *id =
-			(EntityID*)RediSearch_ResultsIteratorNext(iter, rs_idx, NULL);
+	OrderedIndex oi = Index_OrderedIndex(idx);
+	query = IndexQuery_New(oi);
+	IndexQuery_AddClause(query, checks);
+	checks = NULL;
 
-		ASSERT(id != NULL);
+	// constraint holds if there are no duplicates, 'e' is the only match
+	const void *key;
+	EntityID id = ENTITY_GET_ID(e);
+	holds = true;
 
-		if(*id != ENTITY_GET_ID(e)) {
-			holds = false;
-			goto cleanup;
+	while(holds && (key = IndexQuery_Next(query)) != NULL) {
+		bool self;
+		if(Constraint_GetEntityType(c) == GETYPE_NODE) {
+			self = *(const EntityID *)key == id;
+		} else {
+			self = ((const EdgeIndexKey *)key)->edge_id == id;
 		}
-	} else {
-		// first call, expecting to find 'e' in the index
-		const EdgeIndexKey *id =
-			(EdgeIndexKey*)RediSearch_ResultsIteratorNext(iter, rs_idx, NULL);
-
-		ASSERT(id != NULL);
-
-		if(id->edge_id != ENTITY_GET_ID(e)) {
-			holds = false;
-			goto cleanup;
+		if(self) continue;
+
+		// candidate is a duplicate unless one of its values differs
+		// values are read back from the index, which keeps them exactly
+		bool duplicate = true;
+		for(uint8_t i = 0; i < _c->n_attr && duplicate && !exact; i++) {
+			SIValue stored;
+			if(OrderedIndex_GetStoredValue(oi, key, fields_pos[i], &stored)) {
+				duplicate = SIValue_Compare(stored, values[i], NULL) == 0;
+			}
 		}
-	}
 
-	// second call, holds if no value is returned
-	holds = RediSearch_ResultsIteratorNext(iter, rs_idx, NULL) == NULL;
+		holds = !duplicate;
+	}
 
 cleanup:
-	if(iter != NULL) {
-		RediSearch_ResultsIteratorFree(iter);
-	} else {
-		for(uint8_t j = 0; j < i; j++) {
-			RediSearch_QueryNodeFree(nodes[j]);
-		}
-	}
+	if(query  != NULL) IndexQuery_Free(query);
+	if(checks != NULL) IndexQuery_FreeChecks(checks);
 
 	if(holds == false && err_msg != NULL) {
 		int res;
@@ -97,6 +97,16 @@ void SIArray_ToString(SIValue list, char **buf, size_t *bufferLen, size_t *bytes
  */
 XXH64_hash_t SIArray_HashCode(SIValue siarray);
 
+// writes a binary representation of arr into stream
+// format:
+//  number of elements
+//  elements
+void SIArray_ToBinary
+(
+	FILE *stream,       // stream to write array to
+	const SIValue *arr  // array
+);
+
 // creates an array from its binary representation
 // this is the reverse of SIArray_ToBinary
 // x = SIArray_FromBinary(SIArray_ToBinary(y));
@@ -117,3 +117,5 @@
 #define EMSG_SSPATH_INVALID_TYPE "sourceNode must be of type Node"
 #define EMSG_INDEX_SUPPORT_CONSTRAINTS "Index supports constraint"
 #define EMSG_QUERY_MEM_CONSUMPTION "Query's mem consumption exceeded capacity"
+#define EMSG_SPILL_WRITE "Failed to spill records to disk"
+#define EMSG_SPILL_READ "Failed to read spilled records"
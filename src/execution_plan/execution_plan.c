@@ -445,9 +445,12 @@ ResultSet *ExecutionPlan_Execute(ExecutionPlan *plan) {
 
 	ExecutionPlan_Init(plan);
 
-	Record r = NULL;
-	// Execute the root operation and free the processed Record until the data stream is depleted.
-	while((r = OpBase_Consume(plan->root)) != NULL) ExecutionPlan_ReturnRecord(r->owner, r);
+	uint n = 0;
+	Record batch[OP_BATCH_SIZE];
+	// Execute the root operation and free the processed Records until the data stream is depleted.
+	while((n = OpBase_ConsumeBatch(plan->root, batch, OP_BATCH_SIZE)) > 0) {
+		for(uint i = 0; i < n; i++) ExecutionPlan_ReturnRecord(batch[i]->owner, batch[i]);
+	}
 
 	return QueryCtx_GetResultSet();
 }
@@ -469,8 +472,34 @@ bool ExecutionPlan_Drained(ExecutionPlan *plan) {
 	return (plan->root->consume == deplete_consume);
 }
 
+// counts write operations within the tree rooted at 'op'
+static uint _ExecutionPlan_WriterCount(const OpBase *op) {
+	uint count = OpBase_IsWriter((OpBase *)op);
+	for(int i = 0; i < op->childCount; i++) {
+		count += _ExecutionPlan_WriterCount(op->children[i]);
+	}
+	return count;
+}
+
+// return true if the plan's only write operation is an eager
+// create, update or delete at its root
+// such a plan performs no further evaluation once the graph is modified
+bool ExecutionPlan_WritesLast(const ExecutionPlan *plan) {
+	ASSERT(plan != NULL);
+	ASSERT(plan->root != NULL);
+
+	OPType t = plan->root->type;
+	if(t != OPType_CREATE && t != OPType_UPDATE && t != OPType_DELETE) {
+		return false;
+	}
+
+	return _ExecutionPlan_WriterCount(plan->root) == 1;
+}
+
 static void _ExecutionPlan_Drain(OpBase *root) {
 	root->consume = deplete_consume;
+	// fallback to record by record consumption
+	root->consumeBatch = NULL;
 	for(int i = 0; i < root->childCount; i++) {
 		_ExecutionPlan_Drain(root->children[i]);
 	}
@@ -490,9 +519,12 @@ void ExecutionPlan_Drain(ExecutionPlan *plan) {
 static void _ExecutionPlan_InitProfiling(OpBase *root) {
 	root->profile = root->consume;
 	root->consume = OpBase_Profile;
+	// profiled operations are consumed record by record
+	root->consumeBatch = NULL;
 	root->stats = rm_malloc(sizeof(OpStats));
 	root->stats->profileExecTime = 0;
 	root->stats->profileRecordCount = 0;
+	root->stats->profileUndoLogSize = 0;
 
 	if(root->childCount) {
 		for(int i = 0; i < root->childCount; i++) {
@@ -507,6 +539,8 @@ static void _ExecutionPlan_FinalizeProfiling(OpBase *root) {
 		for(int i = 0; i < root->childCount; i++) {
 			OpBase *child = root->children[i];
 			root->stats->profileExecTime -= child->stats->profileExecTime;
+			root->stats->profileUndoLogSize -=
+				child->stats->profileUndoLogSize;
 			_ExecutionPlan_FinalizeProfiling(child);
 		}
 	}
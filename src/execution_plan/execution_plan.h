@@ -63,6 +63,9 @@ bool ExecutionPlan_Drained(ExecutionPlan *plan);
 // Drains execution plan
 void ExecutionPlan_Drain(ExecutionPlan *plan);
 
+// Checks if the plan's root is its only write operation
+bool ExecutionPlan_WritesLast(const ExecutionPlan *plan);
+
 // Profile executes plan
 ResultSet *ExecutionPlan_Profile(ExecutionPlan *plan);
 
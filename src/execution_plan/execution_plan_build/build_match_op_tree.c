@@ -64,7 +64,8 @@ static void _ExecutionPlan_ProcessQueryGraph
 		uint expCount = array_len(exps);
 
 		// Reorder exps, to the most performant arrangement of evaluation.
-		orderExpressions(qg, exps, &expCount, ft, bound_vars);
+		double est_rows[expCount + 1];
+		orderExpressions(qg, exps, &expCount, ft, bound_vars, est_rows);
 
 		// Create the SCAN operation that will be the tail of the traversal chain.
 		QGNode *src = QueryGraph_GetNodeByAlias(qg,
@@ -101,6 +102,7 @@ static void _ExecutionPlan_ProcessQueryGraph
 						AlgebraicExpression_RemoveSource(&exps[0]));
 			}
 		}
+		root->est_rows = est_rows[0];
 
 		// for each expression, build the appropriate traversal operation
 		for(int j = 0; j < expCount; j++) {
@@ -138,6 +140,7 @@ static void _ExecutionPlan_ProcessQueryGraph
 			} else {
 				root = NewCondTraverseOp(plan, gc->g, exp);
 			}
+			root->est_rows = est_rows[j + 1];
 			// Insert the new traversal op at the root of the chain.
 			ExecutionPlan_AddOp(root, tail);
 			tail = root;
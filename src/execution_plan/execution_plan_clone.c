@@ -80,3 +80,20 @@ ExecutionPlan *ExecutionPlan_Clone(const ExecutionPlan *template) {
 	return clone;
 }
 
+
+/* This function clones the op tree rooted at `root`, the resulting ops are bound to
+ * newly cloned ExecutionPlan segments, the returned plan's root is the clone of `root`. */
+ExecutionPlan *ExecutionPlan_CloneBranch(const OpBase *root) {
+	ASSERT(root != NULL);
+	// Store the original AST pointer.
+	AST *master_ast = QueryCtx_GetAST();
+
+	dict *old_to_new = HashTableCreate(&def_dt);
+	OpBase *clone_root = _CloneOpTree((OpBase *)root, old_to_new);
+	ExecutionPlan *clone = (ExecutionPlan *)clone_root->plan;
+	HashTableRelease(old_to_new);
+
+	// Restore the original AST pointer.
+	QueryCtx_SetAST(master_ast);
+	return clone;
+}
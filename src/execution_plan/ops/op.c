@@ -8,6 +8,7 @@
 #include "RG.h"
 #include "op_project.h"
 #include "op_aggregate.h"
+#include "../../query_ctx.h"
 #include "../../util/rmalloc.h"
 #include "../../util/simple_timer.h"
 
@@ -48,6 +49,7 @@ void OpBase_Init
 	op->writer         = writer;
 	op->modifies       = NULL;
 	op->children       = NULL;
+	op->est_rows       = -1;
 	op->childCount     = 0;
 	op->op_initialized = false;
 
@@ -59,6 +61,8 @@ void OpBase_Init
 	op->profile  = NULL;
 	op->consume  = consume;
 	op->toString = toString;
+
+	op->consumeBatch = NULL;
 }
 
 inline Record OpBase_Consume
@@ -68,6 +72,32 @@ inline Record OpBase_Consume
 	return op->consume(op);
 }
 
+uint OpBase_ConsumeBatch
+(
+	OpBase *op,
+	Record *batch,
+	uint cap
+) {
+	ASSERT(cap > 0);
+	ASSERT(batch != NULL);
+
+	if(op->consumeBatch != NULL) return op->consumeBatch(op, batch, cap);
+
+	// op doesn't support batch consumption, consume one record at a time
+	uint n = 0;
+	while(n < cap) {
+		Record r = op->consume(op);
+		if(r == NULL) break;
+
+		// the record might share scalars with a record held by op
+		// which could be freed by a subsequent call to consume
+		Record_PersistScalars(r);
+		batch[n++] = r;
+	}
+
+	return n;
+}
+
 // mark alias as being modified by operation
 // returns the ID associated with alias
 int OpBase_Modifies
@@ -202,6 +232,12 @@ static void _OpBase_StatsToString
 					" | Records produced: %d, Execution time: %f ms",
 					op->stats->profileRecordCount,
 					op->stats->profileExecTime);
+
+	// report undo-log memory consumed by write operations
+	if(op->stats->profileUndoLogSize > 0) {
+		*buff = sdscatprintf(*buff, ", Undo log: %" PRId64 " bytes",
+				op->stats->profileUndoLogSize);
+	}
 }
 
 void OpBase_ToString
@@ -214,7 +250,12 @@ void OpBase_ToString
 	if(op->toString) op->toString(op, buff);
 	else *buff = sdscatprintf(*buff, "%s", op->name);
 
-	if(op->stats) _OpBase_StatsToString(op, buff);
+	if(op->stats) {
+		_OpBase_StatsToString(op, buff);
+	} else if(op->est_rows >= 0) {
+		// report the optimizer's estimate when explained
+		*buff = sdscatprintf(*buff, " | Estimated rows: %.0f", op->est_rows);
+	}
 }
 
 Record OpBase_Profile
@@ -222,11 +263,14 @@ Record OpBase_Profile
 	OpBase *op
 ) {
 	double tic [2];
+	size_t undo_log_size = QueryCtx_UndoLogMemoryUsage();
 	// Start timer.
 	simple_tic(tic);
 	Record r = op->profile(op);
 	// Stop timer and accumulate.
 	op->stats->profileExecTime += simple_toc(tic);
+	op->stats->profileUndoLogSize +=
+		QueryCtx_UndoLogMemoryUsage() - undo_log_size;
 	if(r) op->stats->profileRecordCount++;
 	return r;
 }
@@ -250,6 +294,18 @@ void OpBase_UpdateConsume
 	else op->consume = consume;
 }
 
+void OpBase_UpdateConsumeBatch
+(
+	OpBase *op,
+	fpConsumeBatch consumeBatch
+) {
+	ASSERT(op != NULL);
+	// profiled operations are consumed one record at a time
+	// such that each record is accounted for
+	if(op->profile != NULL) return;
+	op->consumeBatch = consumeBatch;
+}
+
 // updates the plan of an operation
 void OpBase_BindOpToPlan
 (
@@ -333,8 +389,11 @@ OpBase *OpBase_Clone
 	const struct ExecutionPlan *plan,
 	const OpBase *op
 ) {
-	if(op->clone) return op->clone(plan, op);
-	return NULL;
+	if(op->clone == NULL) return NULL;
+
+	OpBase *clone = op->clone(plan, op);
+	if(clone != NULL) clone->est_rows = op->est_rows;
+	return clone;
 }
 
 void OpBase_Free
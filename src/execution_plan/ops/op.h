@@ -16,6 +16,9 @@
 
 #define OP_REQUIRE_NEW_DATA(opRes) (opRes & (OP_DEPLETED | OP_REFRESH)) > 0
 
+// max number of records passed between operations in a single batch
+#define OP_BATCH_SIZE 1024
+
 typedef enum {
 	OPType_ALL_NODE_SCAN,
 	OPType_NODE_BY_LABEL_SCAN,
@@ -55,6 +58,7 @@ typedef enum {
 	OPType_OR_APPLY_MULTIPLEXER,
 	OPType_AND_APPLY_MULTIPLEXER,
 	OPType_OPTIONAL,
+	OPType_GATHER,
 } OPType;
 
 typedef enum {
@@ -112,6 +116,7 @@ struct ExecutionPlan;
 typedef void (*fpFree)(struct OpBase *);
 typedef OpResult(*fpInit)(struct OpBase *);
 typedef Record(*fpConsume)(struct OpBase *);
+typedef uint (*fpConsumeBatch)(struct OpBase *, Record *, uint);
 typedef OpResult(*fpReset)(struct OpBase *);
 typedef void (*fpToString)(const struct OpBase *, sds *);
 typedef struct OpBase *(*fpClone)(const struct ExecutionPlan *, const struct OpBase *);
@@ -120,6 +125,7 @@ typedef struct OpBase *(*fpClone)(const struct ExecutionPlan *, const struct OpB
 typedef struct {
 	int profileRecordCount;     // Number of records generated.
 	double profileExecTime;     // Operation total execution time in ms.
+	int64_t profileUndoLogSize; // Undo-log growth in bytes.
 }  OpStats;
 
 struct OpBase {
@@ -130,6 +136,7 @@ struct OpBase {
 	fpClone clone;              // Operation clone.
 	fpConsume consume;          // Produce next record.
 	fpConsume profile;          // Profiled version of consume.
+	fpConsumeBatch consumeBatch; // [optional] Produce a batch of records.
 	fpToString toString;        // Operation string representation.
 	const char *name;           // Operation name.
 	int childCount;             // Number of children.
@@ -140,6 +147,7 @@ struct OpBase {
 	struct OpBase *parent;      // Parent operations.
 	const struct ExecutionPlan *plan; // ExecutionPlan this operation is part of.
 	bool writer;             // Indicates this is a writer operation.
+	double est_rows;            // Estimated number of records produced, negative if unknown.
 };
 typedef struct OpBase OpBase;
 
@@ -171,6 +179,17 @@ Record OpBase_Consume
 	OpBase *op
 );
 
+// consume up to `cap` records from op into `batch`
+// returns the number of records produced, 0 once op is depleted
+// operations which do not implement batch consumption are consumed
+// one record at a time
+uint OpBase_ConsumeBatch
+(
+	OpBase *op,    // op to consume from
+	Record *batch, // [output] produced records
+	uint cap       // max number of records to produce
+);
+
 // profile op
 Record OpBase_Profile
 (
@@ -262,6 +281,13 @@ void OpBase_UpdateConsume
 	fpConsume consume
 );
 
+// set operation batch consume function
+void OpBase_UpdateConsumeBatch
+(
+	OpBase *op,
+	fpConsumeBatch consumeBatch
+);
+
 // updates the plan of an operation
 void OpBase_BindOpToPlan
 (
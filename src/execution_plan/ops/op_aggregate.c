@@ -6,6 +6,7 @@
 
 #include "RG.h"
 #include "op_sort.h"
+#include "op_gather.h"
 #include "op_aggregate.h"
 #include "../../util/arr.h"
 #include "../../query_ctx.h"
@@ -188,6 +189,97 @@ static void _aggregateRecord
 	OpBase_DeleteRecord(r);
 }
 
+// aggregate a record produced by a gather helper into the helper's
+// pre-aggregation table, executed on the helper's thread
+static void _aggregatePartialRecord
+(
+	void *partial,
+	Record r
+) {
+	_aggregateRecord((OpAggregate *)partial, r);
+}
+
+// free pre-aggregation tables
+static void _freePartials
+(
+	OpAggregate *op
+) {
+	if(op->partials == NULL) return;
+
+	uint n = array_len(op->partials);
+	for(uint i = 0; i < n; i++) OpBase_Free(op->partials[i]);
+	array_free(op->partials);
+	op->partials = NULL;
+}
+
+// in case op is fed by a gather operation, have each gather helper
+// pre-aggregate the records it produces into a table of its own
+// rather than passing them through gather
+// a pre-aggregation table is a clone of op which is never executed
+static void _partitionAggregation
+(
+	OpAggregate *op
+) {
+	OpBase *child = op->op.children[0];
+	if(child->type != OPType_GATHER) return;
+
+	// partial aggregations must be combinable
+	for(uint i = 0; i < op->aggregate_count; i++) {
+		if(!AR_EXP_CanCombineAggregations(op->aggregate_exps[i])) return;
+	}
+
+	OpGather *gather = (OpGather *)child;
+	uint n = GatherOp_HelperCount(gather);
+	if(n == 0) return;
+
+	// each helper gets a private copy of the key and aggregate expressions
+	op->partials = array_new(OpBase *, n);
+	for(uint i = 0; i < n; i++) {
+		array_append(op->partials, AggregateClone(op->op.plan, (OpBase *)op));
+	}
+
+	GatherOp_SetSink(gather, _aggregatePartialRecord, (void **)op->partials);
+}
+
+// merge pre-aggregation tables into op's groups
+static void _combinePartials
+(
+	OpAggregate *op
+) {
+	if(op->partials == NULL) return;
+
+	uint n = array_len(op->partials);
+	for(uint i = 0; i < n; i++) {
+		OpAggregate *partial = (OpAggregate *)op->partials[i];
+
+		dictEntry *entry;
+		dictIterator *it = HashTableGetIterator(partial->groups);
+		while((entry = HashTableNext(it)) != NULL) {
+			Group *src = HashTableGetVal(entry);
+
+			dictEntry *existing;
+			dictEntry *added = HashTableAddRaw(op->groups,
+					HashTableGetKey(entry), &existing);
+
+			if(added != NULL) {
+				// group is missing, move it over
+				HashTableSetVal(op->groups, added, src);
+				HashTableSetVal(partial->groups, entry, NULL);
+				continue;
+			}
+
+			// combine partial aggregations
+			Group *dst = HashTableGetVal(existing);
+			for(uint j = 0; j < op->aggregate_count; j++) {
+				AR_EXP_CombineAggregations(dst->agg[j], src->agg[j]);
+			}
+		}
+		HashTableReleaseIterator(it);
+	}
+
+	_freePartials(op);
+}
+
 // returns a record populated with group data
 static Record _handoff
 (
@@ -231,6 +323,7 @@ OpBase *NewAggregateOp
 
 	op->groups               = HashTableCreate(&_dt);
 	op->group_iter           = NULL;
+	op->partials             = NULL;
 
 	OpBase_Init((OpBase *)op, OPType_AGGREGATE, "Aggregate", NULL,
 			AggregateConsume, AggregateReset, NULL, AggregateClone,
@@ -281,10 +374,19 @@ static Record AggregateConsume
 		_aggregateRecord(op, r);
 	} else {
 		OpBase *child = op->op.children[0];
+
+		// try to spread aggregation across gather helpers
+		_partitionAggregation(op);
+
 		// eager consumption!
-		while((r = OpBase_Consume(child))) {
-			_aggregateRecord(op, r);
+		uint n;
+		Record batch[OP_BATCH_SIZE];
+		while((n = OpBase_ConsumeBatch(child, batch, OP_BATCH_SIZE)) > 0) {
+			for(uint i = 0; i < n; i++) _aggregateRecord(op, batch[i]);
 		}
+
+		// child is depleted, all helpers are done
+		_combinePartials(op);
 	}
 
 	// did we process any records?
@@ -332,6 +434,8 @@ static OpResult AggregateReset
 		op->group_iter = NULL;
 	}
 
+	_freePartials(op);
+
 	// re-create hashtable
 	unsigned long elem_count = HashTableElemCount(op->groups);
 	HashTableRelease(op->groups);
@@ -409,6 +513,9 @@ static void AggregateFree
 		op->group_iter = NULL;
 	}
 
+	// gather, freed prior to this op, stopped all helpers
+	_freePartials(op);
+
 	if(op->key_exps) {
 		for(uint i = 0; i < op->key_count; i++) {
 			AR_EXP_Free(op->key_exps[i]);
@@ -19,6 +19,7 @@ typedef struct {
 	AR_ExpNode **aggregate_exps;  // array of expressions that aggregate data for each key
 	dict *groups;                 // map of all groups built by this operation
 	dictIterator *group_iter;     // iterator for walking all groups
+	OpBase **partials;            // pre-aggregation tables populated by gather helpers
 	uint key_count;               // number of key expressions
 	uint aggregate_count;         // number of aggregating expressions
 } OpAggregate;
@@ -12,6 +12,7 @@
 static OpResult AllNodeScanInit(OpBase *opBase);
 static Record AllNodeScanConsume(OpBase *opBase);
 static Record AllNodeScanConsumeFromChild(OpBase *opBase);
+static Record AllNodeScanConsumeMorsel(OpBase *opBase);
 static OpResult AllNodeScanReset(OpBase *opBase);
 static OpBase *AllNodeScanClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void AllNodeScanFree(OpBase *opBase);
@@ -24,6 +25,9 @@ OpBase *NewAllNodeScanOp(const ExecutionPlan *plan, const char *alias) {
 	AllNodeScan *op = rm_malloc(sizeof(AllNodeScan));
 	op->iter = NULL;
 	op->alias = alias;
+	op->morsels = NULL;
+	op->morsel_id = 0;
+	op->morsel_end = 0;
 	op->child_record = NULL;
 
 	// Set our Op operations
@@ -34,9 +38,15 @@ OpBase *NewAllNodeScanOp(const ExecutionPlan *plan, const char *alias) {
 	return (OpBase *)op;
 }
 
+void AllNodeScanOp_SetMorsels(AllNodeScan *op, MorselSource *morsels) {
+	ASSERT(op->op.childCount == 0);
+	op->morsels = morsels;
+}
+
 static OpResult AllNodeScanInit(OpBase *opBase) {
 	AllNodeScan *op = (AllNodeScan *)opBase;
 	if(opBase->childCount > 0) OpBase_UpdateConsume(opBase, AllNodeScanConsumeFromChild);
+	else if(op->morsels) OpBase_UpdateConsume(opBase, AllNodeScanConsumeMorsel);
 	else op->iter = Graph_ScanNodes(QueryCtx_GetGraph());
 	return OP_OK;
 }
@@ -89,6 +99,32 @@ static Record AllNodeScanConsume(OpBase *opBase) {
 	return r;
 }
 
+// scan node IDs morsel by morsel, claiming a new morsel once the current
+// one is exhausted
+static Record AllNodeScanConsumeMorsel(OpBase *opBase) {
+	AllNodeScan *op = (AllNodeScan *)opBase;
+	Graph *g = QueryCtx_GetGraph();
+
+	Node n = GE_NEW_NODE();
+	while(true) {
+		if(op->morsel_id >= op->morsel_end) {
+			// current morsel exhausted, claim a new one
+			if(!MorselSource_Claim(op->morsels, &op->morsel_id,
+						&op->morsel_end)) {
+				return NULL;
+			}
+		}
+
+		// skip deleted nodes
+		if(Graph_GetNode(g, op->morsel_id++, &n)) break;
+	}
+
+	Record r = OpBase_CreateRecord((OpBase *)op);
+	Record_AddNode(r, op->nodeRecIdx, n);
+
+	return r;
+}
+
 static OpResult AllNodeScanReset(OpBase *op) {
 	AllNodeScan *allNodeScan = (AllNodeScan *)op;
 	if(allNodeScan->iter) DataBlockIterator_Reset(allNodeScan->iter);
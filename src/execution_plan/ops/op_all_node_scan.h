@@ -7,6 +7,7 @@
 #pragma once
 
 #include "op.h"
+#include "shared/morsel.h"
 #include "../execution_plan.h"
 #include "../../graph/graph.h"
 #include "../../graph/query_graph.h"
@@ -21,7 +22,13 @@ typedef struct {
 	uint nodeRecIdx;
 	DataBlockIterator *iter;
 	Record child_record;        /* The Record this op acts on if it is not a tap. */
+	MorselSource *morsels;      /* [optional] shared source of ID ranges to scan. */
+	NodeID morsel_id;           /* Next node ID to scan within current morsel. */
+	NodeID morsel_end;          /* End of current morsel (exclusive). */
 } AllNodeScan;
 
 OpBase *NewAllNodeScanOp(const ExecutionPlan *plan, const char *alias);
 
+/* Restrict scan to the morsels it claims from a shared source. */
+void AllNodeScanOp_SetMorsels(AllNodeScan *op, MorselSource *morsels);
+
@@ -8,19 +8,64 @@
 #include "RG.h"
 #include "shared/print_functions.h"
 #include "../../query_ctx.h"
+#include "../../configuration/config.h"
 
-// default number of records to accumulate before traversing
+// initial number of records to accumulate before traversing
 #define BATCH_SIZE 16
 
+// max number of records to accumulate before traversing
+#define MAX_BATCH_SIZE 4096
+
+// default max number of traversed pairs (entries of M) per batch
+#define PAIR_BUDGET 65536
+
+// estimated memory consumed by a single traversed pair
+// accounting for M's entry and the emitted record
+#define PAIR_MEM_ESTIMATE 256
+
 /* Forward declarations. */
 static OpResult CondTraverseInit(OpBase *opBase);
 static Record CondTraverseConsume(OpBase *opBase);
+static uint CondTraverseConsumeBatch(OpBase *opBase, Record *batch, uint cap);
 static OpResult CondTraverseReset(OpBase *opBase);
 static OpBase *CondTraverseClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void CondTraverseFree(OpBase *opBase);
 
 static void CondTraverseToString(const OpBase *ctx, sds *buf) {
-	TraversalToString(ctx, buf, ((const OpCondTraverse *)ctx)->ae);
+	const OpCondTraverse *op = (const OpCondTraverse *)ctx;
+	TraversalToString(ctx, buf, op->ae);
+
+	// report the largest batch size chosen when profiled
+	if(ctx->stats != NULL) {
+		*buf = sdscatprintf(*buf, " | Batch size: %u", op->record_cap_peak);
+	}
+}
+
+// adapt the number of records accumulated before the next traversal
+// aiming for batches producing about 'pair_budget' traversed pairs
+// such that low fan-out traversals perform fewer, larger multiplications
+// while high fan-out traversals keep the result matrix bounded
+static void _adapt_batch_size(OpCondTraverse *op) {
+	GrB_Index nvals;
+	GrB_Info info = RG_Matrix_nvals(&nvals, op->M);
+	ASSERT(info == GrB_SUCCESS);
+
+	// a partial batch has little to say about the fan-out
+	// unless it is already over budget
+	if(op->record_count < op->record_cap && nvals <= op->pair_budget) return;
+
+	// observed fan-out is nvals / record_count
+	uint64_t target = op->record_cap_max;
+	if(nvals > 0) target = (op->pair_budget * op->record_count) / nvals;
+
+	// grow gradually, fan-out might vary across the scanned sources
+	// shrink at once to stay within budget
+	if(target > (uint64_t)op->record_cap * 2) target = op->record_cap * 2;
+	if(target > op->record_cap_max) target = op->record_cap_max;
+	if(target == 0) target = 1;
+
+	op->record_cap = target;
+	if(op->record_cap > op->record_cap_peak) op->record_cap_peak = op->record_cap;
 }
 
 static void _populate_filter_matrix(OpCondTraverse *op) {
@@ -50,8 +95,8 @@ void _traverse(OpCondTraverse *op) {
 	if(op->F == NULL) {
 		// create both filter and result matrices
 		size_t required_dim = Graph_RequiredMatrixDim(op->graph);
-		RG_Matrix_new(&op->M, GrB_BOOL, op->record_cap, required_dim);
-		RG_Matrix_new(&op->F, GrB_BOOL, op->record_cap, required_dim);
+		RG_Matrix_new(&op->M, GrB_BOOL, op->record_cap_max, required_dim);
+		RG_Matrix_new(&op->F, GrB_BOOL, op->record_cap_max, required_dim);
 
 		// prepend filter matrix to algebraic expression as the leftmost operand
 		AlgebraicExpression_MultiplyToTheLeft(&op->ae, op->F);
@@ -67,6 +112,9 @@ void _traverse(OpCondTraverse *op) {
 	AlgebraicExpression_Eval(op->ae, op->M);
 
 	RG_MatrixTupleIter_attach(&op->iter, op->M);
+
+	// size next batch according to the observed fan-out
+	_adapt_batch_size(op);
 }
 
 OpBase *NewCondTraverseOp
@@ -79,13 +127,14 @@ OpBase *NewCondTraverseOp
 
 	op->ae         = ae;
 	op->graph      = g;
-	op->record_cap = BATCH_SIZE;
+	op->record_cap = MAX_BATCH_SIZE;
 
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_CONDITIONAL_TRAVERSE,
 			"Conditional Traverse", CondTraverseInit, CondTraverseConsume,
 			CondTraverseReset, CondTraverseToString, CondTraverseClone,
 			CondTraverseFree, false, plan);
+	OpBase_UpdateConsumeBatch((OpBase *)op, CondTraverseConsumeBatch);
 
 	bool aware = OpBase_Aware((OpBase *)op, AlgebraicExpression_Src(ae),
 			&op->srcNodeIdx);
@@ -111,20 +160,94 @@ static OpResult CondTraverseInit(OpBase *opBase) {
 	OpCondTraverse *op = (OpCondTraverse *)opBase;
 	// Create 'records' with this Init function as 'record_cap'
 	// might be set during optimization time (applyLimit)
-	// If cap greater than BATCH_SIZE is specified,
-	// use BATCH_SIZE as the value.
+	// 'record_cap' bounds the adaptive batch size, which starts at BATCH_SIZE.
+	op->record_cap_max = op->record_cap;
+	if(op->record_cap_max > MAX_BATCH_SIZE) op->record_cap_max = MAX_BATCH_SIZE;
 	if(op->record_cap > BATCH_SIZE) op->record_cap = BATCH_SIZE;
-	op->records = rm_calloc(op->record_cap, sizeof(Record));
+	op->record_cap_peak = op->record_cap;
+	op->records = rm_calloc(op->record_cap_max, sizeof(Record));
+
+	// bound the number of pairs traversed at once by the query memory cap
+	uint64_t mem_cap = QUERY_MEM_CAPACITY_UNLIMITED;
+	Config_Option_get(Config_QUERY_MEM_CAPACITY, &mem_cap);
+	op->pair_budget = PAIR_BUDGET;
+	if(mem_cap != QUERY_MEM_CAPACITY_UNLIMITED) {
+		// spend no more than a 1/16 of the capacity on a single batch
+		uint64_t budget = mem_cap / 16 / PAIR_MEM_ESTIMATE;
+		if(budget < op->pair_budget) op->pair_budget = budget;
+		if(op->pair_budget == 0) op->pair_budget = 1;
+	}
 
 	return OP_OK;
 }
 
+// frees held source records, pulls the next batch of sources from child
+// and traverses all of them with a single multiplication
+// returns false once child is depleted
+static bool _pull_sources(OpCondTraverse *op) {
+	OpBase *child = op->op.children[0];
+
+	// free old records
+	op->r = NULL;
+	for(uint i = 0; i < op->record_count; i++) {
+		OpBase_DeleteRecord(op->records[i]);
+	}
+
+	// ask child operations for data
+	op->record_count = 0;
+	while(op->record_count < op->record_cap) {
+		Record *records = op->records + op->record_count;
+		uint n = OpBase_ConsumeBatch(child, records,
+				op->record_cap - op->record_count);
+		// if no Records were produced, the child has been depleted
+		if(n == 0) break;
+
+		for(uint i = 0; i < n; i++) {
+			Record childRecord = records[i];
+			if(!Record_GetNode(childRecord, op->srcNodeIdx)) {
+				/* The child Record may not contain the source node in scenarios like
+				 * a failed OPTIONAL MATCH. In this case, delete the Record and try again. */
+				OpBase_DeleteRecord(childRecord);
+				continue;
+			}
+
+			// store received record
+			Record_PersistScalars(childRecord);
+			op->records[op->record_count++] = childRecord;
+		}
+	}
+
+	// no data
+	if(op->record_count == 0) return false;
+
+	_traverse(op);
+	return true;
+}
+
+// sets 'op->r' to the source record of the traversed pair
+// populated with the destination node and the pair's first edge
+static void _set_pair(OpCondTraverse *op, NodeID src_id, NodeID dest_id) {
+	// get node from current column
+	op->r = op->records[src_id];
+	// populate the destination node and add it to the Record
+	Node destNode = GE_NEW_NODE();
+	Graph_GetNode(op->graph, dest_id, &destNode);
+	Record_AddNode(op->r, op->destNodeIdx, destNode);
+
+	if(op->edge_ctx) {
+		Node *srcNode = Record_GetNode(op->r, op->srcNodeIdx);
+		// collect all appropriate edges connecting the current pair of endpoints
+		EdgeTraverseCtx_CollectEdges(op->edge_ctx, ENTITY_GET_ID(srcNode), ENTITY_GET_ID(&destNode));
+		// we're guaranteed to have at least one edge
+		EdgeTraverseCtx_SetEdge(op->edge_ctx, op->r);
+	}
+}
+
 /* Each call to CondTraverseConsume emits a Record containing the
  * traversal's endpoints and, if required, an edge.
  * Returns NULL once all traversals have been performed. */
 static Record CondTraverseConsume(OpBase *opBase) {
 	OpCondTraverse *op = (OpCondTraverse *)opBase;
-	OpBase *child = op->op.children[0];
 
 	/* If we're required to update an edge and have one queued, we can return early.
 	 * Otherwise, try to get a new pair of source and destination nodes. */
@@ -143,55 +266,49 @@ static Record CondTraverseConsume(OpBase *opBase) {
 		// Managed to get a tuple, break.
 		if(info == GrB_SUCCESS) break;
 
-		/* Run out of tuples, try to get new data.
-		 * Free old records. */
-		op->r = NULL;
-		for(uint i = 0; i < op->record_count; i++) {
-			OpBase_DeleteRecord(op->records[i]);
-		}
+		// Run out of tuples, try to get new data.
+		if(!_pull_sources(op)) return NULL;
+	}
 
-		// Ask child operations for data.
-		for(op->record_count = 0; op->record_count < op->record_cap; op->record_count++) {
-			Record childRecord = OpBase_Consume(child);
-			// If the Record is NULL, the child has been depleted.
-			if(childRecord == NULL) {
-				break;
-			}
-			if(!Record_GetNode(childRecord, op->srcNodeIdx)) {
-				/* The child Record may not contain the source node in scenarios like
-				 * a failed OPTIONAL MATCH. In this case, delete the Record and try again. */
-				OpBase_DeleteRecord(childRecord);
-				op->record_count--;
-				continue;
-			}
+	_set_pair(op, src_id, dest_id);
 
-			// Store received record.
-			Record_PersistScalars(childRecord);
-			op->records[op->record_count] = childRecord;
-		}
+	return OpBase_DeepCloneRecord(op->r);
+}
 
-		// No data.
-		if(op->record_count == 0) return NULL;
+/* Fills batch straight from the result matrix, traversing the next batch
+ * of sources whenever the matrix is exhausted.
+ * Emitted Records own their scalars, as held sources are freed once the next
+ * batch is pulled. */
+static uint CondTraverseConsumeBatch(OpBase *opBase, Record *batch, uint cap) {
+	OpCondTraverse *op = (OpCondTraverse *)opBase;
 
-		_traverse(op);
-	}
+	uint   n       = 0;
+	NodeID src_id  = INVALID_ENTITY_ID;
+	NodeID dest_id = INVALID_ENTITY_ID;
 
-	/* Get node from current column. */
-	op->r = op->records[src_id];
-	// Populate the destination node and add it to the Record.
-	Node destNode = GE_NEW_NODE();
-	Graph_GetNode(op->graph, dest_id, &destNode);
-	Record_AddNode(op->r, op->destNodeIdx, destNode);
+	while(n < cap) {
+		// emit edges queued for the current pair
+		if(op->r        != NULL &&
+		   op->edge_ctx != NULL &&
+		   EdgeTraverseCtx_SetEdge(op->edge_ctx, op->r)) {
+			batch[n++] = OpBase_DeepCloneRecord(op->r);
+			continue;
+		}
 
-	if(op->edge_ctx) {
-		Node *srcNode = Record_GetNode(op->r, op->srcNodeIdx);
-		// Collect all appropriate edges connecting the current pair of endpoints.
-		EdgeTraverseCtx_CollectEdges(op->edge_ctx, ENTITY_GET_ID(srcNode), ENTITY_GET_ID(&destNode));
-		// We're guaranteed to have at least one edge.
-		EdgeTraverseCtx_SetEdge(op->edge_ctx, op->r);
+		GrB_Info info = RG_MatrixTupleIter_next_UINT64(&op->iter, &src_id,
+				&dest_id, NULL);
+
+		if(info != GrB_SUCCESS) {
+			// run out of tuples, traverse the next batch of sources
+			if(!_pull_sources(op)) break;
+			continue;
+		}
+
+		_set_pair(op, src_id, dest_id);
+		batch[n++] = OpBase_DeepCloneRecord(op->r);
 	}
 
-	return OpBase_DeepCloneRecord(op->r);
+	return n;
 }
 
 static OpResult CondTraverseReset(OpBase *ctx) {
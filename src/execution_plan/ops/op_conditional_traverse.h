@@ -26,6 +26,9 @@ typedef struct {
 	int destNodeIdx;            // Destination node index into record.
 	uint record_count;          // Number of held records.
 	uint record_cap;            // Max number of records to process.
+	uint record_cap_max;        // Upper bound of the adaptive record_cap.
+	uint record_cap_peak;       // Largest record_cap used, reported by PROFILE.
+	uint64_t pair_budget;       // Max number of traversed pairs per batch.
 	Record *records;            // Array of records.
 	Record r;                   // Currently selected record.
 } OpCondTraverse;
@@ -122,6 +122,9 @@ static void _DeleteEntities
 				DeleteNodes(gc, distinct_nodes, node_count, true);
 				node_deleted = node_count;
 			}
+
+			// remove deleted entities from indices at once
+			QueryCtx_FlushIndexBuffer();
 		}
 	}
 
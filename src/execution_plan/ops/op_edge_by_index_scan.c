@@ -7,7 +7,7 @@
 #include "op_edge_by_index_scan.h"
 #include "../../query_ctx.h"
 #include "shared/print_functions.h"
-#include "../../filter_tree/ft_to_rsq.h"
+#include "../../filter_tree/ft_to_index_query.h"
 
 // forward declarations
 static OpResult EdgeIndexScanInit(OpBase *opBase);
@@ -36,7 +36,7 @@ OpBase *NewEdgeIndexScanOp
 	const ExecutionPlan *plan,
 	Graph *g,
 	QGEdge *e,
-	RSIndex *idx,
+	Index idx,
 	FT_FilterNode *filter
 ) {
 	// validate inputs
@@ -52,7 +52,7 @@ OpBase *NewEdgeIndexScanOp
 	op->g                    =  g;
 	op->idx                  =  idx;
 	op->edge                 =  e;
-	op->iter                 =  NULL;
+	op->query                =  NULL;
 	op->filter               =  filter;
 	op->child_record         =  NULL;
 	op->current_src_node_id  =  NULL;
@@ -214,9 +214,8 @@ pull_index:
 	// pull from index
 	//--------------------------------------------------------------------------
 
-	if(op->iter != NULL && op->child_record != NULL) {
-		while((edgeKey = RediSearch_ResultsIteratorNext(op->iter, op->idx, NULL))
-				!= NULL) {
+	if(op->query != NULL && op->child_record != NULL) {
+		while((edgeKey = IndexQuery_Next(op->query)) != NULL) {
 			// populate record with edge
 			_UpdateRecord(op, op->child_record, edgeKey);
 			// apply unresolved filters
@@ -245,14 +244,14 @@ pull_index:
 	if(op->child_record == NULL) return NULL; // depleted
 
 	//--------------------------------------------------------------------------
-	// reset index iterator
+	// reset index query
 	//--------------------------------------------------------------------------
 
 	if(op->rebuild_index_query) {
-		// free previous iterator
-		if(op->iter != NULL) {
-			RediSearch_ResultsIteratorFree(op->iter);
-			op->iter = NULL;
+		// free previous query
+		if(op->query != NULL) {
+			IndexQuery_Free(op->query);
+			op->query = NULL;
 		}
 
 		// free previous unresolved filters
@@ -277,26 +276,20 @@ pull_index:
 		}
 		#endif
 
-		// convert filter into a RediSearch query
-		RSQNode *rs_query_node = FilterTreeToQueryNode(&op->unresolved_filters,
-				filter, op->idx);
+		// convert filter into an index query
+		op->query = FilterTreeToIndexQuery(&op->unresolved_filters, filter,
+				op->idx);
 		FilterTree_Free(filter);
-
-		// create iterator
-		ASSERT(rs_query_node != NULL);
-		op->iter = RediSearch_GetResultsIterator(rs_query_node, op->idx);
 	} else {
 		// build index query only once (first call)
 		// reset it if already initialized
-		if(op->iter == NULL) {
-			// first call to consume, create query and iterator
-			RSQNode *rs_query_node = FilterTreeToQueryNode(
-					&op->unresolved_filters, op->filter, op->idx);
-			ASSERT(rs_query_node != NULL);
-			op->iter = RediSearch_GetResultsIterator(rs_query_node, op->idx);
+		if(op->query == NULL) {
+			// first call to consume, create query
+			op->query = FilterTreeToIndexQuery(&op->unresolved_filters,
+					op->filter, op->idx);
 		} else {
-			// reset existing iterator
-			RediSearch_ResultsIteratorReset(op->iter);
+			// reset existing query
+			IndexQuery_Reset(op->query);
 		}
 	}
 
@@ -310,22 +303,19 @@ static Record EdgeIndexScanConsume
 ) {
 	OpEdgeIndexScan *op = (OpEdgeIndexScan *)opBase;
 
-	// create iterator on first call
-	if(op->iter == NULL) {
+	// create query on first call
+	if(op->query == NULL) {
 		UpdateCurrentAwareIds(op);
 
-		RSQNode *rs_query_node = FilterTreeToQueryNode(&op->unresolved_filters,
-				op->filter, op->idx);
-
-		op->iter = RediSearch_GetResultsIterator(rs_query_node, op->idx);
+		op->query = FilterTreeToIndexQuery(&op->unresolved_filters, op->filter,
+				op->idx);
 	}
 
 	const EdgeIndexKey *edgeKey = NULL;
 
 	// populate the Record with the actual edge
 	Record r = OpBase_CreateRecord((OpBase *)op);
-	while((edgeKey = RediSearch_ResultsIteratorNext(op->iter, op->idx, NULL))
-			!= NULL) {
+	while((edgeKey = IndexQuery_Next(op->query)) != NULL) {
 		// populate record with edge
 		_UpdateRecord(op, r, edgeKey);
 		// apply unresolved filters
@@ -342,9 +332,9 @@ static Record EdgeIndexScanConsume
 static OpResult EdgeIndexScanReset(OpBase *opBase) {
 	OpEdgeIndexScan *op = (OpEdgeIndexScan *)opBase;
 
-	if(op->iter) {
-		RediSearch_ResultsIteratorFree(op->iter);
-		op->iter = NULL;
+	if(op->query) {
+		IndexQuery_Free(op->query);
+		op->query = NULL;
 	}
 
 	if(op->unresolved_filters) {
@@ -357,13 +347,9 @@ static OpResult EdgeIndexScanReset(OpBase *opBase) {
 
 static void EdgeIndexScanFree(OpBase *opBase) {
 	OpEdgeIndexScan *op = (OpEdgeIndexScan *)opBase;
-	// as long as this Index iterator is alive the index is
-	// read locked, if this index scan operation is part of
-	// a query which will modified this index we'll be stuck in
-	// a dead lock, as we're unable to acquire index write lock
-	if(op->iter) {
-		RediSearch_ResultsIteratorFree(op->iter);
-		op->iter = NULL;
+	if(op->query) {
+		IndexQuery_Free(op->query);
+		op->query = NULL;
 	}
 
 	if(op->child_record) {
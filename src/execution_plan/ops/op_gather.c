@@ -0,0 +1,483 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "op_gather.h"
+#include "../../query_ctx.h"
+#include "op_all_node_scan.h"
+#include "../../errors/errors.h"
+#include "op_node_by_label_scan.h"
+#include "../execution_plan_clone.h"
+#include "../../util/thpool/pools.h"
+
+#include <pthread.h>
+
+// max number of records queued by helpers, once reached helpers wait
+// for the queue to drain
+#define GATHER_QUEUE_CAP 1024
+
+// helper pipeline
+typedef struct {
+	GatherCtx *ctx;       // shared gather context
+	ExecutionPlan *plan;  // cloned pipeline
+	Record *recycle;      // records consumed by gather, pending deletion
+	void *sink_ctx;       // [optional] sink context
+} GatherHelper;
+
+// record produced by a helper
+typedef struct {
+	Record r;              // produced record
+	GatherHelper *helper;  // producing helper
+} GatherItem;
+
+struct GatherCtx {
+	pthread_mutex_t mutex;    // guards context
+	pthread_cond_t produced;  // signaled when a record is queued or a helper exits
+	pthread_cond_t consumed;  // signaled when a record is dequeued
+	MorselSource morsels;     // morsels shared by all pipelines
+	QueryCtx *query_ctx;      // query context, shared with helpers
+	GatherHelper *helpers;    // helper pipelines
+	uint helper_count;        // number of helper pipelines
+	GatherItem *queue;        // records produced by helpers
+	GatherSink sink;          // [optional] consumes records produced by helpers
+	uint active;              // number of running helpers
+	uint refcount;            // gather op and dispatched helpers
+	bool closed;              // no helper may start once set
+	char *error;              // error raised by a helper
+};
+
+// forward declarations
+static OpResult GatherInit(OpBase *opBase);
+static Record GatherConsume(OpBase *opBase);
+static OpBase *GatherClone(const ExecutionPlan *plan, const OpBase *opBase);
+static void GatherFree(OpBase *opBase);
+
+OpBase *NewGatherOp
+(
+	const ExecutionPlan *plan
+) {
+	OpGather *op = rm_calloc(1, sizeof(OpGather));
+
+	// set our op operations
+	OpBase_Init((OpBase *)op, OPType_GATHER, "Gather", GatherInit,
+			GatherConsume, NULL, NULL, GatherClone, GatherFree, false, plan);
+
+	return (OpBase *)op;
+}
+
+// attach morsel source to the scan tapping the pipeline rooted at `root`
+static void _Gather_SetMorsels
+(
+	OpBase *root,
+	MorselSource *morsels
+) {
+	OpBase *tap = root;
+	while(tap->childCount > 0) tap = tap->children[0];
+
+	if(tap->type == OPType_ALL_NODE_SCAN) {
+		AllNodeScanOp_SetMorsels((AllNodeScan *)tap, morsels);
+	} else {
+		NodeByLabelScanOp_SetMorsels((NodeByLabelScan *)tap, morsels);
+	}
+}
+
+// profile a helper pipeline the same way gather's own pipeline is profiled
+static void _Gather_InitProfiling
+(
+	OpBase *op
+) {
+	op->profile = op->consume;
+	op->consume = OpBase_Profile;
+	// profiled operations are consumed record by record
+	op->consumeBatch = NULL;
+	op->stats = rm_calloc(1, sizeof(OpStats));
+
+	for(int i = 0; i < op->childCount; i++) {
+		_Gather_InitProfiling(op->children[i]);
+	}
+}
+
+// accumulate the profile of a helper pipeline `src`
+// into the matching operations of gather's own pipeline `dest`
+static void _Gather_MergeProfile
+(
+	OpBase *dest,
+	const OpBase *src
+) {
+	ASSERT(dest->childCount == src->childCount);
+
+	dest->stats->profileExecTime    += src->stats->profileExecTime;
+	dest->stats->profileRecordCount += src->stats->profileRecordCount;
+	dest->stats->profileUndoLogSize += src->stats->profileUndoLogSize;
+
+	for(int i = 0; i < dest->childCount; i++) {
+		_Gather_MergeProfile(dest->children[i], src->children[i]);
+	}
+}
+
+// merge the profiles of all helper pipelines into gather's stats
+// must be called once no helper is running
+static void _Gather_MergeProfiles
+(
+	OpGather *op
+) {
+	OpBase *opBase = (OpBase *)op;
+	GatherCtx *ctx = op->ctx;
+	ASSERT(ctx->active == 0);
+
+	OpBase *child = opBase->children[0];
+	for(uint i = 0; i < ctx->helper_count; i++) {
+		OpBase *root = ctx->helpers[i].plan->root;
+		_Gather_MergeProfile(child, root);
+
+		// gather's execution time includes the time spent by its helpers
+		// otherwise deducting its child's time would yield a negative time
+		opBase->stats->profileExecTime += root->stats->profileExecTime;
+	}
+}
+
+// drop a reference to the gather context, freeing it once unreferenced
+static void _GatherCtx_Release
+(
+	GatherCtx *ctx
+) {
+	if(__atomic_sub_fetch(&ctx->refcount, 1, __ATOMIC_ACQ_REL) > 0) return;
+
+	ASSERT(ctx->active == 0);
+
+	if(ctx->error != NULL) rm_free(ctx->error);
+	array_free(ctx->queue);
+	rm_free(ctx->helpers);
+
+	pthread_cond_destroy(&ctx->consumed);
+	pthread_cond_destroy(&ctx->produced);
+	pthread_mutex_destroy(&ctx->mutex);
+
+	rm_free(ctx);
+}
+
+static OpResult GatherInit
+(
+	OpBase *opBase
+) {
+	OpGather *op = (OpGather *)opBase;
+	ASSERT(opBase->childCount == 1);
+
+	GatherCtx *ctx = rm_calloc(1, sizeof(GatherCtx));
+
+	pthread_mutex_init(&ctx->mutex, NULL);
+	pthread_cond_init(&ctx->produced, NULL);
+	pthread_cond_init(&ctx->consumed, NULL);
+
+	ctx->queue     = array_new(GatherItem, GATHER_QUEUE_CAP);
+	ctx->refcount  = 1;
+	ctx->query_ctx = QueryCtx_GetQueryCtx();
+
+	// memory capacity applies to the query as a whole
+	// charge this thread's allocations to the counter shared with helpers
+	rm_attach_n_alloced(&ctx->query_ctx->n_alloced);
+
+	// scanned ID range is fixed, the graph is read-locked
+	// throughout the query
+	MorselSource_Init(&ctx->morsels,
+			Graph_UncompactedNodeCount(QueryCtx_GetGraph()));
+
+	op->ctx = ctx;
+
+	// the child pipeline is not initialized yet
+	// attach morsels to its scan before it does
+	OpBase *child = opBase->children[0];
+	_Gather_SetMorsels(child, &ctx->morsels);
+
+	// one helper per additional reader, no more than there are morsels
+	uint64_t morsel_count = MorselSource_Count(&ctx->morsels);
+	uint helper_count = ThreadPools_ReadersCount() - 1;
+	if(morsel_count <= helper_count) {
+		helper_count = (morsel_count > 0) ? morsel_count - 1 : 0;
+	}
+
+	ctx->helper_count = helper_count;
+	ctx->helpers = rm_calloc(helper_count, sizeof(GatherHelper));
+
+	// clone and initialize a pipeline for each helper
+	for(uint i = 0; i < helper_count; i++) {
+		GatherHelper *helper = ctx->helpers + i;
+		helper->ctx     = ctx;
+		helper->plan    = ExecutionPlan_CloneBranch(child);
+		helper->recycle = array_new(Record, 0);
+
+		_Gather_SetMorsels(helper->plan->root, &ctx->morsels);
+		if(opBase->stats != NULL) _Gather_InitProfiling(helper->plan->root);
+		ExecutionPlan_Init(helper->plan);
+	}
+
+	return OP_OK;
+}
+
+// queue a record produced by a helper
+// returns false if gather is closed, in which case the record is discarded
+static bool _Gather_Push
+(
+	GatherHelper *helper,
+	Record r
+) {
+	GatherCtx *ctx = helper->ctx;
+
+	pthread_mutex_lock(&ctx->mutex);
+
+	// free records gather is done with
+	uint n = array_len(helper->recycle);
+	for(uint i = 0; i < n; i++) OpBase_DeleteRecord(helper->recycle[i]);
+	array_clear(helper->recycle);
+
+	while(array_len(ctx->queue) >= GATHER_QUEUE_CAP && !ctx->closed) {
+		pthread_cond_wait(&ctx->consumed, &ctx->mutex);
+	}
+
+	bool closed = ctx->closed;
+	if(!closed) {
+		GatherItem item = {.r = r, .helper = helper};
+		array_append(ctx->queue, item);
+		pthread_cond_signal(&ctx->produced);
+	}
+
+	pthread_mutex_unlock(&ctx->mutex);
+
+	if(closed) OpBase_DeleteRecord(r);
+	return !closed;
+}
+
+// report error encountered by helper to gather and stop all pipelines
+static void _Gather_ReportError
+(
+	GatherCtx *ctx
+) {
+	const char *err = ErrorCtx_Get()->error;
+
+	pthread_mutex_lock(&ctx->mutex);
+	if(ctx->error == NULL) {
+		ctx->error = rm_strdup(err != NULL ? err : "Parallel scan failed");
+	}
+	pthread_mutex_unlock(&ctx->mutex);
+
+	MorselSource_Deplete(&ctx->morsels);
+}
+
+// drain helper's pipeline into gather's queue
+static void _Gather_RunPipeline
+(
+	GatherHelper *helper
+) {
+	GatherCtx *ctx = helper->ctx;
+
+	// charge helper's allocations to the query's shared memory counter
+	rm_reset_n_alloced();
+	rm_attach_n_alloced(&ctx->query_ctx->n_alloced);
+
+	// set an exception-handling breakpoint to capture run-time errors
+	// raised by the helper's pipeline
+	if(SET_EXCEPTION_HANDLER()) {
+		_Gather_ReportError(ctx);
+		ErrorCtx_Clear();
+		rm_reset_n_alloced();
+		return;
+	}
+
+	Record r;
+	OpBase *root = helper->plan->root;
+	if(ctx->sink != NULL) {
+		// records are consumed on this thread
+		while((r = OpBase_Consume(root)) != NULL) ctx->sink(helper->sink_ctx, r);
+	} else {
+		while((r = OpBase_Consume(root)) != NULL) {
+			if(!_Gather_Push(helper, r)) break;
+		}
+	}
+
+	// errors set without raising an exception e.g. memory limit exceeded
+	if(ErrorCtx_EncounteredError()) _Gather_ReportError(ctx);
+	ErrorCtx_Clear();
+
+	// detach from the query's shared memory counter
+	rm_reset_n_alloced();
+}
+
+// helper task, executed by a reader thread
+static void _Gather_Help
+(
+	void *arg
+) {
+	GatherHelper *helper = (GatherHelper *)arg;
+	GatherCtx *ctx = helper->ctx;
+
+	// gather might have been closed before this task got scheduled
+	pthread_mutex_lock(&ctx->mutex);
+	bool closed = ctx->closed;
+	if(!closed) ctx->active++;
+	pthread_mutex_unlock(&ctx->mutex);
+
+	if(!closed) {
+		QueryCtx_SetTLS(ctx->query_ctx);
+		_Gather_RunPipeline(helper);
+		QueryCtx_RemoveFromTLS();
+
+		pthread_mutex_lock(&ctx->mutex);
+		ctx->active--;
+		pthread_cond_signal(&ctx->produced);
+		pthread_mutex_unlock(&ctx->mutex);
+	}
+
+	_GatherCtx_Release(ctx);
+}
+
+// hand helper pipelines to the readers thread pool
+static void _Gather_Dispatch
+(
+	OpGather *op
+) {
+	GatherCtx *ctx = op->ctx;
+
+	for(uint i = 0; i < ctx->helper_count; i++) {
+		__atomic_add_fetch(&ctx->refcount, 1, __ATOMIC_RELAXED);
+		if(ThreadPools_AddWorkReader(_Gather_Help, ctx->helpers + i, 0) != 0) {
+			// readers queue is full, morsels are left to the running pipelines
+			__atomic_sub_fetch(&ctx->refcount, 1, __ATOMIC_RELAXED);
+			break;
+		}
+	}
+
+	op->dispatched = true;
+}
+
+static Record GatherConsume
+(
+	OpBase *opBase
+) {
+	OpGather *op = (OpGather *)opBase;
+	GatherCtx *ctx = op->ctx;
+
+	if(!op->dispatched) _Gather_Dispatch(op);
+
+	while(true) {
+		Record r = NULL;
+
+		pthread_mutex_lock(&ctx->mutex);
+
+		// own pipeline is depleted, wait for running helpers
+		if(op->depleted) {
+			while(array_len(ctx->queue) == 0 && ctx->active > 0 &&
+				  ctx->error == NULL) {
+				pthread_cond_wait(&ctx->produced, &ctx->mutex);
+			}
+		}
+
+		if(ctx->error != NULL) {
+			ErrorCtx_SetError("%s", ctx->error);
+			pthread_mutex_unlock(&ctx->mutex);
+			ErrorCtx_RaiseRuntimeException(NULL);
+			return NULL;
+		}
+
+		// prefer records produced by helpers, freeing up queue space
+		if(array_len(ctx->queue) > 0) {
+			GatherItem item = array_pop(ctx->queue);
+			pthread_cond_signal(&ctx->consumed);
+
+			// take ownership over the helper's record entries
+			// the helper's record is returned to it for deletion
+			r = OpBase_CreateRecord(opBase);
+			Record_TransferEntries(&r, item.r, true);
+			array_append(item.helper->recycle, item.r);
+		} else if(op->depleted && !ctx->closed) {
+			// all pipelines are depleted
+			ctx->closed = true;
+			if(opBase->stats != NULL) _Gather_MergeProfiles(op);
+		}
+
+		pthread_mutex_unlock(&ctx->mutex);
+
+		if(r != NULL) return r;
+		if(op->depleted) return NULL;
+
+		r = OpBase_Consume(opBase->children[0]);
+		if(r != NULL) return r;
+
+		op->depleted = true;
+	}
+}
+
+uint GatherOp_HelperCount
+(
+	const OpGather *op
+) {
+	ASSERT(op != NULL);
+	ASSERT(op->ctx != NULL);
+	return op->ctx->helper_count;
+}
+
+void GatherOp_SetSink
+(
+	OpGather *op,
+	GatherSink sink,
+	void **sink_ctxs
+) {
+	ASSERT(op != NULL);
+	ASSERT(sink != NULL);
+	ASSERT(op->ctx != NULL);
+	ASSERT(!op->dispatched);
+
+	GatherCtx *ctx = op->ctx;
+	ctx->sink = sink;
+	for(uint i = 0; i < ctx->helper_count; i++) {
+		ctx->helpers[i].sink_ctx = sink_ctxs[i];
+	}
+}
+
+static inline OpBase *GatherClone
+(
+	const ExecutionPlan *plan,
+	const OpBase *opBase
+) {
+	ASSERT(opBase->type == OPType_GATHER);
+	return NewGatherOp(plan);
+}
+
+static void GatherFree
+(
+	OpBase *opBase
+) {
+	OpGather *op = (OpGather *)opBase;
+	GatherCtx *ctx = op->ctx;
+	if(ctx == NULL) return;
+
+	// stop all pipelines and wait for running helpers to exit
+	pthread_mutex_lock(&ctx->mutex);
+	ctx->closed = true;
+	MorselSource_Deplete(&ctx->morsels);
+	pthread_cond_broadcast(&ctx->consumed);
+	while(ctx->active > 0) pthread_cond_wait(&ctx->produced, &ctx->mutex);
+	pthread_mutex_unlock(&ctx->mutex);
+
+	// no helper is running nor will one start
+	// it is safe to free helpers' records and pipelines
+	uint n = array_len(ctx->queue);
+	for(uint i = 0; i < n; i++) OpBase_DeleteRecord(ctx->queue[i].r);
+	array_clear(ctx->queue);
+
+	for(uint i = 0; i < ctx->helper_count; i++) {
+		GatherHelper *helper = ctx->helpers + i;
+		n = array_len(helper->recycle);
+		for(uint j = 0; j < n; j++) OpBase_DeleteRecord(helper->recycle[j]);
+		array_free(helper->recycle);
+		helper->recycle = NULL;
+
+		ExecutionPlan_Free(helper->plan);
+		helper->plan = NULL;
+	}
+
+	_GatherCtx_Release(ctx);
+	op->ctx = NULL;
+}
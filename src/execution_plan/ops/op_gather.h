@@ -0,0 +1,54 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "op.h"
+#include "shared/morsel.h"
+#include "../execution_plan.h"
+
+// Gather is an exchange operation placed right below an eager operation
+// its child pipeline, a chain of streaming operations tapped by a node scan
+// is cloned for a number of helper threads from the readers pool
+// the scans of all pipelines claim morsels from a shared MorselSource
+// gather merges the records produced by the helpers with the records
+// produced by its own pipeline, which is executed on the calling thread
+
+typedef struct GatherCtx GatherCtx;
+
+// consumes a record produced by a helper pipeline
+// invoked on the helper's thread, takes ownership over the record
+typedef void (*GatherSink)(void *sink_ctx, Record r);
+
+typedef struct {
+	OpBase op;
+	GatherCtx *ctx;    // state shared with helpers
+	bool dispatched;   // true once helpers were dispatched
+	bool depleted;     // true once own pipeline is depleted
+} OpGather;
+
+// creates a new Gather operation
+OpBase *NewGatherOp
+(
+	const ExecutionPlan *plan  // execution plan
+);
+
+// returns the number of helper pipelines
+// gather must be initialized
+uint GatherOp_HelperCount
+(
+	const OpGather *op  // gather op
+);
+
+// hand records produced by the i-th helper pipeline to sink(sink_ctxs[i], r)
+// on the helper's thread, instead of passing them through gather
+// must be called before consuming from gather
+void GatherOp_SetSink
+(
+	OpGather *op,      // gather op
+	GatherSink sink,   // sink callback
+	void **sink_ctxs   // sink context for each helper pipeline
+);
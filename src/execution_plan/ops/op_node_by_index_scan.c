@@ -7,7 +7,7 @@
 #include "op_node_by_index_scan.h"
 #include "../../query_ctx.h"
 #include "shared/print_functions.h"
-#include "../../filter_tree/ft_to_rsq.h"
+#include "../../filter_tree/ft_to_index_query.h"
 
 // forward declarations
 static OpResult IndexScanInit(OpBase *opBase);
@@ -19,10 +19,12 @@ static void IndexScanFree(OpBase *opBase);
 static void IndexScanToString(const OpBase *ctx, sds *buf) {
 	IndexScan *op = (IndexScan *)ctx;
 	ScanToString(ctx, buf, op->n->alias, op->n->label);
+	if(op->covering) *buf = sdscatprintf(*buf, " | Index only");
+	if(op->sort_field >= 0) *buf = sdscatprintf(*buf, " | Index order");
 }
 
 OpBase *NewIndexScanOp(const ExecutionPlan *plan, Graph *g, NodeScanCtx *n,
-		RSIndex *idx, FT_FilterNode *filter) {
+		Index idx, FT_FilterNode *filter) {
 	// validate inputs
 	ASSERT(g      != NULL);
 	ASSERT(idx    != NULL);
@@ -33,8 +35,11 @@ OpBase *NewIndexScanOp(const ExecutionPlan *plan, Graph *g, NodeScanCtx *n,
 	op->g                    =  g;
 	op->n                    =  n;
 	op->idx                  =  idx;
-	op->iter                 =  NULL;
+	op->query                =  NULL;
 	op->filter               =  filter;
+	op->covering             =  false;
+	op->sort_desc            =  false;
+	op->sort_field           =  -1;
 	op->child_record         =  NULL;
 	op->unresolved_filters   =  NULL;
 	op->rebuild_index_query  =  false;
@@ -73,11 +78,47 @@ static OpResult IndexScanInit(OpBase *opBase) {
 	return OP_OK;
 }
 
+void IndexScanOp_SetCovering(IndexScan *op) {
+	ASSERT(op != NULL);
+	op->covering = true;
+}
+
+void IndexScanOp_SetOrder
+(
+	IndexScan *op,
+	uint16_t field,
+	bool descending
+) {
+	ASSERT(op != NULL);
+	ASSERT(op->op.childCount == 0);
+
+	op->sort_desc  = descending;
+	op->sort_field = field;
+}
+
+bool IndexScanOp_Ordered
+(
+	const IndexScan *op
+) {
+	ASSERT(op != NULL);
+
+	return op->sort_field >= 0 && op->query != NULL &&
+		IndexQuery_Ordered(op->query);
+}
+
 static inline void _UpdateRecord(IndexScan *op, Record r, EntityID node_id) {
-	// Populate the Record with the graph entity data.
 	Node n = GE_NEW_NODE();
-	int res = Graph_GetNode(op->g, node_id, &n);
-	ASSERT(res != 0);
+
+	// unresolved filters might access any of the node's attributes
+	if(op->covering && op->unresolved_filters == NULL) {
+		// skip fetching node, bound attribute accesses read from the index
+		n.id = node_id;
+	} else {
+		// Populate the Record with the graph entity data.
+		int res = Graph_GetNode(op->g, node_id, &n);
+		ASSERT(res != 0);
+	}
+
 	Record_AddNode(r, op->nodeRecIdx, n);
 }
 
@@ -96,9 +137,8 @@ pull_index:
 	// pull from index
 	//--------------------------------------------------------------------------
 
-	if(op->iter != NULL && op->child_record != NULL) {
-		while((nodeId = RediSearch_ResultsIteratorNext(op->iter, op->idx, NULL))
-				!= NULL) {
+	if(op->query != NULL && op->child_record != NULL) {
+		while((nodeId = IndexQuery_Next(op->query)) != NULL) {
 			// populate record with node
 			_UpdateRecord(op, op->child_record, *nodeId);
 			// apply unresolved filters
@@ -127,14 +167,14 @@ pull_index:
 	if(op->child_record == NULL) return NULL; // depleted
 
 	//--------------------------------------------------------------------------
-	// reset index iterator
+	// reset index query
 	//--------------------------------------------------------------------------
 
 	if(op->rebuild_index_query) {
-		// free previous iterator
-		if(op->iter != NULL) {
-			RediSearch_ResultsIteratorFree(op->iter);
-			op->iter = NULL;
+		// free previous query
+		if(op->query != NULL) {
+			IndexQuery_Free(op->query);
+			op->query = NULL;
 		}
 
 		// free previous unresolved filters
@@ -157,25 +197,20 @@ pull_index:
 		}
 		#endif
 
-		// convert filter into a RediSearch query
-		RSQNode *rs_query_node = FilterTreeToQueryNode(&op->unresolved_filters,
-				filter, op->idx);
+		// convert filter into an index query
+		op->query = FilterTreeToIndexQuery(&op->unresolved_filters, filter,
+				op->idx);
 		FilterTree_Free(filter);
-
-		// create iterator
-		ASSERT(rs_query_node != NULL);
-		op->iter = RediSearch_GetResultsIterator(rs_query_node, op->idx);
 	} else {
 		// build index query only once (first call)
 		// reset it if already initialized
-		if(op->iter == NULL) {
-			// first call to consume, create query and iterator
-			RSQNode *rs_query_node = FilterTreeToQueryNode(&op->unresolved_filters, op->filter, op->idx);
-			ASSERT(rs_query_node != NULL);
-			op->iter = RediSearch_GetResultsIterator(rs_query_node, op->idx);
+		if(op->query == NULL) {
+			// first call to consume, create query
+			op->query = FilterTreeToIndexQuery(&op->unresolved_filters,
+					op->filter, op->idx);
 		} else {
-			// reset existing iterator
-			RediSearch_ResultsIteratorReset(op->iter);
+			// reset existing query
+			IndexQuery_Reset(op->query);
 		}
 	}
 
@@ -186,20 +221,20 @@ pull_index:
 static Record IndexScanConsume(OpBase *opBase) {
 	IndexScan *op = (IndexScan *)opBase;
 
-	// create iterator on first call
-	if(op->iter == NULL) {
-		RSQNode *rs_query_node = FilterTreeToQueryNode(&op->unresolved_filters,
-				op->filter, op->idx);
-
-		op->iter = RediSearch_GetResultsIterator(rs_query_node, op->idx);
+	// create query on first call
+	if(op->query == NULL) {
+		op->query = FilterTreeToIndexQuery(&op->unresolved_filters, op->filter,
+				op->idx);
+		if(op->sort_field >= 0) {
+			IndexQuery_SetOrder(op->query, op->sort_field, op->sort_desc);
+		}
 	}
 
 	const EntityID *nodeId = NULL;
 
 	// populate the Record with the actual node
 	Record r = OpBase_CreateRecord((OpBase *)op);
-	while((nodeId = RediSearch_ResultsIteratorNext(op->iter, op->idx, NULL))
-			!= NULL) {
+	while((nodeId = IndexQuery_Next(op->query)) != NULL) {
 		// populate record with node
 		_UpdateRecord(op, r, *nodeId);
 		// apply unresolved filters
@@ -216,9 +251,9 @@ static Record IndexScanConsume(OpBase *opBase) {
 static OpResult IndexScanReset(OpBase *opBase) {
 	IndexScan *op = (IndexScan *)opBase;
 
-	if(op->iter) {
-		RediSearch_ResultsIteratorFree(op->iter);
-		op->iter = NULL;
+	if(op->query) {
+		IndexQuery_Free(op->query);
+		op->query = NULL;
 	}
 
 	if(op->unresolved_filters) {
@@ -231,13 +266,9 @@ static OpResult IndexScanReset(OpBase *opBase) {
 
 static void IndexScanFree(OpBase *opBase) {
 	IndexScan *op = (IndexScan *)opBase;
-	/* As long as this Index iterator is alive the index is
-	 * read locked, if this index scan operation is part of
-	 * a query which will modified this index we'll be stuck in
-	 * a dead lock, as we're unable to acquire index write lock. */
-	if(op->iter != NULL) {
-		RediSearch_ResultsIteratorFree(op->iter);
-		op->iter = NULL;
+	if(op->query != NULL) {
+		IndexQuery_Free(op->query);
+		op->query = NULL;
 	}
 
 	if(op->child_record != NULL) {
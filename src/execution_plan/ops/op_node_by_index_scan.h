@@ -10,17 +10,20 @@
 #include "../execution_plan.h"
 #include "../../graph/graph.h"
 #include "../../index/index.h"
+#include "../../index/index_query.h"
 #include "shared/scan_functions.h"
-#include "redisearch_api.h"
 
 typedef struct {
 	OpBase op;
 	Graph *g;
-	bool rebuild_index_query;           // should we rebuild RediSearch index query for each input record
-	RSIndex *idx;                       // index to query
+	bool rebuild_index_query;           // should we rebuild index query for each input record
+	bool covering;                      // index covers all accesses to scanned node
+	bool sort_desc;                     // requested order is descending
+	int sort_field;                     // index field nodes are requested ordered by, -1 if none
+	Index idx;                          // index to query
 	NodeScanCtx *n;                     // label data of node being scanned
 	uint nodeRecIdx;                    // index of the node being scanned in the Record
-	RSResultsIterator *iter;            // rediSearch iterator over an index with the appropriate filters
+	IndexQuery *query;                  // index query with the appropriate filters
 	FT_FilterNode *filter;              // filter from which to compose index query
 	FT_FilterNode *unresolved_filters;  // subset of filter, contains filters that couldn't be resolved by index
 	Record child_record;                // the Record this op acts on if it is not a tap
@@ -28,5 +31,28 @@ typedef struct {
 
 // creates a new IndexScan operation
 OpBase *NewIndexScanOp(const ExecutionPlan *plan, Graph *g, NodeScanCtx *n,
-		RSIndex *idx, FT_FilterNode *filter);
+		Index idx, FT_FilterNode *filter);
 
+// marks scan as covering, see coverIndexScans
+// a covering scan emits nodes without fetching them from the graph
+// as all accesses to scanned nodes are resolved by the index
+void IndexScanOp_SetCovering(IndexScan *op);
+
+// requests nodes to be emitted in order of an indexed field's value
+// see IndexScanOp_Ordered
+void IndexScanOp_SetOrder
+(
+	IndexScan *op,    // scan to order
+	uint16_t field,   // index field position
+	bool descending   // order nodes by descending value
+);
+
+// returns true if the scan emits nodes in the order requested by
+// IndexScanOp_SetOrder, valid once the scan emitted its first node
+// nodes sharing a value are emitted in no particular order
+// the index query decides at runtime whether its resolved ranges
+// can be scanned in order, see IndexQuery_Ordered
+bool IndexScanOp_Ordered
+(
+	const IndexScan *op  // scan
+);
@@ -14,6 +14,7 @@
 static OpResult NodeByLabelScanInit(OpBase *opBase);
 static Record NodeByLabelScanConsume(OpBase *opBase);
 static Record NodeByLabelScanConsumeFromChild(OpBase *opBase);
+static Record NodeByLabelScanConsumeMorsel(OpBase *opBase);
 static Record NodeByLabelScanNoOp(OpBase *opBase);
 static OpResult NodeByLabelScanReset(OpBase *opBase);
 static OpBase *NodeByLabelScanClone(const ExecutionPlan *plan, const OpBase *opBase);
@@ -75,6 +76,16 @@ void NodeByLabelScanOp_SetIDRange
 	op->op.name = "Node By Label and ID Scan";
 }
 
+void NodeByLabelScanOp_SetMorsels
+(
+	NodeByLabelScan *op,
+	MorselSource *morsels
+) {
+	ASSERT(op->op.childCount == 0);
+	ASSERT(op->op.type == OPType_NODE_BY_LABEL_SCAN);
+	op->morsels = morsels;
+}
+
 static GrB_Info _ConstructIterator
 (
 	NodeByLabelScan *op
@@ -125,6 +136,12 @@ static OpResult NodeByLabelScanInit
 		return OP_OK;
 	}	
 
+	// iterator is attached to each morsel as it is claimed
+	if(op->morsels != NULL) {
+		OpBase_UpdateConsume(opBase, NodeByLabelScanConsumeMorsel);
+		return OP_OK;
+	}
+
 	// the iterator build may fail if the ID range does not match the matrix dimensions
 	GrB_Info iterator_built = _ConstructIterator(op);
 	if(iterator_built != GrB_SUCCESS) {
@@ -218,6 +235,37 @@ static Record NodeByLabelScanConsume(OpBase *opBase) {
 	return r;
 }
 
+// scan label matrix morsel by morsel, attaching the iterator to a newly
+// claimed morsel once the current one is exhausted
+static Record NodeByLabelScanConsumeMorsel
+(
+	OpBase *opBase
+) {
+	NodeByLabelScan *op = (NodeByLabelScan *)opBase;
+
+	GrB_Index nodeId;
+	GrB_Info info = RG_MatrixTupleIter_next_BOOL(&op->iter, &nodeId, NULL, NULL);
+	while(info != GrB_SUCCESS) {
+		// current morsel exhausted (or no morsel claimed yet)
+		uint64_t min;
+		uint64_t max;
+		if(!MorselSource_Claim(op->morsels, &min, &max)) return NULL;
+
+		RG_Matrix L = Graph_GetLabelMatrix(op->g, op->n->label_id);
+		info = RG_MatrixTupleIter_AttachRange(&op->iter, L, min, max - 1);
+		ASSERT(info == GrB_SUCCESS);
+
+		info = RG_MatrixTupleIter_next_BOOL(&op->iter, &nodeId, NULL, NULL);
+	}
+
+	Record r = OpBase_CreateRecord((OpBase *)op);
+
+	// Populate the Record with the actual node.
+	_UpdateRecord(op, r, nodeId);
+
+	return r;
+}
+
 // this function is invoked when the op has no children
 // and no valid label is requested (either no label, or non existing label)
 // the op simply needs to return NULL
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "op.h"
+#include "shared/morsel.h"
 #include "shared/scan_functions.h"
 #include "../execution_plan.h"
 #include "../../graph/graph.h"
@@ -25,6 +26,7 @@ typedef struct {
 	UnsignedRange *id_range;    // ID range to iterate over
 	RG_MatrixTupleIter iter;    // Iterator over label matrix
 	Record child_record;        // The Record this op acts on if it is not a tap
+	MorselSource *morsels;      // [optional] shared source of ID ranges to scan
 } NodeByLabelScan;
 
 /* Creates a new NodeByLabelScan operation */
@@ -37,3 +39,6 @@ OpBase *NewNodeByLabelScanOp
 /* Transform a simple label scan to perform additional range query over the label  matrix. */
 void NodeByLabelScanOp_SetIDRange(NodeByLabelScan *op, UnsignedRange *id_range);
 
+/* Restrict scan to the morsels it claims from a shared source. */
+void NodeByLabelScanOp_SetMorsels(NodeByLabelScan *op, MorselSource *morsels);
+
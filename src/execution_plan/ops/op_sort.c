@@ -11,6 +11,25 @@
 #include "../../util/qsort.h"
 #include "../../util/rmalloc.h"
 #include "../../query_ctx.h"
+#include "../../errors/errors.h"
+#include "../../index/index_range.h"
+
+#include <math.h>
+
+// min number of records buffered before memory pressure triggers a spill
+#define SORT_RUN_MIN_RECORDS 1024
+
+// memory pressure is checked once every SORT_PRESSURE_INTERVAL records
+#define SORT_PRESSURE_INTERVAL 1024
+
+// portion of the query's memory capacity above which buffered records spill
+#define SORT_MEM_PRESSURE 0.5
+
+// max number of spilled runs of a single level merged at once
+#define SORT_MERGE_FAN_IN 64
+
+// merge level denoting the final merge of all levels and the buffer
+#define SORT_FINAL_MERGE UINT_MAX
 
 // forward declarations
 static OpResult SortInit(OpBase *opBase);
@@ -18,6 +37,7 @@ static Record SortConsume(OpBase *opBase);
 static OpResult SortReset(OpBase *opBase);
 static OpBase *SortClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void SortFree(OpBase *opBase);
+static void SortToString(const OpBase *ctx, sds *buff);
 
 // function to compare two records on a subset of fields
 // return value similar to strcmp
@@ -51,18 +71,264 @@ static int _buffer_elem_cmp
 	return _record_cmp(*a, *b, op);
 }
 
-static void _accumulate
+// runs are ordered by their head record, smallest on top
+static int _run_cmp
+(
+	const SortRun *a,
+	const SortRun *b,
+	OpSort *op
+) {
+	return _record_cmp(b->head, a->head, op);
+}
+
+// returns true if the op-tree rooted at `root` contains a writer op
+static bool _containsWriter
+(
+	OpBase *root
+) {
+	if(OpBase_IsWriter(root)) return true;
+
+	for(int i = 0; i < root->childCount; i++) {
+		if(_containsWriter(root->children[i])) return true;
+	}
+
+	return false;
+}
+
+// spilled nodes and edges are re-fetched from the graph once merged
+// as such spilling is restricted to full sorts within read-only plans
+static bool _spillAllowed
+(
+	const OpSort *op
+) {
+	if(op->limit != UNLIMITED) return false;
+
+	OpBase *root = (OpBase *)op;
+	while(root->parent != NULL) root = root->parent;
+
+	return !_containsWriter(root);
+}
+
+// returns the next record of run, NULL if run is depleted
+static Record _runNext
 (
 	OpSort *op,
-	Record r
+	SortRun *run
 ) {
-	if(op->limit == UNLIMITED) {
-		// not using a heap and there's room for record
-		array_append(op->buffer, r);
-		return;
+	if(run->spilled) return RecordSpill_Read(&run->reader, op->owner);
+
+	if(op->record_idx < array_len(op->buffer)) {
+		return op->buffer[op->record_idx++];
+	}
+	return NULL;
+}
+
+// start merging spilled runs
+// merges the runs of a single level, or when 'level' is SORT_FINAL_MERGE
+// the runs of all levels along with the remaining sorted buffer
+static void _mergeInit
+(
+	OpSort *op,
+	uint level
+) {
+	ASSERT(op->merge == NULL);
+
+	bool final = (level == SORT_FINAL_MERGE);
+	uint first = final ? 0 : level;
+	uint last  = final ? array_len(op->spills) : level + 1;
+
+	uint spilled = 0;
+	for(uint l = first; l < last; l++) {
+		spilled += RecordSpill_RunCount(op->spills[l]);
+	}
+	bool buffered = final && op->record_idx < array_len(op->buffer);
+
+	op->run_count = spilled + buffered;
+	op->runs      = rm_calloc(op->run_count, sizeof(SortRun));
+	op->merge     = Heap_new((heap_cmp)_run_cmp, op);
+
+	uint i = 0;
+	for(uint l = first; l < last; l++) {
+		uint n = RecordSpill_RunCount(op->spills[l]);
+		for(uint j = 0; j < n; j++, i++) {
+			SortRun *run = op->runs + i;
+			run->spilled = true;
+			RecordSpill_OpenRun(op->spills[l], j, &run->reader);
+		}
+	}
+
+	for(i = 0; i < op->run_count; i++) {
+		SortRun *run = op->runs + i;
+		run->head = _runNext(op, run);
+		if(run->head != NULL) Heap_offer(&op->merge, run);
+	}
+}
+
+// returns the smallest record across all merged runs
+static Record _mergeNext
+(
+	OpSort *op
+) {
+	if(Heap_count(op->merge) == 0) return NULL;
+
+	SortRun *run = Heap_poll(op->merge);
+	Record r = run->head;
+
+	run->head = _runNext(op, run);
+	if(run->head != NULL) Heap_offer(&op->merge, run);
+
+	return r;
+}
+
+static void _mergeFree
+(
+	OpSort *op
+) {
+	for(uint i = 0; i < op->run_count; i++) {
+		SortRun *run = op->runs + i;
+		if(run->head != NULL) OpBase_DeleteRecord(run->head);
+		if(run->spilled) RecordSpill_CloseRun(&run->reader);
+	}
+
+	rm_free(op->runs);
+	Heap_free(op->merge);
+
+	op->runs      = NULL;
+	op->merge     = NULL;
+	op->run_count = 0;
+}
+
+// merge the runs of 'level' into a single run of the next level
+// merged runs are discarded, as such each level holds fewer than
+// SORT_MERGE_FAN_IN runs and each record is rewritten once per level
+static void _mergeLevel
+(
+	OpSort *op,
+	uint level
+) {
+	ASSERT(array_len(op->buffer) == 0);
+
+	if(level + 1 == array_len(op->spills)) {
+		RecordSpill *spill = RecordSpill_New();
+		if(spill == NULL) ErrorCtx_RaiseRuntimeException(EMSG_SPILL_WRITE);
+		array_append(op->spills, spill);
+	}
+
+	RecordSpill *dst = op->spills[level + 1];
+	_mergeInit(op, level);
+
+	Record r;
+	RecordSpill_BeginRun(dst);
+	while((r = _mergeNext(op)) != NULL) {
+		bool written = RecordSpill_Write(dst, r);
+		OpBase_DeleteRecord(r);
+		if(!written) ErrorCtx_RaiseRuntimeException(EMSG_SPILL_WRITE);
+	}
+	if(!RecordSpill_EndRun(dst)) {
+		ErrorCtx_RaiseRuntimeException(EMSG_SPILL_WRITE);
+	}
+
+	_mergeFree(op);
+
+	if(!RecordSpill_Clear(op->spills[level])) {
+		ErrorCtx_RaiseRuntimeException(EMSG_SPILL_WRITE);
+	}
+
+	if(RecordSpill_RunCount(dst) >= SORT_MERGE_FAN_IN) {
+		_mergeLevel(op, level + 1);
+	}
+}
+
+static void _freeSpills
+(
+	OpSort *op
+) {
+	if(op->spills == NULL) return;
+
+	uint n = array_len(op->spills);
+	for(uint i = 0; i < n; i++) RecordSpill_Free(op->spills[i]);
+	array_free(op->spills);
+	op->spills = NULL;
+}
+
+// sort buffered records and write them to disk as a new run
+static void _spillBuffer
+(
+	OpSort *op
+) {
+	uint n = array_len(op->buffer);
+
+	// records which can't be encoded are kept in memory from here on
+	for(uint i = 0; i < n; i++) {
+		if(!RecordSpill_Encodable(op->buffer[i])) {
+			op->spillable = false;
+			return;
+		}
+	}
+
+	if(op->spills == NULL) {
+		RecordSpill *spill = RecordSpill_New();
+		if(spill == NULL) {
+			op->spillable = false;
+			return;
+		}
+		op->spills = array_new(RecordSpill *, 1);
+		array_append(op->spills, spill);
+		op->owner = op->buffer[0]->owner;
+	}
+
+	RecordSpill *spill = op->spills[0];
+
+	sort_r(op->buffer, n, sizeof(Record), (heap_cmp)_buffer_elem_cmp, op);
+
+	RecordSpill_BeginRun(spill);
+	for(uint i = 0; i < n; i++) {
+		ASSERT(op->buffer[i]->owner == op->owner);
+		if(!RecordSpill_Write(spill, op->buffer[i])) {
+			ErrorCtx_RaiseRuntimeException(EMSG_SPILL_WRITE);
+		}
+	}
+	if(!RecordSpill_EndRun(spill)) {
+		ErrorCtx_RaiseRuntimeException(EMSG_SPILL_WRITE);
+	}
+
+	for(uint i = 0; i < n; i++) OpBase_DeleteRecord(op->buffer[i]);
+	array_clear(op->buffer);
+	op->spilled_runs++;
+
+	// bound the number of runs merged at once
+	if(RecordSpill_RunCount(spill) >= SORT_MERGE_FAN_IN) _mergeLevel(op, 0);
+}
+
+// returns true if buffered records should be spilled
+static bool _shouldSpill
+(
+	OpSort *op
+) {
+	// runs are only capped once memory pressure triggered a spill
+	uint n = array_len(op->buffer);
+	if(n >= op->run_cap) return true;
+
+	if(n < SORT_RUN_MIN_RECORDS || n % SORT_PRESSURE_INTERVAL != 0) {
+		return false;
 	}
 
-	if(Heap_count(op->heap) < op->limit) {
+	if(!rm_mem_pressure(SORT_MEM_PRESSURE)) return false;
+
+	// spilled records are recycled by the record pool
+	// cap subsequent runs to the size of this one
+	op->run_cap = n;
+	return true;
+}
+
+// keeps the top 'cap' records offered to the heap
+static void _offer
+(
+	OpSort *op,
+	Record r,
+	uint cap
+) {
+	if(Heap_count(op->heap) < cap) {
 		Heap_offer(&op->heap, r);
 	} else {
 		// no room in the heap, see if we need to replace
@@ -77,7 +343,112 @@ static void _accumulate
 	}
 }
 
+static void _accumulate
+(
+	OpSort *op,
+	Record r
+) {
+	if(op->limit == UNLIMITED) {
+		// not using a heap, spill buffered records under memory pressure
+		array_append(op->buffer, r);
+		if(op->spillable && _shouldSpill(op)) _spillBuffer(op);
+		return;
+	}
+
+	_offer(op, r, op->limit);
+}
+
+// moves heap records into buffer, smallest record first
+static void _drainHeap
+(
+	OpSort *op
+) {
+	uint records_count = Heap_count(op->heap);
+	op->buffer = array_ensure_len(op->buffer, records_count);
+	for(int i = records_count-1; i >= 0 ; i--) {
+		op->buffer[i] = Heap_poll(op->heap);
+	}
+}
+
+// returns true if 'a' and 'b' share their position within an index
+// numbers are indexed as doubles
+static inline bool _indexTied
+(
+	SIValue a,
+	SIValue b
+) {
+	if((SI_TYPE(a) & SI_NUMERIC) && (SI_TYPE(b) & SI_NUMERIC)) {
+		return SI_GET_NUMERIC(a) == SI_GET_NUMERIC(b);
+	}
+
+	return SIValue_Compare(a, b, NULL) == 0;
+}
+
+// sorts the next group of records arriving in index order
+// only the top records of the group within the limit are kept
+// returns false once input is depleted
+static bool _nextGroup
+(
+	OpSort *op
+) {
+	ASSERT(array_len(op->buffer) == op->record_idx);
+
+	array_clear(op->buffer);
+	op->record_idx = 0;
+
+	if(op->pending == NULL) return false;
+
+	OpBase  *child  = op->op.children[0];
+	uint    offset  = op->record_offsets[0];
+	uint    cap     = op->limit - op->emitted;
+	SIValue head    = SI_CloneValue(Record_Get(op->pending, offset));
+
+	// records sorted by a single key are interchangeable within a group
+	// unless the group holds integers the index doesn't represent exactly
+	bool tied = array_len(op->record_offsets) == 1 &&
+		!((SI_TYPE(head) & SI_NUMERIC) &&
+		  fabs(SI_GET_NUMERIC(head)) >= INDEX_EXACT_NUMERIC_MAX);
+
+	Record r = op->pending;
+	op->pending = NULL;
+
+	while(r != NULL) {
+		_offer(op, r, cap);
+
+		if(tied && Heap_count(op->heap) == cap) break;
+
+		r = OpBase_Consume(child);
+		if(r != NULL && !_indexTied(head, Record_Get(r, offset))) {
+			op->pending = r;
+			break;
+		}
+	}
+
+	SIValue_Free(head);
+	_drainHeap(op);
+
+	return true;
+}
+
+// hands off records arriving in index order, group by group
+static Record _streamNext
+(
+	OpSort *op
+) {
+	// stop pulling records once limit is reached
+	if(op->emitted == op->limit) return NULL;
+
+	if(op->record_idx == array_len(op->buffer) && !_nextGroup(op)) {
+		return NULL;
+	}
+
+	op->emitted++;
+	return op->buffer[op->record_idx++];
+}
+
 static inline Record _handoff(OpSort *op) {
+	if(op->merge != NULL) return _mergeNext(op);
+
 	if(op->record_idx < array_len(op->buffer)) {
 		return op->buffer[op->record_idx++];
 	}
@@ -101,14 +472,37 @@ OpBase *NewSortOp
 	op->record_idx     = 0;
 	op->directions     = directions;
 	op->record_offsets = NULL;
+	op->spillable      = false;
+	op->run_cap        = UINT_MAX;
+	op->spilled_runs   = 0;
+	op->spills         = NULL;
+	op->owner          = NULL;
+	op->runs           = NULL;
+	op->run_count      = 0;
+	op->merge          = NULL;
+	op->scan           = NULL;
+	op->streaming      = false;
+	op->pending        = NULL;
+	op->emitted        = 0;
 
 	// set our Op operations
 	OpBase_Init((OpBase *)op, OPType_SORT, "Sort", SortInit, SortConsume,
-			SortReset, NULL, SortClone, SortFree, false, plan);
+			SortReset, SortToString, SortClone, SortFree, false, plan);
 
 	return (OpBase *)op;
 }
 
+void SortOp_SetOrderedInput
+(
+	OpSort *op,
+	IndexScan *scan
+) {
+	ASSERT(op   != NULL);
+	ASSERT(scan != NULL);
+
+	op->scan = scan;
+}
+
 static OpResult SortInit(OpBase *opBase) {
 	OpSort *op = (OpSort *)opBase;
 	// if there is LIMIT value, l, set in the current clause,
@@ -122,7 +516,9 @@ static OpResult SortInit(OpBase *opBase) {
 		op->heap = Heap_new((heap_cmp)_record_cmp, op);
 	} else {
 		// if all records are being sorted, use quicksort
+		// spilling sorted runs to disk under memory pressure
 		op->buffer = array_new(Record, 32);
+		op->spillable = _spillAllowed(op);
 	}
 
 	uint comparison_count = array_len(op->exps);
@@ -142,32 +538,40 @@ static Record SortConsume(OpBase *opBase) {
 	OpSort *op = (OpSort *)opBase;
 
 	if(!op->first) {
-		return _handoff(op);
+		return op->streaming ? _streamNext(op) : _handoff(op);
 	}
 	// make sure consume will not be called on children again, as their depleted
 	op->first = false;
 
-	Record r;
 	// if we're here, we don't have any records to return
 	// try to get records
 	OpBase *child = op->op.children[0];
-	bool newData = false;
-	while((r = OpBase_Consume(child))) {
-		_accumulate(op, r);
-		newData = true;
+	Record r = OpBase_Consume(child);
+	if(r == NULL) return NULL;
+
+	// scan decided on its first node whether it emits nodes in order
+	if(op->scan != NULL && IndexScanOp_Ordered(op->scan)) {
+		ASSERT(op->limit != UNLIMITED);
+		op->streaming = true;
+		op->pending   = r;
+		op->buffer    = array_new(Record, 32);
+		return _streamNext(op);
 	}
-	if(!newData) return NULL;
+
+	do {
+		_accumulate(op, r);
+	} while((r = OpBase_Consume(child)));
 
 	if(op->buffer) {
 		sort_r(op->buffer, array_len(op->buffer), sizeof(Record),
 				(heap_cmp)_buffer_elem_cmp, op);
+
+		// merge spilled runs with the remaining buffered records
+		if(op->spills != NULL) _mergeInit(op, SORT_FINAL_MERGE);
 	} else {
 		// heap
-		int records_count = Heap_count(op->heap);
-		op->buffer = array_newlen(Record, records_count);
-		for(int i = records_count-1; i >= 0 ; i--) {
-			op->buffer[i] = Heap_poll(op->heap);
-		}
+		op->buffer = array_new(Record, Heap_count(op->heap));
+		_drainHeap(op);
 	}
 
 	// pass ordered records downward
@@ -179,6 +583,9 @@ static OpResult SortReset(OpBase *ctx) {
 	OpSort *op = (OpSort *)ctx;
 	uint recordCount;
 
+	if(op->merge) _mergeFree(op);
+	_freeSpills(op);
+
 	if(op->heap) {
 		recordCount = Heap_count(op->heap);
 		for(uint i = 0; i < recordCount; i++) {
@@ -196,11 +603,40 @@ static OpResult SortReset(OpBase *ctx) {
 		array_clear(op->buffer);
 	}
 
+	if(op->pending) {
+		OpBase_DeleteRecord(op->pending);
+		op->pending = NULL;
+	}
+
+	op->emitted    = 0;
 	op->record_idx = 0;
+	op->run_cap    = UINT_MAX;
+	op->owner      = NULL;
+	op->spillable  = _spillAllowed(op);
 
 	return OP_OK;
 }
 
+static void SortToString
+(
+	const OpBase *ctx,
+	sds *buff
+) {
+	const OpSort *op = (const OpSort *)ctx;
+
+	*buff = sdscatprintf(*buff, "%s", op->op.name);
+
+	// report spilled runs when profiled
+	if(op->op.stats != NULL && op->spilled_runs > 0) {
+		*buff = sdscatprintf(*buff, " | Spilled runs: %u", op->spilled_runs);
+	}
+
+	// report sorting records as they arrive in index order when profiled
+	if(op->op.stats != NULL && op->streaming) {
+		*buff = sdscatprintf(*buff, " | Index order");
+	}
+}
+
 static OpBase *SortClone(const ExecutionPlan *plan, const OpBase *opBase) {
 	ASSERT(opBase->type == OPType_SORT);
 	OpSort *op = (OpSort *)opBase;
@@ -215,6 +651,9 @@ static OpBase *SortClone(const ExecutionPlan *plan, const OpBase *opBase) {
 static void SortFree(OpBase *ctx) {
 	OpSort *op = (OpSort *)ctx;
 
+	if(op->merge) _mergeFree(op);
+	_freeSpills(op);
+
 	if(op->heap) {
 		uint recordCount = Heap_count(op->heap);
 		for(uint i = 0; i < recordCount; i++) {
@@ -235,6 +674,11 @@ static void SortFree(OpBase *ctx) {
 		op->buffer = NULL;
 	}
 
+	if(op->pending) {
+		OpBase_DeleteRecord(op->pending);
+		op->pending = NULL;
+	}
+
 	if(op->record_offsets) {
 		array_free(op->record_offsets);
 		op->record_offsets = NULL;
@@ -9,8 +9,17 @@
 #include "op.h"
 #include "../../util/heap.h"
 #include "../execution_plan.h"
+#include "shared/record_spill.h"
+#include "op_node_by_index_scan.h"
 #include "../../arithmetic/arithmetic_expression.h"
 
+// sorted run of records merged by sort
+typedef struct {
+	Record head;            // next record of the run
+	bool spilled;           // run is read from disk, otherwise from buffer
+	SpillRunReader reader;  // spilled run reader
+} SortRun;
+
 typedef struct {
 	OpBase op;
 	Record *buffer;        // Holds all records.
@@ -22,7 +31,30 @@ typedef struct {
 	uint *record_offsets;  // All Record offsets containing values to sort by
 	int *directions;       // Array of sort directions(ascending / descending)
 	AR_ExpNode **exps;     // Projected expressons.
+	bool spillable;        // buffered records may be spilled to disk
+	uint run_cap;          // max records buffered before spilling, capped under pressure
+	uint spilled_runs;     // number of runs spilled from buffer
+	RecordSpill **spills;  // [optional] sorted runs spilled to disk, per merge level
+	ExecutionPlan *owner;  // owner of spilled records
+	SortRun *runs;         // runs being merged
+	uint run_count;        // number of runs being merged
+	heap_t *merge;         // runs being merged, ordered by their head record
+	IndexScan *scan;       // [optional] scan emitting records in sort order
+	bool streaming;        // records are sorted group by group as they arrive
+	Record pending;        // first record of the next group
+	uint emitted;          // number of records handed off while streaming
 } OpSort;
 
 /* Creates a new Sort operation */
 OpBase *NewSortOp(const ExecutionPlan *plan, AR_ExpNode **exps, int *directions);
+
+// lets sort know its input might arrive ordered by its first sort key
+// see orderIndexScans
+// if at runtime the scan emits its nodes in index order, records are
+// sorted group by group, a group being a run of records sharing their first
+// sort key, and sort stops pulling records once its limit is reached
+void SortOp_SetOrderedInput
+(
+	OpSort *op,      // sort
+	IndexScan *scan  // scan emitting records ordered by the first sort key
+);
@@ -7,90 +7,81 @@
 #include "op_value_hash_join.h"
 #include "../../value.h"
 #include "../../util/arr.h"
-#include "../../util/qsort.h"
 #include "../../util/rmalloc.h"
 
+#include <inttypes.h>
+
 // forward declarations
 static Record ValueHashJoinConsume(OpBase *opBase);
 static OpResult ValueHashJoinReset(OpBase *opBase);
 static OpBase *ValueHashJoinClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void ValueHashJoinFree(OpBase *opBase);
 
-// Determins order between two records by inspecting
-// element stored at postion idx
-static inline int _record_cmp
+// marks the end of a chain of cached records
+#define CHAIN_END UINT32_MAX
+
+// number of bloom filter bits per cached record
+#define BLOOM_BITS_PER_RECORD 8
+
+// returns the smallest power of two >= n
+static uint64_t _next_pow2
 (
-	Record *l,
-	Record *r,
-	uint *_idx
+	uint64_t n
 ) {
-	uint    idx = *_idx;
-	SIValue lv  = Record_Get(*l, idx);
-	SIValue rv  = Record_Get(*r, idx);
-	return SIValue_Compare(lv, rv, NULL);
+	uint64_t p = 1;
+	while(p < n) p <<= 1;
+	return p;
 }
 
-// performs binary search, returns the leftmost index of a match
-static bool _binarySearchLeftmost
+// bloom filter bit positions of hash h
+// derived from the hash's high bits, buckets are addressed by its low bits
+static inline void _bloom_bits
 (
-	uint *idx,
-	Record *array,
-	uint array_len,
-	int join_key_idx,
-	SIValue v
+	const OpValueHashJoin *op,
+	uint64_t h,
+	uint64_t *b1,
+	uint64_t *b2
 ) {
-	ASSERT(idx != NULL);
-
-	SIValue x;
-	uint pos = 0;
-	uint left = 0;
-	uint right = array_len;
-
-	while(left < right) {
-		pos = (right + left) / 2;
-		x = Record_Get(array[pos], join_key_idx);
-		if(SIValue_Compare(x, v, NULL) < 0) left = pos + 1;
-		else right = pos;
-	}
-
-	// make sure value was found
-	*idx = left;
+	*b1 = (h >> 32) & op->bloom_mask;
+	*b2 = ((h * 0x9E3779B97F4A7C15ULL) >> 32) & op->bloom_mask;
+}
 
-	if(left == array_len) return false;
+static inline bool _bloom_contains
+(
+	const OpValueHashJoin *op,
+	uint64_t h
+) {
+	uint64_t b1;
+	uint64_t b2;
+	_bloom_bits(op, h, &b1, &b2);
+	return (op->bloom[b1 >> 6] & (1ULL << (b1 & 63))) &&
+		   (op->bloom[b2 >> 6] & (1ULL << (b2 & 63)));
+}
 
-	x = Record_Get(array[*idx], join_key_idx);
-	// return false if the value wasn't found or evaluated to NULL
-	int disjointOrNull = 0;
-	return (SIValue_Compare(x, v, &disjointOrNull) == 0 &&
-			disjointOrNull != COMPARED_NULL);
+static inline void _bloom_add
+(
+	OpValueHashJoin *op,
+	uint64_t h
+) {
+	uint64_t b1;
+	uint64_t b2;
+	_bloom_bits(op, h, &b1, &b2);
+	op->bloom[b1 >> 6] |= (1ULL << (b1 & 63));
+	op->bloom[b2 >> 6] |= (1ULL << (b2 & 63));
 }
 
-// performs binary search, returns the rightmost index of a match
-// assuming 'v' exists in 'array'
-static bool _binarySearchRightmost
+// locate the bucket holding hash h, or the empty bucket it should occupy
+static inline uint64_t _locate_bucket
 (
-	uint *idx,
-	Record *array,
-	uint array_len,
-	int join_key_idx,
-	SIValue v
+	const OpValueHashJoin *op,
+	uint64_t h
 ) {
-	ASSERT(idx != NULL);
-
-	SIValue x;
-	uint pos = 0;
-	uint left = 0;
-	uint right = array_len;
-
-	while(left < right) {
-		pos = (right + left) / 2;
-		x = Record_Get(array[pos], join_key_idx);
-		if(SIValue_Compare(v, x, NULL) < 0) right = pos;
-		else left = pos + 1;
+	uint64_t pos = h & op->bucket_mask;
+	while(op->buckets[pos] != 0) {
+		if(op->hashes[op->buckets[pos] - 1] == h) break;
+		pos = (pos + 1) & op->bucket_mask;
 	}
-
-	*idx = right - 1;
-	return true;
+	return pos;
 }
 
 // retrive the next intersecting record
@@ -99,74 +90,88 @@ static Record _get_intersecting_record
 (
 	OpValueHashJoin *op
 ) {
-	// no more intersecting records
-	if(op->intersect_idx == -1 ||
-	   op->number_of_intersections == 0) return NULL;
-
-	Record cr = op->cached_records[op->intersect_idx];
-
-	// update intersection trackers
-	op->intersect_idx++;
-	op->number_of_intersections--;
+	// records chained together share the same hash
+	// compare values to rule out hash collisions
+	while(op->intersect_idx != CHAIN_END) {
+		uint32_t idx = op->intersect_idx;
+		op->intersect_idx = op->chain[idx];
+
+		Record cr = op->cached_records[idx];
+		SIValue x = Record_Get(cr, op->join_value_rec_idx);
+
+		// skip values which differ or evaluated to NULL
+		int disjointOrNull = 0;
+		if(SIValue_Compare(x, op->rhs_value, &disjointOrNull) == 0 &&
+		   disjointOrNull != COMPARED_NULL) {
+			return cr;
+		}
+	}
 
-	return cr;
+	return NULL;
 }
 
-// look up first intersecting cached record CR position
+// look up first intersecting cached record CR candidate
 // returns false if no intersecting record is found
 static bool _set_intersection_idx
 (
 	OpValueHashJoin *op,
 	SIValue v
 ) {
-	op->intersect_idx = -1;
-	op->number_of_intersections = 0;
-	uint record_count = array_len(op->cached_records);
+	op->intersect_idx = CHAIN_END;
+
+	// NULL doesn't intersect with any value
+	if(SIValue_IsNull(v)) return false;
 
-	uint leftmost_idx  = 0;
-	uint rightmost_idx = 0;
+	op->probe_count++;
 
-	if(!_binarySearchLeftmost(&leftmost_idx, op->cached_records,
-				array_len(op->cached_records), op->join_value_rec_idx, v)) {
+	uint64_t h = SIValue_HashCode(v);
+
+	// quickly rule out values missing from cache
+	if(!_bloom_contains(op, h)) {
+		op->bloom_reject_count++;
 		return false;
 	}
 
-	// value was found
-	// idx points to the first intersecting record
-	// update number_of_intersections to count how many
-	// records share the same value
-	op->intersect_idx = leftmost_idx;
-
-	// count how many records share the same node
-	// reduce search space by truncating left bound
-	bool found = _binarySearchRightmost(&rightmost_idx,
-			op->cached_records + leftmost_idx, record_count - leftmost_idx,
-			op->join_value_rec_idx, v);
-	UNUSED(found);
-	ASSERT(found == true);
-
-	// compensate index
-	rightmost_idx += leftmost_idx;
-	// +1 consider rightmost_idx == leftmost_idx
-	op->number_of_intersections = rightmost_idx - leftmost_idx + 1;
-	ASSERT(op->number_of_intersections > 0);
+	uint64_t pos = _locate_bucket(op, h);
+	if(op->buckets[pos] == 0) return false;
 
+	op->intersect_idx = op->buckets[pos] - 1;
 	return true;
 }
 
-// sorts cached records by joined value
-void _sort_cached_records
+// builds an open addressing hash table over the cached records
+// records sharing the same joined value hash are chained together
+// in their caching order
+void _build_hash_table
 (
 	OpValueHashJoin *op
 ) {
-	uint idx = op->join_value_rec_idx;
-	sort_r(
-			op->cached_records,
-			array_len(op->cached_records),
-			sizeof(Record),
-			(int(*)(const void*, const void*, void*))_record_cmp,
-			&idx
-		);
+	uint record_count = array_len(op->cached_records);
+	ASSERT(record_count < CHAIN_END);
+
+	// keep load factor at or below 0.5
+	uint64_t bucket_count = _next_pow2(record_count * 2 + 1);
+	op->bucket_mask = bucket_count - 1;
+	op->buckets     = rm_calloc(bucket_count, sizeof(uint32_t));
+	op->chain       = rm_malloc(sizeof(uint32_t) * (record_count + 1));
+
+	uint64_t bloom_bits = _next_pow2(record_count * BLOOM_BITS_PER_RECORD);
+	if(bloom_bits < 64) bloom_bits = 64;
+	op->bloom_mask = bloom_bits - 1;
+	op->bloom      = rm_calloc(bloom_bits / 64, sizeof(uint64_t));
+
+	// insert in reverse order, each record becomes the head of its chain
+	for(uint i = record_count; i > 0; i--) {
+		uint32_t idx = i - 1;
+		uint64_t h   = op->hashes[idx];
+		uint64_t pos = _locate_bucket(op, h);
+
+		op->chain[idx]    = (op->buckets[pos] == 0) ?
+			CHAIN_END : op->buckets[pos] - 1;
+		op->buckets[pos]  = idx + 1;
+
+		_bloom_add(op, h);
+	}
 }
 
 // caches all records coming from left branch
@@ -178,6 +183,7 @@ void _cache_records
 
 	OpBase *left_child = op->op.children[0];
 	op->cached_records = array_new(Record, 32);
+	op->hashes = array_new(uint64_t, 32);
 
 	Record r = left_child->consume(left_child);
 	if(!r) return;
@@ -189,16 +195,65 @@ void _cache_records
 
 		// if the joined value is NULL
 		// it cannot be compared to other values - skip this record
-		if(SIValue_IsNull(v)) continue;
+		if(SIValue_IsNull(v)) {
+			OpBase_DeleteRecord(r);
+			continue;
+		}
 
 		// add joined value to record
 		Record_AddScalar(r, op->join_value_rec_idx, v);
 
 		// cache the record
 		array_append(op->cached_records, r);
+		array_append(op->hashes, SIValue_HashCode(v));
 	} while((r = left_child->consume(left_child)));
 }
 
+// frees cached records and the hash table built over them
+static void _clear_cache
+(
+	OpValueHashJoin *op
+) {
+	op->intersect_idx = CHAIN_END;
+
+	if(op->rhs_rec) {
+		SIValue_Free(op->rhs_value);
+		op->rhs_value = SI_NullVal();
+		OpBase_DeleteRecord(op->rhs_rec);
+		op->rhs_rec = NULL;
+	}
+
+	if(op->cached_records) {
+		uint record_count = array_len(op->cached_records);
+		for(uint i = 0; i < record_count; i++) {
+			Record r = op->cached_records[i];
+			OpBase_DeleteRecord(r);
+		}
+		array_free(op->cached_records);
+		op->cached_records = NULL;
+	}
+
+	if(op->hashes) {
+		array_free(op->hashes);
+		op->hashes = NULL;
+	}
+
+	if(op->chain) {
+		rm_free(op->chain);
+		op->chain = NULL;
+	}
+
+	if(op->buckets) {
+		rm_free(op->buckets);
+		op->buckets = NULL;
+	}
+
+	if(op->bloom) {
+		rm_free(op->bloom);
+		op->bloom = NULL;
+	}
+}
+
 // string representation of operation
 static void ValueHashJoinToString
 (
@@ -225,6 +280,14 @@ static void ValueHashJoinToString
 	AR_EXP_ToString(op->rhs_exp, &exp_str);
 	*buff = sdscatprintf(*buff, "%s", exp_str);
 	rm_free(exp_str);
+
+	// report build and probe statistics when profiled
+	if(op->op.stats != NULL && op->cached_records != NULL) {
+		*buff = sdscatprintf(*buff,
+				" | Build records: %u | Probes: %" PRIu64 " | Bloom rejected: %" PRIu64,
+				array_len(op->cached_records), op->probe_count,
+				op->bloom_reject_count);
+	}
 }
 
 // creates a new valueHashJoin operation
@@ -234,14 +297,13 @@ OpBase *NewValueHashJoin
 	AR_ExpNode *lhs_exp,
 	AR_ExpNode *rhs_exp
 ) {
-	OpValueHashJoin *op = rm_malloc(sizeof(OpValueHashJoin));
+	OpValueHashJoin *op = rm_calloc(1, sizeof(OpValueHashJoin));
 
-	op->rhs_rec                 = NULL;
-	op->lhs_exp                 = lhs_exp;
-	op->rhs_exp                 = rhs_exp;
-	op->intersect_idx           = -1;
-	op->cached_records          = NULL;
-	op->number_of_intersections = 0;
+	op->rhs_rec       = NULL;
+	op->rhs_value     = SI_NullVal();
+	op->lhs_exp       = lhs_exp;
+	op->rhs_exp       = rhs_exp;
+	op->intersect_idx = CHAIN_END;
 
 	// set our Op operations
 	OpBase_Init((OpBase *)op, OPType_VALUE_HASH_JOIN, "Value Hash Join",
@@ -266,8 +328,8 @@ static Record ValueHashJoinConsume
 	// eager, pull from left branch until depleted
 	if(op->cached_records == NULL) {
 		_cache_records(op);
-		// sort cache on intersect node ID
-		_sort_cached_records(op);
+		// hash cache on joined value
+		_build_hash_table(op);
 	}
 
 	// try to produce a record:
@@ -279,47 +341,33 @@ static Record ValueHashJoinConsume
 	// return merged record:
 	// X merged with R
 
-	Record l;
-	if(op->number_of_intersections > 0) {
-		while((l = _get_intersecting_record(op))) {
+	while(true) {
+		Record l = _get_intersecting_record(op);
+		if(l != NULL) {
 			// clone cached record before merging rhs
 			Record c = OpBase_CloneRecord(l);
 			Record_Merge(c, op->rhs_rec);
 			return c;
 		}
-	}
 
-	// if we're here there are no more
-	// left hand side records which intersect with R
-	// discard R
-	if(op->rhs_rec) OpBase_DeleteRecord(op->rhs_rec);
+		// if we're here there are no more
+		// left hand side records which intersect with R
+		// discard R
+		if(op->rhs_rec) {
+			SIValue_Free(op->rhs_value);
+			op->rhs_value = SI_NullVal();
+			OpBase_DeleteRecord(op->rhs_rec);
+			op->rhs_rec = NULL;
+		}
 
-	// try to get new right hand side record
-	// which intersect with a left hand side record
-	while(true) {
-		// pull from right branch
+		// try to get new right hand side record
+		// which intersect with a left hand side record
 		op->rhs_rec = right_child->consume(right_child);
 		if(!op->rhs_rec) return NULL;
 
 		// get value on which we're intersecting
-		SIValue v = AR_EXP_Evaluate(op->rhs_exp, op->rhs_rec);
-
-		bool found_intersection = _set_intersection_idx(op, v);
-		SIValue_Free(v);
-		// no intersection, discard R
-		if(!found_intersection) {
-			OpBase_DeleteRecord(op->rhs_rec);
-			continue;
-		}
-
-		// found atleast one intersecting record
-		l = _get_intersecting_record(op);
-
-		// clone cached record before merging rhs
-		Record c = OpBase_CloneRecord(l);
-		Record_Merge(c, op->rhs_rec);
-
-		return c;
+		op->rhs_value = AR_EXP_Evaluate(op->rhs_exp, op->rhs_rec);
+		_set_intersection_idx(op, op->rhs_value);
 	}
 }
 
@@ -328,24 +376,9 @@ static OpResult ValueHashJoinReset
 	OpBase *ctx
 ) {
 	OpValueHashJoin *op = (OpValueHashJoin *)ctx;
-	op->intersect_idx = -1;
-	op->number_of_intersections = 0;
 
 	// clear cached records
-	if(op->rhs_rec) {
-		OpBase_DeleteRecord(op->rhs_rec);
-		op->rhs_rec = NULL;
-	}
-
-	if(op->cached_records) {
-		uint record_count = array_len(op->cached_records);
-		for(uint i = 0; i < record_count; i++) {
-			Record r = op->cached_records[i];
-			OpBase_DeleteRecord(r);
-		}
-		array_free(op->cached_records);
-		op->cached_records = NULL;
-	}
+	_clear_cache(op);
 
 	return OP_OK;
 }
@@ -365,20 +398,7 @@ static inline OpBase *ValueHashJoinClone
 static void ValueHashJoinFree(OpBase *ctx) {
 	OpValueHashJoin *op = (OpValueHashJoin *)ctx;
 	// free cached records
-	if(op->rhs_rec) {
-		OpBase_DeleteRecord(op->rhs_rec);
-		op->rhs_rec = NULL;
-	}
-
-	if(op->cached_records) {
-		uint record_count = array_len(op->cached_records);
-		for(uint i = 0; i < record_count; i++) {
-			Record r = op->cached_records[i];
-			OpBase_DeleteRecord(r);
-		}
-		array_free(op->cached_records);
-		op->cached_records = NULL;
-	}
+	_clear_cache(op);
 
 	if(op->lhs_exp) {
 		AR_EXP_Free(op->lhs_exp);
@@ -390,4 +410,3 @@ static void ValueHashJoinFree(OpBase *ctx) {
 		op->rhs_exp = NULL;
 	}
 }
-
@@ -13,12 +13,20 @@
 typedef struct {
 	OpBase op;
 	Record rhs_rec;                     // Right hand side record.
+	SIValue rhs_value;                  // Right hand side joined value.
 	AR_ExpNode *lhs_exp;                // Left hand side expression to join on.
 	AR_ExpNode *rhs_exp;                // Right hand side expression to join on.
-	int64_t intersect_idx;              // Current intersection, < number_of_intersections
+	uint32_t intersect_idx;             // Next intersection candidate, cached record index.
 	Record *cached_records;             // Cached left hand side records.
+	uint64_t *hashes;                   // Joined value hash of each cached record.
+	uint32_t *chain;                    // Next cached record sharing the same hash.
+	uint32_t *buckets;                  // Open addressing hash table, cached record index + 1.
+	uint64_t bucket_mask;               // Number of buckets - 1.
+	uint64_t *bloom;                    // Bloom filter over joined value hashes.
+	uint64_t bloom_mask;                // Number of bloom filter bits - 1.
 	uint join_value_rec_idx;            // position on joined expression within record.
-	int64_t number_of_intersections;    // Number of intersections located.
+	uint64_t probe_count;               // Number of probes, reported by PROFILE.
+	uint64_t bloom_reject_count;        // Number of probes rejected by the bloom filter.
 } OpValueHashJoin;
 
 /* Creates a new ValueHashJoin operation */
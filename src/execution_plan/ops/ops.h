@@ -16,6 +16,7 @@
 #include "op_create.h"
 #include "op_delete.h"
 #include "op_filter.h"
+#include "op_gather.h"
 #include "op_update.h"
 #include "op_unwind.h"
 #include "op_results.h"
@@ -75,23 +75,32 @@ static void _CommitNodes
 
 		// introduce node into graph
 		CreateNode(gc, n, labels, label_count, attr, true);
+	}
 
-		//----------------------------------------------------------------------
-		// enforce constraints
-		//----------------------------------------------------------------------
-
-		if(constraint_violation == false) {
-			for(uint j = 0; j < label_count; j++) {
-				Schema *s = GraphContext_GetSchemaByID(gc, labels[j], SCHEMA_NODE);
-				char *err_msg = NULL;
-				if(!Schema_EnforceConstraints(s, (GraphEntity*)n, &err_msg)) {
-					// constraint violation
-					ASSERT(err_msg != NULL);
-					constraint_violation = true;
-					ErrorCtx_SetError("%s", err_msg);
-					free(err_msg);
-					break;
-				}
+	// index created nodes at once
+	// constraints are enforced against up to date indices
+	QueryCtx_FlushIndexBuffer();
+
+	//--------------------------------------------------------------------------
+	// enforce constraints
+	//--------------------------------------------------------------------------
+
+	for(int i = 0; i < node_count && !constraint_violation; i++) {
+		n = pending->created_nodes[i];
+
+		int* labels      = pending->node_labels[i];
+		uint label_count = array_len(labels);
+
+		for(uint j = 0; j < label_count; j++) {
+			Schema *s = GraphContext_GetSchemaByID(gc, labels[j], SCHEMA_NODE);
+			char *err_msg = NULL;
+			if(!Schema_EnforceConstraints(s, (GraphEntity*)n, &err_msg)) {
+				// constraint violation
+				ASSERT(err_msg != NULL);
+				constraint_violation = true;
+				ErrorCtx_SetError("%s", err_msg);
+				free(err_msg);
+				break;
 			}
 		}
 	}
@@ -144,32 +153,39 @@ static void _CommitEdges
 	// sync policy should be set to NOP, no need to sync/resize
 	ASSERT(Graph_GetMatrixPolicy(g) == SYNC_POLICY_NOP);
 
+	// resolve edges relationship-type
 	for(int i = 0; i < edge_count; i++) {
 		e = pending->created_edges[i];
-		NodeID src_id  = Edge_GetSrcNodeID(e);
-		NodeID dest_id = Edge_GetDestNodeID(e);
-		AttributeSet attr = pending->edge_attributes[i];
-
 		Schema *s = GraphContext_GetSchema(gc, e->relationship, SCHEMA_EDGE);
 		// all schemas have been created in the edge blueprint loop or earlier
 		ASSERT(s != NULL);
-		int relation_id = Schema_GetID(s);
+		e->relationID = Schema_GetID(s);
+	}
 
-		CreateEdge(gc, e, src_id, dest_id, relation_id, attr, true);
+	// create edges in bulk
+	// allowing relations to be populated at once
+	CreateEdges(gc, pending->created_edges, pending->edge_attributes,
+			edge_count, true);
 
-		//----------------------------------------------------------------------
-		// enforce constraints
-		//----------------------------------------------------------------------
+	// index created edges at once
+	// constraints are enforced against up to date indices
+	QueryCtx_FlushIndexBuffer();
 
-		if(constraint_violation == false) {
-			char *err_msg = NULL;
-			if(!Schema_EnforceConstraints(s, (GraphEntity*)e, &err_msg)) {
-				// constraint violated!
-				ASSERT(err_msg != NULL);
-				constraint_violation = true;
-				ErrorCtx_SetError("%s", err_msg);
-				free(err_msg);
-			}
+	//--------------------------------------------------------------------------
+	// enforce constraints
+	//--------------------------------------------------------------------------
+
+	for(int i = 0; i < edge_count && !constraint_violation; i++) {
+		e = pending->created_edges[i];
+		Schema *s = GraphContext_GetSchemaByID(gc, e->relationID, SCHEMA_EDGE);
+
+		char *err_msg = NULL;
+		if(!Schema_EnforceConstraints(s, (GraphEntity*)e, &err_msg)) {
+			// constraint violated!
+			ASSERT(err_msg != NULL);
+			constraint_violation = true;
+			ErrorCtx_SetError("%s", err_msg);
+			free(err_msg);
 		}
 	}
 }
@@ -0,0 +1,65 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// number of node IDs handed out by a single morsel
+#define MORSEL_SIZE 16384
+
+// MorselSource splits the node ID range [0, end) into fixed size morsels
+// scans sharing the same source claim morsels in turn
+// such that each ID is scanned exactly once across all of them
+typedef struct {
+	uint64_t next;  // first ID of the next unclaimed morsel
+	uint64_t end;   // end of the scanned range (exclusive)
+} MorselSource;
+
+// initialize morsel source to cover the ID range [0, end)
+static inline void MorselSource_Init
+(
+	MorselSource *src,  // morsel source
+	uint64_t end        // end of range
+) {
+	src->next = 0;
+	src->end  = end;
+}
+
+// returns the number of morsels in the source's range
+static inline uint64_t MorselSource_Count
+(
+	const MorselSource *src  // morsel source
+) {
+	return (src->end + MORSEL_SIZE - 1) / MORSEL_SIZE;
+}
+
+// claim the next morsel [*min, *max)
+// returns false if the source is depleted
+static inline bool MorselSource_Claim
+(
+	MorselSource *src,  // morsel source
+	uint64_t *min,      // [output] first ID of the morsel
+	uint64_t *max       // [output] end of the morsel (exclusive)
+) {
+	uint64_t start = __atomic_fetch_add(&src->next, MORSEL_SIZE,
+			__ATOMIC_RELAXED);
+
+	if(start >= src->end) return false;
+
+	*min = start;
+	*max = (start + MORSEL_SIZE < src->end) ? start + MORSEL_SIZE : src->end;
+	return true;
+}
+
+// deplete source, no further morsels will be handed out
+static inline void MorselSource_Deplete
+(
+	MorselSource *src  // morsel source
+) {
+	__atomic_store_n(&src->next, src->end, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,478 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "record_spill.h"
+#include "../../../util/arr.h"
+#include "../../../query_ctx.h"
+#include "../../../datatypes/map.h"
+#include "../../../errors/errors.h"
+#include "../../../util/rmalloc.h"
+#include "../../../datatypes/array.h"
+
+#include <unistd.h>
+
+// size of a run reader's buffer
+#define SPILL_READ_BUFFER_SIZE 16384
+
+//------------------------------------------------------------------------------
+// encoding
+//------------------------------------------------------------------------------
+
+// returns true if value can be spilled
+static bool _ValueEncodable
+(
+	SIValue v
+) {
+	switch(SI_TYPE(v)) {
+		case T_NULL:
+		case T_BOOL:
+		case T_INT64:
+		case T_DOUBLE:
+		case T_STRING:
+		case T_POINT:
+			return true;
+		case T_ARRAY: {
+			uint32_t n = SIArray_Length(v);
+			for(uint32_t i = 0; i < n; i++) {
+				if(!_ValueEncodable(SIArray_Get(v, i))) return false;
+			}
+			return true;
+		}
+		case T_MAP: {
+			uint n = Map_KeyCount(v);
+			for(uint i = 0; i < n; i++) {
+				SIValue key;
+				SIValue val;
+				Map_GetIdx(v, i, &key, &val);
+				if(!_ValueEncodable(val)) return false;
+			}
+			return true;
+		}
+		default:
+			// graph entities and paths embedded in scalars are not supported
+			return false;
+	}
+}
+
+bool RecordSpill_Encodable
+(
+	const Record r
+) {
+	ASSERT(r != NULL);
+
+	uint n = Record_length(r);
+	for(uint i = 0; i < n; i++) {
+		RecordEntryType t = Record_GetType(r, i);
+		if(t == REC_TYPE_HEADER) return false;
+		if(t == REC_TYPE_SCALAR && !_ValueEncodable(Record_Get(r, i))) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// write a string as its length followed by its bytes
+static inline bool _EncodeString
+(
+	FILE *f,
+	const char *s
+) {
+	uint32_t len = strlen(s);
+	return fwrite(&len, sizeof(len), 1, f) == 1 &&
+		fwrite(s, 1, len, f) == len;
+}
+
+// write value as its type followed by its payload
+static bool _EncodeValue
+(
+	FILE *f,
+	SIValue v
+) {
+	uint32_t t = SI_TYPE(v);
+	if(fwrite(&t, sizeof(t), 1, f) != 1) return false;
+
+	switch(t) {
+		case T_NULL:
+			return true;
+		case T_BOOL:
+		case T_INT64:
+			return fwrite(&v.longval, sizeof(v.longval), 1, f) == 1;
+		case T_DOUBLE:
+			return fwrite(&v.doubleval, sizeof(v.doubleval), 1, f) == 1;
+		case T_POINT:
+			return fwrite(&v.point, sizeof(v.point), 1, f) == 1;
+		case T_STRING:
+			return _EncodeString(f, v.stringval);
+		case T_ARRAY: {
+			uint32_t n = SIArray_Length(v);
+			if(fwrite(&n, sizeof(n), 1, f) != 1) return false;
+			for(uint32_t i = 0; i < n; i++) {
+				if(!_EncodeValue(f, SIArray_Get(v, i))) return false;
+			}
+			return true;
+		}
+		case T_MAP: {
+			uint32_t n = Map_KeyCount(v);
+			if(fwrite(&n, sizeof(n), 1, f) != 1) return false;
+			for(uint32_t i = 0; i < n; i++) {
+				SIValue key;
+				SIValue val;
+				Map_GetIdx(v, i, &key, &val);
+				if(!_EncodeString(f, key.stringval)) return false;
+				if(!_EncodeValue(f, val)) return false;
+			}
+			return true;
+		}
+		default:
+			ASSERT(false && "unexpected spilled value type");
+			return false;
+	}
+}
+
+// write record as its entry count followed by its typed entries
+// nodes are written as their ID
+// edges are written as their ID, relationship type, source and destination
+static bool _EncodeRecord
+(
+	FILE *f,
+	const Record r
+) {
+	uint32_t n = Record_length(r);
+	if(fwrite(&n, sizeof(n), 1, f) != 1) return false;
+
+	for(uint32_t i = 0; i < n; i++) {
+		uint8_t t = Record_GetType(r, i);
+		if(fwrite(&t, sizeof(t), 1, f) != 1) return false;
+
+		switch(t) {
+			case REC_TYPE_UNKNOWN:
+				break;
+			case REC_TYPE_NODE: {
+				Node *node = Record_GetNode(r, i);
+				if(fwrite(&node->id, sizeof(node->id), 1, f) != 1) return false;
+				break;
+			}
+			case REC_TYPE_EDGE: {
+				Edge *edge = Record_GetEdge(r, i);
+				EntityID ids[3] = {edge->id, Edge_GetSrcNodeID(edge),
+					Edge_GetDestNodeID(edge)};
+				int32_t rel = edge->relationID;
+				if(fwrite(ids, sizeof(EntityID), 3, f) != 3) return false;
+				if(fwrite(&rel, sizeof(rel), 1, f) != 1) return false;
+				break;
+			}
+			case REC_TYPE_SCALAR:
+				if(!_EncodeValue(f, Record_Get(r, i))) return false;
+				break;
+			default:
+				ASSERT(false && "unexpected spilled record entry type");
+				return false;
+		}
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------
+// decoding
+//------------------------------------------------------------------------------
+
+// copy the next n bytes of the run into dst, refilling the buffer as needed
+static void _Read
+(
+	SpillRunReader *reader,
+	void *dst,
+	size_t n
+) {
+	char *out = (char *)dst;
+	while(n > 0) {
+		if(reader->pos == reader->len) {
+			ssize_t len = pread(reader->fd, reader->buf, SPILL_READ_BUFFER_SIZE,
+					reader->offset);
+			if(len <= 0) {
+				ErrorCtx_RaiseRuntimeException(EMSG_SPILL_READ);
+			}
+			reader->offset += len;
+			reader->len     = len;
+			reader->pos     = 0;
+		}
+
+		size_t chunk = reader->len - reader->pos;
+		if(chunk > n) chunk = n;
+		memcpy(out, reader->buf + reader->pos, chunk);
+		reader->pos += chunk;
+		out         += chunk;
+		n           -= chunk;
+	}
+}
+
+static char *_DecodeString
+(
+	SpillRunReader *reader
+) {
+	uint32_t len;
+	_Read(reader, &len, sizeof(len));
+	char *s = rm_malloc(len + 1);
+	_Read(reader, s, len);
+	s[len] = '\0';
+	return s;
+}
+
+static SIValue _DecodeValue
+(
+	SpillRunReader *reader
+) {
+	uint32_t t;
+	_Read(reader, &t, sizeof(t));
+
+	switch(t) {
+		case T_NULL:
+			return SI_NullVal();
+		case T_BOOL: {
+			int64_t b;
+			_Read(reader, &b, sizeof(b));
+			return SI_BoolVal(b);
+		}
+		case T_INT64: {
+			int64_t l;
+			_Read(reader, &l, sizeof(l));
+			return SI_LongVal(l);
+		}
+		case T_DOUBLE: {
+			double d;
+			_Read(reader, &d, sizeof(d));
+			return SI_DoubleVal(d);
+		}
+		case T_POINT: {
+			Point p;
+			_Read(reader, &p, sizeof(p));
+			return SI_Point(p.latitude, p.longitude);
+		}
+		case T_STRING:
+			return SI_TransferStringVal(_DecodeString(reader));
+		case T_ARRAY: {
+			uint32_t n;
+			_Read(reader, &n, sizeof(n));
+			SIValue arr = SI_Array(n);
+			for(uint32_t i = 0; i < n; i++) {
+				SIValue elem = _DecodeValue(reader);
+				SIArray_Append(&arr, elem);
+				SIValue_Free(elem);
+			}
+			return arr;
+		}
+		case T_MAP: {
+			uint32_t n;
+			_Read(reader, &n, sizeof(n));
+			SIValue map = SI_Map(n);
+			for(uint32_t i = 0; i < n; i++) {
+				SIValue key = SI_TransferStringVal(_DecodeString(reader));
+				SIValue val = _DecodeValue(reader);
+				Map_Add(&map, key, val);
+				SIValue_Free(key);
+				SIValue_Free(val);
+			}
+			return map;
+		}
+		default:
+			ASSERT(false && "unexpected spilled value type");
+			return SI_NullVal();
+	}
+}
+
+static void _DecodeRecord
+(
+	SpillRunReader *reader,
+	Record r
+) {
+	Graph *g = QueryCtx_GetGraph();
+
+	uint32_t n;
+	_Read(reader, &n, sizeof(n));
+	ASSERT(n == Record_length(r));
+
+	for(uint32_t i = 0; i < n; i++) {
+		uint8_t t;
+		_Read(reader, &t, sizeof(t));
+
+		switch(t) {
+			case REC_TYPE_UNKNOWN:
+				break;
+			case REC_TYPE_NODE: {
+				Node node = GE_NEW_NODE();
+				EntityID id;
+				_Read(reader, &id, sizeof(id));
+				Graph_GetNode(g, id, &node);
+				Record_AddNode(r, i, node);
+				break;
+			}
+			case REC_TYPE_EDGE: {
+				EntityID ids[3];
+				int32_t rel;
+				_Read(reader, ids, sizeof(ids));
+				_Read(reader, &rel, sizeof(rel));
+				Edge edge = GE_NEW_LABELED_EDGE(NULL, rel);
+				Graph_GetEdge(g, ids[0], &edge);
+				Edge_SetSrcNodeID(&edge, ids[1]);
+				Edge_SetDestNodeID(&edge, ids[2]);
+				if(rel != GRAPH_NO_RELATION && rel != GRAPH_UNKNOWN_RELATION) {
+					Schema *s = GraphContext_GetSchemaByID(QueryCtx_GetGraphCtx(),
+							rel, SCHEMA_EDGE);
+					edge.relationship = Schema_GetName(s);
+				}
+				Record_AddEdge(r, i, edge);
+				break;
+			}
+			case REC_TYPE_SCALAR:
+				Record_AddScalar(r, i, _DecodeValue(reader));
+				break;
+			default:
+				ASSERT(false && "unexpected spilled record entry type");
+				break;
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+// record spill
+//------------------------------------------------------------------------------
+
+RecordSpill *RecordSpill_New(void) {
+	FILE *f = tmpfile();
+	if(f == NULL) return NULL;
+
+	RecordSpill *spill = rm_malloc(sizeof(RecordSpill));
+
+	spill->file = f;
+	spill->size = 0;
+	spill->runs = array_new(SpillRun, 1);
+
+	return spill;
+}
+
+void RecordSpill_BeginRun
+(
+	RecordSpill *spill
+) {
+	ASSERT(spill != NULL);
+
+	SpillRun run = {.offset = spill->size, .count = 0};
+	array_append(spill->runs, run);
+}
+
+bool RecordSpill_Write
+(
+	RecordSpill *spill,
+	const Record r
+) {
+	ASSERT(r     != NULL);
+	ASSERT(spill != NULL);
+	ASSERT(array_len(spill->runs) > 0);
+
+	if(!_EncodeRecord(spill->file, r)) return false;
+
+	array_tail(spill->runs).count++;
+	return true;
+}
+
+bool RecordSpill_EndRun
+(
+	RecordSpill *spill
+) {
+	ASSERT(spill != NULL);
+
+	// make the run visible to readers
+	if(fflush(spill->file) != 0) return false;
+
+	long size = ftell(spill->file);
+	if(size < 0) return false;
+
+	spill->size = size;
+	return true;
+}
+
+uint RecordSpill_RunCount
+(
+	const RecordSpill *spill
+) {
+	ASSERT(spill != NULL);
+	return array_len(spill->runs);
+}
+
+void RecordSpill_OpenRun
+(
+	const RecordSpill *spill,
+	uint i,
+	SpillRunReader *reader
+) {
+	ASSERT(spill  != NULL);
+	ASSERT(reader != NULL);
+	ASSERT(i < array_len(spill->runs));
+
+	reader->fd        = fileno(spill->file);
+	reader->offset    = spill->runs[i].offset;
+	reader->remaining = spill->runs[i].count;
+	reader->buf       = rm_malloc(SPILL_READ_BUFFER_SIZE);
+	reader->len       = 0;
+	reader->pos       = 0;
+}
+
+Record RecordSpill_Read
+(
+	SpillRunReader *reader,
+	ExecutionPlan *plan
+) {
+	ASSERT(plan   != NULL);
+	ASSERT(reader != NULL);
+
+	if(reader->remaining == 0) return NULL;
+	reader->remaining--;
+
+	Record r = ExecutionPlan_BorrowRecord(plan);
+	_DecodeRecord(reader, r);
+	return r;
+}
+
+void RecordSpill_CloseRun
+(
+	SpillRunReader *reader
+) {
+	ASSERT(reader != NULL);
+
+	if(reader->buf != NULL) {
+		rm_free(reader->buf);
+		reader->buf = NULL;
+	}
+	reader->remaining = 0;
+}
+
+bool RecordSpill_Clear
+(
+	RecordSpill *spill
+) {
+	ASSERT(spill != NULL);
+
+	// runs are expected to be completed, file buffer is flushed
+	array_clear(spill->runs);
+	spill->size = 0;
+
+	rewind(spill->file);
+	return ftruncate(fileno(spill->file), 0) == 0;
+}
+
+void RecordSpill_Free
+(
+	RecordSpill *spill
+) {
+	ASSERT(spill != NULL);
+
+	// temporary file is removed once closed
+	fclose(spill->file);
+	array_free(spill->runs);
+	rm_free(spill);
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "../../record.h"
+#include "../../execution_plan.h"
+
+// RecordSpill writes runs of records to an anonymous temporary file
+// and reads them back in order, one reader per run
+//
+// records are encoded compactly: scalars are written by value
+// nodes and edges by ID, as such they are re-fetched from the graph
+// when read back and must not be modified or deleted in between
+
+typedef struct {
+	uint64_t offset;  // file offset of the run's first record
+	uint64_t count;   // number of records in run
+} SpillRun;
+
+typedef struct {
+	FILE *file;      // temporary file holding all runs
+	uint64_t size;   // number of bytes written to file
+	SpillRun *runs;  // runs written to file
+} RecordSpill;
+
+typedef struct {
+	int fd;              // spill file descriptor
+	uint64_t offset;     // file offset of the next byte to buffer
+	uint64_t remaining;  // number of records left to read
+	char *buf;           // read buffer
+	size_t len;          // number of buffered bytes
+	size_t pos;          // position of the next buffered byte
+} SpillRunReader;
+
+// returns true if all of the record's entries can be spilled
+bool RecordSpill_Encodable
+(
+	const Record r  // record to check
+);
+
+// creates a new record spill backed by a temporary file
+// returns NULL if the file could not be created
+RecordSpill *RecordSpill_New(void);
+
+// starts a new run, records written are appended to it
+void RecordSpill_BeginRun
+(
+	RecordSpill *spill  // record spill
+);
+
+// appends record to the current run
+// the record must be encodable
+// returns false on failure to write
+bool RecordSpill_Write
+(
+	RecordSpill *spill,  // record spill
+	const Record r       // record to write
+);
+
+// completes the current run, making it available for reading
+// returns false on failure to write
+bool RecordSpill_EndRun
+(
+	RecordSpill *spill  // record spill
+);
+
+// returns the number of runs written
+uint RecordSpill_RunCount
+(
+	const RecordSpill *spill  // record spill
+);
+
+// initialize reader to read the i-th run
+void RecordSpill_OpenRun
+(
+	const RecordSpill *spill,  // record spill
+	uint i,                    // run index
+	SpillRunReader *reader     // reader to initialize
+);
+
+// reads the next record of the run into a record borrowed from plan
+// returns NULL once the run is depleted
+Record RecordSpill_Read
+(
+	SpillRunReader *reader,  // run reader
+	ExecutionPlan *plan      // plan owning the returned record
+);
+
+// free reader's internals
+void RecordSpill_CloseRun
+(
+	SpillRunReader *reader  // reader to close
+);
+
+// discards all runs, truncating the temporary file
+// returns false on failure to truncate
+bool RecordSpill_Clear
+(
+	RecordSpill *spill  // record spill
+);
+
+// free record spill and remove its temporary file
+void RecordSpill_Free
+(
+	RecordSpill *spill  // record spill to free
+);
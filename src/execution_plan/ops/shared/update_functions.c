@@ -66,9 +66,9 @@ void CommitUpdates
 		// if entity has been deleted, perform no updates
 		if(GraphEntity_IsDeleted(update->ge)) continue;
 
-		AttributeSet_PersistValues(update->attributes);
-		
 		// update the attributes on the graph entity
+		// only modified values are persisted, unchanged values
+		// are carried over from the entity's current attribute-set
 		UpdateEntityProperties(gc, update->ge, update->attributes,
 				type == ENTITY_NODE ? GETYPE_NODE : GETYPE_EDGE, true);
 		update->attributes = NULL;
@@ -78,38 +78,49 @@ void CommitUpdates
 				update->remove_labels, array_len(update->add_labels),
 				array_len(update->remove_labels), true);
 		}
+	}
+	HashTableReleaseIterator(it);
 
-		//----------------------------------------------------------------------
-		// enforce constraints
-		//----------------------------------------------------------------------
+	// index updated entities at once
+	// constraints are enforced against up to date indices
+	QueryCtx_FlushIndexBuffer();
 
-		if(constraint_violation == false) {
-			// retrieve labels/rel-type
-			uint label_count = 1;
-			if (type == ENTITY_NODE) {
-				label_count = Graph_LabelTypeCount(gc->g);
-			}
-			LabelID labels[label_count];
-			if (type == ENTITY_NODE) {
-				label_count = Graph_GetNodeLabels(gc->g, (Node*)update->ge, labels,
-						label_count);
-			} else {
-				labels[0] = Edge_GetRelationID((Edge*)update->ge);
-			}
+	//--------------------------------------------------------------------------
+	// enforce constraints
+	//--------------------------------------------------------------------------
 
-			SchemaType stype = type == ENTITY_NODE ? SCHEMA_NODE : SCHEMA_EDGE;
-			for(uint i = 0; i < label_count; i ++) {
-				Schema *s = GraphContext_GetSchemaByID(gc, labels[i], stype);
-				// TODO: a bit wasteful need to target relevant constraints only
-				char *err_msg = NULL;
-				if(!Schema_EnforceConstraints(s, update->ge, &err_msg)) {
-					// constraint violation
-					ASSERT(err_msg != NULL);
-					constraint_violation = true;
-					ErrorCtx_SetError("%s", err_msg);
-					free(err_msg);
-					break;
-				}
+	it = HashTableGetIterator(updates);
+	while(!constraint_violation && (entry = HashTableNext(it)) != NULL) {
+		PendingUpdateCtx *update = HashTableGetVal(entry);
+
+		// deleted entities were not updated
+		if(GraphEntity_IsDeleted(update->ge)) continue;
+
+		// retrieve labels/rel-type
+		uint label_count = 1;
+		if (type == ENTITY_NODE) {
+			label_count = Graph_LabelTypeCount(gc->g);
+		}
+		LabelID labels[label_count];
+		if (type == ENTITY_NODE) {
+			label_count = Graph_GetNodeLabels(gc->g, (Node*)update->ge, labels,
+					label_count);
+		} else {
+			labels[0] = Edge_GetRelationID((Edge*)update->ge);
+		}
+
+		SchemaType stype = type == ENTITY_NODE ? SCHEMA_NODE : SCHEMA_EDGE;
+		for(uint i = 0; i < label_count; i ++) {
+			Schema *s = GraphContext_GetSchemaByID(gc, labels[i], stype);
+			// TODO: a bit wasteful need to target relevant constraints only
+			char *err_msg = NULL;
+			if(!Schema_EnforceConstraints(s, update->ge, &err_msg)) {
+				// constraint violation
+				ASSERT(err_msg != NULL);
+				constraint_violation = true;
+				ErrorCtx_SetError("%s", err_msg);
+				free(err_msg);
+				break;
 			}
 		}
 	}
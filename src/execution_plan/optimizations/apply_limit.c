@@ -14,7 +14,8 @@
  * Once one is found, all relevant child operations (e.g. Sort) will be
  * notified about the current limit value.
  * This is beneficial as a number of different optimizations can be applied
- * once a limit is known. */
+ * once a limit is known, e.g. a bounded Sort might consume an index scan
+ * in index order, see orderIndexScans. */
 
 static void notify_limit(OpBase *op, uint limit) {
 	OPType t = op->type;
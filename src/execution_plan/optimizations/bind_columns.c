@@ -0,0 +1,143 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "../ops/ops.h"
+#include "../../util/arr.h"
+#include "../../configuration/config.h"
+#include "../execution_plan_build/execution_plan_util.h"
+#include "../../arithmetic/entity_funcs/attribute_binding.h"
+
+// the bindColumns optimization binds attribute accesses evaluated by
+// filter, project and aggregate operations to the columnar store
+// whenever the accessed node is resolved by a full label scan, e.g.
+//
+// MATCH (p:Person) WHERE p.age > 30 RETURN avg(p.age)
+//
+// both p.age accesses read from the (Person, age) column instead of
+// searching each node's attribute-set
+//
+// a column is built by scanning the label, as such only accesses to nodes
+// produced by a full label scan are bound, these amortize the column's
+// construction, accesses to nodes resolved by a traversal, an index scan or
+// an ID seek keep reading from the nodes' attribute-sets
+
+// returns the label scanned in full to resolve 'alias'
+// GRAPH_UNKNOWN_LABEL if alias isn't resolved by a full label scan
+static LabelID _ScannedLabel
+(
+	OpBase *op,         // op accessing alias
+	const char *alias   // accessed alias
+) {
+	for(int i = 0; i < op->childCount; i++) {
+		OpBase *resolver = ExecutionPlan_LocateOpResolvingAlias(op->children[i],
+				alias);
+		if(resolver == NULL) continue;
+		if(resolver->type != OPType_NODE_BY_LABEL_SCAN) break;
+
+		// a restricted ID range doesn't pay for a full column
+		NodeByLabelScan *scan = (NodeByLabelScan *)resolver;
+		if(scan->id_range->min != 0 || scan->id_range->max != UINT64_MAX) break;
+
+		return scan->n->label_id;
+	}
+
+	return GRAPH_UNKNOWN_LABEL;
+}
+
+static void _BindExp
+(
+	AR_ExpNode *exp,  // expression to bind
+	OpBase *op        // op evaluating expression
+) {
+	if(exp->type != AR_EXP_OP) return;
+
+	for(int i = 0; i < exp->op.child_count; i++) {
+		_BindExp(exp->op.children[i], op);
+	}
+
+	if(!AR_EXP_IsAttribute(exp, NULL) || exp->op.private_data != NULL) return;
+
+	// property(entity, name, attribute id)
+	AR_ExpNode *entity  = exp->op.children[0];
+	AR_ExpNode *attr_id = exp->op.children[2];
+	if(!AR_EXP_IsVariadic(entity)) return;
+	if(attr_id->operand.constant.longval == ATTRIBUTE_ID_NONE) return;
+
+	LabelID label = _ScannedLabel(op, entity->operand.variadic.entity_alias);
+	if(label == GRAPH_UNKNOWN_LABEL) return;
+
+	AR_SetPrivateData(exp, AttributeBinding_Column(label));
+}
+
+static void _BindFilterTree
+(
+	FT_FilterNode *node,  // filter tree to bind
+	OpBase *op            // op evaluating filter tree
+) {
+	switch(node->t) {
+		case FT_N_EXP:
+			_BindExp(node->exp.exp, op);
+			break;
+		case FT_N_PRED:
+			_BindExp(node->pred.lhs, op);
+			_BindExp(node->pred.rhs, op);
+			break;
+		case FT_N_COND:
+			_BindFilterTree(node->cond.left, op);
+			if(node->cond.right != NULL) _BindFilterTree(node->cond.right, op);
+			break;
+		default:
+			ASSERT(false);
+			break;
+	}
+}
+
+void bindColumns
+(
+	ExecutionPlan *plan
+) {
+	ASSERT(plan != NULL);
+
+	bool enabled = false;
+	Config_Option_get(Config_COLUMNAR_STORE, &enabled);
+	if(!enabled) return;
+
+	const OPType types[3] = {OPType_FILTER, OPType_PROJECT, OPType_AGGREGATE};
+	OpBase **ops = ExecutionPlan_CollectOpsMatchingTypes(plan->root, types, 3);
+
+	uint n = array_len(ops);
+	for(uint i = 0; i < n; i++) {
+		OpBase *op = ops[i];
+		switch(op->type) {
+			case OPType_FILTER:
+				_BindFilterTree(((OpFilter *)op)->filterTree, op);
+				break;
+			case OPType_PROJECT: {
+				OpProject *project = (OpProject *)op;
+				for(uint j = 0; j < project->exp_count; j++) {
+					_BindExp(project->exps[j], op);
+				}
+				break;
+			}
+			case OPType_AGGREGATE: {
+				OpAggregate *aggregate = (OpAggregate *)op;
+				for(uint j = 0; j < aggregate->key_count; j++) {
+					_BindExp(aggregate->key_exps[j], op);
+				}
+				for(uint j = 0; j < aggregate->aggregate_count; j++) {
+					_BindExp(aggregate->aggregate_exps[j], op);
+				}
+				break;
+			}
+			default:
+				ASSERT(false);
+				break;
+		}
+	}
+
+	array_free(ops);
+}
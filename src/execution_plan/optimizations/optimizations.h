@@ -11,17 +11,23 @@
 #include "../../arithmetic/algebraic_expression.h"
 
 // reorders exps such that exp[i] is the ith expression to evaluate
+// if 'est_rows' is provided it is populated with the number of rows estimated
+// to be produced by the scan of exp[0]'s source (est_rows[0])
+// and by each expression (est_rows[i + 1]), negative if unknown
 void orderExpressions(
 	QueryGraph *qg,                 // queryGraph containing expression entity data
 	AlgebraicExpression **exps,     // expressions to order
 	uint *exps_count,               // number of expressions
 	const FT_FilterNode *filters,   // filters
-	rax *bound_vars                 // previously-bound variables
+	rax *bound_vars,                // previously-bound variables
+	double *est_rows                // [optional output] *exps_count + 1 estimates
 );
 
 void compactFilters(ExecutionPlan *plan);
 void reduceScans(ExecutionPlan *plan);
 void utilizeIndices(ExecutionPlan *plan);
+void coverIndexScans(ExecutionPlan *plan);
+void orderIndexScans(ExecutionPlan *plan);
 void seekByID(ExecutionPlan *plan);
 void filterVariableLengthEdges(ExecutionPlan *plan);
 void reduceCartesianProductStreamCount(ExecutionPlan *plan);
@@ -33,4 +39,6 @@ void reduceCount(ExecutionPlan *plan);
 void applyLimit(ExecutionPlan *plan);
 void applySkip(ExecutionPlan *plan);
 void optimizeLabelScan(ExecutionPlan *plan);
+void bindColumns(ExecutionPlan *plan);
+void parallelizeScans(ExecutionPlan *plan);
 
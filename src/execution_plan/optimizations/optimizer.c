@@ -60,5 +60,18 @@ void optimizePlan(ExecutionPlan *plan) {
 
 	// let operations know about specified skip(s)
 	applySkip(plan);
+
+	// feed bounded sorts with index scans over their first sort key
+	// in index order, relies on sort limits set above
+	orderIndexScans(plan);
+
+	// read indexed attributes of index scanned nodes from the index
+	coverIndexScans(plan);
+
+	// read attributes of label scanned nodes from the columnar store
+	bindColumns(plan);
+
+	// split scans feeding eager operations across multiple threads
+	parallelizeScans(plan);
 }
 
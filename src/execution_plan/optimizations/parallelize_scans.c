@@ -0,0 +1,126 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "../ops/ops.h"
+#include "../../query_ctx.h"
+#include "../../util/thpool/pools.h"
+#include "../execution_plan_build/execution_plan_util.h"
+#include "../execution_plan_build/execution_plan_modify.h"
+
+// the parallelizeScans optimization looks for an eager operation
+// (aggregate or sort) fed by a pipeline of streaming operations which is tapped
+// by a full or label scan, e.g.
+//
+// MATCH (a:L)-[:R]->(b) RETURN count(b)
+//
+// Aggregate
+//     Conditional Traverse
+//         Node By Label Scan
+//
+// in which case a Gather operation is introduced right below the eager op
+//
+// Aggregate
+//     Gather
+//         Conditional Traverse
+//             Node By Label Scan
+//
+// at runtime gather splits the scanned ID range into morsels and runs clones
+// of its pipeline on additional reader threads
+// the pipelines are executed concurrently, as such the optimization is
+// restricted to read-only plans, and to graphs spanning multiple morsels
+
+// returns true if op-tree rooted at `root` contains a writer op
+static bool _containsWriter
+(
+	OpBase *root
+) {
+	if(OpBase_IsWriter(root)) return true;
+
+	for(int i = 0; i < root->childCount; i++) {
+		if(_containsWriter(root->children[i])) return true;
+	}
+
+	return false;
+}
+
+// returns true if op and all of its ancestors have a single child
+// ops with multiple children (apply, join, etc.) might reset or re-initialize
+// their branches which gather does not support
+static bool _singleStream
+(
+	const OpBase *op
+) {
+	for(; op != NULL; op = op->parent) {
+		if(op->childCount != 1) return false;
+	}
+	return true;
+}
+
+// returns true if the pipeline rooted at `root` can be cloned and executed
+// by multiple threads, each scanning a portion of the graph
+static bool _parallelizablePipeline
+(
+	const OpBase *root
+) {
+	const OpBase *op = root;
+
+	// streaming ops
+	while(op->type == OPType_FILTER ||
+		  op->type == OPType_PROJECT ||
+		  op->type == OPType_EXPAND_INTO ||
+		  op->type == OPType_CONDITIONAL_TRAVERSE) {
+		if(op->childCount != 1 || op->plan != root->plan) return false;
+		op = op->children[0];
+	}
+
+	// scan tapping the pipeline
+	if(op->childCount != 0 || op->plan != root->plan) return false;
+
+	if(op->type == OPType_ALL_NODE_SCAN) return true;
+
+	if(op->type == OPType_NODE_BY_LABEL_SCAN) {
+		// no point in scanning a missing label
+		return ((NodeByLabelScan *)op)->n->label_id != GRAPH_UNKNOWN_LABEL;
+	}
+
+	return false;
+}
+
+void parallelizeScans
+(
+	ExecutionPlan *plan
+) {
+	ASSERT(plan != NULL);
+
+	// no additional readers to run pipelines on
+	if(ThreadPools_ReadersCount() < 2) return;
+
+	// graph is too small to be split
+	Graph *g = QueryCtx_GetGraph();
+	if(Graph_UncompactedNodeCount(g) < 2 * MORSEL_SIZE) return;
+
+	if(_containsWriter(plan->root)) return;
+
+	const OPType types[2] = {OPType_AGGREGATE, OPType_SORT};
+	OpBase **eager_ops = ExecutionPlan_CollectOpsMatchingTypes(plan->root,
+			types, 2);
+
+	uint n = array_len(eager_ops);
+	for(uint i = 0; i < n; i++) {
+		OpBase *eager = eager_ops[i];
+		if(!_singleStream(eager)) continue;
+
+		OpBase *pipeline = eager->children[0];
+		if(!_parallelizablePipeline(pipeline)) continue;
+
+		// introduce gather right below the eager op
+		OpBase *gather = NewGatherOp(pipeline->plan);
+		ExecutionPlan_PushBelow(pipeline, gather);
+	}
+
+	array_free(eager_ops);
+}
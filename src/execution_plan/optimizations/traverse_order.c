@@ -6,12 +6,18 @@
 
 #include "RG.h"
 #include "../../util/arr.h"
+#include "../../query_ctx.h"
 #include "../../util/rmalloc.h"
 #include "../../arithmetic/algebraic_expression/utils.h"
+#include "traverse_order_cost.h"
 #include "traverse_order_utils.h"
 
 #include <stdlib.h>
 
+// factor by which the cost model's arrangement must be cheaper than the
+// heuristic arrangement in order to replace it
+#define COST_MARGIN 2
+
 // having chosen which algebraic expression will be evaluated first
 // determine whether it is worthwhile to transpose it
 // thus swap the source and destination
@@ -199,6 +205,33 @@ static void _order_expressions
 	ASSERT(res == true);
 }
 
+// replace the heuristic arrangement of 'exps' with the cheapest arrangement
+// found by the cost model, if it is estimated to be considerably cheaper
+// close estimates are not trusted over the heuristics
+static void _cost_based_arrangement
+(
+	const TraverseCost *tc,      // cost model
+	AlgebraicExpression **exps,  // heuristically arranged expressions
+	uint nexp                    // number of expressions
+) {
+	bool transpose;
+	double cost;
+	AlgebraicExpression *arrangement[nexp];
+
+	if(!TraverseCost_Cheapest(tc, exps, nexp, arrangement, &transpose, &cost)) {
+		return;
+	}
+
+	if(cost * COST_MARGIN >= TraverseCost_Arrangement(tc, exps, nexp)) return;
+
+	memcpy(exps, arrangement, nexp * sizeof(AlgebraicExpression *));
+
+	// start at the cheaper end-point of the opening expression
+	if(transpose) AlgebraicExpression_Transpose(exps);
+
+	_resolve_winning_sequence(exps, nexp);
+}
+
 static int _score_cmp
 (
 	const ScoredExp *a,
@@ -217,7 +250,8 @@ void orderExpressions
 	AlgebraicExpression **exps,
 	uint *exp_count,
 	const FT_FilterNode *ft,
-	rax *bound_vars
+	rax *bound_vars,
+	double *est_rows
 ) {
 	// Validate inputs
 	ASSERT(qg          != NULL);
@@ -268,6 +302,12 @@ void orderExpressions
 		AlgebraicExpression_Transpose(exps);
 	}
 
+	// consult the cost model, given the graph holds statistics
+	TraverseCost tc;
+	bool costed = TraverseCost_Init(&tc, QueryCtx_GetGraph(), qg, bound_vars,
+			filtered_entities);
+	if(costed) _cost_based_arrangement(&tc, exps, _exp_count);
+
 	// remove redundent operands from expressions
 	// MATCH (a:A)-[:R]->(b:B), (a)-[:R]->(c:C), (a:A)-[:R]->(d:D)
 	// will result in 2 expressions:
@@ -283,6 +323,14 @@ void orderExpressions
 	_AlgebraicExpression_RemoveRedundentOperands(exps, qg);
 	*exp_count = array_len(exps);
 
+	if(est_rows != NULL) {
+		if(costed) {
+			TraverseCost_EstimateRows(&tc, exps, *exp_count, est_rows);
+		} else {
+			for(uint i = 0; i <= *exp_count; i++) est_rows[i] = -1;
+		}
+	}
+
 	if(filtered_entities) {
 		raxFree(filtered_entities);
 	}
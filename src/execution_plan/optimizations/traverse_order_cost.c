@@ -0,0 +1,360 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "../../util/rmalloc.h"
+#include "traverse_order_cost.h"
+
+#include <float.h>
+
+// fraction of an entity's rows passing a single independent filter
+#define FILTER_SELECTIVITY 0.1
+
+// number of hops considered when estimating variable length traversals
+#define VARLEN_HOPS_ESTIMATE 3
+
+// expressions of a pattern, with their end-points mapped to node indices
+typedef struct {
+	uint nnodes;          // number of distinct nodes
+	const char **nodes;   // node aliases
+	double *node_scan;    // number of nodes scanned to resolve each node
+	double *node_card;    // estimated cardinality of each node, once filtered
+	uint *src;            // node index of each expression source
+	uint *dest;           // node index of each expression destination
+	double *sel;          // edge selectivity of each expression
+} _Pattern;
+
+// fraction of rows remaining once filters applied to entity are evaluated
+static double _FilterSelectivity
+(
+	const TraverseCost *tc,
+	const char *alias
+) {
+	if(tc->filtered_entities == NULL) return 1.0;
+
+	void *freq = raxFind(tc->filtered_entities, (unsigned char *)alias,
+			strlen(alias));
+	if(freq == raxNotFound) return 1.0;
+
+	double sel = 1.0;
+	for(int64_t i = 0; i < (int64_t)freq; i++) sel *= FILTER_SELECTIVITY;
+	return sel;
+}
+
+// number of graph nodes scanned in order to resolve node
+static double _NodeScan
+(
+	const TraverseCost *tc,
+	const char *alias
+) {
+	// bound nodes are resolved by the time the pattern is evaluated
+	if(tc->bound_vars != NULL &&
+	   raxFind(tc->bound_vars, (unsigned char *)alias, strlen(alias))
+	   != raxNotFound) {
+		return 1.0;
+	}
+
+	// a node carrying multiple labels can't outnumber its rarest label
+	double card = tc->node_count;
+	QGNode *n = QueryGraph_GetNodeByAlias(tc->qg, alias);
+	uint label_count = QGNode_LabelCount(n);
+	for(uint i = 0; i < label_count; i++) {
+		double count = Graph_LabeledNodeCount(tc->g, QGNode_GetLabelID(n, i));
+		if(count < card) card = count;
+	}
+
+	return card;
+}
+
+// probability a pair of nodes is connected by the expression's edge
+static double _EdgeSelectivity
+(
+	const TraverseCost *tc,
+	AlgebraicExpression *exp
+) {
+	// label only expression, no edge to traverse
+	const char *alias = AlgebraicExpression_Edge(exp);
+	if(alias == NULL) return 1.0;
+
+	QGEdge *e = QueryGraph_GetEdgeByAlias(tc->qg, alias);
+	ASSERT(e != NULL);
+
+	double edges = 0;
+	int rel_count = QGEdge_RelationCount(e);
+	if(rel_count == 0) {
+		edges = Graph_EdgeCount(tc->g);
+	} else {
+		for(int i = 0; i < rel_count; i++) {
+			edges += Graph_RelationEdgeCount(tc->g, QGEdge_RelationID(e, i));
+		}
+	}
+	if(e->bidirectional) edges *= 2;
+
+	double n = tc->node_count;
+	double sel;
+	if(QGEdge_VariableLength(e) || !QGEdge_SingleHop(e)) {
+		// number of paths leaving a node, given the relation's average degree
+		double degree = edges / n;
+		uint max_hops = e->maxHops;
+		if(max_hops > VARLEN_HOPS_ESTIMATE) {
+			max_hops = (e->minHops > VARLEN_HOPS_ESTIMATE) ?
+				e->minHops : VARLEN_HOPS_ESTIMATE;
+		}
+
+		double paths = (e->minHops == 0) ? 1 : 0;
+		double reach = 1;
+		for(uint h = 1; h <= max_hops; h++) {
+			reach *= degree;
+			if(h >= e->minHops) paths += reach;
+		}
+		sel = paths / n;
+	} else {
+		sel = edges / (n * n);
+	}
+
+	return sel * _FilterSelectivity(tc, alias);
+}
+
+static uint _Pattern_NodeIdx
+(
+	_Pattern *p,
+	const TraverseCost *tc,
+	const char *alias
+) {
+	for(uint i = 0; i < p->nnodes; i++) {
+		if(strcmp(p->nodes[i], alias) == 0) return i;
+	}
+
+	p->nodes[p->nnodes]     = alias;
+	p->node_scan[p->nnodes] = _NodeScan(tc, alias);
+	p->node_card[p->nnodes] = p->node_scan[p->nnodes] *
+		_FilterSelectivity(tc, alias);
+	return p->nnodes++;
+}
+
+static void _Pattern_Init
+(
+	_Pattern *p,
+	const TraverseCost *tc,
+	AlgebraicExpression **exps,
+	uint nexp
+) {
+	p->nnodes    = 0;
+	p->nodes     = rm_malloc(sizeof(char *) * nexp * 2);
+	p->node_scan = rm_malloc(sizeof(double) * nexp * 2);
+	p->node_card = rm_malloc(sizeof(double) * nexp * 2);
+	p->src       = rm_malloc(sizeof(uint) * nexp);
+	p->dest      = rm_malloc(sizeof(uint) * nexp);
+	p->sel       = rm_malloc(sizeof(double) * nexp);
+
+	for(uint i = 0; i < nexp; i++) {
+		p->src[i]  = _Pattern_NodeIdx(p, tc, AlgebraicExpression_Src(exps[i]));
+		p->dest[i] = _Pattern_NodeIdx(p, tc, AlgebraicExpression_Dest(exps[i]));
+		p->sel[i]  = _EdgeSelectivity(tc, exps[i]);
+	}
+}
+
+static void _Pattern_Free
+(
+	_Pattern *p
+) {
+	rm_free(p->nodes);
+	rm_free(p->node_scan);
+	rm_free(p->node_card);
+	rm_free(p->src);
+	rm_free(p->dest);
+	rm_free(p->sel);
+}
+
+// cost of resolving node by a scan: nodes scanned and rows passing filters
+static inline double _ScanCost
+(
+	const _Pattern *p,
+	uint n
+) {
+	return p->node_scan[n] + p->node_card[n];
+}
+
+bool TraverseCost_Init
+(
+	TraverseCost *tc,
+	const Graph *g,
+	const QueryGraph *qg,
+	rax *bound_vars,
+	rax *filtered_entities
+) {
+	ASSERT(g  != NULL);
+	ASSERT(qg != NULL);
+	ASSERT(tc != NULL);
+
+	tc->g                 = g;
+	tc->qg                = qg;
+	tc->bound_vars        = bound_vars;
+	tc->filtered_entities = filtered_entities;
+	tc->node_count        = Graph_NodeCount(g);
+
+	return tc->node_count > 0;
+}
+
+void TraverseCost_EstimateRows
+(
+	const TraverseCost *tc,
+	AlgebraicExpression **exps,
+	uint nexp,
+	double *rows
+) {
+	ASSERT(tc   != NULL);
+	ASSERT(exps != NULL);
+	ASSERT(rows != NULL);
+	ASSERT(nexp > 0);
+
+	_Pattern p;
+	_Pattern_Init(&p, tc, exps, nexp);
+
+	bool resolved[p.nnodes];
+	memset(resolved, 0, sizeof(resolved));
+
+	// nodes scanned by the first expression
+	rows[0] = p.node_scan[p.src[0]];
+
+	double r = 1;
+	for(uint i = 0; i < nexp; i++) {
+		r *= p.sel[i];
+		if(!resolved[p.src[i]]) {
+			r *= p.node_card[p.src[i]];
+			resolved[p.src[i]] = true;
+		}
+		if(!resolved[p.dest[i]]) {
+			r *= p.node_card[p.dest[i]];
+			resolved[p.dest[i]] = true;
+		}
+		rows[i + 1] = r;
+	}
+
+	_Pattern_Free(&p);
+}
+
+double TraverseCost_Arrangement
+(
+	const TraverseCost *tc,
+	AlgebraicExpression **exps,
+	uint nexp
+) {
+	_Pattern p;
+	_Pattern_Init(&p, tc, exps, nexp);
+	double cost = _ScanCost(&p, p.src[0]);
+	_Pattern_Free(&p);
+
+	double rows[nexp + 1];
+	TraverseCost_EstimateRows(tc, exps, nexp, rows);
+	for(uint i = 1; i <= nexp; i++) cost += rows[i];
+
+	return cost;
+}
+
+bool TraverseCost_Cheapest
+(
+	const TraverseCost *tc,
+	AlgebraicExpression **exps,
+	uint nexp,
+	AlgebraicExpression **arrangement,
+	bool *transpose,
+	double *cost
+) {
+	ASSERT(tc          != NULL);
+	ASSERT(exps        != NULL);
+	ASSERT(cost        != NULL);
+	ASSERT(transpose   != NULL);
+	ASSERT(arrangement != NULL);
+	ASSERT(nexp > 0);
+
+	if(nexp > TRAVERSE_COST_MAX_EXPS) return false;
+
+	_Pattern p;
+	_Pattern_Init(&p, tc, exps, nexp);
+
+	// a state is a set of resolved expressions, for each state track:
+	// card  - number of rows produced once the state's expressions are resolved
+	//         independent of the order in which they've been resolved
+	// nodes - nodes resolved by the state's expressions
+	// best  - cost of the cheapest arrangement resolving the state
+	// last  - last expression of the cheapest arrangement
+	uint state_count = 1 << nexp;
+	double   *card  = rm_malloc(sizeof(double) * state_count);
+	double   *best  = rm_malloc(sizeof(double) * state_count);
+	uint32_t *nodes = rm_malloc(sizeof(uint32_t) * state_count);
+	uint8_t  *last  = rm_malloc(sizeof(uint8_t) * state_count);
+
+	card[0]  = 1;
+	best[0]  = 0;
+	nodes[0] = 0;
+
+	for(uint s = 1; s < state_count; s++) {
+		// derive cardinality from the state lacking its lowest expression
+		uint e    = __builtin_ctz(s);
+		uint prev = s & (s - 1);
+		uint32_t e_nodes   = (1u << p.src[e]) | (1u << p.dest[e]);
+		uint32_t new_nodes = e_nodes & ~nodes[prev];
+
+		card[s] = card[prev] * p.sel[e];
+		for(uint n = 0; n < p.nnodes; n++) {
+			if(new_nodes & (1u << n)) card[s] *= p.node_card[n];
+		}
+		nodes[s] = nodes[prev] | e_nodes;
+
+		// single expression, scanned from its cheapest end-point
+		if(prev == 0) {
+			double src_scan  = _ScanCost(&p, p.src[e]);
+			double dest_scan = _ScanCost(&p, p.dest[e]);
+			best[s] = ((src_scan < dest_scan) ? src_scan : dest_scan) + card[s];
+			last[s] = e;
+			continue;
+		}
+
+		// extend the cheapest arrangement of each sub-state by an expression
+		// connected to it
+		best[s] = DBL_MAX;
+		for(uint i = 0; i < nexp; i++) {
+			if(!(s & (1u << i))) continue;
+
+			uint sub = s & ~(1u << i);
+			if(best[sub] == DBL_MAX) continue;
+
+			uint32_t i_nodes = (1u << p.src[i]) | (1u << p.dest[i]);
+			if((i_nodes & nodes[sub]) == 0) continue;
+
+			double c = best[sub] + card[s];
+			if(c < best[s]) {
+				best[s] = c;
+				last[s] = i;
+			}
+		}
+	}
+
+	uint s = state_count - 1;
+	bool found = (best[s] != DBL_MAX);
+	if(found) {
+		*cost = best[s];
+
+		// walk back through the states of the cheapest arrangement
+		uint first = 0;
+		for(int i = nexp - 1; i >= 0; i--) {
+			first = last[s];
+			arrangement[i] = exps[first];
+			s &= ~(1u << first);
+		}
+
+		*transpose = _ScanCost(&p, p.dest[first]) < _ScanCost(&p, p.src[first]);
+	}
+
+	rm_free(card);
+	rm_free(best);
+	rm_free(nodes);
+	rm_free(last);
+	_Pattern_Free(&p);
+
+	return found;
+}
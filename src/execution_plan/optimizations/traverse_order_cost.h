@@ -0,0 +1,87 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "../../graph/graph.h"
+#include "../../graph/query_graph.h"
+#include "../../arithmetic/algebraic_expression.h"
+#include "../../../deps/rax/rax.h"
+
+// max number of expressions arranged by the cost model
+// beyond which the heuristic arrangement is kept
+#define TRAVERSE_COST_MAX_EXPS 12
+
+// cost model for the evaluation order of a traversal pattern
+//
+// the number of rows produced after resolving a set of expressions is
+// estimated from the graph's statistics, under independence assumptions:
+//
+// rows = product of the resolved nodes' cardinality *
+//        product of the expressions' edge selectivity
+//
+// a node's cardinality is its smallest label count (graph node count if
+// unlabeled, 1 if bound) scaled down by each independent filter applied to it
+// an edge's selectivity is the probability two nodes are connected by it:
+// relation edge count / node count^2
+// for variable length edges the selectivity is derived from the relation's
+// average degree raised to the number of hops
+//
+// the cost of an arrangement is the number of nodes scanned by its first
+// expression, the number of scanned nodes passing their filters and the
+// number of rows produced by each of the arrangement's prefixes
+
+typedef struct {
+	const Graph *g;            // graph, source of statistics
+	const QueryGraph *qg;      // query graph
+	rax *bound_vars;           // [optional] bound entities
+	rax *filtered_entities;    // [optional] independent filters frequency
+	double node_count;         // number of nodes in graph
+} TraverseCost;
+
+// initialize cost model
+// returns false if the graph holds no statistics to reason about
+bool TraverseCost_Init
+(
+	TraverseCost *tc,          // cost model to initialize
+	const Graph *g,            // graph
+	const QueryGraph *qg,      // query graph
+	rax *bound_vars,           // [optional] bound entities
+	rax *filtered_entities     // [optional] filtered entities
+);
+
+// estimated number of rows produced by each prefix of 'exps'
+// rows[0] is the number of nodes scanned to resolve the first expression's
+// source, rows[i + 1] is the number of rows produced once exps[0..i]
+// are resolved
+void TraverseCost_EstimateRows
+(
+	const TraverseCost *tc,           // cost model
+	AlgebraicExpression **exps,       // arranged expressions
+	uint nexp,                        // number of expressions
+	double *rows                      // [output] nexp + 1 estimates
+);
+
+// cost of evaluating 'exps' in order, starting at the first expression source
+double TraverseCost_Arrangement
+(
+	const TraverseCost *tc,           // cost model
+	AlgebraicExpression **exps,       // arranged expressions
+	uint nexp                         // number of expressions
+);
+
+// find the cheapest arrangement of 'exps' using dynamic programming
+// over connected subsets of expressions
+// returns false if 'exps' is too large to be arranged
+bool TraverseCost_Cheapest
+(
+	const TraverseCost *tc,             // cost model
+	AlgebraicExpression **exps,         // expressions to arrange
+	uint nexp,                          // number of expressions
+	AlgebraicExpression **arrangement,  // [output] cheapest arrangement
+	bool *transpose,                    // [output] start at first's destination
+	double *cost                        // [output] arrangement cost
+);
@@ -8,8 +8,12 @@
 #include "../../value.h"
 #include "../../util/arr.h"
 #include "../../query_ctx.h"
+#include "../ops/op_sort.h"
 #include "../ops/op_filter.h"
+#include "../ops/op_project.h"
+#include "../ops/op_aggregate.h"
 #include "../../ast/ast_shared.h"
+#include "../../ast/ast_build_op_contexts.h"
 #include "../../datatypes/array.h"
 #include "../../datatypes/point.h"
 #include "../ops/op_node_by_label_scan.h"
@@ -24,6 +28,7 @@
 #include "../../arithmetic/algebraic_expression/utils.h"
 #include "../execution_plan_build/execution_plan_util.h"
 #include "../execution_plan_build/execution_plan_modify.h"
+#include "../../arithmetic/entity_funcs/attribute_binding.h"
 
 //------------------------------------------------------------------------------
 // Filter normalization
@@ -303,7 +308,7 @@ void reduce_scan_op
 	// that has the minimum NNZ entries
 	int         min_label_id;                 // tracks min label ID
 	uint64_t    min_nnz        = UINT64_MAX;  // tracks min entries
-	RSIndex     *rs_idx        = NULL;        // the index to be applied
+	Index       min_idx        = NULL;        // the index to be applied
 	OpFilter    **filters      = NULL;        // tracks indexed filters to apply
 	uint        filters_count  = 0;           // number of matching filters
 	const char  *min_label_str = NULL;        // tracks min label name
@@ -344,12 +349,9 @@ void reduce_scan_op
 			continue;
 		}
 
-		// get all applicable filter for index
-		RSIndex *cur_idx = Index_RSIndex(idx);
-
 		nnz = Graph_LabeledNodeCount(g, label_id);
 		if(min_nnz > nnz) {
-			rs_idx         =  cur_idx;
+			min_idx        =  idx;
 			min_nnz        =  nnz;
 			min_label_str  =  label;
 			min_label_id   =  label_id;
@@ -363,7 +365,7 @@ void reduce_scan_op
 	}
 
 	// no label possessed indexed and filtered attributes, return early
-	if(rs_idx == NULL) goto cleanup;
+	if(min_idx == NULL) goto cleanup;
 
 	// did we found a better label to utilize? if so swap
 	if(scan->n->label_id != min_label_id) {
@@ -397,7 +399,7 @@ void reduce_scan_op
 	}
 
 	FT_FilterNode *root = _Concat_Filters(filters);
-	OpBase *indexOp = NewIndexScanOp(scan->op.plan, scan->g, scan->n, rs_idx,
+	OpBase *indexOp = NewIndexScanOp(scan->op.plan, scan->g, scan->n, min_idx,
 			root);
 	scan->n = NULL;
 
@@ -442,9 +444,8 @@ void reduce_cond_op(ExecutionPlan *plan, OpCondTraverse *cond) {
 	uint filters_count = array_len(filters);
 	if(filters_count == 0) goto cleanup;
 
-	RSIndex *rs_idx = Index_RSIndex(idx);
 	FT_FilterNode *root = _Concat_Filters(filters);
-	OpBase *indexOp = NewEdgeIndexScanOp(cond->op.plan, cond->graph, e, rs_idx,
+	OpBase *indexOp = NewEdgeIndexScanOp(cond->op.plan, cond->graph, e, idx,
 			root);
 
 	// The OPType_ALL_NODE_SCAN operation is redundant
@@ -551,3 +552,290 @@ void utilizeIndices
 	array_free(condOps);
 }
 
+
+//------------------------------------------------------------------------------
+// Covering index scans
+//------------------------------------------------------------------------------
+
+// an index scan covers its node if all accesses to the node are accesses to
+// indexed attributes, e.g.
+//
+// MATCH (p:Person) WHERE p.age > 30 RETURN p.age, count(*)
+//
+// given an index over Person's age, p.age is read from the index
+// and the scan skips fetching each Person from the graph
+//
+// accesses are only inspected up to the first projection
+// as projections discard the scanned node
+
+// returns true if all references to 'alias' within 'exp' are accesses to
+// attributes held by 'idx', binds these accesses to 'idx' if 'bind' is set
+static bool _CoverExp
+(
+	AR_ExpNode *exp,    // expression to inspect
+	const char *alias,  // scanned node
+	const Index idx,    // scanned index
+	bool bind           // bind accesses to index
+) {
+	if(exp->type == AR_EXP_OPERAND) {
+		// the record is accessed as a whole
+		if(exp->operand.type == AR_EXP_BORROW_RECORD) return false;
+
+		// node is accessed other than through one of its attributes
+		return !AR_EXP_IsVariadic(exp) ||
+			strcmp(exp->operand.variadic.entity_alias, alias) != 0;
+	}
+
+	if(AR_EXP_IsAttribute(exp, NULL)) {
+		// property(entity, name, attribute id)
+		AR_ExpNode *entity  = exp->op.children[0];
+		AR_ExpNode *attr_id = exp->op.children[2];
+
+		if(AR_EXP_IsVariadic(entity) &&
+		   strcmp(entity->operand.variadic.entity_alias, alias) == 0) {
+			Attribute_ID attr = attr_id->operand.constant.longval;
+			if(!Index_ContainsAttribute(idx, attr)) return false;
+
+			if(bind && exp->op.private_data == NULL) {
+				AR_SetPrivateData(exp, AttributeBinding_Index(idx));
+			}
+			return true;
+		}
+	} else if(!exp->op.f->aggregate && exp->op.f->callbacks.clone != NULL &&
+			  strcmp(AR_EXP_GetFuncName(exp), "distinct") != 0) {
+		// functions such as list comprehensions keep sub-expressions within
+		// their private data, these might access the node
+		return false;
+	}
+
+	for(int i = 0; i < exp->op.child_count; i++) {
+		if(!_CoverExp(exp->op.children[i], alias, idx, bind)) return false;
+	}
+
+	return true;
+}
+
+static bool _CoverFilterTree
+(
+	FT_FilterNode *node,  // filter tree to inspect
+	const char *alias,    // scanned node
+	const Index idx,      // scanned index
+	bool bind             // bind accesses to index
+) {
+	switch(node->t) {
+		case FT_N_EXP:
+			return _CoverExp(node->exp.exp, alias, idx, bind);
+		case FT_N_PRED:
+			return _CoverExp(node->pred.lhs, alias, idx, bind) &&
+				_CoverExp(node->pred.rhs, alias, idx, bind);
+		case FT_N_COND:
+			return _CoverFilterTree(node->cond.left, alias, idx, bind) &&
+				(node->cond.right == NULL ||
+				 _CoverFilterTree(node->cond.right, alias, idx, bind));
+		default:
+			return false;
+	}
+}
+
+// returns true if all accesses to 'alias' by 'op' are covered by 'idx'
+// 'projects' is set if 'op' discards the scanned node
+static bool _CoverOp
+(
+	OpBase *op,         // op to inspect
+	const char *alias,  // scanned node
+	const Index idx,    // scanned index
+	bool bind,          // bind accesses to index
+	bool *projects      // [output] op projects a new record
+) {
+	switch(op->type) {
+		case OPType_FILTER:
+			return _CoverFilterTree(((OpFilter *)op)->filterTree, alias, idx,
+					bind);
+		case OPType_PROJECT: {
+			OpProject *project = (OpProject *)op;
+			*projects = true;
+			for(uint i = 0; i < project->exp_count; i++) {
+				if(!_CoverExp(project->exps[i], alias, idx, bind)) return false;
+			}
+			return true;
+		}
+		case OPType_AGGREGATE: {
+			OpAggregate *aggregate = (OpAggregate *)op;
+			*projects = true;
+			for(uint i = 0; i < aggregate->key_count; i++) {
+				if(!_CoverExp(aggregate->key_exps[i], alias, idx, bind)) {
+					return false;
+				}
+			}
+			for(uint i = 0; i < aggregate->aggregate_count; i++) {
+				if(!_CoverExp(aggregate->aggregate_exps[i], alias, idx, bind)) {
+					return false;
+				}
+			}
+			return true;
+		}
+		default:
+			// op might access the node in any way
+			return false;
+	}
+}
+
+static void _CoverIndexScan
+(
+	IndexScan *scan
+) {
+	bool       projects = false;
+	Index      idx      = scan->idx;
+	const char *alias   = scan->n->alias;
+
+	// make sure all accesses to the node are covered
+	OpBase *op = scan->op.parent;
+	for(; op != NULL && !projects; op = op->parent) {
+		if(!_CoverOp(op, alias, idx, false, &projects)) return;
+	}
+
+	// node reaches the plan's output
+	if(!projects) return;
+
+	// bind accesses to the index
+	projects = false;
+	for(op = scan->op.parent; !projects; op = op->parent) {
+		_CoverOp(op, alias, idx, true, &projects);
+	}
+
+	IndexScanOp_SetCovering(scan);
+}
+
+void coverIndexScans
+(
+	ExecutionPlan *plan
+) {
+	ASSERT(plan != NULL);
+
+	OpBase **scans = ExecutionPlan_CollectOps(plan->root,
+			OPType_NODE_BY_INDEX_SCAN);
+
+	uint n = array_len(scans);
+	for(uint i = 0; i < n; i++) _CoverIndexScan((IndexScan *)scans[i]);
+
+	array_free(scans);
+}
+
+//------------------------------------------------------------------------------
+// Ordered index scans
+//------------------------------------------------------------------------------
+
+// a sort with a limit fed by an index scan over its first sort key
+// can consume scanned nodes in index order, e.g.
+//
+// MATCH (p:Player) WHERE p.score > 0 RETURN p ORDER BY p.score DESC LIMIT 10
+//
+// given an index over Player's score, the scan visits players from the
+// highest score down and sort stops pulling records after the top 10
+//
+// filter values are only known at runtime, as such sort remains in place
+// and falls back to sorting all of its input whenever the scan's index query
+// can't be resolved in order, see IndexQuery_Ordered
+//
+// the optimization is restricted to read-only plans as index maintenance
+// is deferred to commit, an index might not reflect the query's own writes
+
+// returns true if the op-tree rooted at `root` contains a writer op
+static bool _containsWriter
+(
+	OpBase *root
+) {
+	if(OpBase_IsWriter(root)) return true;
+
+	for(int i = 0; i < root->childCount; i++) {
+		if(_containsWriter(root->children[i])) return true;
+	}
+
+	return false;
+}
+
+// returns the position of the index field 'exp' accesses
+// -1 if 'exp' isn't an access to an attribute of 'alias' indexed by 'idx'
+static int _SortField
+(
+	const AR_ExpNode *exp,  // sort key
+	const char *alias,      // scanned node
+	const Index idx         // scanned index
+) {
+	if(!AR_EXP_IsAttribute(exp, NULL)) return -1;
+
+	// property(entity, name, attribute id)
+	AR_ExpNode *entity  = exp->op.children[0];
+	AR_ExpNode *attr_id = exp->op.children[2];
+
+	if(!AR_EXP_IsVariadic(entity) ||
+	   strcmp(entity->operand.variadic.entity_alias, alias) != 0) {
+		return -1;
+	}
+
+	Attribute_ID     attr   = attr_id->operand.constant.longval;
+	uint             n      = Index_FieldsCount(idx);
+	const IndexField *fields = Index_GetFields(idx);
+
+	for(uint i = 0; i < n; i++) {
+		if(fields[i].id == attr) return i;
+	}
+
+	return -1;
+}
+
+static void _OrderIndexScan
+(
+	OpSort *sort
+) {
+	// records tied on the first sort key are buffered
+	// bound their number by the sort's limit
+	if(sort->limit == UNLIMITED) return;
+
+	// sort fed by a projection of the scanned nodes
+	OpBase *op = sort->op.children[0];
+	if(op->type != OPType_PROJECT || op->childCount != 1) return;
+
+	OpProject *project = (OpProject *)op;
+
+	// filters drop records without reordering them
+	op = op->children[0];
+	while(op->type == OPType_FILTER && op->childCount == 1) {
+		op = op->children[0];
+	}
+
+	// scan tapping the pipeline
+	if(op->type != OPType_NODE_BY_INDEX_SCAN || op->childCount != 0) return;
+
+	IndexScan *scan = (IndexScan *)op;
+
+	// locate the projection of the first sort key
+	const char *name = sort->exps[0]->resolved_name;
+	for(uint i = 0; i < project->exp_count; i++) {
+		AR_ExpNode *exp = project->exps[i];
+		if(strcmp(exp->resolved_name, name) != 0) continue;
+
+		int field = _SortField(exp, scan->n->alias, scan->idx);
+		if(field < 0) return;
+
+		IndexScanOp_SetOrder(scan, field, sort->directions[0] == DIR_DESC);
+		SortOp_SetOrderedInput(sort, scan);
+		return;
+	}
+}
+
+void orderIndexScans
+(
+	ExecutionPlan *plan
+) {
+	ASSERT(plan != NULL);
+
+	if(_containsWriter(plan->root)) return;
+
+	OpBase **sorts = ExecutionPlan_CollectOps(plan->root, OPType_SORT);
+
+	uint n = array_len(sorts);
+	for(uint i = 0; i < n; i++) _OrderIndexScan((OpSort *)sorts[i]);
+
+	array_free(sorts);
+}
@@ -0,0 +1,391 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "ft_to_index_query.h"
+#include "../util/arr.h"
+#include "filter_tree_utils.h"
+#include "../datatypes/point.h"
+#include "../datatypes/array.h"
+
+// maximum number of clauses a filter is expanded into
+#define MAX_CLAUSES 256
+
+// meters per degree of latitude, see EARTH_RADIUS in point_funcs.c
+#define METERS_PER_DEGREE 111319.5
+
+// a filter is converted into a disjunction of clauses
+// each clause is an array of checks, see index_query.h
+
+static void _DNF_Free
+(
+	IndexCheck **dnf
+) {
+	uint n = array_len(dnf);
+	for(uint i = 0; i < n; i++) IndexQuery_FreeChecks(dnf[i]);
+	array_free(dnf);
+}
+
+// creates a DNF made of a single clause holding a single check
+static IndexCheck **_DNF_Check
+(
+	uint16_t field,
+	IndexRange *range
+) {
+	IndexCheck *clause = array_new(IndexCheck, 1);
+	array_append(clause, ((IndexCheck){.field = field, .range = *range}));
+
+	IndexCheck **dnf = array_new(IndexCheck *, 1);
+	array_append(dnf, clause);
+
+	return dnf;
+}
+
+// adds check to clause, intersecting it with the clause's check on field
+// returns false if the clause can't be satisfied
+static bool _Clause_AddCheck
+(
+	IndexCheck **clause,
+	const IndexCheck *check
+) {
+	uint n = array_len(*clause);
+	for(uint i = 0; i < n; i++) {
+		IndexCheck *c = (*clause) + i;
+		if(c->field == check->field) {
+			return IndexRange_Intersect(&c->range, &check->range);
+		}
+	}
+
+	IndexCheck c = {.field = check->field};
+	IndexRange_Clone(&check->range, &c.range);
+	array_append(*clause, c);
+
+	return true;
+}
+
+// computes the conjunction of two DNFs
+// returns false if the result exceeds the maximum number of clauses
+static bool _DNF_And
+(
+	IndexCheck **a,
+	IndexCheck **b,
+	IndexCheck ***res
+) {
+	uint na = array_len(a);
+	uint nb = array_len(b);
+	if((uint64_t)na * nb > MAX_CLAUSES) return false;
+
+	IndexCheck **dnf = array_new(IndexCheck *, na * nb);
+	for(uint i = 0; i < na; i++) {
+		for(uint j = 0; j < nb; j++) {
+			bool satisfiable = true;
+			IndexCheck *clause = array_new(IndexCheck, array_len(a[i]));
+
+			for(uint k = 0; k < array_len(a[i]) && satisfiable; k++) {
+				satisfiable = _Clause_AddCheck(&clause, a[i] + k);
+			}
+			for(uint k = 0; k < array_len(b[j]) && satisfiable; k++) {
+				satisfiable = _Clause_AddCheck(&clause, b[j] + k);
+			}
+
+			// drop unsatisfiable clauses
+			if(satisfiable) array_append(dnf, clause);
+			else IndexQuery_FreeChecks(clause);
+		}
+	}
+
+	*res = dnf;
+	return true;
+}
+
+// returns position of indexed attribute, -1 if attribute isn't indexed
+static int _FieldPosition
+(
+	const Index idx,
+	const char *attr
+) {
+	uint n = Index_FieldsCount(idx);
+	const IndexField *fields = Index_GetFields(idx);
+
+	for(uint i = 0; i < n; i++) {
+		if(strcmp(fields[i].name, attr) == 0) return i;
+	}
+
+	return -1;
+}
+
+// converts IN filter: n.v IN [1,2,3]
+static bool _InFilterToDNF
+(
+	const FT_FilterNode *tree,
+	const Index idx,
+	IndexCheck ***dnf,
+	bool *exact
+) {
+	char *attr;
+	AR_ExpNode *in = tree->exp.exp;
+	if(!AR_EXP_IsAttribute(in->op.children[0], &attr)) return false;
+
+	int field = _FieldPosition(idx, attr);
+	if(field < 0) return false;
+
+	SIValue list = AR_EXP_Evaluate(in->op.children[1], NULL);
+	if(SI_TYPE(list) != T_ARRAY || SIArray_Length(list) > MAX_CLAUSES) {
+		SIValue_Free(list);
+		return false;
+	}
+
+	// a single clause for each element
+	uint n = SIArray_Length(list);
+	*dnf   = array_new(IndexCheck *, n);
+	*exact = true;
+
+	for(uint i = 0; i < n; i++) {
+		SIValue v = SIArray_Get(list, i);
+		// null is never equal to any value
+		if(SI_TYPE(v) == T_NULL) continue;
+
+		IndexRange range;
+		*exact &= IndexRange_FromPredicate(&range, OP_EQUAL, v);
+
+		IndexCheck *clause = array_new(IndexCheck, 1);
+		array_append(clause, ((IndexCheck){.field = field, .range = range}));
+		array_append(*dnf, clause);
+	}
+
+	SIValue_Free(list);
+	return true;
+}
+
+// converts distance filter: distance(n.loc, origin) < radius
+// into the band of latitudes surrounding origin
+static bool _DistanceFilterToDNF
+(
+	const FT_FilterNode *tree,
+	const Index idx,
+	IndexCheck ***dnf,
+	bool *exact
+) {
+	char    *attr  = NULL;
+	SIValue origin = SI_NullVal();
+	SIValue radius = SI_NullVal();
+
+	extractOriginAndRadius(tree, &origin, &radius, &attr);
+
+	int field = _FieldPosition(idx, attr);
+	if(field < 0 || SI_TYPE(origin) != T_POINT) {
+		SIValue_Free(origin);
+		SIValue_Free(radius);
+		return false;
+	}
+
+	// distances are computed in single precision, widen band by 1%
+	double lat = Point_lat(origin);
+	double d   = SI_GET_NUMERIC(radius) / METERS_PER_DEGREE * 1.01;
+
+	IndexRange range;
+	IndexRange_Latitude(&range, lat - d, lat + d);
+
+	*dnf   = _DNF_Check(field, &range);
+	*exact = false;
+
+	SIValue_Free(origin);
+	SIValue_Free(radius);
+	return true;
+}
+
+// converts predicate filter: n.v op exp
+static bool _PredicateFilterToDNF
+(
+	const FT_FilterNode *tree,
+	const Index idx,
+	IndexCheck ***dnf,
+	bool *exact
+) {
+	char *attr;
+	if(!AR_EXP_IsAttribute(tree->pred.lhs, &attr)) return false;
+
+	int field = _FieldPosition(idx, attr);
+	if(field < 0) return false;
+
+	AST_Operator op = tree->pred.op;
+	if(op != OP_LT && op != OP_LE && op != OP_GT && op != OP_GE &&
+	   op != OP_EQUAL) {
+		return false;
+	}
+
+	SIValue v = AR_EXP_Evaluate(tree->pred.rhs, NULL);
+
+	if(SI_TYPE(v) == T_NULL) {
+		// comparing against null never holds
+		*dnf   = array_new(IndexCheck *, 0);
+		*exact = true;
+	} else {
+		IndexRange range;
+		*exact = IndexRange_FromPredicate(&range, op, v);
+		*dnf   = _DNF_Check(field, &range);
+	}
+
+	SIValue_Free(v);
+	return true;
+}
+
+// converts filter tree into a DNF
+// returns false if the filter can't be converted
+// 'exact' is set to false if the DNF matches a superset of the entities
+// passing the filter
+static bool _FilterTreeToDNF
+(
+	const FT_FilterNode *tree,
+	const Index idx,
+	IndexCheck ***dnf,
+	bool *exact
+) {
+	if(isInFilter(tree)) return _InFilterToDNF(tree, idx, dnf, exact);
+
+	if(isDistanceFilter(tree)) {
+		return _DistanceFilterToDNF(tree, idx, dnf, exact);
+	}
+
+	if(tree->t == FT_N_PRED) {
+		return _PredicateFilterToDNF(tree, idx, dnf, exact);
+	}
+
+	if(tree->t != FT_N_COND) return false;
+
+	AST_Operator op = tree->cond.op;
+	if(op != OP_AND && op != OP_OR) return false;
+
+	bool        left_exact;
+	bool        right_exact;
+	IndexCheck  **left  = NULL;
+	IndexCheck  **right = NULL;
+
+	if(!_FilterTreeToDNF(tree->cond.left, idx, &left, &left_exact)) {
+		return false;
+	}
+
+	if(!_FilterTreeToDNF(tree->cond.right, idx, &right, &right_exact)) {
+		_DNF_Free(left);
+		return false;
+	}
+
+	bool res = true;
+	*exact = left_exact && right_exact;
+
+	if(op == OP_AND) {
+		res = _DNF_And(left, right, dnf);
+		_DNF_Free(left);
+		_DNF_Free(right);
+	} else {
+		// union, concatenate clauses
+		uint n = array_len(right);
+		for(uint i = 0; i < n; i++) array_append(left, right[i]);
+		array_free(right);
+
+		*dnf = left;
+		if(array_len(left) > MAX_CLAUSES) {
+			_DNF_Free(left);
+			res = false;
+		}
+	}
+
+	return res;
+}
+
+// edge index scans restrict edge endpoints with the filters:
+// e._src_id = X and e._dest_id = Y
+// returns true if 'tree' is such a filter, restricting 'q' accordingly
+static bool _FilterTreeToEndpoint
+(
+	IndexQuery *q,
+	const FT_FilterNode *tree,
+	const Index idx
+) {
+	if(Index_GraphEntityType(idx) != GETYPE_EDGE) return false;
+	if(tree->t != FT_N_PRED || tree->pred.op != OP_EQUAL) return false;
+
+	char *attr;
+	if(!AR_EXP_IsAttribute(tree->pred.lhs, &attr)) return false;
+
+	bool src  = strcmp(attr, "_src_id")  == 0;
+	bool dest = strcmp(attr, "_dest_id") == 0;
+	if(!src && !dest) return false;
+
+	SIValue v = AR_EXP_Evaluate(tree->pred.rhs, NULL);
+	if(SI_TYPE(v) != T_INT64) {
+		SIValue_Free(v);
+		return false;
+	}
+
+	if(src) IndexQuery_SetSrc(q, v.longval);
+	else    IndexQuery_SetDest(q, v.longval);
+
+	return true;
+}
+
+IndexQuery *FilterTreeToIndexQuery
+(
+	FT_FilterNode **none_converted_filters,
+	const FT_FilterNode *tree,
+	const Index idx
+) {
+	ASSERT(idx                    != NULL);
+	ASSERT(tree                   != NULL);
+	ASSERT(none_converted_filters != NULL);
+
+	IndexQuery          *q           = IndexQuery_New(Index_OrderedIndex(idx));
+	const FT_FilterNode **trees      = FilterTree_SubTrees(tree);
+	const FT_FilterNode **unresolved = array_new(const FT_FilterNode *, 0);
+
+	// start with a single empty clause, matching all entities
+	IndexCheck **dnf = array_new(IndexCheck *, 1);
+	array_append(dnf, array_new(IndexCheck, 0));
+
+	//--------------------------------------------------------------------------
+	// intersect the DNFs of the individual filters
+	//--------------------------------------------------------------------------
+
+	uint tree_count = array_len(trees);
+	for(uint i = 0; i < tree_count; i++) {
+		bool                exact;
+		IndexCheck          **sub = NULL;
+		IndexCheck          **res = NULL;
+		const FT_FilterNode *t    = trees[i];
+
+		if(_FilterTreeToEndpoint(q, t, idx)) continue;
+
+		// filters which can't be converted are applied to each entity
+		if(!_FilterTreeToDNF(t, idx, &sub, &exact)) {
+			array_append(unresolved, t);
+			continue;
+		}
+
+		if(_DNF_And(dnf, sub, &res)) {
+			_DNF_Free(dnf);
+			dnf = res;
+			// the index returns a superset of the entities passing the filter
+			if(!exact) array_append(unresolved, t);
+		} else {
+			// too many clauses, apply filter to each entity
+			array_append(unresolved, t);
+		}
+
+		_DNF_Free(sub);
+	}
+
+	uint n = array_len(dnf);
+	for(uint i = 0; i < n; i++) IndexQuery_AddClause(q, dnf[i]);
+	array_free(dnf);
+
+	*none_converted_filters = FilterTree_Combine(unresolved,
+			array_len(unresolved));
+
+	array_free(trees);
+	array_free(unresolved);
+
+	return q;
+}
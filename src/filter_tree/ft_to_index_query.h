@@ -0,0 +1,21 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "filter_tree.h"
+#include "../index/index.h"
+#include "../index/index_query.h"
+
+// construct an exact-match index query from filter tree
+// filters the index can't resolve on its own are returned via
+// 'none_converted_filters' and must be applied to each returned entity
+IndexQuery *FilterTreeToIndexQuery
+(
+	FT_FilterNode **none_converted_filters,  // [output] none converted filters
+	const FT_FilterNode *tree,               // filter tree to convert
+	const Index idx                          // queried index
+);
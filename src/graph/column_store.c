@@ -0,0 +1,452 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "column_store.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "rg_matrix/rg_matrix_iter.h"
+#include "../configuration/config.h"
+
+// types which can be held by a column
+#define COLUMN_TYPES (T_INT64 | T_DOUBLE | T_BOOL)
+
+// column lookup key
+#define COLUMN_KEY(label, attr) \
+	(((uint64_t)(uint32_t)(label) << 16) | (uint64_t)(attr))
+
+static void _Column_Free
+(
+	Column *c
+) {
+	if(c->covered != NULL) rm_free(c->covered);
+	if(c->nulls   != NULL) rm_free(c->nulls);
+	if(c->longs   != NULL) rm_free(c->longs);
+
+	pthread_mutex_destroy(&c->build);
+	rm_free(c);
+}
+
+// number of bytes held by a column of 'len' slots
+static inline size_t _Column_Memory
+(
+	uint64_t len
+) {
+	uint64_t nwords = (len + 63) / 64;
+	return sizeof(Column) +
+		   2 * (nwords + 1) * sizeof(uint64_t) +  // covered and nulls bitmaps
+		   (len + 1) * sizeof(int64_t);           // values
+}
+
+// create a new, unpopulated column of 'len' slots
+// the column is populated by _Column_Build
+static Column *_Column_New
+(
+	LabelID label,
+	Attribute_ID attr,
+	uint64_t len
+) {
+	Column *c = rm_malloc(sizeof(Column));
+
+	c->len       = len;
+	c->attr      = attr;
+	c->type      = T_NULL;
+	c->label     = label;
+	c->built     = false;
+	c->memory    = _Column_Memory(len);
+	c->last_used = 0;
+	c->ref_count = 1;  // store's reference
+	c->covered   = NULL;
+	c->nulls     = NULL;
+	c->longs     = NULL;
+
+	int res = pthread_mutex_init(&c->build, NULL);
+	ASSERT(res == 0);
+	UNUSED(res);
+
+	return c;
+}
+
+// populate column from the attribute-sets of all nodes labeled 'label'
+static void _Column_Build
+(
+	Graph *g,
+	Column *c
+) {
+	uint64_t     len    = c->len;
+	Attribute_ID attr   = c->attr;
+	uint64_t     nwords = (len + 63) / 64;
+
+	c->covered = rm_calloc(nwords + 1, sizeof(uint64_t));
+	c->nulls   = rm_calloc(nwords + 1, sizeof(uint64_t));
+	c->longs   = rm_malloc((len + 1) * sizeof(int64_t));
+
+	RG_MatrixTupleIter it = {0};
+	RG_Matrix L = Graph_GetLabelMatrix(g, c->label);
+	GrB_Info info = RG_MatrixTupleIter_attach(&it, L);
+	ASSERT(info == GrB_SUCCESS);
+
+	NodeID id;
+	while(RG_MatrixTupleIter_next_BOOL(&it, &id, NULL, NULL) == GrB_SUCCESS) {
+		if(id >= len) continue;
+
+		uint64_t word = id >> 6;
+		uint64_t bit  = 1ULL << (id & 63);
+
+		Node n;
+		Graph_GetNode(g, id, &n);
+		SIValue *v = AttributeSet_Get(*n.attributes, attr);
+
+		if(v == ATTRIBUTE_NOTFOUND) {
+			c->covered[word] |= bit;
+			c->nulls[word]   |= bit;
+			continue;
+		}
+
+		// column is typed by the first supported value
+		SIType t = SI_TYPE(*v);
+		if(c->type == T_NULL && (t & COLUMN_TYPES)) c->type = t;
+
+		// value of a different type, read from the attribute-set
+		if(t != c->type) continue;
+
+		if(t == T_DOUBLE) {
+			c->doubles[id] = v->doubleval;
+		} else {
+			c->longs[id] = v->longval;
+		}
+		c->covered[word] |= bit;
+	}
+
+	RG_MatrixTupleIter_detach(&it);
+}
+
+ColumnStore *ColumnStore_New(void) {
+	ColumnStore *store = rm_malloc(sizeof(ColumnStore));
+
+	store->clock   = 0;
+	store->memory  = 0;
+	store->columns = raxNew();
+	int res = pthread_mutex_init(&store->lock, NULL);
+	ASSERT(res == 0);
+
+	return store;
+}
+
+// remove column from store and release store's reference
+// the store's lock must be held
+static void _ColumnStore_Remove
+(
+	ColumnStore *store,
+	Column *c
+) {
+	uint64_t key = COLUMN_KEY(c->label, c->attr);
+	raxRemove(store->columns, (unsigned char *)&key, sizeof(key), NULL);
+	store->memory -= c->memory;
+	Column_Release(c);
+}
+
+// evict least recently used columns until store holds at most 'capacity' bytes
+// the store's lock must be held
+static void _ColumnStore_Evict
+(
+	ColumnStore *store,
+	size_t capacity
+) {
+	while(store->memory > capacity) {
+		// find least recently used column
+		Column *lru = NULL;
+		raxIterator it;
+		raxStart(&it, store->columns);
+		raxSeek(&it, "^", NULL, 0);
+		while(raxNext(&it)) {
+			Column *c = it.data;
+			if(lru == NULL || c->last_used < lru->last_used) lru = c;
+		}
+		raxStop(&it);
+
+		ASSERT(lru != NULL);
+		_ColumnStore_Remove(store, lru);
+	}
+}
+
+Column *ColumnStore_GetColumn
+(
+	ColumnStore *store,
+	Graph *g,
+	LabelID label,
+	Attribute_ID attr
+) {
+	ASSERT(g     != NULL);
+	ASSERT(store != NULL);
+	ASSERT(label != GRAPH_UNKNOWN_LABEL);
+	ASSERT(attr  != ATTRIBUTE_ID_NONE);
+
+	bool     build = false;
+	uint64_t key   = COLUMN_KEY(label, attr);
+
+	pthread_mutex_lock(&store->lock);
+
+	Column *c = raxFind(store->columns, (unsigned char *)&key, sizeof(key));
+
+	if(c == raxNotFound) {
+		uint64_t capacity;
+		Config_Option_get(Config_COLUMNAR_STORE_MEM_CAPACITY, &capacity);
+
+		// column doesn't fit within the store's capacity
+		uint64_t len = Graph_UncompactedNodeCount(g);
+		size_t memory = _Column_Memory(len);
+		if(memory > capacity) {
+			pthread_mutex_unlock(&store->lock);
+			return NULL;
+		}
+
+		// make room for the new column
+		_ColumnStore_Evict(store, capacity - memory);
+
+		// publish column, claiming its build
+		// concurrent fetches wait for the build to complete
+		c = _Column_New(label, attr, len);
+		pthread_mutex_lock(&c->build);
+		raxInsert(store->columns, (unsigned char *)&key, sizeof(key), c, NULL);
+		store->memory += c->memory;
+		build = true;
+	}
+
+	c->last_used = ++store->clock;
+
+	// caller's reference
+	__atomic_add_fetch(&c->ref_count, 1, __ATOMIC_RELAXED);
+
+	pthread_mutex_unlock(&store->lock);
+
+	if(build) {
+		// build outside of the store's lock
+		// other columns can be fetched and built meanwhile
+		_Column_Build(g, c);
+		__atomic_store_n(&c->built, true, __ATOMIC_RELEASE);
+		pthread_mutex_unlock(&c->build);
+	} else if(!__atomic_load_n(&c->built, __ATOMIC_ACQUIRE)) {
+		// column is being built by another thread, wait for it
+		pthread_mutex_lock(&c->build);
+		pthread_mutex_unlock(&c->build);
+		ASSERT(c->built);
+	}
+
+	return c;
+}
+
+void ColumnStore_Invalidate
+(
+	ColumnStore *store,
+	LabelID label,
+	Attribute_ID attr
+) {
+	ASSERT(store != NULL);
+	ASSERT(label != GRAPH_UNKNOWN_LABEL);
+
+	// nothing to drop
+	if(__atomic_load_n(&store->memory, __ATOMIC_RELAXED) == 0) return;
+
+	pthread_mutex_lock(&store->lock);
+
+	if(attr != ATTRIBUTE_ID_ALL) {
+		uint64_t key = COLUMN_KEY(label, attr);
+		Column *c = raxFind(store->columns, (unsigned char *)&key, sizeof(key));
+		if(c != raxNotFound) _ColumnStore_Remove(store, c);
+	} else {
+		// collect label's columns, the store can't be modified while iterated
+		Column **drop = array_new(Column *, 0);
+
+		raxIterator it;
+		raxStart(&it, store->columns);
+		raxSeek(&it, "^", NULL, 0);
+		while(raxNext(&it)) {
+			Column *c = it.data;
+			if(c->label == label) array_append(drop, c);
+		}
+		raxStop(&it);
+
+		uint n = array_len(drop);
+		for(uint i = 0; i < n; i++) _ColumnStore_Remove(store, drop[i]);
+		array_free(drop);
+	}
+
+	pthread_mutex_unlock(&store->lock);
+}
+
+void ColumnStore_InvalidateNode
+(
+	ColumnStore *store,
+	Graph *g,
+	const Node *n,
+	Attribute_ID attr
+) {
+	ASSERT(g     != NULL);
+	ASSERT(n     != NULL);
+	ASSERT(store != NULL);
+
+	// nothing to drop
+	if(__atomic_load_n(&store->memory, __ATOMIC_RELAXED) == 0) return;
+
+	uint label_count;
+	NODE_GET_LABELS(g, n, label_count);
+	for(uint i = 0; i < label_count; i++) {
+		ColumnStore_Invalidate(store, labels[i], attr);
+	}
+}
+
+void ColumnStore_Evict
+(
+	ColumnStore *store,
+	size_t capacity
+) {
+	ASSERT(store != NULL);
+
+	pthread_mutex_lock(&store->lock);
+
+	_ColumnStore_Evict(store, capacity);
+
+	pthread_mutex_unlock(&store->lock);
+}
+
+void ColumnStore_Clear
+(
+	ColumnStore *store
+) {
+	ASSERT(store != NULL);
+
+	pthread_mutex_lock(&store->lock);
+
+	raxFreeWithCallback(store->columns, (void(*)(void *))Column_Release);
+	store->columns = raxNew();
+	store->memory  = 0;
+
+	pthread_mutex_unlock(&store->lock);
+}
+
+void ColumnStore_GetStats
+(
+	ColumnStore *store,
+	uint64_t *column_count,
+	size_t *memory
+) {
+	ASSERT(store        != NULL);
+	ASSERT(memory       != NULL);
+	ASSERT(column_count != NULL);
+
+	pthread_mutex_lock(&store->lock);
+
+	*memory       = store->memory;
+	*column_count = raxSize(store->columns);
+
+	pthread_mutex_unlock(&store->lock);
+}
+
+void ColumnStore_Free
+(
+	ColumnStore *store
+) {
+	ASSERT(store != NULL);
+
+	raxFreeWithCallback(store->columns, (void(*)(void *))Column_Release);
+	pthread_mutex_destroy(&store->lock);
+	rm_free(store);
+}
+
+void Column_Release
+(
+	Column *c
+) {
+	ASSERT(c != NULL);
+
+	// columns are shared by the store and by concurrent readers
+	if(__atomic_sub_fetch(&c->ref_count, 1, __ATOMIC_ACQ_REL) == 0) {
+		_Column_Free(c);
+	}
+}
+
+//------------------------------------------------------------------------------
+// column binding
+//------------------------------------------------------------------------------
+
+ColumnBinding *ColumnBinding_New
+(
+	LabelID label
+) {
+	ASSERT(label != GRAPH_UNKNOWN_LABEL);
+
+	ColumnBinding *b = rm_malloc(sizeof(ColumnBinding));
+
+	b->label       = label;
+	b->column      = NULL;
+	b->version     = 0;
+	b->exceeded    = false;
+	b->exceeded_at = 0;
+
+	return b;
+}
+
+bool ColumnBinding_Read
+(
+	ColumnBinding *b,
+	ColumnStore *store,
+	Graph *g,
+	Attribute_ID attr,
+	NodeID id,
+	SIValue *v
+) {
+	ASSERT(b != NULL);
+	ASSERT(g != NULL);
+	ASSERT(v != NULL);
+
+	// pending modifications aren't reflected by columns
+	if(g->_writelocked || store == NULL) return false;
+
+	uint64_t version = Graph_GetVersion(g);
+
+	// column didn't fit within the store's capacity at this version
+	if(b->exceeded && b->exceeded_at == version) return false;
+
+	// the graph has changed since the column was fetched
+	// refetch, the column is rebuilt only if it was dropped by a writer
+	Column *c = b->column;
+	if(c == NULL || c->attr != attr || b->version != version) {
+		c = ColumnStore_GetColumn(store, g, b->label, attr);
+		if(b->column != NULL) Column_Release(b->column);
+		b->column  = c;
+		b->version = version;
+
+		// don't retry until the graph changes
+		b->exceeded    = (c == NULL);
+		b->exceeded_at = version;
+		if(c == NULL) return false;
+	}
+
+	return Column_Get(c, id, v);
+}
+
+void *ColumnBinding_Clone
+(
+	void *orig
+) {
+	// unbound property access
+	if(orig == NULL) return NULL;
+
+	// clones fetch their own column, they might be evaluated by another thread
+	return ColumnBinding_New(((ColumnBinding *)orig)->label);
+}
+
+void ColumnBinding_Free
+(
+	void *b
+) {
+	ASSERT(b != NULL);
+
+	ColumnBinding *binding = (ColumnBinding *)b;
+	if(binding->column != NULL) Column_Release(binding->column);
+	rm_free(binding);
+}
@@ -0,0 +1,203 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "graph.h"
+#include "../value.h"
+#include "entities/node.h"
+#include "entities/graph_entity.h"
+#include "entities/attribute_set.h"
+
+#include <pthread.h>
+
+// columnar store
+//
+// a column holds the values of a single attribute for all nodes carrying
+// a label, in a dense typed vector indexed by node ID
+// alongside two bitmaps:
+// covered - slot holds the node's value, either as a value or as a null
+// nulls   - node doesn't have the attribute
+//
+// columns are derived from the nodes' attribute-sets, they're built on demand
+// writers never update columns, instead a writer modifying an attribute of a
+// labeled node drops the label's column of that attribute, see
+// ColumnStore_Invalidate, removing a node or a label drops all of the
+// label's columns, dropped columns are rebuilt once accessed
+//
+// a column is built outside of the store's lock, concurrent fetches of a
+// column which is being built wait on the column's build lock
+//
+// columns are typed by the first numeric or boolean value encountered
+// values of other types are left uncovered and are read from the node's
+// attribute-set
+//
+// the memory held by a store's columns is bounded by the
+// COLUMNAR_STORE_MEM_CAPACITY configuration, least recently used columns are
+// evicted to make room for a new column, a column which exceeds the capacity
+// on its own isn't built and its accesses read from the nodes' attribute-sets
+
+typedef struct {
+	LabelID label;            // label of covered nodes
+	Attribute_ID attr;        // attribute held by column
+	SIType type;              // values type: T_INT64, T_DOUBLE or T_BOOL
+	uint64_t len;             // number of slots
+	uint64_t *covered;        // bitmap, slot represents node's value
+	uint64_t *nulls;          // bitmap, node is missing the attribute
+	union {
+		int64_t *longs;       // T_INT64 and T_BOOL values
+		double *doubles;      // T_DOUBLE values
+	};
+	size_t memory;            // number of bytes held by column
+	uint64_t last_used;       // store's clock at column's last fetch
+	int ref_count;            // number of references to column
+	bool built;               // column is populated
+	pthread_mutex_t build;    // held while column is being built
+} Column;
+
+typedef struct {
+	rax *columns;             // (label, attribute) to column
+	size_t memory;            // number of bytes held by columns
+	uint64_t clock;           // incremented on every column fetch
+	pthread_mutex_t lock;     // protects columns, not held while building
+} ColumnStore;
+
+// binding of a property access to a label's column
+// set as the private data of the property function
+typedef struct {
+	LabelID label;            // label of accessed nodes
+	Column *column;           // [optional] column in use
+	uint64_t version;         // graph version column was fetched at
+	bool exceeded;            // column exceeded the store's capacity
+	uint64_t exceeded_at;     // graph version at which capacity was exceeded
+} ColumnBinding;
+
+// create a new, empty columnar store
+ColumnStore *ColumnStore_New(void);
+
+// returns the column of 'attr' for nodes labeled 'label'
+// building the column if it is missing
+// the caller must hold either the graph's read lock or be the only writer
+// returns NULL if the column exceeds the store's memory capacity
+// the returned column must be released via Column_Release
+Column *ColumnStore_GetColumn
+(
+	ColumnStore *store,       // columnar store
+	Graph *g,                 // graph
+	LabelID label,            // label
+	Attribute_ID attr         // attribute
+);
+
+// drops the column of 'attr' for nodes labeled 'label'
+// all of label's columns are dropped if 'attr' is ATTRIBUTE_ID_ALL
+// called by writers, expecting the graph's write lock to be held
+void ColumnStore_Invalidate
+(
+	ColumnStore *store,       // columnar store
+	LabelID label,            // label
+	Attribute_ID attr         // attribute
+);
+
+// drops the columns of 'attr' for all of node's labels
+// see ColumnStore_Invalidate
+void ColumnStore_InvalidateNode
+(
+	ColumnStore *store,       // columnar store
+	Graph *g,                 // graph
+	const Node *n,            // modified node
+	Attribute_ID attr         // attribute
+);
+
+// evict least recently used columns until the store holds
+// at most 'capacity' bytes
+void ColumnStore_Evict
+(
+	ColumnStore *store,       // columnar store
+	size_t capacity           // max number of bytes to retain
+);
+
+// drop all columns
+void ColumnStore_Clear
+(
+	ColumnStore *store        // columnar store
+);
+
+// report the number of columns held by the store and their memory in bytes
+void ColumnStore_GetStats
+(
+	ColumnStore *store,       // columnar store
+	uint64_t *column_count,   // [output] number of columns
+	size_t *memory            // [output] number of bytes held by columns
+);
+
+// free columnar store
+void ColumnStore_Free
+(
+	ColumnStore *store        // columnar store
+);
+
+// release a reference to column
+void Column_Release
+(
+	Column *c                 // column to release
+);
+
+// read node's value from column
+// returns false if the column doesn't cover the node
+static inline bool Column_Get
+(
+	const Column *c,          // column
+	NodeID id,                // node to read
+	SIValue *v                // [output] node's value
+) {
+	if(id >= c->len) return false;
+
+	uint64_t word = id >> 6;
+	uint64_t bit  = 1ULL << (id & 63);
+	if(!(c->covered[word] & bit)) return false;
+
+	if(c->nulls[word] & bit) {
+		*v = SI_NullVal();
+	} else if(c->type == T_DOUBLE) {
+		*v = SI_DoubleVal(c->doubles[id]);
+	} else if(c->type == T_BOOL) {
+		*v = SI_BoolVal(c->longs[id]);
+	} else {
+		*v = SI_LongVal(c->longs[id]);
+	}
+
+	return true;
+}
+
+// create a new binding to label's columns
+ColumnBinding *ColumnBinding_New
+(
+	LabelID label             // label of accessed nodes
+);
+
+// read node's attribute through binding
+// returns false if the value must be read from the node's attribute-set
+bool ColumnBinding_Read
+(
+	ColumnBinding *b,         // binding
+	ColumnStore *store,       // columnar store
+	Graph *g,                 // graph
+	Attribute_ID attr,        // attribute to read
+	NodeID id,                // node to read
+	SIValue *v                // [output] node's value
+);
+
+// clone binding, the clone doesn't share the bound column
+void *ColumnBinding_Clone
+(
+	void *orig                // binding to clone
+);
+
+// free binding
+void ColumnBinding_Free
+(
+	void *b                   // binding to free
+);
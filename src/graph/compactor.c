@@ -0,0 +1,304 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "compactor.h"
+#include "../globals.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../util/simple_timer.h"
+#include "../configuration/config.h"
+
+#include <time.h>
+#include <pthread.h>
+
+#define COMPACTOR_MIN_INTERVAL 10    // minimal wake up interval in ms
+#define COMPACTOR_MAX_INTERVAL 1000  // maximal wake up interval in ms
+
+// a matrix is considered under pressure once its number of pending changes
+// reaches DELTA_MAX_PENDING_CHANGES / COMPACTOR_PRESSURE_FACTOR
+// compacting ahead of the query path threshold
+#define COMPACTOR_PRESSURE_FACTOR 2
+
+extern uint aux_field_counter;
+
+// matrix to compact
+typedef struct {
+	RG_Matrix C;        // matrix to compact
+	GrB_Matrix M;       // compacted main matrix
+	GrB_Matrix TM;      // compacted transposed main matrix
+	GrB_Index pending;  // number of pending changes folded
+	uint64_t gen;       // generation of C when compacted
+	uint64_t tgen;      // generation of C's transpose when compacted
+} CompactionTask;
+
+typedef struct {
+	pthread_t t;           // worker thread handel
+	pthread_mutex_t lock;  // guards stats
+	CompactorStats stats;  // compactor statistics
+} Compactor;
+
+static Compactor *compactor = NULL;
+
+// compute compacted version of M if it is under pressure
+// returns true if a compaction task was added
+static bool _Compactor_Prepare
+(
+	RG_Matrix M,             // matrix to inspect
+	GrB_Index threshold,     // pressure threshold
+	CompactionTask **tasks   // [output] compaction tasks
+) {
+	ASSERT(M     != NULL);
+	ASSERT(tasks != NULL);
+
+	GrB_Index      pending;
+	CompactionTask task;
+	RG_Matrix      TM    = RG_Matrix_getTranspose(M);
+	bool           added = false;
+
+	// guard against readers synchronizing (resizing / flushing) M
+	RG_Matrix_Lock(M);
+
+	// matrix modified since it was synchronized, skip
+	if(RG_Matrix_isDirty(M)) goto cleanup;
+
+	RG_Matrix_pendingChanges(&pending, M);
+	if(pending < threshold) goto cleanup;
+
+	task = (CompactionTask){.C = M, .M = NULL, .TM = NULL, .pending = pending,
+		.gen = RG_Matrix_generation(M),
+		.tgen = (TM != NULL) ? RG_Matrix_generation(TM) : 0};
+
+	RG_Matrix_compact(&task.M, M);
+	if(TM != NULL) {
+		RG_Matrix_compact(&task.TM, TM);
+	}
+
+	array_append(*tasks, task);
+	added = true;
+
+cleanup:
+	RG_Matrix_Unlock(M);
+	return added;
+}
+
+// discard compaction task
+static void _Compactor_DiscardTask
+(
+	CompactionTask *task
+) {
+	if(task->M  != NULL) GrB_Matrix_free(&task->M);
+	if(task->TM != NULL) GrB_Matrix_free(&task->TM);
+}
+
+// compact graph matrices under pressure
+// returns true if any matrix was compacted
+static bool _Compactor_CompactGraph
+(
+	GraphContext *gc,     // graph to compact
+	GrB_Index threshold,  // pressure threshold
+	CompactorStats *run   // [output] current run statistics
+) {
+	ASSERT(gc != NULL);
+
+	Graph *g = GraphContext_GetGraph(gc);
+	CompactionTask *tasks = array_new(CompactionTask, 0);
+
+	//--------------------------------------------------------------------------
+	// phase 1: compute compacted matrices under read lock
+	//--------------------------------------------------------------------------
+
+	Graph_AcquireReadLock(g);
+
+	// graph is being loaded or bulk inserted into, skip
+	if(Graph_GetMatrixPolicy(g) != SYNC_POLICY_FLUSH_RESIZE) {
+		Graph_ReleaseLock(g);
+		array_free(tasks);
+		return false;
+	}
+
+	// matrices are retrieved via the graph's getters which synchronize
+	// them just as any reader would
+	_Compactor_Prepare(Graph_GetAdjacencyMatrix(g, false), threshold, &tasks);
+	_Compactor_Prepare(Graph_GetNodeLabelMatrix(g), threshold, &tasks);
+
+	uint n = Graph_LabelTypeCount(g);
+	for(uint i = 0; i < n; i++) {
+		_Compactor_Prepare(Graph_GetLabelMatrix(g, i), threshold, &tasks);
+	}
+
+	n = Graph_RelationTypeCount(g);
+	for(uint i = 0; i < n; i++) {
+		_Compactor_Prepare(Graph_GetRelationMatrix(g, i, false), threshold,
+				&tasks);
+	}
+
+	Graph_ReleaseLock(g);
+
+	n = array_len(tasks);
+	if(n == 0) {
+		array_free(tasks);
+		return false;
+	}
+
+	//--------------------------------------------------------------------------
+	// phase 2: swap compacted matrices under write lock
+	//--------------------------------------------------------------------------
+
+	Graph_AcquireWriteLock(g);
+
+	uint compacted = 0;
+	for(uint i = 0; i < n; i++) {
+		CompactionTask *task = tasks + i;
+		RG_Matrix TM = RG_Matrix_getTranspose(task->C);
+
+		// matrix was modified while it was compacted, discard
+		// modifications to other matrices do not affect this one
+		if(RG_Matrix_generation(task->C) != task->gen ||
+		   (TM != NULL && RG_Matrix_generation(TM) != task->tgen)) {
+			_Compactor_DiscardTask(task);
+			continue;
+		}
+
+		RG_Matrix_swap(task->C, &task->M);
+		if(task->TM != NULL) RG_Matrix_swap(TM, &task->TM);
+
+		run->folded_changes += task->pending;
+		compacted++;
+	}
+
+	Graph_ReleaseLock(g);
+
+	run->compactions += compacted;
+	run->aborted     += n - compacted;
+
+	array_free(tasks);
+	return compacted > 0;
+}
+
+// compactor main loop
+// this function executes on the compactor's worker thread
+static void *_Compactor_Run
+(
+	void *arg
+) {
+	// wake up interval, only modified by this thread
+	uint32_t interval = COMPACTOR_MAX_INTERVAL;
+
+	while(true) {
+		// sleep until next run
+		struct timespec ts = {
+			.tv_sec  = interval / 1000,
+			.tv_nsec = (interval % 1000) * 1000000
+		};
+		nanosleep(&ts, NULL);
+
+		// graphs are being loaded, wait for loading to complete
+		if(aux_field_counter > 0) continue;
+
+		int64_t delta_max_pending_changes;
+		Config_Option_get(Config_DELTA_MAX_PENDING_CHANGES,
+				&delta_max_pending_changes);
+
+		GrB_Index threshold =
+			delta_max_pending_changes / COMPACTOR_PRESSURE_FACTOR;
+		threshold = (threshold > 0) ? threshold : 1;
+
+		simple_timer_t timer;
+		simple_tic(timer);
+
+		bool compacted = false;
+		GraphContext *gc = NULL;
+		CompactorStats run = {0};
+		KeySpaceGraphIterator it;
+		Globals_ScanGraphs(&it);
+
+		while((gc = GraphIterator_Next(&it)) != NULL) {
+			compacted |= _Compactor_CompactGraph(gc, threshold, &run);
+			GraphContext_DecreaseRefCount(gc);
+		}
+
+		// determine next run
+		if(compacted) {
+			// under pressure, reduce interval
+			interval = (COMPACTOR_MIN_INTERVAL + interval) / 2;
+		} else {
+			// no pressure, increase interval
+			interval = (COMPACTOR_MAX_INTERVAL + interval) / 2;
+		}
+
+		// publish run statistics at once
+		// readers never observe a partially accounted run
+		pthread_mutex_lock(&compactor->lock);
+
+		compactor->stats.runs++;
+		compactor->stats.compactions    += run.compactions;
+		compactor->stats.aborted        += run.aborted;
+		compactor->stats.folded_changes += run.folded_changes;
+		compactor->stats.time_us        +=
+			TIMER_GET_ELAPSED_MILLISECONDS(timer) * 1000;
+		compactor->stats.interval = interval;
+
+		pthread_mutex_unlock(&compactor->lock);
+	}
+
+	return NULL;
+}
+
+// initialize compactor
+// create compactor worker thread
+bool Compactor_Init(void) {
+	ASSERT(compactor == NULL);
+
+	compactor = rm_calloc(1, sizeof(Compactor));
+	compactor->stats.interval = COMPACTOR_MAX_INTERVAL;
+
+	int res = pthread_mutex_init(&compactor->lock, NULL);
+	if(res != 0) {
+		rm_free(compactor);
+		compactor = NULL;
+		return false;
+	}
+
+	// create worker thread
+	pthread_attr_t attr;
+	res = pthread_attr_init(&attr);
+	if(res != 0) {
+		goto cleanup;
+	}
+
+	res = pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+	if(res == 0) {
+		res = pthread_create(&compactor->t, &attr, _Compactor_Run, NULL);
+	}
+
+	pthread_attr_destroy(&attr);
+
+	if(res == 0) {
+		return true;
+	}
+
+cleanup:
+	pthread_mutex_destroy(&compactor->lock);
+	rm_free(compactor);
+	compactor = NULL;
+
+	return false;
+}
+
+// retrieve compactor statistics
+void Compactor_GetStats
+(
+	CompactorStats *stats  // [output] compactor statistics
+) {
+	ASSERT(stats     != NULL);
+	ASSERT(compactor != NULL);
+
+	// statistics are published once per run, copy a consistent snapshot
+	pthread_mutex_lock(&compactor->lock);
+	*stats = compactor->stats;
+	pthread_mutex_unlock(&compactor->lock);
+}
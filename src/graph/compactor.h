@@ -0,0 +1,46 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Compactor folds pending changes (delta-plus & delta-minus) of graph matrices
+// into their main matrix on a dedicated background thread
+// in the system there's a single instance of it, initialized on module init
+//
+// without it, pending changes are merged by whichever query happens to trip
+// the DELTA_MAX_PENDING_CHANGES threshold, stalling that query
+//
+// compaction is performed in two phases:
+// 1. under the graph's READ lock a compacted copy of each matrix under
+//    pressure is computed, readers are free to run concurrently
+// 2. under the graph's WRITE lock the compacted copies are swapped in,
+//    a copy is discarded only if its own matrix was modified in between
+//    (matrix generation advanced), copies of untouched matrices are kept
+//
+// the compactor wakes up periodically, the interval between two consecutive
+// runs shrinks while matrices are under pressure and grows otherwise
+
+// compactor statistics
+typedef struct {
+	uint64_t runs;            // number of compaction runs
+	uint64_t compactions;     // number of compacted matrices
+	uint64_t aborted;         // compactions discarded due to a concurrent write
+	uint64_t folded_changes;  // number of pending changes folded
+	uint64_t time_us;         // accumulated compaction time in microseconds
+	uint32_t interval;        // current wake up interval in milliseconds
+} CompactorStats;
+
+// initialize compactor
+bool Compactor_Init(void);
+
+// retrieve compactor statistics
+void Compactor_GetStats
+(
+	CompactorStats *stats  // [output] compactor statistics
+);
@@ -207,6 +207,9 @@ void AttributeSet_AddNoClone
 		Attribute *attr = attrs + i;
 		attr->id    = ids[i];
 		attr->value = values[i];
+
+		// intern owned strings, releasing the original allocation
+		SIValue_Intern(&attr->value);
 	}
 
 	// update pointer
@@ -239,7 +242,7 @@ void AttributeSet_Add
 	// set attribute
 	Attribute *attr = _set->attributes + _set->attr_count - 1;
 	attr->id = attr_id;
-	attr->value = SI_CloneValue(value);
+	attr->value = SI_InternValue(value);
 
 	// update pointer
 	*set = _set;
@@ -290,7 +293,7 @@ AttributeSetChangeType AttributeSet_Set_Allow_Null
 	// set attribute
 	Attribute *attr = _set->attributes + _set->attr_count - 1;
 	attr->id = attr_id;
-	attr->value = SI_CloneValue(value);
+	attr->value = SI_InternValue(value);
 
 	// update pointer
 	*set = _set;
@@ -364,7 +367,7 @@ bool AttributeSet_Update
 
 	// value != current, update entity
 	SIValue_Free(*current);  // free previous value
-	*current = SI_CloneValue(value);
+	*current = SI_InternValue(value);
 
 	return true;
 }
@@ -394,6 +397,19 @@ AttributeSet AttributeSet_ShallowClone
     return clone;
 }
 
+// persists a single attribute value
+static inline void _AttributeSet_PersistValue
+(
+	SIValue *v  // value to persist
+) {
+	// volatile strings are interned rather than duplicated
+	if(SI_TYPE(*v) == T_STRING && SI_ALLOCATION(v) == M_VOLATILE) {
+		*v = SI_InternValue(*v);
+	} else {
+		SIValue_Persist(v);
+	}
+}
+
 // persists all attributes within given set
 void AttributeSet_PersistValues
 (
@@ -405,10 +421,78 @@ void AttributeSet_PersistValues
 	if(set == NULL) return;
 
 	for (uint16_t i = 0; i < set->attr_count; ++i) {
-		Attribute *attr = set->attributes + i;
+		_AttributeSet_PersistValue(&set->attributes[i].value);
+	}
+}
 
-		SIValue_Persist(&attr->value);
+// checks if 'v' is the same value as 'original'
+// values shared by a shallow clone refer to the original's allocation
+static inline bool _AttributeSet_SameValue
+(
+	SIValue original,  // original value
+	SIValue v          // value to compare
+) {
+	if(SI_TYPE(original) != SI_TYPE(v)) return false;
+
+	if(SI_ALLOCATION(&v) == M_VOLATILE) return original.ptrval == v.ptrval;
+
+	return SIValue_Compare(original, v, NULL) == 0;
+}
+
+void AttributeSet_Replace
+(
+	AttributeSet *set,        // set to replace
+	AttributeSet update,      // replacing set
+	AttributeSetChangeCB cb,  // invoked for each modified attribute
+	void *pdata               // callback private data
+) {
+	ASSERT(set != NULL);
+	ASSERT(ATTRIBUTE_SET_IS_READONLY(*set)   == false);
+	ASSERT(ATTRIBUTE_SET_IS_READONLY(update) == false);
+
+	AttributeSet original = *set;
+	uint16_t attr_count = (update == NULL) ? 0 : update->attr_count;
+
+	for(uint16_t i = 0; i < attr_count; i++) {
+		Attribute *attr = update->attributes + i;
+		SIValue *v = AttributeSet_Get(original, attr->id);
+
+		if(v != ATTRIBUTE_NOTFOUND && _AttributeSet_SameValue(*v, attr->value)) {
+			// attribute is unchanged, carry over the original value
+			SIValue_Free(attr->value);
+			attr->value = *v;
+			*v = SI_NullVal();
+			continue;
+		}
+
+		// attribute added or modified
+		_AttributeSet_PersistValue(&attr->value);
+
+		SIValue prev = SI_NullVal();
+		if(v != ATTRIBUTE_NOTFOUND) {
+			prev = *v;
+			*v = SI_NullVal();
+		}
+
+		if(cb != NULL) cb(attr->id, prev, pdata);
+		else SIValue_Free(prev);
+	}
+
+	// attributes removed by the update
+	// attribute values are never NULL, consumed values were nullified
+	if(original != NULL) {
+		for(uint16_t i = 0; i < original->attr_count; i++) {
+			Attribute *attr = original->attributes + i;
+			if(SIValue_IsNull(attr->value)) continue;
+
+			if(cb != NULL) cb(attr->id, attr->value, pdata);
+			else SIValue_Free(attr->value);
+		}
+
+		rm_free(original);
 	}
+
+	*set = update;
 }
 
 // free attribute set
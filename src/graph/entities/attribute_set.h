@@ -43,6 +43,17 @@ typedef struct {
 
 typedef _AttributeSet* AttributeSet;
 
+// invoked for each attribute modified by AttributeSet_Replace
+// 'original' is the attribute's value prior to the modification
+// or NULL if the attribute was added, ownership over 'original' is passed
+// to the callback
+typedef void (*AttributeSetChangeCB)
+(
+	Attribute_ID id,   // modified attribute
+	SIValue original,  // original value
+	void *pdata        // private data
+);
+
 // returns number of attributes within the set
 uint16_t AttributeSet_Count
 (
@@ -124,6 +135,20 @@ void AttributeSet_PersistValues
 	const AttributeSet set  // set to persist
 );
 
+// replaces 'set' with 'update'
+// 'update' is expected to be a shallow clone of 'set' to which modifications
+// were applied, values shared between the two sets are carried over from
+// 'set' rather than duplicated, modified values are persisted
+// 'cb' is invoked for every added, modified or removed attribute
+// original values are freed if 'cb' is NULL
+void AttributeSet_Replace
+(
+	AttributeSet *set,        // set to replace
+	AttributeSet update,      // replacing set
+	AttributeSetChangeCB cb,  // invoked for each modified attribute
+	void *pdata               // callback private data
+);
+
 // free attribute set
 void AttributeSet_Free
 (
@@ -16,6 +16,9 @@
 //------------------------------------------------------------------------------
 void _MatrixResizeToCapacity(const Graph *g, RG_Matrix m);
 
+// minimum number of connections for a relation matrix to be built at once
+#define BUILD_CONNECTIONS_THRESHOLD 1024
+
 //------------------------------------------------------------------------------
 // Synchronization functions
 //------------------------------------------------------------------------------
@@ -82,10 +85,25 @@ void Graph_ReleaseLock
 	// for a reader thread to be considered as writer, performing illegal access to
 	// underline matrices, consider a context switch after unlocking `_rwlock` but
 	// before setting `_writelocked` to false
+	if(g->_writelocked) {
+		// publish a new version before letting readers in
+		__atomic_add_fetch(&g->version, 1, __ATOMIC_RELEASE);
+	}
+
 	g->_writelocked = false;
 	pthread_rwlock_unlock(&g->_rwlock);
 }
 
+// returns the graph's committed version
+uint64_t Graph_GetVersion
+(
+	const Graph *g
+) {
+	ASSERT(g != NULL);
+
+	return __atomic_load_n(&g->version, __ATOMIC_ACQUIRE);
+}
+
 //------------------------------------------------------------------------------
 // Graph utility functions
 //------------------------------------------------------------------------------
@@ -98,6 +116,7 @@ static inline size_t _Graph_NodeCap(const Graph *g) {
 static void _CollectEdgesFromEntry
 (
 	const Graph *g,
+	const RG_Matrix M,
 	NodeID src,
 	NodeID dest,
 	RelationID r,
@@ -117,9 +136,9 @@ static void _CollectEdgesFromEntry
 		array_append(*edges, e);
 	} else {
 		// multiple edges connecting src to dest,
-		// entry is a pointer to an array of edge IDs
-		EdgeID *edgeIds = (EdgeID *)(CLEAR_MSB(edgeId));
-		uint edgeCount = array_len(edgeIds);
+		// entry references a contiguous list of edge IDs
+		uint32_t edgeCount;
+		const EdgeID *edgeIds = RG_Matrix_multiEdge(M, edgeId, &edgeCount);
 
 		for(uint i = 0; i < edgeCount; i++) {
 			edgeId       = edgeIds[i];
@@ -154,7 +173,7 @@ void _Graph_GetEdgesConnectingNodes
 	// no entry at [dest, src], src is not connected to dest with relation R
 	if(res == GrB_NO_VALUE) return;
 
-	_CollectEdgesFromEntry(g, src, dest, r, id, edges);
+	_CollectEdgesFromEntry(g, M, src, dest, r, id, edges);
 }
 
 static inline AttributeSet *_Graph_GetEntity(const DataBlock *entities, EntityID id) {
@@ -601,9 +620,9 @@ RelationID Graph_GetEdgeRelation
 		} else {
 			// multiple edges exists between src and dest
 			// see if given edge is one of them
-			EdgeID *edges = (EdgeID *)(CLEAR_MSB(edgeId));
-			int edge_count = array_len(edges);
-			for(int j = 0; j < edge_count; j++) {
+			uint32_t edge_count;
+			const EdgeID *edges = RG_Matrix_multiEdge(M, edgeId, &edge_count);
+			for(uint32_t j = 0; j < edge_count; j++) {
 				if(edges[j] == id) {
 					Edge_SetRelationID(e, i);
 					rel = i;
@@ -823,6 +842,59 @@ bool Graph_FormConnection
 	return true;
 }
 
+void Graph_RemoveConnection
+(
+	Graph *g,
+	NodeID src,
+	NodeID dest,
+	EdgeID edge_id,
+	RelationID r
+) {
+	ASSERT(g != NULL);
+
+	uint64_t    x;
+	RG_Matrix   M;
+	GrB_Info    info;
+	bool        entry_deleted;
+
+	UNUSED(info);
+
+	// an edge of type r has just been deleted, update statistics
+	GraphStatistics_DecEdgeCount(&g->stats, r, 1);
+
+	RG_Matrix R = Graph_GetRelationMatrix(g, r, false);
+
+	// single edge of type R connecting src to dest, delete entry
+	info = RG_Matrix_removeEntry_UINT64(R, src, dest, edge_id, &entry_deleted);
+	ASSERT(info == GrB_SUCCESS);
+
+	if(entry_deleted) {
+		// TODO: consider making ADJ UINT64_T where ADJ[i,j] = #connections
+		// drop the entry once it reaches 0
+		//
+		// see if source is connected to destination with additional edges
+		bool connected = false;
+		int relationCount = Graph_RelationTypeCount(g);
+		for(int i = 0; i < relationCount; i++) {
+			if(i == r) continue;
+			M = Graph_GetRelationMatrix(g, i, false);
+			info = RG_Matrix_extractElement_UINT64(&x, M, src, dest);
+			if(info == GrB_SUCCESS) {
+				connected = true;
+				break;
+			}
+		}
+
+		// there are no additional edges connecting source to destination
+		// remove edge from THE adjacency matrix
+		if(!connected) {
+			M = Graph_GetAdjacencyMatrix(g, false);
+			info = RG_Matrix_removeElement_BOOL(M, src, dest);
+			ASSERT(info == GrB_SUCCESS);
+		}
+	}
+}
+
 void Graph_CreateEdge
 (
 	Graph *g,
@@ -854,6 +926,159 @@ void Graph_CreateEdge
 	Graph_FormConnection(g, src, dest, id, r);
 }
 
+// connection sort order: source, destination, edge ID
+static int _ConnectionCmp
+(
+	const void *a,
+	const void *b
+) {
+	const Edge *x = *(const Edge **)a;
+	const Edge *y = *(const Edge **)b;
+
+	if(x->src_id  != y->src_id)  return (x->src_id  < y->src_id)  ? -1 : 1;
+	if(x->dest_id != y->dest_id) return (x->dest_id < y->dest_id) ? -1 : 1;
+	if(x->id      != y->id)      return (x->id      < y->id)      ? -1 : 1;
+	return 0;
+}
+
+// builds an empty relation matrix out of 'n' connections
+// along with its transpose, the adjacency matrix is updated accordingly
+static void _Graph_BuildConnections
+(
+	Graph *g,       // graph on which to operate
+	RelationID r,   // relation to build
+	Edge **edges,   // edges to connect, sorted by _ConnectionCmp
+	uint64_t n      // number of edges
+) {
+	GrB_Info  info;
+	GrB_Index dim;
+	uint64_t  nvals = 0;
+	RG_Matrix R     = Graph_GetRelationMatrix(g, r, false);
+	RG_Matrix adj   = Graph_GetAdjacencyMatrix(g, false);
+	GrB_Index *I    = rm_malloc(sizeof(GrB_Index) * n);
+	GrB_Index *J    = rm_malloc(sizeof(GrB_Index) * n);
+	uint64_t  *X    = rm_malloc(sizeof(uint64_t) * n);
+	UNUSED(info);
+
+	// edges sharing both source and destination form a single entry
+	// multi-edges are collected into a list, as such no duplicates are left
+	// for GrB_Matrix_build to resolve
+	for(uint64_t i = 0; i < n;) {
+		uint64_t j = i + 1;
+		while(j < n && edges[j]->src_id == edges[i]->src_id &&
+				edges[j]->dest_id == edges[i]->dest_id) j++;
+
+		I[nvals] = edges[i]->src_id;
+		J[nvals] = edges[i]->dest_id;
+
+		if(j - i == 1) {
+			X[nvals] = edges[i]->id;
+		} else {
+			uint64_t list = MultiEdgePool_NewList(R->multi_edges, edges[i]->id,
+					edges[i + 1]->id);
+			for(uint64_t k = i + 2; k < j; k++) {
+				MultiEdgePool_Append(R->multi_edges, list, edges[k]->id);
+			}
+			X[nvals] = SET_MSB(list);
+		}
+
+		nvals++;
+		i = j;
+	}
+
+	// matrices are written to directly, flush pending changes
+	// R holds no entries, flushing it clears pending deletions
+	RG_Matrix_wait(R, true);
+	RG_Matrix_wait(adj, true);
+
+	GrB_Matrix m      = RG_MATRIX_M(R);
+	GrB_Matrix tm     = RG_MATRIX_TM(R);
+	GrB_Matrix adj_m  = RG_MATRIX_M(adj);
+	GrB_Matrix adj_tm = RG_MATRIX_TM(adj);
+
+	info = GrB_Matrix_build_UINT64(m, I, J, X, nvals, GrB_FIRST_UINT64);
+	ASSERT(info == GrB_SUCCESS);
+
+	// transposed matrices only track connections, values are irrelevant
+	info = GrB_Matrix_apply(tm, NULL, NULL, GxB_ONE_BOOL, m, GrB_DESC_T0);
+	ASSERT(info == GrB_SUCCESS);
+
+	// adj<R> = true
+	// the structural mask avoids casting edge ID 0 to false
+	info = GrB_Matrix_nrows(&dim, adj_m);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_assign_BOOL(adj_m, m, NULL, true, GrB_ALL, dim, GrB_ALL,
+			dim, GrB_DESC_S);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_assign_BOOL(adj_tm, tm, NULL, true, GrB_ALL, dim,
+			GrB_ALL, dim, GrB_DESC_S);
+	ASSERT(info == GrB_SUCCESS);
+
+	// matrices were written to directly, advance their generation
+	RG_Matrix_setDirty(R);
+	RG_Matrix_setDirty(adj);
+
+	GraphStatistics_IncEdgeCount(&g->stats, r, n);
+
+	rm_free(I);
+	rm_free(J);
+	rm_free(X);
+}
+
+void Graph_CreateEdges
+(
+	Graph *g,
+	Edge **edges,
+	uint64_t n
+) {
+	ASSERT(g     != NULL);
+	ASSERT(edges != NULL);
+
+	// allocate edges in order
+	for(uint64_t i = 0; i < n; i++) {
+		Edge *e = edges[i];
+		ASSERT(e->relationID < Graph_RelationTypeCount(g));
+
+		AttributeSet *set = DataBlock_AllocateItem(g->edges, &e->id);
+		*set = NULL;
+		e->attributes = set;
+	}
+
+	// group edges by relationship-type
+	uint relation_count = Graph_RelationTypeCount(g);
+	uint64_t counts[relation_count];
+	memset(counts, 0, sizeof(counts));
+	for(uint64_t i = 0; i < n; i++) counts[edges[i]->relationID]++;
+
+	Edge **group = rm_malloc(sizeof(Edge *) * n);
+
+	for(RelationID r = 0; r < relation_count; r++) {
+		if(counts[r] == 0) continue;
+
+		uint64_t k = 0;
+		for(uint64_t i = 0; i < n; i++) {
+			if(edges[i]->relationID == r) group[k++] = edges[i];
+		}
+
+		// build empty relations at once
+		GrB_Index nvals;
+		RG_Matrix R = Graph_GetRelationMatrix(g, r, false);
+		RG_Matrix_nvals(&nvals, R);
+		if(k >= BUILD_CONNECTIONS_THRESHOLD && nvals == 0) {
+			qsort(group, k, sizeof(Edge *), _ConnectionCmp);
+			_Graph_BuildConnections(g, r, group, k);
+			continue;
+		}
+
+		for(uint64_t i = 0; i < k; i++) {
+			Edge *e = group[i];
+			Graph_FormConnection(g, e->src_id, e->dest_id, e->id, r);
+		}
+	}
+
+	rm_free(group);
+}
+
 // retrieves all either incoming or outgoing edges
 // to/from given node N, depending on given direction
 void Graph_GetNodeEdges
@@ -901,7 +1126,7 @@ void Graph_GetNodeEdges
 		if(t == GrB_UINT64) {
 			while(RG_MatrixTupleIter_next_UINT64(&it, NULL, &destID, &edgeID) == GrB_SUCCESS) {
 				// collect all edges (src)->(dest)
-				_CollectEdgesFromEntry(g, srcID, destID, edgeType, edgeID, edges);
+				_CollectEdgesFromEntry(g, M, srcID, destID, edgeType, edgeID, edges);
 			}
 		} else {
 			while(RG_MatrixTupleIter_next_BOOL(&it, NULL, &destID, NULL) == GrB_SUCCESS) {
@@ -930,7 +1155,7 @@ void Graph_GetNodeEdges
 				RG_Matrix_extractElement_UINT64(&edgeID, M, destID, srcID);
 				if(dir == GRAPH_EDGE_DIR_BOTH && srcID == destID) continue;
 				// collect all edges connecting destId to srcId
-				_CollectEdgesFromEntry(g, destID, srcID, edgeType, edgeID, edges);
+				_CollectEdgesFromEntry(g, M, destID, srcID, edgeType, edgeID, edges);
 			}
 		} else {
 			while(RG_MatrixTupleIter_next_BOOL(&it, NULL, &destID, NULL) == GrB_SUCCESS) {
@@ -1007,9 +1232,10 @@ uint64_t Graph_GetNodeDegree
 					edge_count++;
 				} else {
 					// multiple edges connecting src to dest
-					// entry is a pointer to an array of edge IDs
-					EdgeID *multi_edge = (EdgeID *)(CLEAR_MSB(edgeID));
-					edge_count += array_len(multi_edge);
+					// entry references a list of edge IDs
+					uint32_t n;
+					RG_Matrix_multiEdge(M, edgeID, &n);
+					edge_count += n;
 				}
 			}
 			RG_MatrixTupleIter_detach(&it);
@@ -1035,9 +1261,10 @@ uint64_t Graph_GetNodeDegree
 					edge_count++;
 				} else {
 					// multiple edges connecting src to dest
-					// entry is a pointer to an array of edge IDs
-					EdgeID *multi_edge = (EdgeID *)(CLEAR_MSB(edgeID));
-					edge_count += array_len(multi_edge);
+					// entry references a list of edge IDs
+					uint32_t n;
+					RG_Matrix_multiEdge(M, edgeID, &n);
+					edge_count += n;
 				}
 			}
 			RG_MatrixTupleIter_detach(&it);
@@ -1097,56 +1324,15 @@ void Graph_DeleteEdges
 	ASSERT(n > 0);
 	ASSERT(edges != NULL);
 
-	uint64_t    x;
-	RG_Matrix   R;
-	RG_Matrix   M;
-	GrB_Info    info;
-	bool        entry_deleted;
-
 	MATRIX_POLICY policy = Graph_SetMatrixPolicy(g, SYNC_POLICY_NOP);
 
 	for (uint i = 0; i < n; i++) {
-		Edge       *e         =  edges + i;
-		int         r         =  Edge_GetRelationID(e);
-		NodeID      src_id    =  Edge_GetSrcNodeID(e);
-		NodeID      dest_id   =  Edge_GetDestNodeID(e);
+		Edge *e = edges + i;
 
 		ASSERT(!DataBlock_ItemIsDeleted((void *)e->attributes));
 
-		// an edge of type r has just been deleted, update statistics
-		GraphStatistics_DecEdgeCount(&g->stats, r, 1);
-
-		R = Graph_GetRelationMatrix(g, r, false);
-
-		// single edge of type R connecting src to dest, delete entry
-		info = RG_Matrix_removeEntry_UINT64(R, src_id, dest_id, ENTITY_GET_ID(e), &entry_deleted);
-		ASSERT(info == GrB_SUCCESS);
-
-		if(entry_deleted) {
-			// TODO: consider making ADJ UINT64_T where ADJ[i,j] = #connections
-			// drop the entry once it reaches 0
-			//
-			// see if source is connected to destination with additional edges
-			bool connected = false;
-			int relationCount = Graph_RelationTypeCount(g);
-			for(int i = 0; i < relationCount; i++) {
-				if(i == r) continue;
-				M = Graph_GetRelationMatrix(g, i, false);
-				info = RG_Matrix_extractElement_UINT64(&x, M, src_id, dest_id);
-				if(info == GrB_SUCCESS) {
-					connected = true;
-					break;
-				}
-			}
-
-			// there are no additional edges connecting source to destination
-			// remove edge from THE adjacency matrix
-			if(!connected) {
-				M = Graph_GetAdjacencyMatrix(g, false);
-				info = RG_Matrix_removeElement_BOOL(M, src_id, dest_id);
-				ASSERT(info == GrB_SUCCESS);
-			}
-		}
+		Graph_RemoveConnection(g, Edge_GetSrcNodeID(e), Edge_GetDestNodeID(e),
+				ENTITY_GET_ID(e), Edge_GetRelationID(e));
 
 		// free and remove edges from datablock.
 		DataBlock_DeleteItem(g->edges, ENTITY_GET_ID(e));
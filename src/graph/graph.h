@@ -54,6 +54,7 @@ struct Graph {
 	RG_Matrix _zero_matrix;            // zero matrix
 	pthread_rwlock_t _rwlock;          // read-write lock scoped to this specific graph
 	bool _writelocked;                 // true if the read-write lock was acquired by a writer
+	uint64_t version;                  // committed version, advanced by every writer
 	SyncMatrixFunc SynchronizeMatrix;  // function pointer to matrix synchronization routine
 	GraphStatistics stats;             // graph related statistics
 };
@@ -74,11 +75,23 @@ void Graph_AcquireWriteLock
 );
 
 // release the held lock
+// releasing a write lock publishes a new graph version
 void Graph_ReleaseLock
 (
 	Graph *g
 );
 
+// returns the graph's committed version
+// the version is advanced each time a writer releases the graph lock
+// the value is only meaningful to callers holding the read lock
+// two reads under the read lock observing the same version see the same
+// committed state, while the writer holds the lock the graph might already
+// differ from the returned version, which advances once the write completes
+uint64_t Graph_GetVersion
+(
+	const Graph *g
+);
+
 // synchronize and resize all matrices in graph
 void Graph_ApplyAllPending
 (
@@ -209,6 +222,17 @@ void Graph_CreateEdge
 	Edge *e
 );
 
+// creates edges in bulk
+// each edge's source, destination and relationship-type must be set
+// edges are assigned IDs in order, connections to an empty relation are
+// built at once rather than one at a time
+void Graph_CreateEdges
+(
+	Graph *g,       // graph on which to operate
+	Edge **edges,   // edges to create
+	uint64_t n      // number of edges
+);
+
 // deletes nodes from the graph
 void Graph_DeleteNodes
 (
@@ -225,6 +249,102 @@ void Graph_DeleteEdges
 	uint64_t n
 );
 
+//------------------------------------------------------------------------------
+// ID compaction
+//------------------------------------------------------------------------------
+
+// returns true if vacant node IDs reside below the graph's node count
+bool Graph_NodesFragmented
+(
+	const Graph *g
+);
+
+// returns true if vacant edge IDs reside below the graph's edge count
+bool Graph_EdgesFragmented
+(
+	const Graph *g
+);
+
+// collects up to 'n' node IDs positioned beyond the graph's node count
+// in descending order, returns number of collected IDs
+uint64_t Graph_TrailingNodes
+(
+	const Graph *g,  // graph to inspect
+	uint64_t n,      // max number of IDs to collect
+	NodeID *ids      // [output] collected IDs
+);
+
+// collects up to 'n' edges whose ID is beyond the graph's edge count
+// relation matrices are swept starting at relation 'r' row 'row'
+// the sweep pauses once either 'n' edges were collected or 'budget' entries
+// were visited, in which case 'r' and 'row' are updated to resume from
+// returns number of collected edges
+uint64_t Graph_TrailingEdges
+(
+	const Graph *g,   // graph to inspect
+	RelationID *r,    // [input/output] relation to resume sweep from
+	NodeID *row,      // [input/output] row to resume sweep from
+	uint64_t budget,  // max number of entries to visit
+	uint64_t n,       // max number of edges to collect
+	Edge *edges       // [output] collected edges
+);
+
+// moves the attribute-sets of nodes 'src' into vacant IDs at or above 'from'
+// returns number of relocated nodes, new IDs are set in 'dst'
+// each relocated node must be rewired using Graph_RewireNode
+uint64_t Graph_RelocateNodes
+(
+	Graph *g,           // graph to compact
+	uint64_t from,      // lowest vacant ID to fill
+	const NodeID *src,  // nodes to relocate
+	NodeID *dst,        // [output] nodes new IDs
+	uint64_t n          // number of nodes to relocate
+);
+
+// moves the attribute-sets of edges 'src' into vacant IDs at or above 'from'
+// returns number of relocated edges, new IDs are set in 'dst'
+// each relocated edge must be rewired using Graph_RewireEdge
+uint64_t Graph_RelocateEdges
+(
+	Graph *g,           // graph to compact
+	uint64_t from,      // lowest vacant ID to fill
+	const EdgeID *src,  // edges to relocate
+	EdgeID *dst,        // [output] edges new IDs
+	uint64_t n          // number of edges to relocate
+);
+
+// moves the labels and edges of node 'src' over to node 'dst'
+// edges incident to 'src' are appended to 'edges' as they were prior to
+// the move
+void Graph_RewireNode
+(
+	Graph *g,     // graph to operate on
+	NodeID src,   // relocated node old ID
+	NodeID dst,   // relocated node new ID
+	Edge **edges  // [output] rewired edges
+);
+
+// replaces edge 'e' ID within its relation matrix by 'dst'
+void Graph_RewireEdge
+(
+	Graph *g,       // graph to operate on
+	const Edge *e,  // relocated edge, holding its old ID
+	EdgeID dst      // relocated edge new ID
+);
+
+// releases the graph's vacant trailing IDs and shrinks its matrices
+// returns false without modifying the graph if it is fragmented
+bool Graph_Trim
+(
+	Graph *g
+);
+
+// returns number of bytes used by the graph's datablocks and matrices
+size_t Graph_MemoryUsage
+(
+	const Graph *g
+);
+
 // returns true if the given entity has been deleted
 bool Graph_EntityIsDeleted
 (
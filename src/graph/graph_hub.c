@@ -8,18 +8,86 @@
 #include "../query_ctx.h"
 #include "../undo_log/undo_log.h"
 
+// update node under schema indices
+// index changes made by a query are deferred to the query's index buffer
+// and applied in a single batch once the query commits
+static void _IndexNode
+(
+	const Schema *s,     // node schema
+	Node *n,             // modified node
+	IndexChange change,  // type of change
+	bool log             // modification is made by a query
+) {
+	if(!Schema_HasIndices(s)) return;
+
+	if(log) {
+		IndexBuffer_AddNode(QueryCtx_GetIndexBuffer(), s, n, change);
+	} else if(change == INDEX_CHANGE_SET) {
+		Schema_AddNodeToIndices(s, n);
+	} else {
+		Schema_RemoveNodeFromIndices(s, n);
+	}
+}
+
+// update edge under schema indices, see _IndexNode
+static void _IndexEdge
+(
+	const Schema *s,     // edge schema
+	Edge *e,             // modified edge
+	IndexChange change,  // type of change
+	bool log             // modification is made by a query
+) {
+	if(!Schema_HasIndices(s)) return;
+
+	if(log) {
+		IndexBuffer_AddEdge(QueryCtx_GetIndexBuffer(), s, e, change);
+	} else if(change == INDEX_CHANGE_SET) {
+		Schema_AddEdgeToIndices(s, e);
+	} else {
+		Schema_RemoveEdgeFromIndices(s, e);
+	}
+}
+
+// index node created by a query or replicated
+// created nodes aren't indexed yet, a query's nodes are indexed in bulk
+// once the query commits
+static void _IndexNewNode
+(
+	const Schema *s,  // node schema
+	Node *n,          // created node
+	bool log          // node is created by a query
+) {
+	if(!Schema_HasIndices(s)) return;
+
+	if(log) IndexBuffer_AddNewNode(QueryCtx_GetIndexBuffer(), s, n);
+	else Schema_AddNodeToIndices(s, n);
+}
+
+// index created edge, see _IndexNewNode
+static void _IndexNewEdge
+(
+	const Schema *s,  // edge schema
+	Edge *e,          // created edge
+	bool log          // edge is created by a query
+) {
+	if(!Schema_HasIndices(s)) return;
+
+	if(log) IndexBuffer_AddNewEdge(QueryCtx_GetIndexBuffer(), s, e);
+	else Schema_AddEdgeToIndices(s, e);
+}
+
 // delete all references to a node from any relevant index
 static void _DeleteNodeFromIndices
 (
 	GraphContext *gc,
-	Node *n
+	Node *n,
+	bool log
 ) {
 	ASSERT(n  != NULL);
 	ASSERT(gc != NULL);
 
 	Schema   *s      = NULL;
 	Graph    *g      = gc->g;
-	EntityID node_id = ENTITY_GET_ID(n);
 
 	// retrieve node labels
 	uint label_count;
@@ -31,38 +99,38 @@ static void _DeleteNodeFromIndices
 		ASSERT(s != NULL);
 
 		// update any indices this entity is represented in
-		Schema_RemoveNodeFromIndices(s, n);
+		_IndexNode(s, n, INDEX_CHANGE_REMOVE, log);
 	}
 }
 
 static void _DeleteEdgeFromIndices
 (
 	GraphContext *gc,
-	Edge *e
+	Edge *e,
+	bool log
 ) {
 	Schema  *s  =  NULL;
-	Graph   *g  =  gc->g;
 
 	int relation_id = Edge_GetRelationID(e);
 
 	s = GraphContext_GetSchemaByID(gc, relation_id, SCHEMA_EDGE);
 
 	// update any indices this entity is represented in
-	Schema_RemoveEdgeFromIndices(s, e);
+	_IndexEdge(s, e, INDEX_CHANGE_REMOVE, log);
 }
 
 // add node to any relevant index
 static void _AddNodeToIndices
 (
 	GraphContext *gc,
-	Node *n
+	Node *n,
+	bool log
 ) {
 	ASSERT(n  != NULL);
 	ASSERT(gc != NULL);
 
 	Schema    *s       =  NULL;
 	Graph     *g       =  gc->g;
-	EntityID  node_id  =  ENTITY_GET_ID(n);
 
 	// retrieve node labels
 	uint label_count;
@@ -72,21 +140,20 @@ static void _AddNodeToIndices
 		int label_id = labels[i];
 		s = GraphContext_GetSchemaByID(gc, label_id, SCHEMA_NODE);
 		ASSERT(s != NULL);
-		Schema_AddNodeToIndices(s, n);
+		_IndexNode(s, n, INDEX_CHANGE_SET, log);
 	}
 }
 
 // add edge to any relevant index
-static void _AddEdgeToIndices(GraphContext *gc, Edge *e) {
+static void _AddEdgeToIndices(GraphContext *gc, Edge *e, bool log) {
 	Schema  *s  =  NULL;
-	Graph   *g  =  gc->g;
 
 	int relation_id = Edge_GetRelationID(e);
 
 	s = GraphContext_GetSchemaByID(gc, relation_id, SCHEMA_EDGE);
 	ASSERT(s != NULL);
 
-	Schema_AddEdgeToIndices(s, e);
+	_IndexEdge(s, e, INDEX_CHANGE_SET, log);
 }
 
 void CreateNode
@@ -108,7 +175,7 @@ void CreateNode
 	for(uint i = 0; i < label_count; i++) {
 		Schema *s = GraphContext_GetSchemaByID(gc, labels[i], SCHEMA_NODE);
 		ASSERT(s);
-		Schema_AddNodeToIndices(s, n);
+		_IndexNewNode(s, n, log);
 	}
 
 	// add node creation operation to undo log
@@ -139,7 +206,7 @@ void CreateEdge
 	Schema *s = GraphContext_GetSchemaByID(gc, r, SCHEMA_EDGE);
 	// all schemas have been created in the edge blueprint loop or earlier
 	ASSERT(s != NULL);
-	Schema_AddEdgeToIndices(s, e);
+	_IndexNewEdge(s, e, log);
 
 	// add edge creation operation to undo log
 	if(log == true) {
@@ -150,6 +217,38 @@ void CreateEdge
 	}
 }
 
+void CreateEdges
+(
+	GraphContext *gc,
+	Edge **edges,
+	AttributeSet *sets,
+	uint n,
+	bool log
+) {
+	ASSERT(gc    != NULL);
+	ASSERT(sets  != NULL);
+	ASSERT(edges != NULL);
+
+	Graph_CreateEdges(gc->g, edges, n);
+
+	UndoLog undo_log  = (log) ? QueryCtx_GetUndoLog() : NULL;
+	EffectsBuffer *eb = (log) ? QueryCtx_GetEffectsBuffer() : NULL;
+	for(uint i = 0; i < n; i++) {
+		Edge *e = edges[i];
+		*e->attributes = sets[i];
+
+		Schema *s = GraphContext_GetSchemaByID(gc, e->relationID, SCHEMA_EDGE);
+		ASSERT(s != NULL);
+		_IndexNewEdge(s, e, log);
+
+		// add edge creation operation to undo log
+		if(log == true) {
+			UndoLog_CreateEdge(undo_log, e);
+			EffectsBuffer_AddCreateEdgeEffect(eb, e);
+		}
+	}
+}
+
 // delete a node
 // remove the node from the relevant indexes
 // add node deletion operation to undo-log
@@ -178,8 +277,12 @@ void DeleteNodes
 		}
 
 		if(has_indices) {
-			_DeleteNodeFromIndices(gc, n);
+			_DeleteNodeFromIndices(gc, n, log);
 		}
+
+		// node's slot is freed, drop the columns of its labels
+		ColumnStore_InvalidateNode(gc->column_store, gc->g, n,
+				ATTRIBUTE_ID_ALL);
 	}
 
 	Graph_DeleteNodes(gc->g, nodes, n);
@@ -210,7 +313,7 @@ void DeleteEdges
 			}
 
 			if(has_indecise == true) {
-				_DeleteEdgeFromIndices(gc, edges + i);
+				_DeleteEdgeFromIndices(gc, edges + i, log);
 			}
 		}
 	}
@@ -218,6 +321,35 @@ void DeleteEdges
 	Graph_DeleteEdges(gc->g, edges, n);
 }
 
+// private data of _AttributeChange
+typedef struct {
+	GraphContext *gc;  // graph context
+	UndoLog undo_log;  // [optional] undo-log
+	Node *node;        // [optional] updated node
+} AttributeChangeCtx;
+
+// hands an attribute's original value over to the undo-log
+// and drops the columns of the modified node attribute
+static void _AttributeChange
+(
+	Attribute_ID id,   // modified attribute
+	SIValue original,  // original value
+	void *pdata        // attribute change context
+) {
+	AttributeChangeCtx *ctx = (AttributeChangeCtx *)pdata;
+
+	if(ctx->node != NULL) {
+		ColumnStore_InvalidateNode(ctx->gc->column_store, ctx->gc->g,
+				ctx->node, id);
+	}
+
+	if(ctx->undo_log != NULL) {
+		UndoLog_UpdateEntityAttribute(ctx->undo_log, id, original);
+	} else {
+		SIValue_Free(original);
+	}
+}
+
 // updates a graph entity attribute set. Returns as out params the number
 // of properties set and removed.
 void UpdateEntityProperties
@@ -231,19 +363,24 @@ void UpdateEntityProperties
 	ASSERT(gc != NULL);
 	ASSERT(ge != NULL);
 
-	AttributeSet old_set = GraphEntity_GetAttributes(ge);
+	UndoLog undo_log = (log == true) ? QueryCtx_GetUndoLog() : NULL;
+	Node *node = (entity_type == GETYPE_NODE) ? (Node *)ge : NULL;
 
-	if(log == true) {
-		UndoLog log = QueryCtx_GetUndoLog();
-		UndoLog_UpdateEntity(log, ge, old_set, entity_type);
-	}
+	if(undo_log != NULL || node != NULL) {
+		// record only the attributes modified by the update
+		if(undo_log != NULL) UndoLog_UpdateEntity(undo_log, ge, entity_type);
 
-	*ge->attributes = set;
+		AttributeChangeCtx ctx = {.gc = gc, .undo_log = undo_log,
+			.node = node};
+		AttributeSet_Replace(ge->attributes, set, _AttributeChange, &ctx);
+	} else {
+		AttributeSet_Replace(ge->attributes, set, NULL, NULL);
+	}
 
 	if(entity_type == GETYPE_NODE) {
-		_AddNodeToIndices(gc, (Node *)ge);
+		_AddNodeToIndices(gc, (Node *)ge, log);
 	} else {
-		_AddEdgeToIndices(gc, (Edge *)ge);
+		_AddEdgeToIndices(gc, (Edge *)ge, log);
 	}
 }
 
@@ -269,6 +406,8 @@ void UpdateNodeProperty
 		AttributeSet_UpdateNoClone(n.attributes, attr_id, v);
 	}
 
+	ColumnStore_InvalidateNode(gc->column_store, gc->g, &n, attr_id);
+
 	// retrieve node labels
 	uint label_count;
 	NODE_GET_LABELS(gc->g, &n, label_count);
@@ -379,8 +518,11 @@ void UpdateNodeLabels
 				}
 				// append label id
 				add_labels_ids[add_labels_index++] = schema_id;
+				// node joins label, drop label's columns
+				ColumnStore_Invalidate(gc->column_store, schema_id,
+						ATTRIBUTE_ID_ALL);
 				// add to index
-				Schema_AddNodeToIndices(s, node);
+				_IndexNode(s, node, INDEX_CHANGE_SET, log);
 			}
 		}
 
@@ -419,8 +561,11 @@ void UpdateNodeLabels
 
 			// append label id
 			remove_labels_ids[remove_labels_index++] = Schema_GetID(s);
+			// node leaves label, drop label's columns
+			ColumnStore_Invalidate(gc->column_store, Schema_GetID(s),
+					ATTRIBUTE_ID_ALL);
 			// remove node from index
-			Schema_RemoveNodeFromIndices(s, node);
+			_IndexNode(s, node, INDEX_CHANGE_REMOVE, log);
 		}
 
 		if(remove_labels_index > 0) {
@@ -40,6 +40,19 @@ void CreateEdge
 	bool log           // log operation in undo-log
 );
 
+// create edges in bulk
+// each edge's src, dst endpoints and relationship-type must be set
+// add the edges to the relevant indexes
+// add edges creation operations to undo-log
+void CreateEdges
+(
+	GraphContext *gc,    // graph context to create the edges
+	Edge **edges,        // edges to create
+	AttributeSet *sets,  // edges attributes
+	uint n,              // number of edges
+	bool log             // log operations in undo-log
+);
+
 // delete nodes
 // remove nodes from the relevant indexes
 // add node deletion operations to undo-log
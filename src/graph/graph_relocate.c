@@ -0,0 +1,282 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "graph.h"
+#include "../util/arr.h"
+#include "rg_matrix/rg_matrix_iter.h"
+
+// ID compaction
+//
+// deletions leave vacant IDs behind, these are reused by later creations
+// but as long as they're vacant the graph's datablocks and matrices are
+// sized by the highest ID in use rather than by the number of entities
+//
+// compaction moves the entities holding the highest IDs into vacant IDs
+// below the entity count, once no such vacancy remains the datablocks'
+// trailing blocks are released and the matrices are shrunk
+//
+// relocating a node moves its attribute-set and rewires its labels and edges
+// relocating an edge moves its attribute-set and updates its relation matrix
+
+bool Graph_FormConnection(Graph *g, NodeID src, NodeID dest, EdgeID edge_id, int r);
+void Graph_RemoveConnection(Graph *g, NodeID src, NodeID dest, EdgeID edge_id, RelationID r);
+
+bool Graph_NodesFragmented
+(
+	const Graph *g
+) {
+	ASSERT(g != NULL);
+	return DataBlock_Fragmented(g->nodes);
+}
+
+bool Graph_EdgesFragmented
+(
+	const Graph *g
+) {
+	ASSERT(g != NULL);
+	return DataBlock_Fragmented(g->edges);
+}
+
+uint64_t Graph_TrailingNodes
+(
+	const Graph *g,
+	uint64_t n,
+	NodeID *ids
+) {
+	ASSERT(g   != NULL);
+	ASSERT(ids != NULL);
+
+	return DataBlock_TrailingItems(g->nodes, n, ids);
+}
+
+uint64_t Graph_TrailingEdges
+(
+	const Graph *g,
+	RelationID *r,
+	NodeID *row,
+	uint64_t budget,
+	uint64_t n,
+	Edge *edges
+) {
+	ASSERT(g     != NULL);
+	ASSERT(r     != NULL);
+	ASSERT(row   != NULL);
+	ASSERT(edges != NULL);
+
+	uint64_t count     = 0;
+	uint64_t visited   = 0;
+	EdgeID   threshold = Graph_EdgeCount(g);
+	int      relations = Graph_RelationTypeCount(g);
+
+	GrB_Index          i;
+	GrB_Index          j;
+	uint64_t           x;
+	RG_MatrixTupleIter it = {0};
+
+	for(; *r < relations; (*r)++, *row = 0) {
+		RG_Matrix R = Graph_GetRelationMatrix(g, *r, false);
+		RG_MatrixTupleIter_AttachRange(&it, R, *row, RG_ITER_MAX_ROW);
+
+		while(RG_MatrixTupleIter_next_UINT64(&it, &i, &j, &x) == GrB_SUCCESS) {
+			// stop at a row boundary once either limit is reached
+			// a row is resumed from its start, relocated edges are then
+			// positioned below the threshold and won't be collected again
+			if(i != *row && (count >= n || visited >= budget)) {
+				*row = i;
+				RG_MatrixTupleIter_detach(&it);
+				return count;
+			}
+			*row = i;
+
+			uint32_t        len = 1;
+			const uint64_t *ids = &x;
+			if(!SINGLE_EDGE(x)) ids = RG_Matrix_multiEdge(R, x, &len);
+
+			for(uint32_t k = 0; k < len; k++) {
+				visited++;
+				if(ids[k] < threshold || count >= n) continue;
+
+				Edge *e       = edges + count++;
+				e->id         = ids[k];
+				e->src_id     = i;
+				e->dest_id    = j;
+				e->relationID = *r;
+				e->attributes = DataBlock_GetItem(g->edges, ids[k]);
+			}
+		}
+
+		RG_MatrixTupleIter_detach(&it);
+	}
+
+	// sweep is done, next sweep starts over
+	*r   = 0;
+	*row = 0;
+
+	return count;
+}
+
+uint64_t Graph_RelocateNodes
+(
+	Graph *g,
+	uint64_t from,
+	const NodeID *src,
+	NodeID *dst,
+	uint64_t n
+) {
+	ASSERT(g   != NULL);
+	ASSERT(src != NULL);
+	ASSERT(dst != NULL);
+
+	return DataBlock_Relocate(g->nodes, from, src, dst, n);
+}
+
+uint64_t Graph_RelocateEdges
+(
+	Graph *g,
+	uint64_t from,
+	const EdgeID *src,
+	EdgeID *dst,
+	uint64_t n
+) {
+	ASSERT(g   != NULL);
+	ASSERT(src != NULL);
+	ASSERT(dst != NULL);
+
+	return DataBlock_Relocate(g->edges, from, src, dst, n);
+}
+
+void Graph_RewireNode
+(
+	Graph *g,
+	NodeID src,
+	NodeID dst,
+	Edge **edges
+) {
+	ASSERT(g     != NULL);
+	ASSERT(edges != NULL);
+	ASSERT(src   != dst);
+
+	MATRIX_POLICY policy = Graph_SetMatrixPolicy(g, SYNC_POLICY_NOP);
+
+	Node n = GE_NEW_NODE();
+	n.id = src;
+
+	//--------------------------------------------------------------------------
+	// move labels
+	//--------------------------------------------------------------------------
+
+	uint label_count;
+	NODE_GET_LABELS(g, &n, label_count);
+	if(label_count > 0) {
+		Graph_RemoveNodeLabels(g, src, labels, label_count);
+		Graph_LabelNode(g, dst, labels, label_count);
+	}
+
+	//--------------------------------------------------------------------------
+	// move edges
+	//--------------------------------------------------------------------------
+
+	uint offset = array_len(*edges);
+	Graph_GetNodeEdges(g, &n, GRAPH_EDGE_DIR_BOTH, GRAPH_NO_RELATION, edges);
+	uint edge_count = array_len(*edges);
+
+	// detach all edges before reattaching any of them
+	// otherwise a reattached edge might keep the adjacency entry
+	// of a detached one alive
+	for(uint i = offset; i < edge_count; i++) {
+		Edge *e = *edges + i;
+		Graph_RemoveConnection(g, e->src_id, e->dest_id, e->id, e->relationID);
+	}
+
+	for(uint i = offset; i < edge_count; i++) {
+		Edge *e = *edges + i;
+		NodeID s = (e->src_id  == src) ? dst : e->src_id;
+		NodeID d = (e->dest_id == src) ? dst : e->dest_id;
+		bool res = Graph_FormConnection(g, s, d, e->id, e->relationID);
+		ASSERT(res == true);
+		UNUSED(res);
+	}
+
+	Graph_SetMatrixPolicy(g, policy);
+}
+
+void Graph_RewireEdge
+(
+	Graph *g,
+	const Edge *e,
+	EdgeID dst
+) {
+	ASSERT(g != NULL);
+	ASSERT(e != NULL);
+	ASSERT(e->id != dst);
+
+	GrB_Info info;
+	bool     entry_deleted;
+	UNUSED(info);
+
+	MATRIX_POLICY policy = Graph_SetMatrixPolicy(g, SYNC_POLICY_NOP);
+
+	// the adjacency matrix and statistics are unaffected
+	RG_Matrix R = Graph_GetRelationMatrix(g, e->relationID, false);
+
+	info = RG_Matrix_removeEntry_UINT64(R, e->src_id, e->dest_id, e->id,
+			&entry_deleted);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = RG_Matrix_setElement_UINT64(R, dst, e->src_id, e->dest_id);
+	ASSERT(info == GrB_SUCCESS);
+
+	Graph_SetMatrixPolicy(g, policy);
+}
+
+bool Graph_Trim
+(
+	Graph *g
+) {
+	ASSERT(g != NULL);
+
+	// trimming would release IDs of live entities
+	if(Graph_NodesFragmented(g) || Graph_EdgesFragmented(g)) return false;
+
+	DataBlock_Trim(g->nodes);
+	DataBlock_Trim(g->edges);
+
+	// flush pending changes and shrink matrices to the trimmed node capacity
+	Graph_ApplyAllPending(g, true);
+
+	return true;
+}
+
+size_t Graph_MemoryUsage
+(
+	const Graph *g
+) {
+	ASSERT(g != NULL);
+
+	size_t n;
+	size_t size = DataBlock_MemoryUsage(g->nodes) +
+		DataBlock_MemoryUsage(g->edges);
+
+	RG_Matrix_memoryUsage(&n, g->adjacency_matrix);
+	size += n;
+	RG_Matrix_memoryUsage(&n, g->node_labels);
+	size += n;
+
+	uint label_count = array_len(g->labels);
+	for(uint i = 0; i < label_count; i++) {
+		RG_Matrix_memoryUsage(&n, g->labels[i]);
+		size += n;
+	}
+
+	uint relation_count = array_len(g->relations);
+	for(uint i = 0; i < relation_count; i++) {
+		RG_Matrix_memoryUsage(&n, g->relations[i]);
+		size += n;
+	}
+
+	return size;
+}
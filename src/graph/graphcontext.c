@@ -16,6 +16,7 @@
 #include "../constraint/constraint.h"
 #include "../serializers/graphcontext_type.h"
 #include "../commands/execution_ctx.h"
+#include "../ast/ast_parameterize_literals.h"
 
 #include <sys/param.h>
 #include <pthread.h>
@@ -98,6 +99,7 @@ GraphContext *GraphContext_New
 	gc->ref_count        = 0;  // no refences
 	gc->attributes       = raxNew();
 	gc->index_count      = 0;  // no indicies
+	gc->compacting       = false;
 	gc->string_mapping   = array_new(char *, 64);
 	gc->encoding_context = GraphEncodeContext_New();
 	gc->decoding_context = GraphDecodeContext_New();
@@ -130,6 +132,12 @@ GraphContext *GraphContext_New
 	Config_Option_get(Config_CACHE_SIZE, &cache_size);
 	gc->cache = Cache_New(cache_size, (CacheEntryFreeFunc)ExecutionCtx_Free,
 						  (CacheEntryCopyFunc)ExecutionCtx_Clone);
+	gc->literals_cache = Cache_New(cache_size,
+			(CacheEntryFreeFunc)LiteralParams_Free,
+			(CacheEntryCopyFunc)LiteralParams_Clone);
+
+	// columns are built on demand
+	gc->column_store = ColumnStore_New();
 
 	Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_FLUSH_RESIZE);
 
@@ -557,6 +565,28 @@ bool GraphContext_HasIndices(GraphContext *gc) {
 	return has_node_indices || has_edge_indices;
 }
 
+// returns true if any of the schemas holds a constraint
+static bool _schemas_have_constraints(const Schema **schemas) {
+	ASSERT(schemas);
+
+	const uint32_t length = array_len(schemas);
+	for (uint32_t i = 0; i < length; ++i) {
+		if(Schema_HasConstraints(schemas[i])) return true;
+	}
+
+	return false;
+}
+
+bool GraphContext_HasConstraints
+(
+	const GraphContext *gc
+) {
+	ASSERT(gc != NULL);
+
+	return _schemas_have_constraints((const Schema**)gc->node_schemas) ||
+		_schemas_have_constraints((const Schema**)gc->relation_schemas);
+}
+
 uint64_t GraphContext_NodeIndexCount
 (
 	const GraphContext *gc
@@ -844,6 +874,14 @@ Cache *GraphContext_GetCache(const GraphContext *gc) {
 	return gc->cache;
 }
 
+Cache *GraphContext_GetLiteralsCache
+(
+	const GraphContext *gc
+) {
+	ASSERT(gc != NULL);
+	return gc->literals_cache;
+}
+
 //------------------------------------------------------------------------------
 // Free routine
 //------------------------------------------------------------------------------
@@ -965,6 +1003,13 @@ static void _GraphContext_Free(void *arg) {
 	//--------------------------------------------------------------------------
 
 	if(gc->cache) Cache_Free(gc->cache);
+	if(gc->literals_cache) Cache_Free(gc->literals_cache);
+
+	//--------------------------------------------------------------------------
+	// free columnar store
+	//--------------------------------------------------------------------------
+
+	if(gc->column_store) ColumnStore_Free(gc->column_store);
 
 	GraphEncodeContext_Free(gc->encoding_context);
 	GraphDecodeContext_Free(gc->decoding_context);
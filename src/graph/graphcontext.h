@@ -7,6 +7,7 @@
 #pragma once
 
 #include "graph.h"
+#include "column_store.h"
 #include "../redismodule.h"
 #include "../index/index.h"
 #include "../schema/schema.h"
@@ -41,6 +42,9 @@ typedef struct {
 	GraphEncodeContext *encoding_context;  // encode context of the graph
 	GraphDecodeContext *decoding_context;  // decode context of the graph
 	Cache *cache;                          // global cache of execution plans
+	Cache *literals_cache;                 // normalized form of cached queries
+	ColumnStore *column_store;             // columnar copy of node attributes
+	bool compacting;                       // ID compaction in progress
 	XXH32_hash_t version;                  // graph version
 	RedisModuleString *telemetry_stream;   // telemetry stream name
 } GraphContext;
@@ -244,6 +248,12 @@ bool GraphContext_HasIndices
 	GraphContext *gc
 );
 
+// returns true if the graph holds constraints, false otherwise
+bool GraphContext_HasConstraints
+(
+	const GraphContext *gc
+);
+
 // returns the number of node indices within the passed graph context.
 uint64_t GraphContext_NodeIndexCount
 (
@@ -380,3 +390,9 @@ Cache *GraphContext_GetCache
 	const GraphContext *gc
 );
 
+// return cache mapping queries to their literal-free normalized form
+Cache *GraphContext_GetLiteralsCache
+(
+	const GraphContext *gc
+);
+
@@ -0,0 +1,132 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "rg_matrix.h"
+
+// returns the number of pending changes in C's delta matrices
+GrB_Info RG_Matrix_pendingChanges
+(
+	GrB_Index *n,      // [output] number of pending changes
+	const RG_Matrix C  // matrix to inquery
+) {
+	ASSERT(n != NULL);
+	ASSERT(C != NULL);
+
+	GrB_Info  info;
+	GrB_Index dp_nvals;
+	GrB_Index dm_nvals;
+
+	info = GrB_Matrix_nvals(&dp_nvals, RG_MATRIX_DELTA_PLUS(C));
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_nvals(&dm_nvals, RG_MATRIX_DELTA_MINUS(C));
+	ASSERT(info == GrB_SUCCESS);
+
+	*n = dp_nvals + dm_nvals;
+
+	return info;
+}
+
+// computes C's main matrix with all pending changes applied: (M - DM) + DP
+// C itself is left untouched, the result is placed in A
+GrB_Info RG_Matrix_compact
+(
+	GrB_Matrix *A,     // [output] compacted main matrix
+	const RG_Matrix C  // matrix to compact
+) {
+	ASSERT(A != NULL);
+	ASSERT(C != NULL);
+	ASSERT(!RG_Matrix_isDirty(C));
+
+	GrB_Info   info;
+	GrB_Index  nrows;
+	GrB_Index  ncols;
+	GrB_Matrix a  = NULL;
+	GrB_Matrix m  = RG_MATRIX_M(C);
+	GrB_Matrix dp = RG_MATRIX_DELTA_PLUS(C);
+	GrB_Matrix dm = RG_MATRIX_DELTA_MINUS(C);
+
+	info = GrB_Matrix_nrows(&nrows, m);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_ncols(&ncols, m);
+	ASSERT(info == GrB_SUCCESS);
+
+	// start off with a copy of M, the copy inherits M's sparsity control
+	info = GrB_Matrix_dup(&a, m);
+	ASSERT(info == GrB_SUCCESS);
+
+	// drop deleted entries: A<!DM> = A
+	info = GrB_transpose(a, dm, GrB_NULL, a, GrB_DESC_RSCT0);
+	ASSERT(info == GrB_SUCCESS);
+
+	// introduce pending additions: A<DP> = DP
+	info = GrB_Matrix_assign(a, dp, NULL, dp, GrB_ALL, nrows, GrB_ALL, ncols,
+			GrB_DESC_S);
+	ASSERT(info == GrB_SUCCESS);
+
+	// materialize, readers must not trigger any pending work on A
+	info = GrB_wait(a, GrB_MATERIALIZE);
+	ASSERT(info == GrB_SUCCESS);
+
+	*A = a;
+
+	return info;
+}
+
+// replaces C's main matrix with A and clears C's delta matrices
+// A must be the outcome of RG_Matrix_compact(C) and C must not have been
+// modified since, C takes ownership over A
+GrB_Info RG_Matrix_swap
+(
+	RG_Matrix C,   // matrix to update
+	GrB_Matrix *A  // compacted main matrix
+) {
+	ASSERT(A  != NULL);
+	ASSERT(C  != NULL);
+	ASSERT(*A != NULL);
+
+	GrB_Info  info;
+	GrB_Index nrows;
+	GrB_Index ncols;
+	GrB_Index a_nrows;
+	GrB_Index a_ncols;
+
+	// C might have been resized since it was compacted
+	info = GrB_Matrix_nrows(&nrows, RG_MATRIX_M(C));
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_ncols(&ncols, RG_MATRIX_M(C));
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_nrows(&a_nrows, *A);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_ncols(&a_ncols, *A);
+	ASSERT(info == GrB_SUCCESS);
+
+	if(nrows != a_nrows || ncols != a_ncols) {
+		info = GrB_Matrix_resize(*A, nrows, ncols);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_wait(*A, GrB_MATERIALIZE);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	// multi-edge lists are referenced by A and owned by C's pool
+	info = GrB_Matrix_free(&C->matrix);
+	ASSERT(info == GrB_SUCCESS);
+
+	C->matrix = *A;
+	*A = NULL;
+
+	info = GrB_Matrix_clear(RG_MATRIX_DELTA_PLUS(C));
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_clear(RG_MATRIX_DELTA_MINUS(C));
+	ASSERT(info == GrB_SUCCESS);
+
+	info = GrB_wait(RG_MATRIX_DELTA_PLUS(C), GrB_MATERIALIZE);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_wait(RG_MATRIX_DELTA_MINUS(C), GrB_MATERIALIZE);
+	ASSERT(info == GrB_SUCCESS);
+
+	return info;
+}
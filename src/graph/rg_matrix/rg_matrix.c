@@ -14,7 +14,11 @@ void RG_Matrix_setDirty
 ) {
 	ASSERT(C);
 	C->dirty = true;
-	if(RG_MATRIX_MAINTAIN_TRANSPOSE(C)) C->transposed->dirty = true;
+	C->generation++;
+	if(RG_MATRIX_MAINTAIN_TRANSPOSE(C)) {
+		C->transposed->dirty = true;
+		C->transposed->generation++;
+	}
 }
 
 RG_Matrix RG_Matrix_getTranspose
@@ -25,6 +29,14 @@ RG_Matrix RG_Matrix_getTranspose
 	return C->transposed;
 }
 
+uint64_t RG_Matrix_generation
+(
+	const RG_Matrix C
+) {
+	ASSERT(C);
+	return C->generation;
+}
+
 bool RG_Matrix_isDirty
 (
 	const RG_Matrix C
@@ -165,12 +177,32 @@ GrB_Info RG_Matrix_clear
 	info = GrB_Matrix_clear(m);
 	ASSERT(info == GrB_SUCCESS);
 
+	if(A->multi_edges != NULL) MultiEdgePool_Clear(A->multi_edges);
+
 	A->dirty = false;
-	if(RG_MATRIX_MAINTAIN_TRANSPOSE(A)) A->transposed->dirty = false;
+	A->generation++;
+	if(RG_MATRIX_MAINTAIN_TRANSPOSE(A)) {
+		A->transposed->dirty = false;
+		A->transposed->generation++;
+	}
 
 	return info;
 }
 
+const uint64_t *RG_Matrix_multiEdge
+(
+	const RG_Matrix A,
+	uint64_t x,
+	uint32_t *n
+) {
+	ASSERT(A != NULL);
+	ASSERT(n != NULL);
+	ASSERT(A->multi_edges != NULL);
+	ASSERT(!(SINGLE_EDGE(x)));
+
+	return MultiEdgePool_Get(A->multi_edges, CLEAR_MSB(x), n);
+}
+
 GrB_Info RG_Matrix_type
 (
 	GrB_Type *type,
@@ -184,3 +216,41 @@ GrB_Info RG_Matrix_type
 	ASSERT(info == GrB_SUCCESS)
 	return info;
 }
+
+GrB_Info RG_Matrix_memoryUsage
+(
+	size_t *size,
+	const RG_Matrix A
+) {
+	ASSERT(A    != NULL);
+	ASSERT(size != NULL);
+
+	size_t   n;
+	GrB_Info info;
+
+	*size = 0;
+
+	info = GxB_Matrix_memoryUsage(&n, RG_MATRIX_M(A));
+	ASSERT(info == GrB_SUCCESS);
+	*size += n;
+
+	info = GxB_Matrix_memoryUsage(&n, RG_MATRIX_DELTA_PLUS(A));
+	ASSERT(info == GrB_SUCCESS);
+	*size += n;
+
+	info = GxB_Matrix_memoryUsage(&n, RG_MATRIX_DELTA_MINUS(A));
+	ASSERT(info == GrB_SUCCESS);
+	*size += n;
+
+	if(A->multi_edges != NULL) {
+		*size += A->multi_edges->ids_cap * sizeof(uint64_t);
+	}
+
+	if(RG_MATRIX_MAINTAIN_TRANSPOSE(A)) {
+		info = RG_Matrix_memoryUsage(&n, A->transposed);
+		ASSERT(info == GrB_SUCCESS);
+		*size += n;
+	}
+
+	return info;
+}
@@ -8,6 +8,7 @@
 
 #include "RG.h"
 #include "GraphBLAS.h"
+#include "rg_multi_edge.h"
 
 #include <pthread.h>
 
@@ -120,10 +121,12 @@ typedef _RG_Matrix *RG_Matrix;
 
 struct _RG_Matrix {
 	volatile bool dirty;                // Indicates if matrix requires sync
+	uint64_t generation;                // Advanced by every modification
 	GrB_Matrix matrix;                  // Underlying GrB_Matrix
 	GrB_Matrix delta_plus;              // Pending additions
 	GrB_Matrix delta_minus;             // Pending deletions
 	RG_Matrix transposed;               // Transposed matrix
+	MultiEdgePool *multi_edges;         // Multi-edge lists
 	pthread_mutex_t mutex;              // Lock
 };
 
@@ -152,6 +155,13 @@ bool RG_Matrix_isDirty
 	const RG_Matrix C
 );
 
+// returns C's generation, advanced each time C's entries are modified
+// synchronizing or resizing C does not advance its generation
+uint64_t RG_Matrix_generation
+(
+	const RG_Matrix C
+);
+
 // checks if C is fully synced
 // a synced delta matrix does not contains any entries in
 // either its delta-plus and delta-minus internal matrices
@@ -228,6 +238,15 @@ GrB_Info RG_Matrix_extractElement_UINT64   // x = A(i,j)
 	GrB_Index j                            // column index
 ) ;
 
+// returns the edge IDs of a multi-edge entry 'x'
+// IDs are stored contiguously and valid until A is modified
+const uint64_t *RG_Matrix_multiEdge
+(
+	const RG_Matrix A,                     // matrix holding entry
+	uint64_t x,                            // multi-edge entry
+	uint32_t *n                            // [output] number of IDs
+);
+
 // remove entry at position C[i,j]
 GrB_Info RG_Matrix_removeElement_BOOL
 (
@@ -300,6 +319,40 @@ GrB_Info RG_Matrix_wait
 	bool force_sync
 );
 
+// returns the number of pending changes in C's delta matrices
+GrB_Info RG_Matrix_pendingChanges
+(
+	GrB_Index *n,      // [output] number of pending changes
+	const RG_Matrix C  // matrix to inquery
+);
+
+// returns the number of bytes used by A, including its transpose
+GrB_Info RG_Matrix_memoryUsage
+(
+	size_t *size,      // [output] number of bytes used
+	const RG_Matrix A  // matrix to inquery
+);
+
+// computes C's main matrix with all pending changes applied: (M - DM) + DP
+// C itself is left untouched, the result is placed in A
+// this allows the expensive merge to be performed while C is being read
+// transposed matrix isn't handled, caller should compact it separately
+GrB_Info RG_Matrix_compact
+(
+	GrB_Matrix *A,     // [output] compacted main matrix
+	const RG_Matrix C  // matrix to compact
+);
+
+// replaces C's main matrix with A and clears C's delta matrices
+// A must be the outcome of RG_Matrix_compact(C) and C's generation must not
+// have advanced since, A is resized to C's current dimensions
+// C takes ownership over A
+GrB_Info RG_Matrix_swap
+(
+	RG_Matrix C,   // matrix to update
+	GrB_Matrix *A  // compacted main matrix
+);
+
 // get the type of the M matrix
 GrB_Info RG_Matrix_type
 (
@@ -0,0 +1,230 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "rg_multi_edge.h"
+#include "../../util/arr.h"
+#include "../../util/rmalloc.h"
+
+#include <string.h>
+
+// minimum number of IDs the arena is allocated with
+#define ARENA_MIN_CAP 64
+
+// capacity class of a block, blocks hold at least 2 IDs
+static inline uint _BlockClass
+(
+	uint32_t cap
+) {
+	ASSERT(cap >= 2 && (cap & (cap - 1)) == 0);
+	return __builtin_ctz(cap) - 1;
+}
+
+// allocate a block of 'cap' IDs, returns block's offset within the arena
+static uint64_t _AllocBlock
+(
+	MultiEdgePool *pool,
+	uint32_t cap
+) {
+	// reuse a vacated block of the same class
+	uint64_t *free_blocks = pool->free_blocks[_BlockClass(cap)];
+	if(free_blocks != NULL && array_len(free_blocks) > 0) {
+		return array_pop(free_blocks);
+	}
+
+	// extend arena
+	if(pool->ids_len + cap > pool->ids_cap) {
+		uint64_t ids_cap = pool->ids_cap * 2;
+		if(ids_cap < ARENA_MIN_CAP) ids_cap = ARENA_MIN_CAP;
+		if(ids_cap < pool->ids_len + cap) ids_cap = pool->ids_len + cap;
+		pool->ids = rm_realloc(pool->ids, sizeof(uint64_t) * ids_cap);
+		pool->ids_cap = ids_cap;
+	}
+
+	uint64_t offset = pool->ids_len;
+	pool->ids_len += cap;
+
+	return offset;
+}
+
+// vacate block
+static void _FreeBlock
+(
+	MultiEdgePool *pool,
+	uint64_t offset,
+	uint32_t cap
+) {
+	uint c = _BlockClass(cap);
+	if(pool->free_blocks[c] == NULL) {
+		pool->free_blocks[c] = array_new(uint64_t, 1);
+	}
+	array_append(pool->free_blocks[c], offset);
+}
+
+MultiEdgePool *MultiEdgePool_New(void) {
+	MultiEdgePool *pool = rm_calloc(1, sizeof(MultiEdgePool));
+
+	pool->lists      = array_new(MultiEdgeList, 0);
+	pool->free_lists = array_new(uint64_t, 0);
+
+	return pool;
+}
+
+uint64_t MultiEdgePool_NewList
+(
+	MultiEdgePool *pool,
+	uint64_t a,
+	uint64_t b
+) {
+	ASSERT(pool != NULL);
+
+	MultiEdgeList l = {.offset = _AllocBlock(pool, 2), .len = 2, .cap = 2};
+	pool->ids[l.offset]     = a;
+	pool->ids[l.offset + 1] = b;
+
+	uint64_t list;
+	if(array_len(pool->free_lists) > 0) {
+		list = array_pop(pool->free_lists);
+		pool->lists[list] = l;
+	} else {
+		list = array_len(pool->lists);
+		array_append(pool->lists, l);
+	}
+
+	return list;
+}
+
+void MultiEdgePool_Append
+(
+	MultiEdgePool *pool,
+	uint64_t list,
+	uint64_t x
+) {
+	ASSERT(pool != NULL);
+	ASSERT(list < array_len(pool->lists));
+
+	MultiEdgeList *l = pool->lists + list;
+
+	// block is full, migrate list to a block twice as large
+	if(l->len == l->cap) {
+		uint64_t offset = _AllocBlock(pool, l->cap * 2);
+		memcpy(pool->ids + offset, pool->ids + l->offset,
+				sizeof(uint64_t) * l->len);
+		_FreeBlock(pool, l->offset, l->cap);
+		l->offset = offset;
+		l->cap *= 2;
+	}
+
+	pool->ids[l->offset + l->len] = x;
+	l->len++;
+}
+
+bool MultiEdgePool_Remove
+(
+	MultiEdgePool *pool,
+	uint64_t list,
+	uint64_t x,
+	uint64_t *remaining
+) {
+	ASSERT(pool      != NULL);
+	ASSERT(remaining != NULL);
+	ASSERT(list < array_len(pool->lists));
+
+	MultiEdgeList *l = pool->lists + list;
+	uint64_t *ids = pool->ids + l->offset;
+
+	// search for ID
+	uint32_t i = 0;
+	for(; i < l->len; i++) {
+		if(ids[i] == x) break;
+	}
+	ASSERT(i < l->len);
+
+	// migrate last ID into the vacated position
+	l->len--;
+	ids[i] = ids[l->len];
+
+	// incase we're left with a single ID revert back to scalar
+	if(l->len == 1) {
+		*remaining = ids[0];
+		MultiEdgePool_DeleteList(pool, list);
+		return true;
+	}
+
+	return false;
+}
+
+void MultiEdgePool_DeleteList
+(
+	MultiEdgePool *pool,
+	uint64_t list
+) {
+	ASSERT(pool != NULL);
+	ASSERT(list < array_len(pool->lists));
+
+	MultiEdgeList *l = pool->lists + list;
+	_FreeBlock(pool, l->offset, l->cap);
+
+	l->len = 0;
+	array_append(pool->free_lists, list);
+}
+
+void MultiEdgePool_Restore
+(
+	MultiEdgePool *pool,
+	uint64_t list,
+	const uint64_t *ids,
+	uint32_t n
+) {
+	ASSERT(pool != NULL);
+	ASSERT(ids  != NULL);
+	ASSERT(n    >= 2);
+	ASSERT(list >= array_len(pool->lists));
+
+	// recycle skipped list IDs
+	while(array_len(pool->lists) < list) {
+		MultiEdgeList l = {0};
+		array_append(pool->free_lists, array_len(pool->lists));
+		array_append(pool->lists, l);
+	}
+
+	uint32_t cap = 2;
+	while(cap < n) cap *= 2;
+
+	MultiEdgeList l = {.offset = _AllocBlock(pool, cap), .len = n, .cap = cap};
+	memcpy(pool->ids + l.offset, ids, sizeof(uint64_t) * n);
+	array_append(pool->lists, l);
+}
+
+void MultiEdgePool_Clear
+(
+	MultiEdgePool *pool
+) {
+	ASSERT(pool != NULL);
+
+	pool->ids_len = 0;
+	array_clear(pool->lists);
+	array_clear(pool->free_lists);
+	for(uint i = 0; i < MULTI_EDGE_BLOCK_CLASSES; i++) {
+		if(pool->free_blocks[i] != NULL) array_clear(pool->free_blocks[i]);
+	}
+}
+
+void MultiEdgePool_Free
+(
+	MultiEdgePool *pool
+) {
+	ASSERT(pool != NULL);
+
+	if(pool->ids != NULL) rm_free(pool->ids);
+	array_free(pool->lists);
+	array_free(pool->free_lists);
+	for(uint i = 0; i < MULTI_EDGE_BLOCK_CLASSES; i++) {
+		if(pool->free_blocks[i] != NULL) array_free(pool->free_blocks[i]);
+	}
+
+	rm_free(pool);
+}
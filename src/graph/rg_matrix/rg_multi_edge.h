@@ -0,0 +1,111 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// number of block capacity classes, capacities are powers of 2: [2..2^32]
+#define MULTI_EDGE_BLOCK_CLASSES 32
+
+// multi-edge pool
+//
+// when multiple edges connect the same pair of nodes, the relation matrix
+// entry references an edge list held by the matrix's multi-edge pool
+// edge lists are laid out in blocks of a single contiguous arena of IDs
+// each list is identified by a stable ID, unaffected by the arena's growth
+//
+// a list growing beyond its block's capacity migrates to a block twice
+// as large, vacated blocks are recycled by capacity class
+
+typedef struct {
+	uint64_t offset;  // position of list's first ID within the arena
+	uint32_t len;     // number of IDs in list
+	uint32_t cap;     // number of IDs list's block can hold
+} MultiEdgeList;
+
+typedef struct {
+	uint64_t *ids;                                     // arena of IDs
+	uint64_t ids_len;                                  // arena used slots
+	uint64_t ids_cap;                                  // arena capacity
+	MultiEdgeList *lists;                              // edge lists
+	uint64_t *free_lists;                              // recycled list IDs
+	uint64_t *free_blocks[MULTI_EDGE_BLOCK_CLASSES];  // recycled blocks
+} MultiEdgePool;
+
+// create a new multi-edge pool
+MultiEdgePool *MultiEdgePool_New(void);
+
+// create a new list holding 'a' and 'b'
+// returns list ID
+uint64_t MultiEdgePool_NewList
+(
+	MultiEdgePool *pool,  // pool
+	uint64_t a,           // first ID
+	uint64_t b            // second ID
+);
+
+// append 'x' to list
+void MultiEdgePool_Append
+(
+	MultiEdgePool *pool,  // pool
+	uint64_t list,        // list ID
+	uint64_t x            // ID to append
+);
+
+// remove 'x' from list
+// returns true if list is left with a single ID, in which case the list
+// is deleted and its remaining ID is set in 'remaining'
+bool MultiEdgePool_Remove
+(
+	MultiEdgePool *pool,  // pool
+	uint64_t list,        // list ID
+	uint64_t x,           // ID to remove
+	uint64_t *remaining   // [output] remaining ID
+);
+
+// delete list
+void MultiEdgePool_DeleteList
+(
+	MultiEdgePool *pool,  // pool
+	uint64_t list         // list ID
+);
+
+// returns list's IDs, valid until pool is modified
+static inline const uint64_t *MultiEdgePool_Get
+(
+	const MultiEdgePool *pool,  // pool
+	uint64_t list,              // list ID
+	uint32_t *n                 // [output] number of IDs
+) {
+	const MultiEdgeList *l = pool->lists + list;
+	*n = l->len;
+	return pool->ids + l->offset;
+}
+
+// restores list 'list' holding 'ids', used when decoding a pool
+// lists must be restored in increasing ID order
+// list IDs skipped over are recycled
+void MultiEdgePool_Restore
+(
+	MultiEdgePool *pool,  // pool
+	uint64_t list,        // list ID
+	const uint64_t *ids,  // list's IDs
+	uint32_t n            // number of IDs
+);
+
+// delete all lists
+void MultiEdgePool_Clear
+(
+	MultiEdgePool *pool  // pool
+);
+
+// free pool
+void MultiEdgePool_Free
+(
+	MultiEdgePool *pool  // pool
+);
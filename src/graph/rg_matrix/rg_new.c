@@ -16,7 +16,8 @@ static GrB_Info _RG_Matrix_init
 	GrB_Index ncols
 ) {
 	GrB_Info info;
-	A->dirty    =  false;
+	A->dirty      =  false;
+	A->generation =  0;
 
 	//--------------------------------------------------------------------------
 	// create m, delta-plus and delta-minus
@@ -79,7 +80,8 @@ GrB_Info RG_Matrix_new
 	//--------------------------------------------------------------------------
 
 	if(type == GrB_UINT64) {
-		matrix->transposed = rm_calloc(1, sizeof(_RG_Matrix));
+		matrix->multi_edges = MultiEdgePool_New();
+		matrix->transposed  = rm_calloc(1, sizeof(_RG_Matrix));
 		info = _RG_Matrix_init(matrix->transposed, GrB_BOOL, ncols, nrows);
 		ASSERT(info == GrB_SUCCESS);
 	}
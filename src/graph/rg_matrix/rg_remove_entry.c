@@ -7,45 +7,10 @@
 #include "RG.h"
 #include "rg_utils.h"
 #include "rg_matrix.h"
-#include "../../util/arr.h"
-#include "../../util/rmalloc.h"
-
-static bool _removeEntryFromMultiValArr
-(
-	uint64_t **entries,  // multi-value array
-	uint64_t entry       // element to remove output new value
-) {
-	ASSERT(*entries != NULL);
-
-	uint  i  =  0;
-	uint  n  =  array_len(*entries);
-
-	// search for entry
-	for(; i < n; i++) {
-		if((*entries)[i] == entry) {
-			break;
-		}
-	}
-
-	ASSERT(i < n);
-
-	// remove located entry
-	// migrate last element and reduce array size
-	array_del_fast(*entries, i);
-
-	// incase we're left with a single entry revert back to scalar
-	if(array_len(*entries) == 1) {
-		entry = (*entries)[0];
-		array_free(*entries);
-		*entries = (uint64_t *)entry;
-		return true;
-	}
-
-	return false;
-}
 
 static GrB_Info _removeElementMultiVal
 (
+	RG_Matrix C,                    // matrix owning A
 	GrB_Matrix A,                   // matrix to remove entry from
 	GrB_Index i,                    // row index
 	GrB_Index j,                    // column index
@@ -54,7 +19,6 @@ static GrB_Info _removeElementMultiVal
 	ASSERT(A);
 
 	uint64_t  x;
-	uint64_t  tx;
 	GrB_Info  info;
 
 	info = GrB_Matrix_extractElement(&x, A, i, j);
@@ -62,12 +26,12 @@ static GrB_Info _removeElementMultiVal
 	ASSERT((SINGLE_EDGE(x)) == false);
 
 	// remove entry from multi-value
-	x  = CLEAR_MSB(x);
-	uint64_t *entries  = (uint64_t *)x;
-	if(_removeEntryFromMultiValArr(&entries, v)) {
+	// incase we're left with a single entry revert back to scalar
+	if(MultiEdgePool_Remove(C->multi_edges, CLEAR_MSB(x), v, &x)) {
 		// update entry
-		x = (uint64_t)entries;
 		info = GrB_Matrix_setElement(A, x, i, j);
+		// the list is vacated for reuse, entry changed
+		RG_Matrix_setDirty(C);
 	}
 
 	return info;
@@ -126,7 +90,7 @@ GrB_Info RG_Matrix_removeEntry_UINT64
 			ASSERT(info == GrB_SUCCESS)
 			RG_Matrix_setDirty(C);
 		} else {
-			info = _removeElementMultiVal(m, i, j, v);
+			info = _removeElementMultiVal(C, m, i, j, v);
 			ASSERT(info == GrB_SUCCESS);
 		}
 		return info;
@@ -147,7 +111,7 @@ GrB_Info RG_Matrix_removeEntry_UINT64
 		ASSERT(info == GrB_SUCCESS)
 		RG_Matrix_setDirty(C);
 	} else {
-		info = _removeElementMultiVal(dp, i, j, v);
+		info = _removeElementMultiVal(C, dp, i, j, v);
 		ASSERT(info == GrB_SUCCESS);
 	}
 	return info;
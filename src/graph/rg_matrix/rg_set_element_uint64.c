@@ -7,53 +7,33 @@
 #include "RG.h"
 #include "rg_utils.h"
 #include "rg_matrix.h"
-#include "../../util/arr.h"
-
-static GrB_BinaryOp _graph_edge_accum = NULL;
-
-void _edge_accum(void *_z, const void *_x, const void *_y) {
-	uint64_t *ids;
-	uint64_t       *z  =  (uint64_t *)        _z;
-	const uint64_t *x  =  (const uint64_t *)  _x;
-	const uint64_t *y  =  (const uint64_t *)  _y;
-
-	// single edge ID,
-	// switching from single edge ID to multiple IDs
-	if(SINGLE_EDGE(*x)) {
-		ids = array_new(uint64_t, 2);
-		array_append(ids, *x);
-		array_append(ids, *y);
-	} else {
-		// multiple edges, adding another edge
-		ids = (uint64_t *)(CLEAR_MSB(*x));
-		array_append(ids, *y);
-	}
-
-	*z = (uint64_t)SET_MSB(ids);
-}
 
 // dealing with multi-value entries
 static GrB_Info setMultiEdgeEntry
 (
-    GrB_Matrix A,                       // matrix to modify
-    uint64_t x,                         // scalar to assign to A(i,j)
-    GrB_Index i,                        // row index
-    GrB_Index j                         // column index
+	RG_Matrix C,                        // matrix owning A
+	GrB_Matrix A,                       // matrix to modify
+	uint64_t x,                         // scalar to assign to A(i,j)
+	GrB_Index i,                        // row index
+	GrB_Index j                         // column index
 ) {
-	GrB_Info info;
+	uint64_t  v;
+	GrB_Info  info = GrB_Matrix_extractElement_UINT64(&v, A, i, j);
 
-	// create edge accumulator binary function
-	// TODO: remove if condition, initialize binary operation at module load
-	if(!_graph_edge_accum) {
-		info = GrB_BinaryOp_new(&_graph_edge_accum, _edge_accum, GrB_UINT64, 
-								GrB_UINT64, GrB_UINT64);
-		ASSERT(info == GrB_SUCCESS);
-	}
+	// new entry
+	if(info == GrB_NO_VALUE) return GrB_Matrix_setElement_UINT64(A, x, i, j);
 
-	info = GxB_Matrix_subassign_UINT64(A, NULL, _graph_edge_accum, 
-									   x, &i, 1, &j, 1, NULL);
 	ASSERT(info == GrB_SUCCESS);
 
+	if(SINGLE_EDGE(v)) {
+		// switching from single edge ID to multiple IDs
+		uint64_t list = MultiEdgePool_NewList(C->multi_edges, v, x);
+		info = GrB_Matrix_setElement_UINT64(A, SET_MSB(list), i, j);
+	} else {
+		// multiple edges, adding another edge, entry remains the same
+		MultiEdgePool_Append(C->multi_edges, CLEAR_MSB(v), x);
+	}
+
 	return info;
 }
 
@@ -119,10 +99,10 @@ GrB_Info RG_Matrix_setElement_UINT64    // C (i,j) = x
 
 		if(entry_exists) {
 			// update entry at m[i,j]
-			info = setMultiEdgeEntry(m, x, i, j);
+			info = setMultiEdgeEntry(C, m, x, i, j);
 		} else {
 			// update entry at dp[i,j]
-			info = setMultiEdgeEntry(dp, x, i, j);
+			info = setMultiEdgeEntry(C, dp, x, i, j);
 		}
 	}
 
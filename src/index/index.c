@@ -10,7 +10,6 @@
 #include "../util/arr.h"
 #include "../query_ctx.h"
 #include "../util/rmalloc.h"
-#include "../datatypes/point.h"
 #include "../graph/graphcontext.h"
 #include "../graph/entities/node.h"
 #include "../graph/rg_matrix/rg_matrix_iter.h"
@@ -25,8 +24,12 @@ struct _Index {
 	char **stopwords;              // stopwords
 	GraphEntityType entity_type;   // entity type (node/edge) indexed
 	IndexType type;                // index type exact-match / fulltext
-	RSIndex *rsIdx;                // RediSearch index
+	RSIndex *rsIdx;                // RediSearch index, fulltext only
+	OrderedIndex oi;               // ordered index, exact-match only
 	uint _Atomic pending_changes;  // number of pending changes
+	rax *changes;                  // entities modified during population
+	uint64_t _Atomic populated;    // number of entities populated
+	uint64_t population_size;      // number of entities to populate
 };
 
 static void _Index_ConstructFullTextStructure
@@ -57,44 +60,6 @@ static void _Index_ConstructFullTextStructure
 	}
 }
 
-static void _Index_ConstructExactMatchStructure
-(
-	Index idx,
-	RSIndex *rsIdx
-) {
-	ASSERT(idx != NULL);
-	ASSERT(rsIdx != NULL);
-
-	RSFieldID fieldID;
-	uint fields_count = array_len(idx->fields);
-	unsigned types = RSFLDTYPE_NUMERIC | RSFLDTYPE_GEO | RSFLDTYPE_TAG;
-
-	for(uint i = 0; i < fields_count; i++) {
-		IndexField *field = idx->fields + i;
-		// introduce both text, numeric and geo fields
-		fieldID = RediSearch_CreateField(rsIdx, field->name, types,
-				RSFLDOPT_NONE);
-		RediSearch_TagFieldSetSeparator(rsIdx, fieldID, INDEX_SEPARATOR);
-		RediSearch_TagFieldSetCaseSensitive(rsIdx, fieldID, 1);
-	}
-
-	// introduce edge src and dest node ids as additional index fields
-	if(idx->entity_type == GETYPE_EDGE) {
-		RediSearch_CreateField(rsIdx, "_src_id", RSFLDTYPE_NUMERIC,
-				RSFLDOPT_NONE);
-		RediSearch_CreateField(rsIdx, "_dest_id", RSFLDTYPE_NUMERIC,
-				RSFLDOPT_NONE);
-	}
-
-	// for none indexable types e.g. Array introduce an additional field
-	// "none_indexable_fields" which will hold a list of attribute names
-	// that were not indexed
-	fieldID = RediSearch_CreateField(rsIdx, INDEX_FIELD_NONE_INDEXED,
-			RSFLDTYPE_TAG, RSFLDOPT_NONE);
-	RediSearch_TagFieldSetSeparator(rsIdx, fieldID, INDEX_SEPARATOR);
-	RediSearch_TagFieldSetCaseSensitive(rsIdx, fieldID, 1);
-}
-
 // responsible for creating the index structure only!
 // e.g. fields, stopwords, language
 void Index_ConstructStructure
@@ -102,8 +67,17 @@ void Index_ConstructStructure
 	Index idx
 ) {
 	ASSERT(idx != NULL);
+	ASSERT(idx->oi    == NULL);
 	ASSERT(idx->rsIdx == NULL);
 
+	// exact-match indices are maintained natively
+	if(idx->type == IDX_EXACT_MATCH) {
+		size_t key_len = (idx->entity_type == GETYPE_NODE) ?
+			sizeof(EntityID) : sizeof(EdgeIndexKey);
+		idx->oi = OrderedIndex_New(array_len(idx->fields), key_len);
+		return;
+	}
+
 	RSIndex *rsIdx = NULL;
 	RSIndexOptions *idx_options = RediSearch_CreateIndexOptions();
 	RediSearch_IndexOptionsSetLanguage(idx_options, idx->language);
@@ -119,22 +93,15 @@ void Index_ConstructStructure
 	if(idx->stopwords) {
 		RediSearch_IndexOptionsSetStopwords(idx_options,
 				(const char**)idx->stopwords, array_len(idx->stopwords));
-	} else if(idx->type == IDX_EXACT_MATCH) {
-		RediSearch_IndexOptionsSetStopwords(idx_options, NULL, 0);
 	}
 
 	rsIdx = RediSearch_CreateIndex(idx->label, idx_options);
 	RediSearch_FreeIndexOptions(idx_options);
 
 	// create indexed fields
-	if(idx->type == IDX_FULLTEXT) {
-		_Index_ConstructFullTextStructure(idx, rsIdx);
-	} else {
-		_Index_ConstructExactMatchStructure(idx, rsIdx);
-	}
+	_Index_ConstructFullTextStructure(idx, rsIdx);
 
 	// set RediSearch index
-	ASSERT(idx->rsIdx == NULL);
 	idx->rsIdx = rsIdx;
 }
 
@@ -151,99 +118,69 @@ RSDoc *Index_IndexGraphEntity
 	ASSERT(key              !=  NULL);
 	ASSERT(doc_field_count  !=  NULL);
 	ASSERT(key_len          >   0);
+	ASSERT(idx->type        ==  IDX_FULLTEXT);
 
 	double     score       = 1;     // default score
 	IndexField *field      = NULL;  // current indexed field
 	SIValue    *v          = NULL;  // current indexed value
-	EntityID   id          = ENTITY_GET_ID(e);
 	uint       field_count = array_len(idx->fields);
 
 	*doc_field_count = 0;
 
-	// list of none indexable fields
-	uint none_indexable_fields_count = 0; // number of none indexed fields
-	const char *none_indexable_fields[field_count]; // none indexed fields
-
 	// create an empty document
 	RSDoc *doc = RediSearch_CreateDocument2(key, key_len, NULL, score,
 			idx->language);
 
 	// add document field for each indexed property
-	if(idx->type == IDX_FULLTEXT) {
-		for(uint i = 0; i < field_count; i++) {
-			field = idx->fields + i;
-			const char *field_name = field->name;
-			v = GraphEntity_GetProperty(e, field->id);
-			if(v == ATTRIBUTE_NOTFOUND) continue;
-
-			SIType t = SI_TYPE(*v);
-
-			// value must be of type string
-			if(t == T_STRING) {
-				*doc_field_count += 1;
-				RediSearch_DocumentAddFieldString(doc, field_name, v->stringval,
-						strlen(v->stringval), RSFLDTYPE_FULLTEXT);
-			}
-		}
-	} else {
-		for(uint i = 0; i < field_count; i++) {
-			field = idx->fields + i;
-			const char *field_name = field->name;
-			v = GraphEntity_GetProperty(e, field->id);
-			if(v == ATTRIBUTE_NOTFOUND) continue;
+	for(uint i = 0; i < field_count; i++) {
+		field = idx->fields + i;
+		const char *field_name = field->name;
+		v = GraphEntity_GetProperty(e, field->id);
+		if(v == ATTRIBUTE_NOTFOUND) continue;
 
-			SIType t = SI_TYPE(*v);
+		SIType t = SI_TYPE(*v);
 
+		// value must be of type string
+		if(t == T_STRING) {
 			*doc_field_count += 1;
-			if(t == T_STRING) {
-				RediSearch_DocumentAddFieldString(doc, field_name, v->stringval,
-						strlen(v->stringval), RSFLDTYPE_TAG);
-			} else if(t & (SI_NUMERIC | T_BOOL)) {
-				double d = SI_GET_NUMERIC(*v);
-				RediSearch_DocumentAddFieldNumber(doc, field_name, d,
-						RSFLDTYPE_NUMERIC);
-			} else if(t == T_POINT) {
-				double lat = (double)Point_lat(*v);
-				double lon = (double)Point_lon(*v);
-				RediSearch_DocumentAddFieldGeo(doc, field_name, lat, lon,
-						RSFLDTYPE_GEO);
-			} else {
-				// none indexable field
-				none_indexable_fields[none_indexable_fields_count++] =
-					field_name;
-			}
+			RediSearch_DocumentAddFieldString(doc, field_name, v->stringval,
+					strlen(v->stringval), RSFLDTYPE_FULLTEXT);
 		}
+	}
 
-		// index name of none index fields
-		if(none_indexable_fields_count > 0) {
-			// concat all none indexable field names
-			size_t len = none_indexable_fields_count - 1; // seperators
-			for(uint i = 0; i < none_indexable_fields_count; i++) {
-				len += strlen(none_indexable_fields[i]);
-			}
-
-			// add room for \0
-			len++;
-
-			char *s = NULL;
-			if(len < 512) s = alloca(len); // stack base
-			else s = rm_malloc(sizeof(char) * len); // heap base
+	return doc;
+}
 
-			// concat
-			len = sprintf(s, "%s", none_indexable_fields[0]);
-			for(uint i = 1; i < none_indexable_fields_count; i++) {
-				len += sprintf(s + len, "%c%s", INDEX_SEPARATOR, none_indexable_fields[i]);
-			}
+// collects entity's indexed values, NULL for a missing value
+static void _Index_EntityValues
+(
+	const Index idx,
+	const GraphEntity *e,
+	const SIValue **values
+) {
+	uint field_count = array_len(idx->fields);
+	for(uint i = 0; i < field_count; i++) {
+		SIValue *v = GraphEntity_GetProperty(e, idx->fields[i].id);
+		values[i] = (v == ATTRIBUTE_NOTFOUND) ? NULL : v;
+	}
+}
 
-			RediSearch_DocumentAddFieldString(doc, INDEX_FIELD_NONE_INDEXED,
-						s, len, RSFLDTYPE_TAG);
+// update entity's indexed values in an exact-match index
+void Index_SetEntityValues
+(
+	Index idx,
+	const GraphEntity *e,
+	const void *key
+) {
+	ASSERT(idx       != NULL);
+	ASSERT(e         != NULL);
+	ASSERT(key       != NULL);
+	ASSERT(idx->type == IDX_EXACT_MATCH);
 
-			// free if heap based
-			if(len >= 512) rm_free(s);
-		}
-	}
+	const SIValue *values[array_len(idx->fields)];
+	_Index_EntityValues(idx, e, values);
 
-	return doc;
+	OrderedIndex_Set(idx->oi, key, values);
 }
 
 void IndexField_New
@@ -290,13 +227,17 @@ Index Index_New
 
 	idx->type            = type;
 	idx->label           = rm_strdup(label);
+	idx->oi              = NULL;
 	idx->rsIdx           = NULL;
 	idx->fields          = array_new(IndexField, 1);
 	idx->label_id        = label_id;
 	idx->language        = NULL;
 	idx->stopwords       = NULL;
+	idx->changes         = NULL;
+	idx->populated       = ATOMIC_VAR_INIT(0);
 	idx->entity_type     = entity_type;
 	idx->pending_changes = ATOMIC_VAR_INIT(0);
+	idx->population_size = 0;
 
 	return idx;
 }
@@ -316,9 +257,13 @@ Index Index_Clone
 	Index clone = rm_malloc(sizeof(_Index));
 	memcpy(clone, idx, sizeof(_Index));
 
+	clone->oi              = NULL;
 	clone->rsIdx           = NULL;
 	clone->label           = rm_strdup(idx->label);
+	clone->changes         = NULL;
+	clone->populated       = ATOMIC_VAR_INIT(0);
 	clone->pending_changes = ATOMIC_VAR_INIT(0);
+	clone->population_size = 0;
 	
 	if(clone->stopwords != NULL) {
 		array_clone_with_cb(clone->stopwords, idx->stopwords, rm_strdup);
@@ -351,7 +296,7 @@ int Index_PendingChanges
 }
 
 // disable index by increasing the number of pending changes
-// and re-creating the internal RediSearch index
+// and re-creating the internal index
 void Index_Disable
 (
 	Index idx  // index to disable
@@ -366,6 +311,17 @@ void Index_Disable
 		idx->rsIdx = NULL;
 	}
 
+	if(idx->oi != NULL) {
+		OrderedIndex_Free(idx->oi);
+		idx->oi = NULL;
+	}
+
+	// discard changes logged by an ongoing population
+	if(idx->changes != NULL) {
+		raxFree(idx->changes);
+		idx->changes = NULL;
+	}
+
 	// construct index structure
 	Index_ConstructStructure(idx);
 }
@@ -377,7 +333,7 @@ void Index_Enable
 	Index idx
 ) {
 	ASSERT(idx != NULL);
-	ASSERT(idx->rsIdx != NULL);
+	ASSERT(idx->rsIdx != NULL || idx->oi != NULL);
 	ASSERT(idx->pending_changes > 0);
 
 	idx->pending_changes--;
@@ -427,6 +383,7 @@ RSResultsIterator *Index_Query
 ) {
 	ASSERT(idx   != NULL);
 	ASSERT(query != NULL);
+	ASSERT(idx->type == IDX_FULLTEXT);
 
 	return RediSearch_IterateQuery(idx->rsIdx, query, strlen(query), err);
 }
@@ -514,6 +471,10 @@ const char *Index_GetLanguage
 ) {
 	ASSERT(idx != NULL);
 
+	if(idx->type == IDX_EXACT_MATCH) {
+		return (idx->language != NULL) ? idx->language : INDEX_DEFAULT_LANGUAGE;
+	}
+
 	RSIndex *_idx = Index_RSIndex(idx);
 	ASSERT(_idx != NULL);
 
@@ -527,14 +488,12 @@ char **Index_GetStopwords
 ) {
 	ASSERT(idx != NULL);
 
+	if(idx->type == IDX_EXACT_MATCH) return NULL;
+
 	RSIndex *_idx = Index_RSIndex(idx);
 	ASSERT(_idx != NULL);
 
-	if(idx->type == IDX_FULLTEXT) {
-		return RediSearch_IndexGetStopwords(_idx, size);
-	}
-
-	return NULL;
+	return RediSearch_IndexGetStopwords(_idx, size);
 }
 
 // set indexed language
@@ -583,6 +542,191 @@ RSIndex *Index_RSIndex
 	return idx->rsIdx;
 }
 
+// returns ordered index
+OrderedIndex Index_OrderedIndex
+(
+	const Index idx  // index to get internal ordered index from
+) {
+	ASSERT(idx != NULL);
+
+	return idx->oi;
+}
+
+// reads entity's attribute from an exact-match index
+bool Index_GetStoredValue
+(
+	const Index idx,
+	const void *key,
+	Attribute_ID attr,
+	SIValue *v
+) {
+	ASSERT(v   != NULL);
+	ASSERT(idx != NULL);
+	ASSERT(key != NULL);
+
+	// index is being populated
+	if(idx->oi == NULL || !Index_Enabled(idx)) return false;
+
+	uint fields_count = array_len(idx->fields);
+	for(uint i = 0; i < fields_count; i++) {
+		if(idx->fields[i].id == attr) {
+			return OrderedIndex_GetStoredValue(idx->oi, key, i, v);
+		}
+	}
+
+	return false;
+}
+
+// collects entities into a run instead of the index
+void Index_RunAddEntity
+(
+	const Index idx,
+	OrderedIndexRun run,
+	const GraphEntity *e,
+	const void *key
+) {
+	ASSERT(idx       != NULL);
+	ASSERT(run       != NULL);
+	ASSERT(e         != NULL);
+	ASSERT(key       != NULL);
+	ASSERT(idx->type == IDX_EXACT_MATCH);
+
+	const SIValue *values[array_len(idx->fields)];
+	_Index_EntityValues(idx, e, values);
+
+	OrderedIndexRun_Add(run, key, values);
+}
+
+// loads entities which aren't indexed yet into an exact-match index
+// entities are collected into a single sorted run which is loaded in bulk
+// while the index is being populated entities are logged instead
+void Index_LoadEntities
+(
+	Index idx,
+	const GraphEntity **entities,
+	const unsigned char *keys,
+	uint64_t n
+) {
+	ASSERT(idx       != NULL);
+	ASSERT(keys      != NULL);
+	ASSERT(entities  != NULL);
+	ASSERT(idx->type == IDX_EXACT_MATCH);
+
+	size_t key_len = OrderedIndex_KeyLen(idx->oi);
+
+	// index is being populated, entities are indexed once population is done
+	if(idx->changes != NULL) {
+		for(uint64_t i = 0; i < n; i++) {
+			Index_LogChange(idx, keys + i * key_len, INDEX_CHANGE_SET);
+		}
+		return;
+	}
+
+	OrderedIndexRun run = OrderedIndexRun_New(array_len(idx->fields), key_len);
+
+	for(uint64_t i = 0; i < n; i++) {
+		Index_RunAddEntity(idx, run, entities[i], keys + i * key_len);
+	}
+
+	OrderedIndexRun_Sort(run);
+	bool loaded = OrderedIndex_Load(idx->oi, &run, 1, UINT64_MAX);
+	ASSERT(loaded == true);
+	UNUSED(loaded);
+
+	OrderedIndexRun_Free(run);
+}
+
+// starts logging modified entities instead of updating the index
+void Index_StartChangeLog
+(
+	Index idx
+) {
+	ASSERT(idx          != NULL);
+	ASSERT(idx->oi      != NULL);
+	ASSERT(idx->changes == NULL);
+
+	// index is about to be built from scratch
+	uint16_t field_count = array_len(idx->fields);
+	size_t   key_len     = OrderedIndex_KeyLen(idx->oi);
+
+	OrderedIndex_Free(idx->oi);
+	idx->oi      = OrderedIndex_New(field_count, key_len);
+	idx->changes = raxNew();
+}
+
+// logs a modified entity, returns false if changes aren't being logged
+bool Index_LogChange
+(
+	Index idx,
+	const void *key,
+	IndexChange change
+) {
+	ASSERT(idx != NULL);
+	ASSERT(key != NULL);
+
+	if(idx->changes == NULL) return false;
+
+	// last change wins
+	raxInsert(idx->changes, (unsigned char *)key, OrderedIndex_KeyLen(idx->oi),
+			(void *)(uintptr_t)change, NULL);
+
+	return true;
+}
+
+// stops logging changes, returns logged changes
+// caller is responsible for freeing the log
+rax *Index_StopChangeLog
+(
+	Index idx
+) {
+	ASSERT(idx != NULL);
+
+	rax *changes = idx->changes;
+	idx->changes = NULL;
+
+	return changes;
+}
+
+// sets the number of entities to populate, resets population progress
+void Index_SetPopulationSize
+(
+	Index idx,
+	uint64_t n
+) {
+	ASSERT(idx != NULL);
+
+	idx->populated       = 0;
+	idx->population_size = n;
+}
+
+// advances population progress
+void Index_IncPopulated
+(
+	Index idx,
+	uint64_t n
+) {
+	ASSERT(idx != NULL);
+
+	idx->populated += n;
+}
+
+// returns index population progress in percentage
+uint Index_PopulationProgress
+(
+	const Index idx
+) {
+	ASSERT(idx != NULL);
+
+	if(Index_Enabled(idx))        return 100;
+	if(idx->population_size == 0) return 0;
+
+	// report 100% only once the index is enabled
+	uint64_t populated = idx->populated;
+	uint64_t progress  = populated * 100 / idx->population_size;
+
+	return (progress < 99) ? progress : 99;
+}
+
 // free index
 void Index_Free
 (
@@ -594,6 +738,14 @@ void Index_Free
 		RediSearch_DropIndex(idx->rsIdx);
 	}
 
+	if(idx->oi) {
+		OrderedIndex_Free(idx->oi);
+	}
+
+	if(idx->changes) {
+		raxFree(idx->changes);
+	}
+
 	if(idx->language) {
 		rm_free(idx->language);
 	}
@@ -10,12 +10,12 @@
 #include "../graph/entities/edge.h"
 #include "../graph/entities/graph_entity.h"
 #include "../graph/graph.h"
+#include "ordered_index.h"
 #include "redisearch_api.h"
 
 #define INDEX_OK 1
 #define INDEX_FAIL 0
-#define INDEX_SEPARATOR '\1'  // can't use '\0', RediSearch will terminate on \0
-#define INDEX_FIELD_NONE_INDEXED "NONE_INDEXABLE_FIELDS"
+#define INDEX_DEFAULT_LANGUAGE "english"
 
 #define INDEX_FIELD_DEFAULT_WEIGHT 1.0
 #define INDEX_FIELD_DEFAULT_NOSTEM false
@@ -36,6 +36,12 @@ typedef enum {
 	IDX_FULLTEXT     =  2,
 } IndexType;
 
+// entity modification logged during population
+typedef enum {
+	INDEX_CHANGE_SET    = 1,  // entity was added or updated
+	INDEX_CHANGE_REMOVE = 2,  // entity was removed
+} IndexChange;
+
 typedef struct {
 	EntityID src_id;
 	EntityID dest_id;
@@ -96,7 +102,7 @@ void Index_Enable
 );
 
 // disable index by increasing the number of pending changes
-// and re-creating the internal RediSearch index
+// and re-creating the internal index
 void Index_Disable
 (
 	Index idx  // index to disable
@@ -108,12 +114,28 @@ bool Index_Enabled
 	const Index idx  // index to get state of
 );
 
-// returns RediSearch index
+// returns RediSearch index, NULL for exact-match indices
 RSIndex *Index_RSIndex
 (
 	const Index idx  // index to get internal RediSearch index from
 );
 
+// returns ordered index, NULL for fulltext indices
+OrderedIndex Index_OrderedIndex
+(
+	const Index idx  // index to get internal ordered index from
+);
+
+// reads entity's attribute from an exact-match index
+// returns false if the value must be read from the entity itself
+bool Index_GetStoredValue
+(
+	const Index idx,    // index to query
+	const void *key,    // entity key, see OrderedIndex
+	Attribute_ID attr,  // attribute to read
+	SIValue *v          // [output] attribute value
+);
+
 // responsible for creating the index structure only!
 // e.g. fields, stopwords, language
 void Index_ConstructStructure
@@ -156,6 +178,23 @@ void Index_IndexEdge
 	const Edge *e  // edge to index
 );
 
+// index nodes which aren't indexed yet e.g. nodes created by a query
+// exact-match indexes are loaded in bulk
+void Index_IndexNewNodes
+(
+	Index idx,         // index to populate
+	const Node *nodes, // nodes to index
+	uint64_t n         // number of nodes
+);
+
+// index edges which aren't indexed yet, see Index_IndexNewNodes
+void Index_IndexNewEdges
+(
+	Index idx,         // index to populate
+	const Edge *edges, // edges to index
+	uint64_t n         // number of edges
+);
+
 // remove node from index
 void Index_RemoveNode
 (
@@ -170,7 +209,7 @@ void Index_RemoveEdge
 	const Edge *e  // edge to remove from index
 );
 
-// query an index
+// query a fulltext index
 RSResultsIterator *Index_Query
 (
 	const Index idx,    // index to query
@@ -248,6 +287,61 @@ void Index_SetStopwords
 	char **stopwords  // stopwords
 );
 
+//------------------------------------------------------------------------------
+// population
+//------------------------------------------------------------------------------
+
+// collects entity into a run instead of the index
+void Index_RunAddEntity
+(
+	const Index idx,      // index the run is built for
+	OrderedIndexRun run,  // run to extend
+	const GraphEntity *e, // entity to add
+	const void *key       // entity key
+);
+
+// clears an exact-match index and starts logging modified entities
+// instead of updating the index, see Index_Populate
+void Index_StartChangeLog
+(
+	Index idx  // index to log changes for
+);
+
+// logs a modified entity, returns false if changes aren't being logged
+bool Index_LogChange
+(
+	Index idx,          // index to log change for
+	const void *key,    // entity key
+	IndexChange change  // type of change
+);
+
+// stops logging changes, returns logged changes keyed by entity key
+// caller is responsible for freeing the log
+rax *Index_StopChangeLog
+(
+	Index idx  // index to stop logging changes for
+);
+
+// sets the number of entities to populate, resetting population progress
+void Index_SetPopulationSize
+(
+	Index idx,  // index being populated
+	uint64_t n  // number of entities to populate
+);
+
+// advances population progress by 'n' entities
+void Index_IncPopulated
+(
+	Index idx,  // index being populated
+	uint64_t n  // number of populated entities
+);
+
+// returns index population progress in percentage
+uint Index_PopulationProgress
+(
+	const Index idx  // index to query
+);
+
 // free fulltext index
 void Index_Free
 (
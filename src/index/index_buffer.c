@@ -0,0 +1,402 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "index_buffer.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+
+// buffered change key
+// [schema type][schema id][entity ids]
+// all components are big-endian, keeping keys sorted by schema and entity
+// nodes are identified by their ID, edges by their src, dest and edge IDs
+#define KEY_HEADER_LEN (1 + sizeof(uint32_t))
+#define NODE_KEY_LEN   (KEY_HEADER_LEN + sizeof(uint64_t))
+#define EDGE_KEY_LEN   (KEY_HEADER_LEN + 3 * sizeof(uint64_t))
+
+// entities created under a schema
+// nodes are identified by their ID, edges by their src, dest and edge IDs
+typedef struct {
+	SchemaType t;   // schema type
+	int id;         // schema id
+	EntityID *ids;  // created entities
+} CreatedEntities;
+
+struct _IndexBuffer {
+	rax *changes;               // buffered changes, key -> IndexChange
+	CreatedEntities *created;   // entities created by the query, per schema
+	CreatedEntities *last;      // schema entities were last created under
+};
+
+static void _EncodeUInt
+(
+	unsigned char *buf,
+	uint64_t v,
+	uint len
+) {
+	for(uint i = 0; i < len; i++) buf[i] = v >> (8 * (len - 1 - i));
+}
+
+static uint64_t _DecodeUInt
+(
+	const unsigned char *buf,
+	uint len
+) {
+	uint64_t v = 0;
+	for(uint i = 0; i < len; i++) v = (v << 8) | buf[i];
+	return v;
+}
+
+static void _EncodeHeader
+(
+	unsigned char *key,
+	const Schema *s
+) {
+	key[0] = (unsigned char)Schema_GetType(s);
+	_EncodeUInt(key + 1, Schema_GetID(s), sizeof(uint32_t));
+}
+
+// returns created entities of schema, creating an entry if missing
+static CreatedEntities *_CreatedEntities
+(
+	IndexBuffer *buff,
+	const Schema *s
+) {
+	SchemaType t  = Schema_GetType(s);
+	int        id = Schema_GetID(s);
+
+	// entities are usually created in batches under the same schema
+	CreatedEntities *c = buff->last;
+	if(c != NULL && c->t == t && c->id == id) return c;
+
+	uint n = array_len(buff->created);
+	for(uint i = 0; i < n; i++) {
+		c = buff->created + i;
+		if(c->t == t && c->id == id) {
+			buff->last = c;
+			return c;
+		}
+	}
+
+	CreatedEntities entry = {.t = t, .id = id, .ids = array_new(EntityID, 0)};
+	array_append(buff->created, entry);
+
+	buff->last = buff->created + n;
+	return buff->last;
+}
+
+static void _ClearCreated
+(
+	IndexBuffer *buff
+) {
+	uint n = array_len(buff->created);
+	for(uint i = 0; i < n; i++) array_free(buff->created[i].ids);
+	array_clear(buff->created);
+	buff->last = NULL;
+}
+
+IndexBuffer *IndexBuffer_New(void) {
+	IndexBuffer *buff = rm_malloc(sizeof(IndexBuffer));
+	buff->changes = raxNew();
+	buff->created = array_new(CreatedEntities, 0);
+	buff->last    = NULL;
+	return buff;
+}
+
+uint64_t IndexBuffer_Length
+(
+	const IndexBuffer *buff
+) {
+	ASSERT(buff != NULL);
+
+	uint64_t n = raxSize(buff->changes);
+
+	uint created = array_len(buff->created);
+	for(uint i = 0; i < created; i++) {
+		uint64_t count = array_len(buff->created[i].ids);
+		n += (buff->created[i].t == SCHEMA_NODE) ? count : count / 3;
+	}
+
+	return n;
+}
+
+void IndexBuffer_AddNode
+(
+	IndexBuffer *buff,
+	const Schema *s,
+	const Node *n,
+	IndexChange change
+) {
+	ASSERT(s    != NULL);
+	ASSERT(n    != NULL);
+	ASSERT(buff != NULL);
+
+	unsigned char key[NODE_KEY_LEN];
+	_EncodeHeader(key, s);
+	_EncodeUInt(key + KEY_HEADER_LEN, ENTITY_GET_ID(n), sizeof(uint64_t));
+
+	// override previous change to node
+	raxInsert(buff->changes, key, NODE_KEY_LEN, (void *)(uintptr_t)change,
+			NULL);
+}
+
+void IndexBuffer_AddNewNode
+(
+	IndexBuffer *buff,
+	const Schema *s,
+	const Node *n
+) {
+	ASSERT(s    != NULL);
+	ASSERT(n    != NULL);
+	ASSERT(buff != NULL);
+
+	// node ID was freed by this query and reused
+	// the index might still hold the deleted node, replace it
+	if(raxSize(buff->changes) > 0) {
+		unsigned char key[NODE_KEY_LEN];
+		_EncodeHeader(key, s);
+		_EncodeUInt(key + KEY_HEADER_LEN, ENTITY_GET_ID(n), sizeof(uint64_t));
+
+		if(raxFind(buff->changes, key, NODE_KEY_LEN) != raxNotFound) {
+			raxInsert(buff->changes, key, NODE_KEY_LEN,
+					(void *)(uintptr_t)INDEX_CHANGE_SET, NULL);
+			return;
+		}
+	}
+
+	CreatedEntities *c = _CreatedEntities(buff, s);
+	array_append(c->ids, ENTITY_GET_ID(n));
+}
+
+void IndexBuffer_AddEdge
+(
+	IndexBuffer *buff,
+	const Schema *s,
+	const Edge *e,
+	IndexChange change
+) {
+	ASSERT(s    != NULL);
+	ASSERT(e    != NULL);
+	ASSERT(buff != NULL);
+
+	unsigned char key[EDGE_KEY_LEN];
+	unsigned char *ids = key + KEY_HEADER_LEN;
+
+	_EncodeHeader(key, s);
+	_EncodeUInt(ids,      Edge_GetSrcNodeID(e),  sizeof(uint64_t));
+	_EncodeUInt(ids + 8,  Edge_GetDestNodeID(e), sizeof(uint64_t));
+	_EncodeUInt(ids + 16, ENTITY_GET_ID(e),      sizeof(uint64_t));
+
+	// override previous change to edge
+	raxInsert(buff->changes, key, EDGE_KEY_LEN, (void *)(uintptr_t)change,
+			NULL);
+}
+
+void IndexBuffer_AddNewEdge
+(
+	IndexBuffer *buff,
+	const Schema *s,
+	const Edge *e
+) {
+	ASSERT(s    != NULL);
+	ASSERT(e    != NULL);
+	ASSERT(buff != NULL);
+
+	// edge ID was freed by this query and reused, see IndexBuffer_AddNewNode
+	if(raxSize(buff->changes) > 0) {
+		unsigned char key[EDGE_KEY_LEN];
+		unsigned char *ids = key + KEY_HEADER_LEN;
+
+		_EncodeHeader(key, s);
+		_EncodeUInt(ids,      Edge_GetSrcNodeID(e),  sizeof(uint64_t));
+		_EncodeUInt(ids + 8,  Edge_GetDestNodeID(e), sizeof(uint64_t));
+		_EncodeUInt(ids + 16, ENTITY_GET_ID(e),      sizeof(uint64_t));
+
+		if(raxFind(buff->changes, key, EDGE_KEY_LEN) != raxNotFound) {
+			raxInsert(buff->changes, key, EDGE_KEY_LEN,
+					(void *)(uintptr_t)INDEX_CHANGE_SET, NULL);
+			return;
+		}
+	}
+
+	CreatedEntities *c = _CreatedEntities(buff, s);
+	array_append(c->ids, Edge_GetSrcNodeID(e));
+	array_append(c->ids, Edge_GetDestNodeID(e));
+	array_append(c->ids, ENTITY_GET_ID(e));
+}
+
+// index nodes created under schema in bulk
+// nodes which were modified afterwards are left to the buffered changes
+static void _FlushCreatedNodes
+(
+	IndexBuffer *buff,
+	GraphContext *gc,
+	const Schema *s,
+	EntityID *ids
+) {
+	Graph    *g     = gc->g;
+	uint64_t n      = array_len(ids);
+	bool     lookup = raxSize(buff->changes) > 0;
+	Node     *nodes = rm_malloc(sizeof(Node) * n);
+	uint64_t count  = 0;
+
+	unsigned char key[NODE_KEY_LEN];
+	_EncodeHeader(key, s);
+
+	for(uint64_t i = 0; i < n; i++) {
+		if(lookup) {
+			_EncodeUInt(key + KEY_HEADER_LEN, ids[i], sizeof(uint64_t));
+			if(raxFind(buff->changes, key, NODE_KEY_LEN) != raxNotFound) {
+				continue;
+			}
+		}
+
+		nodes[count] = GE_NEW_NODE();
+		if(Graph_GetNode(g, ids[i], nodes + count)) count++;
+	}
+
+	if(count > 0) Schema_AddNewNodesToIndices(s, nodes, count);
+
+	rm_free(nodes);
+}
+
+// index edges created under schema in bulk, see _FlushCreatedNodes
+static void _FlushCreatedEdges
+(
+	IndexBuffer *buff,
+	GraphContext *gc,
+	const Schema *s,
+	EntityID *ids
+) {
+	Graph    *g     = gc->g;
+	uint64_t n      = array_len(ids) / 3;
+	bool     lookup = raxSize(buff->changes) > 0;
+	Edge     *edges = rm_malloc(sizeof(Edge) * n);
+	uint64_t count  = 0;
+
+	unsigned char key[EDGE_KEY_LEN];
+	_EncodeHeader(key, s);
+
+	for(uint64_t i = 0; i < n; i++) {
+		const EntityID *edge_ids = ids + i * 3;
+
+		if(lookup) {
+			unsigned char *k = key + KEY_HEADER_LEN;
+			_EncodeUInt(k,      edge_ids[0], sizeof(uint64_t));
+			_EncodeUInt(k + 8,  edge_ids[1], sizeof(uint64_t));
+			_EncodeUInt(k + 16, edge_ids[2], sizeof(uint64_t));
+			if(raxFind(buff->changes, key, EDGE_KEY_LEN) != raxNotFound) {
+				continue;
+			}
+		}
+
+		Edge *e = edges + count;
+		memset(e, 0, sizeof(Edge));
+		if(!Graph_GetEdge(g, edge_ids[2], e)) continue;
+
+		e->id         = edge_ids[2];
+		e->relationID = Schema_GetID(s);
+		Edge_SetSrcNodeID(e,  edge_ids[0]);
+		Edge_SetDestNodeID(e, edge_ids[1]);
+		count++;
+	}
+
+	if(count > 0) Schema_AddNewEdgesToIndices(s, edges, count);
+
+	rm_free(edges);
+}
+
+void IndexBuffer_Flush
+(
+	IndexBuffer *buff,
+	GraphContext *gc
+) {
+	ASSERT(gc   != NULL);
+	ASSERT(buff != NULL);
+
+	//--------------------------------------------------------------------------
+	// index created entities in bulk
+	//--------------------------------------------------------------------------
+
+	// created entities are not indexed yet, unless modified afterwards
+	// in which case they're handled along with the rest of the changes
+	uint created = array_len(buff->created);
+	for(uint i = 0; i < created; i++) {
+		CreatedEntities *c = buff->created + i;
+		Schema *s = GraphContext_GetSchemaByID(gc, c->id, c->t);
+		ASSERT(s != NULL);
+
+		if(c->t == SCHEMA_NODE) _FlushCreatedNodes(buff, gc, s, c->ids);
+		else _FlushCreatedEdges(buff, gc, s, c->ids);
+	}
+	_ClearCreated(buff);
+
+	//--------------------------------------------------------------------------
+	// apply buffered changes
+	//--------------------------------------------------------------------------
+
+	if(raxSize(buff->changes) == 0) return;
+
+	Graph *g = gc->g;
+
+	raxIterator it;
+	raxStart(&it, buff->changes);
+	raxSeek(&it, "^", NULL, 0);
+
+	while(raxNext(&it)) {
+		SchemaType    t   = (SchemaType)it.key[0];
+		int           id  = _DecodeUInt(it.key + 1, sizeof(uint32_t));
+		unsigned char *ids = it.key + KEY_HEADER_LEN;
+		bool          set = (IndexChange)(uintptr_t)it.data == INDEX_CHANGE_SET;
+
+		Schema *s = GraphContext_GetSchemaByID(gc, id, t);
+		ASSERT(s != NULL);
+
+		// an entity which no longer exists is removed
+		if(t == SCHEMA_NODE) {
+			Node n = GE_NEW_NODE();
+			NodeID node_id = _DecodeUInt(ids, sizeof(uint64_t));
+
+			if(set && Graph_GetNode(g, node_id, &n)) {
+				Schema_AddNodeToIndices(s, &n);
+			} else {
+				n.id = node_id;
+				Schema_RemoveNodeFromIndices(s, &n);
+			}
+		} else {
+			Edge   e       = {0};
+			EdgeID edge_id = _DecodeUInt(ids + 16, sizeof(uint64_t));
+
+			set = set && Graph_GetEdge(g, edge_id, &e);
+
+			e.id         = edge_id;
+			e.relationID = id;
+			Edge_SetSrcNodeID(&e,  _DecodeUInt(ids,     sizeof(uint64_t)));
+			Edge_SetDestNodeID(&e, _DecodeUInt(ids + 8, sizeof(uint64_t)));
+
+			if(set) Schema_AddEdgeToIndices(s, &e);
+			else Schema_RemoveEdgeFromIndices(s, &e);
+		}
+	}
+
+	raxStop(&it);
+
+	// clear buffer
+	raxFree(buff->changes);
+	buff->changes = raxNew();
+}
+
+void IndexBuffer_Free
+(
+	IndexBuffer *buff
+) {
+	if(buff == NULL) return;
+
+	_ClearCreated(buff);
+	array_free(buff->created);
+	raxFree(buff->changes);
+	rm_free(buff);
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "index.h"
+#include "../graph/graphcontext.h"
+
+// IndexBuffer accumulates index changes introduced by a query
+// changes are deduplicated by entity, the last change to an entity wins
+// entities created by the query are kept aside, they are not deduplicated
+// unless modified after their creation
+// once flushed changes are applied in schema and entity ID order
+// entities are re-read from the graph, as such an entity is indexed
+// according to its state at flush time
+
+// IndexBuffer is an opaque data structure
+typedef struct _IndexBuffer IndexBuffer;
+
+// create a new index buffer
+IndexBuffer *IndexBuffer_New(void);
+
+// returns number of buffered changes
+uint64_t IndexBuffer_Length
+(
+	const IndexBuffer *buff  // index buffer
+);
+
+// buffer a change to a node under all of schema's indices
+void IndexBuffer_AddNode
+(
+	IndexBuffer *buff,  // index buffer
+	const Schema *s,    // node schema
+	const Node *n,      // modified node
+	IndexChange change  // type of change
+);
+
+// buffer a node created by the query under all of schema's indices
+// created nodes aren't deduplicated, once flushed they are loaded into
+// exact-match indices in bulk
+void IndexBuffer_AddNewNode
+(
+	IndexBuffer *buff,  // index buffer
+	const Schema *s,    // node schema
+	const Node *n       // created node
+);
+
+// buffer a change to an edge under all of schema's indices
+void IndexBuffer_AddEdge
+(
+	IndexBuffer *buff,  // index buffer
+	const Schema *s,    // edge schema
+	const Edge *e,      // modified edge
+	IndexChange change  // type of change
+);
+
+// buffer an edge created by the query, see IndexBuffer_AddNewNode
+void IndexBuffer_AddNewEdge
+(
+	IndexBuffer *buff,  // index buffer
+	const Schema *s,    // edge schema
+	const Edge *e       // created edge
+);
+
+// apply buffered changes and clear buffer
+// expecting the graph's write lock to be held
+void IndexBuffer_Flush
+(
+	IndexBuffer *buff,  // index buffer
+	GraphContext *gc    // graph context holding the modified entities
+);
+
+// free index buffer
+void IndexBuffer_Free
+(
+	IndexBuffer *buff  // index buffer to free
+);
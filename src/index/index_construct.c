@@ -6,9 +6,43 @@
 
 #include "RG.h"
 #include "index.h"
+#include "../util/rmalloc.h"
+#include "../util/thpool/pools.h"
 #include "../graph/rg_matrix/rg_matrix_iter.h"
 
 #include <assert.h>
+#include <pthread.h>
+
+// max number of nodes a worker indexes while holding the read lock
+#define NODE_BATCH_SIZE 10000
+
+// max number of edges a worker indexes while holding the read lock
+#define EDGE_BATCH_SIZE 1000
+
+// max number of items loaded into the index while holding the read lock
+#define LOAD_BATCH_SIZE 100000
+
+// minimum number of matrix rows scanned by a single worker
+#define MIN_WORKER_ROWS 65536
+
+// tracks the workers of a single population
+typedef struct {
+	uint pending;          // number of running workers
+	pthread_mutex_t lock;  // guards pending
+	pthread_cond_t done;   // signaled once all workers are done
+} PopulateSync;
+
+// population worker, scans rows [start, end] of the indexed matrix
+typedef struct {
+	Index idx;                 // populated index
+	Graph *g;                  // graph holding the indexed entities
+	GrB_Index start;           // first row to scan
+	GrB_Index end;             // last row to scan
+	OrderedIndexRun run;       // run collecting entities, NULL indexes directly
+	bool aborted;              // index changed during population
+	void (*populate)(void *);  // population routine
+	PopulateSync *sync;        // population the worker is part of
+} PopulateWorker;
 
 // index nodes in an asynchronous manner
 // nodes are being indexed in batchs while the graph's read lock is held
@@ -16,21 +50,18 @@
 // is indexed the graph read lock is released
 // alowing for write queries to be processed
 //
-// it is safe to run a write query which effects the index by either:
-// adding/removing/updating an entity while the index is being populated
-// in the "worst" case we will index that entity twice which is perfectly OK
+// exact-match indexes collect nodes into the worker's run while write queries
+// log the entities they modify, see Index_Populate
 static void _Index_PopulateNodeIndex
 (
-	Index idx,
-	Graph *g
+	void *arg
 ) {
-	ASSERT(g   != NULL);
-	ASSERT(idx != NULL);
+	PopulateWorker *w = (PopulateWorker *)arg;
 
-	GrB_Index          rowIdx     = 0;
-	int                indexed    = 0;      // #entities in current batch
-	int                batch_size = 10000;  // max #entities to index in one go
-	RG_MatrixTupleIter it         = {0};
+	Index              idx     = w->idx;
+	Graph              *g      = w->g;
+	GrB_Index          rowIdx  = w->start;
+	RG_MatrixTupleIter it      = {0};
 
 	while(true) {
 		// lock graph for reading
@@ -41,12 +72,11 @@ static void _Index_PopulateNodeIndex
 		// 1. CREATE INDEX FOR (n:Person) ON (n.age)
 		// 2. CREATE INDEX FOR (n:Person) ON (n.height)
 		if(Index_PendingChanges(idx) > 1) {
+			w->aborted = true;
+			Graph_ReleaseLock(g);
 			break;
 		}
 
-		// reset number of indexed nodes in batch
-		indexed = 0;
-
 		// fetch label matrix
 		const RG_Matrix m = Graph_GetLabelMatrix(g, Index_GetLabelID(idx));
 		ASSERT(m != NULL);
@@ -58,7 +88,7 @@ static void _Index_PopulateNodeIndex
 		GrB_Info info;
 		info = RG_MatrixTupleIter_attach(&it, m);
 		ASSERT(info == GrB_SUCCESS);
-		info = RG_MatrixTupleIter_iterate_range(&it, rowIdx, UINT64_MAX);
+		info = RG_MatrixTupleIter_iterate_range(&it, rowIdx, w->end);
 		ASSERT(info == GrB_SUCCESS);
 
 		//----------------------------------------------------------------------
@@ -66,38 +96,40 @@ static void _Index_PopulateNodeIndex
 		//----------------------------------------------------------------------
 
 		EntityID id;
-		while(indexed < batch_size &&
+		uint64_t indexed = 0;  // #entities in current batch
+		while(indexed < NODE_BATCH_SIZE &&
 			  RG_MatrixTupleIter_next_BOOL(&it, &id, NULL, NULL) == GrB_SUCCESS)
 		{
 			Node n;
 			Graph_GetNode(g, id, &n);
-			Index_IndexNode(idx, &n);
+			if(w->run != NULL) {
+				Index_RunAddEntity(idx, w->run, (GraphEntity *)&n, &id);
+			} else {
+				Index_IndexNode(idx, &n);
+			}
 			indexed++;
 		}
 
+		Index_IncPopulated(idx, indexed);
+
 		//----------------------------------------------------------------------
 		// done with current batch
 		//----------------------------------------------------------------------
 
-		if(indexed != batch_size) {
-			// iterator depleted, no more nodes to index
-			break;
-		} else {
-			// release read lock
-			Graph_ReleaseLock(g);
+		// release read lock
+		Graph_ReleaseLock(g);
+		RG_MatrixTupleIter_detach(&it);
 
-			// finished current batch
-			RG_MatrixTupleIter_detach(&it);
+		// iterator depleted, no more nodes to index
+		if(indexed != NODE_BATCH_SIZE) break;
 
-			// continue next batch from row id+1
-			// this is true because we're iterating over a diagonal matrix
-			rowIdx = id + 1;
-		}
+		// continue next batch from row id+1
+		// this is true because we're iterating over a diagonal matrix
+		rowIdx = id + 1;
 	}
 
-	// release read lock
-	Graph_ReleaseLock(g);
-	RG_MatrixTupleIter_detach(&it);
+	// sort run outside of the lock
+	if(w->run != NULL && !w->aborted) OrderedIndexRun_Sort(w->run);
 }
 
 // index edges in an asynchronous manner
@@ -106,25 +138,23 @@ static void _Index_PopulateNodeIndex
 // is indexed the graph read lock is released
 // alowing for write queries to be processed
 //
-// it is safe to run a write query which effects the index by either:
-// adding/removing/updating an entity while the index is being populated
-// in the "worst" case we will index that entity twice which is perfectly OK
+// exact-match indexes collect edges into the worker's run while write queries
+// log the entities they modify, see Index_Populate
 static void _Index_PopulateEdgeIndex
 (
-	Index idx,
-	Graph *g
+	void *arg
 ) {
-	ASSERT(g   != NULL);
-	ASSERT(idx != NULL);
+	PopulateWorker *w = (PopulateWorker *)arg;
 
 	GrB_Info  info;
-	EntityID  src_id       = 0;     // current processed row idx
-	EntityID  dest_id      = 0;     // current processed column idx
-	EntityID  edge_id      = 0;     // current processed edge id
-	EntityID  prev_src_id  = 0;     // last processed row idx
-	EntityID  prev_dest_id = 0;     // last processed column idx
-	int       indexed      = 0;     // number of entities indexed in current batch
-	int       batch_size   = 1000;  // max number of entities to index in one go
+	Index     idx          = w->idx;
+	Graph     *g           = w->g;
+	EntityID  src_id       = w->start;  // current processed row idx
+	EntityID  dest_id      = 0;         // current processed column idx
+	EntityID  edge_id      = 0;         // current processed edge id
+	EntityID  prev_src_id  = 0;         // last processed row idx
+	EntityID  prev_dest_id = 0;         // last processed column idx
+	bool      resume       = false;     // scan continues a previous batch
 	RG_MatrixTupleIter it  = {0};
 
 	while(true) {
@@ -136,11 +166,11 @@ static void _Index_PopulateEdgeIndex
 		// 1. CREATE INDEX FOR (:Person)-[e:WORKS]-(:Company) ON (e.since)
 		// 2. CREATE INDEX FOR (:Person)-[e:WORKS]-(:Company) ON (e.title)
 		if(Index_PendingChanges(idx) > 1) {
+			w->aborted = true;
+			Graph_ReleaseLock(g);
 			break;
 		}
 
-		// reset number of indexed edges in batch
-		indexed      = 0;
 		prev_src_id  = src_id;
 		prev_dest_id = dest_id;
 
@@ -155,17 +185,20 @@ static void _Index_PopulateEdgeIndex
 
 		info = RG_MatrixTupleIter_attach(&it, m);
 		ASSERT(info == GrB_SUCCESS);
-		info = RG_MatrixTupleIter_iterate_range(&it, src_id, UINT64_MAX);
+		info = RG_MatrixTupleIter_iterate_range(&it, src_id, w->end);
 		ASSERT(info == GrB_SUCCESS);
 
-		// skip previously indexed edges
+		// skip edges indexed by the previous batch
 		while((info = RG_MatrixTupleIter_next_UINT64(&it, &src_id, &dest_id,
 						&edge_id)) == GrB_SUCCESS &&
+				resume                &&
 				src_id == prev_src_id &&
-				dest_id < prev_dest_id);
+				dest_id <= prev_dest_id);
 
 		// process only if iterator is on an active entry
 		if(info != GrB_SUCCESS) {
+			Graph_ReleaseLock(g);
+			RG_MatrixTupleIter_detach(&it);
 			break;
 		}
 
@@ -173,51 +206,129 @@ static void _Index_PopulateEdgeIndex
 		// batch index edges
 		//----------------------------------------------------------------------
 
+		uint64_t indexed = 0;  // number of entries indexed in current batch
+		uint64_t edges   = 0;  // number of edges indexed in current batch
+
 		do {
 			Edge e;
 			e.src_id     = src_id;
 			e.dest_id    = dest_id;
 			e.relationID = Index_GetLabelID(idx);
 
-			if(SINGLE_EDGE(edge_id)) {
-				Graph_GetEdge(g, edge_id, &e);
-				Index_IndexEdge(idx, &e);
-			} else {
-				EdgeID *edgeIds = (EdgeID *)(CLEAR_MSB(edge_id));
-				uint edgeCount = array_len(edgeIds);
+			uint32_t     edgeCount = 1;
+			const EdgeID *edgeIds  = &edge_id;
+			if(!SINGLE_EDGE(edge_id)) {
+				edgeIds = RG_Matrix_multiEdge(m, edge_id, &edgeCount);
+			}
 
-				for(uint i = 0; i < edgeCount; i++) {
-					edge_id = edgeIds[i];
-					Graph_GetEdge(g, edge_id, &e);
+			for(uint i = 0; i < edgeCount; i++) {
+				Graph_GetEdge(g, edgeIds[i], &e);
+				if(w->run != NULL) {
+					EdgeIndexKey key = {.src_id  = src_id,
+					                    .dest_id = dest_id,
+					                    .edge_id = edgeIds[i]};
+					Index_RunAddEntity(idx, w->run, (GraphEntity *)&e, &key);
+				} else {
 					Index_IndexEdge(idx, &e);
 				}
 			}
+
+			edges += edgeCount;
 			indexed++; // single/multi edge are counted similarly
-		} while(indexed < batch_size &&
+		} while(indexed < EDGE_BATCH_SIZE &&
 			  RG_MatrixTupleIter_next_UINT64(&it, &src_id, &dest_id, &edge_id)
 				== GrB_SUCCESS);
 
+		Index_IncPopulated(idx, edges);
+
 		//----------------------------------------------------------------------
 		// done with current batch
 		//----------------------------------------------------------------------
 
-		if(indexed != batch_size) {
-			// iterator depleted, no more edges to index
-			break;
+		// release read lock
+		Graph_ReleaseLock(g);
+		RG_MatrixTupleIter_detach(&it);
+
+		// iterator depleted, no more edges to index
+		if(indexed != EDGE_BATCH_SIZE) break;
+
+		resume = true;
+	}
+
+	// sort run outside of the lock
+	if(w->run != NULL && !w->aborted) OrderedIndexRun_Sort(w->run);
+}
+
+// applies changes logged while the index was populated
+// expecting the graph's read lock to be held
+static void _Index_ReplayChanges
+(
+	Index idx,
+	Graph *g
+) {
+	rax *changes = Index_StopChangeLog(idx);
+	ASSERT(changes != NULL);
+
+	raxIterator it;
+	raxStart(&it, changes);
+	raxSeek(&it, "^", NULL, 0);
+
+	bool nodes = Index_GraphEntityType(idx) == GETYPE_NODE;
+
+	while(raxNext(&it)) {
+		// an entity is re-read from the graph as its logged change
+		// might have been followed by further modifications
+		bool set = (IndexChange)(uintptr_t)it.data == INDEX_CHANGE_SET;
+
+		if(nodes) {
+			Node n = GE_NEW_NODE();
+			memcpy(&n.id, it.key, sizeof(EntityID));
+
+			if(set && Graph_GetNode(g, n.id, &n)) Index_IndexNode(idx, &n);
+			else Index_RemoveNode(idx, &n);
 		} else {
-			// finished current batch
-			// release read lock
-			Graph_ReleaseLock(g);
-			RG_MatrixTupleIter_detach(&it);
+			EdgeIndexKey key;
+			memcpy(&key, it.key, sizeof(EdgeIndexKey));
+
+			Edge e = {0};
+			e.id         = key.edge_id;
+			e.relationID = Index_GetLabelID(idx);
+
+			set = set && Graph_GetEdge(g, key.edge_id, &e);
+			e.src_id  = key.src_id;
+			e.dest_id = key.dest_id;
+
+			if(set) Index_IndexEdge(idx, &e);
+			else Index_RemoveEdge(idx, &e);
 		}
 	}
 
-	// release read lock
-	Graph_ReleaseLock(g);
-	RG_MatrixTupleIter_detach(&it);
+	raxStop(&it);
+	raxFree(changes);
+}
+
+// runs a population worker on the indexers pool
+// and notifies the population once its last worker is done
+static void _Index_PopulateTask
+(
+	void *arg
+) {
+	PopulateWorker *worker = (PopulateWorker *)arg;
+	PopulateSync   *sync   = worker->sync;
+
+	worker->populate(worker);
+
+	pthread_mutex_lock(&sync->lock);
+	if(--sync->pending == 0) pthread_cond_signal(&sync->done);
+	pthread_mutex_unlock(&sync->lock);
 }
 
 // constructs index
+//
+// fulltext indexes are populated by a single worker
+// exact-match indexes are populated by multiple workers, each scanning
+// a distinct range of rows into a sorted run, runs are then bulk loaded
+// into the index and the entities modified meanwhile are re-indexed
 void Index_Populate
 (
 	Index idx,
@@ -227,14 +338,131 @@ void Index_Populate
 	ASSERT(idx != NULL);
 	ASSERT(!Index_Enabled(idx));  // index should have pending changes
 
+	bool      native   = Index_Type(idx) == IDX_EXACT_MATCH;
+	bool      nodes    = Index_GraphEntityType(idx) == GETYPE_NODE;
+	int       label_id = Index_GetLabelID(idx);
+	uint      n        = 1;  // number of workers
+	GrB_Index dim      = 0;  // number of rows to scan
+
+	//--------------------------------------------------------------------------
+	// prepare index
+	//--------------------------------------------------------------------------
+
+	Graph_AcquireReadLock(g);
+
+	// index state changed, abort indexing
+	if(Index_PendingChanges(idx) > 1) {
+		Graph_ReleaseLock(g);
+		return;
+	}
+
+	Index_SetPopulationSize(idx, nodes ?
+			Graph_LabeledNodeCount(g, label_id) :
+			Graph_RelationEdgeCount(g, label_id));
+
+	if(native) {
+		// from this point on write queries log the entities they modify
+		Index_StartChangeLog(idx);
+
+		// spread rows among indexers, each scanning at least MIN_WORKER_ROWS
+		dim = Graph_RequiredMatrixDim(g);
+		n   = ThreadPools_IndexersCount();
+		if(n > dim / MIN_WORKER_ROWS) n = dim / MIN_WORKER_ROWS;
+		if(n == 0) n = 1;
+	}
+
+	Graph_ReleaseLock(g);
+
 	//--------------------------------------------------------------------------
 	// populate index
 	//--------------------------------------------------------------------------
 
-	if(Index_GraphEntityType(idx) == GETYPE_NODE) {
-		_Index_PopulateNodeIndex(idx, g);
+	uint16_t       field_count = Index_FieldsCount(idx);
+	size_t         key_len     = nodes ? sizeof(EntityID) : sizeof(EdgeIndexKey);
+	void           (*populate)(void *) = nodes ?
+		_Index_PopulateNodeIndex : _Index_PopulateEdgeIndex;
+	PopulateWorker workers[n];
+
+	for(uint i = 0; i < n; i++) {
+		workers[i].idx      = idx;
+		workers[i].g        = g;
+		workers[i].start    = i * (dim / n);
+		workers[i].end      = (i == n - 1) ? UINT64_MAX : (i + 1) * (dim / n) - 1;
+		workers[i].run      = native ?
+			OrderedIndexRun_New(field_count, key_len) : NULL;
+		workers[i].aborted  = false;
+		workers[i].populate = NULL;
+		workers[i].sync     = NULL;
+	}
+
+	if(n == 1) {
+		populate(workers);
 	} else {
-		_Index_PopulateEdgeIndex(idx, g);
+		// the indexers pool is shared among concurrent populations
+		// wait for this population's workers only
+		PopulateSync sync = {.pending = n};
+		pthread_mutex_init(&sync.lock, NULL);
+		pthread_cond_init(&sync.done, NULL);
+
+		for(uint i = 0; i < n; i++) {
+			workers[i].populate = populate;
+			workers[i].sync     = &sync;
+			int res = ThreadPools_AddWorkIndexer(_Index_PopulateTask,
+					workers + i);
+			ASSERT(res == 0);
+			UNUSED(res);
+		}
+
+		pthread_mutex_lock(&sync.lock);
+		while(sync.pending > 0) pthread_cond_wait(&sync.done, &sync.lock);
+		pthread_mutex_unlock(&sync.lock);
+
+		pthread_cond_destroy(&sync.done);
+		pthread_mutex_destroy(&sync.lock);
 	}
-}
 
+	if(!native) return;
+
+	//--------------------------------------------------------------------------
+	// bulk load runs
+	//--------------------------------------------------------------------------
+
+	OrderedIndexRun runs[n];
+	bool            aborted = false;
+
+	for(uint i = 0; i < n; i++) {
+		runs[i]  = workers[i].run;
+		aborted |= workers[i].aborted;
+	}
+
+	bool loaded = aborted;
+	while(!loaded) {
+		// the read lock protects the index from being dropped
+		Graph_AcquireReadLock(g);
+
+		if(Index_PendingChanges(idx) > 1) {
+			aborted = true;
+			loaded  = true;
+		} else {
+			loaded = OrderedIndex_Load(Index_OrderedIndex(idx), runs, n,
+					LOAD_BATCH_SIZE);
+		}
+
+		Graph_ReleaseLock(g);
+	}
+
+	for(uint i = 0; i < n; i++) OrderedIndexRun_Free(runs[i]);
+
+	//--------------------------------------------------------------------------
+	// catch up with entities modified during population
+	//--------------------------------------------------------------------------
+
+	// an aborted index had its change log discarded by Index_Disable
+	if(aborted) return;
+
+	Graph_AcquireReadLock(g);
+
+	if(Index_PendingChanges(idx) == 1) _Index_ReplayChanges(idx, g);
+
+	Graph_ReleaseLock(g);
+}
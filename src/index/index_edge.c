@@ -13,6 +13,10 @@
 
 extern RSDoc *Index_IndexGraphEntity(Index idx,const GraphEntity *e,
 		const void *key, size_t key_len, uint *doc_field_count);
+extern void Index_SetEntityValues(Index idx, const GraphEntity *e,
+		const void *key);
+extern void Index_LoadEntities(Index idx, const GraphEntity **entities,
+		const unsigned char *keys, uint64_t n);
 
 void Index_IndexEdge
 (
@@ -31,6 +35,14 @@ void Index_IndexEdge
 	EdgeIndexKey key = {.src_id = src_id, .dest_id = dest_id, .edge_id = edge_id};
 	size_t key_len = sizeof(EdgeIndexKey);
 
+	if(Index_Type(idx) == IDX_EXACT_MATCH) {
+		// index is being populated, edge is re-indexed once population is done
+		if(Index_LogChange(idx, &key, INDEX_CHANGE_SET)) return;
+
+		Index_SetEntityValues(idx, (const GraphEntity *)e, &key);
+		return;
+	}
+
 	uint doc_field_count = 0;
 	doc = Index_IndexGraphEntity(idx, (const GraphEntity *)e,
 			(const void *)&key, key_len, &doc_field_count);
@@ -44,12 +56,40 @@ void Index_IndexEdge
 	}
 
 	// add document to active RediSearch index
-	// add src_node and dest_node fields
-	RediSearch_DocumentAddFieldNumber(doc, "_src_id", src_id, RSFLDTYPE_NUMERIC);
-	RediSearch_DocumentAddFieldNumber(doc, "_dest_id", dest_id, RSFLDTYPE_NUMERIC);
 	RediSearch_SpecAddDocument(rsIdx, doc);
 }
 
+void Index_IndexNewEdges
+(
+	Index idx,
+	const Edge *edges,
+	uint64_t n
+) {
+	ASSERT(idx   != NULL);
+	ASSERT(edges != NULL);
+
+	if(Index_Type(idx) != IDX_EXACT_MATCH) {
+		for(uint64_t i = 0; i < n; i++) Index_IndexEdge(idx, edges + i);
+		return;
+	}
+
+	EdgeIndexKey      *keys     = rm_malloc(sizeof(EdgeIndexKey) * n);
+	const GraphEntity **entities = rm_malloc(sizeof(GraphEntity *) * n);
+
+	for(uint64_t i = 0; i < n; i++) {
+		const Edge *e = edges + i;
+		keys[i].src_id  = Edge_GetSrcNodeID(e);
+		keys[i].dest_id = Edge_GetDestNodeID(e);
+		keys[i].edge_id = ENTITY_GET_ID(e);
+		entities[i]     = (const GraphEntity *)e;
+	}
+
+	Index_LoadEntities(idx, entities, (const unsigned char *)keys, n);
+
+	rm_free(keys);
+	rm_free(entities);
+}
+
 void Index_RemoveEdge
 (
 	Index idx,     // index to update
@@ -65,6 +105,14 @@ void Index_RemoveEdge
 
 	EdgeIndexKey key = {.src_id = src_id, .dest_id = dest_id, .edge_id = edge_id};
 	size_t key_len = sizeof(EdgeIndexKey);
+
+	if(Index_Type(idx) == IDX_EXACT_MATCH) {
+		if(Index_LogChange(idx, &key, INDEX_CHANGE_REMOVE)) return;
+
+		OrderedIndex_Remove(Index_OrderedIndex(idx), &key);
+		return;
+	}
+
 	RediSearch_DeleteDocument(rsIdx, &key, key_len);
 }
 
@@ -13,6 +13,10 @@
 
 extern RSDoc *Index_IndexGraphEntity(Index idx, const GraphEntity *e,
 		const void *key, size_t key_len, uint *doc_field_count);
+extern void Index_SetEntityValues(Index idx, const GraphEntity *e,
+		const void *key);
+extern void Index_LoadEntities(Index idx, const GraphEntity **entities,
+		const unsigned char *keys, uint64_t n);
 
 void Index_IndexNode
 (
@@ -28,6 +32,14 @@ void Index_IndexNode
 	size_t   key_len         = sizeof(EntityID);
 	uint     doc_field_count = 0;
 
+	if(Index_Type(idx) == IDX_EXACT_MATCH) {
+		// index is being populated, node is re-indexed once population is done
+		if(Index_LogChange(idx, &key, INDEX_CHANGE_SET)) return;
+
+		Index_SetEntityValues(idx, (const GraphEntity *)n, &key);
+		return;
+	}
+
 	// create RediSearch document representing node
 	doc = Index_IndexGraphEntity(idx, (const GraphEntity *)n,
 			(const void *)&key, key_len, &doc_field_count);
@@ -44,6 +56,34 @@ void Index_IndexNode
 	RediSearch_SpecAddDocument(rsIdx, doc);
 }
 
+void Index_IndexNewNodes
+(
+	Index idx,
+	const Node *nodes,
+	uint64_t n
+) {
+	ASSERT(idx   != NULL);
+	ASSERT(nodes != NULL);
+
+	if(Index_Type(idx) != IDX_EXACT_MATCH) {
+		for(uint64_t i = 0; i < n; i++) Index_IndexNode(idx, nodes + i);
+		return;
+	}
+
+	EntityID          *keys     = rm_malloc(sizeof(EntityID) * n);
+	const GraphEntity **entities = rm_malloc(sizeof(GraphEntity *) * n);
+
+	for(uint64_t i = 0; i < n; i++) {
+		keys[i]     = ENTITY_GET_ID(nodes + i);
+		entities[i] = (const GraphEntity *)(nodes + i);
+	}
+
+	Index_LoadEntities(idx, entities, (const unsigned char *)keys, n);
+
+	rm_free(keys);
+	rm_free(entities);
+}
+
 void Index_RemoveNode
 (
 	Index idx,     // index to update
@@ -55,6 +95,13 @@ void Index_RemoveNode
 	EntityID id     = ENTITY_GET_ID(n);
 	RSIndex  *rsIdx = Index_RSIndex(idx);
 
+	if(Index_Type(idx) == IDX_EXACT_MATCH) {
+		if(Index_LogChange(idx, &id, INDEX_CHANGE_REMOVE)) return;
+
+		OrderedIndex_Remove(Index_OrderedIndex(idx), &id);
+		return;
+	}
+
 	RediSearch_DeleteDocument(rsIdx, &id, sizeof(EntityID));
 }
 
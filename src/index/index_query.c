@@ -0,0 +1,379 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "index.h"
+#include "index_query.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+struct _IndexQuery {
+	OrderedIndex oi;          // queried index
+	IndexCheck **clauses;     // disjunction of clauses
+	bool planned;             // clauses were arranged for scanning
+	bool dedup;               // clauses might overlap
+	bool sorted;              // entities are requested ordered by sort_field
+	bool descending;          // requested order is descending
+	bool ordered;             // entities are returned in requested order
+	uint16_t sort_field;      // field entities are requested ordered by
+	bool src_bound;           // edges must leave src_id
+	bool dest_bound;          // edges must enter dest_id
+	EntityID src_id;          // edges source node ID
+	EntityID dest_id;         // edges destination node ID
+	uint clause;              // current scanned clause
+	bool scanning;            // iterator is attached to current clause
+	OrderedIndexIterator it;  // current clause iterator
+	uint64_t key[3];          // last returned entity key
+};
+
+IndexQuery *IndexQuery_New
+(
+	OrderedIndex oi
+) {
+	ASSERT(oi != NULL);
+	ASSERT(OrderedIndex_KeyLen(oi) <= sizeof(((IndexQuery *)0)->key));
+
+	IndexQuery *q = rm_calloc(1, sizeof(IndexQuery));
+
+	q->oi      = oi;
+	q->clauses = array_new(IndexCheck *, 1);
+
+	return q;
+}
+
+void IndexQuery_AddClause
+(
+	IndexQuery *q,
+	IndexCheck *checks
+) {
+	ASSERT(q      != NULL);
+	ASSERT(checks != NULL);
+	ASSERT(!q->planned);
+
+	array_append(q->clauses, checks);
+}
+
+void IndexQuery_SetSrc
+(
+	IndexQuery *q,
+	EntityID src_id
+) {
+	ASSERT(q != NULL);
+	ASSERT(OrderedIndex_KeyLen(q->oi) == sizeof(EdgeIndexKey));
+
+	q->src_id    = src_id;
+	q->src_bound = true;
+}
+
+void IndexQuery_SetDest
+(
+	IndexQuery *q,
+	EntityID dest_id
+) {
+	ASSERT(q != NULL);
+	ASSERT(OrderedIndex_KeyLen(q->oi) == sizeof(EdgeIndexKey));
+
+	q->dest_id    = dest_id;
+	q->dest_bound = true;
+}
+
+void IndexQuery_SetOrder
+(
+	IndexQuery *q,
+	uint16_t field,
+	bool descending
+) {
+	ASSERT(q != NULL);
+	ASSERT(!q->planned);
+
+	q->sorted     = true;
+	q->descending = descending;
+	q->sort_field = field;
+}
+
+static int _ClauseCmp
+(
+	const void *a,
+	const void *b
+) {
+	const IndexCheck *x = *(IndexCheck * const *)a;
+	const IndexCheck *y = *(IndexCheck * const *)b;
+
+	return IndexRange_CompareMin(&x->range, &y->range);
+}
+
+// returns true if scanning planned clauses in sequence
+// visits entities in order of the sort field
+static bool _IndexQuery_Orderable
+(
+	const IndexQuery *q
+) {
+	// overlapping clauses aren't sorted nor disjoint
+	if(q->dedup) return false;
+
+	unsigned char bucket = 0;
+	uint          n      = array_len(q->clauses);
+
+	for(uint i = 0; i < n; i++) {
+		IndexCheck *checks = q->clauses[i];
+
+		// clause must be scanned by the sort field
+		if(array_len(checks) == 0 || checks[0].field != q->sort_field) {
+			return false;
+		}
+
+		// index and Cypher orders agree within these buckets
+		unsigned char b = IndexRange_Bucket(&checks[0].range);
+		if(b != INDEX_VALUE_BOOL    &&
+		   b != INDEX_VALUE_NUMERIC &&
+		   b != INDEX_VALUE_STRING) {
+			return false;
+		}
+
+		// Cypher orders types differently than the index does
+		if(i > 0 && b != bucket) return false;
+		bucket = b;
+	}
+
+	return true;
+}
+
+// arranges clauses for scanning
+static void _IndexQuery_Plan
+(
+	IndexQuery *q
+) {
+	uint n = array_len(q->clauses);
+
+	//--------------------------------------------------------------------------
+	// an empty clause matches all entities, drop all other clauses
+	//--------------------------------------------------------------------------
+
+	for(uint i = 0; i < n; i++) {
+		if(array_len(q->clauses[i]) > 0) continue;
+
+		IndexCheck *all = q->clauses[i];
+		array_del_fast(q->clauses, i);
+		for(uint j = 0; j < array_len(q->clauses); j++) {
+			IndexQuery_FreeChecks(q->clauses[j]);
+		}
+		array_clear(q->clauses);
+		array_append(q->clauses, all);
+		return;
+	}
+
+	//--------------------------------------------------------------------------
+	// scan each clause by its most selective check
+	//--------------------------------------------------------------------------
+
+	for(uint i = 0; i < n; i++) {
+		IndexCheck *checks = q->clauses[i];
+		uint check_count = array_len(checks);
+		for(uint j = 1; j < check_count; j++) {
+			if(IndexRange_IsExact(&checks[j].range)) {
+				IndexCheck tmp = checks[0];
+				checks[0] = checks[j];
+				checks[j] = tmp;
+				break;
+			}
+		}
+	}
+
+	//--------------------------------------------------------------------------
+	// merge single check clauses over the same field into disjoint ranges
+	//--------------------------------------------------------------------------
+
+	bool mergeable = n > 1;
+	for(uint i = 0; i < n && mergeable; i++) {
+		mergeable = array_len(q->clauses[i]) == 1 &&
+			q->clauses[i][0].field == q->clauses[0][0].field;
+	}
+
+	if(mergeable) {
+		qsort(q->clauses, n, sizeof(IndexCheck *), _ClauseCmp);
+
+		uint last = 0;
+		for(uint i = 1; i < n; i++) {
+			IndexCheck *c = q->clauses[i];
+			if(IndexRange_Merge(&q->clauses[last][0].range, &c[0].range)) {
+				IndexQuery_FreeChecks(c);
+			} else {
+				q->clauses[++last] = c;
+			}
+		}
+		q->clauses = array_trimm_len(q->clauses, last + 1);
+	}
+
+	q->dedup = !mergeable && n > 1;
+
+	//--------------------------------------------------------------------------
+	// order entities by scanning clauses in sequence
+	//--------------------------------------------------------------------------
+
+	if(q->sorted && _IndexQuery_Orderable(q)) {
+		q->ordered = true;
+
+		// scan clauses from the greatest range down
+		if(q->descending) {
+			n = array_len(q->clauses);
+			for(uint i = 0; i < n / 2; i++) {
+				IndexCheck *tmp = q->clauses[i];
+				q->clauses[i] = q->clauses[n - 1 - i];
+				q->clauses[n - 1 - i] = tmp;
+			}
+		}
+	}
+}
+
+bool IndexQuery_Ordered
+(
+	IndexQuery *q
+) {
+	ASSERT(q != NULL);
+
+	if(!q->planned) {
+		_IndexQuery_Plan(q);
+		q->planned = true;
+	}
+
+	return q->ordered;
+}
+
+// returns true if entity satisfies clause checks starting at 'from'
+static bool _IndexQuery_PassChecks
+(
+	const IndexQuery *q,
+	IndexCheck *checks,
+	uint from,
+	const unsigned char *key
+) {
+	uint n = array_len(checks);
+	for(uint i = from; i < n; i++) {
+		size_t len;
+		const unsigned char *v =
+			OrderedIndex_GetValue(q->oi, key, checks[i].field, &len);
+		if(v == NULL || !IndexRange_Contains(&checks[i].range, v, len)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// returns true if edge connects the required nodes
+static bool _IndexQuery_PassEndpoints
+(
+	const IndexQuery *q,
+	const unsigned char *key
+) {
+	if(!q->src_bound && !q->dest_bound) return true;
+
+	EdgeIndexKey e;
+	memcpy(&e, key, sizeof(EdgeIndexKey));
+
+	if(q->src_bound  && e.src_id  != q->src_id)  return false;
+	if(q->dest_bound && e.dest_id != q->dest_id) return false;
+
+	return true;
+}
+
+const void *IndexQuery_Next
+(
+	IndexQuery *q
+) {
+	ASSERT(q != NULL);
+
+	if(!q->planned) {
+		_IndexQuery_Plan(q);
+		q->planned = true;
+	}
+
+	size_t key_len = OrderedIndex_KeyLen(q->oi);
+	uint   n       = array_len(q->clauses);
+
+	while(q->clause < n) {
+		IndexCheck *checks = q->clauses[q->clause];
+
+		// attach iterator to clause's first check
+		if(!q->scanning) {
+			if(array_len(checks) > 0) {
+				OrderedIndexIterator_Init(&q->it, q->oi, checks[0].field,
+						&checks[0].range, q->ordered && q->descending);
+			} else {
+				OrderedIndexIterator_Init(&q->it, q->oi, 0, NULL, false);
+			}
+			q->scanning = true;
+		}
+
+		const unsigned char *key;
+		while((key = OrderedIndexIterator_Next(&q->it)) != NULL) {
+			if(!_IndexQuery_PassEndpoints(q, key))         continue;
+			if(!_IndexQuery_PassChecks(q, checks, 1, key)) continue;
+
+			// skip entities returned by a previous clause
+			if(q->dedup) {
+				bool seen = false;
+				for(uint i = 0; i < q->clause && !seen; i++) {
+					seen = _IndexQuery_PassChecks(q, q->clauses[i], 0, key);
+				}
+				if(seen) continue;
+			}
+
+			memcpy(q->key, key, key_len);
+			return q->key;
+		}
+
+		// clause depleted, advance to next clause
+		OrderedIndexIterator_Free(&q->it);
+		q->scanning = false;
+		q->clause++;
+	}
+
+	return NULL;
+}
+
+void IndexQuery_Reset
+(
+	IndexQuery *q
+) {
+	ASSERT(q != NULL);
+
+	if(q->scanning) {
+		OrderedIndexIterator_Free(&q->it);
+		q->scanning = false;
+	}
+
+	q->clause = 0;
+}
+
+void IndexQuery_FreeChecks
+(
+	IndexCheck *checks
+) {
+	ASSERT(checks != NULL);
+
+	uint n = array_len(checks);
+	for(uint i = 0; i < n; i++) IndexRange_Free(&checks[i].range);
+	array_free(checks);
+}
+
+void IndexQuery_Free
+(
+	IndexQuery *q
+) {
+	ASSERT(q != NULL);
+
+	if(q->scanning) OrderedIndexIterator_Free(&q->it);
+
+	uint n = array_len(q->clauses);
+	for(uint i = 0; i < n; i++) IndexQuery_FreeChecks(q->clauses[i]);
+	array_free(q->clauses);
+
+	rm_free(q);
+}
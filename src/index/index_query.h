@@ -0,0 +1,102 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "index_range.h"
+#include "ordered_index.h"
+#include "../graph/entities/graph_entity.h"
+
+// exact-match index query
+//
+// a query is a disjunction of clauses
+// each clause is a conjunction of checks, a check restricts a field's value
+// to a range, an empty clause matches every indexed entity
+//
+// a clause is resolved by scanning the range of one of its checks
+// and verifying its remaining checks against the entity's indexed values
+// when clauses might overlap an entity is only returned by the first clause
+// it satisfies
+
+// restricts field value to a range
+typedef struct {
+	uint16_t field;    // field position
+	IndexRange range;  // range of valid values
+} IndexCheck;
+
+typedef struct _IndexQuery IndexQuery;
+
+// create a new query over an ordered index
+IndexQuery *IndexQuery_New
+(
+	OrderedIndex oi  // queried index
+);
+
+// adds a clause to the query
+// the query takes ownership of 'checks', an array of checks
+void IndexQuery_AddClause
+(
+	IndexQuery *q,      // query to extend
+	IndexCheck *checks  // conjunction of checks
+);
+
+// restricts returned edges to edges leaving 'src_id'
+void IndexQuery_SetSrc
+(
+	IndexQuery *q,   // query to restrict
+	EntityID src_id  // source node ID
+);
+
+// restricts returned edges to edges entering 'dest_id'
+void IndexQuery_SetDest
+(
+	IndexQuery *q,    // query to restrict
+	EntityID dest_id  // destination node ID
+);
+
+// requests entities to be returned in order of a field's value
+// the order is only followed if the query is resolved by scanning
+// a single bucket of the field's values, see IndexQuery_Ordered
+void IndexQuery_SetOrder
+(
+	IndexQuery *q,     // query to order
+	uint16_t field,    // field position
+	bool descending    // order entities by descending value
+);
+
+// returns true if entities are returned in the order requested by
+// IndexQuery_SetOrder, in which case returned values are either all booleans,
+// all numbers or all strings, ordered as Cypher orders them
+// entities sharing a value's encoding are returned in no particular order
+bool IndexQuery_Ordered
+(
+	IndexQuery *q  // query
+);
+
+// returns next matching entity key, NULL once query is depleted
+// key is either an EntityID or an EdgeIndexKey
+const void *IndexQuery_Next
+(
+	IndexQuery *q  // query to advance
+);
+
+// restart query
+void IndexQuery_Reset
+(
+	IndexQuery *q  // query to reset
+);
+
+// free clause checks
+void IndexQuery_FreeChecks
+(
+	IndexCheck *checks  // checks array to free
+);
+
+// free query
+void IndexQuery_Free
+(
+	IndexQuery *q  // query to free
+);
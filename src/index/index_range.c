@@ -0,0 +1,466 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "index_range.h"
+#include "../util/rmalloc.h"
+#include "../datatypes/point.h"
+
+#include <math.h>
+#include <string.h>
+
+// returns the bucket 'v' is indexed under
+static unsigned char _IndexValue_Tag
+(
+	SIValue v
+) {
+	switch(SI_TYPE(v)) {
+		case T_BOOL:
+			return INDEX_VALUE_BOOL;
+		case T_INT64:
+			return INDEX_VALUE_NUMERIC;
+		case T_DOUBLE:
+			// NaN doesn't compare to any number
+			return isnan(v.doubleval) ? INDEX_VALUE_OTHER : INDEX_VALUE_NUMERIC;
+		case T_STRING:
+			return INDEX_VALUE_STRING;
+		case T_POINT:
+			return INDEX_VALUE_POINT;
+		default:
+			return INDEX_VALUE_OTHER;
+	}
+}
+
+// encodes a double such that the encoded bytes order as the doubles do
+static void _EncodeDouble
+(
+	double d,
+	unsigned char *buf
+) {
+	// -0.0 and 0.0 are equal
+	if(d == 0) d = 0;
+
+	uint64_t bits;
+	memcpy(&bits, &d, sizeof(bits));
+
+	// flip all bits of negative numbers, flip sign bit of positive numbers
+	bits = (bits >> 63) ? ~bits : (bits | (1ULL << 63));
+
+	// big-endian
+	for(int i = 0; i < 8; i++) buf[i] = bits >> (56 - 8 * i);
+}
+
+// inverse of _EncodeDouble, -0.0 is decoded as 0.0
+static double _DecodeDouble
+(
+	const unsigned char *buf
+) {
+	uint64_t bits = 0;
+	for(int i = 0; i < 8; i++) bits = (bits << 8) | buf[i];
+
+	bits = (bits >> 63) ? (bits & ~(1ULL << 63)) : ~bits;
+
+	double d;
+	memcpy(&d, &bits, sizeof(d));
+	return d;
+}
+
+// sets range bound to a copy of 'v'
+static void _SetBound
+(
+	unsigned char **bound,
+	size_t *bound_len,
+	const unsigned char *v,
+	size_t len
+) {
+	*bound     = rm_malloc(len);
+	*bound_len = len;
+	memcpy(*bound, v, len);
+}
+
+size_t IndexValue_Len
+(
+	SIValue v
+) {
+	switch(_IndexValue_Tag(v)) {
+		case INDEX_VALUE_BOOL:
+			return 2;
+		case INDEX_VALUE_NUMERIC:
+			return 9;
+		case INDEX_VALUE_STRING:
+			return strlen(v.stringval) + 2;
+		case INDEX_VALUE_POINT:
+			return 17;
+		default:
+			return 1;
+	}
+}
+
+size_t IndexValue_Encode
+(
+	SIValue v,
+	unsigned char *buf
+) {
+	ASSERT(buf != NULL);
+
+	size_t len;
+	unsigned char tag = _IndexValue_Tag(v);
+
+	buf[0] = tag;
+
+	switch(tag) {
+		case INDEX_VALUE_BOOL:
+			buf[1] = v.longval != 0;
+			return 2;
+		case INDEX_VALUE_NUMERIC:
+			_EncodeDouble(SI_GET_NUMERIC(v), buf + 1);
+			return 9;
+		case INDEX_VALUE_STRING:
+			// strings can't contain '\0', terminator keeps encoding prefix free
+			len = strlen(v.stringval);
+			memcpy(buf + 1, v.stringval, len + 1);
+			return len + 2;
+		case INDEX_VALUE_POINT:
+			_EncodeDouble(Point_lat(v), buf + 1);
+			_EncodeDouble(Point_lon(v), buf + 9);
+			return 17;
+		default:
+			return 1;
+	}
+}
+
+size_t IndexValue_StoredLen
+(
+	SIValue v
+) {
+	size_t len = IndexValue_Len(v);
+	if(_IndexValue_Tag(v) == INDEX_VALUE_NUMERIC) {
+		len += INDEX_VALUE_NUMERIC_SUFFIX_LEN;
+	}
+
+	return len;
+}
+
+size_t IndexValue_Store
+(
+	SIValue v,
+	unsigned char *buf
+) {
+	ASSERT(buf != NULL);
+
+	size_t len = IndexValue_Encode(v, buf);
+	if(buf[0] != INDEX_VALUE_NUMERIC) return len;
+
+	// suffix: original type followed by its native representation
+	unsigned char *suffix = buf + len;
+	suffix[0] = (SI_TYPE(v) == T_INT64);
+	if(SI_TYPE(v) == T_INT64) memcpy(suffix + 1, &v.longval, 8);
+	else memcpy(suffix + 1, &v.doubleval, 8);
+
+	return len + INDEX_VALUE_NUMERIC_SUFFIX_LEN;
+}
+
+size_t IndexValue_EncodedLen
+(
+	const unsigned char *stored,
+	size_t len
+) {
+	ASSERT(stored != NULL);
+
+	if(stored[0] != INDEX_VALUE_NUMERIC) return len;
+
+	ASSERT(len == 9 + INDEX_VALUE_NUMERIC_SUFFIX_LEN);
+	return len - INDEX_VALUE_NUMERIC_SUFFIX_LEN;
+}
+
+bool IndexValue_Decode
+(
+	const unsigned char *stored,
+	size_t len,
+	SIValue *v
+) {
+	ASSERT(v      != NULL);
+	ASSERT(len    >  0);
+	ASSERT(stored != NULL);
+
+	const unsigned char *suffix = stored + 9;
+
+	switch(stored[0]) {
+		case INDEX_VALUE_BOOL:
+			*v = SI_BoolVal(stored[1]);
+			return true;
+		case INDEX_VALUE_NUMERIC:
+			if(suffix[0]) {
+				int64_t l;
+				memcpy(&l, suffix + 1, 8);
+				*v = SI_LongVal(l);
+			} else {
+				double d;
+				memcpy(&d, suffix + 1, 8);
+				*v = SI_DoubleVal(d);
+			}
+			return true;
+		case INDEX_VALUE_STRING:
+			*v = SI_ConstStringVal((const char *)stored + 1);
+			return true;
+		case INDEX_VALUE_POINT:
+			// points hold single precision coordinates, widened losslessly
+			*v = SI_Point(_DecodeDouble(stored + 1), _DecodeDouble(stored + 9));
+			return true;
+		default:
+			// value isn't represented by its encoding
+			return false;
+	}
+}
+
+int IndexValue_Compare
+(
+	const unsigned char *a,
+	size_t a_len,
+	const unsigned char *b,
+	size_t b_len
+) {
+	int c = memcmp(a, b, (a_len < b_len) ? a_len : b_len);
+	if(c != 0) return c;
+
+	return (a_len > b_len) - (a_len < b_len);
+}
+
+bool IndexRange_FromPredicate
+(
+	IndexRange *r,
+	AST_Operator op,
+	SIValue v
+) {
+	ASSERT(r != NULL);
+	ASSERT(op == OP_LT    ||
+		   op == OP_LE    ||
+		   op == OP_GT    ||
+		   op == OP_GE    ||
+		   op == OP_EQUAL);
+
+	unsigned char tag      = _IndexValue_Tag(v);
+	unsigned char bucket[] = {tag, tag + 1};
+	bool          exact    = tag == INDEX_VALUE_BOOL    ||
+	                         tag == INDEX_VALUE_NUMERIC ||
+	                         tag == INDEX_VALUE_STRING  ||
+	                         (tag == INDEX_VALUE_POINT && op == OP_EQUAL);
+
+	// values which can't be ordered, scan their entire bucket
+	if(!exact) {
+		_SetBound(&r->min, &r->min_len, bucket, 1);
+		_SetBound(&r->max, &r->max_len, bucket + 1, 1);
+		r->include_min = true;
+		r->include_max = false;
+		return false;
+	}
+
+	// large numbers might collide with their neighbours once indexed
+	// include bounds and have the predicate re-evaluated
+	if(tag == INDEX_VALUE_NUMERIC &&
+	   fabs((double)SI_GET_NUMERIC(v)) >= INDEX_EXACT_NUMERIC_MAX) {
+		exact = false;
+		if(op == OP_LT) op = OP_LE;
+		if(op == OP_GT) op = OP_GE;
+	}
+
+	size_t        len = IndexValue_Len(v);
+	unsigned char enc[len];
+	IndexValue_Encode(v, enc);
+
+	switch(op) {
+		case OP_EQUAL:
+			_SetBound(&r->min, &r->min_len, enc, len);
+			_SetBound(&r->max, &r->max_len, enc, len);
+			r->include_min = true;
+			r->include_max = true;
+			break;
+		case OP_LT:
+		case OP_LE:
+			_SetBound(&r->min, &r->min_len, bucket, 1);
+			_SetBound(&r->max, &r->max_len, enc, len);
+			r->include_min = true;
+			r->include_max = (op == OP_LE);
+			break;
+		case OP_GT:
+		case OP_GE:
+			_SetBound(&r->min, &r->min_len, enc, len);
+			_SetBound(&r->max, &r->max_len, bucket + 1, 1);
+			r->include_min = (op == OP_GE);
+			r->include_max = false;
+			break;
+		default:
+			ASSERT(false && "unexpected operation");
+			break;
+	}
+
+	return exact;
+}
+
+void IndexRange_Latitude
+(
+	IndexRange *r,
+	double lat_min,
+	double lat_max
+) {
+	ASSERT(r != NULL);
+
+	// lower bound is a prefix of all points at lat_min
+	// upper bound follows all points at lat_max
+	unsigned char min[9];
+	unsigned char max[17];
+
+	min[0] = INDEX_VALUE_POINT;
+	max[0] = INDEX_VALUE_POINT;
+	_EncodeDouble(lat_min, min + 1);
+	_EncodeDouble(lat_max, max + 1);
+	memset(max + 9, 0xFF, 8);
+
+	_SetBound(&r->min, &r->min_len, min, sizeof(min));
+	_SetBound(&r->max, &r->max_len, max, sizeof(max));
+	r->include_min = true;
+	r->include_max = true;
+}
+
+bool IndexRange_Contains
+(
+	const IndexRange *r,
+	const unsigned char *v,
+	size_t len
+) {
+	ASSERT(r != NULL);
+	ASSERT(v != NULL);
+
+	int c = IndexValue_Compare(v, len, r->min, r->min_len);
+	if(c < 0 || (c == 0 && !r->include_min)) return false;
+
+	c = IndexValue_Compare(v, len, r->max, r->max_len);
+	return c < 0 || (c == 0 && r->include_max);
+}
+
+bool IndexRange_IsExact
+(
+	const IndexRange *r
+) {
+	ASSERT(r != NULL);
+
+	return r->include_min && r->include_max &&
+		IndexValue_Compare(r->min, r->min_len, r->max, r->max_len) == 0;
+}
+
+unsigned char IndexRange_Bucket
+(
+	const IndexRange *r
+) {
+	ASSERT(r != NULL);
+	ASSERT(r->min_len > 0 && r->max_len > 0);
+
+	unsigned char tag = r->min[0];
+
+	// upper bound within the bucket or at the start of the next bucket
+	if(r->max[0] == tag) return tag;
+	if(r->max[0] == tag + 1 && r->max_len == 1 && !r->include_max) return tag;
+
+	return 0;
+}
+
+bool IndexRange_Intersect
+(
+	IndexRange *r,
+	const IndexRange *other
+) {
+	ASSERT(r     != NULL);
+	ASSERT(other != NULL);
+
+	// tighten lower bound
+	int c = IndexValue_Compare(other->min, other->min_len, r->min, r->min_len);
+	if(c > 0 || (c == 0 && !other->include_min)) {
+		rm_free(r->min);
+		_SetBound(&r->min, &r->min_len, other->min, other->min_len);
+		r->include_min = other->include_min;
+	}
+
+	// tighten upper bound
+	c = IndexValue_Compare(other->max, other->max_len, r->max, r->max_len);
+	if(c < 0 || (c == 0 && !other->include_max)) {
+		rm_free(r->max);
+		_SetBound(&r->max, &r->max_len, other->max, other->max_len);
+		r->include_max = other->include_max;
+	}
+
+	// validate range
+	c = IndexValue_Compare(r->min, r->min_len, r->max, r->max_len);
+	return c < 0 || (c == 0 && r->include_min && r->include_max);
+}
+
+int IndexRange_CompareMin
+(
+	const IndexRange *a,
+	const IndexRange *b
+) {
+	ASSERT(a != NULL);
+	ASSERT(b != NULL);
+
+	int c = IndexValue_Compare(a->min, a->min_len, b->min, b->min_len);
+	if(c != 0) return c;
+
+	// inclusive bound comes first
+	return (int)b->include_min - (int)a->include_min;
+}
+
+bool IndexRange_Merge
+(
+	IndexRange *r,
+	const IndexRange *other
+) {
+	ASSERT(r     != NULL);
+	ASSERT(other != NULL);
+	ASSERT(IndexRange_CompareMin(r, other) <= 0);
+
+	// ranges must overlap or touch
+	int c = IndexValue_Compare(other->min, other->min_len, r->max, r->max_len);
+	if(c > 0 || (c == 0 && !r->include_max && !other->include_min)) {
+		return false;
+	}
+
+	// extend upper bound
+	c = IndexValue_Compare(other->max, other->max_len, r->max, r->max_len);
+	if(c > 0) {
+		rm_free(r->max);
+		_SetBound(&r->max, &r->max_len, other->max, other->max_len);
+		r->include_max = other->include_max;
+	} else if(c == 0) {
+		r->include_max |= other->include_max;
+	}
+
+	return true;
+}
+
+void IndexRange_Clone
+(
+	const IndexRange *r,
+	IndexRange *clone
+) {
+	ASSERT(r     != NULL);
+	ASSERT(clone != NULL);
+
+	_SetBound(&clone->min, &clone->min_len, r->min, r->min_len);
+	_SetBound(&clone->max, &clone->max_len, r->max, r->max_len);
+	clone->include_min = r->include_min;
+	clone->include_max = r->include_max;
+}
+
+void IndexRange_Free
+(
+	IndexRange *r
+) {
+	ASSERT(r != NULL);
+
+	rm_free(r->min);
+	rm_free(r->max);
+	r->min = NULL;
+	r->max = NULL;
+}
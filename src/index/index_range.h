@@ -0,0 +1,181 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "../value.h"
+#include "../ast/ast_shared.h"
+
+#include <stddef.h>
+#include <stdbool.h>
+
+// exact-match indexes keep values in an order preserving binary encoding
+// a value is encoded as a single tag byte followed by the value's payload
+// the tag groups values of comparable types into buckets
+// such that comparing two encoded values with memcmp agrees with the
+// Cypher ordering of values within the same bucket
+//
+// encoded values are prefix free, no encoded value is a prefix of another
+
+#define INDEX_VALUE_BOOL    0x01  // 1 byte, false < true
+#define INDEX_VALUE_NUMERIC 0x02  // 8 bytes, integers and floats as doubles
+#define INDEX_VALUE_STRING  0x03  // null terminated string
+#define INDEX_VALUE_POINT   0x04  // 16 bytes, latitude followed by longitude
+#define INDEX_VALUE_OTHER   0x05  // no payload, none comparable values
+
+// integers and floats are indexed as doubles
+// numbers of greater magnitude might not be represented exactly
+#define INDEX_EXACT_NUMERIC_MAX 9007199254740992.0  // 2^53
+
+// indexes keep each value's encoding alongside the value itself
+// allowing values to be read back from the index, see IndexValue_Decode
+// a stored value is the value's encoding followed by an optional suffix
+// numbers are suffixed by their type and their 8 bytes representation
+// as their encoding doesn't tell integers from floats
+// nor represents large integers exactly
+
+#define INDEX_VALUE_NUMERIC_SUFFIX_LEN 9
+
+// a range of encoded values
+typedef struct {
+	unsigned char *min;  // lower bound
+	unsigned char *max;  // upper bound
+	size_t min_len;      // lower bound length
+	size_t max_len;      // upper bound length
+	bool include_min;    // lower bound is inclusive
+	bool include_max;    // upper bound is inclusive
+} IndexRange;
+
+// returns the length of 'v' encoded
+size_t IndexValue_Len
+(
+	SIValue v  // value to encode
+);
+
+// encodes 'v' into 'buf', returns number of bytes written
+// 'buf' must hold at least IndexValue_Len(v) bytes
+size_t IndexValue_Encode
+(
+	SIValue v,          // value to encode
+	unsigned char *buf  // [output] encoded value
+);
+
+// returns the length of 'v' stored
+size_t IndexValue_StoredLen
+(
+	SIValue v  // value to store
+);
+
+// stores 'v' into 'buf', returns number of bytes written
+// 'buf' must hold at least IndexValue_StoredLen(v) bytes
+size_t IndexValue_Store
+(
+	SIValue v,          // value to store
+	unsigned char *buf  // [output] stored value
+);
+
+// returns the length of the encoding within a stored value
+size_t IndexValue_EncodedLen
+(
+	const unsigned char *stored,  // stored value
+	size_t len                    // length of stored value
+);
+
+// decodes a stored value
+// strings are returned as constant values pointing into 'stored'
+// returns false if the value can't be recovered from its encoding
+bool IndexValue_Decode
+(
+	const unsigned char *stored,  // stored value
+	size_t len,                   // length of stored value
+	SIValue *v                    // [output] decoded value
+);
+
+// compares two encoded values
+int IndexValue_Compare
+(
+	const unsigned char *a,  // encoded value
+	size_t a_len,            // length of a
+	const unsigned char *b,  // encoded value
+	size_t b_len             // length of b
+);
+
+// sets 'r' to the range of values 'x' satisfying: x op v
+// returns true if the range holds exactly the values satisfying the
+// predicate, false if it is a superset of these values, in which case
+// the predicate must be re-evaluated against each value in the range
+bool IndexRange_FromPredicate
+(
+	IndexRange *r,    // [output] range
+	AST_Operator op,  // one of: <, <=, =, >, >=
+	SIValue v         // value compared against
+);
+
+// sets 'r' to the range of points with latitude in [lat_min, lat_max]
+void IndexRange_Latitude
+(
+	IndexRange *r,   // [output] range
+	double lat_min,  // minimum latitude
+	double lat_max   // maximum latitude
+);
+
+// returns true if encoded value is within range
+bool IndexRange_Contains
+(
+	const IndexRange *r,     // range
+	const unsigned char *v,  // encoded value
+	size_t len               // length of v
+);
+
+// returns true if the range holds a single value
+bool IndexRange_IsExact
+(
+	const IndexRange *r  // range
+);
+
+// returns the tag of the bucket holding all values within range
+// 0 if the range spans multiple buckets
+unsigned char IndexRange_Bucket
+(
+	const IndexRange *r  // range
+);
+
+// tightens 'r' to the intersection of 'r' and 'other'
+// returns false if the intersection is empty
+bool IndexRange_Intersect
+(
+	IndexRange *r,            // range to tighten
+	const IndexRange *other  // range to intersect with
+);
+
+// compares ranges by their lower bounds
+int IndexRange_CompareMin
+(
+	const IndexRange *a,
+	const IndexRange *b
+);
+
+// extends 'r' to cover 'other' if the two ranges overlap or are adjacent
+// returns false if the ranges are disjoint, in which case 'r' is unchanged
+// 'r' lower bound must not be greater than 'other' lower bound
+bool IndexRange_Merge
+(
+	IndexRange *r,            // range to extend
+	const IndexRange *other  // range to merge
+);
+
+// deep clones range
+void IndexRange_Clone
+(
+	const IndexRange *r,  // range to clone
+	IndexRange *clone     // [output] clone
+);
+
+// free range bounds
+void IndexRange_Free
+(
+	IndexRange *r  // range to free
+);
@@ -0,0 +1,760 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "ordered_index.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// values keys shorter than this are composed on the stack
+#define VALUES_KEY_STACK_LEN 256
+
+struct _OrderedIndex {
+	rax *values;           // (field, encoded value, entity key) -> NULL
+	rax *entries;          // entity key -> entity entry
+	uint16_t field_count;  // number of indexed fields
+	size_t key_len;        // entity key length
+	size_t stored_memory;  // bytes held only to decode stored values
+};
+
+// entity entry layout:
+// field_count * uint32_t stored value length, 0 for a missing field
+// followed by the concatenated stored values, see IndexValue_Store
+
+// returns stored value of field within entry, NULL if field is missing
+static const unsigned char *_Entry_GetStored
+(
+	const OrderedIndex oi,
+	const unsigned char *entry,
+	uint16_t field,
+	size_t *len
+) {
+	const uint32_t      *lens = (const uint32_t *)entry;
+	const unsigned char *v    = entry + sizeof(uint32_t) * oi->field_count;
+
+	for(uint16_t i = 0; i < field; i++) v += lens[i];
+
+	*len = lens[field];
+	return (*len == 0) ? NULL : v;
+}
+
+// returns encoded value of field within entry, NULL if field is missing
+static const unsigned char *_Entry_GetValue
+(
+	const OrderedIndex oi,
+	const unsigned char *entry,
+	uint16_t field,
+	size_t *len
+) {
+	const unsigned char *v = _Entry_GetStored(oi, entry, field, len);
+	if(v != NULL) *len = IndexValue_EncodedLen(v, *len);
+
+	return v;
+}
+
+// returns number of entry bytes held only to decode its values
+// i.e. the native representation suffixed to numeric values
+static size_t _Entry_StoredMemory
+(
+	uint16_t n,
+	const unsigned char *entry
+) {
+	if(entry == NULL) return 0;
+
+	size_t               memory = 0;
+	const uint32_t      *lens   = (const uint32_t *)entry;
+	const unsigned char *v      = entry + sizeof(uint32_t) * n;
+
+	for(uint16_t i = 0; i < n; i++) {
+		if(lens[i] == 0) continue;
+		if(v[0] == INDEX_VALUE_NUMERIC) memory += INDEX_VALUE_NUMERIC_SUFFIX_LEN;
+		v += lens[i];
+	}
+
+	return memory;
+}
+
+// encodes values into a new entry, NULL if all values are missing
+static unsigned char *_Entry_New
+(
+	uint16_t n,
+	const SIValue **values
+) {
+	size_t   header = sizeof(uint32_t) * n;
+	size_t   total  = 0;
+	uint32_t lens[n];
+
+	for(uint16_t i = 0; i < n; i++) {
+		lens[i] = (values[i] == NULL) ? 0 : IndexValue_StoredLen(*values[i]);
+		total += lens[i];
+	}
+
+	if(total == 0) return NULL;
+
+	unsigned char *entry = rm_malloc(header + total);
+	memcpy(entry, lens, header);
+
+	unsigned char *v = entry + header;
+	for(uint16_t i = 0; i < n; i++) {
+		if(values[i] != NULL) v += IndexValue_Store(*values[i], v);
+	}
+
+	return entry;
+}
+
+// composes a values key: field, encoded value, entity key
+// 'buf' is used if large enough, otherwise the key is heap allocated
+static unsigned char *_ValuesKey
+(
+	const OrderedIndex oi,
+	unsigned char *buf,
+	uint16_t field,
+	const unsigned char *v,
+	size_t len,
+	const void *key,
+	size_t *key_len
+) {
+	size_t n = 2 + len + oi->key_len;
+	unsigned char *k = (n <= VALUES_KEY_STACK_LEN) ? buf : rm_malloc(n);
+
+	// big-endian field position, keeps fields ordered
+	k[0] = field >> 8;
+	k[1] = field & 0xFF;
+	memcpy(k + 2, v, len);
+	memcpy(k + 2 + len, key, oi->key_len);
+
+	*key_len = n;
+	return k;
+}
+
+static void _AddValue
+(
+	OrderedIndex oi,
+	uint16_t field,
+	const unsigned char *v,
+	size_t len,
+	const void *key
+) {
+	size_t        n;
+	unsigned char buf[VALUES_KEY_STACK_LEN];
+	unsigned char *k = _ValuesKey(oi, buf, field, v, len, key, &n);
+
+	raxInsert(oi->values, k, n, NULL, NULL);
+
+	if(k != buf) rm_free(k);
+}
+
+static void _RemoveValue
+(
+	OrderedIndex oi,
+	uint16_t field,
+	const unsigned char *v,
+	size_t len,
+	const void *key
+) {
+	size_t        n;
+	unsigned char buf[VALUES_KEY_STACK_LEN];
+	unsigned char *k = _ValuesKey(oi, buf, field, v, len, key, &n);
+
+	int res = raxRemove(oi->values, k, n, NULL);
+	ASSERT(res == 1);
+	UNUSED(res);
+
+	if(k != buf) rm_free(k);
+}
+
+OrderedIndex OrderedIndex_New
+(
+	uint16_t field_count,
+	size_t key_len
+) {
+	ASSERT(field_count > 0);
+	ASSERT(key_len     > 0);
+
+	OrderedIndex oi = rm_malloc(sizeof(_OrderedIndex));
+
+	oi->values      = raxNew();
+	oi->entries     = raxNew();
+	oi->key_len       = key_len;
+	oi->field_count   = field_count;
+	oi->stored_memory = 0;
+
+	return oi;
+}
+
+void OrderedIndex_Set
+(
+	OrderedIndex oi,
+	const void *key,
+	const SIValue **values
+) {
+	ASSERT(oi     != NULL);
+	ASSERT(key    != NULL);
+	ASSERT(values != NULL);
+
+	uint16_t      n      = oi->field_count;
+	unsigned char *entry = _Entry_New(n, values);
+
+	//--------------------------------------------------------------------------
+	// update modified values
+	//--------------------------------------------------------------------------
+
+	unsigned char *prev = raxFind(oi->entries, (unsigned char *)key,
+			oi->key_len);
+	if(prev == raxNotFound) prev = NULL;
+
+	for(uint16_t i = 0; i < n; i++) {
+		size_t old_len = 0;
+		size_t new_len = 0;
+		const unsigned char *old_v = NULL;
+		const unsigned char *new_v = NULL;
+
+		if(prev  != NULL) old_v = _Entry_GetValue(oi, prev, i, &old_len);
+		if(entry != NULL) new_v = _Entry_GetValue(oi, entry, i, &new_len);
+
+		// value unchanged
+		if(old_v != NULL && new_v != NULL && old_len == new_len &&
+		   memcmp(old_v, new_v, old_len) == 0) {
+			continue;
+		}
+
+		if(old_v != NULL) _RemoveValue(oi, i, old_v, old_len, key);
+		if(new_v != NULL) _AddValue(oi, i, new_v, new_len, key);
+	}
+
+	//--------------------------------------------------------------------------
+	// replace entry
+	//--------------------------------------------------------------------------
+
+	if(entry != NULL) {
+		raxInsert(oi->entries, (unsigned char *)key, oi->key_len, entry, NULL);
+	} else if(prev != NULL) {
+		raxRemove(oi->entries, (unsigned char *)key, oi->key_len, NULL);
+	}
+
+	// stored memory is read concurrently by GRAPH.INFO
+	__atomic_add_fetch(&oi->stored_memory, _Entry_StoredMemory(n, entry),
+			__ATOMIC_RELAXED);
+	__atomic_sub_fetch(&oi->stored_memory, _Entry_StoredMemory(n, prev),
+			__ATOMIC_RELAXED);
+
+	if(prev != NULL) rm_free(prev);
+}
+
+void OrderedIndex_Remove
+(
+	OrderedIndex oi,
+	const void *key
+) {
+	ASSERT(oi  != NULL);
+	ASSERT(key != NULL);
+
+	unsigned char *entry = raxFind(oi->entries, (unsigned char *)key,
+			oi->key_len);
+	if(entry == raxNotFound) return;
+
+	for(uint16_t i = 0; i < oi->field_count; i++) {
+		size_t len;
+		const unsigned char *v = _Entry_GetValue(oi, entry, i, &len);
+		if(v != NULL) _RemoveValue(oi, i, v, len, key);
+	}
+
+	raxRemove(oi->entries, (unsigned char *)key, oi->key_len, NULL);
+	__atomic_sub_fetch(&oi->stored_memory,
+			_Entry_StoredMemory(oi->field_count, entry), __ATOMIC_RELAXED);
+	rm_free(entry);
+}
+
+const unsigned char *OrderedIndex_GetValue
+(
+	const OrderedIndex oi,
+	const void *key,
+	uint16_t field,
+	size_t *len
+) {
+	ASSERT(oi    != NULL);
+	ASSERT(key   != NULL);
+	ASSERT(len   != NULL);
+	ASSERT(field <  oi->field_count);
+
+	unsigned char *entry = raxFind(oi->entries, (unsigned char *)key,
+			oi->key_len);
+	if(entry == raxNotFound) return NULL;
+
+	return _Entry_GetValue(oi, entry, field, len);
+}
+
+bool OrderedIndex_GetStoredValue
+(
+	const OrderedIndex oi,
+	const void *key,
+	uint16_t field,
+	SIValue *v
+) {
+	ASSERT(v     != NULL);
+	ASSERT(oi    != NULL);
+	ASSERT(key   != NULL);
+	ASSERT(field <  oi->field_count);
+
+	unsigned char *entry = raxFind(oi->entries, (unsigned char *)key,
+			oi->key_len);
+	if(entry == raxNotFound) return false;
+
+	size_t len;
+	const unsigned char *stored = _Entry_GetStored(oi, entry, field, &len);
+
+	// indexed entity is missing the field
+	if(stored == NULL) {
+		*v = SI_NullVal();
+		return true;
+	}
+
+	return IndexValue_Decode(stored, len, v);
+}
+
+size_t OrderedIndex_StoredMemory
+(
+	const OrderedIndex oi
+) {
+	ASSERT(oi != NULL);
+
+	return __atomic_load_n(&oi->stored_memory, __ATOMIC_RELAXED);
+}
+
+size_t OrderedIndex_KeyLen
+(
+	const OrderedIndex oi
+) {
+	ASSERT(oi != NULL);
+
+	return oi->key_len;
+}
+
+uint64_t OrderedIndex_EntityCount
+(
+	const OrderedIndex oi
+) {
+	ASSERT(oi != NULL);
+
+	return raxSize(oi->entries);
+}
+
+uint64_t OrderedIndex_ValueCount
+(
+	const OrderedIndex oi
+) {
+	ASSERT(oi != NULL);
+
+	return raxSize(oi->values);
+}
+
+static void _FreeEntry
+(
+	void *entry
+) {
+	rm_free(entry);
+}
+
+void OrderedIndex_Free
+(
+	OrderedIndex oi
+) {
+	ASSERT(oi != NULL);
+
+	raxFree(oi->values);
+	raxFreeWithCallback(oi->entries, _FreeEntry);
+	rm_free(oi);
+}
+
+//------------------------------------------------------------------------------
+// iterator
+//------------------------------------------------------------------------------
+
+void OrderedIndexIterator_Init
+(
+	OrderedIndexIterator *it,
+	OrderedIndex oi,
+	uint16_t field,
+	const IndexRange *range,
+	bool reverse
+) {
+	ASSERT(it    != NULL);
+	ASSERT(oi    != NULL);
+	ASSERT(field <  oi->field_count);
+	ASSERT(range != NULL || !reverse);
+
+	it->oi       = oi;
+	it->range    = range;
+	it->field    = field;
+	it->reverse  = reverse;
+	it->started  = false;
+	it->depleted = false;
+
+	raxStart(&it->it, (range == NULL) ? oi->entries : oi->values);
+}
+
+// positions iterator at the first key within range
+static void _OrderedIndexIterator_Seek
+(
+	OrderedIndexIterator *it
+) {
+	const IndexRange *r = it->range;
+
+	if(r == NULL) {
+		raxSeek(&it->it, "^", NULL, 0);
+		return;
+	}
+
+	// keys of values equal to an excluded lower bound are all smaller than
+	// the lower bound followed by the greatest possible entity key
+	size_t        n;
+	size_t        pad = r->include_min ? 0 : it->oi->key_len;
+	unsigned char buf[VALUES_KEY_STACK_LEN];
+	unsigned char *k = (2 + r->min_len + pad <= VALUES_KEY_STACK_LEN) ?
+		buf : rm_malloc(2 + r->min_len + pad);
+
+	k[0] = it->field >> 8;
+	k[1] = it->field & 0xFF;
+	memcpy(k + 2, r->min, r->min_len);
+	memset(k + 2 + r->min_len, 0xFF, pad);
+	n = 2 + r->min_len + pad;
+
+	raxSeek(&it->it, r->include_min ? ">=" : ">", k, n);
+
+	if(k != buf) rm_free(k);
+}
+
+// positions iterator at the last key within range
+static void _OrderedIndexIterator_SeekLast
+(
+	OrderedIndexIterator *it
+) {
+	const IndexRange *r = it->range;
+
+	// keys of values equal to an included upper bound are all smaller than
+	// the upper bound followed by the greatest possible entity key
+	size_t        n;
+	size_t        pad = r->include_max ? it->oi->key_len : 0;
+	unsigned char buf[VALUES_KEY_STACK_LEN];
+	unsigned char *k = (2 + r->max_len + pad <= VALUES_KEY_STACK_LEN) ?
+		buf : rm_malloc(2 + r->max_len + pad);
+
+	k[0] = it->field >> 8;
+	k[1] = it->field & 0xFF;
+	memcpy(k + 2, r->max, r->max_len);
+	memset(k + 2 + r->max_len, 0xFF, pad);
+	n = 2 + r->max_len + pad;
+
+	raxSeek(&it->it, r->include_max ? "<=" : "<", k, n);
+
+	if(k != buf) rm_free(k);
+}
+
+const unsigned char *OrderedIndexIterator_Next
+(
+	OrderedIndexIterator *it
+) {
+	ASSERT(it != NULL);
+
+	if(it->depleted) return NULL;
+
+	if(!it->started) {
+		if(it->reverse) _OrderedIndexIterator_SeekLast(it);
+		else _OrderedIndexIterator_Seek(it);
+		it->started = true;
+	}
+
+	if(!(it->reverse ? raxPrev(&it->it) : raxNext(&it->it))) {
+		it->depleted = true;
+		return NULL;
+	}
+
+	const unsigned char *k       = it->it.key;
+	size_t               k_len   = it->it.key_len;
+	size_t               key_len = it->oi->key_len;
+
+	// iterating over all entities
+	if(it->range == NULL) return k;
+
+	// make sure key belongs to iterated field
+	ASSERT(k_len > 2 + key_len);
+	if(((uint16_t)k[0] << 8 | k[1]) != it->field) {
+		it->depleted = true;
+		return NULL;
+	}
+
+	// make sure value is within the bound the iterator advances towards
+	const IndexRange    *r     = it->range;
+	const unsigned char *v     = k + 2;
+	size_t               v_len = k_len - 2 - key_len;
+
+	if(it->reverse) {
+		int c = IndexValue_Compare(v, v_len, r->min, r->min_len);
+		if(c < 0 || (c == 0 && !r->include_min)) {
+			it->depleted = true;
+			return NULL;
+		}
+	} else {
+		int c = IndexValue_Compare(v, v_len, r->max, r->max_len);
+		if(c > 0 || (c == 0 && !r->include_max)) {
+			it->depleted = true;
+			return NULL;
+		}
+	}
+
+	return v + v_len;
+}
+
+void OrderedIndexIterator_Free
+(
+	OrderedIndexIterator *it
+) {
+	ASSERT(it != NULL);
+
+	raxStop(&it->it);
+}
+
+//------------------------------------------------------------------------------
+// runs
+//------------------------------------------------------------------------------
+
+// a values key within a run
+typedef struct {
+	const unsigned char *k;  // key
+	size_t len;              // key length
+} RunKey;
+
+struct _OrderedIndexRun {
+	uint16_t field_count;     // number of indexed fields
+	size_t key_len;           // entity key length
+	unsigned char *values;    // concatenated values keys
+	size_t values_len;        // values buffer length
+	size_t values_cap;        // values buffer capacity
+	size_t *offsets;          // values keys offsets within values buffer
+	RunKey *sorted;           // sorted values keys
+	unsigned char *keys;      // concatenated entity keys
+	size_t keys_len;          // keys buffer length
+	size_t keys_cap;          // keys buffer capacity
+	unsigned char **entries;  // entities entries, aligned with keys
+	uint64_t loaded_values;   // number of values keys loaded into an index
+	uint64_t loaded_entries;  // number of entries loaded into an index
+};
+
+// appends data to a growing buffer
+static void _Buffer_Append
+(
+	unsigned char **buf,
+	size_t *len,
+	size_t *cap,
+	const void *data,
+	size_t n
+) {
+	if(*len + n > *cap) {
+		*cap = (*cap * 2 > *len + n) ? *cap * 2 : *len + n;
+		*buf = rm_realloc(*buf, *cap);
+	}
+
+	memcpy(*buf + *len, data, n);
+	*len += n;
+}
+
+static int _RunKey_Compare
+(
+	const void *a,
+	const void *b
+) {
+	const RunKey *x = a;
+	const RunKey *y = b;
+
+	return IndexValue_Compare(x->k, x->len, y->k, y->len);
+}
+
+OrderedIndexRun OrderedIndexRun_New
+(
+	uint16_t field_count,
+	size_t key_len
+) {
+	ASSERT(field_count > 0);
+	ASSERT(key_len     > 0);
+
+	OrderedIndexRun run = rm_calloc(1, sizeof(_OrderedIndexRun));
+
+	run->key_len     = key_len;
+	run->offsets     = array_new(size_t, 0);
+	run->entries     = array_new(unsigned char *, 0);
+	run->field_count = field_count;
+
+	return run;
+}
+
+void OrderedIndexRun_Add
+(
+	OrderedIndexRun run,
+	const void *key,
+	const SIValue **values
+) {
+	ASSERT(run    != NULL);
+	ASSERT(key    != NULL);
+	ASSERT(values != NULL);
+	ASSERT(run->sorted == NULL);
+
+	unsigned char *entry = _Entry_New(run->field_count, values);
+
+	// entity doesn't hold any indexed value
+	if(entry == NULL) return;
+
+	_Buffer_Append(&run->keys, &run->keys_len, &run->keys_cap, key,
+			run->key_len);
+	array_append(run->entries, entry);
+
+	// append a values key for each value
+	const uint32_t      *lens = (const uint32_t *)entry;
+	const unsigned char *v    = entry + sizeof(uint32_t) * run->field_count;
+
+	for(uint16_t i = 0; i < run->field_count; i++) {
+		if(lens[i] == 0) continue;
+
+		unsigned char field[2] = {i >> 8, i & 0xFF};
+		array_append(run->offsets, run->values_len);
+
+		_Buffer_Append(&run->values, &run->values_len, &run->values_cap,
+				field, 2);
+		_Buffer_Append(&run->values, &run->values_len, &run->values_cap,
+				v, IndexValue_EncodedLen(v, lens[i]));
+		_Buffer_Append(&run->values, &run->values_len, &run->values_cap,
+				key, run->key_len);
+
+		v += lens[i];
+	}
+}
+
+void OrderedIndexRun_Sort
+(
+	OrderedIndexRun run
+) {
+	ASSERT(run != NULL);
+	ASSERT(run->sorted == NULL);
+
+	// values buffer is final, resolve keys
+	uint64_t n = array_len(run->offsets);
+	run->sorted = rm_malloc(sizeof(RunKey) * (n + 1));
+
+	for(uint64_t i = 0; i < n; i++) {
+		size_t end = (i + 1 < n) ? run->offsets[i + 1] : run->values_len;
+		run->sorted[i].k   = run->values + run->offsets[i];
+		run->sorted[i].len = end - run->offsets[i];
+	}
+
+	qsort(run->sorted, n, sizeof(RunKey), _RunKey_Compare);
+}
+
+uint64_t OrderedIndexRun_EntityCount
+(
+	const OrderedIndexRun run
+) {
+	ASSERT(run != NULL);
+
+	return array_len(run->entries);
+}
+
+void OrderedIndexRun_Free
+(
+	OrderedIndexRun run
+) {
+	ASSERT(run != NULL);
+
+	// free entries which weren't loaded into an index
+	uint64_t n = array_len(run->entries);
+	for(uint64_t i = run->loaded_entries; i < n; i++) {
+		rm_free(run->entries[i]);
+	}
+
+	if(run->keys   != NULL) rm_free(run->keys);
+	if(run->values != NULL) rm_free(run->values);
+	if(run->sorted != NULL) rm_free(run->sorted);
+
+	array_free(run->offsets);
+	array_free(run->entries);
+	rm_free(run);
+}
+
+bool OrderedIndex_Load
+(
+	OrderedIndex oi,
+	OrderedIndexRun *runs,
+	uint n,
+	uint64_t limit
+) {
+	ASSERT(oi   != NULL);
+	ASSERT(runs != NULL);
+
+	uint64_t loaded = 0;
+
+	//--------------------------------------------------------------------------
+	// load entries
+	//--------------------------------------------------------------------------
+
+	for(uint i = 0; i < n && loaded < limit; i++) {
+		OrderedIndexRun run = runs[i];
+		ASSERT(run->sorted      != NULL);
+		ASSERT(run->key_len     == oi->key_len);
+		ASSERT(run->field_count == oi->field_count);
+
+		uint64_t count = array_len(run->entries);
+		while(run->loaded_entries < count && loaded < limit) {
+			uint64_t      j     = run->loaded_entries++;
+			unsigned char *key  = run->keys + j * run->key_len;
+			void          *prev = NULL;
+
+			// runs are expected to hold each entity once
+			if(!raxInsert(oi->entries, key, oi->key_len, run->entries[j],
+						&prev)) {
+				ASSERT(false && "entity loaded twice");
+				__atomic_sub_fetch(&oi->stored_memory,
+						_Entry_StoredMemory(oi->field_count, prev),
+						__ATOMIC_RELAXED);
+				rm_free(prev);
+			}
+
+			__atomic_add_fetch(&oi->stored_memory,
+					_Entry_StoredMemory(oi->field_count, run->entries[j]),
+					__ATOMIC_RELAXED);
+
+			loaded++;
+		}
+	}
+
+	//--------------------------------------------------------------------------
+	// load values, merging runs in key order
+	//--------------------------------------------------------------------------
+
+	while(loaded < limit) {
+		OrderedIndexRun min = NULL;
+
+		for(uint i = 0; i < n; i++) {
+			OrderedIndexRun run = runs[i];
+			if(run->loaded_values == array_len(run->offsets)) continue;
+
+			if(min == NULL ||
+			   _RunKey_Compare(run->sorted + run->loaded_values,
+				   min->sorted + min->loaded_values) < 0) {
+				min = run;
+			}
+		}
+
+		// all runs loaded
+		if(min == NULL) return true;
+
+		RunKey *k = min->sorted + min->loaded_values++;
+		raxInsert(oi->values, (unsigned char *)k->k, k->len, NULL, NULL);
+		loaded++;
+	}
+
+	return false;
+}
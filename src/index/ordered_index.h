@@ -0,0 +1,196 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "rax.h"
+#include "index_range.h"
+#include "../value.h"
+
+#include <stdint.h>
+
+// ordered index
+//
+// native index backing exact-match indexes
+// maps each indexed field value to the entities holding it
+// entities are identified by a fixed length key e.g. a node ID
+//
+// the index is made of two radix trees:
+// values - ordered by (field, encoded value, entity key)
+//          range lookups seek to a range lower bound and scan forward
+// entries - maps an entity key to the entity's stored field values
+//           used to replace or remove an entity's values, to check
+//           additional field constraints and to read indexed values
+//           without accessing the graph
+//
+// the index isn't thread safe, writers are expected to hold the graph's
+// write lock, or to be the only ones accessing the index
+
+typedef struct _OrderedIndex _OrderedIndex;
+typedef _OrderedIndex *OrderedIndex;
+
+// run of entities built aside of an index, see OrderedIndex_Load
+typedef struct _OrderedIndexRun _OrderedIndexRun;
+typedef _OrderedIndexRun *OrderedIndexRun;
+
+// iterates over entities within a range of a field's values
+typedef struct {
+	raxIterator it;           // underlying rax iterator
+	OrderedIndex oi;          // iterated index
+	const IndexRange *range;  // iterated range, NULL iterates all entities
+	uint16_t field;           // iterated field
+	bool reverse;             // iterate from the range's upper bound down
+	bool started;             // iterator positioned
+	bool depleted;            // iterator depleted
+} OrderedIndexIterator;
+
+// create a new ordered index
+OrderedIndex OrderedIndex_New
+(
+	uint16_t field_count,  // number of indexed fields
+	size_t key_len         // length of entity key
+);
+
+// sets entity's indexed values, replacing previously indexed values
+// an entity without any indexed values is removed from the index
+void OrderedIndex_Set
+(
+	OrderedIndex oi,        // index to update
+	const void *key,        // entity key
+	const SIValue **values  // field values, NULL for a missing field
+);
+
+// removes entity from the index
+void OrderedIndex_Remove
+(
+	OrderedIndex oi,  // index to update
+	const void *key   // entity key
+);
+
+// returns entity's encoded field value
+// NULL if the entity isn't indexed or is missing the field
+const unsigned char *OrderedIndex_GetValue
+(
+	const OrderedIndex oi,  // index to query
+	const void *key,        // entity key
+	uint16_t field,         // field position
+	size_t *len             // [output] encoded value length
+);
+
+// reads entity's field value from the index
+// a field missing from an indexed entity is read as null
+// returns false if the entity isn't indexed or the value can't be
+// recovered from the index
+bool OrderedIndex_GetStoredValue
+(
+	const OrderedIndex oi,  // index to query
+	const void *key,        // entity key
+	uint16_t field,         // field position
+	SIValue *v              // [output] field value
+);
+
+// returns number of bytes held by the index only to read stored values back
+// e.g. the exact type and representation of numeric values
+size_t OrderedIndex_StoredMemory
+(
+	const OrderedIndex oi  // index to query
+);
+
+// returns entity key length
+size_t OrderedIndex_KeyLen
+(
+	const OrderedIndex oi  // index to query
+);
+
+// returns number of indexed entities
+uint64_t OrderedIndex_EntityCount
+(
+	const OrderedIndex oi  // index to query
+);
+
+// returns number of indexed values
+uint64_t OrderedIndex_ValueCount
+(
+	const OrderedIndex oi  // index to query
+);
+
+// free index
+void OrderedIndex_Free
+(
+	OrderedIndex oi  // index to free
+);
+
+// create a new run
+// runs collect entities without accessing an index
+// allowing an index to be built by multiple threads
+OrderedIndexRun OrderedIndexRun_New
+(
+	uint16_t field_count,  // number of indexed fields
+	size_t key_len         // length of entity key
+);
+
+// adds entity to run, each entity must be added at most once
+void OrderedIndexRun_Add
+(
+	OrderedIndexRun run,    // run to extend
+	const void *key,        // entity key
+	const SIValue **values  // field values, NULL for a missing field
+);
+
+// sorts run, no entities can be added to a sorted run
+void OrderedIndexRun_Sort
+(
+	OrderedIndexRun run  // run to sort
+);
+
+// returns number of entities in run
+uint64_t OrderedIndexRun_EntityCount
+(
+	const OrderedIndexRun run  // run to query
+);
+
+// free run
+void OrderedIndexRun_Free
+(
+	OrderedIndexRun run  // run to free
+);
+
+// loads sorted runs into index, inserting values in key order
+// loads at most 'limit' items, returns true once all runs were loaded
+// runs must not share entities with each other or with the index
+bool OrderedIndex_Load
+(
+	OrderedIndex oi,        // index to load into
+	OrderedIndexRun *runs,  // sorted runs
+	uint n,                 // number of runs
+	uint64_t limit          // max number of items to load
+);
+
+// initialize iterator over entities with field value within range
+// iterates over all indexed entities if range is NULL
+// entities are visited in field value order, descending if 'reverse' is set
+// entities sharing a value are visited in entity key order
+void OrderedIndexIterator_Init
+(
+	OrderedIndexIterator *it,  // iterator to initialize
+	OrderedIndex oi,           // index to iterate
+	uint16_t field,            // field position
+	const IndexRange *range,   // [optional] range of values
+	bool reverse               // visit values in descending order
+);
+
+// returns next entity key, NULL once iterator is depleted
+// returned key is valid until the next call
+const unsigned char *OrderedIndexIterator_Next
+(
+	OrderedIndexIterator *it  // iterator
+);
+
+// free iterator internals
+void OrderedIndexIterator_Free
+(
+	OrderedIndexIterator *it  // iterator
+);
@@ -16,6 +16,7 @@
 #include "query_ctx.h"
 #include "index/indexer.h"
 #include "redisearch_api.h"
+#include "graph/compactor.h"
 #include "arithmetic/funcs.h"
 #include "commands/commands.h"
 #include "util/thpool/pools.h"
@@ -135,6 +136,7 @@ int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
 	if(!ErrorCtx_Init())              return REDISMODULE_ERR;
 	if(!ThreadPools_Init())           return REDISMODULE_ERR;
 	if(!Indexer_Init())               return REDISMODULE_ERR;
+	if(!Compactor_Init())             return REDISMODULE_ERR;
 	if(!AST_ValidationsMappingInit()) return REDISMODULE_ERR;
 
 	RedisModule_Log(ctx, "notice", "Thread pool created, using %d threads.",
@@ -188,6 +190,11 @@ int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
 		return REDISMODULE_ERR;
 	}
 
+	if(RedisModule_CreateCommand(ctx, "graph.COMPACT", Graph_Compact, "write deny-oom", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
 	if(RedisModule_CreateCommand(ctx, "graph.SLOWLOG", Graph_Slowlog, "readonly", 1, 1,
 								 1) == REDISMODULE_ERR) {
 		return REDISMODULE_ERR;
@@ -26,6 +26,7 @@ typedef struct {
 	SIValue *yield_entity_type; // yield index entity type
 	SIValue *yield_status;      // yield index status
 	SIValue *yield_info;        // yield info
+	SIValue *yield_progress;    // yield index population progress
 } IndexesContext;
 
 static void _process_yield
@@ -35,6 +36,7 @@ static void _process_yield
 ) {
 	ctx->yield_type        = NULL;
 	ctx->yield_info        = NULL;
+	ctx->yield_progress    = NULL;
 	ctx->yield_label       = NULL;
 	ctx->yield_status      = NULL;
 	ctx->yield_language    = NULL;
@@ -91,6 +93,12 @@ static void _process_yield
 			idx++;
 			continue;
 		}
+
+		if(strcasecmp("progress", yield[i]) == 0) {
+			ctx->yield_progress = ctx->out + idx;
+			idx++;
+			continue;
+		}
 	}
 }
 
@@ -252,7 +260,16 @@ static bool _EmitIndex
 	// index info
 	//--------------------------------------------------------------------------
 
-	if(ctx->yield_info) {
+	if(ctx->yield_info && Index_Type(idx) == IDX_EXACT_MATCH) {
+		OrderedIndex oi = Index_OrderedIndex(idx);
+		SIValue map = SI_Map(3);
+
+		Map_Add(&map, SI_ConstStringVal("lang"),         SI_ConstStringVal((char *)Index_GetLanguage(idx)));
+		Map_Add(&map, SI_ConstStringVal("numDocuments"), SI_LongVal(OrderedIndex_EntityCount(oi)));
+		Map_Add(&map, SI_ConstStringVal("numRecords"),   SI_LongVal(OrderedIndex_ValueCount(oi)));
+
+		*ctx->yield_info = map;
+	} else if(ctx->yield_info) {
 		RSIdxInfo info = { .version = RS_INFO_CURRENT_VERSION };
 
 		RSIndex *rsIdx = Index_RSIndex(idx);
@@ -304,6 +321,14 @@ static bool _EmitIndex
 		*ctx->yield_info = map;
 	}
 
+	//--------------------------------------------------------------------------
+	// index population progress
+	//--------------------------------------------------------------------------
+
+	if(ctx->yield_progress != NULL) {
+		*ctx->yield_progress = SI_LongVal(Index_PopulationProgress(idx));
+	}
+
 	return true;
 }
 
@@ -346,7 +371,7 @@ ProcedureResult Proc_IndexesFree
 ProcedureCtx *Proc_IndexesCtx(void) {
 	void *privateData = NULL;
 	ProcedureOutput output;
-	ProcedureOutput *outputs = array_new(ProcedureOutput, 8);
+	ProcedureOutput *outputs = array_new(ProcedureOutput, 9);
 
 	// index type (exact-match / fulltext)
 	output = (ProcedureOutput) {
@@ -396,6 +421,12 @@ ProcedureCtx *Proc_IndexesCtx(void) {
 	};
 	array_append(outputs, output);
 
+	// index population progress in percentage
+	output = (ProcedureOutput) {
+		.name = "progress", .type = T_INT64
+	};
+	array_append(outputs, output);
+
 	ProcedureCtx *ctx = ProcCtxNew("db.indexes",
 								   0,
 								   outputs,
@@ -28,6 +28,7 @@ static inline QueryCtx *_QueryCtx_GetCreateCtx(void) {
 		// created lazily only when needed
 		ctx->undo_log       = NULL;
 		ctx->effects_buffer = NULL;
+		ctx->index_buffer   = NULL;
 		ctx->stage          = QueryStage_WAITING;  // initial query stage
 
 		pthread_setspecific(_tlsQueryCtxKey, ctx);
@@ -259,11 +260,29 @@ UndoLog QueryCtx_GetUndoLog(void) {
 	ASSERT(ctx != NULL);
 	
 	if(ctx->undo_log == NULL) {
+		// a query which can't fail once it has modified the graph requires
+		// no undo log, unless it had already failed or is subject to
+		// constraints, which are enforced as the graph is modified
+		if((ctx->flags & QueryExecutionTypeFlag_NO_UNDO_LOG) &&
+		   !ErrorCtx_EncounteredError() &&
+		   !GraphContext_HasConstraints(ctx->gc)) {
+			return NULL;
+		}
+
 		ctx->undo_log = UndoLog_New();
 	}
 	return ctx->undo_log;
 }
 
+// returns number of bytes consumed by the undo-log
+size_t QueryCtx_UndoLogMemoryUsage(void) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	ASSERT(ctx != NULL);
+
+	if(ctx->undo_log == NULL) return 0;
+	return UndoLog_MemoryUsage(ctx->undo_log);
+}
+
 // rollback the current command
 void QueryCtx_Rollback(void) {
 	QueryCtx *ctx = _QueryCtx_GetCtx();
@@ -271,6 +290,9 @@ void QueryCtx_Rollback(void) {
 
 	Graph_ResetReservedNode(ctx->gc->g);
 
+	// bring indices up to date with the graph before reverting it
+	QueryCtx_FlushIndexBuffer();
+
 	if(ctx->undo_log == NULL) return;
 	
 	UndoLog_Rollback(&ctx->undo_log);
@@ -288,6 +310,26 @@ EffectsBuffer *QueryCtx_GetEffectsBuffer(void) {
 	return ctx->effects_buffer;
 }
 
+// retrieve index-buffer
+IndexBuffer *QueryCtx_GetIndexBuffer(void) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	ASSERT(ctx != NULL);
+
+	if(ctx->index_buffer == NULL) {
+		ctx->index_buffer = IndexBuffer_New();
+	}
+
+	return ctx->index_buffer;
+}
+
+// apply index changes accumulated by the query
+void QueryCtx_FlushIndexBuffer(void) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	if(ctx == NULL || ctx->index_buffer == NULL) return;
+
+	IndexBuffer_Flush(ctx->index_buffer, ctx->gc);
+}
+
 // retrieve the Redis module context
 RedisModuleCtx *QueryCtx_GetRedisModuleCtx(void) {
 	QueryCtx *ctx = _QueryCtx_GetCtx();
@@ -373,6 +415,7 @@ bool QueryCtx_LockForCommit(void) {
 
 	// acquire graph write lock
 	Graph_AcquireWriteLock(gc->g);
+	ctx->internal_exec_ctx.graph_locked      = true;
 	ctx->internal_exec_ctx.locked_for_commit = true;
 
 	return true;
@@ -396,8 +439,14 @@ static void _QueryCtx_UnlockCommit
 	GraphContext *gc = ctx->gc;
 
 	ctx->internal_exec_ctx.locked_for_commit = false;
-	// release graph R/W lock
-	Graph_ReleaseLock(gc->g);
+
+	// release graph R/W lock, unless it was already released
+	if(ctx->internal_exec_ctx.graph_locked) {
+		// apply pending index changes before letting readers in
+		QueryCtx_FlushIndexBuffer();
+		ctx->internal_exec_ctx.graph_locked = false;
+		Graph_ReleaseLock(gc->g);
+	}
 
 	// close Key
 	RedisModule_CloseKey(ctx->internal_exec_ctx.key);
@@ -425,6 +474,24 @@ void QueryCtx_UnlockCommit() {
 	_QueryCtx_UnlockCommit(ctx);
 }
 
+// releases the graph write lock acquired by QueryCtx_LockForCommit
+// while keeping both the GIL and the graph key open
+void QueryCtx_ReleaseGraphLock(void) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	if(!ctx) return;
+
+	// graph isn't locked
+	if(!ctx->internal_exec_ctx.graph_locked) return;
+
+	// apply pending index changes before letting readers in
+	QueryCtx_FlushIndexBuffer();
+
+	// release graph R/W lock, publishing a new graph version
+	// the GIL and graph key are released by QueryCtx_UnlockCommit
+	ctx->internal_exec_ctx.graph_locked = false;
+	Graph_ReleaseLock(ctx->gc->g);
+}
+
 // replicate command to AOF/Replicas
 void QueryCtx_Replicate
 (
@@ -456,12 +523,16 @@ void QueryCtx_Free(void) {
 
 	UndoLog_Free(&ctx->undo_log);
 	EffectsBuffer_Free(ctx->effects_buffer);
+	IndexBuffer_Free(ctx->index_buffer);
 
 	if(ctx->query_data.params != NULL) {
 		raxFreeWithCallback(ctx->query_data.params, _ParameterFreeCallback);
 		ctx->query_data.params = NULL;
 	}
 
+	// stop charging allocations to the query's shared memory counter
+	rm_detach_n_alloced();
+
 	rm_free(ctx);
 
 	// NULL-set the context for reuse the next time this thread receives a query
@@ -17,6 +17,7 @@
 #include "execution_plan/ops/op.h"
 #include "undo_log/undo_log.h"
 #include "effects/effects.h"
+#include "index/index_buffer.h"
 #include <pthread.h>
 
 extern pthread_key_t _tlsQueryCtxKey;  // Thread local storage query context key.
@@ -30,6 +31,8 @@ typedef enum QueryExecutionTypeFlag {
 	QueryExecutionTypeFlag_WRITE = 1 << 0,
 	// whether or not we want to profile the query
 	QueryExecutionTypeFlag_PROFILE = 1 << 1,
+	// query can't fail once it has modified the graph, no undo-log is kept
+	QueryExecutionTypeFlag_NO_UNDO_LOG = 1 << 2,
 } QueryExecutionTypeFlag;
 
 // holds the query execution status
@@ -58,6 +61,7 @@ typedef struct {
 	RedisModuleKey *key;     // graph open key, for later extraction and closing
 	ResultSet *result_set;   // execution result set
 	bool locked_for_commit;  // indicates if QueryCtx_LockForCommit been called
+	bool graph_locked;       // indicates if the graph write lock is held
 } QueryCtx_InternalExecCtx;
 
 typedef struct {
@@ -83,6 +87,8 @@ typedef struct QueryCtx {
 	QueryExecutionStatus status;                 // query execution status
 	QueryExecutionTypeFlag flags;                // execution flags
 	EffectsBuffer *effects_buffer;               // effects-buffer for replication, used when write query succeed and replication is needed
+	IndexBuffer *index_buffer;                   // index changes deferred until commit
+	int64_t n_alloced;                           // memory consumed by threads sharing the query's capacity
 	QueryCtx_QueryData query_data;               // data related to the query syntax
 	QueryCtx_GlobalExecCtx global_exec_ctx;      // data related to global redis execution
 	QueryCtx_InternalExecCtx internal_exec_ctx;  // data related to internal query execution
@@ -181,14 +187,25 @@ GraphContext *QueryCtx_GetGraphCtx(void);
 Graph *QueryCtx_GetGraph(void);
 
 // retrieve undo log
+// returns NULL if the query doesn't require an undo log
 UndoLog QueryCtx_GetUndoLog(void);
 
+// returns number of bytes consumed by the undo-log
+size_t QueryCtx_UndoLogMemoryUsage(void);
+
 // rollback the current command
 void QueryCtx_Rollback(void);
 
 // retrieve effects-buffer
 EffectsBuffer *QueryCtx_GetEffectsBuffer(void);
 
+// retrieve index-buffer
+IndexBuffer *QueryCtx_GetIndexBuffer(void);
+
+// apply index changes accumulated by the query
+// must be called before the query reads an index it might have modified
+void QueryCtx_FlushIndexBuffer(void);
+
 // retrieve the Redis module context
 RedisModuleCtx *QueryCtx_GetRedisModuleCtx(void);
 
@@ -219,11 +236,17 @@ bool QueryCtx_LockForCommit(void);
 // the last writer, if they are equal then the commit and unlock flow will start
 // Unlocking flow:
 // 1. replicate
-// 2. unlock graph R/W lock
+// 2. unlock graph R/W lock, unless released by QueryCtx_ReleaseGraphLock
 // 3. close key
 // 4. unlock GIL
 void QueryCtx_UnlockCommit(void);
 
+// releases the graph write lock acquired by QueryCtx_LockForCommit
+// while keeping both the GIL and the graph key open
+// called once all modifications were applied, letting readers access the
+// newly committed graph version while the query is being replicated
+void QueryCtx_ReleaseGraphLock(void);
+
 // replicate command to AOF/Replicas
 void QueryCtx_Replicate
 (
@@ -286,7 +286,7 @@ void ResultSet_Free
 	// calling SIValue_Free is required
 	if(set->cells) {
 		// free individual cells if resultset encountered a heap allocated value
-		if(set->cells_allocation & M_SELF) {
+		if(set->cells_allocation & (M_SELF | M_INTERN)) {
 			uint64_t n = DataBlock_ItemCount(set->cells);
 			for(uint64_t i = 0; i < n; i++) {
 				SIValue *v = DataBlock_GetItem(set->cells, i);
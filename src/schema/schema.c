@@ -572,6 +572,50 @@ void Schema_AddEdgeToIndices
 	if(idx != NULL) Index_IndexEdge(idx, e);
 }
 
+// index nodes which aren't indexed yet under all schema indices
+void Schema_AddNewNodesToIndices
+(
+	const Schema *s,
+	const Node *nodes,
+	uint64_t n
+) {
+	ASSERT(s     != NULL);
+	ASSERT(nodes != NULL);
+
+	Index idx = NULL;
+
+	idx = ACTIVE_EXACTMATCH_IDX(s);
+	if(idx != NULL) Index_IndexNewNodes(idx, nodes, n);
+
+	idx = PENDING_EXACTMATCH_IDX(s);
+	if(idx != NULL) Index_IndexNewNodes(idx, nodes, n);
+
+	idx = ACTIVE_FULLTEXT_IDX(s);
+	if(idx != NULL) Index_IndexNewNodes(idx, nodes, n);
+
+	idx = PENDING_FULLTEXT_IDX(s);
+	if(idx != NULL) Index_IndexNewNodes(idx, nodes, n);
+}
+
+// index edges which aren't indexed yet under all schema indices
+void Schema_AddNewEdgesToIndices
+(
+	const Schema *s,
+	const Edge *edges,
+	uint64_t n
+) {
+	ASSERT(s     != NULL);
+	ASSERT(edges != NULL);
+
+	Index idx = NULL;
+
+	idx = ACTIVE_EXACTMATCH_IDX(s);
+	if(idx != NULL) Index_IndexNewEdges(idx, edges, n);
+
+	idx = PENDING_EXACTMATCH_IDX(s);
+	if(idx != NULL) Index_IndexNewEdges(idx, edges, n);
+}
+
 // remove node from schema indicies
 void Schema_RemoveNodeFromIndices
 (
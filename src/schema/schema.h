@@ -141,6 +141,22 @@ void Schema_AddEdgeToIndices
 	const Edge *e
 );
 
+// introduce nodes which aren't indexed yet to schema indicies
+void Schema_AddNewNodesToIndices
+(
+	const Schema *s,
+	const Node *nodes,
+	uint64_t n
+);
+
+// introduce edges which aren't indexed yet to schema indicies
+void Schema_AddNewEdgesToIndices
+(
+	const Schema *s,
+	const Edge *edges,
+	uint64_t n
+);
+
 // remove node from schema indicies
 void Schema_RemoveNodeFromIndices
 (
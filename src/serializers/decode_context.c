@@ -8,6 +8,7 @@
 #include "../RG.h"
 #include "../util/arr.h"
 #include "../util/rmalloc.h"
+#include "../util/thpool/pools.h"
 #include "../util/rax_extensions.h"
 
 GraphDecodeContext *GraphDecodeContext_New() {
@@ -16,12 +17,36 @@ GraphDecodeContext *GraphDecodeContext_New() {
 	ctx->graph_keys_count = 1;
 	ctx->meta_keys = raxNew();
 	ctx->multi_edge = NULL;
+	ctx->label_tiles = NULL;
+	ctx->relation_tiles = NULL;
+	ctx->workers = NULL;
 	return ctx;
 }
 
+static void _GraphDecodeContext_FreeTiles(GrB_Matrix ***tiles) {
+	if(*tiles == NULL) return;
+
+	uint n = array_len(*tiles);
+	for(uint i = 0; i < n; i++) {
+		GrB_Matrix *m_tiles = (*tiles)[i];
+		if(m_tiles == NULL) continue;
+
+		uint tile_count = array_len(m_tiles);
+		for(uint j = 0; j < tile_count; j++) {
+			if(m_tiles[j] != NULL) GrB_Matrix_free(m_tiles + j);
+		}
+		array_free(m_tiles);
+	}
+
+	array_free(*tiles);
+	*tiles = NULL;
+}
+
 void GraphDecodeContext_Reset(GraphDecodeContext *ctx) {
 	ASSERT(ctx);
 
+	GraphDecodeContext_WaitTasks(ctx);
+
 	ctx->keys_processed    =  0;
 	ctx->graph_keys_count  =  1;
 
@@ -29,6 +54,65 @@ void GraphDecodeContext_Reset(GraphDecodeContext *ctx) {
 		array_free(ctx->multi_edge);
 		ctx->multi_edge = NULL;
 	}
+
+	_GraphDecodeContext_FreeTiles(&ctx->label_tiles);
+	_GraphDecodeContext_FreeTiles(&ctx->relation_tiles);
+}
+
+void GraphDecodeContext_InitTiles(GraphDecodeContext *ctx, uint64_t label_count,
+		uint64_t relation_count) {
+	ASSERT(ctx);
+	ASSERT(ctx->label_tiles == NULL && ctx->relation_tiles == NULL);
+
+	ctx->label_tiles = array_newlen(GrB_Matrix *, label_count);
+	for(uint64_t i = 0; i < label_count; i++) ctx->label_tiles[i] = NULL;
+
+	ctx->relation_tiles = array_newlen(GrB_Matrix *, relation_count);
+	for(uint64_t i = 0; i < relation_count; i++) ctx->relation_tiles[i] = NULL;
+}
+
+void GraphDecodeContext_SetTile(GrB_Matrix **tiles, uint64_t m, uint64_t tile,
+		uint64_t tile_count, GrB_Matrix T) {
+	ASSERT(tiles != NULL);
+	ASSERT(m < array_len(tiles));
+	ASSERT(tile < tile_count);
+
+	// tiles may arrive in any order, allocate room for all of them
+	if(tiles[m] == NULL) {
+		tiles[m] = array_newlen(GrB_Matrix, tile_count);
+		for(uint64_t i = 0; i < tile_count; i++) tiles[m][i] = NULL;
+	}
+
+	ASSERT(array_len(tiles[m]) == tile_count);
+	ASSERT(tiles[m][tile] == NULL);
+	tiles[m][tile] = T;
+}
+
+void GraphDecodeContext_AddTask(GraphDecodeContext *ctx, void (*task)(void *),
+		void *arg) {
+	ASSERT(ctx);
+	ASSERT(task);
+
+	// workers are created lazily, one per reader thread
+	if(ctx->workers == NULL) {
+		uint n = ThreadPools_ReadersCount();
+		ctx->workers = thpool_init((n > 0) ? n : 1, "decoder");
+		ASSERT(ctx->workers != NULL);
+	}
+
+	int res = thpool_add_work(ctx->workers, task, arg);
+	ASSERT(res == 0);
+	UNUSED(res);
+}
+
+void GraphDecodeContext_WaitTasks(GraphDecodeContext *ctx) {
+	ASSERT(ctx);
+
+	if(ctx->workers == NULL) return;
+
+	thpool_wait(ctx->workers);
+	thpool_destroy(ctx->workers);
+	ctx->workers = NULL;
 }
 
 void GraphDecodeContext_SetKeyCount(GraphDecodeContext *ctx, uint64_t key_count) {
@@ -75,6 +159,7 @@ bool GraphDecodeContext_GetProcessedKeyCount(const GraphDecodeContext *ctx) {
 
 void GraphDecodeContext_Free(GraphDecodeContext *ctx) {
 	if(ctx) {
+		GraphDecodeContext_WaitTasks(ctx);
 		raxFree(ctx->meta_keys);
 
 		if(ctx->multi_edge) {
@@ -82,6 +167,9 @@ void GraphDecodeContext_Free(GraphDecodeContext *ctx) {
 			ctx->multi_edge = NULL;
 		}
 
+		_GraphDecodeContext_FreeTiles(&ctx->label_tiles);
+		_GraphDecodeContext_FreeTiles(&ctx->relation_tiles);
+
 		rm_free(ctx);
 	}
 }
@@ -10,6 +10,8 @@
 #include "stdbool.h"
 #include "stdint.h"
 #include "rax.h"
+#include "../util/thpool/thpool.h"
+#include "../../deps/GraphBLAS/Include/GraphBLAS.h"
 
 // A struct that maintains the state of a graph decoding from RDB.
 typedef struct {
@@ -17,6 +19,9 @@ typedef struct {
 	uint64_t graph_keys_count;  // The number of keys representing the graph.
 	rax *meta_keys;             // The meta keys encountered so far in the decode process.
 	uint64_t *multi_edge;       // Is relation contains multi edge values.
+	GrB_Matrix **label_tiles;     // Decoded label matrices tiles.
+	GrB_Matrix **relation_tiles;  // Decoded relation matrices tiles.
+	threadpool workers;           // Threads decoding entities payloads.
 } GraphDecodeContext;
 
 // Creates a new graph decoding context.
@@ -25,6 +30,21 @@ GraphDecodeContext *GraphDecodeContext_New();
 // Reset a graph decoding context.
 void GraphDecodeContext_Reset(GraphDecodeContext *ctx);
 
+// Allocates room for the tiles of each label and relation matrix.
+void GraphDecodeContext_InitTiles(GraphDecodeContext *ctx, uint64_t label_count,
+		uint64_t relation_count);
+
+// Stores a decoded matrix tile.
+void GraphDecodeContext_SetTile(GrB_Matrix **tiles, uint64_t m, uint64_t tile,
+		uint64_t tile_count, GrB_Matrix T);
+
+// Hands a decoding task to the context's worker threads.
+void GraphDecodeContext_AddTask(GraphDecodeContext *ctx, void (*task)(void *),
+		void *arg);
+
+// Waits for all decoding tasks to complete.
+void GraphDecodeContext_WaitTasks(GraphDecodeContext *ctx);
+
 // Sets the number of keys required for decoding the graph.
 void GraphDecodeContext_SetKeyCount(GraphDecodeContext *ctx, uint64_t key_count);
 
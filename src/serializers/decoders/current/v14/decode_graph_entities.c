@@ -0,0 +1,197 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "decode_v14.h"
+#include "../../../../util/compression/compression.h"
+
+// decoding task, restores the attributes of a batch of entities
+typedef struct {
+	uint64_t n;              // number of entities
+	AttributeSet **sets;     // entities attribute-sets
+	CompressionCodec codec;  // attributes compression codec
+	char *attrs;             // encoded attributes
+	size_t attrs_size;       // encoded attributes size
+	size_t raw_size;         // decompressed attributes size
+} DecodeAttributesTask;
+
+static AttributeSet _ReadAttributeSet
+(
+	FILE *stream
+) {
+	// Format:
+	// #attributes N (varint)
+	// (attribute ID (varint), value type, value) X N
+
+	ushort n = Varint_Read(stream);
+
+	SIValue vals[n];
+	Attribute_ID ids[n];
+
+	for(ushort i = 0; i < n; i++) {
+		ids[i]  = Varint_Read(stream);
+		vals[i] = SIValue_FromBinary(stream);
+	}
+
+	AttributeSet set = NULL;
+	AttributeSet_AddNoClone(&set, ids, vals, n, false);
+
+	return set;
+}
+
+// runs on a worker thread
+// each task owns a distinct set of preallocated datablock items
+static void _DecodeAttributes
+(
+	void *arg
+) {
+	DecodeAttributesTask *task = (DecodeAttributesTask *)arg;
+
+	char *attrs = task->attrs;
+	if(task->codec == COMPRESSION_LZ4) {
+		attrs = rm_malloc(task->raw_size);
+		bool res = Compression_LZ4Decompress(task->attrs, task->attrs_size,
+				attrs, task->raw_size);
+		ASSERT(res == true);
+		UNUSED(res);
+	}
+
+	FILE *stream = fmemopen(attrs, task->raw_size, "r");
+	ASSERT(stream != NULL);
+
+	for(uint64_t i = 0; i < task->n; i++) {
+		*task->sets[i] = _ReadAttributeSet(stream);
+	}
+
+	fclose(stream);
+
+	if(attrs != task->attrs) rm_free(attrs);
+	RedisModule_Free(task->attrs);
+	rm_free(task->sets);
+	rm_free(task);
+}
+
+// loads a batch of entities
+// entities are allocated on the calling thread
+// their attributes are decoded by the decode context's workers
+static void _RdbLoadEntities
+(
+	RedisModuleIO *rdb,
+	GraphContext *gc,
+	GraphEntityType t,
+	uint64_t entity_count
+) {
+	// Format:
+	//  codec
+	//  IDs buffer:
+	//   ID delta (varint) X N
+	//  attributes buffer size
+	//  attributes buffer, compressed according to codec:
+	//   (#attributes M, (attribute ID, value type, value) X M) X N
+
+	if(entity_count == 0) return;
+
+	DecodeAttributesTask *task = rm_malloc(sizeof(DecodeAttributesTask));
+	task->n     = entity_count;
+	task->sets  = rm_malloc(sizeof(AttributeSet *) * entity_count);
+	task->codec = RedisModule_LoadUnsigned(rdb);
+	ASSERT(task->codec == COMPRESSION_NONE || task->codec == COMPRESSION_LZ4);
+
+	size_t len;
+	char *ids = RedisModule_LoadStringBuffer(rdb, &len);
+
+	task->raw_size = RedisModule_LoadUnsigned(rdb);
+	task->attrs    = RedisModule_LoadStringBuffer(rdb, &task->attrs_size);
+
+	FILE *stream = fmemopen(ids, len, "r");
+	ASSERT(stream != NULL);
+
+	EntityID id = 0;
+	for(uint64_t i = 0; i < entity_count; i++) {
+		id += Varint_Read(stream);
+		if(t == GETYPE_NODE) {
+			Node n;
+			Serializer_Graph_SetNode(gc->g, id, NULL, 0, &n);
+			task->sets[i] = n.attributes;
+		} else {
+			Edge e;
+			Serializer_Graph_AllocateEdge(gc->g, id, &e);
+			task->sets[i] = e.attributes;
+		}
+	}
+
+	fclose(stream);
+	RedisModule_Free(ids);
+
+	// decoded sizes are reported along with the encoded ones
+	// raw size accounts for full width IDs, see _RdbSaveDataBlock_v14
+	GraphEncodeContext_AddEncodedBytes(gc->encoding_context,
+			sizeof(EntityID) * entity_count + task->raw_size,
+			len + task->attrs_size);
+
+	GraphDecodeContext_AddTask(gc->decoding_context, _DecodeAttributes, task);
+}
+
+void RdbLoadNodes_v14
+(
+	RedisModuleIO *rdb,
+	GraphContext *gc,
+	uint64_t node_count
+) {
+	// Format:
+	//  codec
+	//  IDs buffer
+	//  attributes buffer size
+	//  attributes buffer
+	//
+	// node labels are restored along with the label matrices
+
+	_RdbLoadEntities(rdb, gc, GETYPE_NODE, node_count);
+}
+
+void RdbLoadDeletedNodes_v14
+(
+	RedisModuleIO *rdb,
+	GraphContext *gc,
+	uint64_t deleted_node_count
+) {
+	// Format:
+	// node id X N
+	for(uint64_t i = 0; i < deleted_node_count; i++) {
+		NodeID id = RedisModule_LoadUnsigned(rdb);
+		Serializer_Graph_MarkNodeDeleted(gc->g, id);
+	}
+}
+
+void RdbLoadEdges_v14
+(
+	RedisModuleIO *rdb,
+	GraphContext *gc,
+	uint64_t edge_count
+) {
+	// Format:
+	//  codec
+	//  IDs buffer
+	//  attributes buffer size
+	//  attributes buffer
+	//
+	// edge connections are restored along with the relation matrices
+
+	_RdbLoadEntities(rdb, gc, GETYPE_EDGE, edge_count);
+}
+
+void RdbLoadDeletedEdges_v14
+(
+	RedisModuleIO *rdb,
+	GraphContext *gc,
+	uint64_t deleted_edge_count
+) {
+	// Format:
+	// edge id X N
+	for(uint64_t i = 0; i < deleted_edge_count; i++) {
+		EdgeID id = RedisModule_LoadUnsigned(rdb);
+		Serializer_Graph_MarkEdgeDeleted(gc->g, id);
+	}
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "decode_v14.h"
+
+// loads a single serialized tile
+static GrB_Matrix _RdbLoadTile
+(
+	RedisModuleIO *rdb
+) {
+	size_t     len;
+	GrB_Matrix T    = NULL;
+	char       *blob = RedisModule_LoadStringBuffer(rdb, &len);
+
+	GrB_Info info = GxB_Matrix_deserialize(&T, NULL, blob, len, NULL);
+	ASSERT(info == GrB_SUCCESS);
+	UNUSED(info);
+
+	RedisModule_Free(blob);
+
+	return T;
+}
+
+static void _RdbLoadMultiEdgeLists
+(
+	RedisModuleIO *rdb,
+	GraphContext *gc,
+	RelationID r
+) {
+	// Format:
+	//  (list ID, #IDs N, (ID) X N) X #lists
+
+	size_t len;
+	uint64_t *buff = (uint64_t *)RedisModule_LoadStringBuffer(rdb, &len);
+	uint64_t *end  = buff + len / sizeof(uint64_t);
+
+	for(uint64_t *it = buff; it < end;) {
+		uint64_t list = it[0];
+		uint32_t n    = it[1];
+		ASSERT(it + 2 + n <= end);
+
+		Serializer_Graph_SetMultiEdgeList(gc->g, r, list, it + 2, n);
+		it += 2 + n;
+	}
+
+	RedisModule_Free(buff);
+}
+
+void RdbLoadLabelMatrices_v14
+(
+	RedisModuleIO *rdb,
+	GraphContext *gc,
+	uint64_t tile_count
+) {
+	// Format:
+	// Tile format * tile_count:
+	//  label ID
+	//  tile index
+	//  #tiles
+	//  tile blob
+
+	for(uint64_t i = 0; i < tile_count; i++) {
+		LabelID  l     = RedisModule_LoadUnsigned(rdb);
+		uint64_t tile  = RedisModule_LoadUnsigned(rdb);
+		uint64_t tiles = RedisModule_LoadUnsigned(rdb);
+
+		GraphDecodeContext_SetTile(gc->decoding_context->label_tiles, l, tile,
+				tiles, _RdbLoadTile(rdb));
+	}
+}
+
+void RdbLoadRelationMatrices_v14
+(
+	RedisModuleIO *rdb,
+	GraphContext *gc,
+	uint64_t tile_count
+) {
+	// Format:
+	// Tile format * tile_count:
+	//  relation ID
+	//  tile index
+	//  #tiles
+	//  tile blob
+	//  multi-edge lists (last tile only)
+
+	for(uint64_t i = 0; i < tile_count; i++) {
+		RelationID r     = RedisModule_LoadUnsigned(rdb);
+		uint64_t   tile  = RedisModule_LoadUnsigned(rdb);
+		uint64_t   tiles = RedisModule_LoadUnsigned(rdb);
+
+		GraphDecodeContext_SetTile(gc->decoding_context->relation_tiles, r,
+				tile, tiles, _RdbLoadTile(rdb));
+
+		if(tile == tiles - 1) _RdbLoadMultiEdgeLists(rdb, gc, r);
+	}
+}
+
+// concatenates a matrix's row tiles, tiles are freed
+static GrB_Matrix _ConcatTiles
+(
+	GrB_Matrix *tiles
+) {
+	ASSERT(tiles != NULL);
+
+	GrB_Info   info;
+	GrB_Type   t;
+	GrB_Index  ncols;
+	GrB_Index  nrows = 0;
+	GrB_Matrix A     = NULL;
+	uint       n     = array_len(tiles);
+	UNUSED(info);
+
+	if(n == 1) {
+		A = tiles[0];
+		tiles[0] = NULL;
+		return A;
+	}
+
+	for(uint i = 0; i < n; i++) {
+		GrB_Index tile_nrows;
+		ASSERT(tiles[i] != NULL);
+		info = GrB_Matrix_nrows(&tile_nrows, tiles[i]);
+		ASSERT(info == GrB_SUCCESS);
+		nrows += tile_nrows;
+	}
+
+	info = GxB_Matrix_type(&t, tiles[0]);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_ncols(&ncols, tiles[0]);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = GrB_Matrix_new(&A, t, nrows, ncols);
+	ASSERT(info == GrB_SUCCESS);
+	info = GxB_Matrix_concat(A, tiles, n, 1, NULL);
+	ASSERT(info == GrB_SUCCESS);
+
+	for(uint i = 0; i < n; i++) GrB_Matrix_free(tiles + i);
+
+	return A;
+}
+
+void RdbLoadMatrices_v14
+(
+	GraphContext *gc
+) {
+	ASSERT(gc != NULL);
+
+	GraphDecodeContext *ctx = gc->decoding_context;
+
+	uint label_count = array_len(ctx->label_tiles);
+	for(uint i = 0; i < label_count; i++) {
+		ASSERT(ctx->label_tiles[i] != NULL);
+		GrB_Matrix L = _ConcatTiles(ctx->label_tiles[i]);
+		Serializer_Graph_SetLabelMatrix(gc->g, i, &L);
+	}
+
+	uint relation_count = array_len(ctx->relation_tiles);
+	for(uint i = 0; i < relation_count; i++) {
+		ASSERT(ctx->relation_tiles[i] != NULL);
+		GrB_Matrix R = _ConcatTiles(ctx->relation_tiles[i]);
+		Serializer_Graph_SetRelationMatrix(gc->g, i, &R);
+	}
+}
+
@@ -28,11 +28,6 @@ static void _GraphEncodeContext_ResetHeader(GraphEncodeContext *ctx) {
 	header->graph_name = NULL;
 	header->label_matrix_count = 0;
 	header->relationship_matrix_count = 0;
-
-	if(header->multi_edge != NULL) {
-		rm_free(header->multi_edge);
-		header->multi_edge = NULL;
-	}
 }
 
 void GraphEncodeContext_Reset(GraphEncodeContext *ctx) {
@@ -43,13 +38,12 @@ void GraphEncodeContext_Reset(GraphEncodeContext *ctx) {
 	ctx->offset = 0;
 	ctx->keys_processed = 0;
 	ctx->state = ENCODE_STATE_INIT;
-	ctx->multiple_edges_src_id = 0;
-	ctx->multiple_edges_dest_id = 0;
-	ctx->multiple_edges_array = NULL;
-	ctx->current_relation_matrix_id = 0;
-	ctx->multiple_edges_current_index = 0;
 
 	Config_Option_get(Config_VKEY_MAX_ENTITY_COUNT, &ctx->vkey_entity_count);
+	Config_Option_get(Config_RDB_COMPRESSION, &ctx->compress);
+
+	ctx->raw_bytes     = 0;
+	ctx->encoded_bytes = 0;
 
 	// Avoid leaks in case or reset during encodeing.
 	if(ctx->datablock_iterator != NULL) {
@@ -58,7 +52,10 @@ void GraphEncodeContext_Reset(GraphEncodeContext *ctx) {
 	}
 
 	// Avoid leaks in case or reset during encodeing.
-	RG_MatrixTupleIter_detach(&ctx->matrix_tuple_iterator);
+	if(ctx->exported != NULL) {
+		GrB_Matrix_free(&ctx->exported);
+		ctx->exported_from = NULL;
+	}
 }
 
 void GraphEncodeContext_InitHeader
@@ -70,27 +67,16 @@ void GraphEncodeContext_InitHeader
 	ASSERT(g   != NULL);
 	ASSERT(ctx != NULL);
 
-	int r_count = Graph_RelationTypeCount(g);
 	GraphEncodeHeader *header = &(ctx->header);
-	ASSERT(header->multi_edge == NULL);
 
 	header->graph_name                 =  graph_name;
 	header->node_count                 =  Graph_NodeCount(g);
 	header->edge_count                 =  Graph_EdgeCount(g);
 	header->deleted_node_count         =  Graph_DeletedNodeCount(g);
 	header->deleted_edge_count         =  Graph_DeletedEdgeCount(g);
-	header->relationship_matrix_count  =  r_count;
+	header->relationship_matrix_count  =  Graph_RelationTypeCount(g);
 	header->label_matrix_count         =  Graph_LabelTypeCount(g);
 	header->key_count                  =  GraphEncodeContext_GetKeyCount(ctx);
-	header->multi_edge                 =  rm_malloc(sizeof(bool) * r_count);
-
-	// denote for each relationship matrix Ri if it contains muti-edge entries
-	// this information alows for an optimization when loading the data
-	// as construction of a matrix without multiple edge entry is cheaper
-	for(uint i = 0; i < r_count; i++) {
-		bool multi_edge = Graph_RelationshipContainsMultiEdge(g, i, false);
-		header->multi_edge[i] = multi_edge;
-	}
 }
 
 EncodeState GraphEncodeContext_GetEncodeState(const GraphEncodeContext *ctx) {
@@ -152,51 +138,55 @@ void GraphEncodeContext_SetDatablockIterator(GraphEncodeContext *ctx,
 	ctx->datablock_iterator = iter;
 }
 
-uint GraphEncodeContext_GetCurrentRelationID(const GraphEncodeContext *ctx) {
-	ASSERT(ctx);
-	return ctx->current_relation_matrix_id;
-}
+GrB_Matrix GraphEncodeContext_GetExportedMatrix
+(
+	GraphEncodeContext *ctx,
+	RG_Matrix M
+) {
+	ASSERT(M   != NULL);
+	ASSERT(ctx != NULL);
 
-void GraphEncodeContext_SetCurrentRelationID(GraphEncodeContext *ctx,
-											 uint current_relation_matrix_id) {
-	ASSERT(ctx);
-	ctx->current_relation_matrix_id = current_relation_matrix_id;
-}
+	if(ctx->exported_from != M) {
+		if(ctx->exported != NULL) GrB_Matrix_free(&ctx->exported);
 
-RG_MatrixTupleIter *GraphEncodeContext_GetMatrixTupleIterator(
-	GraphEncodeContext *ctx) {
-	ASSERT(ctx);
-	return &ctx->matrix_tuple_iterator;
-}
+		GrB_Info info = RG_Matrix_export(&ctx->exported, M);
+		ASSERT(info == GrB_SUCCESS);
+		UNUSED(info);
 
-void GraphEncodeContext_SetMutipleEdgesArray(GraphEncodeContext *ctx, EdgeID *edges,
-											 uint current_index, NodeID src, NodeID dest) {
-	ASSERT(ctx);
-	ctx->multiple_edges_array = edges;
-	ctx->multiple_edges_current_index = current_index;
-	ctx->multiple_edges_src_id = src;
-	ctx->multiple_edges_dest_id = dest;
+		ctx->exported_from = M;
+	}
+
+	return ctx->exported;
 }
 
-EdgeID *GraphEncodeContext_GetMultipleEdgesArray(const GraphEncodeContext *ctx) {
+void GraphEncodeContext_AddEncodedBytes(GraphEncodeContext *ctx, uint64_t raw,
+		uint64_t encoded) {
 	ASSERT(ctx);
-	return ctx->multiple_edges_array;
+	ctx->raw_bytes     += raw;
+	ctx->encoded_bytes += encoded;
 }
 
-uint GraphEncodeContext_GetMultipleEdgesCurrentIndex(const GraphEncodeContext *ctx) {
+double GraphEncodeContext_CompressionRatio(const GraphEncodeContext *ctx) {
 	ASSERT(ctx);
-	return ctx->multiple_edges_current_index;
+	if(ctx->encoded_bytes == 0) return 1;
+	return (double)ctx->raw_bytes / ctx->encoded_bytes;
 }
 
-
-NodeID GraphEncodeContext_GetMultipleEdgesSourceNode(const GraphEncodeContext *ctx) {
+void GraphEncodeContext_PublishEncodedBytes(GraphEncodeContext *ctx) {
 	ASSERT(ctx);
-	return ctx->multiple_edges_src_id;
+	ctx->last_raw_bytes     = ctx->raw_bytes;
+	ctx->last_encoded_bytes = ctx->encoded_bytes;
+	ctx->raw_bytes          = 0;
+	ctx->encoded_bytes      = 0;
 }
 
-NodeID GraphEncodeContext_GetMultipleEdgesDestinationNode(const GraphEncodeContext *ctx) {
+void GraphEncodeContext_GetLastEncodedBytes(const GraphEncodeContext *ctx,
+		uint64_t *raw, uint64_t *encoded) {
 	ASSERT(ctx);
-	return ctx->multiple_edges_dest_id;
+	ASSERT(raw);
+	ASSERT(encoded);
+	*raw     = ctx->last_raw_bytes;
+	*encoded = ctx->last_encoded_bytes;
 }
 
 bool GraphEncodeContext_Finished(const GraphEncodeContext *ctx) {
@@ -210,13 +200,9 @@ void GraphEncodeContext_IncreaseProcessedKeyCount(GraphEncodeContext *ctx) {
 	ctx->keys_processed++;
 }
 
-static void GraphEncodeContext_FreeHeader(GraphEncodeContext *ctx) {
-	if(ctx->header.multi_edge != NULL) rm_free(ctx->header.multi_edge);
-}
-
 void GraphEncodeContext_Free(GraphEncodeContext *ctx) {
 	if(ctx) {
-		GraphEncodeContext_FreeHeader(ctx);
+		if(ctx->exported != NULL) GrB_Matrix_free(&ctx->exported);
 		raxFree(ctx->meta_keys);
 		rm_free(ctx);
 	}
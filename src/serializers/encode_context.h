@@ -11,7 +11,7 @@
 #include "stdbool.h"
 #include "../graph/graph.h"
 #include "../util/datablock/datablock.h"
-#include "../graph/rg_matrix/rg_matrix_iter.h"
+#include "../graph/rg_matrix/rg_matrix.h"
 #include "../graph/entities/graph_entity.h"
 #include "rax.h"
 
@@ -23,12 +23,13 @@ typedef enum {
 	ENCODE_STATE_EDGES,         // encoding edges
 	ENCODE_STATE_DELETED_EDGES, // encoding deleted edges
 	ENCODE_STATE_GRAPH_SCHEMA,  // encoding graph schemas
+	ENCODE_STATE_LABELS_MATRICES,    // encoding label matrices
+	ENCODE_STATE_RELATION_MATRICES,  // encoding relation matrices
 	ENCODE_STATE_FINAL          // encoding final state
 } EncodeState;
 
 // Header information encoded for every payload
 typedef struct {
-	bool *multi_edge;                // true if R[i] contain a multi edge entry
 	uint64_t key_count;              // number of virtual keys + primary key
 	uint64_t node_count;             // number of nodes
 	uint64_t edge_count;             // number of edges
@@ -47,13 +48,14 @@ typedef struct {
 	uint64_t keys_processed;                    // Count the number of procssed graph keys.
 	GraphEncodeHeader header;                   // Header replied for each vkey
 	uint64_t vkey_entity_count;                 // Number of entities in a single virtual key.
-	NodeID multiple_edges_src_id;               // The current edges array sourc node id.
-	NodeID multiple_edges_dest_id;              // The current edges array destination node id.
-	EdgeID *multiple_edges_array;               // Multiple edges array, save in the context.
-	uint current_relation_matrix_id;            // Current encoded relationship matrix.
-	uint multiple_edges_current_index;          // The current index of the encoded edges array.
 	DataBlockIterator *datablock_iterator;      // Datablock iterator to be saved in the context.
-	RG_MatrixTupleIter matrix_tuple_iterator;   // Matrix tuple iterator to be saved in the context.
+	RG_Matrix exported_from;                    // Matrix currently being encoded.
+	GrB_Matrix exported;                        // Synced copy of the matrix currently being encoded.
+	bool compress;                              // Compress encoded entities.
+	uint64_t raw_bytes;                         // Size of entities prior to compression.
+	uint64_t encoded_bytes;                     // Size of encoded entities.
+	uint64_t last_raw_bytes;                    // Raw size of entities last encoded or decoded in full.
+	uint64_t last_encoded_bytes;                // Encoded size of entities last encoded or decoded in full.
 } GraphEncodeContext;
 
 // Creates a new graph encoding context.
@@ -98,31 +100,25 @@ DataBlockIterator *GraphEncodeContext_GetDatablockIterator(const GraphEncodeCont
 // Set graph encoding context datablock iterator - keep iterator state for further usage.
 void GraphEncodeContext_SetDatablockIterator(GraphEncodeContext *ctx, DataBlockIterator *iter);
 
-// Retrieve graph encoding context current encoded relation matrix id.
-uint GraphEncodeContext_GetCurrentRelationID(const GraphEncodeContext *ctx);
+// Returns a synced copy of 'M', the copy is owned by the context
+// and is reused for as long as 'M' is being encoded.
+GrB_Matrix GraphEncodeContext_GetExportedMatrix(GraphEncodeContext *ctx, RG_Matrix M);
 
-// Set graph encoding context current encoded relation matrix id.
-void GraphEncodeContext_SetCurrentRelationID(GraphEncodeContext *ctx,
-											 uint current_relation_matrix_id);
+// Accumulates the size of encoded entities before and after compression.
+void GraphEncodeContext_AddEncodedBytes(GraphEncodeContext *ctx, uint64_t raw,
+		uint64_t encoded);
 
-// Retrieve stored matrix tuple iterator.
-RG_MatrixTupleIter *GraphEncodeContext_GetMatrixTupleIterator(GraphEncodeContext *ctx);
+// Returns the ratio between the entities raw and encoded sizes.
+double GraphEncodeContext_CompressionRatio(const GraphEncodeContext *ctx);
 
-// Sets a multiple edges array and the current index, for saving the state of multiple edges encoding.
-void GraphEncodeContext_SetMutipleEdgesArray(GraphEncodeContext *ctx, EdgeID *edges,
-											 uint current_index, NodeID src, NodeID dest);
+// Records the accumulated entities sizes as the graph's last completed
+// encoding, called once the entire graph was either encoded or decoded.
+// Sizes are kept across resets and are reported by GRAPH.INFO.
+void GraphEncodeContext_PublishEncodedBytes(GraphEncodeContext *ctx);
 
-// Retrive the multiple edges array, to continue array of multiple edge encoding.
-EdgeID *GraphEncodeContext_GetMultipleEdgesArray(const GraphEncodeContext *ctx);
-
-// Retrive the multiple edges array current index, to continue array of multiple edge encoding.
-uint GraphEncodeContext_GetMultipleEdgesCurrentIndex(const GraphEncodeContext *ctx);
-
-// Retrive the multiple edges array source node.
-NodeID GraphEncodeContext_GetMultipleEdgesSourceNode(const GraphEncodeContext *ctx);
-
-// Retrive the multiple edges array destination node.
-NodeID GraphEncodeContext_GetMultipleEdgesDestinationNode(const GraphEncodeContext *ctx);
+// Retrieves the entities sizes of the graph's last completed encoding.
+void GraphEncodeContext_GetLastEncodedBytes(const GraphEncodeContext *ctx,
+		uint64_t *raw, uint64_t *encoded);
 
 // Returns if the the number of processed keys is equal to the total number of graph keys.
 bool GraphEncodeContext_Finished(const GraphEncodeContext *ctx);
@@ -4,7 +4,7 @@
  * the Server Side Public License v1 (SSPLv1).
  */
 
-#include "encode_v13.h"
+#include "encode_v14.h"
 #include "../../../globals.h"
 
 // Determine whether we are in the context of a bgsave, in which case
@@ -25,8 +25,7 @@ static void _RdbSaveHeader
 	// Deleted node count
 	// Deleted edge count
 	// Label matrix count
-	// Relation matrix count - N
-	// Does relationship Ri holds mutiple edges under a single entry X N 
+	// Relation matrix count
 	// Number of graph keys (graph context key + meta keys)
 	// Schema
 
@@ -55,17 +54,11 @@ static void _RdbSaveHeader
 	// relation matrix count
 	RedisModule_SaveUnsigned(rdb, header->relationship_matrix_count);
 
-	// does relationship Ri holds mutiple edges under a single entry X N
-	for(int i = 0; i < header->relationship_matrix_count; i++) {
-		// true if R[i] contain a multi edge entry
-		RedisModule_SaveUnsigned(rdb, header->multi_edge[i]);
-	}
-
 	// number of keys
 	RedisModule_SaveUnsigned(rdb, header->key_count);
 
 	// save graph schemas
-	RdbSaveGraphSchema_v13(rdb, gc);
+	RdbSaveGraphSchema_v14(rdb, gc);
 }
 
 // returns a state information regarding the number of entities required
@@ -94,6 +87,14 @@ static PayloadInfo _StatePayloadInfo
 	case ENCODE_STATE_GRAPH_SCHEMA:
 		required_entities_count = 1;
 		break;
+	case ENCODE_STATE_LABELS_MATRICES:
+		required_entities_count = Graph_LabelTypeCount(gc->g) *
+			RdbSaveMatrixTileCount_v14(gc);
+		break;
+	case ENCODE_STATE_RELATION_MATRICES:
+		required_entities_count = Graph_RelationTypeCount(gc->g) *
+			RdbSaveMatrixTileCount_v14(gc);
+		break;
 	default:
 		ASSERT(false && "Unknown encoding state in _CurrentStatePayloadInfo");
 		break;
@@ -168,7 +169,7 @@ static PayloadInfo *_RdbSaveKeySchema
 	return payloads;
 }
 
-void RdbSaveGraph_v13
+void RdbSaveGraph_v14
 (
 	RedisModuleIO *rdb,
 	void *value
@@ -187,6 +188,8 @@ void RdbSaveGraph_v13
 	// 3. Edges
 	// 4. Deleted edges
 	// 5. Graph schema
+	// 6. Label matrices
+	// 7. Relation matrices
 	//
 	// Each payload type can spread over one or more keys. For example:
 	// A graph with 200,000 nodes, and the number of entities per payload
@@ -221,20 +224,26 @@ void RdbSaveGraph_v13
 		PayloadInfo payload = key_schema[i];
 		switch(payload.state) {
 		case ENCODE_STATE_NODES:
-			RdbSaveNodes_v13(rdb, gc, payload.entities_count);
+			RdbSaveNodes_v14(rdb, gc, payload.entities_count);
 			break;
 		case ENCODE_STATE_DELETED_NODES:
-			RdbSaveDeletedNodes_v13(rdb, gc, payload.entities_count);
+			RdbSaveDeletedNodes_v14(rdb, gc, payload.entities_count);
 			break;
 		case ENCODE_STATE_EDGES:
-			RdbSaveEdges_v13(rdb, gc, payload.entities_count);
+			RdbSaveEdges_v14(rdb, gc, payload.entities_count);
 			break;
 		case ENCODE_STATE_DELETED_EDGES:
-			RdbSaveDeletedEdges_v13(rdb, gc, payload.entities_count);
+			RdbSaveDeletedEdges_v14(rdb, gc, payload.entities_count);
 			break;
 		case ENCODE_STATE_GRAPH_SCHEMA:
 			// skip, handled in _RdbSaveHeader
 			break;
+		case ENCODE_STATE_LABELS_MATRICES:
+			RdbSaveLabelMatrices_v14(rdb, gc, payload.entities_count);
+			break;
+		case ENCODE_STATE_RELATION_MATRICES:
+			RdbSaveRelationMatrices_v14(rdb, gc, payload.entities_count);
+			break;
 		default:
 			ASSERT(false && "Unknown encoding phase");
 			break;
@@ -252,9 +261,13 @@ void RdbSaveGraph_v13
 	// if finished encoding, reset context
 	GraphEncodeContext_IncreaseProcessedKeyCount(gc->encoding_context);
 	if(GraphEncodeContext_Finished(gc->encoding_context)) {
-		GraphEncodeContext_Reset(gc->encoding_context);
 		RedisModuleCtx *ctx = RedisModule_GetContextFromIO(rdb);
-		RedisModule_Log(ctx, "notice", "Done encoding graph %s", gc->graph_name);
+		RedisModule_Log(ctx, "notice",
+				"Done encoding graph %s, entities compression ratio %.2f",
+				gc->graph_name,
+				GraphEncodeContext_CompressionRatio(gc->encoding_context));
+		GraphEncodeContext_PublishEncodedBytes(gc->encoding_context);
+		GraphEncodeContext_Reset(gc->encoding_context);
 	}
 
 	// if a lock was acquired, release it
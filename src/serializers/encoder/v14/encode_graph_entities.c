@@ -0,0 +1,208 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "encode_v14.h"
+#include "../../../datatypes/datatypes.h"
+#include "../../../util/compression/compression.h"
+
+// writes entity's attributes to stream
+static void _WriteAttributeSet
+(
+	FILE *stream,
+	const GraphEntity *e
+) {
+	// Format:
+	// #attributes N (varint)
+	// (attribute ID (varint), value type, value) X N
+
+	const AttributeSet set = GraphEntity_GetAttributes(e);
+	ushort attr_count = AttributeSet_Count(set);
+
+	Varint_Write(stream, attr_count);
+
+	for(ushort i = 0; i < attr_count; i++) {
+		Attribute_ID attr_id;
+		SIValue value = AttributeSet_GetIdx(set, i, &attr_id);
+		Varint_Write(stream, attr_id);
+		SIValue_ToBinary(stream, &value);
+	}
+}
+
+// encodes entities of a datablock, resuming from the last encoded entity
+static void _RdbSaveDataBlock_v14
+(
+	RedisModuleIO *rdb,
+	GraphContext *gc,
+	DataBlockIterator *(*scan)(const Graph *),
+	uint64_t entity_count,
+	uint64_t entities_to_encode
+) {
+	// Format:
+	//  codec
+	//  IDs buffer:
+	//   ID delta (varint) X N
+	//  attributes buffer size
+	//  attributes buffer, compressed according to codec:
+	//   (#attributes M, (attribute ID, value type, value) X M) X N
+	//
+	// entities are encoded as two binary buffers, allowing the decoder to
+	// allocate all entities up front and hand the attributes buffer over
+	// to a worker thread
+
+	// get the number of entities already encoded
+	uint64_t offset = GraphEncodeContext_GetProcessedEntitiesOffset(gc->encoding_context);
+
+	// get datablock iterator from context,
+	// already set to offset by a previous encodeing of entities, or create new one
+	DataBlockIterator *iter = GraphEncodeContext_GetDatablockIterator(gc->encoding_context);
+	if(!iter) {
+		iter = scan(gc->g);
+		GraphEncodeContext_SetDatablockIterator(gc->encoding_context, iter);
+	}
+
+	char     *ids        = NULL;
+	char     *attrs      = NULL;
+	size_t   ids_size    = 0;
+	size_t   attrs_size  = 0;
+	EntityID prev_id     = 0;
+	FILE     *ids_stream = open_memstream(&ids, &ids_size);
+	FILE     *stream     = open_memstream(&attrs, &attrs_size);
+	ASSERT(stream != NULL && ids_stream != NULL);
+
+	for(uint64_t i = 0; i < entities_to_encode; i++) {
+		GraphEntity e;
+		e.attributes = (AttributeSet *)DataBlockIterator_Next(iter, &e.id);
+
+		// IDs are scanned in increasing order, encode their deltas
+		EntityID id = ENTITY_GET_ID(&e);
+		Varint_Write(ids_stream, id - prev_id);
+		prev_id = id;
+
+		_WriteAttributeSet(stream, &e);
+	}
+
+	fclose(ids_stream);
+	fclose(stream);
+
+	// compress attributes, falling back to raw attributes
+	// in case compression doesn't save space
+	size_t           payload_size = attrs_size;
+	char             *payload     = NULL;
+	CompressionCodec codec        = COMPRESSION_NONE;
+
+	if(gc->encoding_context->compress) {
+		payload = Compression_LZ4Compress(attrs, attrs_size, &payload_size);
+		if(payload != NULL) codec = COMPRESSION_LZ4;
+	}
+
+	RedisModule_SaveUnsigned(rdb, codec);
+	RedisModule_SaveStringBuffer(rdb, ids, ids_size);
+	RedisModule_SaveUnsigned(rdb, attrs_size);
+	RedisModule_SaveStringBuffer(rdb, (payload != NULL) ? payload : attrs,
+			payload_size);
+
+	// raw size accounts for full width IDs
+	GraphEncodeContext_AddEncodedBytes(gc->encoding_context,
+			sizeof(EntityID) * entities_to_encode + attrs_size,
+			ids_size + payload_size);
+
+	free(ids);
+	free(attrs);
+	if(payload != NULL) rm_free(payload);
+
+	// check if done encodeing entities
+	if(offset + entities_to_encode == entity_count) {
+		DataBlockIterator_Free(iter);
+		iter = NULL;
+		GraphEncodeContext_SetDatablockIterator(gc->encoding_context, iter);
+	}
+}
+
+static void _RdbSaveDeletedEntities_v14
+(
+	RedisModuleIO *rdb,
+	GraphContext *gc,
+	uint64_t deleted_entities_to_encode,
+	uint64_t *deleted_id_list
+) {
+	// Get the number of deleted entities already encoded.
+	uint64_t offset = GraphEncodeContext_GetProcessedEntitiesOffset(gc->encoding_context);
+
+	// Iterated over the required range in the datablock deleted items.
+	for(uint64_t i = offset; i < offset + deleted_entities_to_encode; i++) {
+		RedisModule_SaveUnsigned(rdb, deleted_id_list[i]);
+	}
+}
+
+void RdbSaveDeletedNodes_v14
+(
+	RedisModuleIO *rdb,
+	GraphContext *gc,
+	uint64_t deleted_nodes_to_encode
+) {
+	// Format:
+	// node id X N
+
+	if(deleted_nodes_to_encode == 0) return;
+	// get deleted nodes list
+	uint64_t *deleted_nodes_list = Serializer_Graph_GetDeletedNodesList(gc->g);
+	_RdbSaveDeletedEntities_v14(rdb, gc, deleted_nodes_to_encode, deleted_nodes_list);
+}
+
+void RdbSaveDeletedEdges_v14
+(
+	RedisModuleIO *rdb,
+	GraphContext *gc,
+	uint64_t deleted_edges_to_encode
+) {
+	// Format:
+	// edge id X N
+
+	if(deleted_edges_to_encode == 0) return;
+
+	// get deleted edges list
+	uint64_t *deleted_edges_list = Serializer_Graph_GetDeletedEdgesList(gc->g);
+	_RdbSaveDeletedEntities_v14(rdb, gc, deleted_edges_to_encode, deleted_edges_list);
+}
+
+void RdbSaveNodes_v14
+(
+	RedisModuleIO *rdb,
+	GraphContext *gc,
+	uint64_t nodes_to_encode
+) {
+	// Format:
+	//  codec
+	//  IDs buffer
+	//  attributes buffer size
+	//  attributes buffer
+
+	if(nodes_to_encode == 0) return;
+
+	_RdbSaveDataBlock_v14(rdb, gc, Graph_ScanNodes, Graph_NodeCount(gc->g),
+			nodes_to_encode);
+}
+
+void RdbSaveEdges_v14
+(
+	RedisModuleIO *rdb,
+	GraphContext *gc,
+	uint64_t edges_to_encode
+) {
+	// Format:
+	//  codec
+	//  IDs buffer
+	//  attributes buffer size
+	//  attributes buffer
+	//
+	// edges are encoded in ID order, their source, destination
+	// and relationship-type are encoded by the relation matrices
+
+	if(edges_to_encode == 0) return;
+
+	_RdbSaveDataBlock_v14(rdb, gc, Graph_ScanEdges, Graph_EdgeCount(gc->g),
+			edges_to_encode);
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "encode_v14.h"
+
+// matrices are encoded as GraphBLAS serialized blobs
+// to bound the size of a single blob and to allow a matrix to spread
+// across multiple virtual keys, each matrix is split into row tiles
+// holding up to VKEY_MAX_ENTITY_COUNT rows
+
+uint64_t RdbSaveMatrixTileCount_v14
+(
+	const GraphContext *gc
+) {
+	ASSERT(gc != NULL);
+
+	uint64_t dim  = Graph_RequiredMatrixDim(gc->g);
+	uint64_t rows = gc->encoding_context->vkey_entity_count;
+	uint64_t n    = dim / rows + (dim % rows != 0);
+
+	return MAX(n, 1);
+}
+
+static void _RdbSaveTile
+(
+	RedisModuleIO *rdb,
+	GraphContext *gc,
+	RG_Matrix M,
+	uint64_t tile,
+	uint64_t tile_count
+) {
+	GrB_Info   info;
+	GrB_Type   t;
+	GrB_Index  nrows;
+	void       *blob      = NULL;
+	GrB_Index  blob_size  = 0;
+	GrB_Matrix T          = NULL;
+	GrB_Index  dim        = Graph_RequiredMatrixDim(gc->g);
+	GrB_Matrix A          = GraphEncodeContext_GetExportedMatrix(
+			gc->encoding_context, M);
+	UNUSED(info);
+
+	// tiles are computed against the graph's required dimensions
+	// matrices pending a resize are resized on the exported copy
+	info = GrB_Matrix_nrows(&nrows, A);
+	ASSERT(info == GrB_SUCCESS);
+	if(nrows != dim) {
+		info = GrB_Matrix_resize(A, dim, dim);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	if(tile_count == 1) {
+		T = A;
+	} else {
+		uint64_t  rows = gc->encoding_context->vkey_entity_count;
+		GrB_Index I[2] = {tile * rows, MIN((tile + 1) * rows, dim) - 1};
+
+		info = GxB_Matrix_type(&t, A);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_Matrix_new(&T, t, I[1] - I[0] + 1, dim);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_Matrix_extract(T, NULL, NULL, A, I, GxB_RANGE, GrB_ALL, dim,
+				NULL);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	info = GxB_Matrix_serialize(&blob, &blob_size, T, NULL);
+	ASSERT(info == GrB_SUCCESS);
+
+	RedisModule_SaveStringBuffer(rdb, blob, blob_size);
+
+	rm_free(blob);
+	if(T != A) GrB_Matrix_free(&T);
+}
+
+static void _RdbSaveMultiEdgeLists
+(
+	RedisModuleIO *rdb,
+	RG_Matrix R
+) {
+	// Format:
+	//  (list ID, #IDs N, (ID) X N) X #lists
+	//
+	// encoded as a single buffer, vacant lists are skipped
+
+	const MultiEdgePool *pool = R->multi_edges;
+	uint list_count = array_len(pool->lists);
+
+	uint64_t *buff = array_new(uint64_t, 0);
+	for(uint i = 0; i < list_count; i++) {
+		uint32_t n;
+		if(pool->lists[i].len == 0) continue;
+
+		const uint64_t *ids = MultiEdgePool_Get(pool, i, &n);
+		array_append(buff, i);
+		array_append(buff, n);
+		for(uint32_t j = 0; j < n; j++) array_append(buff, ids[j]);
+	}
+
+	RedisModule_SaveStringBuffer(rdb, (const char *)buff,
+			sizeof(uint64_t) * array_len(buff));
+
+	array_free(buff);
+}
+
+void RdbSaveLabelMatrices_v14
+(
+	RedisModuleIO *rdb,
+	GraphContext *gc,
+	uint64_t tiles_to_encode
+) {
+	// Format:
+	// Tile format * tiles_to_encode:
+	//  label ID
+	//  tile index
+	//  #tiles
+	//  tile blob
+
+	uint64_t tile_count = RdbSaveMatrixTileCount_v14(gc);
+	uint64_t offset =
+		GraphEncodeContext_GetProcessedEntitiesOffset(gc->encoding_context);
+
+	for(uint64_t i = offset; i < offset + tiles_to_encode; i++) {
+		LabelID  l    = i / tile_count;
+		uint64_t tile = i % tile_count;
+
+		RedisModule_SaveUnsigned(rdb, l);
+		RedisModule_SaveUnsigned(rdb, tile);
+		RedisModule_SaveUnsigned(rdb, tile_count);
+
+		_RdbSaveTile(rdb, gc, Graph_GetLabelMatrix(gc->g, l), tile,
+				tile_count);
+	}
+}
+
+void RdbSaveRelationMatrices_v14
+(
+	RedisModuleIO *rdb,
+	GraphContext *gc,
+	uint64_t tiles_to_encode
+) {
+	// Format:
+	// Tile format * tiles_to_encode:
+	//  relation ID
+	//  tile index
+	//  #tiles
+	//  tile blob
+	//  multi-edge lists (last tile only)
+
+	uint64_t tile_count = RdbSaveMatrixTileCount_v14(gc);
+	uint64_t offset =
+		GraphEncodeContext_GetProcessedEntitiesOffset(gc->encoding_context);
+
+	for(uint64_t i = offset; i < offset + tiles_to_encode; i++) {
+		RelationID r    = i / tile_count;
+		uint64_t   tile = i % tile_count;
+		RG_Matrix  R    = Graph_GetRelationMatrix(gc->g, r, false);
+
+		RedisModule_SaveUnsigned(rdb, r);
+		RedisModule_SaveUnsigned(rdb, tile);
+		RedisModule_SaveUnsigned(rdb, tile_count);
+
+		_RdbSaveTile(rdb, gc, R, tile, tile_count);
+
+		// matrix entries holding multiple edges refer to the relation's
+		// multi-edge lists, encode these once the matrix is done
+		if(tile == tile_count - 1) _RdbSaveMultiEdgeLists(rdb, R);
+	}
+}
+
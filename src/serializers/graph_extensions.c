@@ -217,6 +217,135 @@ void Serializer_Graph_SetEdge
 	}
 }
 
+void Serializer_Graph_AllocateEdge
+(
+	Graph *g,
+	EdgeID edge_id,
+	Edge *e
+) {
+	ASSERT(g != NULL);
+	ASSERT(e != NULL);
+
+	AttributeSet *set = DataBlock_AllocateItemOutOfOrder(g->edges, edge_id);
+	*set = NULL;
+
+	e->id         =  edge_id;
+	e->src_id     =  INVALID_ENTITY_ID;
+	e->dest_id    =  INVALID_ENTITY_ID;
+	e->attributes =  set;
+	e->relationID =  GRAPH_NO_RELATION;
+}
+
+// replaces M's underlying matrix with 'A'
+// 'A' is resized to match M's dimensions
+static void _SetMatrix
+(
+	RG_Matrix M,
+	GrB_Matrix *A
+) {
+	GrB_Info  info;
+	GrB_Index nrows;
+	GrB_Index ncols;
+	UNUSED(info);
+
+	// M is expected to be empty
+	ASSERT(RG_Matrix_Synced(M));
+
+	info = RG_Matrix_nrows(&nrows, M);
+	ASSERT(info == GrB_SUCCESS);
+	info = RG_Matrix_ncols(&ncols, M);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = GrB_Matrix_resize(*A, nrows, ncols);
+	ASSERT(info == GrB_SUCCESS);
+	info = GxB_set(*A, GxB_SPARSITY_CONTROL, GxB_SPARSE | GxB_HYPERSPARSE);
+	ASSERT(info == GrB_SUCCESS);
+
+	GrB_Matrix_free(&RG_MATRIX_M(M));
+	RG_MATRIX_M(M) = *A;
+	*A = NULL;
+}
+
+void Serializer_Graph_SetLabelMatrix
+(
+	Graph *g,
+	LabelID l,
+	GrB_Matrix *A
+) {
+	ASSERT(g != NULL);
+	ASSERT(A != NULL && *A != NULL);
+
+	_SetMatrix(Graph_GetLabelMatrix(g, l), A);
+}
+
+void Serializer_Graph_SetRelationMatrix
+(
+	Graph *g,
+	RelationID r,
+	GrB_Matrix *A
+) {
+	ASSERT(g != NULL);
+	ASSERT(A != NULL && *A != NULL);
+
+	GrB_Info  info;
+	GrB_Index n;
+	GrB_Index nvals;
+	RG_Matrix R   = Graph_GetRelationMatrix(g, r, false);
+	RG_Matrix adj = Graph_GetAdjacencyMatrix(g, false);
+	UNUSED(info);
+
+	_SetMatrix(R, A);
+
+	GrB_Matrix m      = RG_MATRIX_M(R);
+	GrB_Matrix tm     = RG_MATRIX_TM(R);
+	GrB_Matrix adj_m  = RG_MATRIX_M(adj);
+	GrB_Matrix adj_tm = RG_MATRIX_TM(adj);
+
+	info = GrB_Matrix_nrows(&n, m);
+	ASSERT(info == GrB_SUCCESS);
+
+	// transposed matrices only track connections, values are irrelevant
+	info = GrB_Matrix_apply(tm, NULL, NULL, GxB_ONE_BOOL, m, GrB_DESC_T0);
+	ASSERT(info == GrB_SUCCESS);
+
+	// adj<R> = true
+	// the structural mask avoids casting edge ID 0 to false
+	info = GrB_Matrix_assign_BOOL(adj_m, m, NULL, true, GrB_ALL, n, GrB_ALL, n,
+			GrB_DESC_S);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_assign_BOOL(adj_tm, tm, NULL, true, GrB_ALL, n, GrB_ALL,
+			n, GrB_DESC_S);
+	ASSERT(info == GrB_SUCCESS);
+
+	// count edges, each multi-edge entry accounts for its list's length
+	info = GrB_Matrix_nvals(&nvals, m);
+	ASSERT(info == GrB_SUCCESS);
+
+	const MultiEdgePool *pool = R->multi_edges;
+	uint list_count = array_len(pool->lists);
+	for(uint i = 0; i < list_count; i++) {
+		uint32_t len = pool->lists[i].len;
+		if(len > 0) nvals += len - 1;
+	}
+
+	GraphStatistics_IncEdgeCount(&g->stats, r, nvals);
+}
+
+void Serializer_Graph_SetMultiEdgeList
+(
+	Graph *g,
+	RelationID r,
+	uint64_t list,
+	const EdgeID *ids,
+	uint32_t n
+) {
+	ASSERT(g   != NULL);
+	ASSERT(ids != NULL);
+
+	RG_Matrix R = Graph_GetRelationMatrix(g, r, false);
+	MultiEdgePool_Restore(R->multi_edges, list, ids, n);
+}
+
 // returns the graph deleted nodes list
 uint64_t *Serializer_Graph_GetDeletedNodesList
 (
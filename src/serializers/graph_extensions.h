@@ -36,6 +36,43 @@ void Serializer_Graph_SetEdge
 	Edge *e                 // pointer to edge
 );
 
+// allocates an edge without connecting it
+// the edge's connection is restored along with its relation matrix
+void Serializer_Graph_AllocateEdge
+(
+	Graph *g,               // graph to add edge to
+	EdgeID edge_id,         // edge ID
+	Edge *e                 // pointer to edge
+);
+
+// sets a label matrix, takes ownership of 'A'
+void Serializer_Graph_SetLabelMatrix
+(
+	Graph *g,               // graph to update
+	LabelID l,              // label
+	GrB_Matrix *A           // label matrix
+);
+
+// sets a relation matrix and its transpose, takes ownership of 'A'
+// the adjacency matrix and edge statistics are updated accordingly
+// the relation's multi-edge lists must be restored beforehand
+void Serializer_Graph_SetRelationMatrix
+(
+	Graph *g,               // graph to update
+	RelationID r,           // relationship-type
+	GrB_Matrix *A           // relation matrix
+);
+
+// restores a multi-edge list of a relation matrix
+void Serializer_Graph_SetMultiEdgeList
+(
+	Graph *g,               // graph to update
+	RelationID r,           // relationship-type
+	uint64_t list,          // list ID
+	const EdgeID *ids,      // edge IDs
+	uint32_t n              // number of edges
+);
+
 // marks a node ID as deleted
 void Serializer_Graph_MarkNodeDeleted
 (
@@ -14,9 +14,9 @@
 // initial number of entries in undo-log
 #define UNDOLOG_INIT_SIZE 32
 
-#define UNDOLOG_GET_ITEM(log, i) DataBlock_GetItem(log, i)
+#define UNDOLOG_GET_ITEM(log, i) DataBlock_GetItem((log)->ops, i)
 #define UNDOLOG_ADD_OP(log, op) \
-	*(UndoOp*)DataBlock_AllocateItem((log), NULL) = op;
+	*(UndoOp*)DataBlock_AllocateItem((log)->ops, NULL) = op;
 
 static void _index_node
 (
@@ -135,17 +135,21 @@ static void _UndoLog_Rollback_Update_Entity
 	for(int i = seq_start; i > seq_end; --i) {
 		UndoOp *op = UNDOLOG_GET_ITEM(ctx->undo_log, i);
 		UndoUpdateOp *update_op = &op->update_op;
+		UndoAttribute *attrs = ctx->undo_log->attrs + update_op->offset;
+		GraphEntity *ge = (update_op->entity_type == GETYPE_NODE)
+			? (GraphEntity *)&update_op->n
+			: (GraphEntity *)&update_op->e;
+
+		// restore modified attributes
+		// ownership over the original values is passed back to the entity
+		for(uint32_t j = 0; j < update_op->count; j++) {
+			_UndoLog_Restore_Entity_Property(ge, attrs[j].id, attrs[j].value);
+		}
 
 		// update indices
 		if(update_op->entity_type == GETYPE_NODE) {
-			// free current entity attribute-set
-			AttributeSet_Free(update_op->n.attributes);
-			// restore entity original attribute-set
-			*update_op->n.attributes = update_op->set;
 			_index_node(ctx, &update_op->n);
 		} else {
-			AttributeSet_Free(update_op->e.attributes);
-			*update_op->e.attributes = update_op->set;
 			_index_edge(ctx, &update_op->e);
 		}
 	}
@@ -326,11 +330,13 @@ static void _UndoLog_Rollback_Add_Attribute
 }
 
 UndoLog UndoLog_New(void) {
-	return (UndoLog)DataBlock_New(
-		UNDOLOG_INIT_SIZE,
-		UNDOLOG_INIT_SIZE,
-		sizeof(UndoOp),
-		NULL);
+	UndoLog log = rm_malloc(sizeof(_UndoLog));
+
+	log->ops = DataBlock_New(UNDOLOG_INIT_SIZE, UNDOLOG_INIT_SIZE,
+			sizeof(UndoOp), NULL);
+	log->attrs = array_new(UndoAttribute, UNDOLOG_INIT_SIZE);
+
+	return log;
 }
 
 // returns number of entries in log
@@ -339,7 +345,18 @@ uint UndoLog_Length
 	const UndoLog log  // log to query
 ) {
 	ASSERT(log != NULL);
-	return DataBlock_ItemCount(log);
+	return DataBlock_ItemCount(log->ops);
+}
+
+// returns number of bytes consumed by the log's records
+size_t UndoLog_MemoryUsage
+(
+	const UndoLog log  // log to query
+) {
+	ASSERT(log != NULL);
+
+	return sizeof(_UndoLog) + DataBlock_MemoryUsage(log->ops) +
+		array_sizeof(array_hdr(log->attrs));
 }
 
 //------------------------------------------------------------------------------
@@ -352,7 +369,7 @@ void UndoLog_CreateNode
 	UndoLog log,           // undo log
 	Node *node             // node created
 ) {
-	ASSERT(log != NULL);
+	if(log == NULL) return;
 
 	UndoOp op;
 
@@ -368,7 +385,7 @@ void UndoLog_CreateEdge
 	UndoLog log,           // undo log
 	Edge *edge             // edge created
 ) {
-	ASSERT(log != NULL);
+	if(log == NULL) return;
 
 	UndoOp op;
 
@@ -384,7 +401,7 @@ void UndoLog_DeleteNode
 	UndoLog log,       // undo log
 	Node *node         // node deleted
 ) {
-	ASSERT(log != NULL);
+	if(log == NULL) return;
 	ASSERT(node != NULL);
 
 	UndoOp op;
@@ -418,7 +435,7 @@ void UndoLog_DeleteEdge
 	UndoLog log,   // undo log
 	Edge *edge     // edge deleted
 ) {
-	ASSERT(log != NULL);
+	if(log == NULL) return;
 	ASSERT(edge != NULL);
 
 	UndoOp op;
@@ -444,16 +461,17 @@ void UndoLog_UpdateEntity
 (
 	UndoLog log,                 // undo log
 	GraphEntity *ge,             // updated entity
-	AttributeSet set,            // old attribute set
 	GraphEntityType entity_type  // entity type
 ) {
-	ASSERT(log != NULL);
 	ASSERT(ge != NULL);
 
+	if(log == NULL) return;
+
 	UndoOp op;
 
 	op.type                  = UNDO_UPDATE;
-	op.update_op.set         = set;
+	op.update_op.count       = 0;
+	op.update_op.offset      = array_len(log->attrs);
 	op.update_op.entity_type = entity_type;
 
 	if(entity_type == GETYPE_NODE) {
@@ -465,6 +483,24 @@ void UndoLog_UpdateEntity
 	UNDOLOG_ADD_OP(log, op);
 }
 
+// records the original value of an attribute modified by the
+// most recent entity update
+void UndoLog_UpdateEntityAttribute
+(
+	UndoLog log,      // undo log
+	Attribute_ID id,  // modified attribute
+	SIValue original  // original value, NULL if attribute was added
+) {
+	ASSERT(log != NULL);
+
+	UndoOp *op = UNDOLOG_GET_ITEM(log, DataBlock_ItemCount(log->ops) - 1);
+	ASSERT(op->type == UNDO_UPDATE);
+
+	UndoAttribute attr = {.id = id, .value = original};
+	array_append(log->attrs, attr);
+	op->update_op.count++;
+}
+
 // undo node add label
 void UndoLog_AddLabels
 (
@@ -473,6 +509,8 @@ void UndoLog_AddLabels
 	LabelID *label_ids,          // added labels
 	size_t labels_count          // number of removed labels
 ) {
+	if(log == NULL) return;
+
 	ASSERT(node != NULL);
 	ASSERT(label_ids != NULL);
 
@@ -494,6 +532,8 @@ void UndoLog_RemoveLabels
 	LabelID *label_ids,          // removed labels
 	size_t labels_count          // number of removed labels
 ) {
+	if(log == NULL) return;
+
 	ASSERT(node != NULL);
 	ASSERT(label_ids != NULL);
 
@@ -514,7 +554,7 @@ void UndoLog_AddSchema
 	int schema_id,  // id of the schema
 	SchemaType t    // type of the schema
 ) {
-	ASSERT(log != NULL);
+	if(log == NULL) return;
 	UndoOp op;
 
 	op.type = UNDO_ADD_SCHEMA;
@@ -528,7 +568,7 @@ void UndoLog_AddAttribute
 	UndoLog log,              // undo log
 	Attribute_ID attribute_id // id of the attribute
 ) {
-	ASSERT(log != NULL);
+	if(log == NULL) return;
 	UndoOp op;
 
 	op.type = UNDO_ADD_ATTRIBUTE;
@@ -550,7 +590,7 @@ void UndoLog_Rollback
 	if(_log == NULL) return;
 
 	QueryCtx *ctx  = QueryCtx_GetQueryCtx();
-	uint64_t count = DataBlock_ItemCount(_log);
+	uint64_t count = DataBlock_ItemCount(_log->ops);
 
 	// apply undo operations in reverse order for rollback correctness
 	// find sequences of the same operation and rollback them as a bulk
@@ -599,7 +639,10 @@ void UndoLog_Rollback
 		}
  	}
 
-	DataBlock_Free(_log);
+	// original values were handed back to the graph
+	DataBlock_Free(_log->ops);
+	array_free(_log->attrs);
+	rm_free(_log);
 	*log = NULL;
 }
 
@@ -611,7 +654,7 @@ static void UndoLog_FreeOp
 
 	switch(op->type) {
 		case UNDO_UPDATE:
-			AttributeSet_Free(&op->update_op.set);
+			// original values are freed along with the attribute arena
 			break;
 		case UNDO_CREATE_NODE:
 			break;
@@ -645,13 +688,19 @@ void UndoLog_Free
 	UndoLog _log = *log;
 	if(_log == NULL) return;
 
-	DataBlockIterator *iter = DataBlock_Scan(_log);
+	DataBlockIterator *iter = DataBlock_Scan(_log->ops);
 	UndoOp *op;
 	while((op = DataBlockIterator_Next(iter, NULL))) {
 		UndoLog_FreeOp(op);
 	}
 	DataBlockIterator_Free(iter);
-	DataBlock_Free(_log);
+	DataBlock_Free(_log->ops);
+
+	uint attr_count = array_len(_log->attrs);
+	for(uint i = 0; i < attr_count; i++) SIValue_Free(_log->attrs[i].value);
+	array_free(_log->attrs);
+
+	rm_free(_log);
 	*log = NULL;
 }
 
@@ -19,6 +19,10 @@
 // upon failure for which ever reason we can apply the
 // operations within the undo log to rollback the graph to its
 // original state
+//
+// add operations accept a NULL log, in which case nothing is recorded
+// queries which can't fail once they've modified the graph
+// do not maintain an undo log
 
 // UndoLog operation types
 typedef enum {
@@ -66,6 +70,8 @@ struct UndoDeleteEdgeOp {
 };
 
 // undo graph entity update
+// only modified attributes are recorded, their original values are kept
+// in the undo-log's attribute arena
 typedef struct UndoUpdateOp UndoUpdateOp;
 struct UndoUpdateOp {
 	union {
@@ -73,9 +79,16 @@ struct UndoUpdateOp {
 		Edge e;
 	};
 	GraphEntityType entity_type;  // node/edge
-	AttributeSet set;             // old attribute set
+	uint32_t offset;              // position of first modified attribute
+	uint32_t count;               // number of modified attributes
 };
 
+// original value of a modified attribute
+typedef struct {
+	Attribute_ID id;  // attribute ID
+	SIValue value;    // original value, NULL if attribute was added
+} UndoAttribute;
+
 typedef struct UndoLabelsOp UndoLabelsOp;
 struct UndoLabelsOp {
 	Node node;
@@ -109,7 +122,12 @@ typedef struct {
 } UndoOp;
 
 // container for undo_list
-typedef DataBlock *UndoLog;
+typedef struct {
+	DataBlock *ops;        // undo operations
+	UndoAttribute *attrs;  // append-only arena of original attribute values
+} _UndoLog;
+
+typedef _UndoLog *UndoLog;
 
 // create a new undo-log
 UndoLog UndoLog_New(void);
@@ -120,6 +138,12 @@ uint UndoLog_Length
 	const UndoLog log  // log to query
 );
 
+// returns number of bytes consumed by the log's records
+size_t UndoLog_MemoryUsage
+(
+	const UndoLog log  // log to query
+);
+
 //------------------------------------------------------------------------------
 // UndoLog add operations
 //------------------------------------------------------------------------------
@@ -153,14 +177,24 @@ void UndoLog_DeleteEdge
 );
 
 // undo entity update
+// the entity's modified attributes are recorded by subsequent calls to
+// UndoLog_UpdateEntityAttribute
 void UndoLog_UpdateEntity
 (
 	UndoLog log,                 // undo log
 	GraphEntity *ge,             // updated entity
-	AttributeSet set,            // old attribute set
 	GraphEntityType entity_type  // entity type
 );
 
+// records the original value of an attribute modified by the
+// most recent entity update, the log takes ownership over 'original'
+void UndoLog_UpdateEntityAttribute
+(
+	UndoLog log,      // undo log
+	Attribute_ID id,  // modified attribute
+	SIValue original  // original value, NULL if attribute was added
+);
+
 // undo node add label
 void UndoLog_AddLabels
 (
@@ -63,6 +63,8 @@ Cache *Cache_New(uint cap, CacheEntryFreeFunc freeFunc, CacheEntryCopyFunc copyF
 	cache->size      = 0;
 	cache->lookup    = raxNew();       // Instantiate key entry mapping.
 	cache->counter   = 0;             // Initialize counter to zero.
+	cache->hits      = 0;
+	cache->misses    = 0;
 	cache->copy_item = copyFunc;
 	cache->free_item = freeFunc;
 	cache->arr = rm_calloc(cap, sizeof(CacheEntry)); // Array of cached values.
@@ -93,6 +95,7 @@ void *Cache_GetValue(Cache *cache, const char *key) {
 	// note that multiple threads can be here simultaneously
 	cache->counter++;
 	entry->LRU = cache->counter;
+	__atomic_fetch_add(&cache->hits, 1, __ATOMIC_RELAXED);
 
 	// return a copy of element
 	item = cache->copy_item(entry->value);
@@ -114,6 +117,9 @@ void Cache_SetValue(Cache *cache, const char *key, void *value) {
 	UNUSED(res);
 	ASSERT(res == 0);
 
+	// value was built following a failed lookup
+	__atomic_fetch_add(&cache->misses, 1, __ATOMIC_RELAXED);
+
 	// Insert the value to the cache.
 	_Cache_SetValue(cache, key, value, key_len);
 
@@ -133,6 +139,9 @@ void *Cache_SetGetValue(Cache *cache, const char *key, void *value) {
 	UNUSED(res);
 	ASSERT(res == 0);
 
+	// value was built following a failed lookup
+	__atomic_fetch_add(&cache->misses, 1, __ATOMIC_RELAXED);
+
 	// return true if value was added, false if value already in cache
 	if(_Cache_SetValue(cache, key, value, key_len)) {
 		// return a copy of original value
@@ -145,6 +154,15 @@ void *Cache_SetGetValue(Cache *cache, const char *key, void *value) {
 	return value_to_return;
 }
 
+void Cache_GetStats(const Cache *cache, uint64_t *hits, uint64_t *misses) {
+	ASSERT(hits != NULL);
+	ASSERT(cache != NULL);
+	ASSERT(misses != NULL);
+
+	*hits   = __atomic_load_n(&cache->hits, __ATOMIC_RELAXED);
+	*misses = __atomic_load_n(&cache->misses, __ATOMIC_RELAXED);
+}
+
 void Cache_Free(Cache *cache) {
 	ASSERT(cache != NULL);
 
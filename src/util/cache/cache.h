@@ -17,6 +17,8 @@ typedef struct Cache {
 	uint cap;                          // Cache capacity.
 	uint size;                         // Cache current size.
 	long long counter;                 // Atomic counter for number of reads.
+	uint64_t hits;                     // Number of lookups served from cache.
+	uint64_t misses;                   // Number of values built and stored.
 	rax *lookup;                       // Mapping between keys to entries, for fast lookups.
 	CacheEntry *arr;                   // Array of cache elements.
 	CacheEntryFreeFunc free_item;      // Callback function that free cached value.
@@ -60,6 +62,14 @@ void Cache_SetValue(Cache *cache, const char *key, void *item);
  */
 void *Cache_SetGetValue(Cache *cache, const char *key, void *value);
 
+/**
+ * @brief  Retrieves the cache's hit and miss counters.
+ * @param  *cache: cache pointer.
+ * @param  *hits: [output] number of lookups served from the cache.
+ * @param  *misses: [output] number of values stored after a failed lookup.
+ */
+void Cache_GetStats(const Cache *cache, uint64_t *hits, uint64_t *misses);
+
 /**
  * @brief  Destroys the cache and free all stored items.
  * @param  *cache: cache pointer
@@ -0,0 +1,56 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "compression.h"
+#include "../rmalloc.h"
+
+// GraphBLAS vendors LZ4 and renames its symbols
+// compile the same sources here to expose the LZ4_* API to the module
+#include "GraphBLAS/lz4/lz4.c"
+
+char *Compression_LZ4Compress
+(
+	const char *src,
+	size_t n,
+	size_t *compressed_size
+) {
+	ASSERT(src             != NULL);
+	ASSERT(compressed_size != NULL);
+
+	// LZ4 operates on blocks of up to LZ4_MAX_INPUT_SIZE bytes
+	if(n == 0 || n > LZ4_MAX_INPUT_SIZE) return NULL;
+
+	int  cap = LZ4_compressBound(n);
+	char *dst = rm_malloc(cap);
+
+	int size = LZ4_compress_default(src, dst, n, cap);
+
+	// discard output which doesn't save space
+	if(size <= 0 || (size_t)size >= n) {
+		rm_free(dst);
+		return NULL;
+	}
+
+	*compressed_size = size;
+	return rm_realloc(dst, size);
+}
+
+bool Compression_LZ4Decompress
+(
+	const char *src,
+	size_t n,
+	char *dst,
+	size_t dst_size
+) {
+	ASSERT(src != NULL);
+	ASSERT(dst != NULL);
+
+	if(n > LZ4_MAX_INPUT_SIZE || dst_size > LZ4_MAX_INPUT_SIZE) return false;
+
+	int size = LZ4_decompress_safe(src, dst, n, dst_size);
+	return size >= 0 && (size_t)size == dst_size;
+}
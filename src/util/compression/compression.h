@@ -0,0 +1,72 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// compression codecs
+// values are persisted, do not reorder
+typedef enum {
+	COMPRESSION_NONE = 0,  // uncompressed
+	COMPRESSION_LZ4  = 1,  // LZ4 block compression
+} CompressionCodec;
+
+// compresses 'n' bytes of 'src' using LZ4
+// returns a newly allocated buffer and sets 'compressed_size'
+// returns NULL if 'src' can't be compressed into fewer bytes
+char *Compression_LZ4Compress
+(
+	const char *src,         // data to compress
+	size_t n,                // size of data
+	size_t *compressed_size  // [output] size of compressed data
+);
+
+// decompresses 'n' bytes of 'src' into 'dst'
+// returns false if 'src' doesn't decompress into exactly 'dst_size' bytes
+bool Compression_LZ4Decompress
+(
+	const char *src,  // compressed data
+	size_t n,         // size of compressed data
+	char *dst,        // decompressed data
+	size_t dst_size   // size of decompressed data
+);
+
+// writes 'v' to stream as a variable length integer
+// 7 bits per byte, least significant group first
+static inline void Varint_Write
+(
+	FILE *stream,  // stream to write to
+	uint64_t v     // value to write
+) {
+	while(v >= 0x80) {
+		fputc((int)(v & 0x7F) | 0x80, stream);
+		v >>= 7;
+	}
+	fputc((int)v, stream);
+}
+
+// reads a variable length integer off of stream
+static inline uint64_t Varint_Read
+(
+	FILE *stream  // stream to read from
+) {
+	int      c;
+	uint64_t v     = 0;
+	uint32_t shift = 0;
+
+	do {
+		c = fgetc(stream);
+		if(c == EOF) break;
+		v |= (uint64_t)(c & 0x7F) << shift;
+		shift += 7;
+	} while(c & 0x80);
+
+	return v;
+}
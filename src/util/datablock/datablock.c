@@ -10,6 +10,7 @@
 #include "../arr.h"
 #include "../rmalloc.h"
 #include <math.h>
+#include <string.h>
 #include <stdbool.h>
 
 // computes the number of blocks required to accommodate n items.
@@ -259,6 +260,147 @@ void DataBlock_MarkAsDeletedOutOfOrder
 	array_append(dataBlock->deletedIdx, idx);
 }
 
+//------------------------------------------------------------------------------
+// Defragmentation
+//------------------------------------------------------------------------------
+
+bool DataBlock_Fragmented(const DataBlock *dataBlock) {
+	ASSERT(dataBlock != NULL);
+
+	uint n = array_len(dataBlock->deletedIdx);
+	for(uint i = 0; i < n; i++) {
+		if(dataBlock->deletedIdx[i] < dataBlock->itemCount) return true;
+	}
+
+	return false;
+}
+
+uint64_t DataBlock_TrailingItems
+(
+	const DataBlock *dataBlock,
+	uint64_t n,
+	uint64_t *idx
+) {
+	ASSERT(idx       != NULL);
+	ASSERT(dataBlock != NULL);
+
+	uint64_t count = 0;
+	uint64_t pos   = dataBlock->itemCount + array_len(dataBlock->deletedIdx);
+
+	// scan from the top of the datablock down to its item count
+	while(count < n && pos > dataBlock->itemCount) {
+		pos--;
+		DataBlockItemHeader *item_header = DataBlock_GetItemHeader(dataBlock, pos);
+		if(!IS_ITEM_DELETED(item_header)) idx[count++] = pos;
+	}
+
+	return count;
+}
+
+static int _cmp_uint64
+(
+	const void *a,
+	const void *b
+) {
+	uint64_t _a = *(const uint64_t *)a;
+	uint64_t _b = *(const uint64_t *)b;
+	return (_a > _b) - (_a < _b);
+}
+
+uint64_t DataBlock_Relocate
+(
+	DataBlock *dataBlock,
+	uint64_t from,
+	const uint64_t *src,
+	uint64_t *dst,
+	uint64_t n
+) {
+	ASSERT(src       != NULL);
+	ASSERT(dst       != NULL);
+	ASSERT(dataBlock != NULL);
+
+	uint64_t i   = 0;
+	uint64_t pos = from;
+	uint     sz  = dataBlock->itemSize - ITEM_HEADER_SIZE;
+
+	for(; i < n; i++) {
+		ASSERT(src[i] >= dataBlock->itemCount);
+
+		// locate next vacant position below item count
+		DataBlockItemHeader *dst_header = NULL;
+		for(; pos < dataBlock->itemCount; pos++) {
+			dst_header = DataBlock_GetItemHeader(dataBlock, pos);
+			if(IS_ITEM_DELETED(dst_header)) break;
+		}
+		if(pos >= dataBlock->itemCount) break;
+
+		DataBlockItemHeader *src_header =
+			DataBlock_GetItemHeader(dataBlock, src[i]);
+		ASSERT(!IS_ITEM_DELETED(src_header));
+
+		memcpy(ITEM_DATA(dst_header), ITEM_DATA(src_header), sz);
+		MARK_HEADER_AS_NOT_DELETED(dst_header);
+		MARK_HEADER_AS_DELETED(src_header);
+
+		dst[i] = pos++;
+	}
+
+	//--------------------------------------------------------------------------
+	// update deleted indices
+	//--------------------------------------------------------------------------
+
+	// each filled vacancy is replaced by the position it was filled from
+	// 'dst' is sorted, as vacancies are filled in ascending order
+	uint d = array_len(dataBlock->deletedIdx);
+	for(uint j = 0; j < d && i > 0; j++) {
+		uint64_t *match = bsearch(dataBlock->deletedIdx + j, dst, i,
+				sizeof(uint64_t), _cmp_uint64);
+		if(match != NULL) dataBlock->deletedIdx[j] = src[match - dst];
+	}
+
+	return i;
+}
+
+size_t DataBlock_MemoryUsage(const DataBlock *dataBlock) {
+	ASSERT(dataBlock != NULL);
+
+	size_t blockSize = sizeof(Block) + dataBlock->blockCap * dataBlock->itemSize;
+
+	return sizeof(DataBlock) +
+		dataBlock->blockCount * (sizeof(Block *) + blockSize) +
+		array_len(dataBlock->deletedIdx) * sizeof(uint64_t);
+}
+
+size_t DataBlock_Trim(DataBlock *dataBlock) {
+	ASSERT(dataBlock != NULL);
+	ASSERT(!DataBlock_Fragmented(dataBlock));
+
+	size_t reclaimed = array_len(dataBlock->deletedIdx) * sizeof(uint64_t);
+
+	// all vacancies reside beyond item count, forget them
+	array_free(dataBlock->deletedIdx);
+	dataBlock->deletedIdx = array_new(uint64_t, 128);
+
+	// keep at least a single block
+	uint blockCount = ITEM_COUNT_TO_BLOCK_COUNT(dataBlock->itemCount,
+			dataBlock->blockCap);
+	if(blockCount == 0) blockCount = 1;
+	if(blockCount >= dataBlock->blockCount) return reclaimed;
+
+	for(uint i = blockCount; i < dataBlock->blockCount; i++) {
+		Block_Free(dataBlock->blocks[i]);
+		reclaimed += sizeof(Block) + dataBlock->blockCap * dataBlock->itemSize;
+	}
+
+	dataBlock->blockCount = blockCount;
+	dataBlock->blocks = rm_realloc(dataBlock->blocks,
+			sizeof(Block *) * blockCount);
+	dataBlock->blocks[blockCount - 1]->next = NULL;
+	dataBlock->itemCap = blockCount * dataBlock->blockCap;
+
+	return reclaimed;
+}
+
 void DataBlock_Free(DataBlock *dataBlock) {
 	for(uint i = 0; i < dataBlock->blockCount; i++) Block_Free(dataBlock->blocks[i]);
 
@@ -100,6 +100,44 @@ uint DataBlock_DeletedItemsCount(const DataBlock *dataBlock);
 // Returns true if the given item has been deleted.
 bool DataBlock_ItemIsDeleted(void *item);
 
+//------------------------------------------------------------------------------
+// Defragmentation
+//------------------------------------------------------------------------------
+
+// returns true if the datablock has vacant positions below its item count
+// such vacancies can be filled by relocating items positioned beyond it
+bool DataBlock_Fragmented(const DataBlock *dataBlock);
+
+// collects up to 'n' live items positioned beyond the datablock's item count
+// in descending order, returns number of collected items
+uint64_t DataBlock_TrailingItems
+(
+	const DataBlock *dataBlock,  // datablock to inspect
+	uint64_t n,                  // max number of items to collect
+	uint64_t *idx                // [output] collected items positions
+);
+
+// relocates items 'src' into the datablock's vacant positions at or above
+// 'from' in ascending order, sources must be live items positioned beyond the
+// datablock's item count, items are moved as is, no destructor is invoked
+// returns number of relocated items, relocation stops once all vacancies
+// below the datablock's item count were filled
+uint64_t DataBlock_Relocate
+(
+	DataBlock *dataBlock,  // datablock to defragment
+	uint64_t from,         // lowest vacant position to fill
+	const uint64_t *src,   // items to relocate
+	uint64_t *dst,         // [output] items new positions
+	uint64_t n             // number of items to relocate
+);
+
+// returns number of bytes allocated by the datablock
+size_t DataBlock_MemoryUsage(const DataBlock *dataBlock);
+
+// releases the datablock's trailing blocks and deleted indices
+// datablock mustn't be fragmented, returns number of bytes released
+size_t DataBlock_Trim(DataBlock *dataBlock);
+
 // Free block.
 void DataBlock_Free(DataBlock *block);
 
@@ -19,6 +19,9 @@
 // actual allocated size from 'n_alloced' which can lead to negative values if
 // bytes requested < bytes allocated
 static __thread int64_t n_alloced;
+// [optional] counter shared by all threads executing the same query
+// when set, the thread's allocations are charged to it instead of 'n_alloced'
+static __thread int64_t *shared_n_alloced;
 static int64_t mem_capacity;  // maximum memory consumption for thread
 
 // function pointers which hold the original address of RedisModule_Alloc*
@@ -30,21 +33,64 @@ static void * (*RedisModule_Calloc_Orig)(size_t nmemb, size_t size);
 
 void rm_reset_n_alloced() {
 	n_alloced = 0;
+	shared_n_alloced = NULL;
+}
+
+void rm_attach_n_alloced(int64_t *counter) {
+	if(shared_n_alloced == counter) return;  // already attached
+
+	__atomic_add_fetch(counter, n_alloced, __ATOMIC_RELAXED);
+	n_alloced = 0;
+	shared_n_alloced = counter;
+}
+
+void rm_detach_n_alloced(void) {
+	if(shared_n_alloced == NULL) return;  // not attached
+
+	n_alloced = __atomic_load_n(shared_n_alloced, __ATOMIC_RELAXED);
+	shared_n_alloced = NULL;
+}
+
+// returns the memory consumed by the calling thread's query
+static inline int64_t _nmalloc_consumed(void) {
+	if(shared_n_alloced != NULL) {
+		return __atomic_load_n(shared_n_alloced, __ATOMIC_RELAXED);
+	}
+	return n_alloced;
+}
+
+bool rm_mem_pressure(double ratio) {
+	return (mem_capacity > 0 && _nmalloc_consumed() > mem_capacity * ratio);
 }
 
 // removes n_bytes from thread memory consumption
 static inline void _nmalloc_decrement(int64_t n_bytes) {
-	n_alloced -= n_bytes;
+	if(shared_n_alloced != NULL) {
+		__atomic_sub_fetch(shared_n_alloced, n_bytes, __ATOMIC_RELAXED);
+	} else {
+		n_alloced -= n_bytes;
+	}
 }
 
 // adds nbytes to thread memory consumption
 static inline void _nmalloc_increment(int64_t n_bytes) {
-	n_alloced += n_bytes;
+	int64_t consumed;
+	if(shared_n_alloced != NULL) {
+		consumed = __atomic_add_fetch(shared_n_alloced, n_bytes,
+				__ATOMIC_RELAXED);
+	} else {
+		consumed = (n_alloced += n_bytes);
+	}
+
 	// check if capacity exceeded
-	if(n_alloced > mem_capacity) {
-		// set n_alloced to MIN to avoid further out of memory exceptions
+	if(consumed > mem_capacity) {
+		// set counter to MIN to avoid further out of memory exceptions
 		// TODO: consider switching to double -inf
-		n_alloced = INT32_MIN;
+		if(shared_n_alloced != NULL) {
+			__atomic_store_n(shared_n_alloced, INT32_MIN, __ATOMIC_RELAXED);
+		} else {
+			n_alloced = INT32_MIN;
+		}
 
 		// throw exception cause memory limit exceeded
 		ErrorCtx_SetError(EMSG_QUERY_MEM_CONSUMPTION);
@@ -121,6 +167,16 @@ void rm_set_mem_capacity(int64_t cap) {
 void rm_reset_n_alloced() {
 }
 
+void rm_attach_n_alloced(int64_t *counter) {
+}
+
+void rm_detach_n_alloced(void) {
+}
+
+bool rm_mem_pressure(double ratio) {
+	return false;
+}
+
 void rm_set_mem_capacity(int64_t cap) {
 }
 
@@ -2,6 +2,7 @@
 #define __REDISGRAPH_ALLOC__
 
 #include <stdlib.h>
+#include <stdbool.h>
 #include <string.h>
 #include "../redismodule.h"
 
@@ -18,6 +19,20 @@ void rm_set_mem_capacity(int64_t cap);
 // reset thread memory consumption counter to 0 (no memory consumed)
 void rm_reset_n_alloced();
 
+// charge the calling thread's allocations to 'counter', which is shared by
+// all threads executing the same query, such that the memory capacity applies
+// to the query as a whole rather than to each of its threads
+// the thread's consumption so far is moved into 'counter'
+void rm_attach_n_alloced(int64_t *counter);
+
+// stop charging the calling thread's allocations to a shared counter
+// the thread's counter resumes from the shared counter's value
+void rm_detach_n_alloced(void);
+
+// returns true if the calling thread (or its query, when attached to a shared
+// counter) consumed more than `ratio` of its memory capacity, always false when memory is not capped
+bool rm_mem_pressure(double ratio);
+
 static inline void *rm_malloc(size_t n) {
 	return RedisModule_Alloc(n);
 }
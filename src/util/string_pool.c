@@ -0,0 +1,167 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "dict.h"
+#include "rmalloc.h"
+#include "string_pool.h"
+
+#include <string.h>
+#include <stddef.h>
+#include <pthread.h>
+
+// number of independently locked pool shards, must be a power of 2
+#define STRING_POOL_SHARD_COUNT 64
+
+// interned string, characters follow the header
+typedef struct {
+	uint64_t ref_count;  // number of references to string
+	uint16_t shard;      // shard holding the string
+	char str[];          // string
+} InternedString;
+
+#define INTERNED_STRING(s) \
+	((InternedString *)((char *)(s) - offsetof(InternedString, str)))
+
+// pool shard, strings are assigned to shards by their hash
+typedef struct {
+	dict *strings;         // interned strings
+	pthread_mutex_t lock;  // guards strings and ref count drops to 0
+} StringPoolShard;
+
+static StringPoolShard _shards[STRING_POOL_SHARD_COUNT];
+static pthread_once_t _init_once = PTHREAD_ONCE_INIT;
+
+static uint64_t _StringPool_Hash
+(
+	const void *key
+) {
+	return HashTableGenHashFunction(key, strlen(key));
+}
+
+static int _StringPool_KeyCompare
+(
+	dict *d,
+	const void *key1,
+	const void *key2
+) {
+	return strcmp(key1, key2) == 0;
+}
+
+// pool keys are the interned strings themselves, no values are stored
+static dictType _pool_dt = {_StringPool_Hash, NULL, NULL,
+	_StringPool_KeyCompare, NULL, NULL, NULL, NULL, NULL, NULL};
+
+static void _StringPool_Init(void) {
+	for(uint i = 0; i < STRING_POOL_SHARD_COUNT; i++) {
+		_shards[i].strings = HashTableCreate(&_pool_dt);
+		int res = pthread_mutex_init(&_shards[i].lock, NULL);
+		ASSERT(res == 0);
+		UNUSED(res);
+	}
+}
+
+char *StringPool_Intern
+(
+	const char *s
+) {
+	ASSERT(s != NULL);
+
+	size_t len = strlen(s);
+	if(len > STRING_POOL_MAX_LEN) return NULL;
+
+	// pool is created lazily
+	pthread_once(&_init_once, _StringPool_Init);
+
+	// the dict consumes the low bits of the hash, pick a shard by the high bits
+	uint64_t hash = HashTableGenHashFunction(s, len);
+	uint16_t shard_idx = (hash >> 32) & (STRING_POOL_SHARD_COUNT - 1);
+	StringPoolShard *shard = _shards + shard_idx;
+
+	pthread_mutex_lock(&shard->lock);
+
+	InternedString *entry;
+	dictEntry *de = HashTableFind(shard->strings, s);
+	if(de != NULL) {
+		entry = INTERNED_STRING(HashTableGetKey(de));
+		__atomic_fetch_add(&entry->ref_count, 1, __ATOMIC_RELAXED);
+	} else {
+		entry = rm_malloc(sizeof(InternedString) + len + 1);
+		entry->ref_count = 1;
+		entry->shard     = shard_idx;
+		memcpy(entry->str, s, len + 1);
+		HashTableAdd(shard->strings, entry->str, NULL);
+	}
+
+	pthread_mutex_unlock(&shard->lock);
+
+	return entry->str;
+}
+
+void StringPool_Retain
+(
+	char *s
+) {
+	ASSERT(s != NULL);
+
+	// the caller holds a reference, the string can't be freed concurrently
+	__atomic_fetch_add(&INTERNED_STRING(s)->ref_count, 1, __ATOMIC_RELAXED);
+}
+
+void StringPool_Release
+(
+	char *s
+) {
+	ASSERT(s != NULL);
+
+	InternedString *entry = INTERNED_STRING(s);
+
+	// drop a reference without locking as long as it isn't the last one
+	uint64_t n = __atomic_load_n(&entry->ref_count, __ATOMIC_RELAXED);
+	while(n > 1) {
+		if(__atomic_compare_exchange_n(&entry->ref_count, &n, n - 1, true,
+					__ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+			return;
+		}
+	}
+
+	// possibly the last reference, lookups must not revive the string
+	StringPoolShard *shard = _shards + entry->shard;
+	pthread_mutex_lock(&shard->lock);
+
+	ASSERT(__atomic_load_n(&entry->ref_count, __ATOMIC_RELAXED) > 0);
+	if(__atomic_sub_fetch(&entry->ref_count, 1, __ATOMIC_ACQ_REL) == 0) {
+		int res = HashTableDelete(shard->strings, s);
+		ASSERT(res == DICT_OK);
+		UNUSED(res);
+		rm_free(entry);
+	}
+
+	pthread_mutex_unlock(&shard->lock);
+}
+
+uint64_t StringPool_Size(void) {
+	pthread_once(&_init_once, _StringPool_Init);
+
+	uint64_t n = 0;
+	for(uint i = 0; i < STRING_POOL_SHARD_COUNT; i++) {
+		StringPoolShard *shard = _shards + i;
+		pthread_mutex_lock(&shard->lock);
+		n += HashTableElemCount(shard->strings);
+		pthread_mutex_unlock(&shard->lock);
+	}
+
+	return n;
+}
+
+uint64_t StringPool_RefCount
+(
+	const char *s
+) {
+	ASSERT(s != NULL);
+
+	return __atomic_load_n(&INTERNED_STRING(s)->ref_count, __ATOMIC_RELAXED);
+}
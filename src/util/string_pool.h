@@ -0,0 +1,64 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// strings longer than this are not interned
+#define STRING_POOL_MAX_LEN 128
+
+// string pool
+//
+// property values often repeat the same short strings
+// e.g. country, status, type
+// the pool keeps a single reference counted copy of each such string
+// which is shared by all attribute-sets holding it
+//
+// the pool is process wide and thread safe, an interned string is released
+// once its last reference is dropped
+// it is split into independently locked shards such that concurrent writers,
+// e.g. RDB decoding workers, rarely contend, references are taken and dropped
+// atomically, a lock is only acquired to intern or to drop a last reference
+//
+// interned strings are plain strings to their readers, equality, hashing
+// and RDB encoding operate on their characters
+// only the owner of a reference knows a string is interned (M_INTERN),
+// the copies handed to readers, e.g. by SI_ConstValue, are ordinary strings
+// as such comparisons and GROUP BY hashing can't rely on the pool's identity
+// beyond the pointer equality shortcut taken by SIValue_Compare
+// and the RDB encodes each value's characters rather than a dictionary
+
+// interns 's', returns the pool's copy of 's'
+// returns NULL if 's' is too long to be interned
+char *StringPool_Intern
+(
+	const char *s  // string to intern
+);
+
+// adds a reference to an interned string
+void StringPool_Retain
+(
+	char *s  // interned string
+);
+
+// drops a reference to an interned string
+// the string is freed once its last reference is dropped
+void StringPool_Release
+(
+	char *s  // interned string
+);
+
+// returns number of distinct strings in the pool
+uint64_t StringPool_Size(void);
+
+// returns number of references to an interned string
+uint64_t StringPool_RefCount
+(
+	const char *s  // interned string
+);
+
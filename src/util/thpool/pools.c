@@ -15,6 +15,7 @@
 
 static threadpool _readers_thpool = NULL;  // readers
 static threadpool _writers_thpool = NULL;  // writers
+static threadpool _indexers_thpool = NULL; // index population workers
 
 int ThreadPools_Init
 (
@@ -36,7 +37,7 @@ int ThreadPools_Init
 	return ThreadPools_CreatePools(reader_count, writer_count, max_queue_size);
 }
 
-// set up thread pools  (readers and writers)
+// set up thread pools (readers, writers and indexers)
 // returns 1 if thread pools initialized, 0 otherwise
 int ThreadPools_CreatePools
 (
@@ -44,8 +45,9 @@ int ThreadPools_CreatePools
 	uint writer_count,
 	uint64_t max_pending_work
 ) {
-	ASSERT(_readers_thpool == NULL);
-	ASSERT(_writers_thpool == NULL);
+	ASSERT(_readers_thpool  == NULL);
+	ASSERT(_writers_thpool  == NULL);
+	ASSERT(_indexers_thpool == NULL);
 
 	_readers_thpool = thpool_init(reader_count, "reader");
 	if(_readers_thpool == NULL) return 0;
@@ -53,6 +55,11 @@ int ThreadPools_CreatePools
 	_writers_thpool = thpool_init(writer_count, "writer");
 	if(_writers_thpool == NULL) return 0;
 
+	// index population is bounded by the number of readers
+	// shared by all populated indexes
+	_indexers_thpool = thpool_init(reader_count, "indexer");
+	if(_indexers_thpool == NULL) return 0;
+
 	ThreadPools_SetMaxPendingWork(max_pending_work);
 
 	return 1;
@@ -81,6 +88,14 @@ uint ThreadPools_ReadersCount
 	return thpool_num_threads(_readers_thpool);
 }
 
+uint ThreadPools_IndexersCount
+(
+	void
+) {
+	ASSERT(_indexers_thpool != NULL);
+	return thpool_num_threads(_indexers_thpool);
+}
+
 // retrieve current thread id
 // 0         redis-main
 // 1..N + 1  readers
@@ -165,6 +180,18 @@ int ThreadPools_AddWorkWriter
 	return thpool_add_work(_writers_thpool, function_p, arg_p);
 }
 
+// adds an index population task
+// index population tasks are never rejected
+int ThreadPools_AddWorkIndexer
+(
+	void (*function_p)(void *),
+	void *arg_p
+) {
+	ASSERT(_indexers_thpool != NULL);
+
+	return thpool_add_work(_indexers_thpool, function_p, arg_p);
+}
+
 void ThreadPools_SetMaxPendingWork(uint64_t val) {
 	if(_readers_thpool != NULL) thpool_set_jobqueue_cap(_readers_thpool, val);
 	if(_writers_thpool != NULL) thpool_set_jobqueue_cap(_writers_thpool, val);
@@ -210,10 +237,12 @@ void ThreadPools_Destroy
 (
 	void
 ) {
-	ASSERT(_readers_thpool != NULL);
-	ASSERT(_writers_thpool != NULL);
+	ASSERT(_readers_thpool  != NULL);
+	ASSERT(_writers_thpool  != NULL);
+	ASSERT(_indexers_thpool != NULL);
 
 	thpool_destroy(_readers_thpool);
 	thpool_destroy(_writers_thpool);
+	thpool_destroy(_indexers_thpool);
 }
 
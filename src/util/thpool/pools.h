@@ -17,7 +17,7 @@ int ThreadPools_Init
 	void
 );
 
-// create both readers and writers thread pools
+// create readers, writers and index population thread pools
 int ThreadPools_CreatePools
 (
 	uint reader_count,
@@ -31,6 +31,9 @@ uint ThreadPools_ThreadCount(void);
 // return size of READERS thread-pool
 uint ThreadPools_ReadersCount(void);
 
+// return size of INDEXERS thread-pool
+uint ThreadPools_IndexersCount(void);
+
 // retrieve current thread id
 // 0         redis-main
 // 1..N + 1  readers
@@ -59,6 +62,13 @@ int ThreadPools_AddWorkWriter
 	int force                    // true will add task even if internal queue is full
 );
 
+// add an index population task
+int ThreadPools_AddWorkIndexer
+(
+	void (*function_p)(void *),  // function to run
+	void *arg_p                  // function arguments
+);
+
 // sets the limit on max queued queries in each thread pool
 void ThreadPools_SetMaxPendingWork
 (
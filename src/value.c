@@ -15,6 +15,7 @@
 #include <ctype.h>
 #include <sys/param.h>
 #include "util/rmalloc.h"
+#include "util/string_pool.h"
 #include "datatypes/map.h"
 #include "datatypes/array.h"
 #include "datatypes/point.h"
@@ -124,7 +125,7 @@ SIValue SI_Point(float latitude, float longitude) {
 SIValue SI_ShareValue(const SIValue v) {
 	SIValue dup = v;
 	// If the original value owns an allocation, mark that the duplicate shares it.
-	if(v.allocation == M_SELF) dup.allocation = M_VOLATILE;
+	if(v.allocation & (M_SELF | M_INTERN)) dup.allocation = M_VOLATILE;
 	return dup;
 }
 
@@ -171,6 +172,25 @@ SIValue SI_CloneValue(const SIValue v) {
 	return clone;
 }
 
+// clone 'v', strings short enough are interned
+// repeated strings then share a single reference counted allocation
+SIValue SI_InternValue(const SIValue v) {
+	if(v.type != T_STRING) return SI_CloneValue(v);
+
+	// already interned, add a reference
+	if(v.allocation == M_INTERN) {
+		StringPool_Retain(v.stringval);
+		return v;
+	}
+
+	char *s = StringPool_Intern(v.stringval);
+	if(s == NULL) return SI_DuplicateStringVal(v.stringval);
+
+	return (SIValue) {
+		.stringval = s, .type = T_STRING, .allocation = M_INTERN
+	};
+}
+
 SIValue SI_ShallowCloneValue(const SIValue v) {
 	if(v.allocation == M_CONST || v.allocation == M_NONE) return v;
 	return SI_CloneValue(v);
@@ -187,7 +207,7 @@ SIValue SI_ConstValue(const SIValue *v) {
 // Clone 'v' and set v's allocation to volatile if 'v' owned the memory
 SIValue SI_TransferOwnership(SIValue *v) {
 	SIValue dup = *v;
-	if(v->allocation == M_SELF) v->allocation = M_VOLATILE;
+	if(v->allocation & (M_SELF | M_INTERN)) v->allocation = M_VOLATILE;
 	return dup;
 }
 
@@ -195,7 +215,7 @@ SIValue SI_TransferOwnership(SIValue *v) {
  * with no responsibility for freeing or guarantee regarding scope.
  * This is used in cases like performing shallow copies of scalars in Record entries. */
 void SIValue_MakeVolatile(SIValue *v) {
-	if(v->allocation == M_SELF) v->allocation = M_VOLATILE;
+	if(v->allocation & (M_SELF | M_INTERN)) v->allocation = M_VOLATILE;
 }
 
 /* Ensure that any allocation held by the given SIValue is guaranteed to not go out
@@ -208,6 +228,19 @@ void SIValue_Persist(SIValue *v) {
 	if(v->allocation == M_VOLATILE) *v = SI_CloneValue(*v);
 }
 
+// replace an owned string with its interned copy
+// values which can't be interned are left as is
+void SIValue_Intern(SIValue *v) {
+	if(v->type != T_STRING || v->allocation != M_SELF) return;
+
+	char *s = StringPool_Intern(v->stringval);
+	if(s == NULL) return;
+
+	rm_free(v->stringval);
+	v->stringval  = s;
+	v->allocation = M_INTERN;
+}
+
 /* Update an SIValue's allocation type to the provided value. */
 inline void SIValue_SetAllocationType(SIValue *v, SIAllocation allocation) {
 	v->allocation = allocation;
@@ -597,6 +630,8 @@ int SIValue_Compare(const SIValue a, const SIValue b, int *disjointOrNull) {
 
 			return SAFE_COMPARISON_RESULT(a.doubleval - b.doubleval);
 		case T_STRING:
+			// interned strings sharing an allocation are equal
+			if(a.stringval == b.stringval) return 0;
 			return strcmp(a.stringval, b.stringval);
 		case T_NODE:
 		case T_EDGE:
@@ -616,6 +651,13 @@ int SIValue_Compare(const SIValue a, const SIValue b, int *disjointOrNull) {
 				return SAFE_COMPARISON_RESULT(Point_lat(a) - Point_lat(b));
 			return lon_diff;
 		}
+		case T_DATETIME:
+		case T_LOCALDATETIME:
+		case T_DATE:
+		case T_TIME:
+		case T_LOCALTIME:
+		case T_DURATION:
+			return SAFE_COMPARISON_RESULT(a.longval - b.longval);
 		default:
 			// Both inputs were of an incomparable type, like a pointer, or not implemented comparison yet.
 			ASSERT(false);
@@ -740,7 +782,27 @@ void SIValue_HashUpdate(SIValue v, XXH64_state_t *state) {
 			inner_hash = SIPath_HashCode(v);
 			XXH64_update(state, &inner_hash, sizeof(inner_hash));
 			return;
-			// TODO: Implement for temporal types once we support them.
+		case T_POINT:
+		{
+			XXH64_update(state, &t, sizeof(t));
+			// normalize -0.0 to 0.0, both compare equal
+			float lat = Point_lat(v) + 0.0f;
+			float lon = Point_lon(v) + 0.0f;
+			XXH64_update(state, &lat, sizeof(lat));
+			XXH64_update(state, &lon, sizeof(lon));
+			return;
+		}
+		case T_DATETIME:
+		case T_LOCALDATETIME:
+		case T_DATE:
+		case T_TIME:
+		case T_LOCALTIME:
+		case T_DURATION:
+			// temporal values are held in longval
+			// values of different temporal types are never equal
+			XXH64_update(state, &t, sizeof(t));
+			XXH64_update(state, &v.longval, sizeof(v.longval));
+			return;
 		default:
 			ASSERT(false);
 			break;
@@ -762,6 +824,51 @@ XXH64_hash_t SIValue_HashCode(SIValue v) {
 	return XXH64_digest(&state);
 }
 
+// writes a binary representation of v into stream
+// this is the reverse of SIValue_FromBinary
+void SIValue_ToBinary
+(
+	FILE *stream,     // stream to write value to
+	const SIValue *v  // value to write
+) {
+	ASSERT(v      != NULL);
+	ASSERT(stream != NULL);
+
+	// format:
+	//    type
+	//    value
+	bool b;
+	SIType t = v->type;
+
+	fwrite_assert(&t, sizeof(SIType), stream);
+	switch(t) {
+		case T_POINT:
+			fwrite_assert(&v->point, sizeof(v->point), stream);
+			break;
+		case T_ARRAY:
+			SIArray_ToBinary(stream, v);
+			break;
+		case T_STRING:
+			fwrite_string(v->stringval, stream);
+			break;
+		case T_BOOL:
+			b = SIValue_IsTrue(*v);
+			fwrite_assert(&b, sizeof(b), stream);
+			break;
+		case T_INT64:
+			fwrite_assert(&v->longval, sizeof(v->longval), stream);
+			break;
+		case T_DOUBLE:
+			fwrite_assert(&v->doubleval, sizeof(v->doubleval), stream);
+			break;
+		case T_NULL:
+			// no additional data is required to represent NULL
+			break;
+		default:
+			assert(false && "unknown SIValue type");
+	}
+}
+
 // reads SIValue off of binary stream
 SIValue SIValue_FromBinary
 (
@@ -826,6 +933,12 @@ SIValue SIValue_FromBinary
 }
 			
 void SIValue_Free(SIValue v) {
+	// drop reference to interned string
+	if(v.allocation == M_INTERN) {
+		StringPool_Release(v.stringval);
+		return;
+	}
+
 	// The free routine only performs work if it owns a heap allocation.
 	if(v.allocation != M_SELF) return;
 
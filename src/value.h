@@ -44,7 +44,8 @@ typedef enum {
 	M_NONE = 0,             // SIValue is not heap-allocated
 	M_SELF = (1 << 0),      // SIValue is responsible for freeing its reference
 	M_VOLATILE = (1 << 1),  // SIValue does not own its reference and may go out of scope
-	M_CONST = (1 << 2)      // SIValue does not own its allocation, but its access is safe
+	M_CONST = (1 << 2),     // SIValue does not own its allocation, but its access is safe
+	M_INTERN = (1 << 3)     // SIValue holds a reference to an interned string
 } SIAllocation;
 
 #define SI_TYPE(value) (value).type
@@ -132,6 +133,9 @@ SIValue SI_ShareValue(const SIValue v);
 // SI_CloneValue creates an SIValue that duplicates all of the original's allocations.
 SIValue SI_CloneValue(const SIValue v);
 
+// SI_InternValue clones 'v', short strings are interned rather than duplicated.
+SIValue SI_InternValue(const SIValue v);
+
 // SI_CloneValue creates an SIValue that duplicates all of the original's self-owned or volatile allocations.
 SIValue SI_ShallowCloneValue(const SIValue v);
 
@@ -146,6 +150,9 @@ SIValue SI_TransferOwnership(SIValue *v);
 // SIValue_MakeVolatile updates an SIValue to mark that its allocations are shared rather than self-owned.
 void SIValue_MakeVolatile(SIValue *v);
 
+// SIValue_Intern replaces an owned string with its interned copy, releasing the original.
+void SIValue_Intern(SIValue *v);
+
 // SIValue_Persist updates an SIValue to duplicate any allocations that may go out of scope in the lifetime of this query.
 void SIValue_Persist(SIValue *v);
 
@@ -207,6 +214,14 @@ void SIValue_HashUpdate(SIValue v, XXH64_state_t *state);
 /* Returns a hash code for a given SIValue. */
 XXH64_hash_t SIValue_HashCode(SIValue v);
 
+// writes a binary representation of v into stream
+// this is the reverse of SIValue_FromBinary
+void SIValue_ToBinary
+(
+	FILE *stream,     // stream to write value to
+	const SIValue *v  // value to write
+);
+
 // reads SIValue off of binary stream
 SIValue SIValue_FromBinary
 (
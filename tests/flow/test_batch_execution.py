@@ -0,0 +1,72 @@
+from common import *
+
+GRAPH_ID = "batch_execution"
+
+# number of nodes created, spans multiple record batches
+NODE_COUNT = 3000
+
+
+class testBatchExecution(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        self.conn = self.env.getConnection()
+        self.graph = Graph(self.conn, GRAPH_ID)
+        self.populate_graph()
+
+    def populate_graph(self):
+        q = f"""UNWIND range(0, {NODE_COUNT - 1}) AS x
+                CREATE (:L {{v: x, s: toString(x)}})-[:R]->(:M {{v: x}})"""
+        self.graph.query(q)
+
+    def test01_filter_project(self):
+        # filter and project records across batch boundaries
+        q = """MATCH (a:L) WHERE a.v % 3 = 0
+               RETURN a.v * 2 AS x, a.s + '!' AS s ORDER BY x"""
+        res = self.graph.query(q).result_set
+        expected = [[v * 2, str(v) + '!'] for v in range(0, NODE_COUNT, 3)]
+        self.env.assertEquals(res, expected)
+
+        # filter discarding entire batches
+        q = f"MATCH (a:L) WHERE a.v = {NODE_COUNT - 1} RETURN a.v"
+        res = self.graph.query(q).result_set
+        self.env.assertEquals(res, [[NODE_COUNT - 1]])
+
+    def test02_traverse(self):
+        # scalars produced below a traversal outlive their batch
+        q = """MATCH (a:L) WITH a, toUpper(a.s) AS s
+               MATCH (a)-[:R]->(b) RETURN s, b.v ORDER BY b.v"""
+        res = self.graph.query(q).result_set
+        expected = [[str(v), v] for v in range(NODE_COUNT)]
+        self.env.assertEquals(res, expected)
+
+        q = "MATCH (a:L)-[:R]->(b:M) WHERE b.v >= 1000 RETURN count(b)"
+        res = self.graph.query(q).result_set
+        self.env.assertEquals(res, [[NODE_COUNT - 1000]])
+
+    def test03_resultset_size_limit(self):
+        self.conn.execute_command("GRAPH.CONFIG", "SET", "RESULTSET_SIZE", 1500)
+        try:
+            res = self.graph.query("MATCH (a:L) RETURN a.v").result_set
+            self.env.assertEquals(len(res), 1500)
+        finally:
+            self.conn.execute_command("GRAPH.CONFIG", "SET", "RESULTSET_SIZE", -1)
+
+    def test04_profile(self):
+        # profiled operations report exact record counts
+        q = "MATCH (a:L) WHERE a.v < 2000 RETURN a.v"
+        profile = self.conn.execute_command("GRAPH.PROFILE", GRAPH_ID, q)
+        profile = [x[0:x.index(',')].strip() for x in profile]
+        self.env.assertIn("Results | Records produced: 2000", profile)
+        self.env.assertIn("Filter | Records produced: 2000", profile)
+        self.env.assertIn(f"Node By Label Scan | (a:L) | Records produced: {NODE_COUNT}", profile)
+
+    def test05_traverse_multi_edges(self):
+        # parallel edges between a pair are emitted across batch boundaries
+        q = """MATCH (a:L)-[:R]->(b:M) WHERE a.v < 1500
+               CREATE (a)-[:P {v: a.v}]->(b), (a)-[:P {v: -a.v}]->(b)"""
+        self.graph.query(q)
+
+        q = """MATCH (a:L)-[e:P]->(b:M)
+               RETURN count(e), count(DISTINCT e), sum(abs(e.v) - a.v)"""
+        res = self.graph.query(q).result_set
+        self.env.assertEquals(res, [[3000, 3000, 0]])
@@ -2,6 +2,8 @@
 from common import *
 import csv
 import time
+import struct
+import tempfile
 import threading
 from click.testing import CliRunner
 from redisgraph_bulk_loader.bulk_insert import bulk_insert
@@ -9,6 +11,8 @@ from redisgraph_bulk_loader.bulk_insert import bulk_insert
 redis_con = None
 port = None
 redis_graph = None
+# directory GRAPH.BULK LOAD is allowed to read from
+bulk_load_root = tempfile.mkdtemp()
 
 
 def run_bulk_loader(graphname, filename):
@@ -19,7 +23,8 @@ def run_bulk_loader(graphname, filename):
 
 class testGraphBulkInsertFlow(FlowTestsBase):
     def __init__(self):
-        self.env = Env(decodeResponses=True)
+        self.env = Env(decodeResponses=True,
+                       moduleArgs='BULK_LOAD_ROOT %s' % bulk_load_root)
 
         # skip test if we're running under Valgrind
         if VALGRIND:
@@ -715,3 +720,158 @@ class testGraphBulkInsertFlow(FlowTestsBase):
             query_result = graph.query(q)
             self.env.assertEquals(query_result.result_set, expected_result)
 
+
+    def test12_load_local_files(self):
+        graphname = "bulk_load"
+
+        def node_blob(label, names):
+            blob = label.encode() + b'\0' + struct.pack('<I', 2) + b'name\0v\0'
+            for i, name in enumerate(names):
+                blob += b'\x03' + name.encode() + b'\0'
+                blob += b'\x04' + struct.pack('<q', i)
+            return blob
+
+        def edge_blob(relation, edges):
+            blob = relation.encode() + b'\0' + struct.pack('<I', 1) + b'v\0'
+            for src, dest, v in edges:
+                blob += struct.pack('<QQ', src, dest)
+                blob += b'\x04' + struct.pack('<q', v)
+            return blob
+
+        def section(t, blob):
+            return struct.pack('<BQ', t, len(blob)) + blob
+
+        with tempfile.TemporaryDirectory(dir=bulk_load_root) as path:
+            # files are loaded by name order, node sections precede
+            # edge sections regardless of the file they reside in
+            with open(os.path.join(path, '01.bin'), 'wb') as f:
+                f.write(section(1, edge_blob('KNOWS', [(0, 1, 10), (0, 1, 20),
+                                                       (1, 2, 30), (3, 0, 40)])))
+                f.write(section(0, node_blob('City', ['Tel-Aviv'])))
+            with open(os.path.join(path, '00.bin'), 'wb') as f:
+                f.write(section(0, node_blob('Person', ['Alice', 'Bob', 'Carol'])))
+
+            res = redis_con.execute_command("GRAPH.BULK", graphname, "LOAD", path)
+            self.env.assertEquals(res, "4 nodes created, 4 edges created")
+
+            # loading into an existing graph fails
+            try:
+                redis_con.execute_command("GRAPH.BULK", graphname, "LOAD", path)
+                self.env.assertTrue(False)
+            except redis.exceptions.ResponseError as e:
+                self.env.assertIn("already exists", str(e))
+
+            # edges must refer to loaded nodes
+            bad = os.path.join(path, 'bad.bin')
+            with open(bad, 'wb') as f:
+                f.write(section(0, node_blob('Person', ['Dave'])))
+                f.write(section(1, edge_blob('KNOWS', [(0, 5, 0)])))
+            try:
+                redis_con.execute_command("GRAPH.BULK", "bulk_load_bad", "LOAD", bad)
+                self.env.assertTrue(False)
+            except redis.exceptions.ResponseError as e:
+                self.env.assertIn("missing node", str(e))
+            self.env.assertEquals(redis_con.exists("bulk_load_bad"), 0)
+
+            # loading blocks the client, which is not allowed within MULTI
+            pipe = redis_con.pipeline(transaction=True)
+            pipe.execute_command("GRAPH.BULK", "bulk_load_multi", "LOAD", path)
+            res = pipe.execute(raise_on_error=False)
+            self.env.assertIn("MULTI", str(res[0]))
+            self.env.assertEquals(redis_con.exists("bulk_load_multi"), 0)
+
+            # a single file can be loaded
+            single = os.path.join(path, 'single.bin')
+            with open(single, 'wb') as f:
+                f.write(section(0, node_blob('Person', ['Eve'])))
+            res = redis_con.execute_command("GRAPH.BULK", "bulk_load_single", "LOAD", single)
+            self.env.assertEquals(res, "1 nodes created, 0 edges created")
+
+            # paths are relative to the bulk load root
+            res = redis_con.execute_command("GRAPH.BULK", "bulk_load_relative", "LOAD",
+                                            os.path.relpath(single, bulk_load_root))
+            self.env.assertEquals(res, "1 nodes created, 0 edges created")
+
+        # paths resolving outside of the bulk load root are rejected
+        with tempfile.TemporaryDirectory() as outside:
+            target = os.path.join(outside, 'outside.bin')
+            with open(target, 'wb') as f:
+                f.write(section(0, node_blob('Person', ['Mallory'])))
+
+            link = os.path.join(bulk_load_root, 'link.bin')
+            os.symlink(target, link)
+
+            paths = [outside, target, link,
+                     os.path.join(bulk_load_root, '..'),
+                     os.path.join(bulk_load_root, '..', os.path.basename(outside))]
+            for p in paths:
+                try:
+                    redis_con.execute_command("GRAPH.BULK", "bulk_load_outside", "LOAD", p)
+                    self.env.assertTrue(False)
+                except redis.exceptions.ResponseError as e:
+                    self.env.assertIn("BULK_LOAD_ROOT", str(e))
+                self.env.assertEquals(redis_con.exists("bulk_load_outside"), 0)
+
+            # links within a loaded directory are skipped
+            with tempfile.TemporaryDirectory(dir=bulk_load_root) as path:
+                os.symlink(target, os.path.join(path, 'link.bin'))
+                try:
+                    redis_con.execute_command("GRAPH.BULK", "bulk_load_outside", "LOAD", path)
+                    self.env.assertTrue(False)
+                except redis.exceptions.ResponseError as e:
+                    self.env.assertIn("no files to load", str(e))
+
+            os.remove(link)
+
+        graph = Graph(redis_con, graphname)
+        query_result = graph.query("MATCH (n) RETURN ID(n), labels(n), n.name ORDER BY ID(n)")
+        expected_result = [[0, ['Person'], 'Alice'],
+                           [1, ['Person'], 'Bob'],
+                           [2, ['Person'], 'Carol'],
+                           [3, ['City'], 'Tel-Aviv']]
+        self.env.assertEquals(query_result.result_set, expected_result)
+
+        query_result = graph.query("MATCH (a)-[e:KNOWS]->(b) RETURN a.name, e.v, b.name ORDER BY e.v")
+        expected_result = [['Alice', 10, 'Bob'],
+                           ['Alice', 20, 'Bob'],
+                           ['Bob', 30, 'Carol'],
+                           ['Tel-Aviv', 40, 'Alice']]
+        self.env.assertEquals(query_result.result_set, expected_result)
+
+    def test13_malformed_blobs(self):
+        graphname = "bulk_malformed"
+
+        header = b'Person\0' + struct.pack('<I', 1) + b'name\0'
+        blobs = [
+            # unterminated label
+            b'Person',
+            # property count exceeds blob
+            b'Person\0' + struct.pack('<I', 1000),
+            # truncated integer value
+            header + b'\x04' + struct.pack('<q', 1)[:4],
+            # unterminated string value
+            header + b'\x03Alice',
+            # unknown value type
+            header + b'\x09',
+            # array length exceeds blob
+            header + b'\x05' + struct.pack('<q', 1 << 40),
+        ]
+
+        for blob in blobs:
+            try:
+                redis_con.execute_command("GRAPH.BULK", graphname, "BEGIN", 1,
+                                          0, 1, 0, blob)
+                self.env.assertTrue(False)
+            except redis.exceptions.ResponseError as e:
+                self.env.assertIn("Bulk insert format error", str(e))
+            self.env.assertEquals(redis_con.exists(graphname), 0)
+
+        # truncated edge endpoints
+        blob = b'KNOWS\0' + struct.pack('<I', 0) + struct.pack('<Q', 0)
+        try:
+            redis_con.execute_command("GRAPH.BULK", graphname, "BEGIN", 0, 1,
+                                      0, 1, blob)
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertIn("Bulk insert format error", str(e))
+        self.env.assertEquals(redis_con.exists(graphname), 0)
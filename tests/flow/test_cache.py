@@ -245,7 +245,135 @@ class testCache():
         self.env.assertEqual(expected_result, cached_result.result_set)
         self.env.assertTrue(cached_result.cached_execution)
 
-    def test_14_cache_eviction(self):
+    def test_14_literal_parameterization(self):
+        # queries differing only by their literals share a cached plan
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "PARAMETERIZE_LITERALS", "yes")
+        try:
+            graph = Graph(redis_con, 'Cache_Test_Literals')
+            graph.query("UNWIND range(0, 9) AS x CREATE (:N {id: x, name: 'n' + toString(x)})")
+
+            def cache_stats():
+                res = redis_con.execute_command("GRAPH.INFO", "Cache")
+                stats = res[1]
+                return stats[1], stats[3]
+
+            hits, misses = cache_stats()
+
+            q = "MATCH (n:N {id: %d}) WHERE n.name <> 'x' RETURN n.name AS name"
+            result = graph.query(q % 1)
+            self.env.assertFalse(result.cached_execution)
+            self.env.assertEqual([['n1']], result.result_set)
+
+            for i in range(2, 6):
+                result = graph.query(q % i)
+                self.env.assertTrue(result.cached_execution)
+                self.env.assertEqual([['n%d' % i]], result.result_set)
+
+            # negative and string literals
+            result = graph.query("MATCH (n:N) WHERE n.id > -1 AND n.name = 'n7' RETURN n.id AS id")
+            self.env.assertFalse(result.cached_execution)
+            self.env.assertEqual([[7]], result.result_set)
+            result = graph.query("MATCH (n:N) WHERE n.id > -5 AND n.name = 'n3' RETURN n.id AS id")
+            self.env.assertTrue(result.cached_execution)
+            self.env.assertEqual([[3]], result.result_set)
+
+            # literals naming a column are not parameterized
+            result = graph.query("MATCH (n:N {id: 2}) RETURN n.id + 1")
+            self.env.assertEqual(['n.id + 1'], [c[1] for c in result.header])
+            self.env.assertEqual([[3]], result.result_set)
+            result = graph.query("MATCH (n:N {id: 2}) RETURN n.id + 2")
+            self.env.assertFalse(result.cached_execution)
+            self.env.assertEqual([[4]], result.result_set)
+
+            # variable length bounds are not parameterized
+            result = graph.query("MATCH (a)-[*1..2]->(b) RETURN count(b) AS c")
+            self.env.assertFalse(result.cached_execution)
+            result = graph.query("MATCH (a)-[*2..3]->(b) RETURN count(b) AS c")
+            self.env.assertFalse(result.cached_execution)
+
+            # skip and limit
+            q = "MATCH (n:N) RETURN n.id AS id ORDER BY n.id SKIP %d LIMIT %d"
+            result = graph.query(q % (1, 2))
+            self.env.assertEqual([[1], [2]], result.result_set)
+            result = graph.query(q % (5, 3))
+            self.env.assertTrue(result.cached_execution)
+            self.env.assertEqual([[5], [6], [7]], result.result_set)
+
+            # user parameters mixed with literals
+            q = "MATCH (n:N) WHERE n.id >= $min AND n.id < %d RETURN count(n) AS c"
+            result = graph.query(q % 5, {'min': 1})
+            self.env.assertEqual([[4]], result.result_set)
+            result = graph.query(q % 8, {'min': 6})
+            self.env.assertTrue(result.cached_execution)
+            self.env.assertEqual([[2]], result.result_set)
+
+            new_hits, new_misses = cache_stats()
+            self.env.assertEqual(new_hits - hits, 7)
+            self.env.assertEqual(new_misses - misses, 8)
+            graph.delete()
+        finally:
+            redis_con.execute_command("GRAPH.CONFIG", "SET", "PARAMETERIZE_LITERALS", "no")
+
+    def test_15_literal_parameterization_expression_names(self):
+        # expressions are named after the normalized query text
+        # which must outlive the query that cached the plan
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "PARAMETERIZE_LITERALS", "yes")
+        try:
+            graph = Graph(redis_con, 'Cache_Test_Literals_Names')
+            graph.query("UNWIND range(0, 9) AS x CREATE (:N {id: x})-[:R]->(:M {id: x * 10})")
+
+            q = """MATCH (n:N) WHERE n.id > %d
+                   RETURN n.id AS id, [(n)-[:R]->(m) WHERE m.id > %d | m.id + 1] AS ms
+                   ORDER BY id DESC LIMIT 2"""
+
+            result = graph.query(q % (5, 0))
+            self.env.assertFalse(result.cached_execution)
+            self.env.assertEqual(['id', 'ms'], [c[1] for c in result.header])
+            self.env.assertEqual([[9, [91]], [8, [81]]], result.result_set)
+
+            # a query with literals of a different length is served by the same
+            # plan, its expressions are resolved against the normalized query
+            result = graph.query(q % (123456, 12345))
+            self.env.assertTrue(result.cached_execution)
+            self.env.assertEqual([], result.result_set)
+
+            result = graph.query(q % (0, 75))
+            self.env.assertTrue(result.cached_execution)
+            self.env.assertEqual(['id', 'ms'], [c[1] for c in result.header])
+            self.env.assertEqual([[9, [91]], [8, [81]]], result.result_set)
+
+            result = graph.query(q % (7, 85))
+            self.env.assertTrue(result.cached_execution)
+            self.env.assertEqual([[9, [91]], [8, []]], result.result_set)
+
+            graph.delete()
+        finally:
+            redis_con.execute_command("GRAPH.CONFIG", "SET", "PARAMETERIZE_LITERALS", "no")
+
+    def test_16_literal_parameterization_explain(self):
+        # EXPLAIN reports the plan of the query as given
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "PARAMETERIZE_LITERALS", "yes")
+        try:
+            graph = Graph(redis_con, 'Cache_Test_Literals_Explain')
+            graph.query("UNWIND range(0, 9) AS x CREATE (:N {id: x})")
+
+            q = "MATCH (a:N), (b:N) WHERE a.id = b.id + 1 RETURN a.id AS a, b.id AS b"
+            plan = graph.execution_plan(q)
+            self.env.assertIn("Value Hash Join", plan)
+            self.env.assertNotIn("__lit_", plan)
+
+            # the lifted form of the query is unaffected
+            result = graph.query("MATCH (a:N), (b:N) WHERE a.id = b.id + 9 RETURN a.id AS a, b.id AS b")
+            self.env.assertFalse(result.cached_execution)
+            self.env.assertEqual([[9, 0]], result.result_set)
+            plan = graph.execution_plan(q)
+            self.env.assertNotIn("__lit_", plan)
+
+            graph.delete()
+        finally:
+            redis_con.execute_command("GRAPH.CONFIG", "SET", "PARAMETERIZE_LITERALS", "no")
+
+    def test_17_cache_eviction(self):
         # this tests spawns a new graph env` with a query-cache with just
         # a single slot, then multiple clients are issuing a similar query
         # only with a small variation to cause a cache miss which implies
@@ -0,0 +1,173 @@
+from common import *
+
+GRAPH_ID = "columnar_store"
+
+
+class testColumnarStore(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True, moduleArgs='COLUMNAR_STORE yes')
+        self.conn = self.env.getConnection()
+        self.graph = Graph(self.conn, GRAPH_ID)
+        self.populate_graph()
+
+    def populate_graph(self):
+        # every third person is missing an age
+        q = """UNWIND range(0, 99) AS x
+               CREATE (:Person {id: x, age: CASE WHEN x % 3 = 0 THEN NULL ELSE x END,
+                                score: toFloat(x) / 2, active: x % 2 = 0})"""
+        self.graph.query(q)
+
+    def test01_aggregate(self):
+        ages = [x for x in range(100) if x % 3 != 0]
+        q = "MATCH (p:Person) RETURN count(p.age), sum(p.age), min(p.age), max(p.age)"
+        res = self.graph.query(q).result_set
+        self.env.assertEquals(res, [[len(ages), sum(ages), min(ages), max(ages)]])
+
+        q = "MATCH (p:Person) RETURN sum(p.score)"
+        res = self.graph.query(q).result_set
+        self.env.assertEquals(res, [[sum(x / 2 for x in range(100))]])
+
+    def test02_filter_and_project(self):
+        q = """MATCH (p:Person) WHERE p.age > 90 AND p.active
+               RETURN p.id, p.age, p.score ORDER BY p.id"""
+        res = self.graph.query(q).result_set
+        expected = [[x, x, x / 2] for x in range(91, 100)
+                    if x % 3 != 0 and x % 2 == 0]
+        self.env.assertEquals(res, expected)
+
+        # missing attributes evaluate to null
+        q = "MATCH (p:Person) WHERE p.age IS NULL RETURN count(p)"
+        res = self.graph.query(q).result_set
+        self.env.assertEquals(res, [[34]])
+
+        q = "MATCH (p:Person) WHERE p.id < 3 RETURN p.age ORDER BY p.id"
+        res = self.graph.query(q).result_set
+        self.env.assertEquals(res, [[None], [1], [2]])
+
+    def test03_mixed_types(self):
+        # values which differ from the column's type are still reported
+        self.graph.query("CREATE (:Person {id: 100, age: 'unknown'})")
+
+        q = "MATCH (p:Person) WHERE p.id >= 98 RETURN p.age ORDER BY p.id"
+        res = self.graph.query(q).result_set
+        self.env.assertEquals(res, [[98], [None], ['unknown']])
+
+        self.graph.query("MATCH (p:Person {id: 100}) DELETE p")
+
+    def test04_modifications(self):
+        q = "MATCH (p:Person) RETURN sum(p.id)"
+        res = self.graph.query(q).result_set
+        self.env.assertEquals(res, [[sum(range(100))]])
+
+        # columns reflect committed modifications
+        self.graph.query("MATCH (p:Person) WHERE p.id < 10 SET p.id = p.id + 1000")
+        res = self.graph.query(q).result_set
+        self.env.assertEquals(res, [[sum(range(100)) + 10 * 1000]])
+
+        self.graph.query("MATCH (p:Person) WHERE p.id >= 1000 DELETE p")
+        res = self.graph.query(q).result_set
+        self.env.assertEquals(res, [[sum(range(10, 100))]])
+
+        self.graph.query("CREATE (:Person {id: 5000})")
+        res = self.graph.query(q).result_set
+        self.env.assertEquals(res, [[sum(range(10, 100)) + 5000]])
+
+        # reads following a write within the same query
+        q = """MATCH (p:Person {id: 5000}) SET p.id = 6000
+               WITH 1 AS x
+               MATCH (p:Person) RETURN sum(p.id)"""
+        res = self.graph.query(q).result_set
+        self.env.assertEquals(res, [[sum(range(10, 100)) + 6000]])
+
+    def test05_toggle(self):
+        q = "MATCH (p:Person) WHERE p.id < 50 RETURN sum(p.id)"
+        expected = self.graph.query(q).result_set
+
+        self.conn.execute_command("GRAPH.CONFIG", "SET", "COLUMNAR_STORE", "no")
+        res = self.graph.query(q).result_set
+        self.env.assertEquals(res, expected)
+
+        self.conn.execute_command("GRAPH.CONFIG", "SET", "COLUMNAR_STORE", "yes")
+        res = self.graph.query(q).result_set
+        self.env.assertEquals(res, expected)
+
+    def test06_memory_report(self):
+        q = "MATCH (p:Person) RETURN sum(p.score)"
+        self.graph.query(q)
+
+        # columns held by the store are reported
+        res = self.conn.execute_command("GRAPH.INFO", "ColumnarStore")
+        self.env.assertEquals(res[0], "# Columnar store")
+        stats = dict(zip(res[1][::2], res[1][1::2]))
+        self.env.assertGreater(stats["Columns"], 0)
+        self.env.assertGreater(stats["Column memory"], 0)
+
+    def test07_memory_capacity(self):
+        capacity = self.conn.execute_command("GRAPH.CONFIG", "GET",
+                                             "COLUMNAR_STORE_MEM_CAPACITY")[1]
+        self.env.assertEquals(capacity, 256 * 1024 * 1024)
+
+        q = "MATCH (p:Person) WHERE p.id < 50 RETURN sum(p.id), sum(p.score)"
+        expected = self.graph.query(q).result_set
+
+        try:
+            # lowering the capacity evicts all columns
+            self.conn.execute_command("GRAPH.CONFIG", "SET",
+                                      "COLUMNAR_STORE_MEM_CAPACITY", 0)
+            res = self.conn.execute_command("GRAPH.INFO", "ColumnarStore")
+            self.env.assertEquals(res[1], ["Columns", 0, "Column memory", 0])
+
+            # columns exceeding the capacity aren't built,
+            # values are read from the nodes' attribute-sets
+            res = self.graph.query(q).result_set
+            self.env.assertEquals(res, expected)
+
+            res = self.conn.execute_command("GRAPH.INFO", "ColumnarStore")
+            self.env.assertEquals(res[1], ["Columns", 0, "Column memory", 0])
+
+            # measure a single column
+            self.conn.execute_command("GRAPH.CONFIG", "SET",
+                                      "COLUMNAR_STORE_MEM_CAPACITY", capacity)
+            self.graph.query("MATCH (p:Person) RETURN sum(p.id)")
+            res = self.conn.execute_command("GRAPH.INFO", "ColumnarStore")
+            self.env.assertEquals(res[1][1], 1)
+            column_memory = res[1][3]
+
+            # room for a single column, the least recently used is evicted
+            self.conn.execute_command("GRAPH.CONFIG", "SET",
+                                      "COLUMNAR_STORE_MEM_CAPACITY",
+                                      column_memory)
+            res = self.graph.query(q).result_set
+            self.env.assertEquals(res, expected)
+
+            res = self.conn.execute_command("GRAPH.INFO", "ColumnarStore")
+            self.env.assertEquals(res[1], ["Columns", 1,
+                                           "Column memory", column_memory])
+        finally:
+            self.conn.execute_command("GRAPH.CONFIG", "SET",
+                                      "COLUMNAR_STORE_MEM_CAPACITY", capacity)
+
+    def test08_invalidation(self):
+        q = "MATCH (p:Person) RETURN sum(p.id), sum(p.score)"
+        expected = self.graph.query(q).result_set
+
+        res = self.conn.execute_command("GRAPH.INFO", "ColumnarStore")
+        columns = res[1][1]
+        self.env.assertGreaterEqual(columns, 2)
+
+        # writes to other labels keep Person's columns
+        self.graph.query("CREATE (:Other {id: 1, score: 1.0})")
+        res = self.conn.execute_command("GRAPH.INFO", "ColumnarStore")
+        self.env.assertEquals(res[1][1], columns)
+
+        # modifying an attribute drops only its column
+        self.graph.query("MATCH (p:Person) WHERE p.id = 50 SET p.score = 1000.0")
+        res = self.conn.execute_command("GRAPH.INFO", "ColumnarStore")
+        self.env.assertEquals(res[1][1], columns - 1)
+
+        res = self.graph.query(q).result_set
+        self.env.assertEquals(res, [[expected[0][0],
+                                     expected[0][1] - 25.0 + 1000.0]])
+
+        self.graph.query("MATCH (p:Person) WHERE p.id = 50 SET p.score = 25.0")
+        self.graph.query("MATCH (o:Other) DELETE o")
@@ -3,7 +3,7 @@ from common import *
 redis_con = None
 redis_graph = None
 # Number of options available.
-NUMBER_OF_OPTIONS = 16
+NUMBER_OF_OPTIONS = 21
 
 class testConfig(FlowTestsBase):
     def __init__(self):
@@ -25,7 +25,7 @@ class testConfig(FlowTestsBase):
         # Try reading all configurations
         config_name = "*"
         response = redis_con.execute_command("GRAPH.CONFIG GET " + config_name)
-        # 16 configurations should be reported
+        # 21 configurations should be reported
         self.env.assertEquals(len(response), NUMBER_OF_OPTIONS)
 
     def test02_config_get_invalid_name(self):
@@ -298,3 +298,20 @@ class testConfig(FlowTestsBase):
         expected_response = ["NODE_CREATION_BUFFER", 1024]
         self.env.assertEqual(creation_buffer_size, expected_response)
 
+    def test12_bulk_load_root(self):
+        # bulk load is disabled by default
+        response = redis_con.execute_command("GRAPH.CONFIG", "GET", "BULK_LOAD_ROOT")
+        self.env.assertEqual(response, ["BULK_LOAD_ROOT", ""])
+
+        # bulk load root can only be set at load-time
+        try:
+            redis_con.execute_command("GRAPH.CONFIG", "SET", "BULK_LOAD_ROOT", "/")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertIn("cannot be set at run-time", str(e))
+
+        try:
+            redis_con.execute_command("GRAPH.BULK", "bulk", "LOAD", "/")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertIn("Bulk load is disabled", str(e))
@@ -74,14 +74,17 @@ class testConstraintNodes():
             self.env.assertContains("mandatory constraint violation: node with label Person missing property height", str(e))
 
         #-----------------------------------------------------------------------
-        # create a node that violates the unique constraint on point data ignored
+        # create a node that violates the unique constraint on point data
         #-----------------------------------------------------------------------
 
         try:
-            g.query("MATCH (p:Person) CREATE (n:Person{height:p.height + 1, loc: p.loc}) DELETE n")
-            self.env.assertTrue(True)
-        except ResponseError as e:
+            g.query("MATCH (p:Person) CREATE (:Person{height:p.height + 1000, loc: p.loc})")
             self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains("unique constraint violation on node of type Person", str(e))
+
+        # distinct points are accepted
+        g.query("CREATE (n:Person{height: 1000, loc: point({latitude:5, longitude:2})}) DELETE n")
 
         #-----------------------------------------------------------------------
         # create a node that violates the unique constraint
@@ -550,6 +553,28 @@ class testConstraintNodes():
         drop_exact_match_index(self.g, "Author", "nickname")
         drop_exact_match_index(self.g, "Author", "birthdate")
 
+    def test09_large_integers(self):
+        # integers of great magnitude share their index encoding
+        # 9007199254740993 is indexed as 9007199254740992
+        self.g.query("CREATE (:Account {number: 9007199254740992})")
+        self.g.query("CREATE (:Account {number: 9007199254740993})")
+
+        # enforcing the constraint over existing nodes compares them exactly
+        create_unique_node_constraint(self.g, "Account", "number", sync=True)
+        c = get_constraint(self.g, "UNIQUE", "NODE", "Account", "number")
+        self.env.assertEquals(c.status, "OPERATIONAL")
+
+        # distinct neighbours are accepted
+        self.g.query("CREATE (:Account {number: 9007199254740994})")
+
+        # exact duplicates are rejected
+        for v in ["9007199254740992", "9007199254740993"]:
+            try:
+                self.g.query("CREATE (:Account {number: %s})" % v)
+                self.env.assertTrue(False)
+            except ResponseError as e:
+                self.env.assertContains("unique constraint violation on node of type Account", str(e))
+
 class testConstraintEdges():
     def __init__(self):
         self.env = Env(decodeResponses=True)
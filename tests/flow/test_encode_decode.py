@@ -343,3 +343,94 @@ class test_encode_decode(FlowTestsBase):
 
         compare_nodes_result_set(self.env, nodes_before.result_set, nodes_after.result_set)
         self.env.assertEquals(edges_before.result_set, edges_after.result_set)
+
+    # matrices are encoded as row tiles, make sure a graph spanning
+    # multiple tiles, labels and multi-edges is restored intact
+    def test13_matrices_over_multiple_tiles(self):
+        redis_con.flushall()
+
+        response = redis_con.execute_command(
+            "GRAPH.CONFIG SET VKEY_MAX_ENTITY_COUNT 10")
+        self.env.assertEqual(response, "OK")
+
+        graph_name = "matrix_tiles"
+        redis_graph = Graph(redis_con, graph_name)
+
+        redis_graph.query("UNWIND range(0, 99) AS v CREATE (:A:B {v: v})")
+        redis_graph.query("""MATCH (a:A), (b:B) WHERE b.v = (a.v * 7) % 100
+                             CREATE (a)-[:R {v: a.v}]->(b),
+                                    (a)-[:R {v: -a.v}]->(b),
+                                    (b)-[:S {v: a.v}]->(a)""")
+        redis_graph.query("MATCH (n:A) WHERE n.v % 3 = 0 REMOVE n:B")
+        create_node_exact_match_index(redis_graph, 'A', 'v', sync=True)
+
+        queries = ["MATCH (n:B) RETURN n.v ORDER BY n.v",
+                   "MATCH (a)-[e:R]->(b) RETURN a.v, e.v, b.v ORDER BY a.v, e.v",
+                   "MATCH (a)<-[e:S]-(b) RETURN a.v, e.v, b.v ORDER BY a.v",
+                   "MATCH (a:A {v: 42})-[:R]->(b) RETURN b.v",
+                   "MATCH ()-[e]->() RETURN count(e)"]
+        expected = [redis_graph.query(q).result_set for q in queries]
+
+        redis_con.execute_command("DEBUG", "RELOAD")
+
+        actual = [redis_graph.query(q).result_set for q in queries]
+        self.env.assertEquals(expected, actual)
+
+        # index is populated
+        plan = str(redis_graph.explain(queries[3]))
+        self.env.assertIn("Node By Index Scan", plan)
+
+    def test14_compressed_entities(self):
+        redis_con.flushall()
+
+        logfilename = self.env.envRunner._getFileName("master", ".log")
+        logfile = open(f"{self.env.logDir}/{logfilename}")
+        logfile.read()
+
+        response = redis_con.execute_command(
+            "GRAPH.CONFIG SET RDB_COMPRESSION yes")
+        self.env.assertEqual(response, "OK")
+
+        graph_name = "compressed_entities"
+        redis_graph = Graph(redis_con, graph_name)
+
+        redis_graph.query("""UNWIND range(0, 999) AS v
+                             CREATE (:N {v: v, s: 'status: active', a: [v, 'x'],
+                                         p: point({latitude: 32.0, longitude: 34.0})})""")
+        redis_graph.query("""MATCH (a:N), (b:N) WHERE b.v = a.v + 1
+                             CREATE (a)-[:R {v: a.v, s: 'status: active'}]->(b)""")
+
+        queries = ["MATCH (n:N) RETURN n ORDER BY n.v",
+                   "MATCH ()-[e:R]->() RETURN e ORDER BY e.v"]
+        expected = [redis_graph.query(q).result_set for q in queries]
+
+        redis_con.execute_command("DEBUG", "RELOAD")
+
+        actual = [redis_graph.query(q).result_set for q in queries]
+        self.env.assertEquals(expected, actual)
+
+        # compression ratio is reported once the graph is encoded
+        log = logfile.read()
+        matches = re.findall(
+            "Done encoding graph compressed_entities, entities compression ratio ([0-9.]+)",
+            log)
+        self.env.assertGreater(len(matches), 0)
+        self.env.assertGreater(float(matches[-1]), 1)
+
+        # compression ratio of the loaded graph is reported by GRAPH.INFO
+        res = redis_con.execute_command("GRAPH.INFO", "Persistence")
+        self.env.assertEquals(res[0], "# Persistence")
+        stats = dict(zip(res[1][::2], res[1][1::2]))
+        self.env.assertGreater(stats["Entity bytes"],
+                               stats["Encoded entity bytes"])
+        self.env.assertGreater(float(stats["Compression ratio"]), 1)
+
+        # disabling compression reverts to raw encoding
+        response = redis_con.execute_command(
+            "GRAPH.CONFIG SET RDB_COMPRESSION no")
+        self.env.assertEqual(response, "OK")
+
+        redis_con.execute_command("DEBUG", "RELOAD")
+
+        actual = [redis_graph.query(q).result_set for q in queries]
+        self.env.assertEquals(expected, actual)
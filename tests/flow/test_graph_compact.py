@@ -0,0 +1,130 @@
+from common import *
+from index_utils import *
+
+GRAPH_ID = "graph_compact"
+
+
+class testGraphCompact(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        self.conn = self.env.getConnection()
+        self.graph = Graph(self.conn, GRAPH_ID)
+
+    def compact(self):
+        return self.conn.execute_command("GRAPH.COMPACT", GRAPH_ID)
+
+    def populate_graph(self):
+        self.graph.delete()
+
+        # chain of 1000 nodes, each connected to its successor
+        # by both a R and a multi-edge S pair
+        q = """UNWIND range(0, 999) AS x
+               CREATE (:N {v: x})"""
+        self.graph.query(q)
+
+        q = """MATCH (a:N), (b:N) WHERE b.v = a.v + 1
+               CREATE (a)-[:R {v: a.v}]->(b),
+                      (a)-[:S {v: a.v}]->(b),
+                      (a)-[:S {v: -a.v}]->(b)"""
+        self.graph.query(q)
+
+        create_node_exact_match_index(self.graph, 'N', 'v', sync=True)
+        create_edge_exact_match_index(self.graph, 'R', 'v', sync=True)
+
+        # delete every node but every 10th, along with their edges
+        self.graph.query("MATCH (n:N) WHERE n.v % 10 <> 0 DELETE n")
+
+        # reconnect the remaining nodes
+        q = """MATCH (a:N), (b:N) WHERE b.v = a.v + 10
+               CREATE (a)-[:R {v: a.v}]->(b),
+                      (a)-[:S {v: a.v}]->(b),
+                      (a)-[:S {v: -a.v}]->(b)"""
+        self.graph.query(q)
+
+    def snapshot(self):
+        nodes = self.graph.query("MATCH (n:N) RETURN n.v ORDER BY n.v").result_set
+        edges = self.graph.query("""MATCH (a)-[e]->(b)
+                                    RETURN a.v, type(e), e.v, b.v
+                                    ORDER BY a.v, type(e), e.v""").result_set
+        return nodes, edges
+
+    def test01_compact(self):
+        self.populate_graph()
+        expected = self.snapshot()
+
+        res = self.compact()
+        self.env.assertEquals(len(res), 3)
+        self.env.assertTrue(res[0].startswith("Nodes relocated: "))
+        self.env.assertTrue(res[1].startswith("Relationships relocated: "))
+        self.env.assertTrue(res[2].startswith("Memory reclaimed: "))
+        self.env.assertGreater(int(res[0].split(": ")[1]), 0)
+        self.env.assertGreater(int(res[1].split(": ")[1]), 0)
+
+        # graph content is unaffected
+        self.env.assertEquals(self.snapshot(), expected)
+
+        # IDs are dense
+        q = "MATCH (n) RETURN count(n), max(ID(n))"
+        res = self.graph.query(q).result_set
+        self.env.assertEquals(res, [[100, 99]])
+
+        q = "MATCH ()-[e]->() RETURN count(e), max(ID(e))"
+        res = self.graph.query(q).result_set
+        self.env.assertEquals(res, [[297, 296]])
+
+    def test02_indices(self):
+        # node index lookup
+        q = "MATCH (n:N) WHERE n.v = 500 RETURN n.v"
+        plan = str(self.graph.explain(q))
+        self.env.assertIn("Node By Index Scan", plan)
+        res = self.graph.query(q).result_set
+        self.env.assertEquals(res, [[500]])
+
+        # edge index lookup, documents are keyed by the edge endpoints
+        q = "MATCH (a)-[e:R]->(b) WHERE e.v = 500 RETURN a.v, b.v"
+        plan = str(self.graph.explain(q))
+        self.env.assertIn("Edge By Index Scan", plan)
+        res = self.graph.query(q).result_set
+        self.env.assertEquals(res, [[500, 510]])
+
+    def test03_modifications(self):
+        # graph is fully usable following compaction
+        self.graph.query("CREATE (:N {v: 2000})")
+        q = "MATCH (n:N {v: 2000}) RETURN ID(n)"
+        res = self.graph.query(q).result_set
+        self.env.assertEquals(res, [[100]])
+
+        q = """MATCH (a:N {v: 990}), (b:N {v: 2000})
+               CREATE (a)-[:R {v: 990}]->(b)"""
+        self.graph.query(q)
+
+        q = "MATCH (a)-[e:R]->(b) WHERE e.v = 990 RETURN a.v, b.v"
+        res = self.graph.query(q).result_set
+        self.env.assertEquals(res, [[990, 2000]])
+
+    def test04_noop(self):
+        # compacting a dense graph is a no-op
+        res = self.compact()
+        self.env.assertEquals(res[0], "Nodes relocated: 0")
+        self.env.assertEquals(res[1], "Relationships relocated: 0")
+
+    def test05_missing_graph(self):
+        try:
+            self.conn.execute_command("GRAPH.COMPACT", "no_such_graph")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError:
+            pass
+
+    def test06_non_blocking_context(self):
+        # compaction can't run within MULTI or Lua scripts
+        pipe = self.conn.pipeline(transaction=True)
+        pipe.execute_command("GRAPH.COMPACT", GRAPH_ID)
+        res = pipe.execute(raise_on_error=False)
+        self.env.assertIn("non-blocking contexts", str(res[0]))
+
+        try:
+            self.conn.eval("return redis.call('GRAPH.COMPACT', KEYS[1])", 1,
+                           GRAPH_ID)
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertIn("non-blocking contexts", str(e))
@@ -194,3 +194,62 @@ class testGraphCreationFlow(FlowTestsBase):
             result = redis_graph.query(query)
             expected_result = [[0]]
             self.env.assertEquals(result.result_set, expected_result)
+
+    def test11_create_batch_of_edges(self):
+        # a large batch of edges introducing a new relationship-type
+        # is built into its matrix at once
+        query = """UNWIND range(0, 1999) AS x
+                   CREATE (:L {v: x})"""
+        redis_graph.query(query)
+
+        # every node is connected to its successor by two edges
+        query = """MATCH (a:L), (b:L) WHERE b.v = a.v + 1
+                   CREATE (a)-[:BATCH {v: a.v}]->(b),
+                          (a)-[:BATCH {v: -a.v}]->(b)"""
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.relationships_created, 3998)
+
+        queries = ["MATCH (:L)-[e:BATCH]->(:L) RETURN count(e)",
+                   "MATCH (:L)<-[e:BATCH]-(:L) RETURN count(e)"]
+        for query in queries:
+            result = redis_graph.query(query)
+            self.env.assertEquals(result.result_set, [[3998]])
+
+        query = """MATCH (a:L {v: 10})-[e:BATCH]->(b)
+                   RETURN a.v, e.v, b.v ORDER BY e.v"""
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set, [[10, -10, 11], [10, 10, 11]])
+
+        # both edges of the collapsed entry resolve the same endpoints
+        query = """MATCH (a)-[e:BATCH]->(b:L {v: 11})
+                   RETURN a.v, e.v, b.v ORDER BY e.v"""
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set, [[10, -10, 11], [10, 10, 11]])
+
+        query = """MATCH (a:L {v: 11})<-[e:BATCH]-(b)
+                   RETURN b.v, e.v ORDER BY e.v"""
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set, [[10, -10], [10, 10]])
+
+        query = """MATCH ()-[e:BATCH]->() WHERE abs(e.v) = 10
+                   RETURN startNode(e).v, e.v, endNode(e).v ORDER BY e.v"""
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set, [[10, -10, 11], [10, 10, 11]])
+
+        # remove one edge out of a pair
+        query = "MATCH ()-[e:BATCH {v: -10}]->() DELETE e"
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.relationships_deleted, 1)
+
+        query = "MATCH (:L {v: 10})-[e:BATCH]->() RETURN e.v"
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set, [[10]])
+
+        # additional edges go through the regular path
+        query = """MATCH (a:L {v: 0}), (b:L {v: 1999})
+                   CREATE (a)-[:BATCH {v: 5000}]->(b)"""
+        redis_graph.query(query)
+
+        query = "MATCH (:L)-[e:BATCH]->(:L) RETURN count(e)"
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set, [[3998]])
@@ -433,3 +433,57 @@ class testGraphInfo(FlowTestsBase):
         # wait for all threads to complete
         for t in threads:
             t.join()
+
+    def test08_compaction(self):
+        # lower the number of pending changes the query path tolerates
+        # such that the compactor will consider our matrices under pressure
+        original = self.conn.execute_command("GRAPH.CONFIG", "GET",
+                                             "DELTA_MAX_PENDING_CHANGES")[1]
+        self.conn.execute_command("GRAPH.CONFIG", "SET",
+                                  "DELTA_MAX_PENDING_CHANGES", 100)
+
+        try:
+            g = Graph(self.conn, "compaction")
+            g.query("UNWIND range(0, 90) AS x CREATE (:A {v:x})-[:R]->(:B)")
+
+            def compaction_stats():
+                res = self.conn.execute_command("GRAPH.INFO", "Compaction")
+                self.env.assertEquals(res[0], "# Compaction")
+                stats = res[1]
+                return dict(zip(stats[0::2], stats[1::2]))
+
+            # wait for compactor to pick up pending changes
+            # each poll reads all statistics at once, from a single snapshot
+            deadline = time.time() + 10
+            while True:
+                stats = compaction_stats()
+                if stats["Compacted matrices"] > 0 or time.time() > deadline:
+                    break
+                time.sleep(0.1)
+
+            self.env.assertGreater(stats["Compacted matrices"], 0)
+            self.env.assertGreater(stats["Runs"], 0)
+            self.env.assertGreater(stats["Folded changes"], 0)
+
+            # make sure graph is intact
+            res = g.query("MATCH (a:A)-[:R]->(b:B) RETURN count(a), count(b)")
+            self.env.assertEquals(res.result_set[0], [91, 91])
+
+            # writes to one label do not abort the compaction of another
+            g.query("UNWIND range(0, 90) AS x CREATE (:C {v:x})")
+            before = compaction_stats()["Compacted matrices"]
+            deadline = time.time() + 10
+            while time.time() < deadline:
+                g.query("CREATE (:D)")
+                stats = compaction_stats()
+                if stats["Compacted matrices"] > before:
+                    break
+                time.sleep(0.01)
+
+            self.env.assertGreater(stats["Compacted matrices"], before)
+            res = g.query("MATCH (c:C) RETURN count(c)")
+            self.env.assertEquals(res.result_set[0], [91])
+        finally:
+            # restore original value
+            self.conn.execute_command("GRAPH.CONFIG", "SET",
+                                      "DELTA_MAX_PENDING_CHANGES", original)
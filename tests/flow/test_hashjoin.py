@@ -35,3 +35,47 @@ class testHashJoin(FlowTestsBase):
 
         self.env.assertEquals(actual_result.result_set, expected_result)
 
+
+    def test_hashjoin_multiple_matches(self):
+        graph = Graph(self.env.getConnection(), "hashjoin_matches")
+        graph.query("UNWIND range(0, 999) AS x CREATE (:L {v: x % 100, s: toString(x % 10)}), (:R {v: x % 50, s: toString(x % 5)})")
+
+        # every L node with v < 50 joins with 20 R nodes
+        q = "MATCH (a:L), (b:R) WHERE a.v = b.v RETURN count(1)"
+        plan = graph.execution_plan(q)
+        self.env.assertIn("Value Hash Join", plan)
+        res = graph.query(q).result_set
+        self.env.assertEquals(res, [[500 * 20]])
+
+        # string keys
+        q = "MATCH (a:L), (b:R) WHERE a.s = b.s RETURN count(1)"
+        res = graph.query(q).result_set
+        self.env.assertEquals(res, [[500 * 200]])
+
+        # integers and floats representing the same value intersect
+        q = "MATCH (a:L), (b:R) WHERE a.v = toFloat(b.v) RETURN count(1)"
+        res = graph.query(q).result_set
+        self.env.assertEquals(res, [[500 * 20]])
+
+        q = "MATCH (a:L), (b:R) WHERE a.v = b.v + 0.5 RETURN count(1)"
+        res = graph.query(q).result_set
+        self.env.assertEquals(res, [[0]])
+
+        graph.delete()
+
+    def test_hashjoin_profile(self):
+        graph = Graph(self.env.getConnection(), "hashjoin_profile")
+        graph.query("UNWIND range(0, 99) AS x CREATE (:L {v: x}), (:R {v: x + 50})")
+
+        q = "MATCH (a:L), (b:R) WHERE a.v = b.v RETURN count(1)"
+        res = graph.query(q).result_set
+        self.env.assertEquals(res, [[50]])
+
+        # build and probe statistics are reported
+        profile = self.env.getConnection().execute_command("GRAPH.PROFILE", "hashjoin_profile", q)
+        join = [x for x in profile if "Value Hash Join" in x][0]
+        self.env.assertIn("Build records: 100", join)
+        self.env.assertIn("Probes: 100", join)
+        self.env.assertIn("Records produced: 50", join)
+
+        graph.delete()
@@ -777,3 +777,45 @@ class testIndexCreationFlow():
     #     # one (v) we're expecting thier overall construction time to be similar
     #     self.env.assertTrue(elapsed_2 < elapsed * 2)
 
+
+    def test14_index_population_concurrent_writes(self):
+        # entities modified while an index is populated must be indexed
+        # according to their latest state
+        g = Graph(con, "concurrent_population")
+        g.query("UNWIND range(0, 300000) AS x CREATE (:P {v: x})")
+        g.query("UNWIND range(0, 30000) AS x CREATE (:Q)-[:R {v: x}]->(:Q)")
+
+        create_node_exact_match_index(g, 'P', 'v', sync=False)
+        create_edge_exact_match_index(g, 'R', 'v', sync=False)
+
+        # modify entities while indexes are being populated
+        g.query("MATCH (n:P) WHERE n.v % 1000 = 0 SET n.v = -n.v - 1")
+        g.query("MATCH (n:P) WHERE n.v % 1000 = 1 DELETE n")
+        g.query("UNWIND range(1, 100) AS x CREATE (:P {v: -x})")
+        g.query("MATCH ()-[e:R]->() WHERE e.v % 100 = 0 SET e.v = -e.v - 1")
+        g.query("MATCH ()-[e:R]->() WHERE e.v % 100 = 1 DELETE e")
+
+        wait_for_indices_to_sync(g)
+
+        # populated indexes report completion
+        res = g.query("CALL db.indexes() YIELD progress RETURN collect(progress)")
+        self.env.assertEquals(res.result_set[0][0], [100, 100])
+
+        # index scans agree with label scans
+        q = "MATCH (n:P) WHERE n.v < 0 RETURN count(n)"
+        plan = str(g.explain(q))
+        self.env.assertIn("Node By Index Scan", plan)
+        self.env.assertEquals(g.query(q).result_set[0][0], 401)
+
+        q = "MATCH (n:P) WHERE n.v >= 0 RETURN count(n)"
+        self.env.assertEquals(g.query(q).result_set[0][0], 300001 - 301 - 300)
+
+        q = "MATCH (:Q)-[e:R]->(:Q) WHERE e.v < 0 RETURN count(e)"
+        plan = str(g.explain(q))
+        self.env.assertIn("Edge By Index Scan", plan)
+        self.env.assertEquals(g.query(q).result_set[0][0], 301)
+
+        q = "MATCH (:Q)-[e:R]->(:Q) WHERE e.v >= 0 RETURN count(e)"
+        self.env.assertEquals(g.query(q).result_set[0][0], 30001 - 301 - 300)
+
+        g.delete()
@@ -710,3 +710,167 @@ class testIndexScanFlow():
 
         # expecting an no index scan operation
         self.env.assertNotIn('Node By Index Scan', plan)
+
+    def test_24_index_scan_mixed_types(self):
+        g = Graph(self.env.getConnection(), 'mixed_types')
+
+        # populate an indexed and a none indexed label with the same values
+        q = """UNWIND range(0, 99) AS x
+               WITH x, CASE x % 4
+                   WHEN 0 THEN x
+                   WHEN 1 THEN toFloat(x) / 2
+                   WHEN 2 THEN toString(x)
+                   ELSE x % 2 = 1 END AS v
+               CREATE (:A {id: x, v: v, w: x % 5}), (:B {id: x, v: v, w: x % 5})"""
+        g.query(q)
+
+        create_node_exact_match_index(g, 'A', 'v', 'w', sync=True)
+
+        filters = [
+            "n.v = 8",
+            "n.v = 4.5",
+            "n.v = '10'",
+            "n.v = true",
+            "n.v = 1",
+            "n.v < 10",
+            "n.v >= 40.5 AND n.v < 48",
+            "n.v > '5'",
+            "n.v <= false",
+            "n.v IN [0, 12, '14', true, 0.5]",
+            "n.v < 10 OR n.v > 90",
+            "n.v < 10 OR n.w = 3",
+            "n.v > 20 AND n.w = 2",
+            "(n.v = 4 OR n.v = 8) AND (n.w = 3 OR n.w = 4)",
+            "n.v > 9007199254740993",
+        ]
+
+        for f in filters:
+            indexed_q = f"MATCH (n:A) WHERE {f} RETURN n.id ORDER BY n.id"
+            plan = g.execution_plan(indexed_q)
+            self.env.assertIn('Node By Index Scan', plan)
+
+            scan_q = f"MATCH (n:B) WHERE {f} RETURN n.id ORDER BY n.id"
+            expected = g.query(scan_q).result_set
+            actual = g.query(indexed_q).result_set
+            self.env.assertEquals(actual, expected)
+
+    def test_25_covering_index_scan(self):
+        g = Graph(self.env.getConnection(), 'covering')
+
+        # populate an indexed and a none indexed label with the same values
+        q = """UNWIND range(0, 99) AS x
+               WITH x, CASE x % 7
+                   WHEN 0 THEN x
+                   WHEN 1 THEN toFloat(x)
+                   WHEN 2 THEN toString(x)
+                   WHEN 3 THEN x % 2 = 1
+                   WHEN 4 THEN point({latitude: x / 2.0, longitude: -x})
+                   WHEN 5 THEN [x]
+                   ELSE NULL END AS v
+               CREATE (:A {id: x, v: v, w: x}), (:B {id: x, v: v, w: x})"""
+        g.query(q)
+
+        create_node_exact_match_index(g, 'A', 'v', 'w', sync=True)
+
+        # queries accessing only indexed attributes are answered by the index
+        covered = [
+            "MATCH (n:{L}) WHERE n.w >= 10 RETURN n.v, n.w ORDER BY n.w",
+            "MATCH (n:{L}) WHERE n.w < 50 AND n.v > 0 RETURN n.w, n.v + 1 ORDER BY n.w",
+            "MATCH (n:{L}) WHERE n.w > 20 RETURN min(n.w), max(n.w), count(n.v)",
+            "MATCH (n:{L}) WHERE n.w > 20 WITH n.v AS v WHERE v IS NOT NULL RETURN count(v)",
+            "MATCH (n:{L}) WHERE n.w > 9007199254740993 OR n.w < 5 RETURN n.w ORDER BY n.w",
+        ]
+
+        # queries accessing the node itself or a none indexed attribute
+        uncovered = [
+            "MATCH (n:{L}) WHERE n.w > 90 RETURN n.id ORDER BY n.id",
+            "MATCH (n:{L}) WHERE n.w > 90 RETURN n ORDER BY n.w",
+            "MATCH (n:{L}) WHERE n.w > 90 RETURN [x IN [1] | n.id] ORDER BY n.w",
+        ]
+
+        for q in covered + uncovered:
+            indexed_q = q.replace('{L}', 'A')
+            plan = g.execution_plan(indexed_q)
+            self.env.assertIn('Node By Index Scan', plan)
+            if q in covered:
+                self.env.assertIn('Index only', plan)
+            else:
+                self.env.assertNotIn('Index only', plan)
+
+            expected = g.query(q.replace('{L}', 'B')).result_set
+            actual = g.query(indexed_q).result_set
+            if q.find("RETURN n ") != -1:
+                # nodes differ by their labels, compare their attributes
+                expected = [[n.properties for n in row] for row in expected]
+                actual = [[n.properties for n in row] for row in actual]
+            self.env.assertEquals(actual, expected)
+
+        # memory held to answer index-only scans is reported
+        res = self.env.getConnection().execute_command("GRAPH.INFO", "Indexes")
+        self.env.assertEquals(res[0], "# Indexes")
+        stats = dict(zip(res[1][::2], res[1][1::2]))
+        self.env.assertGreater(stats["Exact-match indexes"], 0)
+        self.env.assertGreater(stats["Stored value memory"], 0)
+
+    def test_26_ordered_index_scan(self):
+        conn = self.env.getConnection()
+        g = Graph(conn, 'ordered')
+
+        # sort op reports consuming records in index order only when profiled
+        def sort_line(q):
+            profile = conn.execute_command("GRAPH.PROFILE", 'ordered', q)
+            sort = [x for x in profile if x.strip().startswith("Sort")]
+            self.env.assertEquals(len(sort), 1)
+            return sort[0]
+
+        # populate an indexed and a none indexed label with the same values
+        # scores are tied in groups, some are strings
+        # and some are integers the index doesn't represent exactly
+        q = """UNWIND range(0, 99) AS x
+               WITH x, CASE x % 10
+                   WHEN 8 THEN toString(x % 20)
+                   WHEN 9 THEN 9007199254740993 + x % 3
+                   ELSE x % 20 END AS score
+               CREATE (:A {id: x, score: score}), (:B {id: x, score: score})"""
+        g.query(q)
+
+        create_node_exact_match_index(g, 'A', 'score', sync=True)
+
+        # sorted as the index scan emits its nodes
+        streamed = [
+            "MATCH (n:{L}) WHERE n.score > 3 RETURN n.score ORDER BY n.score DESC LIMIT 7",
+            "MATCH (n:{L}) WHERE n.score >= 0 RETURN n.id, n.score ORDER BY n.score, n.id DESC LIMIT 12",
+            "MATCH (n:{L}) WHERE n.score < 10 RETURN n.score ORDER BY n.score DESC SKIP 3 LIMIT 5",
+            "MATCH (n:{L}) WHERE n.score IN [1, 4, 7] RETURN n.id, n.score ORDER BY n.score DESC, n.id LIMIT 8",
+            "MATCH (n:{L}) WHERE n.score > '1' RETURN n.score AS s ORDER BY s LIMIT 6",
+            "MATCH (n:{L}) WHERE n.score > 20 RETURN n.score ORDER BY n.score DESC LIMIT 4",
+            "MATCH (n:{L}) WHERE n.score > 20 RETURN n.score ORDER BY n.score LIMIT 2",
+        ]
+
+        # resolved out of order, sorted as usual
+        unordered = [
+            "MATCH (n:{L}) WHERE n.score IN [1, '4', 7] RETURN n.id, n.score ORDER BY n.score DESC, n.id LIMIT 8",
+            "MATCH (n:{L}) WHERE n.score < 3 OR n.score = '8' RETURN n.id, n.score ORDER BY n.score, n.id LIMIT 9",
+        ]
+
+        for q in streamed + unordered:
+            indexed_q = q.replace('{L}', 'A')
+            # scan is planned to emit nodes in index order
+            plan = g.execution_plan(indexed_q)
+            self.env.assertIn('Index order', plan)
+
+            # decided on the scan's first node
+            if q in streamed:
+                self.env.assertIn('Index order', sort_line(indexed_q))
+            else:
+                self.env.assertNotIn('Index order', sort_line(indexed_q))
+
+            expected = g.query(q.replace('{L}', 'B')).result_set
+            actual = g.query(indexed_q).result_set
+            self.env.assertEquals(actual, expected)
+
+        # unbounded sorts and sort keys which aren't indexed
+        for q in ["MATCH (n:A) WHERE n.score > 3 RETURN n.score ORDER BY n.score",
+                  "MATCH (n:A) WHERE n.score > 3 RETURN n.id ORDER BY n.id LIMIT 3"]:
+            self.env.assertNotIn('Index order', g.execution_plan(q))
+            self.env.assertNotIn('Index order', sort_line(q))
@@ -200,3 +200,103 @@ class testIndexUpdatesFlow(FlowTestsBase):
         result = redis_graph.query("CALL db.idx.fulltext.queryNodes('label_a', 'Group C')")
         self.env.assertEquals(len(result.result_set), 0)
 
+
+    # index changes made by a query are visible to the rest of the query
+    # and are reverted along with a failed query
+    def test08_deferred_index_changes(self):
+        g = Graph(self.redis_con, "deferred_index_changes")
+        create_node_exact_match_index(g, 'L', 'v', sync=True)
+        create_fulltext_index(g, 'L', 's', sync=True)
+
+        # entities created, updated and deleted within a single query
+        q = """UNWIND range(1, 1000) AS x
+               CREATE (n:L {v: x, s: 'created'})
+               WITH n
+               SET n.v = n.v * 10, n.s = 'updated'
+               WITH n
+               WHERE n.v % 20 = 0
+               DELETE n"""
+        result = g.query(q)
+        self.env.assertEquals(result.nodes_created, 1000)
+        self.env.assertEquals(result.nodes_deleted, 500)
+
+        # index is consulted within the query that modified it
+        q = """CREATE (:L {v: -1})
+               WITH 1 AS x
+               MATCH (n:L) WHERE n.v < 0
+               RETURN count(n)"""
+        plan = str(g.explain(q))
+        self.env.assertIn("Node By Index Scan", plan)
+        self.env.assertEquals(g.query(q).result_set[0][0], 1)
+
+        q = "MATCH (n:L) WHERE n.v > 0 RETURN count(n), min(n.v), max(n.v)"
+        self.env.assertEquals(g.query(q).result_set[0], [500, 10, 9990])
+
+        result = g.query("CALL db.idx.fulltext.queryNodes('L', 'updated')")
+        self.env.assertEquals(len(result.result_set), 500)
+
+        result = g.query("CALL db.idx.fulltext.queryNodes('L', 'created')")
+        self.env.assertEquals(len(result.result_set), 0)
+
+        # failed query leaves indices intact
+        try:
+            g.query("""MATCH (n:L) WHERE n.v > 0
+                       SET n.v = -n.v
+                       WITH count(n) AS c
+                       RETURN c / 0""")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains("Division by zero", str(e))
+
+        q = "MATCH (n:L) WHERE n.v > 0 RETURN count(n)"
+        self.env.assertEquals(g.query(q).result_set[0][0], 500)
+
+        q = "MATCH (n:L) WHERE n.v < 0 RETURN count(n)"
+        self.env.assertEquals(g.query(q).result_set[0][0], 1)
+
+        g.delete()
+
+    # entities created by a query are indexed in bulk
+    # unless modified or reusing the ID of an entity deleted by the query
+    def test09_bulk_index_created_entities(self):
+        g = Graph(self.redis_con, "bulk_index_created_entities")
+        create_node_exact_match_index(g, 'L', 'v', sync=True)
+        create_edge_exact_match_index(g, 'R', 'w', sync=True)
+
+        q = """UNWIND range(0, 999) AS x
+               CREATE (:L {v: x})-[:R {w: x}]->(:L {v: x + 1000})"""
+        result = g.query(q)
+        self.env.assertEquals(result.nodes_created, 2000)
+
+        q = "MATCH (n:L) WHERE n.v >= 500 AND n.v < 1500 RETURN count(n)"
+        self.env.assertIn("Node By Index Scan", str(g.explain(q)))
+        self.env.assertEquals(g.query(q).result_set[0][0], 1000)
+
+        q = "MATCH ()-[e:R]->() WHERE e.w < 100 RETURN count(e), sum(e.w)"
+        self.env.assertIn("Edge By Index Scan", str(g.explain(q)))
+        self.env.assertEquals(g.query(q).result_set[0], [100, 4950])
+
+        # deleted IDs are reused by entities created within the same query
+        q = """MATCH (n:L) WHERE n.v < 10
+               DETACH DELETE n
+               WITH count(n) AS c
+               UNWIND range(1, c) AS x
+               CREATE (:L {v: -x})"""
+        result = g.query(q)
+        self.env.assertEquals(result.nodes_deleted, 10)
+        self.env.assertEquals(result.nodes_created, 10)
+
+        q = "MATCH (n:L) WHERE n.v < 10 RETURN count(n), min(n.v), max(n.v)"
+        self.env.assertEquals(g.query(q).result_set[0], [10, -10, -1])
+
+        # created entities updated within the creating query
+        q = """UNWIND range(0, 99) AS x
+               CREATE (n:L {v: 5000 + x})
+               SET n.v = n.v + 1000"""
+        g.query(q)
+
+        q = "MATCH (n:L) WHERE n.v >= 5000 AND n.v < 6000 RETURN count(n)"
+        self.env.assertEquals(g.query(q).result_set[0][0], 0)
+
+        q = "MATCH (n:L) WHERE n.v >= 6000 RETURN count(n)"
+        self.env.assertEquals(g.query(q).result_set[0][0], 100)
@@ -73,3 +73,39 @@ class testOrderBy(FlowTestsBase):
         # assert the order of the results
         self.env.assertEquals(res.result_set[0][0], Node(label='N', properties={'v': 1}))
         self.env.assertEquals(res.result_set[1][0], Node(label='N', properties={'v': 2}))
+
+    def test03_spill_under_memory_pressure(self):
+        """Tests that a full sort exceeding its memory share spills sorted
+        runs to disk and merges them, rather than failing the query"""
+
+        conn = self.env.getConnection()
+        g = Graph(conn, GRAPH_ID)
+        g.query("UNWIND range(0, 999) AS x CREATE (:S {v: x})")
+
+        # ~100K wide records, well over the query's memory capacity
+        q = """MATCH (n:S) UNWIND range(0, 99) AS i
+               WITH n, i, $pad + toString(i) AS s
+               ORDER BY i DESC, n.v
+               RETURN n.v"""
+        params = {'pad': 'x' * 500}
+
+        conn.execute_command("GRAPH.CONFIG", "SET", "QUERY_MEM_CAPACITY", 16 * 1024 * 1024)
+        try:
+            res = g.query(q, params).result_set
+            profile = conn.execute_command("GRAPH.PROFILE", GRAPH_ID,
+                                           "CYPHER pad='%s' %s" % ('x' * 500, q))
+        finally:
+            conn.execute_command("GRAPH.CONFIG", "SET", "QUERY_MEM_CAPACITY", 0)
+
+        expected = [[v] for i in range(99, -1, -1) for v in range(1000)]
+        self.env.assertEquals(res, expected)
+
+        sort = [x for x in profile if x.strip().startswith("Sort")]
+        self.env.assertEquals(len(sort), 1)
+        self.env.assertIn("Spilled runs", sort[0])
+
+        # without a memory capacity the sort is kept in memory
+        profile = conn.execute_command("GRAPH.PROFILE", GRAPH_ID,
+                                       "CYPHER pad='%s' %s" % ('x' * 500, q))
+        sort = [x for x in profile if x.strip().startswith("Sort")]
+        self.env.assertNotIn("Spilled runs", sort[0])
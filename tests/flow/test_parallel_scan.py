@@ -0,0 +1,122 @@
+from common import *
+
+GRAPH_ID = "parallel_scan"
+
+# number of nodes created per label, spans multiple scan morsels
+NODE_COUNT = 40000
+
+
+class testParallelScan(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True, moduleArgs='THREAD_COUNT 4')
+        self.conn = self.env.getConnection()
+        self.graph = Graph(self.conn, GRAPH_ID)
+        self.populate_graph()
+
+    def populate_graph(self):
+        q = f"""UNWIND range(0, {NODE_COUNT - 1}) AS x
+                CREATE (:L {{v: x}})-[:R]->(:M {{v: x}})"""
+        self.graph.query(q)
+
+    def test01_gather_placement(self):
+        # eager operations fed by a scan are parallelized
+        queries = ["MATCH (a:L)-[:R]->(b) RETURN count(b)",
+                   "MATCH (a) WHERE a.v > 10 RETURN a.v ORDER BY a.v LIMIT 3",
+                   "MATCH (a:L)-[:R]->(b:M) RETURN a.v % 10, count(b)"]
+        for q in queries:
+            plan = self.graph.execution_plan(q)
+            self.env.assertIn("Gather", plan)
+
+        # write queries are not parallelized
+        q = "MATCH (a:L) WITH count(a) AS c CREATE (:N {c: c})"
+        plan = self.graph.execution_plan(q)
+        self.env.assertNotIn("Gather", plan)
+
+        # small graphs are not parallelized
+        g = Graph(self.conn, "parallel_scan_small")
+        g.query("UNWIND range(0, 100) AS x CREATE (:L {v: x})")
+        plan = g.execution_plan("MATCH (a:L) RETURN count(a.v)")
+        self.env.assertNotIn("Gather", plan)
+        g.delete()
+
+    def test02_aggregation(self):
+        q = "MATCH (a:L)-[:R]->(b) RETURN count(b), sum(b.v)"
+        res = self.graph.query(q).result_set
+        expected = [[NODE_COUNT, NODE_COUNT * (NODE_COUNT - 1) // 2]]
+        self.env.assertEquals(res, expected)
+
+        # full scan
+        q = "MATCH (a) WHERE a.v % 2 = 0 RETURN count(a)"
+        res = self.graph.query(q).result_set
+        self.env.assertEquals(res, [[NODE_COUNT]])
+
+        # grouping
+        q = "MATCH (a:L)-[:R]->(b:M) RETURN a.v % 4 AS k, count(b) ORDER BY k"
+        res = self.graph.query(q).result_set
+        expected = [[k, NODE_COUNT // 4] for k in range(4)]
+        self.env.assertEquals(res, expected)
+
+    def test03_sort(self):
+        q = "MATCH (a:L) WHERE a.v % 10000 = 0 RETURN a.v ORDER BY a.v DESC"
+        res = self.graph.query(q).result_set
+        expected = [[v] for v in range(NODE_COUNT - 10000, -1, -10000)]
+        self.env.assertEquals(res, expected)
+
+    def test04_runtime_error(self):
+        # runtime errors raised by any of the pipelines fail the query
+        q = "MATCH (a:L) RETURN sum(a.v / (a.v - 30000))"
+        try:
+            self.graph.query(q)
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertIn("Division by zero", str(e))
+
+        # graph remains queryable
+        res = self.graph.query("MATCH (a:L) RETURN count(a)").result_set
+        self.env.assertEquals(res, [[NODE_COUNT]])
+
+    def test05_partial_aggregations(self):
+        # aggregations pre-aggregated by each pipeline and combined
+        q = """MATCH (a:L)
+               RETURN avg(a.v), min(a.v), max(a.v), size(collect(a.v)),
+                      round(stDevP(a.v) * 1000) / 1000,
+                      percentileDisc(a.v, 0.5), count(DISTINCT a.v % 7)"""
+        plan = self.graph.execution_plan(q)
+        self.env.assertIn("Gather", plan)
+
+        res = self.graph.query(q).result_set
+        stdev = round(((NODE_COUNT ** 2 - 1) / 12) ** 0.5 * 1000) / 1000
+        expected = [[(NODE_COUNT - 1) / 2, 0, NODE_COUNT - 1, NODE_COUNT,
+                     stdev, NODE_COUNT // 2 - 1, 7]]
+        self.env.assertEquals(res, expected)
+
+        # grouping
+        q = """MATCH (a:L)-[:R]->(b:M)
+               RETURN a.v % 3 AS k, min(b.v), max(b.v), sum(b.v) / count(b)
+               ORDER BY k"""
+        res = self.graph.query(q).result_set
+        expected = []
+        for k in range(3):
+            vs = range(k, NODE_COUNT, 3)
+            expected.append([k, min(vs), max(vs), sum(vs) / len(vs)])
+        self.env.assertEquals(res, expected)
+
+    def test06_profile(self):
+        # profile accounts for records produced by all pipelines
+        q = "MATCH (a:L) WHERE a.v % 2 = 0 RETURN count(a)"
+        profile = self.conn.execute_command("GRAPH.PROFILE", GRAPH_ID, q)
+        self.env.assertIn("Gather", "\n".join(profile))
+
+        stats = {}
+        for line in profile:
+            name = line[0:line.index('|')].strip()
+            records = int(line.split("Records produced: ")[1].split(',')[0])
+            time = float(line.split("Execution time: ")[1].split(' ')[0])
+            stats[name] = (records, time)
+
+        self.env.assertEquals(stats["Node By Label Scan"][0], NODE_COUNT)
+        self.env.assertEquals(stats["Filter"][0], NODE_COUNT // 2)
+
+        # execution times are not negative
+        for records, time in stats.values():
+            self.env.assertGreaterEqual(time, 0)
@@ -1,3 +1,4 @@
+import re
 from common import *
 
 GRAPH_ID = "profile"
@@ -39,3 +40,30 @@ class testProfile(FlowTestsBase):
         self.env.assertIn("Update | Records produced: 0", profile)
         self.env.assertIn("Conditional Variable Length Traverse | (a)-[@anon_1*1..INF]->(@anon_0) | Records produced: 0", profile)
         self.env.assertIn("Node By Label Scan | (a:L) | Records produced: 0", profile)
+
+    def test03_profile_traverse_batch_size(self):
+        # traversal batch size adapts to the observed fan-out
+        g = Graph(redis_con, "profile_batch_size")
+        g.query("UNWIND range(1, 2000) AS x CREATE (:A)-[:R]->(:B)")
+        g.query("UNWIND range(1, 40) AS x CREATE (h:H) WITH h UNWIND range(1, 100) AS y CREATE (h)-[:R]->(:B)")
+
+        def batch_size(q):
+            profile = redis_con.execute_command("GRAPH.PROFILE", "profile_batch_size", q)
+            traverse = [x for x in profile if x.startswith("Conditional Traverse")][0]
+            return int(re.search(r"Batch size: (\d+)", traverse).group(1))
+
+        # low fan-out, batch grows beyond its initial size
+        q = "MATCH (a:A)-[:R]->(b) RETURN count(b)"
+        self.env.assertEquals(g.query(q).result_set, [[2000]])
+        self.env.assertGreater(batch_size(q), 16)
+
+        # high fan-out under a tight memory budget, batch doesn't grow
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "QUERY_MEM_CAPACITY", 1048576)
+        try:
+            q = "MATCH (h:H)-[:R]->(b) RETURN count(b)"
+            self.env.assertEquals(g.query(q).result_set, [[4000]])
+            self.env.assertLessEqual(batch_size(q), 16)
+        finally:
+            redis_con.execute_command("GRAPH.CONFIG", "SET", "QUERY_MEM_CAPACITY", 0)
+
+        g.delete()
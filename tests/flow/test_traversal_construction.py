@@ -114,6 +114,30 @@ class testTraversalConstruction():
         ops = plan.split(os.linesep)
         self.env.assertEqual(len(ops), 14)
 
+    def test_cost_based_starting_point(self):
+        # traversal starts at the end-point estimated to be cheapest
+        # according to the graph's statistics
+        g = Graph(self.env.getConnection(), "cost_based_order")
+        g.query("UNWIND range(0, 999) AS x CREATE (:A {v: x})")
+        g.query("UNWIND range(0, 9) AS x CREATE (:B {v: x})")
+        g.query("MATCH (a:A), (b:B) WHERE a.v % 10 = b.v CREATE (a)-[:R]->(b)")
+
+        # heuristics alone would scan A, the pattern's source
+        plan = g.execution_plan("MATCH (a:A)-[:R]->(b:B) RETURN a")
+        ops = plan.split(os.linesep)
+        ops.reverse()
+        self.env.assertIn("Node By Label Scan | (b:B)", ops[0])
+        self.env.assertIn("Conditional Traverse", ops[1])
+
+        # explain reports the estimated number of rows
+        self.env.assertIn("Estimated rows: 10", ops[0])
+        self.env.assertIn("Estimated rows", ops[1])
+
+        res = g.query("MATCH (a:A)-[:R]->(b:B) RETURN count(a)").result_set
+        self.env.assertEquals(res, [[1000]])
+
+        g.delete()
+
     def test_start_with_index_filter(self):
         # TODO: enable this test, once we'll score higher filters that
         # have the potential turn into index scan
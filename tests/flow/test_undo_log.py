@@ -493,3 +493,65 @@ class testUndoLog():
         result = self.graph.query("MATCH (n:L4) RETURN labels(n)")
         self.env.assertEquals(len(result.result_set), 1)
         self.env.assertEquals(["L4"], result.result_set[0][0])
+
+    def test20_undo_partial_update(self):
+        self.graph.query("CREATE (:N {a: 1, b: 'b', c: [1, 2]})")
+        try:
+            # modify, add and remove attributes
+            self.graph.query("""MATCH (n:N)
+                                SET n.a = 2, n.b = NULL, n.d = 'd'
+                                WITH n
+                                RETURN 1 * n""")
+            # we're not supposed to be here, expecting query to fail
+            self.env.assertTrue(False)
+        except:
+            pass
+
+        # original attributes should be restored
+        result = self.graph.query("MATCH (n:N) RETURN properties(n)")
+        self.env.assertEquals(result.result_set[0][0],
+                              {'a': 1, 'b': 'b', 'c': [1, 2]})
+
+        # replacing the attribute-set is reverted as well
+        try:
+            self.graph.query("""MATCH (n:N)
+                                SET n = {a: 1, e: 5}
+                                WITH n
+                                RETURN 1 * n""")
+            self.env.assertTrue(False)
+        except:
+            pass
+
+        result = self.graph.query("MATCH (n:N) RETURN properties(n)")
+        self.env.assertEquals(result.result_set[0][0],
+                              {'a': 1, 'b': 'b', 'c': [1, 2]})
+
+    def test21_undo_log_profile(self):
+        self.graph.query("UNWIND range(1, 100) AS x CREATE (:N {v: x, s: 'str'})")
+
+        # evaluation follows the update, an undo-log is maintained
+        q = "MATCH (n:N) SET n.v = n.v + 1 RETURN count(n)"
+        profile = self.redis_con.execute_command("GRAPH.PROFILE", GRAPH_ID, q)
+        update = [op for op in profile if op.strip().startswith("Update")][0]
+        self.env.assertIn("Undo log: ", update)
+
+        # the update is the last operation, the query can't fail once the
+        # graph is modified and no undo-log is maintained
+        q = "MATCH (n:N) SET n.v = n.v + 1"
+        profile = self.redis_con.execute_command("GRAPH.PROFILE", GRAPH_ID, q)
+        update = [op for op in profile if op.strip().startswith("Update")][0]
+        self.env.assertNotIn("Undo log: ", update)
+
+        # updates were applied
+        result = self.graph.query("MATCH (n:N) RETURN min(n.v), max(n.v), collect(DISTINCT n.s)")
+        self.env.assertEquals(result.result_set, [[3, 102, ['str']]])
+
+        # failing updates are rolled back even without an undo-log up front
+        try:
+            self.graph.query("MATCH (n:N) SET n.v = {}")
+            self.env.assertTrue(False)
+        except:
+            pass
+
+        result = self.graph.query("MATCH (n:N) RETURN min(n.v), max(n.v)")
+        self.env.assertEquals(result.result_set, [[3, 102]])
@@ -93,6 +93,16 @@ void test_executionPlanCache() {
 	// Verify that oldest entry do not exists - queue is [ 4 | 3 | 2 ].
 	TEST_ASSERT(Cache_GetValue(cache, key1) == NULL);
 
+	//--------------------------------------------------------------------------
+	// Hit and miss counters
+	//--------------------------------------------------------------------------
+
+	uint64_t hits;
+	uint64_t misses;
+	Cache_GetStats(cache, &hits, &misses);
+	TEST_ASSERT(hits == 2);
+	TEST_ASSERT(misses == 4);
+
 	Cache_Free(cache);
 
 	// Expecting CacheObjFree to be called 9 times.
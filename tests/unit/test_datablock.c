@@ -230,12 +230,68 @@ void test_dataBlockOutOfOrderBuilding() {
 	DataBlockIterator_Free(it);
 }
 
+void test_dataBlockDefragment() {
+	// 4 blocks, 16 items each
+	DataBlock *dataBlock = DataBlock_New(16, 64, sizeof(int), NULL);
+
+	for(int i = 0; i < 64; i++) {
+		int *item = (int *)DataBlock_AllocateItem(dataBlock, NULL);
+		*item = i;
+	}
+	TEST_ASSERT(!DataBlock_Fragmented(dataBlock));
+
+	// delete even items within the first two blocks
+	for(int i = 0; i < 32; i += 2) DataBlock_DeleteItem(dataBlock, i);
+	TEST_ASSERT(dataBlock->itemCount == 48);
+	TEST_ASSERT(DataBlock_Fragmented(dataBlock));
+
+	// collect items positioned beyond item count
+	uint64_t src[64];
+	uint64_t dst[64];
+	uint64_t n = DataBlock_TrailingItems(dataBlock, 64, src);
+	TEST_ASSERT(n == 16);
+	for(int i = 0; i < n; i++) TEST_ASSERT(src[i] == 63 - i);
+
+	// fill vacancies
+	TEST_ASSERT(DataBlock_Relocate(dataBlock, 0, src, dst, n) == n);
+	TEST_ASSERT(!DataBlock_Fragmented(dataBlock));
+	for(int i = 0; i < n; i++) {
+		TEST_ASSERT(dst[i] == i * 2);
+		int *item = (int *)DataBlock_GetItem(dataBlock, dst[i]);
+		TEST_ASSERT(*item == src[i]);
+		TEST_ASSERT(DataBlock_GetItem(dataBlock, src[i]) == NULL);
+	}
+
+	// release trailing block
+	TEST_ASSERT(DataBlock_Trim(dataBlock) > 0);
+	TEST_ASSERT(dataBlock->blockCount == 3);
+	TEST_ASSERT(dataBlock->itemCap == 48);
+	TEST_ASSERT(array_len(dataBlock->deletedIdx) == 0);
+
+	int sum = 0;
+	int *item;
+	DataBlockIterator *it = DataBlock_Scan(dataBlock);
+	while((item = (int *)DataBlockIterator_Next(it, NULL))) sum += *item;
+	DataBlockIterator_Free(it);
+
+	// items 1, 3, .. 31 and 32 .. 63
+	TEST_ASSERT(sum == 16 * 16 + (32 + 63) * 16);
+
+	// new items are appended
+	uint64_t idx;
+	DataBlock_AllocateItem(dataBlock, &idx);
+	TEST_ASSERT(idx == 48);
+
+	DataBlock_Free(dataBlock);
+}
+
 TEST_LIST = {
 	{"dataBlockNew", test_dataBlockNew},
 	{"dataBlockAddItem", test_dataBlockAddItem },
 	{"dataBlockScan", test_dataBlockScan},
 	{"dataBlockRemoveItem", test_dataBlockRemoveItem},
 	{"dataBlockOutOfOrderBuilding", test_dataBlockOutOfOrderBuilding},
+	{"dataBlockDefragment", test_dataBlockDefragment},
 	{NULL, NULL}
 };
 
@@ -463,11 +463,88 @@ void test_getEdge() {
 	Graph_Free(g);
 }
 
+void test_createEdges() {
+	/* Create edges in bulk, enough for an empty relation to be built at once.
+	 * every node is connected to its successor by two edges,
+	 * make sure both edges of each collapsed multi-edge entry
+	 * report the correct source and destination. */
+
+	size_t nodeCount = 2048;
+	size_t edgeCount = (nodeCount - 1) * 2;
+
+	Graph *g = Graph_New(nodeCount, edgeCount);
+	Graph_AcquireWriteLock(g);
+	_test_node_creation(g, nodeCount);
+	int r = Graph_AddRelationType(g);
+
+	Edge *edges = rm_malloc(sizeof(Edge) * edgeCount);
+	Edge **to_create = rm_malloc(sizeof(Edge *) * edgeCount);
+	for(size_t i = 0; i < edgeCount; i++) {
+		Edge *e = edges + i;
+		e->relationship = NULL;
+		e->relationID = r;
+		e->src_id = i / 2;
+		e->dest_id = i / 2 + 1;
+		to_create[i] = e;
+	}
+
+	Graph_CreateEdges(g, to_create, edgeCount);
+
+	// edge IDs are assigned in order
+	for(EdgeID i = 0; i < edgeCount; i++) TEST_ASSERT(edges[i].id == i);
+	TEST_ASSERT(Graph_EdgeCount(g) == edgeCount);
+
+	Node n;
+	Edge *res = array_new(Edge, 2);
+	for(NodeID i = 0; i + 1 < nodeCount; i++) {
+		// edges connecting i to its successor
+		Graph_GetEdgesConnectingNodes(g, i, i + 1, r, &res);
+		TEST_ASSERT(array_len(res) == 2);
+		for(int j = 0; j < 2; j++) {
+			TEST_ASSERT(res[j].id == i * 2 + j);
+			TEST_ASSERT(Edge_GetSrcNodeID(res + j) == i);
+			TEST_ASSERT(Edge_GetDestNodeID(res + j) == i + 1);
+		}
+		array_clear(res);
+
+		// outgoing edges
+		Graph_GetNode(g, i, &n);
+		Graph_GetNodeEdges(g, &n, GRAPH_EDGE_DIR_OUTGOING, r, &res);
+		TEST_ASSERT(array_len(res) == 2);
+		for(int j = 0; j < 2; j++) {
+			TEST_ASSERT(Edge_GetSrcNodeID(res + j) == i);
+			TEST_ASSERT(Edge_GetDestNodeID(res + j) == i + 1);
+		}
+		array_clear(res);
+
+		// incoming edges
+		Graph_GetNode(g, i + 1, &n);
+		Graph_GetNodeEdges(g, &n, GRAPH_EDGE_DIR_INCOMING, r, &res);
+		TEST_ASSERT(array_len(res) == 2);
+		for(int j = 0; j < 2; j++) {
+			TEST_ASSERT(Edge_GetSrcNodeID(res + j) == i);
+			TEST_ASSERT(Edge_GetDestNodeID(res + j) == i + 1);
+		}
+		array_clear(res);
+
+		// no edge connects successor back to i
+		Graph_GetEdgesConnectingNodes(g, i + 1, i, r, &res);
+		TEST_ASSERT(array_len(res) == 0);
+	}
+
+	array_free(res);
+	rm_free(to_create);
+	rm_free(edges);
+	Graph_ReleaseLock(g);
+	Graph_Free(g);
+}
+
 TEST_LIST = {
 	{"newGraph", test_newGraph},
 	{"graphConstruction", test_graphConstruction},
 	{"removeNodes", test_removeNodes},
 	{"getNode", test_getNode},
 	{"getEdge", test_getEdge},
+	{"createEdges", test_createEdges},
 	{NULL, NULL}
 };
@@ -0,0 +1,446 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "src/value.h"
+#include "src/util/arr.h"
+#include "src/util/rmalloc.h"
+#include "src/index/index.h"
+#include "src/index/index_query.h"
+#include "src/index/ordered_index.h"
+
+#include <math.h>
+
+void setup() {
+	Alloc_Reset();
+}
+
+#define TEST_INIT setup();
+#include "acutest.h"
+
+// creates a query clause restricting a single field
+static IndexCheck *_Clause
+(
+	uint16_t field,
+	AST_Operator op,
+	SIValue v
+) {
+	IndexCheck check = {.field = field};
+	IndexRange_FromPredicate(&check.range, op, v);
+
+	IndexCheck *clause = array_new(IndexCheck, 1);
+	array_append(clause, check);
+	return clause;
+}
+
+// returns number of entities matched by query
+static int _Count
+(
+	IndexQuery *q
+) {
+	int n = 0;
+	while(IndexQuery_Next(q) != NULL) n++;
+	return n;
+}
+
+void test_indexValueOrder() {
+	// values in ascending index order
+	SIValue values[] = {
+		SI_BoolVal(false),
+		SI_BoolVal(true),
+		SI_DoubleVal(-INFINITY),
+		SI_DoubleVal(-2.5),
+		SI_LongVal(-1),
+		SI_LongVal(0),
+		SI_DoubleVal(0.5),
+		SI_LongVal(1),
+		SI_DoubleVal(INFINITY),
+		SI_ConstStringVal(""),
+		SI_ConstStringVal("a"),
+		SI_ConstStringVal("ab"),
+		SI_ConstStringVal("b"),
+		SI_DoubleVal(NAN),
+	};
+
+	uint n = sizeof(values) / sizeof(SIValue);
+	for(uint i = 1; i < n; i++) {
+		size_t        a_len = IndexValue_Len(values[i-1]);
+		size_t        b_len = IndexValue_Len(values[i]);
+		unsigned char a[a_len];
+		unsigned char b[b_len];
+
+		TEST_ASSERT(IndexValue_Encode(values[i-1], a) == a_len);
+		TEST_ASSERT(IndexValue_Encode(values[i], b) == b_len);
+		TEST_ASSERT(IndexValue_Compare(a, a_len, b, b_len) < 0);
+	}
+
+	// integers and floats are comparable, -0.0 equals 0.0
+	unsigned char a[9];
+	unsigned char b[9];
+	IndexValue_Encode(SI_LongVal(3), a);
+	IndexValue_Encode(SI_DoubleVal(3.0), b);
+	TEST_ASSERT(IndexValue_Compare(a, 9, b, 9) == 0);
+
+	IndexValue_Encode(SI_DoubleVal(-0.0), a);
+	IndexValue_Encode(SI_DoubleVal(0.0), b);
+	TEST_ASSERT(IndexValue_Compare(a, 9, b, 9) == 0);
+}
+
+void test_orderedIndexSet() {
+	OrderedIndex oi = OrderedIndex_New(2, sizeof(EntityID));
+
+	SIValue a = SI_LongVal(1);
+	SIValue b = SI_ConstStringVal("x");
+	const SIValue *values[2] = {&a, &b};
+
+	EntityID id = 7;
+	OrderedIndex_Set(oi, &id, values);
+	TEST_ASSERT(OrderedIndex_EntityCount(oi) == 1);
+	TEST_ASSERT(OrderedIndex_ValueCount(oi)  == 2);
+
+	size_t len;
+	const unsigned char *v = OrderedIndex_GetValue(oi, &id, 1, &len);
+	TEST_ASSERT(v != NULL);
+	TEST_ASSERT(len == IndexValue_Len(b));
+
+	// replace values, drop second field
+	values[1] = NULL;
+	OrderedIndex_Set(oi, &id, values);
+	TEST_ASSERT(OrderedIndex_EntityCount(oi) == 1);
+	TEST_ASSERT(OrderedIndex_ValueCount(oi)  == 1);
+	TEST_ASSERT(OrderedIndex_GetValue(oi, &id, 1, &len) == NULL);
+
+	// entity without any values is removed
+	values[0] = NULL;
+	OrderedIndex_Set(oi, &id, values);
+	TEST_ASSERT(OrderedIndex_EntityCount(oi) == 0);
+	TEST_ASSERT(OrderedIndex_ValueCount(oi)  == 0);
+
+	values[0] = &a;
+	OrderedIndex_Set(oi, &id, values);
+	OrderedIndex_Remove(oi, &id);
+	TEST_ASSERT(OrderedIndex_EntityCount(oi) == 0);
+	TEST_ASSERT(OrderedIndex_GetValue(oi, &id, 0, &len) == NULL);
+
+	OrderedIndex_Free(oi);
+}
+
+void test_orderedIndexStoredValue() {
+	OrderedIndex oi = OrderedIndex_New(4, sizeof(EntityID));
+
+	// large integers aren't represented exactly by their encoding
+	SIValue a = SI_LongVal(9007199254740993);
+	SIValue b = SI_DoubleVal(2.0);
+	SIValue c = SI_ConstStringVal("str");
+	const SIValue *values[4] = {&a, &b, &c, NULL};
+
+	EntityID id = 3;
+	OrderedIndex_Set(oi, &id, values);
+
+	// numeric values keep their native representation
+	TEST_ASSERT(OrderedIndex_StoredMemory(oi) ==
+			2 * INDEX_VALUE_NUMERIC_SUFFIX_LEN);
+
+	SIValue v;
+	TEST_ASSERT(OrderedIndex_GetStoredValue(oi, &id, 0, &v));
+	TEST_ASSERT(SI_TYPE(v) == T_INT64 && v.longval == a.longval);
+
+	// integers and floats are told apart
+	TEST_ASSERT(OrderedIndex_GetStoredValue(oi, &id, 1, &v));
+	TEST_ASSERT(SI_TYPE(v) == T_DOUBLE && v.doubleval == 2.0);
+
+	TEST_ASSERT(OrderedIndex_GetStoredValue(oi, &id, 2, &v));
+	TEST_ASSERT(SI_TYPE(v) == T_STRING && strcmp(v.stringval, "str") == 0);
+
+	// missing field is read as null
+	TEST_ASSERT(OrderedIndex_GetStoredValue(oi, &id, 3, &v));
+	TEST_ASSERT(SI_TYPE(v) == T_NULL);
+
+	// stored suffix doesn't take part in lookups
+	IndexQuery *q = IndexQuery_New(oi);
+	IndexQuery_AddClause(q, _Clause(1, OP_EQUAL, SI_LongVal(2)));
+	TEST_ASSERT(_Count(q) == 1);
+	IndexQuery_Free(q);
+
+	// replacing an integer with an equal float updates the stored value
+	b = SI_LongVal(2);
+	OrderedIndex_Set(oi, &id, values);
+	TEST_ASSERT(OrderedIndex_ValueCount(oi) == 3);
+	TEST_ASSERT(OrderedIndex_GetStoredValue(oi, &id, 1, &v));
+	TEST_ASSERT(SI_TYPE(v) == T_INT64 && v.longval == 2);
+
+	// values without a faithful encoding can't be read back
+	a = SI_DoubleVal(NAN);
+	OrderedIndex_Set(oi, &id, values);
+	TEST_ASSERT(!OrderedIndex_GetStoredValue(oi, &id, 0, &v));
+
+	// entity isn't indexed
+	OrderedIndex_Remove(oi, &id);
+	TEST_ASSERT(!OrderedIndex_GetStoredValue(oi, &id, 1, &v));
+	TEST_ASSERT(OrderedIndex_StoredMemory(oi) == 0);
+
+	OrderedIndex_Free(oi);
+}
+
+void test_indexQueryRange() {
+	OrderedIndex oi = OrderedIndex_New(2, sizeof(EntityID));
+
+	// v = id, w = id % 10
+	for(EntityID id = 0; id < 100; id++) {
+		SIValue v = SI_LongVal(id);
+		SIValue w = SI_LongVal(id % 10);
+		const SIValue *values[2] = {&v, &w};
+		OrderedIndex_Set(oi, &id, values);
+	}
+
+	// v >= 10 AND v < 20, entities are returned in value order
+	IndexQuery *q = IndexQuery_New(oi);
+	IndexCheck *clause = _Clause(0, OP_GE, SI_LongVal(10));
+	IndexCheck *lt     = _Clause(0, OP_LT, SI_LongVal(20));
+	TEST_ASSERT(IndexRange_Intersect(&clause[0].range, &lt[0].range));
+	IndexQuery_FreeChecks(lt);
+	IndexQuery_AddClause(q, clause);
+
+	const EntityID *id;
+	EntityID expected = 10;
+	while((id = IndexQuery_Next(q)) != NULL) {
+		TEST_ASSERT(*id == expected);
+		expected++;
+	}
+	TEST_ASSERT(expected == 20);
+
+	// reset restarts query
+	IndexQuery_Reset(q);
+	TEST_ASSERT(_Count(q) == 10);
+	IndexQuery_Free(q);
+
+	// v > 50 AND w = 3
+	q = IndexQuery_New(oi);
+	clause = _Clause(0, OP_GT, SI_LongVal(50));
+	IndexCheck *eq = _Clause(1, OP_EQUAL, SI_LongVal(3));
+	array_append(clause, eq[0]);
+	array_free(eq);
+	IndexQuery_AddClause(q, clause);
+	TEST_ASSERT(_Count(q) == 5);
+	IndexQuery_Free(q);
+
+	// strings are not numbers
+	q = IndexQuery_New(oi);
+	IndexQuery_AddClause(q, _Clause(0, OP_EQUAL, SI_ConstStringVal("1")));
+	TEST_ASSERT(_Count(q) == 0);
+	IndexQuery_Free(q);
+
+	// an empty clause matches all entities
+	q = IndexQuery_New(oi);
+	IndexQuery_AddClause(q, array_new(IndexCheck, 0));
+	TEST_ASSERT(_Count(q) == 100);
+	IndexQuery_Free(q);
+
+	OrderedIndex_Free(oi);
+}
+
+void test_indexQueryDisjunction() {
+	OrderedIndex oi = OrderedIndex_New(2, sizeof(EntityID));
+
+	for(EntityID id = 0; id < 100; id++) {
+		SIValue v = SI_LongVal(id);
+		SIValue w = SI_LongVal(id % 10);
+		const SIValue *values[2] = {&v, &w};
+		OrderedIndex_Set(oi, &id, values);
+	}
+
+	// overlapping ranges over the same field: v < 20 OR v <= 30 OR v = 90
+	IndexQuery *q = IndexQuery_New(oi);
+	IndexQuery_AddClause(q, _Clause(0, OP_LT, SI_LongVal(20)));
+	IndexQuery_AddClause(q, _Clause(0, OP_LE, SI_LongVal(30)));
+	IndexQuery_AddClause(q, _Clause(0, OP_EQUAL, SI_LongVal(90)));
+	TEST_ASSERT(_Count(q) == 32);
+	IndexQuery_Free(q);
+
+	// clauses over different fields: v < 10 OR w = 0
+	q = IndexQuery_New(oi);
+	IndexQuery_AddClause(q, _Clause(0, OP_LT, SI_LongVal(10)));
+	IndexQuery_AddClause(q, _Clause(1, OP_EQUAL, SI_LongVal(0)));
+	TEST_ASSERT(_Count(q) == 19);
+	IndexQuery_Free(q);
+
+	OrderedIndex_Free(oi);
+}
+
+void test_indexQueryOrder() {
+	OrderedIndex oi = OrderedIndex_New(2, sizeof(EntityID));
+
+	// v = 99 - id, w = id % 10
+	for(EntityID id = 0; id < 100; id++) {
+		SIValue v = SI_LongVal(99 - id);
+		SIValue w = SI_LongVal(id % 10);
+		const SIValue *values[2] = {&v, &w};
+		OrderedIndex_Set(oi, &id, values);
+	}
+
+	// v > 10 AND v <= 20 ordered by descending v
+	IndexQuery *q = IndexQuery_New(oi);
+	IndexCheck *clause = _Clause(0, OP_GT, SI_LongVal(10));
+	IndexCheck *le     = _Clause(0, OP_LE, SI_LongVal(20));
+	TEST_ASSERT(IndexRange_Intersect(&clause[0].range, &le[0].range));
+	IndexQuery_FreeChecks(le);
+	IndexQuery_AddClause(q, clause);
+	IndexQuery_SetOrder(q, 0, true);
+	TEST_ASSERT(IndexQuery_Ordered(q));
+
+	const EntityID *id;
+	int64_t expected = 20;
+	while((id = IndexQuery_Next(q)) != NULL) {
+		TEST_ASSERT(99 - *id == expected);
+		expected--;
+	}
+	TEST_ASSERT(expected == 10);
+	IndexQuery_Free(q);
+
+	// v < 5 OR v >= 95 OR v = 50, unbounded ranges stay within the bucket
+	q = IndexQuery_New(oi);
+	IndexQuery_AddClause(q, _Clause(0, OP_LT, SI_LongVal(5)));
+	IndexQuery_AddClause(q, _Clause(0, OP_GE, SI_LongVal(95)));
+	IndexQuery_AddClause(q, _Clause(0, OP_EQUAL, SI_LongVal(50)));
+	IndexQuery_SetOrder(q, 0, true);
+	TEST_ASSERT(IndexQuery_Ordered(q));
+
+	int n = 0;
+	int64_t prev = INT64_MAX;
+	while((id = IndexQuery_Next(q)) != NULL) {
+		TEST_ASSERT(99 - (int64_t)*id < prev);
+		prev = 99 - *id;
+		n++;
+	}
+	TEST_ASSERT(n == 11);
+	IndexQuery_Free(q);
+
+	// ranges of different types aren't ordered as Cypher orders them
+	q = IndexQuery_New(oi);
+	IndexQuery_AddClause(q, _Clause(0, OP_EQUAL, SI_LongVal(5)));
+	IndexQuery_AddClause(q, _Clause(0, OP_EQUAL, SI_ConstStringVal("5")));
+	IndexQuery_SetOrder(q, 0, false);
+	TEST_ASSERT(!IndexQuery_Ordered(q));
+	TEST_ASSERT(_Count(q) == 1);
+	IndexQuery_Free(q);
+
+	// scanned by an exact check on another field
+	q = IndexQuery_New(oi);
+	clause = _Clause(0, OP_GT, SI_LongVal(50));
+	IndexCheck *eq = _Clause(1, OP_EQUAL, SI_LongVal(3));
+	array_append(clause, eq[0]);
+	array_free(eq);
+	IndexQuery_AddClause(q, clause);
+	IndexQuery_SetOrder(q, 0, false);
+	TEST_ASSERT(!IndexQuery_Ordered(q));
+	TEST_ASSERT(_Count(q) == 5);
+	IndexQuery_Free(q);
+
+	// all entities
+	q = IndexQuery_New(oi);
+	IndexQuery_AddClause(q, array_new(IndexCheck, 0));
+	IndexQuery_SetOrder(q, 0, false);
+	TEST_ASSERT(!IndexQuery_Ordered(q));
+	IndexQuery_Free(q);
+
+	OrderedIndex_Free(oi);
+}
+
+void test_indexQueryEdges() {
+	OrderedIndex oi = OrderedIndex_New(1, sizeof(EdgeIndexKey));
+
+	// edges (i % 3)->(i % 5), all sharing the same value
+	SIValue v = SI_BoolVal(true);
+	const SIValue *values[1] = {&v};
+	for(EntityID i = 0; i < 30; i++) {
+		EdgeIndexKey key = {.src_id = i % 3, .dest_id = i % 5, .edge_id = i};
+		OrderedIndex_Set(oi, &key, values);
+	}
+
+	IndexQuery *q = IndexQuery_New(oi);
+	IndexQuery_AddClause(q, _Clause(0, OP_EQUAL, SI_BoolVal(true)));
+	IndexQuery_SetSrc(q, 1);
+	IndexQuery_SetDest(q, 2);
+
+	const EdgeIndexKey *key;
+	int n = 0;
+	while((key = IndexQuery_Next(q)) != NULL) {
+		TEST_ASSERT(key->src_id  == 1);
+		TEST_ASSERT(key->dest_id == 2);
+		n++;
+	}
+	TEST_ASSERT(n == 2);
+
+	IndexQuery_Free(q);
+	OrderedIndex_Free(oi);
+}
+
+void test_orderedIndexLoad() {
+	OrderedIndex    oi = OrderedIndex_New(2, sizeof(EntityID));
+	OrderedIndexRun runs[3];
+
+	// entities are spread among runs, v = id, w = id % 10
+	for(uint i = 0; i < 3; i++) runs[i] = OrderedIndexRun_New(2, sizeof(EntityID));
+	for(EntityID id = 0; id < 100; id++) {
+		SIValue v = SI_LongVal(id);
+		SIValue w = SI_LongVal(id % 10);
+		const SIValue *values[2] = {&v, &w};
+
+		// entities without values are skipped
+		if(id == 99) values[0] = values[1] = NULL;
+		OrderedIndexRun_Add(runs[id % 3], &id, values);
+	}
+
+	for(uint i = 0; i < 3; i++) OrderedIndexRun_Sort(runs[i]);
+
+	// load in multiple batches
+	int batches = 1;
+	while(!OrderedIndex_Load(oi, runs, 3, 16)) batches++;
+	TEST_ASSERT(batches > 1);
+
+	for(uint i = 0; i < 3; i++) OrderedIndexRun_Free(runs[i]);
+
+	TEST_ASSERT(OrderedIndex_EntityCount(oi) == 99);
+	TEST_ASSERT(OrderedIndex_ValueCount(oi)  == 198);
+
+	// entities are returned in value order
+	IndexQuery *q = IndexQuery_New(oi);
+	IndexQuery_AddClause(q, _Clause(0, OP_GE, SI_LongVal(0)));
+
+	const EntityID *id;
+	EntityID expected = 0;
+	while((id = IndexQuery_Next(q)) != NULL) {
+		TEST_ASSERT(*id == expected);
+		expected++;
+	}
+	TEST_ASSERT(expected == 99);
+	IndexQuery_Free(q);
+
+	// loaded entities can be updated
+	EntityID e = 5;
+	SIValue  v = SI_LongVal(500);
+	const SIValue *values[2] = {&v, NULL};
+	OrderedIndex_Set(oi, &e, values);
+	TEST_ASSERT(OrderedIndex_ValueCount(oi) == 197);
+
+	q = IndexQuery_New(oi);
+	IndexQuery_AddClause(q, _Clause(1, OP_EQUAL, SI_LongVal(5)));
+	TEST_ASSERT(_Count(q) == 9);
+	IndexQuery_Free(q);
+
+	OrderedIndex_Free(oi);
+}
+
+TEST_LIST = {
+	{"indexValueOrder", test_indexValueOrder},
+	{"orderedIndexSet", test_orderedIndexSet},
+	{"orderedIndexStoredValue", test_orderedIndexStoredValue},
+	{"indexQueryRange", test_indexQueryRange},
+	{"indexQueryDisjunction", test_indexQueryDisjunction},
+	{"indexQueryOrder", test_indexQueryOrder},
+	{"indexQueryEdges", test_indexQueryEdges},
+	{"orderedIndexLoad", test_orderedIndexLoad},
+	{NULL, NULL}
+};
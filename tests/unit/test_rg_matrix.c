@@ -1539,6 +1539,232 @@ void test_RGMatrix_resize() {
 	RG_Matrix_free(&A);
 }
 
+// multi-edge entries
+void test_RGMatrix_multi_edge() {
+	GrB_Type    t                   =  GrB_UINT64;
+	RG_Matrix   A                   =  NULL;
+	GrB_Info    info                =  GrB_SUCCESS;
+	GrB_Index   nrows               =  100;
+	GrB_Index   ncols               =  100;
+	GrB_Index   i                   =  0;
+	GrB_Index   j                   =  1;
+	uint64_t    x                   =  0;
+	uint32_t    n                   =  0;
+	bool        entry_deleted       =  false;
+	const uint64_t *ids             =  NULL;
+
+	info = RG_Matrix_new(&A, t, nrows, ncols);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	//--------------------------------------------------------------------------
+	// introduce multiple edges at position i,j
+	//--------------------------------------------------------------------------
+
+	for(uint64_t id = 0; id < 3; id++) {
+		info = RG_Matrix_setElement_UINT64(A, id, i, j);
+		TEST_ASSERT(info == GrB_SUCCESS);
+	}
+
+	info = RG_Matrix_extractElement_UINT64(&x, A, i, j);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	TEST_ASSERT(!(SINGLE_EDGE(x)));
+
+	ids = RG_Matrix_multiEdge(A, x, &n);
+	TEST_ASSERT(n == 3);
+	for(uint64_t id = 0; id < 3; id++) TEST_ASSERT(ids[id] == id);
+
+	// entry is kept intact by a flush
+	RG_Matrix_wait(A, true);
+
+	// grow entry while it resides in M
+	for(uint64_t id = 3; id < 100; id++) {
+		info = RG_Matrix_setElement_UINT64(A, id, i, j);
+		TEST_ASSERT(info == GrB_SUCCESS);
+	}
+
+	// neighbouring entry, interleaves blocks with entry i,j
+	for(uint64_t id = 100; id < 110; id++) {
+		info = RG_Matrix_setElement_UINT64(A, id, j, i);
+		TEST_ASSERT(info == GrB_SUCCESS);
+	}
+
+	info = RG_Matrix_extractElement_UINT64(&x, A, i, j);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	ids = RG_Matrix_multiEdge(A, x, &n);
+	TEST_ASSERT(n == 100);
+	for(uint64_t id = 0; id < 100; id++) TEST_ASSERT(ids[id] == id);
+
+	info = RG_Matrix_extractElement_UINT64(&x, A, j, i);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	ids = RG_Matrix_multiEdge(A, x, &n);
+	TEST_ASSERT(n == 10);
+	for(uint64_t id = 0; id < 10; id++) TEST_ASSERT(ids[id] == id + 100);
+
+	//--------------------------------------------------------------------------
+	// remove edges
+	//--------------------------------------------------------------------------
+
+	for(uint64_t id = 1; id < 100; id++) {
+		info = RG_Matrix_removeEntry_UINT64(A, i, j, id, &entry_deleted);
+		TEST_ASSERT(info == GrB_SUCCESS);
+		TEST_ASSERT(!entry_deleted);
+	}
+
+	// entry reverted back to a single edge
+	info = RG_Matrix_extractElement_UINT64(&x, A, i, j);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	TEST_ASSERT(SINGLE_EDGE(x));
+	TEST_ASSERT(x == 0);
+
+	// remove multi-edge entry altogether
+	info = RG_Matrix_removeElement_UINT64(A, j, i);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	info = RG_Matrix_extractElement_UINT64(&x, A, j, i);
+	TEST_ASSERT(info == GrB_NO_VALUE);
+
+	// vacated lists are reused
+	info = RG_Matrix_setElement_UINT64(A, 200, j, i);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	info = RG_Matrix_setElement_UINT64(A, 201, j, i);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	RG_Matrix_wait(A, true);
+
+	info = RG_Matrix_extractElement_UINT64(&x, A, j, i);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	ids = RG_Matrix_multiEdge(A, x, &n);
+	TEST_ASSERT(n == 2);
+	TEST_ASSERT(ids[0] == 200 && ids[1] == 201);
+
+	// clean up
+	RG_Matrix_free(&A);
+	TEST_ASSERT(A == NULL);
+}
+
+// modifications advance a matrix's generation, synchronization does not
+void test_RGMatrix_generation() {
+	GrB_Type    t       =  GrB_UINT64;
+	RG_Matrix   A       =  NULL;
+	RG_Matrix   TA      =  NULL;
+	GrB_Matrix  C       =  NULL;
+	GrB_Info    info    =  GrB_SUCCESS;
+	GrB_Index   nrows   =  100;
+	GrB_Index   ncols   =  100;
+	GrB_Index   nvals   =  0;
+	uint64_t    gen     =  0;
+	uint64_t    x       =  0;
+
+	info = RG_Matrix_new(&A, t, nrows, ncols);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	TA = RG_Matrix_getTranspose(A);
+
+	gen = RG_Matrix_generation(A);
+	uint64_t tgen = RG_Matrix_generation(TA);
+
+	// additions and deletions advance generation, along with the transpose
+	info = RG_Matrix_setElement_UINT64(A, 1, 0, 1);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	TEST_ASSERT(RG_Matrix_generation(A) > gen);
+	TEST_ASSERT(RG_Matrix_generation(TA) > tgen);
+
+	gen = RG_Matrix_generation(A);
+	info = RG_Matrix_removeElement_UINT64(A, 0, 1);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	TEST_ASSERT(RG_Matrix_generation(A) > gen);
+
+	info = RG_Matrix_setElement_UINT64(A, 1, 2, 3);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	// synchronizing and resizing leave generation intact
+	gen  = RG_Matrix_generation(A);
+	tgen = RG_Matrix_generation(TA);
+
+	info = RG_Matrix_wait(A, false);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	// compacted matrix is swapped in after A was resized
+	info = RG_Matrix_compact(&C, A);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	info = RG_Matrix_resize(A, nrows * 2, ncols * 2);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	TEST_ASSERT(RG_Matrix_generation(A) == gen);
+	TEST_ASSERT(RG_Matrix_generation(TA) == tgen);
+
+	info = RG_Matrix_swap(A, &C);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	TEST_ASSERT(C == NULL);
+
+	info = RG_Matrix_nrows(&nrows, A);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	TEST_ASSERT(nrows == 200);
+
+	info = RG_Matrix_nvals(&nvals, A);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	TEST_ASSERT(nvals == 1);
+
+	info = RG_Matrix_extractElement_UINT64(&x, A, 2, 3);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	TEST_ASSERT(x == 1);
+
+	// clean up
+	RG_Matrix_free(&A);
+	TEST_ASSERT(A == NULL);
+}
+
+// a multi-edge entry reverting to a single edge advances generation
+// a matrix compacted before the revert must not be swapped in
+// as it refers to a vacated edge list
+void test_RGMatrix_generation_multi_edge() {
+	GrB_Type    t              =  GrB_UINT64;
+	RG_Matrix   A              =  NULL;
+	GrB_Matrix  C              =  NULL;
+	GrB_Info    info           =  GrB_SUCCESS;
+	GrB_Index   nrows          =  100;
+	GrB_Index   ncols          =  100;
+	uint64_t    gen            =  0;
+	uint64_t    x              =  0;
+	bool        entry_deleted  =  false;
+
+	info = RG_Matrix_new(&A, t, nrows, ncols);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	// two edges at position 0,1
+	info = RG_Matrix_setElement_UINT64(A, 1, 0, 1);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	info = RG_Matrix_setElement_UINT64(A, 2, 0, 1);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	info = RG_Matrix_wait(A, false);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	// compact, as done by the compactor's first phase
+	gen  = RG_Matrix_generation(A);
+	info = RG_Matrix_compact(&C, A);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	// remove one of the edges, entry reverts to a single edge
+	info = RG_Matrix_removeEntry_UINT64(A, 0, 1, 2, &entry_deleted);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	TEST_ASSERT(!entry_deleted);
+
+	info = RG_Matrix_extractElement_UINT64(&x, A, 0, 1);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	TEST_ASSERT(SINGLE_EDGE(x) && x == 1);
+
+	// compacted matrix is stale, the compactor discards it
+	TEST_ASSERT(RG_Matrix_generation(A) != gen);
+
+	// clean up
+	GrB_Matrix_free(&C);
+	RG_Matrix_free(&A);
+	TEST_ASSERT(A == NULL);
+}
+
 TEST_LIST = {
 	{"RGMatrix_new", test_RGMatrix_new},
 	{"RGMatrix_simple_set", test_RGMatrix_simple_set},
@@ -1553,6 +1779,9 @@ TEST_LIST = {
 	{"RGMatrix_copy", test_RGMatrix_copy},
 	{"RGMatrix_mxm", test_RGMatrix_mxm},
 	{"RGMatrix_resize", test_RGMatrix_resize},
+	{"RGMatrix_multi_edge", test_RGMatrix_multi_edge},
+	{"RGMatrix_generation", test_RGMatrix_generation},
+	{"RGMatrix_generation_multi_edge", test_RGMatrix_generation_multi_edge},
 	{NULL, NULL}
 };
 
@@ -6,12 +6,16 @@
 
 #include "src/value.h"
 #include "src/util/rmalloc.h"
+#include "src/util/string_pool.h"
 #include "src/datatypes/set.h"
 #include "src/datatypes/array.h"
 #include "src/datatypes/path/path.h"
 #include "src/graph/entities/node.h"
 #include "src/graph/entities/edge.h"
 
+#include <stdio.h>
+#include <pthread.h>
+
 void setup() {
 	Alloc_Reset();
 }
@@ -62,6 +66,95 @@ void test_strings() {
 	SIValue_Free(v);
 }
 
+void test_internedStrings() {
+	uint64_t pool_size = StringPool_Size();
+
+	// interning equal strings shares a single allocation
+	SIValue a = SI_InternValue(SI_ConstStringVal("active"));
+	SIValue b = SI_InternValue(SI_DuplicateStringVal("active"));
+	TEST_ASSERT(a.allocation == M_INTERN);
+	TEST_ASSERT(b.allocation == M_INTERN);
+	TEST_ASSERT(a.stringval == b.stringval);
+	TEST_ASSERT(StringPool_RefCount(a.stringval) == 2);
+	TEST_ASSERT(StringPool_Size() == pool_size + 1);
+	TEST_ASSERT(SIValue_Compare(a, b, NULL) == 0);
+
+	// interning an interned value adds a reference
+	SIValue c = SI_InternValue(a);
+	TEST_ASSERT(c.stringval == a.stringval);
+	TEST_ASSERT(StringPool_RefCount(a.stringval) == 3);
+
+	// shared and cloned values don't reference the pool
+	SIValue shared = SI_ShareValue(a);
+	TEST_ASSERT(shared.allocation == M_VOLATILE);
+	SIValue clone = SI_CloneValue(a);
+	TEST_ASSERT(clone.allocation == M_SELF);
+	TEST_ASSERT(clone.stringval != a.stringval);
+	TEST_ASSERT(StringPool_RefCount(a.stringval) == 3);
+	SIValue_Free(shared);
+	SIValue_Free(clone);
+
+	// owned strings are interned in place
+	SIValue d = SI_DuplicateStringVal("active");
+	SIValue_Intern(&d);
+	TEST_ASSERT(d.allocation == M_INTERN);
+	TEST_ASSERT(d.stringval == a.stringval);
+
+	// long strings are not interned
+	char long_str[STRING_POOL_MAX_LEN + 2];
+	memset(long_str, 'x', STRING_POOL_MAX_LEN + 1);
+	long_str[STRING_POOL_MAX_LEN + 1] = '\0';
+	SIValue e = SI_InternValue(SI_ConstStringVal(long_str));
+	TEST_ASSERT(e.allocation == M_SELF);
+	SIValue_Free(e);
+
+	// string is released once its last reference is dropped
+	SIValue_Free(a);
+	SIValue_Free(b);
+	SIValue_Free(c);
+	TEST_ASSERT(StringPool_Size() == pool_size + 1);
+	SIValue_Free(d);
+	TEST_ASSERT(StringPool_Size() == pool_size);
+}
+
+static void *_internWorker(void *arg) {
+	char buf[16];
+	bool *shared = arg;
+	for(int i = 0; i < 10000; i++) {
+		// strings shared among workers land on different shards
+		sprintf(buf, "v%d", i % 100);
+		SIValue a = SI_InternValue(SI_ConstStringVal(buf));
+		SIValue b = SI_InternValue(a);
+		*shared &= (a.stringval == b.stringval);
+		SIValue_Free(a);
+		SIValue_Free(b);
+	}
+	return NULL;
+}
+
+void test_internedStringsConcurrent() {
+	uint64_t pool_size = StringPool_Size();
+
+	SIValue kept = SI_InternValue(SI_ConstStringVal("v0"));
+
+	pthread_t workers[8];
+	bool shared[8];
+	for(int i = 0; i < 8; i++) {
+		shared[i] = true;
+		pthread_create(workers + i, NULL, _internWorker, shared + i);
+	}
+	for(int i = 0; i < 8; i++) {
+		pthread_join(workers[i], NULL);
+		TEST_ASSERT(shared[i]);
+	}
+
+	// only the string referenced by this thread remains
+	TEST_ASSERT(StringPool_RefCount(kept.stringval) == 1);
+	TEST_ASSERT(StringPool_Size() == pool_size + 1);
+	SIValue_Free(kept);
+	TEST_ASSERT(StringPool_Size() == pool_size);
+}
+
 // idempotence and correctness tests for:
 // null, bool, long, double, edge, node, array.
 void test_null() {
@@ -116,6 +209,30 @@ void test_hashDouble() {
 	TEST_ASSERT(origHashCode == otherHashCode);
 }
 
+void test_hashTemporal() {
+	SIType types[6] = {T_DATETIME, T_LOCALDATETIME, T_DATE, T_TIME,
+		T_LOCALTIME, T_DURATION};
+
+	for(int i = 0; i < 6; i++) {
+		SIValue v     = {.longval = 1672531200, .type = types[i]};
+		SIValue other = {.longval = 1672531200, .type = types[i]};
+		TEST_ASSERT(SIValue_HashCode(v) == SIValue_HashCode(other));
+		TEST_ASSERT(SIValue_Compare(v, other, NULL) == 0);
+
+		other.longval++;
+		TEST_ASSERT(SIValue_HashCode(v) != SIValue_HashCode(other));
+		TEST_ASSERT(SIValue_Compare(v, other, NULL) < 0);
+
+		// same payload, different temporal type
+		other.longval = v.longval;
+		other.type    = types[(i + 1) % 6];
+		TEST_ASSERT(SIValue_HashCode(v) != SIValue_HashCode(other));
+
+		// temporal values do not hash as their integer payload
+		TEST_ASSERT(SIValue_HashCode(v) != SIValue_HashCode(SI_LongVal(v.longval)));
+	}
+}
+
 void test_edge() {
 	AttributeSet attr;
 
@@ -164,6 +281,46 @@ void test_node() {
 	TEST_ASSERT(origHashCode != otherHashCode);
 }
 
+void test_binary() {
+	SIValue arr = SI_Array(2);
+	SIArray_Append(&arr, SI_LongVal(7));
+	SIArray_Append(&arr, SI_ConstStringVal("seven"));
+
+	SIValue vals[7] = {
+		SI_LongVal(-3),
+		SI_DoubleVal(3.14),
+		SI_BoolVal(true),
+		SI_ConstStringVal("binary"),
+		SI_Point(32.07, 34.78),
+		SI_NullVal(),
+		arr
+	};
+
+	char   *buff = NULL;
+	size_t size  = 0;
+	FILE *stream = open_memstream(&buff, &size);
+	for(int i = 0; i < 7; i++) SIValue_ToBinary(stream, vals + i);
+	fclose(stream);
+
+	// values are restored in order
+	stream = fmemopen(buff, size, "r");
+	for(int i = 0; i < 7; i++) {
+		SIValue v = SIValue_FromBinary(stream);
+		TEST_ASSERT(v.type == vals[i].type);
+		if(v.type != T_NULL) {
+			TEST_ASSERT(SIValue_Compare(v, vals[i], NULL) == 0);
+		}
+		SIValue_Free(v);
+	}
+
+	// stream is fully consumed
+	TEST_ASSERT(ftell(stream) == size);
+	fclose(stream);
+
+	free(buff);
+	SIValue_Free(arr);
+}
+
 void test_array() {
 	SIValue arr = SI_EmptyArray();
 	SIValue arrOther = SI_EmptyArray();
@@ -451,12 +608,16 @@ void test_path() {
 TEST_LIST = {
 	{"numerics", test_numerics},
 	{"strings", test_strings},
+	{"internedStrings", test_internedStrings},
+	{"internedStringsConcurrent", test_internedStringsConcurrent},
 	{"null", test_null},
 	{"hashBool", test_hashBool},
 	{"hashLong", test_hashLong},
 	{"hashDouble", test_hashDouble},
+	{"hashTemporal", test_hashTemporal},
 	{"edge", test_edge},
 	{"node", test_node},
+	{"binary", test_binary},
 	{"array", test_array},
 	{"hashLongAndBool", test_hashLongAndBool},
 	{"hashLongAndDouble", test_hashLongAndDouble},